@@ -0,0 +1,323 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: benchmarkclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "benchmarkclass.h"
+
+
+BenchmarkClass::BenchmarkClass()
+{
+	m_GpuProfiler = 0;
+	m_warmupFrames = 0;
+	m_frameCount = 0;
+	m_frame = 0;
+	m_firstGpuFrame = 0;
+	m_pendingFrame = 0;
+	m_timestep = 0.0f;
+	m_running = false;
+	m_finished = false;
+}
+
+
+BenchmarkClass::BenchmarkClass(const BenchmarkClass& other)
+{
+}
+
+
+BenchmarkClass::~BenchmarkClass()
+{
+}
+
+
+bool BenchmarkClass::Initialize(GpuProfilerClass* gpuProfiler)
+{
+	m_GpuProfiler = gpuProfiler;
+
+	return true;
+}
+
+
+void BenchmarkClass::Shutdown()
+{
+	Stop();
+
+	m_frames.clear();
+	m_frames.shrink_to_fit();
+	m_cpuStats.Shutdown();
+	m_gpuStats.Shutdown();
+	m_GpuProfiler = 0;
+
+	return;
+}
+
+
+bool BenchmarkClass::Start(int warmupFrames, int frameCount, float timestep)
+{
+	bool result;
+
+
+	if(warmupFrames < 0 || frameCount <= 0 || timestep <= 0.0f)
+	{
+		return false;
+	}
+
+	// Keep room for every recorded frame up front so the run itself does not allocate.
+	m_frames.clear();
+	m_frames.reserve(frameCount);
+
+	// The statistics cover the whole run.
+	result = m_cpuStats.Initialize(frameCount, FRAME_STATS_BUDGET);
+	if(!result)
+	{
+		return false;
+	}
+
+	result = m_gpuStats.Initialize(frameCount, FRAME_STATS_BUDGET);
+	if(!result)
+	{
+		return false;
+	}
+
+	m_warmupFrames = warmupFrames;
+	m_frameCount = frameCount;
+	m_timestep = timestep;
+	m_frame = 0;
+	m_firstGpuFrame = 0;
+	m_pendingFrame = 0;
+	m_running = true;
+	m_finished = false;
+
+	return true;
+}
+
+
+void BenchmarkClass::Stop()
+{
+	m_running = false;
+
+	return;
+}
+
+
+bool BenchmarkClass::IsRunning()
+{
+	return m_running;
+}
+
+
+bool BenchmarkClass::IsFinished()
+{
+	return m_finished;
+}
+
+
+float BenchmarkClass::GetTimestep()
+{
+	return m_timestep;
+}
+
+
+void BenchmarkClass::GetCamera(float& positionX, float& positionY, float& positionZ, float& rotationX, float& rotationY, float& rotationZ)
+{
+	const float* keys[4];
+	float time, t;
+	int segment, i;
+
+
+	// Find the segment of the loop the simulated time is in and how far along it is.
+	time = GetSimulatedTime() / BENCHMARK_SEGMENT_TIME;
+	segment = (int)floorf(time);
+	t = time - (float)segment;
+
+	// Take the presets either side of the segment and the ones beyond them to shape the curve.
+	for(i=0; i<4; i++)
+	{
+		keys[i] = CAMERA_PRESETS[(segment + i + CAMERA_PRESET_COUNT - 1) % CAMERA_PRESET_COUNT];
+	}
+
+	positionX = CatmullRom(keys[0][0], keys[1][0], keys[2][0], keys[3][0], t);
+	positionY = CatmullRom(keys[0][1], keys[1][1], keys[2][1], keys[3][1], t);
+	positionZ = CatmullRom(keys[0][2], keys[1][2], keys[2][2], keys[3][2], t);
+	rotationX = CatmullRom(keys[0][3], keys[1][3], keys[2][3], keys[3][3], t);
+	rotationY = CatmullRom(keys[0][4], keys[1][4], keys[2][4], keys[3][4], t);
+	rotationZ = CatmullRom(keys[0][5], keys[1][5], keys[2][5], keys[3][5], t);
+
+	return;
+}
+
+
+void BenchmarkClass::BeginFrame()
+{
+	if(!m_running)
+	{
+		return;
+	}
+
+	// The first recorded frame is the next one the GPU profiler starts.
+	if(m_frame == m_warmupFrames && m_GpuProfiler)
+	{
+		m_firstGpuFrame = m_GpuProfiler->GetFrameIndex();
+	}
+
+	m_frameStart = chrono::steady_clock::now();
+
+	return;
+}
+
+
+void BenchmarkClass::EndFrame(const RenderDeviceClass::StatisticsType& statistics)
+{
+	FrameType frame;
+
+
+	if(!m_running)
+	{
+		return;
+	}
+
+	// Record the frames past the warm up.
+	if(m_frame >= m_warmupFrames && m_frame < m_warmupFrames + m_frameCount)
+	{
+		frame.time = GetSimulatedTime();
+		frame.cpuTime = chrono::duration<float, milli>(chrono::steady_clock::now() - m_frameStart).count();
+		frame.gpuTime = 0.0f;
+		frame.gpuTimed = false;
+		frame.drawCalls = statistics.drawCalls;
+		frame.triangles = statistics.indexCount / 3;
+
+		m_frames.push_back(frame);
+		m_cpuStats.AddFrame(frame.cpuTime);
+	}
+
+	m_frame++;
+
+	// Pick up the GPU times of the recorded frames the profiler has read back by now.
+	CollectGpuTimes();
+
+	// Finish once every recorded frame has been read back, the profiler drops a frame rather than hold on to it for
+	// longer than its ring.
+	if(m_frame >= m_warmupFrames + m_frameCount)
+	{
+		if(m_pendingFrame == (int)m_frames.size() || m_frame > m_warmupFrames + m_frameCount + GPU_PROFILER_FRAMES)
+		{
+			m_running = false;
+			m_finished = true;
+		}
+	}
+
+	return;
+}
+
+
+int BenchmarkClass::GetRecordedFrameCount()
+{
+	return (int)m_frames.size();
+}
+
+
+bool BenchmarkClass::WriteReport(const char* filename)
+{
+	ofstream fout;
+	unsigned int i;
+
+
+	fout.open(filename, ios::out);
+	if(fout.fail())
+	{
+		return false;
+	}
+
+	// Write one row for every recorded frame with the times in milliseconds, the GPU time is left empty for a frame the
+	// profiler could not time.
+	fout << "frame,time,cpu,gpu,draws,triangles" << endl;
+
+	for(i=0; i<m_frames.size(); i++)
+	{
+		fout << i << "," << m_frames[i].time << "," << m_frames[i].cpuTime << ",";
+		if(m_frames[i].gpuTimed)
+		{
+			fout << m_frames[i].gpuTime;
+		}
+		fout << "," << m_frames[i].drawCalls << "," << m_frames[i].triangles << endl;
+	}
+
+	fout.close();
+
+	return !fout.fail();
+}
+
+
+bool BenchmarkClass::WriteSummary(const char* filename)
+{
+	FrameStatsClass::SummaryType cpu, gpu;
+	ofstream fout;
+
+
+	m_cpuStats.GetSummary(cpu);
+	m_gpuStats.GetSummary(gpu);
+
+	fout.open(filename, ios::out);
+	if(fout.fail())
+	{
+		return false;
+	}
+
+	// Write the distribution of the CPU and GPU frame times over the run.
+	fout << "statistic,cpu,gpu" << endl;
+	fout << "frames," << cpu.frameCount << "," << gpu.frameCount << endl;
+	fout << "minimum," << cpu.minimum << "," << gpu.minimum << endl;
+	fout << "mean," << cpu.mean << "," << gpu.mean << endl;
+	fout << "median," << cpu.median << "," << gpu.median << endl;
+	fout << "p95," << cpu.percentile95 << "," << gpu.percentile95 << endl;
+	fout << "p99," << cpu.percentile99 << "," << gpu.percentile99 << endl;
+	fout << "maximum," << cpu.maximum << "," << gpu.maximum << endl;
+	fout << "over budget," << cpu.overBudgetCount << "," << gpu.overBudgetCount << endl;
+
+	fout.close();
+
+	return !fout.fail();
+}
+
+
+float BenchmarkClass::GetSimulatedTime()
+{
+	// The camera waits at the start of the path while the benchmark warms up.
+	if(m_frame < m_warmupFrames)
+	{
+		return 0.0f;
+	}
+
+	return (float)(m_frame - m_warmupFrames) * m_timestep;
+}
+
+
+void BenchmarkClass::CollectGpuTimes()
+{
+	FrameType* frame;
+
+
+	if(!m_GpuProfiler)
+	{
+		return;
+	}
+
+	// The profiler reads the frames in order, a frame behind its read index was either recorded or dropped.
+	while(m_pendingFrame < (int)m_frames.size() && m_firstGpuFrame + m_pendingFrame < m_GpuProfiler->GetReadFrameIndex())
+	{
+		frame = &m_frames[m_pendingFrame];
+		frame->gpuTimed = m_GpuProfiler->GetRecordedFrameTime(m_firstGpuFrame + m_pendingFrame, frame->gpuTime);
+		if(frame->gpuTimed)
+		{
+			m_gpuStats.AddFrame(frame->gpuTime);
+		}
+
+		m_pendingFrame++;
+	}
+
+	return;
+}
+
+
+float BenchmarkClass::CatmullRom(float p0, float p1, float p2, float p3, float t)
+{
+	return 0.5f * ((2.0f * p1) + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t * t + (3.0f * p1 - p0 - 3.0f * p2 + p3) * t * t * t);
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: benchmarkclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _BENCHMARKCLASS_H_
+#define _BENCHMARKCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <math.h>
+#include <chrono>
+#include <fstream>
+#include <vector>
+using namespace std;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+#include "gpuprofilerclass.h"
+#include "framestatsclass.h"
+#include "positionclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int BENCHMARK_WARMUP_FRAMES = 60;
+const int BENCHMARK_FRAMES = 900;
+const float BENCHMARK_TIMESTEP = 1000.0f / 60.0f;
+const float BENCHMARK_SEGMENT_TIME = 5000.0f;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: BenchmarkClass
+//
+// Flies the camera along a closed Catmull-Rom spline through the camera presets and steps the simulation by a fixed
+// time every frame, so every run renders the same frames whatever the machine or the input.  The first frames warm up
+// the caches and are not recorded.  Every recorded frame keeps its CPU time, its draw and triangle counts and, once the
+// GPU profiler has read it back a few frames later, its GPU time.  The benchmark keeps going for a few frames after the
+// last recorded one to collect the GPU times still in flight.
+////////////////////////////////////////////////////////////////////////////////
+class BenchmarkClass
+{
+private:
+	struct FrameType
+	{
+		float time;
+		float cpuTime, gpuTime;
+		bool gpuTimed;
+		int drawCalls, triangles;
+	};
+
+public:
+	BenchmarkClass();
+	BenchmarkClass(const BenchmarkClass&);
+	~BenchmarkClass();
+
+	bool Initialize(GpuProfilerClass*);
+	void Shutdown();
+
+	bool Start(int, int, float);
+	void Stop();
+	bool IsRunning();
+	bool IsFinished();
+
+	float GetTimestep();
+	void GetCamera(float&, float&, float&, float&, float&, float&);
+
+	void BeginFrame();
+	void EndFrame(const RenderDeviceClass::StatisticsType&);
+
+	int GetRecordedFrameCount();
+	bool WriteReport(const char*);
+	bool WriteSummary(const char*);
+
+private:
+	float GetSimulatedTime();
+	void CollectGpuTimes();
+	static float CatmullRom(float, float, float, float, float);
+
+private:
+	GpuProfilerClass* m_GpuProfiler;
+	FrameStatsClass m_cpuStats, m_gpuStats;
+	vector<FrameType> m_frames;
+	int m_warmupFrames, m_frameCount, m_frame;
+	int m_firstGpuFrame, m_pendingFrame;
+	float m_timestep;
+	bool m_running, m_finished;
+	chrono::steady_clock::time_point m_frameStart;
+};
+
+#endif
\ No newline at end of file
@@ -6,11 +6,9 @@
 
 BumpMapShaderClass::BumpMapShaderClass()
 {
-	m_vertexShader = 0;
-	m_pixelShader = 0;
-	m_layout = 0;
+	m_Device = 0;
+	m_pipeline = 0;
 	m_matrixBuffer = 0;
-	m_sampleState = 0;
 	m_lightBuffer = 0;
 }
 
@@ -25,13 +23,16 @@ BumpMapShaderClass::~BumpMapShaderClass()
 }
 
 
-bool BumpMapShaderClass::Initialize(ID3D11Device* device, HWND hwnd)
+bool BumpMapShaderClass::Initialize(RenderDeviceClass* device)
 {
 	bool result;
 
 
+	// Store the device the shader objects are created on.
+	m_Device = device;
+
 	// Initialize the vertex and pixel shaders.
-	result = InitializeShader(device, hwnd, L"../Engine/bumpmap.vs", L"../Engine/bumpmap.ps");
+	result = InitializeShader(L"../Engine/bumpmap.vs", L"../Engine/bumpmap.ps");
 	if(!result)
 	{
 		return false;
@@ -50,209 +51,62 @@ void BumpMapShaderClass::Shutdown()
 }
 
 
-bool BumpMapShaderClass::Render(ID3D11DeviceContext* deviceContext, int indexCount, const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix,
-	const XMMATRIX &projectionMatrix, ID3D11ShaderResourceView* colorTexture, ID3D11ShaderResourceView* normalMapTexture,
-	XMFLOAT3 lightDirection, XMFLOAT4 diffuseColor)
+bool BumpMapShaderClass::Render(int indexCount, const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix,
+	int colorTexture, int normalMapTexture, XMFLOAT3 lightDirection, XMFLOAT4 diffuseColor)
 {
 	bool result;
 
 
 	// Set the shader parameters that it will use for rendering.
-	result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, colorTexture, normalMapTexture, 
-								 lightDirection, diffuseColor);
+	result = SetShaderParameters(worldMatrix, viewMatrix, projectionMatrix, colorTexture, normalMapTexture, lightDirection, diffuseColor);
 	if(!result)
 	{
 		return false;
 	}
 
 	// Now render the prepared buffers with the shader.
-	RenderShader(deviceContext, indexCount);
+	RenderShader(indexCount);
 
 	return true;
 }
 
 
-bool BumpMapShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename)
+int BumpMapShaderClass::GetPipeline()
 {
-	HRESULT result;
-	ID3D10Blob* errorMessage;
-	ID3D10Blob* vertexShaderBuffer;
-	ID3D10Blob* pixelShaderBuffer;
-	D3D11_INPUT_ELEMENT_DESC polygonLayout[5];
-	unsigned int numElements;
-	D3D11_BUFFER_DESC matrixBufferDesc;
-    D3D11_SAMPLER_DESC samplerDesc;
-	D3D11_BUFFER_DESC lightBufferDesc;
-
-
-	// Initialize the pointers this function will use to null.
-	errorMessage = 0;
-	vertexShaderBuffer = 0;
-	pixelShaderBuffer = 0;
-
-    // Compile the vertex shader code.
-	result = D3DCompileFromFile(vsFilename, NULL, NULL, "BumpMapVertexShader", "vs_5_0",
-		D3D10_SHADER_ENABLE_STRICTNESS, 0, &vertexShaderBuffer, &errorMessage);
-
-	if(FAILED(result))
-	{
-		// If the shader failed to compile it should have writen something to the error message.
-		if(errorMessage)
-		{
-			OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
-		}
-		// If there was  nothing in the error message then it simply could not find the shader file itself.
-		else
-		{
-			MessageBox(hwnd, vsFilename, L"Missing Shader File", MB_OK);
-		}
-
-		return false;
-	}
-
-    // Compile the pixel shader code.
-	result = D3DCompileFromFile(psFilename, NULL, NULL, "BumpMapPixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, &pixelShaderBuffer, &errorMessage);
-
-	if(FAILED(result))
-	{
-		// If the shader failed to compile it should have writen something to the error message.
-		if(errorMessage)
-		{
-			OutputShaderErrorMessage(errorMessage, hwnd, psFilename);
-		}
-		// If there was  nothing in the error message then it simply could not find the file itself.
-		else
-		{
-			MessageBox(hwnd, psFilename, L"Missing Shader File", MB_OK);
-		}
-
-		return false;
-	}
-
-    // Create the vertex shader from the buffer.
-    result = device->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, 
-										&m_vertexShader);
-	if(FAILED(result))
-	{
-		return false;
-	}
-
-    // Create the vertex shader from the buffer.
-    result = device->CreatePixelShader(pixelShaderBuffer->GetBufferPointer(), pixelShaderBuffer->GetBufferSize(), NULL, 
-									   &m_pixelShader);
-	if(FAILED(result))
-	{
-		return false;
-	}
+	return m_pipeline;
+}
 
-	// Create the vertex input layout description.
-	// This setup needs to match the VertexType stucture in the ModelClass and in the shader.
-	polygonLayout[0].SemanticName = "POSITION";
-	polygonLayout[0].SemanticIndex = 0;
-	polygonLayout[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	polygonLayout[0].InputSlot = 0;
-	polygonLayout[0].AlignedByteOffset = 0;
-	polygonLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	polygonLayout[0].InstanceDataStepRate = 0;
-
-	polygonLayout[1].SemanticName = "TEXCOORD";
-	polygonLayout[1].SemanticIndex = 0;
-	polygonLayout[1].Format = DXGI_FORMAT_R32G32_FLOAT;
-	polygonLayout[1].InputSlot = 0;
-	polygonLayout[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	polygonLayout[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	polygonLayout[1].InstanceDataStepRate = 0;
-
-	polygonLayout[2].SemanticName = "NORMAL";
-	polygonLayout[2].SemanticIndex = 0;
-	polygonLayout[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	polygonLayout[2].InputSlot = 0;
-	polygonLayout[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	polygonLayout[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	polygonLayout[2].InstanceDataStepRate = 0;
-
-	polygonLayout[3].SemanticName = "TANGENT";
-	polygonLayout[3].SemanticIndex = 0;
-	polygonLayout[3].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	polygonLayout[3].InputSlot = 0;
-	polygonLayout[3].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	polygonLayout[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	polygonLayout[3].InstanceDataStepRate = 0;
-
-	polygonLayout[4].SemanticName = "BINORMAL";
-	polygonLayout[4].SemanticIndex = 0;
-	polygonLayout[4].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	polygonLayout[4].InputSlot = 0;
-	polygonLayout[4].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	polygonLayout[4].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	polygonLayout[4].InstanceDataStepRate = 0;
-
-	// Get a count of the elements in the layout.
-    numElements = sizeof(polygonLayout) / sizeof(polygonLayout[0]);
-
-	// Create the vertex input layout.
-	result = device->CreateInputLayout(polygonLayout, numElements, vertexShaderBuffer->GetBufferPointer(), 
-									   vertexShaderBuffer->GetBufferSize(), &m_layout);
-	if(FAILED(result))
-	{
-		return false;
-	}
 
-	// Release the vertex shader buffer and pixel shader buffer since they are no longer needed.
-	vertexShaderBuffer->Release();
-	vertexShaderBuffer = 0;
+bool BumpMapShaderClass::InitializeShader(const wchar_t* vsFilename, const wchar_t* psFilename)
+{
+	RenderDeviceClass::PipelineDescType pipelineDesc;
 
-	pixelShaderBuffer->Release();
-	pixelShaderBuffer = 0;
 
-    // Setup the description of the matrix dynamic constant buffer that is in the vertex shader.
-    matrixBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-	matrixBufferDesc.ByteWidth = sizeof(MatrixBufferType);
-    matrixBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-    matrixBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-    matrixBufferDesc.MiscFlags = 0;
-	matrixBufferDesc.StructureByteStride = 0;
+	// Describe the pipeline with the input layout matching the VertexType structure in the BumpModelClass.
+	pipelineDesc.vertexShaderFilename = vsFilename;
+	pipelineDesc.vertexShaderEntryPoint = "BumpMapVertexShader";
+	pipelineDesc.vertexFormat = RenderDeviceClass::VERTEX_FORMAT_BUMPMAP;
+	pipelineDesc.pixelShaderFilename = psFilename;
+	pipelineDesc.pixelShaderEntryPoint = "BumpMapPixelShader";
+	pipelineDesc.sampler = RenderDeviceClass::SAMPLER_LINEAR_WRAP;
 
-	// Create the matrix constant buffer pointer so we can access the vertex shader constant buffer from within this class.
-	result = device->CreateBuffer(&matrixBufferDesc, NULL, &m_matrixBuffer);
-	if(FAILED(result))
+	// Create the pipeline, it shares any shader or sampler another pipeline already created.
+	m_pipeline = m_Device->CreatePipeline(pipelineDesc);
+	if(!m_pipeline)
 	{
 		return false;
 	}
 
-	// Create a texture sampler state description.
-    samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-    samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
-    samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
-    samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
-    samplerDesc.MipLODBias = 0.0f;
-    samplerDesc.MaxAnisotropy = 1;
-    samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
-    samplerDesc.BorderColor[0] = 0;
-	samplerDesc.BorderColor[1] = 0;
-	samplerDesc.BorderColor[2] = 0;
-	samplerDesc.BorderColor[3] = 0;
-    samplerDesc.MinLOD = 0;
-    samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
-
-	// Create the texture sampler state.
-    result = device->CreateSamplerState(&samplerDesc, &m_sampleState);
-	if(FAILED(result))
+	// Create the dynamic matrix constant buffer that is in the vertex shader.
+	m_matrixBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_CONSTANT_BUFFER, NULL, sizeof(MatrixBufferType));
+	if(!m_matrixBuffer)
 	{
 		return false;
 	}
 
-	// Setup the description of the light dynamic constant buffer that is in the pixel shader.
-	lightBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-	lightBufferDesc.ByteWidth = sizeof(LightBufferType);
-	lightBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-	lightBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	lightBufferDesc.MiscFlags = 0;
-	lightBufferDesc.StructureByteStride = 0;
-
-	// Create the constant buffer pointer so we can access the vertex shader constant buffer from within this class.
-	result = device->CreateBuffer(&lightBufferDesc, NULL, &m_lightBuffer);
-	if(FAILED(result))
+	// Create the dynamic light constant buffer that is in the pixel shader.
+	m_lightBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_CONSTANT_BUFFER, NULL, sizeof(LightBufferType));
+	if(!m_lightBuffer)
 	{
 		return false;
 	}
@@ -266,168 +120,80 @@ void BumpMapShaderClass::ShutdownShader()
 	// Release the light constant buffer.
 	if(m_lightBuffer)
 	{
-		m_lightBuffer->Release();
+		m_Device->ReleaseResource(m_lightBuffer);
 		m_lightBuffer = 0;
 	}
 
-	// Release the sampler state.
-	if(m_sampleState)
-	{
-		m_sampleState->Release();
-		m_sampleState = 0;
-	}
-
 	// Release the matrix constant buffer.
 	if(m_matrixBuffer)
 	{
-		m_matrixBuffer->Release();
+		m_Device->ReleaseResource(m_matrixBuffer);
 		m_matrixBuffer = 0;
 	}
 
-	// Release the layout.
-	if(m_layout)
-	{
-		m_layout->Release();
-		m_layout = 0;
-	}
-
-	// Release the pixel shader.
-	if(m_pixelShader)
+	// Release the pipeline.
+	if(m_pipeline)
 	{
-		m_pixelShader->Release();
-		m_pixelShader = 0;
-	}
-
-	// Release the vertex shader.
-	if(m_vertexShader)
-	{
-		m_vertexShader->Release();
-		m_vertexShader = 0;
+		m_Device->ReleasePipeline(m_pipeline);
+		m_pipeline = 0;
 	}
 
 	return;
 }
 
 
-void BumpMapShaderClass::OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND hwnd, WCHAR* shaderFilename)
+bool BumpMapShaderClass::SetShaderParameters(const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix,
+	int colorTexture, int normalMapTexture, XMFLOAT3 lightDirection, XMFLOAT4 diffuseColor)
 {
-	char* compileErrors;
-	unsigned long bufferSize, i;
-	ofstream fout;
-
-
-	// Get a pointer to the error message text buffer.
-	compileErrors = (char*)(errorMessage->GetBufferPointer());
-
-	// Get the length of the message.
-	bufferSize = errorMessage->GetBufferSize();
-
-	// Open a file to write the error message to.
-	fout.open("shader-error.txt");
-
-	// Write out the error message.
-	for(i=0; i<bufferSize; i++)
-	{
-		fout << compileErrors[i];
-	}
-
-	// Close the file.
-	fout.close();
-
-	// Release the error message.
-	errorMessage->Release();
-	errorMessage = 0;
-
-	// Pop a message up on the screen to notify the user to check the text file for compile errors.
-	MessageBox(hwnd, L"Error compiling shader.  Check shader-error.txt for message.", shaderFilename, MB_OK);
-
-	return;
-}
-
-
-bool BumpMapShaderClass::SetShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX &worldMatrix,
-	const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix,
-											 ID3D11ShaderResourceView* colorTexture, ID3D11ShaderResourceView* normalMapTexture, 
-											 XMFLOAT3 lightDirection, XMFLOAT4 diffuseColor)
-{
-	HRESULT result;
-    D3D11_MAPPED_SUBRESOURCE mappedResource;
-	MatrixBufferType* dataPtr;
-	unsigned int bufferNumber;
-	LightBufferType* dataPtr2;
+	MatrixBufferType matrixBuffer;
+	LightBufferType lightBuffer;
+	bool result;
 
 
 	// Transpose the matrices to prepare them for the shader.
+	matrixBuffer.world = XMMatrixTranspose(worldMatrix);
+	matrixBuffer.view = XMMatrixTranspose(viewMatrix);
+	matrixBuffer.projection = XMMatrixTranspose(projectionMatrix);
 
-	// Lock the matrix constant buffer so it can be written to.
-	result = deviceContext->Map(m_matrixBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	if(FAILED(result))
+	// Copy the matrices into the matrix constant buffer.
+	result = m_Device->UpdateBuffer(m_matrixBuffer, &matrixBuffer, sizeof(MatrixBufferType));
+	if(!result)
 	{
 		return false;
 	}
 
-	// Get a pointer to the data in the constant buffer.
-	dataPtr = (MatrixBufferType*)mappedResource.pData;
-
-	// Copy the matrices into the constant buffer.
-	dataPtr->world = XMMatrixTranspose(worldMatrix);
-	dataPtr->view = XMMatrixTranspose(viewMatrix);
-	dataPtr->projection = XMMatrixTranspose(projectionMatrix);
-
-	// Unlock the matrix constant buffer.
-    deviceContext->Unmap(m_matrixBuffer, 0);
-
-	// Set the position of the matrix constant buffer in the vertex shader.
-	bufferNumber = 0;
-
 	// Now set the matrix constant buffer in the vertex shader with the updated values.
-    deviceContext->VSSetConstantBuffers(bufferNumber, 1, &m_matrixBuffer);
+	m_Device->SetConstantBuffer(RenderDeviceClass::SHADER_STAGE_VERTEX, 0, m_matrixBuffer);
 
 	// Set shader texture resources in the pixel shader.
-	deviceContext->PSSetShaderResources(0, 1, &colorTexture);
-	deviceContext->PSSetShaderResources(1, 1, &normalMapTexture);
+	m_Device->SetTexture(0, colorTexture);
+	m_Device->SetTexture(1, normalMapTexture);
+
+	// Copy the lighting variables into the light constant buffer.
+	lightBuffer.diffuseColor = diffuseColor;
+	lightBuffer.lightDirection = lightDirection;
+	lightBuffer.padding = 0.0f;
 
-	// Lock the light constant buffer so it can be written to.
-	result = deviceContext->Map(m_lightBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	if(FAILED(result))
+	result = m_Device->UpdateBuffer(m_lightBuffer, &lightBuffer, sizeof(LightBufferType));
+	if(!result)
 	{
 		return false;
 	}
 
-	// Get a pointer to the data in the constant buffer.
-	dataPtr2 = (LightBufferType*)mappedResource.pData;
-
-	// Copy the lighting variables into the constant buffer.
-	dataPtr2->diffuseColor = diffuseColor;
-	dataPtr2->lightDirection = lightDirection;
-
-	// Unlock the constant buffer.
-	deviceContext->Unmap(m_lightBuffer, 0);
-
-	// Set the position of the light constant buffer in the pixel shader.
-	bufferNumber = 0;
-
 	// Finally set the light constant buffer in the pixel shader with the updated values.
-	deviceContext->PSSetConstantBuffers(bufferNumber, 1, &m_lightBuffer);
+	m_Device->SetConstantBuffer(RenderDeviceClass::SHADER_STAGE_PIXEL, 0, m_lightBuffer);
 
 	return true;
 }
 
 
-void BumpMapShaderClass::RenderShader(ID3D11DeviceContext* deviceContext, int indexCount)
+void BumpMapShaderClass::RenderShader(int indexCount)
 {
-	// Set the vertex input layout.
-	deviceContext->IASetInputLayout(m_layout);
-
-    // Set the vertex and pixel shaders that will be used to render this triangle.
-    deviceContext->VSSetShader(m_vertexShader, NULL, 0);
-    deviceContext->PSSetShader(m_pixelShader, NULL, 0);
-
-	// Set the sampler state in the pixel shader.
-	deviceContext->PSSetSamplers(0, 1, &m_sampleState);
+	// Bind the shaders, input layout and sampler in one go.
+	m_Device->SetPipeline(m_pipeline);
 
 	// Render the triangles.
-	deviceContext->DrawIndexed(indexCount, 0, 0);
+	m_Device->DrawIndexed(indexCount);
 
 	return;
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 BumpModelClass::BumpModelClass()
 {
+	m_Device = 0;
 	m_vertexBuffer = 0;
 	m_indexBuffer = 0;
 	m_model = 0;
@@ -24,11 +25,14 @@ BumpModelClass::~BumpModelClass()
 }
 
 
-bool BumpModelClass::Initialize(ID3D11Device* device, char* modelFilename, WCHAR* textureFilename1, WCHAR* textureFilename2)
+bool BumpModelClass::Initialize(RenderDeviceClass* device, char* modelFilename, const wchar_t* textureFilename1, const wchar_t* textureFilename2)
 {
 	bool result;
 
 
+	// Store the device the buffers and textures are created on.
+	m_Device = device;
+
 	// Load in the model data,
 	result = LoadModel(modelFilename);
 	if(!result)
@@ -40,14 +44,14 @@ bool BumpModelClass::Initialize(ID3D11Device* device, char* modelFilename, WCHAR
 	CalculateModelVectors();
 
 	// Initialize the vertex and index buffers.
-	result = InitializeBuffers(device);
+	result = InitializeBuffers();
 	if(!result)
 	{
 		return false;
 	}
 
 	// Load the textures for this model.
-	result = LoadTextures(device, textureFilename1, textureFilename2);
+	result = LoadTextures(textureFilename1, textureFilename2);
 	if(!result)
 	{
 		return false;
@@ -72,10 +76,10 @@ void BumpModelClass::Shutdown()
 }
 
 
-void BumpModelClass::Render(ID3D11DeviceContext* deviceContext)
+void BumpModelClass::Render()
 {
 	// Put the vertex and index buffers on the graphics pipeline to prepare them for drawing.
-	RenderBuffers(deviceContext);
+	RenderBuffers();
 
 	return;
 }
@@ -87,25 +91,22 @@ int BumpModelClass::GetIndexCount()
 }
 
 
-ID3D11ShaderResourceView* BumpModelClass::GetColorTexture()
+int BumpModelClass::GetColorTexture()
 {
 	return m_ColorTexture->GetTexture();
 }
 
 
-ID3D11ShaderResourceView* BumpModelClass::GetNormalMapTexture()
+int BumpModelClass::GetNormalMapTexture()
 {
 	return m_NormalMapTexture->GetTexture();
 }
 
 
-bool BumpModelClass::InitializeBuffers(ID3D11Device* device)
+bool BumpModelClass::InitializeBuffers()
 {
 	VertexType* vertices;
-	unsigned long* indices;
-	D3D11_BUFFER_DESC vertexBufferDesc, indexBufferDesc;
-	D3D11_SUBRESOURCE_DATA vertexData, indexData;
-	HRESULT result;
+	unsigned int* indices;
 	int i;
 
 
@@ -117,7 +118,7 @@ bool BumpModelClass::InitializeBuffers(ID3D11Device* device)
 	}
 
 	// Create the index array.
-	indices = new unsigned long[m_indexCount];
+	indices = new unsigned int[m_indexCount];
 	if(!indices)
 	{
 		return false;
@@ -135,42 +136,16 @@ bool BumpModelClass::InitializeBuffers(ID3D11Device* device)
 		indices[i] = i;
 	}
 
-	// Set up the description of the static vertex buffer.
-    vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-    vertexBufferDesc.ByteWidth = sizeof(VertexType) * m_vertexCount;
-    vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-    vertexBufferDesc.CPUAccessFlags = 0;
-    vertexBufferDesc.MiscFlags = 0;
-	vertexBufferDesc.StructureByteStride = 0;
-
-	// Give the subresource structure a pointer to the vertex data.
-    vertexData.pSysMem = vertices;
-	vertexData.SysMemPitch = 0;
-	vertexData.SysMemSlicePitch = 0;
-
-	// Now create the vertex buffer.
-    result = device->CreateBuffer(&vertexBufferDesc, &vertexData, &m_vertexBuffer);
-	if(FAILED(result))
+	// Now create the static vertex buffer.
+	m_vertexBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_VERTEX_BUFFER, vertices, sizeof(VertexType) * m_vertexCount);
+	if(!m_vertexBuffer)
 	{
 		return false;
 	}
 
-	// Set up the description of the static index buffer.
-    indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-    indexBufferDesc.ByteWidth = sizeof(unsigned long) * m_indexCount;
-    indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-    indexBufferDesc.CPUAccessFlags = 0;
-    indexBufferDesc.MiscFlags = 0;
-	indexBufferDesc.StructureByteStride = 0;
-
-	// Give the subresource structure a pointer to the index data.
-    indexData.pSysMem = indices;
-	indexData.SysMemPitch = 0;
-	indexData.SysMemSlicePitch = 0;
-
-	// Create the index buffer.
-	result = device->CreateBuffer(&indexBufferDesc, &indexData, &m_indexBuffer);
-	if(FAILED(result))
+	// Create the static index buffer.
+	m_indexBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_INDEX_BUFFER, indices, sizeof(unsigned int) * m_indexCount);
+	if(!m_indexBuffer)
 	{
 		return false;
 	}
@@ -191,14 +166,14 @@ void BumpModelClass::ShutdownBuffers()
 	// Release the index buffer.
 	if(m_indexBuffer)
 	{
-		m_indexBuffer->Release();
+		m_Device->ReleaseResource(m_indexBuffer);
 		m_indexBuffer = 0;
 	}
 
 	// Release the vertex buffer.
 	if(m_vertexBuffer)
 	{
-		m_vertexBuffer->Release();
+		m_Device->ReleaseResource(m_vertexBuffer);
 		m_vertexBuffer = 0;
 	}
 
@@ -206,30 +181,19 @@ void BumpModelClass::ShutdownBuffers()
 }
 
 
-void BumpModelClass::RenderBuffers(ID3D11DeviceContext* deviceContext)
+void BumpModelClass::RenderBuffers()
 {
-	unsigned int stride;
-	unsigned int offset;
-
-
-	// Set vertex buffer stride and offset.
-	stride = sizeof(VertexType); 
-	offset = 0;
-    
 	// Set the vertex buffer to active in the input assembler so it can be rendered.
-	deviceContext->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
-
-    // Set the index buffer to active in the input assembler so it can be rendered.
-	deviceContext->IASetIndexBuffer(m_indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	m_Device->SetVertexBuffer(m_vertexBuffer, sizeof(VertexType));
 
-    // Set the type of primitive that should be rendered from this vertex buffer, in this case triangles.
-	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	// Set the index buffer to active in the input assembler so it can be rendered.
+	m_Device->SetIndexBuffer(m_indexBuffer);
 
 	return;
 }
 
 
-bool BumpModelClass::LoadTextures(ID3D11Device* device, WCHAR* filename1, WCHAR* filename2)
+bool BumpModelClass::LoadTextures(const wchar_t* filename1, const wchar_t* filename2)
 {
 	bool result;
 
@@ -242,7 +206,7 @@ bool BumpModelClass::LoadTextures(ID3D11Device* device, WCHAR* filename1, WCHAR*
 	}
 
 	// Initialize the color texture object.
-	result = m_ColorTexture->Initialize(device, filename1);
+	result = m_ColorTexture->Initialize(m_Device, filename1);
 	if(!result)
 	{
 		return false;
@@ -256,7 +220,7 @@ bool BumpModelClass::LoadTextures(ID3D11Device* device, WCHAR* filename1, WCHAR*
 	}
 
 	// Initialize the normal map texture object.
-	result = m_NormalMapTexture->Initialize(device, filename2);
+	result = m_NormalMapTexture->Initialize(m_Device, filename2);
 	if(!result)
 	{
 		return false;
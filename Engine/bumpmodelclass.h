@@ -8,8 +8,8 @@
 //////////////
 // INCLUDES //
 //////////////
-#include <d3d11_1.h>
-#include <directXMath.h>
+#include <math.h>
+#include <DirectXMath.h>
 using namespace DirectX;
 
 #include <fstream>
@@ -19,6 +19,7 @@ using namespace std;
 ///////////////////////
 // MY CLASS INCLUDES //
 ///////////////////////
+#include "renderdeviceclass.h"
 #include "textureclass.h"
 
 
@@ -63,20 +64,20 @@ public:
 	BumpModelClass(const BumpModelClass&);
 	~BumpModelClass();
 
-	bool Initialize(ID3D11Device*, char*, WCHAR*, WCHAR*);
+	bool Initialize(RenderDeviceClass*, char*, const wchar_t*, const wchar_t*);
 	void Shutdown();
-	void Render(ID3D11DeviceContext*);
+	void Render();
 
 	int GetIndexCount();
-	ID3D11ShaderResourceView* GetColorTexture();
-	ID3D11ShaderResourceView* GetNormalMapTexture();
+	int GetColorTexture();
+	int GetNormalMapTexture();
 
 private:
-	bool InitializeBuffers(ID3D11Device*);
+	bool InitializeBuffers();
 	void ShutdownBuffers();
-	void RenderBuffers(ID3D11DeviceContext*);
+	void RenderBuffers();
 
-	bool LoadTextures(ID3D11Device*, WCHAR*, WCHAR*);
+	bool LoadTextures(const wchar_t*, const wchar_t*);
 	void ReleaseTextures();
 
 	bool LoadModel(char*);
@@ -86,7 +87,8 @@ private:
 	void CalculateTangentBinormal(TempVertexType, TempVertexType, TempVertexType, VectorType&, VectorType&);
 
 private:
-	ID3D11Buffer *m_vertexBuffer, *m_indexBuffer;
+	RenderDeviceClass* m_Device;
+	int m_vertexBuffer, m_indexBuffer;
 	int m_vertexCount, m_indexCount;
 	ModelType* m_model;
 	TextureClass* m_ColorTexture;
@@ -13,6 +13,16 @@ CameraClass::CameraClass()
 	m_rotationX = 0.0f;
 	m_rotationY = 0.0f;
 	m_rotationZ = 0.0f;
+
+	XMStoreFloat4x4(&m_projectionMatrix, XMMatrixIdentity());
+	XMStoreFloat4x4(&m_baseViewMatrix, XMMatrixIdentity());
+	XMStoreFloat4x4(&m_reflectionViewMatrix, XMMatrixIdentity());
+	m_reflectionHeight = 0.0f;
+	m_dirty = true;
+	m_reflectionDirty = true;
+	m_version = 0;
+
+	Update();
 }
 
 
@@ -28,18 +38,48 @@ CameraClass::~CameraClass()
 
 void CameraClass::SetPosition(float x, float y, float z)
 {
-	m_positionX = x;
-	m_positionY = y;
-	m_positionZ = z;
+	// Only a camera that really moved has to work its matrices out again.
+	if(x != m_positionX || y != m_positionY || z != m_positionZ)
+	{
+		m_positionX = x;
+		m_positionY = y;
+		m_positionZ = z;
+		m_dirty = true;
+		m_reflectionDirty = true;
+	}
+
 	return;
 }
 
 
 void CameraClass::SetRotation(float x, float y, float z)
 {
-	m_rotationX = x;
-	m_rotationY = y;
-	m_rotationZ = z;
+	if(x != m_rotationX || y != m_rotationY || z != m_rotationZ)
+	{
+		m_rotationX = x;
+		m_rotationY = y;
+		m_rotationZ = z;
+		m_dirty = true;
+		m_reflectionDirty = true;
+	}
+
+	return;
+}
+
+
+void CameraClass::SetProjectionMatrix(const XMMATRIX& projectionMatrix)
+{
+	XMFLOAT4X4 matrix;
+
+
+	// The view-projection matrix and the frustum planes depend on the projection as well.
+	XMStoreFloat4x4(&matrix, projectionMatrix);
+	if(memcmp(&matrix, &m_projectionMatrix, sizeof(matrix)) != 0)
+	{
+		m_projectionMatrix = matrix;
+		m_dirty = true;
+	}
+
 	return;
 }
 
@@ -58,84 +98,112 @@ XMFLOAT3 CameraClass::GetRotation()
 
 void CameraClass::Render()
 {
-	XMVECTOR up, position, lookAt;
-	float yaw, pitch, roll;
-	XMMATRIX rotationMatrix;
+	// Bring the view up to date, which does nothing when the camera has not changed.
+	Update();
 
+	return;
+}
 
-	// Setup the vector that points upwards.
-	up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
 
-	// Setup the position of the camera in the world.
-	position = XMVectorSet(m_positionX, m_positionY, m_positionZ, 0.0f);
+void CameraClass::GetViewMatrix(XMMATRIX& viewMatrix)
+{
+	Update();
+	viewMatrix = XMLoadFloat4x4(&m_viewMatrix);
+	return;
+}
 
-	// Setup where the camera is looking by default.
-	lookAt = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
 
-	// Set the yaw (Y axis), pitch (X axis), and roll (Z axis) rotations in radians.
-	pitch = m_rotationX * 0.0174532925f;
-	yaw   = m_rotationY * 0.0174532925f;
-	roll  = m_rotationZ * 0.0174532925f;
+void CameraClass::GetViewProjectionMatrix(XMMATRIX& viewProjectionMatrix)
+{
+	Update();
+	viewProjectionMatrix = XMLoadFloat4x4(&m_viewProjectionMatrix);
+	return;
+}
 
-	// Create the rotation matrix from the yaw, pitch, and roll values.
-	rotationMatrix = XMMatrixRotationRollPitchYaw(pitch, yaw, roll); //Is the order correct, Xu 13/11/2015
 
-	// Transform the lookAt and up vector by the rotation matrix so the view is correctly rotated at the origin.
-	lookAt = XMVector3TransformCoord(lookAt, rotationMatrix);
+void CameraClass::GetInverseViewMatrix(XMMATRIX& inverseViewMatrix)
+{
+	Update();
+	inverseViewMatrix = XMLoadFloat4x4(&m_inverseViewMatrix);
+	return;
+}
 
-	up = XMVector3TransformCoord(up, rotationMatrix);
 
-	// Translate the rotated camera position to the location of the viewer.
-	lookAt = position + lookAt;
+void CameraClass::GetFrustumPlanes(XMFLOAT4* planes)
+{
+	int i;
 
-	// Finally create the view matrix from the three updated vectors.
-	m_viewMatrix = XMMatrixLookAtLH(position, lookAt, up);
 
-	return;
-}
+	Update();
 
+	for(i=0; i<CAMERA_FRUSTUM_PLANES; i++)
+	{
+		planes[i] = m_frustumPlanes[i];
+	}
 
-void CameraClass::GetViewMatrix(XMMATRIX& viewMatrix)
-{
-	viewMatrix = m_viewMatrix;
 	return;
 }
 
 
-void CameraClass::GenerateBaseViewMatrix()
+unsigned int CameraClass::GetVersion()
 {
-	XMVECTOR up, position, lookAt;
-	float yaw, pitch, roll;
-	XMMATRIX rotationMatrix;
+	Update();
+	return m_version;
+}
 
 
-	// Setup the vector that points upwards.
-	up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+bool CameraClass::CheckSphere(const XMFLOAT3& center, float radius)
+{
+	const XMFLOAT4* plane;
+	int i;
 
-	// Setup the position of the camera in the world.
-	position = XMVectorSet(m_positionX, m_positionY, m_positionZ, 0.0f);
 
-	// Setup where the camera is looking by default.
-	lookAt = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+	Update();
 
-	// Set the yaw (Y axis), pitch (X axis), and roll (Z axis) rotations in radians.
-	pitch = m_rotationX * 0.0174532925f;
-	yaw = m_rotationY * 0.0174532925f;
-	roll = m_rotationZ * 0.0174532925f;
+	// The sphere is outside once it is wholly behind any one of the planes.
+	for(i=0; i<CAMERA_FRUSTUM_PLANES; i++)
+	{
+		plane = &m_frustumPlanes[i];
+		if(plane->x * center.x + plane->y * center.y + plane->z * center.z + plane->w < -radius)
+		{
+			return false;
+		}
+	}
 
-	// Create the rotation matrix from the yaw, pitch, and roll values.
-	rotationMatrix = XMMatrixRotationRollPitchYaw(pitch, yaw, roll); //Is the order correct, Xu 13/11/2015
+	return true;
+}
 
-	// Transform the lookAt and up vector by the rotation matrix so the view is correctly rotated at the origin.
-	lookAt = XMVector3TransformCoord(lookAt, rotationMatrix);
 
-	up = XMVector3TransformCoord(up, rotationMatrix);
+bool CameraClass::CheckBox(const XMFLOAT3& center, const XMFLOAT3& extents)
+{
+	const XMFLOAT4* plane;
+	float distance, radius;
+	int i;
+
+
+	Update();
+
+	// The box reaches as far towards each plane as its extents projected onto the plane normal.
+	for(i=0; i<CAMERA_FRUSTUM_PLANES; i++)
+	{
+		plane = &m_frustumPlanes[i];
+		distance = plane->x * center.x + plane->y * center.y + plane->z * center.z + plane->w;
+		radius = fabsf(plane->x) * extents.x + fabsf(plane->y) * extents.y + fabsf(plane->z) * extents.z;
+		if(distance < -radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
 
-	// Translate the rotated camera position to the location of the viewer.
-	lookAt = position + lookAt;
 
-	// Finally create the baseView matrix from the three updated vectors.
-	m_baseViewMatrix = XMMatrixLookAtLH(position, lookAt, up);
+void CameraClass::GenerateBaseViewMatrix()
+{
+	// The base view is the view as it is now.
+	Update();
+	m_baseViewMatrix = m_viewMatrix;
 
 	return;
 }
@@ -143,30 +211,109 @@ void CameraClass::GenerateBaseViewMatrix()
 
 void CameraClass::GetBaseViewMatrix(XMMATRIX& viewMatrix)
 {
-	viewMatrix = m_baseViewMatrix;
+	viewMatrix = XMLoadFloat4x4(&m_baseViewMatrix);
 	return;
 }
 
 
 void CameraClass::RenderReflection(float height)
+{
+	// Mirror the camera in the plane at the height, only when the camera or the height changed.
+	if(m_reflectionDirty || height != m_reflectionHeight)
+	{
+		XMStoreFloat4x4(&m_reflectionViewMatrix, BuildViewMatrix(m_positionX, -m_positionY + (height * 2.0f), m_positionZ, -m_rotationX, m_rotationY, m_rotationZ));
+		m_reflectionHeight = height;
+		m_reflectionDirty = false;
+	}
+
+	return;
+}
+
+
+void CameraClass::GetReflectionViewMatrix(XMMATRIX& viewMatrix)
+{
+	viewMatrix = XMLoadFloat4x4(&m_reflectionViewMatrix);
+	return;
+}
+
+
+void CameraClass::Update()
+{
+	XMMATRIX viewMatrix, viewProjectionMatrix;
+	XMFLOAT4X4 m;
+	XMFLOAT4* plane;
+	float length;
+	int i;
+
+
+	if(!m_dirty)
+	{
+		return;
+	}
+
+	// Work out the view and everything that follows from it in one go.
+	viewMatrix = BuildViewMatrix(m_positionX, m_positionY, m_positionZ, m_rotationX, m_rotationY, m_rotationZ);
+	viewProjectionMatrix = XMMatrixMultiply(viewMatrix, XMLoadFloat4x4(&m_projectionMatrix));
+
+	XMStoreFloat4x4(&m_viewMatrix, viewMatrix);
+	XMStoreFloat4x4(&m_viewProjectionMatrix, viewProjectionMatrix);
+	XMStoreFloat4x4(&m_inverseViewMatrix, XMMatrixInverse(0, viewMatrix));
+
+	// Pull the frustum planes out of the columns of the view-projection matrix, a point is inside when 0 <= z <= w and
+	// -w <= x, y <= w in clip space.
+	m = m_viewProjectionMatrix;
+	m_frustumPlanes[0] = XMFLOAT4(m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41);
+	m_frustumPlanes[1] = XMFLOAT4(m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41);
+	m_frustumPlanes[2] = XMFLOAT4(m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42);
+	m_frustumPlanes[3] = XMFLOAT4(m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42);
+	m_frustumPlanes[4] = XMFLOAT4(m._13, m._23, m._33, m._43);
+	m_frustumPlanes[5] = XMFLOAT4(m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43);
+
+	// Normalize the planes so the distances are in world units, a plane at infinity keeps everything in.
+	for(i=0; i<CAMERA_FRUSTUM_PLANES; i++)
+	{
+		plane = &m_frustumPlanes[i];
+		length = sqrtf(plane->x * plane->x + plane->y * plane->y + plane->z * plane->z);
+		if(length > 1.0e-6f)
+		{
+			plane->x /= length;
+			plane->y /= length;
+			plane->z /= length;
+			plane->w /= length;
+		}
+		else
+		{
+			*plane = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+		}
+	}
+
+	m_version++;
+	m_dirty = false;
+
+	return;
+}
+
+
+XMMATRIX CameraClass::BuildViewMatrix(float positionX, float positionY, float positionZ, float rotationX, float rotationY, float rotationZ)
 {
 	XMVECTOR up, position, lookAt;
 	float yaw, pitch, roll;
 	XMMATRIX rotationMatrix;
 
+
 	// Setup the vector that points upwards.
 	up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
 
 	// Setup the position of the camera in the world.
-	position = XMVectorSet(m_positionX, -m_positionY + (height * 2.0f), m_positionZ, 0.0f);
+	position = XMVectorSet(positionX, positionY, positionZ, 0.0f);
 
 	// Setup where the camera is looking by default.
 	lookAt = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
 
 	// Set the yaw (Y axis), pitch (X axis), and roll (Z axis) rotations in radians.
-	pitch = -m_rotationX * 0.0174532925f;
-	yaw = m_rotationY * 0.0174532925f;
-	roll = m_rotationZ * 0.0174532925f;
+	pitch = rotationX * 0.0174532925f;
+	yaw   = rotationY * 0.0174532925f;
+	roll  = rotationZ * 0.0174532925f;
 
 	// Create the rotation matrix from the yaw, pitch, and roll values.
 	rotationMatrix = XMMatrixRotationRollPitchYaw(pitch, yaw, roll); //Is the order correct, Xu 13/11/2015
@@ -179,15 +326,6 @@ void CameraClass::RenderReflection(float height)
 	// Translate the rotated camera position to the location of the viewer.
 	lookAt = position + lookAt;
 
-	// Finally create the m_reflectionViewMatrix from the three updated vectors.
-	m_reflectionViewMatrix = XMMatrixLookAtLH(position, lookAt, up);
-
-	return;
-}
-
-
-void CameraClass::GetReflectionViewMatrix(XMMATRIX& viewMatrix)
-{
-	viewMatrix = m_reflectionViewMatrix;
-	return;
+	// Finally create the view matrix from the three updated vectors.
+	return XMMatrixLookAtLH(position, lookAt, up);
 }
\ No newline at end of file
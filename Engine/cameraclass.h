@@ -8,10 +8,26 @@
 //////////////
 // INCLUDES //
 //////////////
+#include <math.h>
+#include <string.h>
 #include <DirectXMath.h> 
 using namespace DirectX;
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int CAMERA_FRUSTUM_PLANES = 6;
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: CameraClass
+//
+// Keeps the view matrix together with the view-projection matrix, the inverse of the view and the six normalized
+// frustum planes, all worked out at once the first time they are asked for after the camera moved or the projection
+// changed, so everything that reads them in a frame sees the same view.  The planes point into the frustum.  The version
+// goes up every time the view changes, so a reader can tell its own copy is out of date without comparing matrices.
+// The reflection view is kept the same way for the height it was last asked for.
 ////////////////////////////////////////////////////////////////////////////////
 class CameraClass
 {
@@ -22,12 +38,20 @@ public:
 
 	void SetPosition(float, float, float);
 	void SetRotation(float, float, float);
+	void SetProjectionMatrix(const XMMATRIX&);
 
 	XMFLOAT3 GetPosition();
 	XMFLOAT3 GetRotation();
 
 	void Render();
 	void GetViewMatrix(XMMATRIX&);
+	void GetViewProjectionMatrix(XMMATRIX&);
+	void GetInverseViewMatrix(XMMATRIX&);
+	void GetFrustumPlanes(XMFLOAT4*);
+	unsigned int GetVersion();
+
+	bool CheckSphere(const XMFLOAT3&, float);
+	bool CheckBox(const XMFLOAT3&, const XMFLOAT3&);
 
 	void GenerateBaseViewMatrix();
 	void GetBaseViewMatrix(XMMATRIX&);
@@ -35,10 +59,20 @@ public:
 	void RenderReflection(float);
 	void GetReflectionViewMatrix(XMMATRIX&);
 
+private:
+	void Update();
+	static XMMATRIX BuildViewMatrix(float, float, float, float, float, float);
+
 private:
 	float m_positionX, m_positionY, m_positionZ;
 	float m_rotationX, m_rotationY, m_rotationZ;
-	XMMATRIX m_viewMatrix, m_baseViewMatrix, m_reflectionViewMatrix;
+	XMFLOAT4X4 m_projectionMatrix;
+	XMFLOAT4X4 m_viewMatrix, m_viewProjectionMatrix, m_inverseViewMatrix;
+	XMFLOAT4 m_frustumPlanes[CAMERA_FRUSTUM_PLANES];
+	XMFLOAT4X4 m_baseViewMatrix, m_reflectionViewMatrix;
+	float m_reflectionHeight;
+	bool m_dirty, m_reflectionDirty;
+	unsigned int m_version;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,522 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: clusterclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "clusterclass.h"
+
+
+ClusterClass::ClusterClass()
+{
+	m_Device = 0;
+	m_WorkerPool = 0;
+	m_screenWidth = 0;
+	m_screenHeight = 0;
+	m_threadCount = 1;
+	m_depthScale = 0.0f;
+	m_depthBias = 0.0f;
+	m_bounds = 0;
+	m_clusterCounts = 0;
+	m_clusterLights = 0;
+	m_ranges = 0;
+	m_binTime = 0.0f;
+	m_lightBuffer = 0;
+	m_rangeBuffer = 0;
+	m_indexBuffer = 0;
+	m_clusterBuffer = 0;
+}
+
+
+ClusterClass::ClusterClass(const ClusterClass& other)
+{
+}
+
+
+ClusterClass::~ClusterClass()
+{
+}
+
+
+bool ClusterClass::Initialize(RenderDeviceClass* device, int screenWidth, int screenHeight, float screenDepth, WorkerPoolClass* workerPool)
+{
+	XMMATRIX projectionMatrix;
+	float depthRange;
+	int i;
+
+
+	if(!device || screenWidth <= 0 || screenHeight <= 0 || screenDepth <= CLUSTER_NEAR_DEPTH)
+	{
+		return false;
+	}
+
+	m_Device = device;
+	m_screenWidth = screenWidth;
+	m_screenHeight = screenHeight;
+
+	// Store the number of threads the binning may split its work across, without a pool it runs on this thread.
+	m_WorkerPool = workerPool;
+	m_threadCount = m_WorkerPool ? m_WorkerPool->GetThreadCount() : 1;
+	if(m_threadCount > CLUSTER_MAX_THREADS)
+	{
+		m_threadCount = CLUSTER_MAX_THREADS;
+	}
+
+	// The slices are spaced exponentially from the cluster near depth to the far plane, the first slice also takes
+	// everything in front of the near depth.  The shader finds the slice with log(depth) * scale + bias.
+	depthRange = logf(screenDepth / CLUSTER_NEAR_DEPTH);
+	m_depthScale = (float)CLUSTER_SLICES / depthRange;
+	m_depthBias = -logf(CLUSTER_NEAR_DEPTH) * m_depthScale;
+
+	m_sliceDepths[0] = 0.0f;
+	for(i=1; i<CLUSTER_SLICES; i++)
+	{
+		m_sliceDepths[i] = CLUSTER_NEAR_DEPTH * expf(depthRange * (float)i / (float)CLUSTER_SLICES);
+	}
+	m_sliceDepths[CLUSTER_SLICES] = screenDepth;
+
+	// Create the arrays the clusters are binned into.
+	m_bounds = new ClusterBoundsType[CLUSTER_COUNT / 4];
+	if(!m_bounds)
+	{
+		return false;
+	}
+
+	m_clusterCounts = new int[CLUSTER_COUNT];
+	if(!m_clusterCounts)
+	{
+		return false;
+	}
+
+	m_clusterLights = new unsigned int[CLUSTER_COUNT * CLUSTER_MAX_LIGHTS_PER_CLUSTER];
+	if(!m_clusterLights)
+	{
+		return false;
+	}
+
+	m_ranges = new ClusterRangeType[CLUSTER_COUNT];
+	if(!m_ranges)
+	{
+		return false;
+	}
+
+	memset(m_clusterCounts, 0, sizeof(int) * CLUSTER_COUNT);
+	memset(m_ranges, 0, sizeof(ClusterRangeType) * CLUSTER_COUNT);
+
+	// Work out the view space bounds of every cluster from the projection of the device.
+	m_Device->GetProjectionMatrix(projectionMatrix);
+	BuildBounds(projectionMatrix);
+
+	// Create the structured buffers at their largest size so they never have to be recreated.
+	m_lightBuffer = m_Device->CreateStructuredBuffer(sizeof(PointLightType), CLUSTER_MAX_LIGHTS);
+	if(!m_lightBuffer)
+	{
+		return false;
+	}
+
+	m_rangeBuffer = m_Device->CreateStructuredBuffer(sizeof(ClusterRangeType), CLUSTER_COUNT);
+	if(!m_rangeBuffer)
+	{
+		return false;
+	}
+
+	m_indexBuffer = m_Device->CreateStructuredBuffer(sizeof(unsigned int), CLUSTER_COUNT * CLUSTER_MAX_LIGHTS_PER_CLUSTER);
+	if(!m_indexBuffer)
+	{
+		return false;
+	}
+
+	// Create the dynamic cluster constant buffer that is in the light pixel shader.
+	m_clusterBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_CONSTANT_BUFFER, NULL, sizeof(ClusterBufferType));
+	if(!m_clusterBuffer)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void ClusterClass::Shutdown()
+{
+	// Release the buffers.
+	if(m_Device)
+	{
+		m_Device->ReleaseResource(m_clusterBuffer);
+		m_Device->ReleaseResource(m_indexBuffer);
+		m_Device->ReleaseResource(m_rangeBuffer);
+		m_Device->ReleaseResource(m_lightBuffer);
+	}
+	m_clusterBuffer = 0;
+	m_indexBuffer = 0;
+	m_rangeBuffer = 0;
+	m_lightBuffer = 0;
+
+	// Release the cluster arrays.
+	delete [] m_ranges;
+	m_ranges = 0;
+
+	delete [] m_clusterLights;
+	m_clusterLights = 0;
+
+	delete [] m_clusterCounts;
+	m_clusterCounts = 0;
+
+	delete [] m_bounds;
+	m_bounds = 0;
+
+	m_lights.clear();
+	m_viewLights.clear();
+	m_indices.clear();
+	m_WorkerPool = 0;
+	m_Device = 0;
+
+	return;
+}
+
+
+bool ClusterClass::SetLights(const PointLightType* lights, int count)
+{
+	// The light buffer was created for a fixed number of lights.
+	if(count < 0 || count > CLUSTER_MAX_LIGHTS || (count > 0 && !lights))
+	{
+		return false;
+	}
+
+	m_lights.assign(lights, lights + count);
+	m_viewLights.resize(count);
+	m_firstSlice.resize(count);
+	m_lastSlice.resize(count);
+
+	return true;
+}
+
+
+void ClusterClass::SetScreenSize(int screenWidth, int screenHeight)
+{
+	// The lit pixels can cover less than the screen when the scene is drawn at a lower resolution, the clusters are
+	// spread over the pixels actually drawn.
+	if(screenWidth > 0 && screenHeight > 0)
+	{
+		m_screenWidth = screenWidth;
+		m_screenHeight = screenHeight;
+	}
+
+	return;
+}
+
+
+void ClusterClass::Bin(const XMMATRIX& viewMatrix)
+{
+	CpuZoneClass zone("BinLights");
+	chrono::high_resolution_clock::time_point start;
+	float depth, radius;
+	int i, count, offset;
+
+
+	start = chrono::high_resolution_clock::now();
+
+	count = (int)m_lights.size();
+
+	// Move all the lights into view space in one SIMD stream and keep the radius in w.
+	if(count > 0)
+	{
+		XMVector3TransformStream(m_viewLights.data(), sizeof(XMFLOAT4), &m_lights[0].position, sizeof(PointLightType), count, viewMatrix);
+	}
+
+	// Find the range of slices each light reaches, a light entirely behind the camera or past the far plane reaches none.
+	for(i=0; i<count; i++)
+	{
+		radius = m_lights[i].radius;
+		depth = m_viewLights[i].z;
+		m_viewLights[i].w = radius;
+
+		if((depth + radius < 0.0f) || (depth - radius > m_sliceDepths[CLUSTER_SLICES]))
+		{
+			m_firstSlice[i] = 1;
+			m_lastSlice[i] = 0;
+			continue;
+		}
+
+		m_firstSlice[i] = GetSlice(depth - radius);
+		m_lastSlice[i] = GetSlice(depth + radius);
+	}
+
+	// Every slice only writes its own clusters, so the slices are split into one contiguous block per thread.
+	if((m_threadCount == 1) || (count < CLUSTER_PARALLEL_MIN_LIGHTS))
+	{
+		BinSlices(this, 0, CLUSTER_SLICES);
+	}
+	else
+	{
+		m_WorkerPool->Run(BinSlices, this, CLUSTER_SLICES, (CLUSTER_SLICES + m_threadCount - 1) / m_threadCount);
+	}
+
+	// Pack the light lists of the clusters one after the other into the index list.
+	m_indices.clear();
+	offset = 0;
+	for(i=0; i<CLUSTER_COUNT; i++)
+	{
+		m_ranges[i].offset = offset;
+		m_ranges[i].count = m_clusterCounts[i];
+
+		m_indices.insert(m_indices.end(), m_clusterLights + i * CLUSTER_MAX_LIGHTS_PER_CLUSTER,
+						 m_clusterLights + i * CLUSTER_MAX_LIGHTS_PER_CLUSTER + m_clusterCounts[i]);
+		offset += m_clusterCounts[i];
+	}
+
+	m_binTime = chrono::duration<float, milli>(chrono::high_resolution_clock::now() - start).count();
+
+	return;
+}
+
+
+bool ClusterClass::Render()
+{
+	ClusterBufferType clusterBuffer;
+	bool result;
+
+
+	// Fill in how the pixel shader finds its cluster.
+	clusterBuffer.scaleX = (float)CLUSTER_COLUMNS / (float)m_screenWidth;
+	clusterBuffer.scaleY = (float)CLUSTER_ROWS / (float)m_screenHeight;
+	clusterBuffer.depthScale = m_depthScale;
+	clusterBuffer.depthBias = m_depthBias;
+	clusterBuffer.columns = CLUSTER_COLUMNS;
+	clusterBuffer.rows = CLUSTER_ROWS;
+	clusterBuffer.slices = CLUSTER_SLICES;
+	clusterBuffer.lightCount = (unsigned int)m_lights.size();
+
+	result = m_Device->UpdateBuffer(m_clusterBuffer, &clusterBuffer, sizeof(ClusterBufferType));
+	if(!result)
+	{
+		return false;
+	}
+
+	// Upload the lights and the binning of this frame, only as much of each buffer as is used.
+	if(!m_lights.empty())
+	{
+		result = m_Device->UpdateBuffer(m_lightBuffer, m_lights.data(), (int)(m_lights.size() * sizeof(PointLightType)));
+		if(!result)
+		{
+			return false;
+		}
+	}
+
+	result = m_Device->UpdateBuffer(m_rangeBuffer, m_ranges, sizeof(ClusterRangeType) * CLUSTER_COUNT);
+	if(!result)
+	{
+		return false;
+	}
+
+	if(!m_indices.empty())
+	{
+		result = m_Device->UpdateBuffer(m_indexBuffer, m_indices.data(), (int)(m_indices.size() * sizeof(unsigned int)));
+		if(!result)
+		{
+			return false;
+		}
+	}
+
+	// Bind the cluster constants and the buffers to the slots the light pixel shader reads them from.
+	m_Device->SetConstantBuffer(RenderDeviceClass::SHADER_STAGE_PIXEL, 1, m_clusterBuffer);
+	m_Device->SetShaderBuffer(1, m_lightBuffer);
+	m_Device->SetShaderBuffer(2, m_rangeBuffer);
+	m_Device->SetShaderBuffer(3, m_indexBuffer);
+
+	return true;
+}
+
+
+int ClusterClass::GetLightCount()
+{
+	return (int)m_lights.size();
+}
+
+
+int ClusterClass::GetSlice(float depth)
+{
+	float slice;
+
+
+	// Everything in front of the cluster near depth falls into the first slice.
+	if(depth <= CLUSTER_NEAR_DEPTH)
+	{
+		return 0;
+	}
+
+	slice = floorf(logf(depth) * m_depthScale + m_depthBias);
+	if(slice > (float)(CLUSTER_SLICES - 1))
+	{
+		return CLUSTER_SLICES - 1;
+	}
+
+	return (int)slice;
+}
+
+
+int ClusterClass::GetCluster(int column, int row, int slice)
+{
+	return (slice * CLUSTER_ROWS + row) * CLUSTER_COLUMNS + column;
+}
+
+
+int ClusterClass::GetClusterLightCount(int cluster)
+{
+	if(cluster < 0 || cluster >= CLUSTER_COUNT)
+	{
+		return 0;
+	}
+
+	return m_ranges[cluster].count;
+}
+
+
+const unsigned int* ClusterClass::GetClusterLights(int cluster)
+{
+	if(cluster < 0 || cluster >= CLUSTER_COUNT || m_ranges[cluster].count == 0)
+	{
+		return 0;
+	}
+
+	return &m_indices[m_ranges[cluster].offset];
+}
+
+
+int ClusterClass::GetIndexCount()
+{
+	return (int)m_indices.size();
+}
+
+
+float ClusterClass::GetBinTime()
+{
+	return m_binTime;
+}
+
+
+void ClusterClass::BuildBounds(const XMMATRIX& projectionMatrix)
+{
+	XMFLOAT4X4 projection;
+	ClusterBoundsType* bounds;
+	float scaleX, scaleY, left, right, top, bottom, nearDepth, farDepth;
+	int slice, tile, lane, column, row;
+
+
+	// A view space point at depth z lands on x * z / m11 and y * z / m22 in normalized device coordinates.
+	XMStoreFloat4x4(&projection, projectionMatrix);
+	scaleX = 1.0f / projection._11;
+	scaleY = 1.0f / projection._22;
+
+	for(slice=0; slice<CLUSTER_SLICES; slice++)
+	{
+		nearDepth = m_sliceDepths[slice];
+		farDepth = m_sliceDepths[slice + 1];
+
+		for(tile=0; tile<CLUSTER_COLUMNS * CLUSTER_ROWS; tile++)
+		{
+			column = tile % CLUSTER_COLUMNS;
+			row = tile / CLUSTER_COLUMNS;
+
+			// The rows count down from the top of the screen like the pixel rows do.
+			left = -1.0f + 2.0f * (float)column / (float)CLUSTER_COLUMNS;
+			right = -1.0f + 2.0f * (float)(column + 1) / (float)CLUSTER_COLUMNS;
+			top = 1.0f - 2.0f * (float)row / (float)CLUSTER_ROWS;
+			bottom = 1.0f - 2.0f * (float)(row + 1) / (float)CLUSTER_ROWS;
+
+			// The tile frustum is widest at whichever end of the slice its edges point away from the center.
+			bounds = &m_bounds[(slice * CLUSTER_COLUMNS * CLUSTER_ROWS + tile) / 4];
+			lane = tile % 4;
+
+			(&bounds->minX.x)[lane] = min(left * nearDepth, left * farDepth) * scaleX;
+			(&bounds->maxX.x)[lane] = max(right * nearDepth, right * farDepth) * scaleX;
+			(&bounds->minY.x)[lane] = min(bottom * nearDepth, bottom * farDepth) * scaleY;
+			(&bounds->maxY.x)[lane] = max(top * nearDepth, top * farDepth) * scaleY;
+		}
+	}
+
+	return;
+}
+
+
+void ClusterClass::BinSlices(void* context, int firstSlice, int lastSlice)
+{
+	ClusterClass* clusters;
+	const ClusterBoundsType* bounds;
+	XMVECTOR centerX, centerY, limit, zero, distanceX, distanceY, distance;
+	uint32_t mask[4];
+	float nearDepth, farDepth, distanceZ, distanceRow;
+	int slice, i, group, lane, cluster, count;
+
+
+	clusters = (ClusterClass*)context;
+	zero = XMVectorZero();
+	count = (int)clusters->m_lights.size();
+
+	for(slice=firstSlice; slice<lastSlice; slice++)
+	{
+		// Empty the clusters of the slice.
+		memset(clusters->m_clusterCounts + slice * CLUSTER_COLUMNS * CLUSTER_ROWS, 0, sizeof(int) * CLUSTER_COLUMNS * CLUSTER_ROWS);
+
+		nearDepth = clusters->m_sliceDepths[slice];
+		farDepth = clusters->m_sliceDepths[slice + 1];
+
+		for(i=0; i<count; i++)
+		{
+			if(slice < clusters->m_firstSlice[i] || slice > clusters->m_lastSlice[i])
+			{
+				continue;
+			}
+
+			// The depth part of the sphere to box distance is the same for the whole slice.
+			distanceZ = max(max(nearDepth - clusters->m_viewLights[i].z, clusters->m_viewLights[i].z - farDepth), 0.0f);
+			if(distanceZ > clusters->m_viewLights[i].w)
+			{
+				continue;
+			}
+
+			centerX = XMVectorReplicate(clusters->m_viewLights[i].x);
+			centerY = XMVectorReplicate(clusters->m_viewLights[i].y);
+			limit = XMVectorReplicate(clusters->m_viewLights[i].w * clusters->m_viewLights[i].w - distanceZ * distanceZ);
+
+			// Test the sphere against the boxes of four clusters at a time.
+			bounds = clusters->m_bounds + slice * CLUSTER_COLUMNS * CLUSTER_ROWS / 4;
+			for(group=0; group<CLUSTER_COLUMNS * CLUSTER_ROWS / 4; group++)
+			{
+				// All the boxes of a row share their height, so a row the sphere misses vertically is skipped whole.
+				if((group % (CLUSTER_COLUMNS / 4)) == 0)
+				{
+					distanceRow = max(max(bounds[group].minY.x - clusters->m_viewLights[i].y, clusters->m_viewLights[i].y - bounds[group].maxY.x), 0.0f);
+					if(distanceRow * distanceRow > clusters->m_viewLights[i].w * clusters->m_viewLights[i].w - distanceZ * distanceZ)
+					{
+						group += CLUSTER_COLUMNS / 4 - 1;
+						continue;
+					}
+				}
+
+				distanceX = XMVectorMax(XMVectorMax(XMVectorSubtract(XMLoadFloat4(&bounds[group].minX), centerX),
+													XMVectorSubtract(centerX, XMLoadFloat4(&bounds[group].maxX))), zero);
+				distanceY = XMVectorMax(XMVectorMax(XMVectorSubtract(XMLoadFloat4(&bounds[group].minY), centerY),
+													XMVectorSubtract(centerY, XMLoadFloat4(&bounds[group].maxY))), zero);
+				distance = XMVectorMultiplyAdd(distanceX, distanceX, XMVectorMultiply(distanceY, distanceY));
+
+				XMStoreInt4(mask, XMVectorLessOrEqual(distance, limit));
+
+				for(lane=0; lane<4; lane++)
+				{
+					if(!mask[lane])
+					{
+						continue;
+					}
+
+					// A full cluster keeps the first lights in list order and drops the rest.
+					cluster = slice * CLUSTER_COLUMNS * CLUSTER_ROWS + group * 4 + lane;
+					if(clusters->m_clusterCounts[cluster] < CLUSTER_MAX_LIGHTS_PER_CLUSTER)
+					{
+						clusters->m_clusterLights[cluster * CLUSTER_MAX_LIGHTS_PER_CLUSTER + clusters->m_clusterCounts[cluster]] = i;
+						clusters->m_clusterCounts[cluster]++;
+					}
+				}
+			}
+		}
+	}
+
+	return;
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: clusterclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _CLUSTERCLASS_H_
+#define _CLUSTERCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <DirectXMath.h>
+using namespace DirectX;
+using namespace std;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+#include "cpuprofilerclass.h"
+#include "workerpoolclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int CLUSTER_COLUMNS = 16;
+const int CLUSTER_ROWS = 9;
+const int CLUSTER_SLICES = 24;
+const int CLUSTER_COUNT = CLUSTER_COLUMNS * CLUSTER_ROWS * CLUSTER_SLICES;
+const int CLUSTER_MAX_LIGHTS = 1024;
+const int CLUSTER_MAX_LIGHTS_PER_CLUSTER = 64;
+const float CLUSTER_NEAR_DEPTH = 5.0f;
+const int CLUSTER_MAX_THREADS = 8;
+const int CLUSTER_PARALLEL_MIN_LIGHTS = 64;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: ClusterClass
+//
+// Bins the point lights into a grid of froxels, screen tiles split into depth slices that grow exponentially with the
+// distance, so the light shader only loops over the lights that can reach its cluster.  The binning runs on the CPU
+// every frame and the lights, the range of every cluster and the light index list are uploaded as structured buffers.
+////////////////////////////////////////////////////////////////////////////////
+class ClusterClass
+{
+public:
+	// The layouts of the structured buffers, they match the ones declared in light.ps.
+	struct PointLightType
+	{
+		XMFLOAT3 position;
+		float radius;
+		XMFLOAT3 color;
+		float padding;
+	};
+
+	struct ClusterRangeType
+	{
+		unsigned int offset;
+		unsigned int count;
+	};
+
+private:
+	struct ClusterBufferType
+	{
+		float scaleX, scaleY;
+		float depthScale, depthBias;
+		unsigned int columns, rows, slices;
+		unsigned int lightCount;
+	};
+
+	// The view space bounds of four neighbouring clusters of a slice, so one light is tested against all four at once.
+	struct ClusterBoundsType
+	{
+		XMFLOAT4 minX, maxX, minY, maxY;
+	};
+
+public:
+	ClusterClass();
+	ClusterClass(const ClusterClass&);
+	~ClusterClass();
+
+	bool Initialize(RenderDeviceClass*, int, int, float, WorkerPoolClass*);
+	void Shutdown();
+
+	bool SetLights(const PointLightType*, int);
+	void SetScreenSize(int, int);
+	void Bin(const XMMATRIX&);
+	bool Render();
+
+	int GetLightCount();
+	int GetSlice(float);
+	int GetCluster(int, int, int);
+	int GetClusterLightCount(int);
+	const unsigned int* GetClusterLights(int);
+	int GetIndexCount();
+	float GetBinTime();
+
+private:
+	void BuildBounds(const XMMATRIX&);
+	static void BinSlices(void*, int, int);
+
+private:
+	RenderDeviceClass* m_Device;
+	WorkerPoolClass* m_WorkerPool;
+	int m_screenWidth, m_screenHeight;
+	int m_threadCount;
+	float m_depthScale, m_depthBias;
+	float m_sliceDepths[CLUSTER_SLICES + 1];
+	ClusterBoundsType* m_bounds;
+
+	vector<PointLightType> m_lights;
+	vector<XMFLOAT4> m_viewLights;
+	vector<int> m_firstSlice, m_lastSlice;
+
+	int* m_clusterCounts;
+	unsigned int* m_clusterLights;
+	ClusterRangeType* m_ranges;
+	vector<unsigned int> m_indices;
+	float m_binTime;
+
+	int m_lightBuffer, m_rangeBuffer, m_indexBuffer, m_clusterBuffer;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,233 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: cpuprofilerclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "cpuprofilerclass.h"
+
+
+atomic<bool> CpuProfilerClass::m_enabled(false);
+atomic<int> CpuProfilerClass::m_generation(0);
+mutex CpuProfilerClass::m_mutex;
+vector<CpuProfilerClass::ThreadBufferType*> CpuProfilerClass::m_buffers;
+unsigned long long CpuProfilerClass::m_startTime = 0;
+chrono::steady_clock::time_point CpuProfilerClass::m_startClock;
+thread_local CpuProfilerClass::ThreadOwnerType CpuProfilerClass::m_threadOwner;
+thread_local CpuProfilerClass::ThreadBufferType* CpuProfilerClass::m_threadBuffer = 0;
+thread_local int CpuProfilerClass::m_threadGeneration = 0;
+
+
+CpuProfilerClass::ThreadOwnerType::~ThreadOwnerType()
+{
+	// Let the next new thread take over the ring, unless the profiler has been restarted since it was handed out.
+	if(buffer && generation == m_generation.load())
+	{
+		buffer->owned = false;
+	}
+}
+
+
+bool CpuProfilerClass::Initialize()
+{
+	// Start over with no rings, the rings of an earlier run are released.
+	Shutdown();
+
+	lock_guard<mutex> lock(m_mutex);
+
+	m_generation++;
+
+	// Remember where the counter and the clock were, the trace is timed from here.
+	m_startTime = GetTime();
+	m_startClock = chrono::steady_clock::now();
+
+	m_enabled = true;
+
+	return true;
+}
+
+
+void CpuProfilerClass::Shutdown()
+{
+	unsigned int i;
+
+
+	m_enabled = false;
+
+	lock_guard<mutex> lock(m_mutex);
+
+	// Release the rings, the threads holding one see the new generation and ask for another.
+	for(i=0; i<m_buffers.size(); i++)
+	{
+		delete m_buffers[i];
+		m_buffers[i] = 0;
+	}
+	m_buffers.clear();
+
+	m_generation++;
+
+	return;
+}
+
+
+void CpuProfilerClass::SetThreadName(const char* name)
+{
+	ThreadBufferType* buffer;
+
+
+	if(!IsEnabled() || !name)
+	{
+		return;
+	}
+
+	buffer = GetThreadBuffer();
+	if(!buffer)
+	{
+		return;
+	}
+
+	strncpy(buffer->name, name, CPU_PROFILER_MAX_NAME - 1);
+	buffer->name[CPU_PROFILER_MAX_NAME - 1] = 0;
+
+	return;
+}
+
+
+int CpuProfilerClass::GetEventCount()
+{
+	unsigned int i;
+	int count;
+
+
+	lock_guard<mutex> lock(m_mutex);
+
+	count = 0;
+	for(i=0; i<m_buffers.size(); i++)
+	{
+		count += (m_buffers[i]->count < (unsigned int)CPU_PROFILER_EVENTS) ? (int)m_buffers[i]->count : CPU_PROFILER_EVENTS;
+	}
+
+	return count;
+}
+
+
+bool CpuProfilerClass::WriteTrace(const char* filename)
+{
+	ofstream fout;
+	ThreadBufferType* buffer;
+	EventType* event;
+	double elapsedMicroseconds, ticksPerMicrosecond;
+	unsigned int i, j, first;
+	bool separator;
+
+
+	lock_guard<mutex> lock(m_mutex);
+
+	// Work out the rate of the counter from how far it and the clock have moved since the start.
+	elapsedMicroseconds = chrono::duration<double, micro>(chrono::steady_clock::now() - m_startClock).count();
+	ticksPerMicrosecond = 1.0;
+	if(elapsedMicroseconds > 0.0 && GetTime() > m_startTime)
+	{
+		ticksPerMicrosecond = (double)(GetTime() - m_startTime) / elapsedMicroseconds;
+	}
+
+	fout.open(filename, ios::out);
+	if(fout.fail())
+	{
+		return false;
+	}
+
+	fout.setf(ios::fixed);
+	fout.precision(3);
+
+	// Write every zone as a complete event with its start and duration in microseconds, one track per thread.
+	fout << "{\"traceEvents\":[";
+	separator = false;
+
+	for(i=0; i<m_buffers.size(); i++)
+	{
+		buffer = m_buffers[i];
+
+		if(buffer->name[0])
+		{
+			fout << (separator ? ",\n" : "\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread
+				 << ",\"args\":{\"name\":\"" << buffer->name << "\"}}";
+			separator = true;
+		}
+
+		first = (buffer->count > (unsigned int)CPU_PROFILER_EVENTS) ? buffer->count - CPU_PROFILER_EVENTS : 0;
+		for(j=first; j<buffer->count; j++)
+		{
+			event = &buffer->events[j % CPU_PROFILER_EVENTS];
+			if(event->start < m_startTime || event->end < event->start)
+			{
+				continue;
+			}
+
+			fout << (separator ? ",\n" : "\n") << "{\"name\":\"" << event->name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread
+				 << ",\"ts\":" << (double)(event->start - m_startTime) / ticksPerMicrosecond
+				 << ",\"dur\":" << (double)(event->end - event->start) / ticksPerMicrosecond << "}";
+			separator = true;
+		}
+	}
+
+	fout << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	fout.close();
+
+	return !fout.fail();
+}
+
+
+CpuProfilerClass::ThreadBufferType* CpuProfilerClass::GetThreadBuffer()
+{
+	ThreadBufferType* buffer;
+	unsigned int i;
+
+
+	// No ring is handed out while the profiler is off, the rings of the last run may already be gone.
+	if(!IsEnabled())
+	{
+		return 0;
+	}
+
+	// The ring handed to this thread stays valid until the profiler is restarted.
+	if(m_threadOwner.buffer && m_threadOwner.generation == m_generation.load(memory_order_relaxed))
+	{
+		m_threadBuffer = m_threadOwner.buffer;
+		m_threadGeneration = m_threadOwner.generation;
+		return m_threadBuffer;
+	}
+
+	lock_guard<mutex> lock(m_mutex);
+
+	// Take over the ring of a thread that has exited, or add a new one.
+	buffer = 0;
+	for(i=0; i<m_buffers.size() && !buffer; i++)
+	{
+		if(!m_buffers[i]->owned)
+		{
+			buffer = m_buffers[i];
+		}
+	}
+
+	if(!buffer)
+	{
+		buffer = new ThreadBufferType;
+		if(!buffer)
+		{
+			return 0;
+		}
+
+		buffer->count = 0;
+		buffer->thread = (int)m_buffers.size() + 1;
+		buffer->name[0] = 0;
+		m_buffers.push_back(buffer);
+	}
+
+	buffer->owned = true;
+
+	m_threadOwner.buffer = buffer;
+	m_threadOwner.generation = m_generation.load();
+	m_threadBuffer = buffer;
+	m_threadGeneration = m_threadOwner.generation;
+
+	return buffer;
+}
\ No newline at end of file
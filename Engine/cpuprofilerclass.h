@@ -0,0 +1,235 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: cpuprofilerclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _CPUPROFILERCLASS_H_
+#define _CPUPROFILERCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <vector>
+using namespace std;
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+/////////////
+// GLOBALS //
+/////////////
+const bool CPU_PROFILER_ENABLED = true;
+const int CPU_PROFILER_EVENTS = 65536;
+const int CPU_PROFILER_MAX_NAME = 32;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: CpuProfilerClass
+//
+// Collects the zones timed by CpuZoneClass and writes them out as a Chrome trace, which shows the zones of every thread
+// nested by time.  Each thread writes into a ring buffer of its own so recording a zone takes no lock, the ring keeps
+// the newest events once it is full.  A thread that exits leaves its ring behind for the next new thread, so worker
+// threads that are started over and over do not pile up buffers.  The zones read the time stamp counter where there is
+// one and the counter is converted to microseconds against the system clock when the trace is written.  The trace can
+// only be written and the profiler shut down while no other thread is recording, and zone names must be literals.
+////////////////////////////////////////////////////////////////////////////////
+class CpuProfilerClass
+{
+private:
+	struct EventType
+	{
+		const char* name;
+		unsigned long long start, end;
+	};
+
+	struct ThreadBufferType
+	{
+		EventType events[CPU_PROFILER_EVENTS];
+		unsigned int count;
+		int thread;
+		char name[CPU_PROFILER_MAX_NAME];
+		atomic<bool> owned;
+	};
+
+	// Hands a thread's ring back when the thread exits.
+	struct ThreadOwnerType
+	{
+		ThreadBufferType* buffer;
+		int generation;
+		~ThreadOwnerType();
+	};
+
+public:
+	static bool Initialize();
+	static void Shutdown();
+	static bool IsEnabled();
+
+	static void SetThreadName(const char*);
+	static void AddEvent(const char*, unsigned long long, unsigned long long);
+	static int GetEventCount();
+	static bool WriteTrace(const char*);
+
+	static unsigned long long GetTime();
+
+private:
+	static ThreadBufferType* GetThreadBuffer();
+
+private:
+	static atomic<bool> m_enabled;
+	static atomic<int> m_generation;
+	static mutex m_mutex;
+	static vector<ThreadBufferType*> m_buffers;
+	static unsigned long long m_startTime;
+	static chrono::steady_clock::time_point m_startClock;
+	static thread_local ThreadOwnerType m_threadOwner;
+	static thread_local ThreadBufferType* m_threadBuffer;
+	static thread_local int m_threadGeneration;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: CpuZoneClass
+//
+// Times the scope it lives in, or up to End when the zone is closed early.  One zone can also time a run of phases one
+// after the other, Begin ends the phase before.  It does nothing while the profiler is off.
+////////////////////////////////////////////////////////////////////////////////
+class CpuZoneClass
+{
+public:
+	CpuZoneClass();
+	CpuZoneClass(const char*);
+	~CpuZoneClass();
+
+	void Begin(const char*);
+	void End();
+
+private:
+	CpuZoneClass(const CpuZoneClass&);
+	void Record(unsigned long long);
+
+private:
+	const char* m_name;
+	unsigned long long m_start;
+};
+
+
+// The zones sit on hot paths, so the clock and the zone are inline.
+inline unsigned long long CpuProfilerClass::GetTime()
+{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return (unsigned long long)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+
+inline bool CpuProfilerClass::IsEnabled()
+{
+	return CPU_PROFILER_ENABLED && m_enabled.load(memory_order_relaxed);
+}
+
+
+inline void CpuProfilerClass::AddEvent(const char* name, unsigned long long start, unsigned long long end)
+{
+	ThreadBufferType* buffer;
+	EventType* event;
+
+
+	// Only the first event of a thread, and the first after a restart, goes out of line for its ring.  The cached ring
+	// is in a plain pointer since reaching the owner, which has a destructor, costs a call on every access.
+	buffer = m_threadBuffer;
+	if(!buffer || m_threadGeneration != m_generation.load(memory_order_relaxed))
+	{
+		buffer = GetThreadBuffer();
+		if(!buffer)
+		{
+			return;
+		}
+	}
+
+	// Write over the oldest event once the ring is full.
+	event = &buffer->events[buffer->count % CPU_PROFILER_EVENTS];
+	event->name = name;
+	event->start = start;
+	event->end = end;
+	buffer->count++;
+
+	return;
+}
+
+
+inline CpuZoneClass::CpuZoneClass()
+{
+	m_name = 0;
+	m_start = 0;
+}
+
+
+inline CpuZoneClass::CpuZoneClass(const char* name)
+{
+	m_name = 0;
+	m_start = 0;
+	Begin(name);
+}
+
+
+inline CpuZoneClass::~CpuZoneClass()
+{
+	End();
+}
+
+
+inline void CpuZoneClass::Begin(const char* name)
+{
+	unsigned long long time;
+
+
+	if(!CpuProfilerClass::IsEnabled())
+	{
+		End();
+		return;
+	}
+
+	// Reading the counter is most of the cost of a zone, so the phase before ends at the very time this one starts.
+	time = CpuProfilerClass::GetTime();
+	Record(time);
+
+	m_name = name;
+	m_start = time;
+
+	return;
+}
+
+
+inline void CpuZoneClass::End()
+{
+	if(m_name)
+	{
+		Record(CpuProfilerClass::GetTime());
+	}
+
+	return;
+}
+
+
+inline void CpuZoneClass::Record(unsigned long long end)
+{
+	if(m_name)
+	{
+		CpuProfilerClass::AddEvent(m_name, m_start, end);
+		m_name = 0;
+	}
+
+	return;
+}
+
+#endif
\ No newline at end of file
@@ -6,14 +6,27 @@
 
 D3DClass::D3DClass()
 {
+	m_hwnd = 0;
+	m_ShaderCache = 0;
 	m_swapChain = 0;
+	m_frameLatencyWaitableObject = 0;
+	m_flipModel = false;
 	m_device = 0;
 	m_deviceContext = 0;
 	m_renderTargetView = 0;
 	m_depthStencilBuffer = 0;
 	m_depthStencilState = 0;
+	m_depthEqualState = 0;
+	m_depthSkyState = 0;
+	m_depthDisabledState = 0;
+	m_depthShadowState = 0;
 	m_depthStencilView = 0;
 	m_rasterState = 0;
+	m_screenWidth = 0;
+	m_targetWidth = 0;
+	m_targetHeight = 0;
+	m_screenHeight = 0;
+	ZeroMemory(m_textureSlots, sizeof(m_textureSlots));
 }
 
 
@@ -28,7 +41,7 @@ D3DClass::~D3DClass()
 
 
 bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hwnd, bool fullscreen, 
-						  float screenDepth, float screenNear)
+						  float screenDepth, float screenNear, bool reverseDepth)
 {
 	HRESULT result;
 	IDXGIFactory* factory;
@@ -39,6 +52,7 @@ bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 	DXGI_ADAPTER_DESC adapterDesc;
 	int error;
 	DXGI_SWAP_CHAIN_DESC swapChainDesc;
+	IDXGISwapChain2* swapChain2;
 	D3D_FEATURE_LEVEL featureLevel;
 	ID3D11Texture2D* backBufferPtr;
 	D3D11_TEXTURE2D_DESC depthBufferDesc;
@@ -46,12 +60,26 @@ bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 	D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc;
 	D3D11_RASTERIZER_DESC rasterDesc;
 	D3D11_VIEWPORT viewport;
+	DXGI_FORMAT depthFormat;
 	float fieldOfView, screenAspect;
 
 
+	// Store the window handle, it is the owner of any shader error message boxes.
+	m_hwnd = hwnd;
+
 	// Store the vsync setting.
 	m_vsync_enabled = vsync;
 
+	// Store the depth direction, reverse depth needs a float depth buffer to keep its precision in the distance.
+	m_reverseDepth = reverseDepth;
+	depthFormat = reverseDepth ? DXGI_FORMAT_D32_FLOAT_S8X24_UINT : DXGI_FORMAT_D24_UNORM_S8_UINT;
+
+	// Store the screen size, the viewport goes back to it whenever the back buffer is drawn to again.
+	m_screenWidth = screenWidth;
+	m_screenHeight = screenHeight;
+	m_targetWidth = screenWidth;
+	m_targetHeight = screenHeight;
+
 	// Create a DirectX graphics interface factory.
 	result = CreateDXGIFactory(__uuidof(IDXGIFactory), (void**)&factory);
 	if(FAILED(result))
@@ -144,8 +172,8 @@ bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 	// Initialize the swap chain description.
     ZeroMemory(&swapChainDesc, sizeof(swapChainDesc));
 
-	// Set to a single back buffer.
-    swapChainDesc.BufferCount = 1;
+	// Set to two buffers, the flip model needs one on screen and one to draw to.
+    swapChainDesc.BufferCount = 2;
 
 	// Set the width and height of the back buffer.
     swapChainDesc.BufferDesc.Width = screenWidth;
@@ -190,11 +218,11 @@ bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 	swapChainDesc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
 	swapChainDesc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
 
-	// Discard the back buffer contents after presenting.
-	swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+	// Flip the buffers instead of copying the back buffer out, and discard its contents after presenting.
+	swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
 
-	// Don't set the advanced flags.
-	swapChainDesc.Flags = 0;
+	// Ask for an object to wait on until the swap chain can take another frame.
+	swapChainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
 
 	// Set the feature level to DirectX 11.
 	featureLevel = D3D_FEATURE_LEVEL_11_0;
@@ -202,9 +230,35 @@ bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 	// Create the swap chain, Direct3D device, and Direct3D device context.
 	result = D3D11CreateDeviceAndSwapChain(NULL, D3D_DRIVER_TYPE_HARDWARE, NULL, 0, &featureLevel, 1, 
 										   D3D11_SDK_VERSION, &swapChainDesc, &m_swapChain, &m_device, NULL, &m_deviceContext);
-	if(FAILED(result))
+	m_flipModel = SUCCEEDED(result);
+
+	// Fall back to the blit model with a single back buffer where the flip model is not supported.
+	if(!m_flipModel)
 	{
-		return false;
+		swapChainDesc.BufferCount = 1;
+		swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+		swapChainDesc.Flags = 0;
+
+		result = D3D11CreateDeviceAndSwapChain(NULL, D3D_DRIVER_TYPE_HARDWARE, NULL, 0, &featureLevel, 1, 
+											   D3D11_SDK_VERSION, &swapChainDesc, &m_swapChain, &m_device, NULL, &m_deviceContext);
+		if(FAILED(result))
+		{
+			return false;
+		}
+	}
+
+	// Let only one frame be queued ahead of the screen and get the object that is signalled when the next can start.
+	if(m_flipModel)
+	{
+		result = m_swapChain->QueryInterface(__uuidof(IDXGISwapChain2), (void**)&swapChain2);
+		if(SUCCEEDED(result))
+		{
+			swapChain2->SetMaximumFrameLatency(D3D_MAX_FRAME_LATENCY);
+			m_frameLatencyWaitableObject = swapChain2->GetFrameLatencyWaitableObject();
+
+			swapChain2->Release();
+			swapChain2 = 0;
+		}
 	}
 
 	// Get the pointer to the back buffer.
@@ -233,7 +287,7 @@ bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 	depthBufferDesc.Height = screenHeight;
 	depthBufferDesc.MipLevels = 1;
 	depthBufferDesc.ArraySize = 1;
-	depthBufferDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+	depthBufferDesc.Format = depthFormat;
 	depthBufferDesc.SampleDesc.Count = 1;
 	depthBufferDesc.SampleDesc.Quality = 0;
 	depthBufferDesc.Usage = D3D11_USAGE_DEFAULT;
@@ -254,7 +308,7 @@ bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 	// Set up the description of the stencil state.
 	depthStencilDesc.DepthEnable = true;
 	depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
-	depthStencilDesc.DepthFunc = D3D11_COMPARISON_LESS;
+	depthStencilDesc.DepthFunc = GetComparisonFunc(GetDepthComparison(DEPTH_STATE_DEFAULT, reverseDepth));
 
 	depthStencilDesc.StencilEnable = true;
 	depthStencilDesc.StencilReadMask = 0xFF;
@@ -282,11 +336,63 @@ bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 	// Set the depth stencil state.
 	m_deviceContext->OMSetDepthStencilState(m_depthStencilState, 1);
 
+	// Now create a second depth stencil state for the main pass after a depth prepass.  The depth buffer already holds
+	// the nearest surface so only the pixel that wrote it passes, and there is no need to write depth again.
+	depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+	depthStencilDesc.DepthFunc = GetComparisonFunc(GetDepthComparison(DEPTH_STATE_EQUAL, reverseDepth));
+	depthStencilDesc.StencilEnable = false;
+
+	// Create the depth equal state.
+	result = m_device->CreateDepthStencilState(&depthStencilDesc, &m_depthEqualState);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
+	// Create a third state for the sky.  The sky is pushed to the far plane so it must pass against the cleared depth
+	// but fail wherever opaque geometry has already been drawn.
+	depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+	depthStencilDesc.DepthFunc = GetComparisonFunc(GetDepthComparison(DEPTH_STATE_SKY, reverseDepth));
+	depthStencilDesc.StencilEnable = false;
+
+	// Create the sky depth state.
+	result = m_device->CreateDepthStencilState(&depthStencilDesc, &m_depthSkyState);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
+	// Create a last state with no depth test at all for the fullscreen passes.
+	depthStencilDesc.DepthEnable = false;
+	depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+	depthStencilDesc.DepthFunc = GetComparisonFunc(GetDepthComparison(DEPTH_STATE_DISABLED, reverseDepth));
+	depthStencilDesc.StencilEnable = false;
+
+	// Create the disabled depth state.
+	result = m_device->CreateDepthStencilState(&depthStencilDesc, &m_depthDisabledState);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
+	// Create a state for the shadow maps, which are cleared to 1.0 and test LESS whichever way the scene depth runs.
+	depthStencilDesc.DepthEnable = true;
+	depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+	depthStencilDesc.DepthFunc = GetComparisonFunc(GetDepthComparison(DEPTH_STATE_SHADOW, reverseDepth));
+	depthStencilDesc.StencilEnable = false;
+
+	// Create the shadow depth state.
+	result = m_device->CreateDepthStencilState(&depthStencilDesc, &m_depthShadowState);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
 	// Initialize the depth stencil view.
 	ZeroMemory(&depthStencilViewDesc, sizeof(depthStencilViewDesc));
 
 	// Set up the depth stencil view description.
-	depthStencilViewDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+	depthStencilViewDesc.Format = depthFormat;
 	depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
 	depthStencilViewDesc.Texture2D.MipSlice = 0;
 
@@ -338,7 +444,7 @@ bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 	screenAspect = (float)screenWidth / (float)screenHeight;
 
 	// Create the projection matrix for 3D rendering.
-	m_projectionMatrix = XMMatrixPerspectiveFovLH(fieldOfView, screenAspect, screenNear, screenDepth);
+	m_projectionMatrix = BuildProjectionMatrix(fieldOfView, screenAspect, screenNear, screenDepth, reverseDepth);
 
     // Initialize the world matrix to the identity matrix.
 	m_worldMatrix = XMMatrixIdentity();
@@ -350,18 +456,59 @@ bool D3DClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 	// Create the viewport.
 	m_deviceContext->RSSetViewports(1, &viewport);
 
+	// Every model in the engine is an indexed triangle list so the topology only needs to be set once.
+	m_deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	// Create the shader cache object, the post build step has usually filled it already.
+	m_ShaderCache = new ShaderCacheClass;
+	if(!m_ShaderCache)
+	{
+		return false;
+	}
+
+	if(!m_ShaderCache->Initialize(L"../Engine/shadercache"))
+	{
+		return false;
+	}
+
     return true;
 }
 
 
 void D3DClass::Shutdown()
 {
+	unsigned int i;
+
+
+	// Release any resources the engine did not release itself, pipelines included.
+	ClearPipelines();
+	for(i=0; i<m_resources.size(); i++)
+	{
+		ReleaseResource(i + 1);
+	}
+	m_resources.clear();
+
+	// Release the shader cache object.
+	if(m_ShaderCache)
+	{
+		m_ShaderCache->Shutdown();
+		delete m_ShaderCache;
+		m_ShaderCache = 0;
+	}
+
 	// Before shutting down set to windowed mode or when you release the swap chain it will throw an exception.
 	if(m_swapChain)
 	{
 		m_swapChain->SetFullscreenState(false, NULL);
 	}
 
+	// Close the handle of the frame latency object.
+	if(m_frameLatencyWaitableObject)
+	{
+		CloseHandle(m_frameLatencyWaitableObject);
+		m_frameLatencyWaitableObject = 0;
+	}
+
 	if(m_rasterState)
 	{
 		m_rasterState->Release();
@@ -374,6 +521,30 @@ void D3DClass::Shutdown()
 		m_depthStencilView = 0;
 	}
 
+	if(m_depthShadowState)
+	{
+		m_depthShadowState->Release();
+		m_depthShadowState = 0;
+	}
+
+	if(m_depthDisabledState)
+	{
+		m_depthDisabledState->Release();
+		m_depthDisabledState = 0;
+	}
+
+	if(m_depthSkyState)
+	{
+		m_depthSkyState->Release();
+		m_depthSkyState = 0;
+	}
+
+	if(m_depthEqualState)
+	{
+		m_depthEqualState->Release();
+		m_depthEqualState = 0;
+	}
+
 	if(m_depthStencilState)
 	{
 		m_depthStencilState->Release();
@@ -425,11 +596,17 @@ void D3DClass::BeginScene(float red, float green, float blue, float alpha)
 	color[2] = blue;
 	color[3] = alpha;
 
+	// The flip model takes the back buffer off the pipeline at every Present, so bind it again.
+	if(m_flipModel)
+	{
+		m_deviceContext->OMSetRenderTargets(1, &m_renderTargetView, m_depthStencilView);
+	}
+
 	// Clear the back buffer.
 	m_deviceContext->ClearRenderTargetView(m_renderTargetView, color);
     
-	// Clear the depth buffer.
-	m_deviceContext->ClearDepthStencilView(m_depthStencilView, D3D11_CLEAR_DEPTH, 1.0f, 0);
+	// Clear the depth buffer to the far plane.
+	m_deviceContext->ClearDepthStencilView(m_depthStencilView, D3D11_CLEAR_DEPTH, GetFarDepth(), 0);
 
 	return;
 }
@@ -453,6 +630,25 @@ void D3DClass::EndScene()
 }
 
 
+void D3DClass::WaitForFrame()
+{
+	// Block until the frame started now is the next one the swap chain can show, so it is built from the freshest input
+	// instead of sitting in a queue.  The timeout keeps a lost signal from hanging the application.
+	if(m_frameLatencyWaitableObject)
+	{
+		WaitForSingleObjectEx(m_frameLatencyWaitableObject, D3D_FRAME_WAIT_TIMEOUT, TRUE);
+	}
+
+	return;
+}
+
+
+bool D3DClass::IsFlipModel()
+{
+	return m_flipModel;
+}
+
+
 ID3D11Device* D3DClass::GetDevice()
 {
 	return m_device;
@@ -490,5 +686,1279 @@ void D3DClass::GetVideoCardInfo(char* cardName, int& memory)
 {
 	strcpy_s(cardName, 128, m_videoCardDescription);
 	memory = m_videoCardMemory;
+	return;
+}
+
+
+int D3DClass::CreateBuffer(ResourceType type, const void* data, int bytes)
+{
+	DeviceResourceType resource;
+	D3D11_BUFFER_DESC bufferDesc;
+	D3D11_SUBRESOURCE_DATA bufferData;
+	HRESULT result;
+
+
+	// Vertex and index buffers are static and filled once, constant buffers are dynamic and rewritten every draw and
+	// instance buffers are dynamic vertex buffers rewritten every frame.
+	if(type == RESOURCE_CONSTANT_BUFFER)
+	{
+		bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+		bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	}
+	else if(type == RESOURCE_INSTANCE_BUFFER)
+	{
+		bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+		bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	}
+	else
+	{
+		bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		bufferDesc.BindFlags = (type == RESOURCE_INDEX_BUFFER) ? D3D11_BIND_INDEX_BUFFER : D3D11_BIND_VERTEX_BUFFER;
+		bufferDesc.CPUAccessFlags = 0;
+	}
+	bufferDesc.ByteWidth = bytes;
+	bufferDesc.MiscFlags = 0;
+	bufferDesc.StructureByteStride = 0;
+
+	// Give the subresource structure a pointer to the initial data.
+	bufferData.pSysMem = data;
+	bufferData.SysMemPitch = 0;
+	bufferData.SysMemSlicePitch = 0;
+
+	// Create the buffer.
+	ZeroMemory(&resource, sizeof(resource));
+	result = m_device->CreateBuffer(&bufferDesc, data ? &bufferData : NULL, &resource.buffer);
+	if(FAILED(result))
+	{
+		return 0;
+	}
+
+	resource.type = type;
+	resource.bytes = bytes;
+
+	return AddResource(resource);
+}
+
+
+bool D3DClass::UpdateBuffer(int handle, const void* data, int bytes)
+{
+	DeviceResourceType* resource;
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	HRESULT result;
+
+
+	// Only the dynamic constant, structured and instance buffers can be rewritten.
+	resource = GetResource(handle, RESOURCE_CONSTANT_BUFFER);
+	if(!resource)
+	{
+		resource = GetResource(handle, RESOURCE_STRUCTURED_BUFFER);
+	}
+	if(!resource)
+	{
+		resource = GetResource(handle, RESOURCE_INSTANCE_BUFFER);
+	}
+
+	if(!resource || bytes > resource->bytes)
+	{
+		return false;
+	}
+
+	// Lock the buffer, copy the new contents in and unlock it again.
+	result = m_deviceContext->Map(resource->buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
+	memcpy(mappedResource.pData, data, bytes);
+
+	m_deviceContext->Unmap(resource->buffer, 0);
+
+	m_statistics.bufferUpdates++;
+	m_statistics.bufferUpdateBytes += bytes;
+
+	return true;
+}
+
+
+int D3DClass::CreateTexture(const wchar_t* filename)
+{
+	DeviceResourceType resource;
+	HRESULT result;
+
+
+	// Load the texture in.
+	ZeroMemory(&resource, sizeof(resource));
+	result = CreateDDSTextureFromFile(m_device, filename, NULL, &resource.texture, NULL);
+	if(FAILED(result))
+	{
+		return 0;
+	}
+
+	resource.type = RESOURCE_TEXTURE;
+	resource.bytes = GetFileBytes(filename);
+
+	return AddResource(resource);
+}
+
+
+int D3DClass::CreateVertexShader(const wchar_t* filename, const char* entryPoint, VertexFormatType format)
+{
+	static const char* semanticNames[5] = { "POSITION", "TEXCOORD", "NORMAL", "TANGENT", "BINORMAL" };
+	static const DXGI_FORMAT semanticFormats[5] = { DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32_FLOAT, DXGI_FORMAT_R32G32B32_FLOAT,
+		DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32B32_FLOAT };
+	DeviceResourceType resource;
+	ID3D10Blob* vertexShaderBuffer;
+	D3D11_INPUT_ELEMENT_DESC polygonLayout[9];
+	unsigned int numElements, instanceElements, i;
+	HRESULT result;
+
+
+	// Compile the vertex shader code.
+	if(!CompileShader(filename, entryPoint, "vs_5_0", &vertexShaderBuffer))
+	{
+		return 0;
+	}
+
+	// Create the vertex shader from the buffer.
+	ZeroMemory(&resource, sizeof(resource));
+	result = m_device->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &resource.vertexShader);
+	if(FAILED(result))
+	{
+		vertexShaderBuffer->Release();
+		return 0;
+	}
+
+	// The vertex formats all share the same leading elements, they only differ in how many of them they use.
+	instanceElements = 0;
+	switch(format)
+	{
+		case VERTEX_FORMAT_NONE:
+			numElements = 0;
+			break;
+		case VERTEX_FORMAT_POSITION:
+			numElements = 1;
+			break;
+		case VERTEX_FORMAT_POSITION_TEXTURE:
+			numElements = 2;
+			break;
+		case VERTEX_FORMAT_POSITION_TEXTURE_NORMAL:
+			numElements = 3;
+			break;
+		case VERTEX_FORMAT_POSITION_TEXTURE_NORMAL_INSTANCED:
+			numElements = 3;
+			instanceElements = 4;
+			break;
+		default:
+			numElements = 5;
+			break;
+	}
+
+	// Create the vertex input layout description.
+	// This setup needs to match the vertex structures in the model classes and in the shader.
+	for(i=0; i<numElements; i++)
+	{
+		polygonLayout[i].SemanticName = semanticNames[i];
+		polygonLayout[i].SemanticIndex = 0;
+		polygonLayout[i].Format = semanticFormats[i];
+		polygonLayout[i].InputSlot = 0;
+		polygonLayout[i].AlignedByteOffset = (i == 0) ? 0 : D3D11_APPEND_ALIGNED_ELEMENT;
+		polygonLayout[i].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		polygonLayout[i].InstanceDataStepRate = 0;
+	}
+
+	// The instanced format reads the rows of the world matrix of each instance from the second vertex buffer.
+	for(i=0; i<instanceElements; i++)
+	{
+		polygonLayout[numElements + i].SemanticName = "WORLD";
+		polygonLayout[numElements + i].SemanticIndex = i;
+		polygonLayout[numElements + i].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+		polygonLayout[numElements + i].InputSlot = 1;
+		polygonLayout[numElements + i].AlignedByteOffset = (i == 0) ? 0 : D3D11_APPEND_ALIGNED_ELEMENT;
+		polygonLayout[numElements + i].InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+		polygonLayout[numElements + i].InstanceDataStepRate = 1;
+	}
+
+	// Create the vertex input layout, a shader without vertex input is drawn with no layout bound.
+	if(numElements > 0)
+	{
+		result = m_device->CreateInputLayout(polygonLayout, numElements + instanceElements, vertexShaderBuffer->GetBufferPointer(),
+			vertexShaderBuffer->GetBufferSize(), &resource.layout);
+		if(FAILED(result))
+		{
+			resource.vertexShader->Release();
+			vertexShaderBuffer->Release();
+			return 0;
+		}
+	}
+
+	resource.type = RESOURCE_VERTEX_SHADER;
+	resource.bytes = (int)vertexShaderBuffer->GetBufferSize();
+
+	// Release the vertex shader buffer since it is no longer needed.
+	vertexShaderBuffer->Release();
+	vertexShaderBuffer = 0;
+
+	return AddResource(resource);
+}
+
+
+int D3DClass::CreatePixelShader(const wchar_t* filename, const char* entryPoint)
+{
+	DeviceResourceType resource;
+	ID3D10Blob* pixelShaderBuffer;
+	HRESULT result;
+
+
+	// Compile the pixel shader code.
+	if(!CompileShader(filename, entryPoint, "ps_5_0", &pixelShaderBuffer))
+	{
+		return 0;
+	}
+
+	// Create the pixel shader from the buffer.
+	ZeroMemory(&resource, sizeof(resource));
+	result = m_device->CreatePixelShader(pixelShaderBuffer->GetBufferPointer(), pixelShaderBuffer->GetBufferSize(), NULL, &resource.pixelShader);
+	if(FAILED(result))
+	{
+		pixelShaderBuffer->Release();
+		return 0;
+	}
+
+	resource.type = RESOURCE_PIXEL_SHADER;
+	resource.bytes = (int)pixelShaderBuffer->GetBufferSize();
+
+	// Release the pixel shader buffer since it is no longer needed.
+	pixelShaderBuffer->Release();
+	pixelShaderBuffer = 0;
+
+	return AddResource(resource);
+}
+
+
+int D3DClass::CreateSampler()
+{
+	DeviceResourceType resource;
+	D3D11_SAMPLER_DESC samplerDesc;
+	HRESULT result;
+
+
+	// Create a texture sampler state description.
+	samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+	samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.MipLODBias = 0.0f;
+	samplerDesc.MaxAnisotropy = 1;
+	samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+	samplerDesc.BorderColor[0] = 0;
+	samplerDesc.BorderColor[1] = 0;
+	samplerDesc.BorderColor[2] = 0;
+	samplerDesc.BorderColor[3] = 0;
+	samplerDesc.MinLOD = 0;
+	samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+
+	// Create the texture sampler state.
+	ZeroMemory(&resource, sizeof(resource));
+	result = m_device->CreateSamplerState(&samplerDesc, &resource.sampler);
+	if(FAILED(result))
+	{
+		return 0;
+	}
+
+	resource.type = RESOURCE_SAMPLER;
+	resource.bytes = 0;
+
+	return AddResource(resource);
+}
+
+
+int D3DClass::CreateStructuredBuffer(int elementBytes, int elementCount)
+{
+	DeviceResourceType resource;
+	D3D11_BUFFER_DESC bufferDesc;
+	D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc;
+	HRESULT result;
+
+
+	if(elementBytes <= 0 || elementCount <= 0)
+	{
+		return 0;
+	}
+
+	// Setup a dynamic buffer of structures the pixel shader reads through a shader resource view.
+	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDesc.ByteWidth = elementBytes * elementCount;
+	bufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+	bufferDesc.StructureByteStride = elementBytes;
+
+	// Create the buffer, its contents are written later with UpdateBuffer.
+	ZeroMemory(&resource, sizeof(resource));
+	result = m_device->CreateBuffer(&bufferDesc, NULL, &resource.buffer);
+	if(FAILED(result))
+	{
+		return 0;
+	}
+
+	// Setup the view over every element of the buffer.
+	viewDesc.Format = DXGI_FORMAT_UNKNOWN;
+	viewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+	viewDesc.Buffer.FirstElement = 0;
+	viewDesc.Buffer.NumElements = elementCount;
+
+	// Create the shader resource view.
+	result = m_device->CreateShaderResourceView(resource.buffer, &viewDesc, &resource.texture);
+	if(FAILED(result))
+	{
+		resource.buffer->Release();
+		return 0;
+	}
+
+	resource.type = RESOURCE_STRUCTURED_BUFFER;
+	resource.bytes = elementBytes * elementCount;
+
+	return AddResource(resource);
+}
+
+
+int D3DClass::CreateRenderTarget(int width, int height, RenderTargetFormatType format)
+{
+	static const DXGI_FORMAT formats[3] = { DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R16G16_SNORM, DXGI_FORMAT_R32_FLOAT };
+	DeviceResourceType resource;
+	D3D11_TEXTURE2D_DESC textureDesc;
+	ID3D11Texture2D* texture;
+	HRESULT result;
+
+
+	if(width <= 0 || height <= 0 || GetPixelBytes(format) == 0)
+	{
+		return 0;
+	}
+
+	// Setup a single mip texture that can be both drawn to and read by the pixel shader.
+	ZeroMemory(&textureDesc, sizeof(textureDesc));
+	textureDesc.Width = width;
+	textureDesc.Height = height;
+	textureDesc.MipLevels = 1;
+	textureDesc.ArraySize = 1;
+	textureDesc.Format = formats[format];
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Usage = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+	textureDesc.CPUAccessFlags = 0;
+	textureDesc.MiscFlags = 0;
+
+	// Create the render target texture.
+	result = m_device->CreateTexture2D(&textureDesc, NULL, &texture);
+	if(FAILED(result))
+	{
+		return 0;
+	}
+
+	// Create the render target view and the shader resource view over the whole texture.
+	ZeroMemory(&resource, sizeof(resource));
+	result = m_device->CreateRenderTargetView(texture, NULL, &resource.renderTarget);
+	if(FAILED(result))
+	{
+		texture->Release();
+		return 0;
+	}
+
+	result = m_device->CreateShaderResourceView(texture, NULL, &resource.texture);
+	if(FAILED(result))
+	{
+		resource.renderTarget->Release();
+		texture->Release();
+		return 0;
+	}
+
+	// The views keep the texture alive.
+	texture->Release();
+	texture = 0;
+
+	resource.type = RESOURCE_RENDER_TARGET;
+	resource.bytes = width * height * GetPixelBytes(format);
+	resource.width = width;
+	resource.height = height;
+	resource.format = format;
+
+	return AddResource(resource);
+}
+
+
+int D3DClass::CreateDepthTarget(int width, int height)
+{
+	DeviceResourceType resource;
+	D3D11_TEXTURE2D_DESC textureDesc;
+	D3D11_DEPTH_STENCIL_VIEW_DESC depthViewDesc;
+	D3D11_SHADER_RESOURCE_VIEW_DESC shaderViewDesc;
+	ID3D11Texture2D* texture;
+	HRESULT result;
+
+
+	if(width <= 0 || height <= 0)
+	{
+		return 0;
+	}
+
+	// Setup a typeless 32 bit texture so it can be viewed as a float depth buffer and as a float texture.
+	ZeroMemory(&textureDesc, sizeof(textureDesc));
+	textureDesc.Width = width;
+	textureDesc.Height = height;
+	textureDesc.MipLevels = 1;
+	textureDesc.ArraySize = 1;
+	textureDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Usage = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE;
+	textureDesc.CPUAccessFlags = 0;
+	textureDesc.MiscFlags = 0;
+
+	// Create the depth target texture.
+	result = m_device->CreateTexture2D(&textureDesc, NULL, &texture);
+	if(FAILED(result))
+	{
+		return 0;
+	}
+
+	// Create the depth stencil view.
+	ZeroMemory(&depthViewDesc, sizeof(depthViewDesc));
+	depthViewDesc.Format = DXGI_FORMAT_D32_FLOAT;
+	depthViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+	depthViewDesc.Texture2D.MipSlice = 0;
+
+	ZeroMemory(&resource, sizeof(resource));
+	result = m_device->CreateDepthStencilView(texture, &depthViewDesc, &resource.depthTarget);
+	if(FAILED(result))
+	{
+		texture->Release();
+		return 0;
+	}
+
+	// Create the shader resource view that reads the depth as a float.
+	ZeroMemory(&shaderViewDesc, sizeof(shaderViewDesc));
+	shaderViewDesc.Format = DXGI_FORMAT_R32_FLOAT;
+	shaderViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+	shaderViewDesc.Texture2D.MostDetailedMip = 0;
+	shaderViewDesc.Texture2D.MipLevels = 1;
+
+	result = m_device->CreateShaderResourceView(texture, &shaderViewDesc, &resource.texture);
+	if(FAILED(result))
+	{
+		resource.depthTarget->Release();
+		texture->Release();
+		return 0;
+	}
+
+	// The views keep the texture alive.
+	texture->Release();
+	texture = 0;
+
+	resource.type = RESOURCE_DEPTH_TARGET;
+	resource.bytes = width * height * 4;
+	resource.width = width;
+	resource.height = height;
+	resource.format = -1;
+
+	return AddResource(resource);
+}
+
+
+int D3DClass::CreateQuery(ResourceType type)
+{
+	DeviceResourceType resource;
+	D3D11_QUERY_DESC queryDesc;
+	HRESULT result;
+
+
+	if(type != RESOURCE_TIMESTAMP_QUERY && type != RESOURCE_DISJOINT_QUERY)
+	{
+		return 0;
+	}
+
+	// Setup the description of the query.
+	queryDesc.Query = (type == RESOURCE_TIMESTAMP_QUERY) ? D3D11_QUERY_TIMESTAMP : D3D11_QUERY_TIMESTAMP_DISJOINT;
+	queryDesc.MiscFlags = 0;
+
+	// Create the query.
+	ZeroMemory(&resource, sizeof(resource));
+	result = m_device->CreateQuery(&queryDesc, &resource.query);
+	if(FAILED(result))
+	{
+		return 0;
+	}
+
+	resource.type = type;
+	resource.bytes = 0;
+
+	return AddResource(resource);
+}
+
+
+void D3DClass::ReleaseResource(int handle)
+{
+	DeviceResourceType* resource;
+	int i;
+
+
+	// Ignore null and already released handles.
+	if(handle <= 0 || handle > (int)m_resources.size())
+	{
+		return;
+	}
+	resource = &m_resources[handle - 1];
+
+	if(resource->buffer)
+	{
+		resource->buffer->Release();
+	}
+
+	if(resource->texture)
+	{
+		resource->texture->Release();
+	}
+
+	if(resource->renderTarget)
+	{
+		resource->renderTarget->Release();
+	}
+
+	if(resource->depthTarget)
+	{
+		resource->depthTarget->Release();
+	}
+
+	if(resource->layout)
+	{
+		resource->layout->Release();
+	}
+
+	if(resource->vertexShader)
+	{
+		resource->vertexShader->Release();
+	}
+
+	if(resource->pixelShader)
+	{
+		resource->pixelShader->Release();
+	}
+
+	if(resource->sampler)
+	{
+		resource->sampler->Release();
+	}
+
+	if(resource->query)
+	{
+		resource->query->Release();
+	}
+
+	// Forget the texture slots it was bound to, the handle can come back for a new resource.
+	for(i=0; i<D3D_MAX_TEXTURE_SLOTS; i++)
+	{
+		if(m_textureSlots[i] == handle)
+		{
+			m_textureSlots[i] = 0;
+		}
+	}
+
+	// Mark the slot as free so the next resource created can reuse it.
+	ZeroMemory(resource, sizeof(DeviceResourceType));
+	resource->type = -1;
+
+	return;
+}
+
+
+void D3DClass::SetVertexBuffer(int handle, int stride)
+{
+	DeviceResourceType* resource;
+	unsigned int vertexStride, offset;
+
+
+	resource = GetResource(handle, RESOURCE_VERTEX_BUFFER);
+	if(!resource)
+	{
+		return;
+	}
+
+	// Set the vertex buffer to active in the input assembler so it can be rendered.
+	vertexStride = stride;
+	offset = 0;
+	m_deviceContext->IASetVertexBuffers(0, 1, &resource->buffer, &vertexStride, &offset);
+
+	m_statistics.geometryChanges++;
+
+	return;
+}
+
+
+void D3DClass::SetIndexBuffer(int handle)
+{
+	DeviceResourceType* resource;
+
+
+	resource = GetResource(handle, RESOURCE_INDEX_BUFFER);
+	if(!resource)
+	{
+		return;
+	}
+
+	// Set the index buffer to active in the input assembler so it can be rendered.
+	m_deviceContext->IASetIndexBuffer(resource->buffer, DXGI_FORMAT_R32_UINT, 0);
+
+	m_statistics.geometryChanges++;
+
+	return;
+}
+
+
+void D3DClass::SetInstanceBuffer(int handle, int stride)
+{
+	DeviceResourceType* resource;
+	unsigned int instanceStride, offset;
+
+
+	resource = GetResource(handle, RESOURCE_INSTANCE_BUFFER);
+	if(!resource)
+	{
+		return;
+	}
+
+	// Set the instance buffer in the second input slot next to the vertex buffer.
+	instanceStride = stride;
+	offset = 0;
+	m_deviceContext->IASetVertexBuffers(1, 1, &resource->buffer, &instanceStride, &offset);
+
+	m_statistics.geometryChanges++;
+
+	return;
+}
+
+
+void D3DClass::SetShaders(int vertexShader, int pixelShader)
+{
+	DeviceResourceType* vertexResource;
+	DeviceResourceType* pixelResource;
+
+
+	vertexResource = GetResource(vertexShader, RESOURCE_VERTEX_SHADER);
+	if(!vertexResource)
+	{
+		return;
+	}
+
+	// A pixel shader handle of 0 unbinds the pixel shader, as used by the depth only passes.
+	pixelResource = GetResource(pixelShader, RESOURCE_PIXEL_SHADER);
+
+	// Set the vertex input layout and the shaders that will be used to render.
+	m_deviceContext->IASetInputLayout(vertexResource->layout);
+	m_deviceContext->VSSetShader(vertexResource->vertexShader, NULL, 0);
+	m_deviceContext->PSSetShader(pixelResource ? pixelResource->pixelShader : NULL, NULL, 0);
+
+	m_statistics.shaderChanges++;
+
+	return;
+}
+
+
+void D3DClass::SetConstantBuffer(ShaderStageType stage, int slot, int handle)
+{
+	DeviceResourceType* resource;
+
+
+	resource = GetResource(handle, RESOURCE_CONSTANT_BUFFER);
+	if(!resource)
+	{
+		return;
+	}
+
+	// Set the constant buffer in the requested shader stage.
+	if(stage == SHADER_STAGE_VERTEX)
+	{
+		m_deviceContext->VSSetConstantBuffers(slot, 1, &resource->buffer);
+	}
+	else
+	{
+		m_deviceContext->PSSetConstantBuffers(slot, 1, &resource->buffer);
+	}
+
+	m_statistics.constantBufferChanges++;
+
+	return;
+}
+
+
+void D3DClass::SetTexture(int slot, int handle)
+{
+	DeviceResourceType* resource;
+
+
+	// Render and depth targets are read through the same slots as a texture.
+	resource = GetResource(handle, RESOURCE_TEXTURE);
+	if(!resource)
+	{
+		resource = GetResource(handle, RESOURCE_RENDER_TARGET);
+	}
+	if(!resource)
+	{
+		resource = GetResource(handle, RESOURCE_DEPTH_TARGET);
+	}
+
+	if(!resource || slot < 0 || slot >= D3D_MAX_TEXTURE_SLOTS)
+	{
+		return;
+	}
+
+	// Set shader texture resource in the pixel shader.
+	m_deviceContext->PSSetShaderResources(slot, 1, &resource->texture);
+	m_textureSlots[slot] = handle;
+
+	m_statistics.textureChanges++;
+
+	return;
+}
+
+
+void D3DClass::SetShaderBuffer(int slot, int handle)
+{
+	DeviceResourceType* resource;
+
+
+	resource = GetResource(handle, RESOURCE_STRUCTURED_BUFFER);
+	if(!resource || slot < 0 || slot >= D3D_MAX_TEXTURE_SLOTS)
+	{
+		return;
+	}
+
+	// Set the structured buffer in the pixel shader, it shares the resource slots with the textures.
+	m_deviceContext->PSSetShaderResources(slot, 1, &resource->texture);
+	m_textureSlots[slot] = handle;
+
+	m_statistics.shaderBufferChanges++;
+
+	return;
+}
+
+
+void D3DClass::SetSampler(int slot, int handle)
+{
+	DeviceResourceType* resource;
+
+
+	resource = GetResource(handle, RESOURCE_SAMPLER);
+	if(!resource)
+	{
+		return;
+	}
+
+	// Set the sampler state in the pixel shader.
+	m_deviceContext->PSSetSamplers(slot, 1, &resource->sampler);
+
+	m_statistics.samplerChanges++;
+
+	return;
+}
+
+
+void D3DClass::SetDepthState(DepthStateType state)
+{
+	switch(state)
+	{
+		// Only shade the pixels whose depth was written by the prepass.
+		case DEPTH_STATE_EQUAL:
+			m_deviceContext->OMSetDepthStencilState(m_depthEqualState, 1);
+			break;
+
+		// Draw the sky at the far plane behind everything without writing depth.
+		case DEPTH_STATE_SKY:
+			m_deviceContext->OMSetDepthStencilState(m_depthSkyState, 1);
+			break;
+
+		// Cover every pixel of the screen whatever is in the depth buffer.
+		case DEPTH_STATE_DISABLED:
+			m_deviceContext->OMSetDepthStencilState(m_depthDisabledState, 1);
+			break;
+
+		// Draw the shadow casters with the usual depth direction.
+		case DEPTH_STATE_SHADOW:
+			m_deviceContext->OMSetDepthStencilState(m_depthShadowState, 1);
+			break;
+
+		// The default and prepass states both test towards the near plane and write depth.
+		default:
+			m_deviceContext->OMSetDepthStencilState(m_depthStencilState, 1);
+			break;
+	}
+
+	m_statistics.depthStateChanges++;
+
+	return;
+}
+
+
+void D3DClass::SetRenderTargets(const int* targets, int count, int depthTarget)
+{
+	ID3D11RenderTargetView* views[RENDER_MAX_TARGETS];
+	ID3D11DepthStencilView* depthView;
+	DeviceResourceType* resource;
+	D3D11_VIEWPORT viewport;
+	int i, width, height;
+
+
+	if(count < 0 || count > RENDER_MAX_TARGETS || (count > 0 && !targets))
+	{
+		return;
+	}
+
+	// The set is as big as its depth buffer, the back buffer depth is screen sized.
+	depthView = m_depthStencilView;
+	width = m_screenWidth;
+	height = m_screenHeight;
+
+	if(depthTarget)
+	{
+		resource = GetResource(depthTarget, RESOURCE_DEPTH_TARGET);
+		if(!resource)
+		{
+			return;
+		}
+
+		depthView = resource->depthTarget;
+		width = resource->width;
+		height = resource->height;
+	}
+
+	// Every target of the set must be a live render target of the same size as the depth buffer.
+	for(i=0; i<count; i++)
+	{
+		resource = GetResource(targets[i], RESOURCE_RENDER_TARGET);
+		if(!resource || resource->width != width || resource->height != height)
+		{
+			return;
+		}
+
+		views[i] = resource->renderTarget;
+	}
+
+	// A resource cannot be read and drawn to at once, so take the targets out of any slot the last pass read them from.
+	for(i=0; i<count; i++)
+	{
+		UnbindTexture(targets[i]);
+	}
+	UnbindTexture(depthTarget);
+
+	// Bind the targets and cover them with the viewport, no targets at all means the back buffer.
+	if(count == 0 && !depthTarget)
+	{
+		m_deviceContext->OMSetRenderTargets(1, &m_renderTargetView, m_depthStencilView);
+	}
+	else
+	{
+		m_deviceContext->OMSetRenderTargets(count, count ? views : NULL, depthView);
+	}
+
+	viewport.Width = (float)width;
+	viewport.Height = (float)height;
+	viewport.MinDepth = 0.0f;
+	viewport.MaxDepth = 1.0f;
+	viewport.TopLeftX = 0.0f;
+	viewport.TopLeftY = 0.0f;
+
+	m_deviceContext->RSSetViewports(1, &viewport);
+
+	m_targetWidth = width;
+	m_targetHeight = height;
+
+	m_statistics.renderTargetChanges++;
+
+	return;
+}
+
+
+void D3DClass::SetViewport(int width, int height)
+{
+	D3D11_VIEWPORT viewport;
+
+
+	// Keep the viewport inside the bound targets.
+	width = max(1, min(width, m_targetWidth));
+	height = max(1, min(height, m_targetHeight));
+
+	viewport.Width = (float)width;
+	viewport.Height = (float)height;
+	viewport.MinDepth = 0.0f;
+	viewport.MaxDepth = 1.0f;
+	viewport.TopLeftX = 0.0f;
+	viewport.TopLeftY = 0.0f;
+
+	m_deviceContext->RSSetViewports(1, &viewport);
+
+	return;
+}
+
+
+void D3DClass::ClearRenderTarget(int handle, float red, float green, float blue, float alpha)
+{
+	DeviceResourceType* resource;
+	float color[4];
+
+
+	resource = GetResource(handle, RESOURCE_RENDER_TARGET);
+	if(!resource)
+	{
+		return;
+	}
+
+	// Setup the color to clear the target to.
+	color[0] = red;
+	color[1] = green;
+	color[2] = blue;
+	color[3] = alpha;
+
+	m_deviceContext->ClearRenderTargetView(resource->renderTarget, color);
+
+	return;
+}
+
+
+void D3DClass::ClearDepthTarget(int handle, float depth)
+{
+	DeviceResourceType* resource;
+
+
+	resource = GetResource(handle, RESOURCE_DEPTH_TARGET);
+	if(!resource)
+	{
+		return;
+	}
+
+	m_deviceContext->ClearDepthStencilView(resource->depthTarget, D3D11_CLEAR_DEPTH, depth, 0);
+
+	return;
+}
+
+
+void D3DClass::CopyTarget(int destination, int source)
+{
+	DeviceResourceType *destinationResource, *sourceResource;
+	ID3D11Resource *destinationTexture, *sourceTexture;
+
+
+	// Both must be render targets of the same format or both depth targets, and of the same size.
+	if(destination <= 0 || destination > (int)m_resources.size() || source <= 0 || source > (int)m_resources.size() || destination == source)
+	{
+		return;
+	}
+
+	destinationResource = &m_resources[destination - 1];
+	sourceResource = &m_resources[source - 1];
+	if((sourceResource->type != RESOURCE_RENDER_TARGET && sourceResource->type != RESOURCE_DEPTH_TARGET) ||
+	   destinationResource->type != sourceResource->type || destinationResource->format != sourceResource->format ||
+	   destinationResource->width != sourceResource->width || destinationResource->height != sourceResource->height)
+	{
+		return;
+	}
+
+	// Copy the whole texture under the shader resource views.
+	destinationResource->texture->GetResource(&destinationTexture);
+	sourceResource->texture->GetResource(&sourceTexture);
+
+	m_deviceContext->CopyResource(destinationTexture, sourceTexture);
+
+	destinationTexture->Release();
+	sourceTexture->Release();
+
+	return;
+}
+
+
+void D3DClass::DrawIndexed(int indexCount)
+{
+	// Render the triangles.
+	m_deviceContext->DrawIndexed(indexCount, 0, 0);
+
+	m_statistics.drawCalls++;
+	m_statistics.indexCount += indexCount;
+
+	return;
+}
+
+
+void D3DClass::DrawIndexedInstanced(int indexCount, int instanceCount)
+{
+	// Render the triangles once for every instance.
+	m_deviceContext->DrawIndexedInstanced(indexCount, instanceCount, 0, 0, 0);
+
+	m_statistics.drawCalls++;
+	m_statistics.indexCount += indexCount * instanceCount;
+
+	return;
+}
+
+
+void D3DClass::Draw(int vertexCount)
+{
+	// Render the triangles straight from the vertex indices.
+	m_deviceContext->Draw(vertexCount, 0);
+
+	m_statistics.drawCalls++;
+	m_statistics.indexCount += vertexCount;
+
+	return;
+}
+
+
+void D3DClass::BeginQuery(int handle)
+{
+	DeviceResourceType* resource;
+
+
+	// Only the disjoint query covers a range, a timestamp is a single point.
+	resource = GetResource(handle, RESOURCE_DISJOINT_QUERY);
+	if(!resource)
+	{
+		return;
+	}
+
+	m_deviceContext->Begin(resource->query);
+
+	return;
+}
+
+
+void D3DClass::EndQuery(int handle)
+{
+	DeviceResourceType* resource;
+
+
+	resource = GetResource(handle, RESOURCE_TIMESTAMP_QUERY);
+	if(!resource)
+	{
+		resource = GetResource(handle, RESOURCE_DISJOINT_QUERY);
+	}
+
+	if(!resource)
+	{
+		return;
+	}
+
+	m_deviceContext->End(resource->query);
+
+	return;
+}
+
+
+bool D3DClass::GetQueryData(int handle, unsigned long long& value)
+{
+	DeviceResourceType* resource;
+	D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjointData;
+	UINT64 timestamp;
+	HRESULT result;
+
+
+	// Ask for the result without flushing the command buffer, S_FALSE means the GPU has not got there yet.
+	resource = GetResource(handle, RESOURCE_TIMESTAMP_QUERY);
+	if(resource)
+	{
+		result = m_deviceContext->GetData(resource->query, &timestamp, sizeof(timestamp), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+		if(result != S_OK)
+		{
+			return false;
+		}
+
+		value = timestamp;
+		return true;
+	}
+
+	resource = GetResource(handle, RESOURCE_DISJOINT_QUERY);
+	if(!resource)
+	{
+		return false;
+	}
+
+	result = m_deviceContext->GetData(resource->query, &disjointData, sizeof(disjointData), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+	if(result != S_OK)
+	{
+		return false;
+	}
+
+	// A frequency of 0 tells the caller to throw the timestamps of the frame away.
+	value = disjointData.Disjoint ? 0 : disjointData.Frequency;
+
+	return true;
+}
+
+
+int D3DClass::GetResourceBytes()
+{
+	unsigned int i;
+	int bytes;
+
+
+	// Add up the size of every live resource.
+	bytes = 0;
+	for(i=0; i<m_resources.size(); i++)
+	{
+		if(m_resources[i].type != -1)
+		{
+			bytes += m_resources[i].bytes;
+		}
+	}
+
+	return bytes;
+}
+
+
+int D3DClass::AddResource(const DeviceResourceType& resource)
+{
+	unsigned int i;
+
+
+	// Reuse the first released slot if there is one.
+	for(i=0; i<m_resources.size(); i++)
+	{
+		if(m_resources[i].type == -1)
+		{
+			m_resources[i] = resource;
+			return i + 1;
+		}
+	}
+
+	// Otherwise grow the table, handles are the slot index plus one so that 0 stays invalid.
+	m_resources.push_back(resource);
+
+	return (int)m_resources.size();
+}
+
+
+D3DClass::DeviceResourceType* D3DClass::GetResource(int handle, int type)
+{
+	// Check the handle is in range and refers to a live resource of the expected type.
+	if(handle <= 0 || handle > (int)m_resources.size())
+	{
+		return 0;
+	}
+
+	if(m_resources[handle - 1].type != type)
+	{
+		return 0;
+	}
+
+	return &m_resources[handle - 1];
+}
+
+
+void D3DClass::UnbindTexture(int handle)
+{
+	ID3D11ShaderResourceView* nullView;
+	int i;
+
+
+	if(!handle)
+	{
+		return;
+	}
+
+	// Clear every pixel shader slot the resource is bound to.
+	nullView = 0;
+	for(i=0; i<D3D_MAX_TEXTURE_SLOTS; i++)
+	{
+		if(m_textureSlots[i] == handle)
+		{
+			m_deviceContext->PSSetShaderResources(i, 1, &nullView);
+			m_textureSlots[i] = 0;
+		}
+	}
+
+	return;
+}
+
+
+D3D11_COMPARISON_FUNC D3DClass::GetComparisonFunc(DepthComparisonType comparison)
+{
+	switch(comparison)
+	{
+		case DEPTH_COMPARISON_LESS:
+			return D3D11_COMPARISON_LESS;
+		case DEPTH_COMPARISON_LESS_EQUAL:
+			return D3D11_COMPARISON_LESS_EQUAL;
+		case DEPTH_COMPARISON_GREATER:
+			return D3D11_COMPARISON_GREATER;
+		case DEPTH_COMPARISON_GREATER_EQUAL:
+			return D3D11_COMPARISON_GREATER_EQUAL;
+		case DEPTH_COMPARISON_EQUAL:
+			return D3D11_COMPARISON_EQUAL;
+		default:
+			return D3D11_COMPARISON_ALWAYS;
+	}
+}
+
+
+bool D3DClass::CompileShader(const wchar_t* filename, const char* entryPoint, const char* target, ID3D10Blob** shaderBuffer)
+{
+	CpuZoneClass zone("CompileShader");
+	ID3D10Blob* errorMessage;
+	bool result;
+
+
+	// Load the shader bytecode from the cache, it is only compiled when the source has changed since the last run.
+	result = m_ShaderCache->GetShader(filename, entryPoint, target, shaderBuffer, &errorMessage);
+	if(!result)
+	{
+		// If the shader failed to compile it should have writen something to the error message.
+		if(errorMessage)
+		{
+			OutputShaderErrorMessage(errorMessage, filename);
+		}
+		// If there was nothing in the error message then it simply could not find the shader file itself.
+		else
+		{
+			MessageBox(m_hwnd, filename, L"Missing Shader File", MB_OK);
+		}
+
+		return false;
+	}
+
+	return true;
+}
+
+
+void D3DClass::OutputShaderErrorMessage(ID3D10Blob* errorMessage, const wchar_t* shaderFilename)
+{
+	char* compileErrors;
+	unsigned long bufferSize, i;
+	ofstream fout;
+
+
+	// Get a pointer to the error message text buffer.
+	compileErrors = (char*)(errorMessage->GetBufferPointer());
+
+	// Get the length of the message.
+	bufferSize = (unsigned long)errorMessage->GetBufferSize();
+
+	// Open a file to write the error message to.
+	fout.open("shader-error.txt");
+
+	// Write out the error message.
+	for(i=0; i<bufferSize; i++)
+	{
+		fout << compileErrors[i];
+	}
+
+	// Close the file.
+	fout.close();
+
+	// Release the error message.
+	errorMessage->Release();
+	errorMessage = 0;
+
+	// Pop a message up on the screen to notify the user to check the text file for compile errors.
+	MessageBox(m_hwnd, L"Error compiling shader.  Check shader-error.txt for message.", shaderFilename, MB_OK);
+
 	return;
 }
\ No newline at end of file
@@ -17,28 +17,102 @@
 //////////////
 // INCLUDES //
 //////////////
-#include <dxgi.h>
+#include <dxgi1_3.h>
 #include <d3d11_1.h>
+#include <d3dcompiler.h>
 #include <DirectXMath.h>
+#include "DDSTextureLoader.h"
 
 using namespace DirectX;
 
+#include <fstream>
+#include <vector>
+using namespace std;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+#include "shadercacheclass.h"
+#include "cpuprofilerclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int D3D_MAX_TEXTURE_SLOTS = 16;
+const int D3D_MAX_FRAME_LATENCY = 1;
+const DWORD D3D_FRAME_WAIT_TIMEOUT = 1000;
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: D3DClass
 ////////////////////////////////////////////////////////////////////////////////
-class D3DClass
+class D3DClass : public RenderDeviceClass
 {
+private:
+	struct DeviceResourceType
+	{
+		int type;
+		int bytes;
+		int width, height, format;
+		ID3D11Buffer* buffer;
+		// The shader resource view of a texture, a structured buffer, a render target or a depth target.
+		ID3D11ShaderResourceView* texture;
+		ID3D11RenderTargetView* renderTarget;
+		ID3D11DepthStencilView* depthTarget;
+		ID3D11VertexShader* vertexShader;
+		ID3D11InputLayout* layout;
+		ID3D11PixelShader* pixelShader;
+		ID3D11SamplerState* sampler;
+		ID3D11Query* query;
+	};
+
 public:
 	D3DClass();
 	D3DClass(const D3DClass&);
 	~D3DClass();
 
-	bool Initialize(int, int, bool, HWND, bool, float, float);
+	bool Initialize(int, int, bool, HWND, bool, float, float, bool);
 	void Shutdown();
 	
 	void BeginScene(float, float, float, float);
 	void EndScene();
+	void WaitForFrame();
+	bool IsFlipModel();
+
+	int CreateBuffer(ResourceType, const void*, int);
+	bool UpdateBuffer(int, const void*, int);
+	int CreateTexture(const wchar_t*);
+	int CreateVertexShader(const wchar_t*, const char*, VertexFormatType);
+	int CreatePixelShader(const wchar_t*, const char*);
+	int CreateSampler();
+	int CreateStructuredBuffer(int, int);
+	int CreateRenderTarget(int, int, RenderTargetFormatType);
+	int CreateDepthTarget(int, int);
+	int CreateQuery(ResourceType);
+	void ReleaseResource(int);
+
+	void SetVertexBuffer(int, int);
+	void SetIndexBuffer(int);
+	void SetInstanceBuffer(int, int);
+	void SetConstantBuffer(ShaderStageType, int, int);
+	void SetTexture(int, int);
+	void SetShaderBuffer(int, int);
+	void SetDepthState(DepthStateType);
+	void SetRenderTargets(const int*, int, int);
+	void SetViewport(int, int);
+	void ClearRenderTarget(int, float, float, float, float);
+	void ClearDepthTarget(int, float);
+	void CopyTarget(int, int);
+	void DrawIndexed(int);
+	void DrawIndexedInstanced(int, int);
+	void Draw(int);
+
+	void BeginQuery(int);
+	void EndQuery(int);
+	bool GetQueryData(int, unsigned long long&);
 
 	ID3D11Device* GetDevice();
 	ID3D11DeviceContext* GetDeviceContext();
@@ -47,24 +121,51 @@ public:
 	void GetWorldMatrix(XMMATRIX&);
 	void GetOrthoMatrix(XMMATRIX&);
 
+	int GetResourceBytes();
+
 	void GetVideoCardInfo(char*, int&);
 
+protected:
+	void SetShaders(int, int);
+	void SetSampler(int, int);
+
+private:
+	int AddResource(const DeviceResourceType&);
+	DeviceResourceType* GetResource(int, int);
+	void UnbindTexture(int);
+	D3D11_COMPARISON_FUNC GetComparisonFunc(DepthComparisonType);
+	bool CompileShader(const wchar_t*, const char*, const char*, ID3D10Blob**);
+	void OutputShaderErrorMessage(ID3D10Blob*, const wchar_t*);
+
 private:
+	HWND m_hwnd;
+	ShaderCacheClass* m_ShaderCache;
+	int m_screenWidth, m_screenHeight;
+	int m_targetWidth, m_targetHeight;
 	bool m_vsync_enabled;
 	int m_videoCardMemory;
 	char m_videoCardDescription[128];
 	IDXGISwapChain* m_swapChain;
+	HANDLE m_frameLatencyWaitableObject;
+	bool m_flipModel;
 	ID3D11Device* m_device;
 	ID3D11DeviceContext* m_deviceContext;
 	ID3D11RenderTargetView* m_renderTargetView;
 	ID3D11Texture2D* m_depthStencilBuffer;
 	ID3D11DepthStencilState* m_depthStencilState;
+	ID3D11DepthStencilState* m_depthEqualState;
+	ID3D11DepthStencilState* m_depthSkyState;
+	ID3D11DepthStencilState* m_depthDisabledState;
+	ID3D11DepthStencilState* m_depthShadowState;
 	ID3D11DepthStencilView* m_depthStencilView;
 	ID3D11RasterizerState* m_rasterState;
 
 	XMMATRIX m_projectionMatrix;
 	XMMATRIX m_worldMatrix;
 	XMMATRIX m_orthoMatrix;
+
+	vector<DeviceResourceType> m_resources;
+	int m_textureSlots[D3D_MAX_TEXTURE_SLOTS];
 };
 
 #endif
\ No newline at end of file
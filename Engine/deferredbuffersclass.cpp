@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: deferredbuffersclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "deferredbuffersclass.h"
+
+
+DeferredBuffersClass::DeferredBuffersClass()
+{
+	int i;
+
+
+	m_Device = 0;
+	for(i=0; i<DEFERRED_BUFFER_COUNT; i++)
+	{
+		m_renderTargets[i] = 0;
+	}
+}
+
+
+DeferredBuffersClass::DeferredBuffersClass(const DeferredBuffersClass& other)
+{
+}
+
+
+DeferredBuffersClass::~DeferredBuffersClass()
+{
+}
+
+
+bool DeferredBuffersClass::Initialize(RenderDeviceClass* device, int width, int height)
+{
+	RenderDeviceClass::RenderTargetFormatType formats[DEFERRED_BUFFER_COUNT];
+	int i;
+
+
+	// Store the device the render targets are created on.
+	m_Device = device;
+
+	// Pick the format of every target in the order of the buffer types.
+	formats[BUFFER_COLOR] = RenderDeviceClass::RENDER_TARGET_RGBA8;
+	formats[BUFFER_NORMAL] = RenderDeviceClass::RENDER_TARGET_RG16_SNORM;
+	formats[BUFFER_DEPTH] = RenderDeviceClass::RENDER_TARGET_R32_FLOAT;
+
+	// Create the render targets.
+	for(i=0; i<DEFERRED_BUFFER_COUNT; i++)
+	{
+		m_renderTargets[i] = m_Device->CreateRenderTarget(width, height, formats[i]);
+		if(!m_renderTargets[i])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+void DeferredBuffersClass::Shutdown()
+{
+	int i;
+
+
+	// Release the render targets.
+	for(i=0; i<DEFERRED_BUFFER_COUNT; i++)
+	{
+		if(m_renderTargets[i])
+		{
+			m_Device->ReleaseResource(m_renderTargets[i]);
+			m_renderTargets[i] = 0;
+		}
+	}
+
+	return;
+}
+
+
+void DeferredBuffersClass::SetRenderTargets(int depthTarget)
+{
+	// Bind all the targets at once with the depth buffer the scene is drawn with, 0 is the one of the back buffer.
+	m_Device->SetRenderTargets(m_renderTargets, DEFERRED_BUFFER_COUNT, depthTarget);
+
+	return;
+}
+
+
+void DeferredBuffersClass::ClearRenderTargets()
+{
+	int i;
+
+
+	// Clear every target to 0, which also marks every pixel as empty in the depth target.
+	for(i=0; i<DEFERRED_BUFFER_COUNT; i++)
+	{
+		m_Device->ClearRenderTarget(m_renderTargets[i], 0.0f, 0.0f, 0.0f, 0.0f);
+	}
+
+	return;
+}
+
+
+int DeferredBuffersClass::GetTexture(BufferType buffer)
+{
+	return m_renderTargets[buffer];
+}
\ No newline at end of file
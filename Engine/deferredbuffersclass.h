@@ -0,0 +1,55 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: deferredbuffersclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _DEFERREDBUFFERSCLASS_H_
+#define _DEFERREDBUFFERSCLASS_H_
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int DEFERRED_BUFFER_COUNT = 3;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: DeferredBuffersClass
+//
+// The G-buffer of the deferred path, 12 bytes per pixel in three render targets.  The first holds the albedo with the
+// specular power over 255 in its alpha, the second the normal folded onto an octahedron in two signed 16 bit channels
+// and the third the linear view depth the light pass rebuilds the position from.  A depth of 0 marks empty pixels.
+////////////////////////////////////////////////////////////////////////////////
+class DeferredBuffersClass
+{
+public:
+	enum BufferType
+	{
+		BUFFER_COLOR,
+		BUFFER_NORMAL,
+		BUFFER_DEPTH
+	};
+
+public:
+	DeferredBuffersClass();
+	DeferredBuffersClass(const DeferredBuffersClass&);
+	~DeferredBuffersClass();
+
+	bool Initialize(RenderDeviceClass*, int, int);
+	void Shutdown();
+
+	void SetRenderTargets(int);
+	void ClearRenderTargets();
+
+	int GetTexture(BufferType);
+
+private:
+	RenderDeviceClass* m_Device;
+	int m_renderTargets[DEFERRED_BUFFER_COUNT];
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,205 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: deferredlightshaderclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "deferredlightshaderclass.h"
+
+
+DeferredLightShaderClass::DeferredLightShaderClass()
+{
+	m_Device = 0;
+	m_pipeline = 0;
+	m_lightBuffer = 0;
+	m_cameraBuffer = 0;
+}
+
+
+DeferredLightShaderClass::DeferredLightShaderClass(const DeferredLightShaderClass& other)
+{
+}
+
+
+DeferredLightShaderClass::~DeferredLightShaderClass()
+{
+}
+
+
+bool DeferredLightShaderClass::Initialize(RenderDeviceClass* device)
+{
+	bool result;
+
+
+	// Store the device the shader objects are created on.
+	m_Device = device;
+
+	// Initialize the vertex and pixel shaders.
+	result = InitializeShader(L"../Engine/deferredlight.vs", L"../Engine/deferredlight.ps");
+	if(!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void DeferredLightShaderClass::Shutdown()
+{
+	// Shutdown the vertex and pixel shaders as well as the related objects.
+	ShutdownShader();
+
+	return;
+}
+
+
+bool DeferredLightShaderClass::Render(int colorTexture, int normalTexture, int depthTexture, const XMMATRIX &viewMatrix,
+	const XMMATRIX &projectionMatrix, XMFLOAT3 lightDirection, XMFLOAT4 ambientColor, XMFLOAT4 diffuseColor, XMFLOAT4 specularColor)
+{
+	bool result;
+
+
+	// Set the shader parameters that it will use for rendering.
+	result = SetShaderParameters(colorTexture, normalTexture, depthTexture, viewMatrix, projectionMatrix, lightDirection, ambientColor,
+								 diffuseColor, specularColor);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Now light the whole screen with the shader.
+	RenderShader();
+
+	return true;
+}
+
+
+int DeferredLightShaderClass::GetPipeline()
+{
+	return m_pipeline;
+}
+
+
+bool DeferredLightShaderClass::InitializeShader(const wchar_t* vsFilename, const wchar_t* psFilename)
+{
+	RenderDeviceClass::PipelineDescType pipelineDesc;
+
+
+	// Describe the pipeline, the vertex shader has no input and the G-buffer is read texel by texel without a sampler.
+	pipelineDesc.vertexShaderFilename = vsFilename;
+	pipelineDesc.vertexShaderEntryPoint = "DeferredLightVertexShader";
+	pipelineDesc.vertexFormat = RenderDeviceClass::VERTEX_FORMAT_NONE;
+	pipelineDesc.pixelShaderFilename = psFilename;
+	pipelineDesc.pixelShaderEntryPoint = "DeferredLightPixelShader";
+	pipelineDesc.sampler = RenderDeviceClass::SAMPLER_NONE;
+
+	// Create the pipeline, it shares any shader or sampler another pipeline already created.
+	m_pipeline = m_Device->CreatePipeline(pipelineDesc);
+	if(!m_pipeline)
+	{
+		return false;
+	}
+
+	// Create the dynamic light constant buffer that is in the pixel shader.
+	m_lightBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_CONSTANT_BUFFER, NULL, sizeof(LightBufferType));
+	if(!m_lightBuffer)
+	{
+		return false;
+	}
+
+	// Create the dynamic camera constant buffer that is in the pixel shader.
+	m_cameraBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_CONSTANT_BUFFER, NULL, sizeof(CameraBufferType));
+	if(!m_cameraBuffer)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void DeferredLightShaderClass::ShutdownShader()
+{
+	// Release the camera constant buffer.
+	if(m_cameraBuffer)
+	{
+		m_Device->ReleaseResource(m_cameraBuffer);
+		m_cameraBuffer = 0;
+	}
+
+	// Release the light constant buffer.
+	if(m_lightBuffer)
+	{
+		m_Device->ReleaseResource(m_lightBuffer);
+		m_lightBuffer = 0;
+	}
+
+	// Release the pipeline.
+	if(m_pipeline)
+	{
+		m_Device->ReleasePipeline(m_pipeline);
+		m_pipeline = 0;
+	}
+
+	return;
+}
+
+
+bool DeferredLightShaderClass::SetShaderParameters(int colorTexture, int normalTexture, int depthTexture, const XMMATRIX &viewMatrix,
+	const XMMATRIX &projectionMatrix, XMFLOAT3 lightDirection, XMFLOAT4 ambientColor, XMFLOAT4 diffuseColor, XMFLOAT4 specularColor)
+{
+	LightBufferType lightBuffer;
+	CameraBufferType cameraBuffer;
+	XMFLOAT4X4 projection;
+	bool result;
+
+
+	// Copy the lighting variables into the light constant buffer, the specular power comes from the G-buffer.
+	lightBuffer.ambientColor = ambientColor;
+	lightBuffer.diffuseColor = diffuseColor;
+	lightBuffer.lightDirection = lightDirection;
+	lightBuffer.padding = 0.0f;
+	lightBuffer.specularColor = specularColor;
+
+	result = m_Device->UpdateBuffer(m_lightBuffer, &lightBuffer, sizeof(LightBufferType));
+	if(!result)
+	{
+		return false;
+	}
+
+	m_Device->SetConstantBuffer(RenderDeviceClass::SHADER_STAGE_PIXEL, 0, m_lightBuffer);
+
+	// Store the transposed inverse view matrix and the inverse projection scales, which is all it takes to turn a screen
+	// position and a view depth back into a world position.
+	XMStoreFloat4x4(&projection, projectionMatrix);
+
+	cameraBuffer.inverseView = XMMatrixTranspose(XMMatrixInverse(NULL, viewMatrix));
+	cameraBuffer.projectionScale = XMFLOAT2(1.0f / projection._11, 1.0f / projection._22);
+	cameraBuffer.padding = XMFLOAT2(0.0f, 0.0f);
+
+	result = m_Device->UpdateBuffer(m_cameraBuffer, &cameraBuffer, sizeof(CameraBufferType));
+	if(!result)
+	{
+		return false;
+	}
+
+	// The ClusterBuffer fills slot 1.
+	m_Device->SetConstantBuffer(RenderDeviceClass::SHADER_STAGE_PIXEL, 2, m_cameraBuffer);
+
+	// Bind the G-buffer around the cluster buffers.
+	m_Device->SetTexture(0, colorTexture);
+	m_Device->SetTexture(4, normalTexture);
+	m_Device->SetTexture(5, depthTexture);
+
+	return true;
+}
+
+
+void DeferredLightShaderClass::RenderShader()
+{
+	// Bind the shaders in one go, the pipeline has no input layout or sampler.
+	m_Device->SetPipeline(m_pipeline);
+
+	// Render the fullscreen triangle.
+	m_Device->Draw(3);
+
+	return;
+}
\ No newline at end of file
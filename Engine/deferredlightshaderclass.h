@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: deferredlightshaderclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _DEFERREDLIGHTSHADERCLASS_H_
+#define _DEFERREDLIGHTSHADERCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <DirectXMath.h>
+using namespace DirectX;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: DeferredLightShaderClass
+//
+// Lights every covered pixel of the G-buffer once with one fullscreen triangle, using the same directional light and
+// clustered point lights as the light shader.  The G-buffer is read in slots 0, 4 and 5 as slots 1 to 3 hold the
+// cluster buffers.
+////////////////////////////////////////////////////////////////////////////////
+class DeferredLightShaderClass
+{
+private:
+	struct LightBufferType
+	{
+		XMFLOAT4 ambientColor;
+		XMFLOAT4 diffuseColor;
+		XMFLOAT3 lightDirection;
+		float padding;
+		XMFLOAT4 specularColor;
+	};
+
+	struct CameraBufferType
+	{
+		XMMATRIX inverseView;
+		XMFLOAT2 projectionScale;
+		XMFLOAT2 padding;
+	};
+
+public:
+	DeferredLightShaderClass();
+	DeferredLightShaderClass(const DeferredLightShaderClass&);
+	~DeferredLightShaderClass();
+
+	bool Initialize(RenderDeviceClass*);
+	void Shutdown();
+	bool Render(int, int, int, const XMMATRIX&, const XMMATRIX&, XMFLOAT3, XMFLOAT4, XMFLOAT4, XMFLOAT4);
+
+	int GetPipeline();
+
+private:
+	bool InitializeShader(const wchar_t*, const wchar_t*);
+	void ShutdownShader();
+
+	bool SetShaderParameters(int, int, int, const XMMATRIX&, const XMMATRIX&, XMFLOAT3, XMFLOAT4, XMFLOAT4, XMFLOAT4);
+	void RenderShader();
+
+private:
+	RenderDeviceClass* m_Device;
+	int m_pipeline;
+	int m_lightBuffer;
+	int m_cameraBuffer;
+};
+
+#endif
\ No newline at end of file
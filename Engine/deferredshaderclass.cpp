@@ -0,0 +1,197 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: deferredshaderclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "deferredshaderclass.h"
+
+
+DeferredShaderClass::DeferredShaderClass()
+{
+	m_Device = 0;
+	m_pipeline = 0;
+	m_matrixBuffer = 0;
+	m_materialBuffer = 0;
+}
+
+
+DeferredShaderClass::DeferredShaderClass(const DeferredShaderClass& other)
+{
+}
+
+
+DeferredShaderClass::~DeferredShaderClass()
+{
+}
+
+
+bool DeferredShaderClass::Initialize(RenderDeviceClass* device)
+{
+	bool result;
+
+
+	// Store the device the shader objects are created on.
+	m_Device = device;
+
+	// Initialize the vertex and pixel shaders.
+	result = InitializeShader(L"../Engine/deferred.vs", L"../Engine/deferred.ps");
+	if(!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void DeferredShaderClass::Shutdown()
+{
+	// Shutdown the vertex and pixel shaders as well as the related objects.
+	ShutdownShader();
+
+	return;
+}
+
+
+bool DeferredShaderClass::Render(int indexCount, const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix,
+	int texture, float specularPower)
+{
+	bool result;
+
+
+	// Set the shader parameters that it will use for rendering.
+	result = SetShaderParameters(worldMatrix, viewMatrix, projectionMatrix, texture, specularPower);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Now render the prepared buffers with the shader.
+	RenderShader(indexCount);
+
+	return true;
+}
+
+
+int DeferredShaderClass::GetPipeline()
+{
+	return m_pipeline;
+}
+
+
+bool DeferredShaderClass::InitializeShader(const wchar_t* vsFilename, const wchar_t* psFilename)
+{
+	RenderDeviceClass::PipelineDescType pipelineDesc;
+
+
+	// Describe the pipeline with the same input layout as the light shader.
+	pipelineDesc.vertexShaderFilename = vsFilename;
+	pipelineDesc.vertexShaderEntryPoint = "DeferredVertexShader";
+	pipelineDesc.vertexFormat = RenderDeviceClass::VERTEX_FORMAT_POSITION_TEXTURE_NORMAL;
+	pipelineDesc.pixelShaderFilename = psFilename;
+	pipelineDesc.pixelShaderEntryPoint = "DeferredPixelShader";
+	pipelineDesc.sampler = RenderDeviceClass::SAMPLER_LINEAR_WRAP;
+
+	// Create the pipeline, it shares any shader or sampler another pipeline already created.
+	m_pipeline = m_Device->CreatePipeline(pipelineDesc);
+	if(!m_pipeline)
+	{
+		return false;
+	}
+
+	// Create the dynamic matrix constant buffer that is in the vertex shader.
+	m_matrixBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_CONSTANT_BUFFER, NULL, sizeof(MatrixBufferType));
+	if(!m_matrixBuffer)
+	{
+		return false;
+	}
+
+	// Create the dynamic material constant buffer that is in the pixel shader.
+	m_materialBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_CONSTANT_BUFFER, NULL, sizeof(MaterialBufferType));
+	if(!m_materialBuffer)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void DeferredShaderClass::ShutdownShader()
+{
+	// Release the material constant buffer.
+	if(m_materialBuffer)
+	{
+		m_Device->ReleaseResource(m_materialBuffer);
+		m_materialBuffer = 0;
+	}
+
+	// Release the matrix constant buffer.
+	if(m_matrixBuffer)
+	{
+		m_Device->ReleaseResource(m_matrixBuffer);
+		m_matrixBuffer = 0;
+	}
+
+	// Release the pipeline.
+	if(m_pipeline)
+	{
+		m_Device->ReleasePipeline(m_pipeline);
+		m_pipeline = 0;
+	}
+
+	return;
+}
+
+
+bool DeferredShaderClass::SetShaderParameters(const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix,
+	int texture, float specularPower)
+{
+	MatrixBufferType matrixBuffer;
+	MaterialBufferType materialBuffer;
+	bool result;
+
+
+	// Transpose the matrices to prepare them for the shader.
+	matrixBuffer.world = XMMatrixTranspose(worldMatrix);
+	matrixBuffer.view = XMMatrixTranspose(viewMatrix);
+	matrixBuffer.projection = XMMatrixTranspose(projectionMatrix);
+
+	// Copy the matrices into the constant buffer.
+	result = m_Device->UpdateBuffer(m_matrixBuffer, &matrixBuffer, sizeof(MatrixBufferType));
+	if(!result)
+	{
+		return false;
+	}
+
+	// Now set the constant buffer in the vertex shader with the updated values.
+	m_Device->SetConstantBuffer(RenderDeviceClass::SHADER_STAGE_VERTEX, 0, m_matrixBuffer);
+
+	// Set shader texture resource in the pixel shader.
+	m_Device->SetTexture(0, texture);
+
+	// Copy the specular power into the material constant buffer.
+	materialBuffer.specularPower = specularPower;
+	materialBuffer.padding = XMFLOAT3(0.0f, 0.0f, 0.0f);
+
+	result = m_Device->UpdateBuffer(m_materialBuffer, &materialBuffer, sizeof(MaterialBufferType));
+	if(!result)
+	{
+		return false;
+	}
+
+	// Finally set the material constant buffer in the pixel shader with the updated values.
+	m_Device->SetConstantBuffer(RenderDeviceClass::SHADER_STAGE_PIXEL, 0, m_materialBuffer);
+
+	return true;
+}
+
+
+void DeferredShaderClass::RenderShader(int indexCount)
+{
+	// Bind the shaders, input layout and sampler in one go.
+	m_Device->SetPipeline(m_pipeline);
+
+	// Render the triangle.
+	m_Device->DrawIndexed(indexCount);
+
+	return;
+}
\ No newline at end of file
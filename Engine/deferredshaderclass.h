@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: deferredshaderclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _DEFERREDSHADERCLASS_H_
+#define _DEFERREDSHADERCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <DirectXMath.h>
+using namespace DirectX;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: DeferredShaderClass
+//
+// Writes the albedo, normal, specular power and view depth of the models the light shader would draw into the bound
+// G-buffer, without doing any lighting.
+////////////////////////////////////////////////////////////////////////////////
+class DeferredShaderClass
+{
+private:
+	struct MatrixBufferType
+	{
+		XMMATRIX world;
+		XMMATRIX view;
+		XMMATRIX projection;
+	};
+
+	struct MaterialBufferType
+	{
+		float specularPower;
+		XMFLOAT3 padding;
+	};
+
+public:
+	DeferredShaderClass();
+	DeferredShaderClass(const DeferredShaderClass&);
+	~DeferredShaderClass();
+
+	bool Initialize(RenderDeviceClass*);
+	void Shutdown();
+	bool Render(int, const XMMATRIX&, const XMMATRIX&, const XMMATRIX&, int, float);
+
+	int GetPipeline();
+
+private:
+	bool InitializeShader(const wchar_t*, const wchar_t*);
+	void ShutdownShader();
+
+	bool SetShaderParameters(const XMMATRIX&, const XMMATRIX&, const XMMATRIX&, int, float);
+	void RenderShader(int);
+
+private:
+	RenderDeviceClass* m_Device;
+	int m_pipeline;
+	int m_matrixBuffer;
+	int m_materialBuffer;
+};
+
+#endif
\ No newline at end of file
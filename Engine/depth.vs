@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: depth.vs
+////////////////////////////////////////////////////////////////////////////////
+
+
+/////////////
+// GLOBALS //
+/////////////
+cbuffer MatrixBuffer
+{
+	matrix worldMatrix;
+	matrix viewMatrix;
+	matrix projectionMatrix;
+};
+
+
+//////////////
+// TYPEDEFS //
+//////////////
+struct VertexInputType
+{
+    float4 position : POSITION;
+};
+
+struct PixelInputType
+{
+    float4 position : SV_POSITION;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Vertex Shader
+////////////////////////////////////////////////////////////////////////////////
+PixelInputType DepthVertexShader(VertexInputType input)
+{
+    PixelInputType output;
+    
+
+	// Change the position vector to be 4 units for proper matrix calculations.
+    input.position.w = 1.0f;
+
+	// Calculate the position of the vertex against the world, view, and projection matrices.
+	// This must stay the same sequence of multiplies as texture.vs and light.vs so the depth matches for the EQUAL test.
+    output.position = mul(input.position, worldMatrix);
+    output.position = mul(output.position, viewMatrix);
+    output.position = mul(output.position, projectionMatrix);
+    
+    return output;
+}
\ No newline at end of file
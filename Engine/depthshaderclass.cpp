@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: depthshaderclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "depthshaderclass.h"
+
+
+DepthShaderClass::DepthShaderClass()
+{
+	m_Device = 0;
+	m_pipeline = 0;
+	m_matrixBuffer = 0;
+}
+
+
+DepthShaderClass::DepthShaderClass(const DepthShaderClass& other)
+{
+}
+
+
+DepthShaderClass::~DepthShaderClass()
+{
+}
+
+
+bool DepthShaderClass::Initialize(RenderDeviceClass* device)
+{
+	bool result;
+
+
+	// Store the device the shader objects are created on.
+	m_Device = device;
+
+	// Initialize the vertex shader.  The depth prepass has no pixel shader.
+	result = InitializeShader(L"../Engine/depth.vs");
+	if(!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void DepthShaderClass::Shutdown()
+{
+	// Shutdown the vertex shader as well as the related objects.
+	ShutdownShader();
+
+	return;
+}
+
+
+bool DepthShaderClass::Render(int indexCount, const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix)
+{
+	bool result;
+
+
+	// Set the shader parameters that it will use for rendering.
+	result = SetShaderParameters(worldMatrix, viewMatrix, projectionMatrix);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Now render the prepared buffers with the shader.
+	RenderShader(indexCount);
+
+	return true;
+}
+
+
+int DepthShaderClass::GetPipeline()
+{
+	return m_pipeline;
+}
+
+
+bool DepthShaderClass::InitializeShader(const wchar_t* vsFilename)
+{
+	RenderDeviceClass::PipelineDescType pipelineDesc;
+
+
+	// Describe the pipeline without a pixel shader or sampler, it only reads the position stream of the ModelClass.
+	pipelineDesc.vertexShaderFilename = vsFilename;
+	pipelineDesc.vertexShaderEntryPoint = "DepthVertexShader";
+	pipelineDesc.vertexFormat = RenderDeviceClass::VERTEX_FORMAT_POSITION;
+	pipelineDesc.pixelShaderFilename = 0;
+	pipelineDesc.pixelShaderEntryPoint = 0;
+	pipelineDesc.sampler = RenderDeviceClass::SAMPLER_NONE;
+
+	// Create the pipeline.
+	m_pipeline = m_Device->CreatePipeline(pipelineDesc);
+	if(!m_pipeline)
+	{
+		return false;
+	}
+
+	// Create the dynamic matrix constant buffer that is in the vertex shader.
+	m_matrixBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_CONSTANT_BUFFER, NULL, sizeof(MatrixBufferType));
+	if(!m_matrixBuffer)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void DepthShaderClass::ShutdownShader()
+{
+	// Release the matrix constant buffer.
+	if(m_matrixBuffer)
+	{
+		m_Device->ReleaseResource(m_matrixBuffer);
+		m_matrixBuffer = 0;
+	}
+
+	// Release the pipeline.
+	if(m_pipeline)
+	{
+		m_Device->ReleasePipeline(m_pipeline);
+		m_pipeline = 0;
+	}
+
+	return;
+}
+
+
+bool DepthShaderClass::SetShaderParameters(const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix)
+{
+	MatrixBufferType matrixBuffer;
+	bool result;
+
+
+	// Transpose the matrices to prepare them for the shader.
+	matrixBuffer.world = XMMatrixTranspose(worldMatrix);
+	matrixBuffer.view = XMMatrixTranspose(viewMatrix);
+	matrixBuffer.projection = XMMatrixTranspose(projectionMatrix);
+
+	// Copy the matrices into the constant buffer.
+	result = m_Device->UpdateBuffer(m_matrixBuffer, &matrixBuffer, sizeof(MatrixBufferType));
+	if(!result)
+	{
+		return false;
+	}
+
+	// Now set the constant buffer in the vertex shader with the updated values.
+	m_Device->SetConstantBuffer(RenderDeviceClass::SHADER_STAGE_VERTEX, 0, m_matrixBuffer);
+
+	return true;
+}
+
+
+void DepthShaderClass::RenderShader(int indexCount)
+{
+	// Bind the depth only pipeline, it has no pixel shader so only depth is written.
+	m_Device->SetPipeline(m_pipeline);
+
+	// Render the triangles.
+	m_Device->DrawIndexed(indexCount);
+
+	return;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: depthshaderclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _DEPTHSHADERCLASS_H_
+#define _DEPTHSHADERCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <DirectXMath.h>
+using namespace DirectX;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: DepthShaderClass
+////////////////////////////////////////////////////////////////////////////////
+class DepthShaderClass
+{
+private:
+	struct MatrixBufferType
+	{
+		XMMATRIX world;
+		XMMATRIX view;
+		XMMATRIX projection;
+	};
+
+public:
+	DepthShaderClass();
+	DepthShaderClass(const DepthShaderClass&);
+	~DepthShaderClass();
+
+	bool Initialize(RenderDeviceClass*);
+	void Shutdown();
+	bool Render(int, const XMMATRIX&, const XMMATRIX&, const XMMATRIX&);
+
+	int GetPipeline();
+
+private:
+	bool InitializeShader(const wchar_t*);
+	void ShutdownShader();
+
+	bool SetShaderParameters(const XMMATRIX&, const XMMATRIX&, const XMMATRIX&);
+	void RenderShader(int);
+
+private:
+	RenderDeviceClass* m_Device;
+	int m_pipeline;
+	int m_matrixBuffer;
+};
+
+#endif
\ No newline at end of file
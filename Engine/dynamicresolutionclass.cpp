@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: dynamicresolutionclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "dynamicresolutionclass.h"
+
+
+DynamicResolutionClass::DynamicResolutionClass()
+{
+	m_Device = 0;
+	m_renderTarget = 0;
+	m_depthTarget = 0;
+	m_screenWidth = 0;
+	m_screenHeight = 0;
+	m_nextFrame = 0;
+}
+
+
+DynamicResolutionClass::DynamicResolutionClass(const DynamicResolutionClass& other)
+{
+}
+
+
+DynamicResolutionClass::~DynamicResolutionClass()
+{
+}
+
+
+bool DynamicResolutionClass::Initialize(RenderDeviceClass* device, int screenWidth, int screenHeight, float budget)
+{
+	bool result;
+
+
+	// Store the device the targets are created on and the size they cover at the full scale.
+	m_Device = device;
+	m_screenWidth = screenWidth;
+	m_screenHeight = screenHeight;
+
+	// Initialize the controller with the frame budget and the range of scales.
+	result = m_Controller.Initialize(budget, RESOLUTION_MIN_SCALE, RESOLUTION_MAX_SCALE);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Create the scene color and depth targets at the full screen size.
+	m_renderTarget = m_Device->CreateRenderTarget(screenWidth, screenHeight, RenderDeviceClass::RENDER_TARGET_RGBA8);
+	if(!m_renderTarget)
+	{
+		return false;
+	}
+
+	m_depthTarget = m_Device->CreateDepthTarget(screenWidth, screenHeight);
+	if(!m_depthTarget)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void DynamicResolutionClass::Shutdown()
+{
+	// Release the depth target.
+	if(m_depthTarget)
+	{
+		m_Device->ReleaseResource(m_depthTarget);
+		m_depthTarget = 0;
+	}
+
+	// Release the render target.
+	if(m_renderTarget)
+	{
+		m_Device->ReleaseResource(m_renderTarget);
+		m_renderTarget = 0;
+	}
+
+	return;
+}
+
+
+void DynamicResolutionClass::Update(GpuProfilerClass* gpuProfiler)
+{
+	float frameTime;
+
+
+	// Hand every frame read back since the last update to the controller in order, the dropped ones have no time and
+	// the ones older than the history of the profiler are gone.
+	m_nextFrame = max(m_nextFrame, gpuProfiler->GetReadFrameIndex() - GPU_PROFILER_HISTORY);
+	while(m_nextFrame < gpuProfiler->GetReadFrameIndex())
+	{
+		if(gpuProfiler->GetRecordedFrameTime(m_nextFrame, frameTime))
+		{
+			m_Controller.Update(frameTime);
+		}
+
+		m_nextFrame++;
+	}
+
+	return;
+}
+
+
+void DynamicResolutionClass::SetScale(float scale)
+{
+	// Restart the controller from the given scale, the frames already measured are forgotten.
+	m_Controller.Reset(scale);
+
+	return;
+}
+
+
+void DynamicResolutionClass::SetRenderTargets()
+{
+	// Bind the scene targets and only draw to the corner of them the current scale covers.
+	m_Device->SetRenderTargets(&m_renderTarget, 1, m_depthTarget);
+	m_Device->SetViewport(GetWidth(), GetHeight());
+
+	return;
+}
+
+
+void DynamicResolutionClass::ClearRenderTargets()
+{
+	// Clear the color the way the back buffer is cleared and the depth to the far plane.
+	m_Device->ClearRenderTarget(m_renderTarget, 0.0f, 0.0f, 0.0f, 1.0f);
+	m_Device->ClearDepthTarget(m_depthTarget, m_Device->GetFarDepth());
+
+	return;
+}
+
+
+int DynamicResolutionClass::GetTexture()
+{
+	return m_renderTarget;
+}
+
+
+int DynamicResolutionClass::GetDepthTarget()
+{
+	return m_depthTarget;
+}
+
+
+float DynamicResolutionClass::GetScale()
+{
+	return m_Controller.GetScale();
+}
+
+
+int DynamicResolutionClass::GetWidth()
+{
+	return max(1, (int)((float)m_screenWidth * m_Controller.GetScale() + 0.5f));
+}
+
+
+int DynamicResolutionClass::GetHeight()
+{
+	return max(1, (int)((float)m_screenHeight * m_Controller.GetScale() + 0.5f));
+}
+
+
+int DynamicResolutionClass::GetTextureWidth()
+{
+	return m_screenWidth;
+}
+
+
+int DynamicResolutionClass::GetTextureHeight()
+{
+	return m_screenHeight;
+}
+
+
+ResolutionControllerClass* DynamicResolutionClass::GetController()
+{
+	return &m_Controller;
+}
\ No newline at end of file
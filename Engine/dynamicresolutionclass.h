@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: dynamicresolutionclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _DYNAMICRESOLUTIONCLASS_H_
+#define _DYNAMICRESOLUTIONCLASS_H_
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+#include "gpuprofilerclass.h"
+#include "resolutioncontrollerclass.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: DynamicResolutionClass
+//
+// The screen sized color and depth targets the scene is drawn into at a lower resolution when the GPU falls behind.
+// Only the top left corner of them is drawn to, so changing the scale never recreates a target, and the upscale pass
+// stretches that corner over the back buffer.  Every frame the GPU profiler has read back since the last update is
+// handed to the resolution controller, which picks the scale of the frames to come.
+////////////////////////////////////////////////////////////////////////////////
+class DynamicResolutionClass
+{
+public:
+	DynamicResolutionClass();
+	DynamicResolutionClass(const DynamicResolutionClass&);
+	~DynamicResolutionClass();
+
+	bool Initialize(RenderDeviceClass*, int, int, float);
+	void Shutdown();
+
+	void Update(GpuProfilerClass*);
+	void SetScale(float);
+
+	void SetRenderTargets();
+	void ClearRenderTargets();
+
+	int GetTexture();
+	int GetDepthTarget();
+	float GetScale();
+	int GetWidth();
+	int GetHeight();
+	int GetTextureWidth();
+	int GetTextureHeight();
+	ResolutionControllerClass* GetController();
+
+private:
+	RenderDeviceClass* m_Device;
+	ResolutionControllerClass m_Controller;
+	int m_renderTarget, m_depthTarget;
+	int m_screenWidth, m_screenHeight;
+	int m_nextFrame;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,348 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: entityclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "entityclass.h"
+
+
+template <class T>
+static bool GrowArray(T*& data, int count, int capacity)
+{
+	T* newData;
+	int i;
+
+
+	// Create the larger array and copy the existing rows over.
+	newData = new T[capacity];
+	if(!newData)
+	{
+		return false;
+	}
+
+	for(i=0; i<count; i++)
+	{
+		newData[i] = data[i];
+	}
+
+	delete [] data;
+	data = newData;
+
+	return true;
+}
+
+
+EntityClass::EntityClass()
+{
+	m_WorkerPool = 0;
+	m_threadCount = 1;
+	m_archetypeCount = 0;
+}
+
+
+EntityClass::EntityClass(const EntityClass& other)
+{
+}
+
+
+EntityClass::~EntityClass()
+{
+}
+
+
+bool EntityClass::Initialize(WorkerPoolClass* workerPool)
+{
+	// Store the number of threads the systems may split their work across, without a pool they run on this thread.
+	m_WorkerPool = workerPool;
+	m_threadCount = m_WorkerPool ? m_WorkerPool->GetThreadCount() : 1;
+	if(m_threadCount > ENTITY_MAX_THREADS)
+	{
+		m_threadCount = ENTITY_MAX_THREADS;
+	}
+
+	m_archetypeCount = 0;
+
+	return true;
+}
+
+
+void EntityClass::Shutdown()
+{
+	int i;
+
+
+	// Release the component arrays of every archetype.
+	for(i=0; i<m_archetypeCount; i++)
+	{
+		ReleaseArchetype(&m_archetypes[i]);
+	}
+
+	m_archetypeCount = 0;
+	m_WorkerPool = 0;
+
+	return;
+}
+
+
+int EntityClass::CreateEntity(unsigned int mask, int& archetype)
+{
+	ArchetypeType* type;
+	int row;
+
+
+	// Find the archetype for this set of components, creating it the first time it is used.
+	archetype = FindArchetype(mask);
+	if(archetype < 0)
+	{
+		if(m_archetypeCount >= ENTITY_MAX_ARCHETYPES)
+		{
+			return -1;
+		}
+
+		archetype = m_archetypeCount;
+		m_archetypeCount++;
+
+		type = &m_archetypes[archetype];
+		type->mask = mask;
+		type->count = 0;
+		type->capacity = 0;
+		type->transformNode = 0;
+		type->mesh = 0;
+		type->orbitNode = 0;
+		type->orbitSpeed = 0;
+		type->followOffsetX = 0;
+		type->followOffsetY = 0;
+		type->followOffsetZ = 0;
+	}
+
+	type = &m_archetypes[archetype];
+
+	// Make room for the new row.
+	if(type->count == type->capacity)
+	{
+		if(!GrowArchetype(type))
+		{
+			return -1;
+		}
+	}
+
+	// Append the entity to the end of the dense arrays, the caller fills in its components.
+	row = type->count;
+	type->count++;
+
+	return row;
+}
+
+
+int EntityClass::GetArchetypeCount()
+{
+	return m_archetypeCount;
+}
+
+
+EntityClass::ArchetypeType* EntityClass::GetArchetype(int index)
+{
+	return &m_archetypes[index];
+}
+
+
+int EntityClass::GetEntityCount()
+{
+	int i, count;
+
+
+	count = 0;
+	for(i=0; i<m_archetypeCount; i++)
+	{
+		count += m_archetypes[i].count;
+	}
+
+	return count;
+}
+
+
+void EntityClass::UpdateOrbits(TransformClass* transforms, float rotation)
+{
+	RowJobType job;
+	int i;
+
+
+	job.transforms = transforms;
+	job.rotation = rotation;
+
+	for(i=0; i<m_archetypeCount; i++)
+	{
+		job.type = &m_archetypes[i];
+		if((job.type->mask & COMPONENT_ORBIT) == 0)
+		{
+			continue;
+		}
+
+		// Small archetypes are not worth waking the workers for.
+		if((m_threadCount == 1) || (job.type->count < ENTITY_PARALLEL_MIN_COUNT))
+		{
+			OrbitRows(&job, 0, job.type->count);
+			continue;
+		}
+
+		// Split the rows into one contiguous block per thread, every row writes its own transform node.
+		m_WorkerPool->Run(OrbitRows, &job, job.type->count, (job.type->count + m_threadCount - 1) / m_threadCount);
+	}
+
+	return;
+}
+
+
+void EntityClass::UpdateFollowers(TransformClass* transforms, float targetX, float targetY, float targetZ)
+{
+	RowJobType job;
+	int i;
+
+
+	job.transforms = transforms;
+	job.targetX = targetX;
+	job.targetY = targetY;
+	job.targetZ = targetZ;
+
+	for(i=0; i<m_archetypeCount; i++)
+	{
+		job.type = &m_archetypes[i];
+		if((job.type->mask & (COMPONENT_FOLLOW | COMPONENT_TRANSFORM)) != (COMPONENT_FOLLOW | COMPONENT_TRANSFORM))
+		{
+			continue;
+		}
+
+		// Small archetypes are not worth waking the workers for.
+		if((m_threadCount == 1) || (job.type->count < ENTITY_PARALLEL_MIN_COUNT))
+		{
+			FollowRows(&job, 0, job.type->count);
+			continue;
+		}
+
+		// Split the rows into one contiguous block per thread, every row writes its own transform node.
+		m_WorkerPool->Run(FollowRows, &job, job.type->count, (job.type->count + m_threadCount - 1) / m_threadCount);
+	}
+
+	return;
+}
+
+
+int EntityClass::FindArchetype(unsigned int mask)
+{
+	int i;
+
+
+	for(i=0; i<m_archetypeCount; i++)
+	{
+		if(m_archetypes[i].mask == mask)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+
+bool EntityClass::GrowArchetype(ArchetypeType* type)
+{
+	int capacity;
+	bool result;
+
+
+	// Double the capacity so adding many entities stays linear overall.
+	capacity = (type->capacity == 0) ? 64 : type->capacity * 2;
+
+	result = true;
+	if(type->mask & COMPONENT_TRANSFORM)
+	{
+		result = result && GrowArray(type->transformNode, type->count, capacity);
+	}
+
+	if(type->mask & COMPONENT_MESH)
+	{
+		result = result && GrowArray(type->mesh, type->count, capacity);
+	}
+
+	if(type->mask & COMPONENT_ORBIT)
+	{
+		result = result && GrowArray(type->orbitNode, type->count, capacity);
+		result = result && GrowArray(type->orbitSpeed, type->count, capacity);
+	}
+
+	if(type->mask & COMPONENT_FOLLOW)
+	{
+		result = result && GrowArray(type->followOffsetX, type->count, capacity);
+		result = result && GrowArray(type->followOffsetY, type->count, capacity);
+		result = result && GrowArray(type->followOffsetZ, type->count, capacity);
+	}
+
+	if(!result)
+	{
+		return false;
+	}
+
+	type->capacity = capacity;
+
+	return true;
+}
+
+
+void EntityClass::ReleaseArchetype(ArchetypeType* type)
+{
+	delete [] type->transformNode;
+	delete [] type->mesh;
+	delete [] type->orbitNode;
+	delete [] type->orbitSpeed;
+	delete [] type->followOffsetX;
+	delete [] type->followOffsetY;
+	delete [] type->followOffsetZ;
+
+	type->transformNode = 0;
+	type->mesh = 0;
+	type->orbitNode = 0;
+	type->orbitSpeed = 0;
+	type->followOffsetX = 0;
+	type->followOffsetY = 0;
+	type->followOffsetZ = 0;
+
+	type->count = 0;
+	type->capacity = 0;
+
+	return;
+}
+
+
+void EntityClass::OrbitRows(void* context, int start, int end)
+{
+	RowJobType* job;
+	int i;
+
+
+	job = (RowJobType*)context;
+
+	// Spin each orbit pivot around the world Y axis.
+	for(i=start; i<end; i++)
+	{
+		job->transforms->SetLocalRotation(job->type->orbitNode[i], 0.0f, job->rotation * job->type->orbitSpeed[i], 0.0f);
+	}
+
+	return;
+}
+
+
+void EntityClass::FollowRows(void* context, int start, int end)
+{
+	RowJobType* job;
+	int i;
+
+
+	job = (RowJobType*)context;
+
+	// Place each follower at its offset from the target.
+	for(i=start; i<end; i++)
+	{
+		job->transforms->SetLocalPosition(job->type->transformNode[i], job->type->followOffsetX[i] + job->targetX,
+										  job->type->followOffsetY[i] + job->targetY, job->type->followOffsetZ[i] + job->targetZ);
+	}
+
+	return;
+}
\ No newline at end of file
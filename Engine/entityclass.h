@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: entityclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _ENTITYCLASS_H_
+#define _ENTITYCLASS_H_
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "transformclass.h"
+#include "workerpoolclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int ENTITY_MAX_ARCHETYPES = 16;
+const int ENTITY_MAX_THREADS = 8;
+const int ENTITY_PARALLEL_MIN_COUNT = 4096;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: EntityClass
+////////////////////////////////////////////////////////////////////////////////
+class EntityClass
+{
+public:
+	enum ComponentType
+	{
+		COMPONENT_TRANSFORM = 1,
+		COMPONENT_MESH = 2,
+		COMPONENT_ORBIT = 4,
+		COMPONENT_FOLLOW = 8
+	};
+
+	// Every entity with the same set of components lives in the same archetype, in dense arrays indexed by row.
+	// Only the arrays of the components in the mask are allocated.
+	struct ArchetypeType
+	{
+		unsigned int mask;
+		int count, capacity;
+
+		// Transform component, the node of the entity in the transform hierarchy.
+		int* transformNode;
+
+		// Mesh component, the scene prefab that is drawn for the entity.
+		int* mesh;
+
+		// Orbit component, a pivot node spun around Y at a speed relative to the scene rotation.
+		int* orbitNode;
+		float* orbitSpeed;
+
+		// Follow component, an offset from the followed target.
+		float *followOffsetX, *followOffsetY, *followOffsetZ;
+	};
+
+private:
+	// What a system hands the worker pool along with each block of rows.
+	struct RowJobType
+	{
+		ArchetypeType* type;
+		TransformClass* transforms;
+		float rotation;
+		float targetX, targetY, targetZ;
+	};
+
+public:
+	EntityClass();
+	EntityClass(const EntityClass&);
+	~EntityClass();
+
+	bool Initialize(WorkerPoolClass*);
+	void Shutdown();
+
+	int CreateEntity(unsigned int, int&);
+
+	int GetArchetypeCount();
+	ArchetypeType* GetArchetype(int);
+	int GetEntityCount();
+
+	void UpdateOrbits(TransformClass*, float);
+	void UpdateFollowers(TransformClass*, float, float, float);
+
+private:
+	int FindArchetype(unsigned int);
+	bool GrowArchetype(ArchetypeType*);
+	void ReleaseArchetype(ArchetypeType*);
+
+	static void OrbitRows(void*, int, int);
+	static void FollowRows(void*, int, int);
+
+private:
+	WorkerPoolClass* m_WorkerPool;
+	int m_threadCount;
+	int m_archetypeCount;
+	ArchetypeType m_archetypes[ENTITY_MAX_ARCHETYPES];
+};
+
+#endif
\ No newline at end of file
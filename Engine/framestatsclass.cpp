@@ -0,0 +1,202 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: framestatsclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "framestatsclass.h"
+
+
+FrameStatsClass::FrameStatsClass()
+{
+	m_historySize = 0;
+	m_historyIndex = 0;
+	m_total = 0.0;
+	m_budget = 0.0;
+	m_overBudgetCount = 0;
+	m_totalFrameCount = 0;
+	m_totalOverBudgetCount = 0;
+}
+
+
+FrameStatsClass::FrameStatsClass(const FrameStatsClass& other)
+{
+}
+
+
+FrameStatsClass::~FrameStatsClass()
+{
+}
+
+
+bool FrameStatsClass::Initialize(int historySize, double budget)
+{
+	if(historySize <= 0 || budget <= 0.0)
+	{
+		return false;
+	}
+
+	// Reserve the whole window up front so adding a frame never allocates.
+	m_historySize = historySize;
+	m_budget = budget;
+	m_history.reserve(historySize);
+	m_sorted.reserve(historySize);
+
+	Reset();
+
+	return true;
+}
+
+
+void FrameStatsClass::Shutdown()
+{
+	m_history.clear();
+	m_history.shrink_to_fit();
+	m_sorted.clear();
+	m_sorted.shrink_to_fit();
+	m_historySize = 0;
+
+	return;
+}
+
+
+void FrameStatsClass::Reset()
+{
+	m_history.clear();
+	m_sorted.clear();
+	m_historyIndex = 0;
+	m_total = 0.0;
+	m_overBudgetCount = 0;
+	m_totalFrameCount = 0;
+	m_totalOverBudgetCount = 0;
+
+	return;
+}
+
+
+void FrameStatsClass::AddFrame(double frameTime)
+{
+	vector<double>::iterator position;
+	double oldest;
+
+
+	if(m_historySize == 0)
+	{
+		return;
+	}
+
+	if((int)m_history.size() < m_historySize)
+	{
+		// Grow the window until it is full.
+		m_history.push_back(frameTime);
+	}
+	else
+	{
+		// Take the oldest frame out of the window, the sorted copy holds the same value somewhere.
+		oldest = m_history[m_historyIndex];
+		m_history[m_historyIndex] = frameTime;
+		m_historyIndex = (m_historyIndex + 1) % m_historySize;
+
+		position = lower_bound(m_sorted.begin(), m_sorted.end(), oldest);
+		m_sorted.erase(position);
+
+		m_total -= oldest;
+		if(oldest > m_budget)
+		{
+			m_overBudgetCount--;
+		}
+	}
+
+	// Insert the new frame in order.
+	position = upper_bound(m_sorted.begin(), m_sorted.end(), frameTime);
+	m_sorted.insert(position, frameTime);
+
+	m_total += frameTime;
+	m_totalFrameCount++;
+
+	if(frameTime > m_budget)
+	{
+		m_overBudgetCount++;
+		m_totalOverBudgetCount++;
+	}
+
+	return;
+}
+
+
+int FrameStatsClass::GetFrameCount()
+{
+	return (int)m_sorted.size();
+}
+
+
+int FrameStatsClass::GetTotalFrameCount()
+{
+	return m_totalFrameCount;
+}
+
+
+double FrameStatsClass::GetMinimum()
+{
+	return m_sorted.empty() ? 0.0 : m_sorted.front();
+}
+
+
+double FrameStatsClass::GetMean()
+{
+	return m_sorted.empty() ? 0.0 : m_total / (double)m_sorted.size();
+}
+
+
+double FrameStatsClass::GetMaximum()
+{
+	return m_sorted.empty() ? 0.0 : m_sorted.back();
+}
+
+
+double FrameStatsClass::GetPercentile(double percentile)
+{
+	int rank;
+
+
+	if(m_sorted.empty())
+	{
+		return 0.0;
+	}
+
+	// The nearest rank is the smallest frame time that at least the given percent of the frames do not exceed.
+	rank = (int)ceil(percentile / 100.0 * (double)m_sorted.size());
+	rank = max(1, min(rank, (int)m_sorted.size()));
+
+	return m_sorted[rank - 1];
+}
+
+
+int FrameStatsClass::GetOverBudgetCount()
+{
+	return m_overBudgetCount;
+}
+
+
+int FrameStatsClass::GetTotalOverBudgetCount()
+{
+	return m_totalOverBudgetCount;
+}
+
+
+double FrameStatsClass::GetBudget()
+{
+	return m_budget;
+}
+
+
+void FrameStatsClass::GetSummary(SummaryType& summary)
+{
+	summary.frameCount = GetFrameCount();
+	summary.minimum = GetMinimum();
+	summary.mean = GetMean();
+	summary.median = GetPercentile(50.0);
+	summary.percentile95 = GetPercentile(95.0);
+	summary.percentile99 = GetPercentile(99.0);
+	summary.maximum = GetMaximum();
+	summary.overBudgetCount = GetOverBudgetCount();
+
+	return;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: framestatsclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _FRAMESTATSCLASS_H_
+#define _FRAMESTATSCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+using namespace std;
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int FRAME_STATS_HISTORY = 1024;
+const double FRAME_STATS_BUDGET = 1000.0 / 60.0;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: FrameStatsClass
+//
+// Keeps the frame times of the last frames in a ring and a sorted copy of the same window, both updated as each frame
+// comes in, so the percentiles are a lookup instead of a sort.  The percentiles use the nearest rank.  Frames longer
+// than the budget are counted both in the window and since the last reset.
+////////////////////////////////////////////////////////////////////////////////
+class FrameStatsClass
+{
+public:
+	struct SummaryType
+	{
+		int frameCount;
+		double minimum, mean, median, percentile95, percentile99, maximum;
+		int overBudgetCount;
+	};
+
+public:
+	FrameStatsClass();
+	FrameStatsClass(const FrameStatsClass&);
+	~FrameStatsClass();
+
+	bool Initialize(int, double);
+	void Shutdown();
+	void Reset();
+
+	void AddFrame(double);
+
+	int GetFrameCount();
+	int GetTotalFrameCount();
+	double GetMinimum();
+	double GetMean();
+	double GetMaximum();
+	double GetPercentile(double);
+	int GetOverBudgetCount();
+	int GetTotalOverBudgetCount();
+	double GetBudget();
+	void GetSummary(SummaryType&);
+
+private:
+	vector<double> m_history;
+	vector<double> m_sorted;
+	int m_historySize, m_historyIndex;
+	double m_total, m_budget;
+	int m_overBudgetCount;
+	int m_totalFrameCount, m_totalOverBudgetCount;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,507 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: gpuprofilerclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "gpuprofilerclass.h"
+
+
+GpuProfilerClass::GpuProfilerClass()
+{
+	m_Device = 0;
+	memset(m_frames, 0, sizeof(m_frames));
+	m_frameIndex = 0;
+	m_readIndex = 0;
+	m_frameOpen = false;
+	m_passOpen = false;
+	m_passCount = 0;
+	m_frameTotal = 0.0;
+	m_historyIndex = 0;
+	m_historyCount = 0;
+	m_completedFrames = 0;
+	m_droppedFrames = 0;
+	m_disjointFrames = 0;
+}
+
+
+GpuProfilerClass::GpuProfilerClass(const GpuProfilerClass& other)
+{
+}
+
+
+GpuProfilerClass::~GpuProfilerClass()
+{
+}
+
+
+bool GpuProfilerClass::Initialize(RenderDeviceClass* device)
+{
+	int i, j;
+
+
+	m_Device = device;
+
+	// Create every query of the ring up front, a frame only ever reuses the queries of the frame that was read from
+	// its slot.
+	for(i=0; i<GPU_PROFILER_FRAMES; i++)
+	{
+		m_frames[i].disjointQuery = m_Device->CreateQuery(RenderDeviceClass::RESOURCE_DISJOINT_QUERY);
+		m_frames[i].beginQuery = m_Device->CreateQuery(RenderDeviceClass::RESOURCE_TIMESTAMP_QUERY);
+		m_frames[i].endQuery = m_Device->CreateQuery(RenderDeviceClass::RESOURCE_TIMESTAMP_QUERY);
+		if(!m_frames[i].disjointQuery || !m_frames[i].beginQuery || !m_frames[i].endQuery)
+		{
+			return false;
+		}
+
+		for(j=0; j<GPU_PROFILER_MAX_PASSES; j++)
+		{
+			m_frames[i].passBeginQueries[j] = m_Device->CreateQuery(RenderDeviceClass::RESOURCE_TIMESTAMP_QUERY);
+			m_frames[i].passEndQueries[j] = m_Device->CreateQuery(RenderDeviceClass::RESOURCE_TIMESTAMP_QUERY);
+			if(!m_frames[i].passBeginQueries[j] || !m_frames[i].passEndQueries[j])
+			{
+				return false;
+			}
+		}
+
+		m_frames[i].markerCount = 0;
+	}
+
+	m_frameIndex = 0;
+	m_readIndex = 0;
+	m_frameOpen = false;
+	m_passOpen = false;
+	m_passCount = 0;
+	memset(m_frameHistory, 0, sizeof(m_frameHistory));
+	for(i=0; i<GPU_PROFILER_HISTORY; i++)
+	{
+		m_frameIndices[i] = -1;
+	}
+	m_frameTotal = 0.0;
+	m_historyIndex = 0;
+	m_historyCount = 0;
+	m_completedFrames = 0;
+	m_droppedFrames = 0;
+	m_disjointFrames = 0;
+
+	return true;
+}
+
+
+void GpuProfilerClass::Shutdown()
+{
+	int i, j;
+
+
+	if(!m_Device)
+	{
+		return;
+	}
+
+	// Release the queries of the ring.
+	for(i=0; i<GPU_PROFILER_FRAMES; i++)
+	{
+		m_Device->ReleaseResource(m_frames[i].disjointQuery);
+		m_Device->ReleaseResource(m_frames[i].beginQuery);
+		m_Device->ReleaseResource(m_frames[i].endQuery);
+
+		for(j=0; j<GPU_PROFILER_MAX_PASSES; j++)
+		{
+			m_Device->ReleaseResource(m_frames[i].passBeginQueries[j]);
+			m_Device->ReleaseResource(m_frames[i].passEndQueries[j]);
+		}
+	}
+
+	memset(m_frames, 0, sizeof(m_frames));
+	m_Device = 0;
+
+	return;
+}
+
+
+void GpuProfilerClass::BeginFrame()
+{
+	FrameType* frame;
+
+
+	if(!m_Device || m_frameOpen)
+	{
+		return;
+	}
+
+	// The slot of this frame must have been read.  Give the oldest frame one more chance and drop it if the GPU is still
+	// behind, waiting for it would stall the CPU.
+	if(m_frameIndex - m_readIndex >= GPU_PROFILER_FRAMES)
+	{
+		CollectFrames();
+		if(m_frameIndex - m_readIndex >= GPU_PROFILER_FRAMES)
+		{
+			m_readIndex++;
+			m_droppedFrames++;
+		}
+	}
+
+	frame = &m_frames[m_frameIndex % GPU_PROFILER_FRAMES];
+	frame->markerCount = 0;
+
+	// Open the disjoint range around the frame and mark its start.
+	m_Device->BeginQuery(frame->disjointQuery);
+	m_Device->EndQuery(frame->beginQuery);
+
+	m_frameOpen = true;
+
+	return;
+}
+
+
+void GpuProfilerClass::EndFrame()
+{
+	FrameType* frame;
+
+
+	if(!m_frameOpen)
+	{
+		return;
+	}
+
+	EndPass();
+
+	// Mark the end of the frame and close the disjoint range.
+	frame = &m_frames[m_frameIndex % GPU_PROFILER_FRAMES];
+	m_Device->EndQuery(frame->endQuery);
+	m_Device->EndQuery(frame->disjointQuery);
+
+	m_frameIndex++;
+	m_frameOpen = false;
+
+	// Read back every earlier frame that has finished on the GPU by now.
+	CollectFrames();
+
+	return;
+}
+
+
+void GpuProfilerClass::BeginPass(const char* name)
+{
+	FrameType* frame;
+	int pass;
+
+
+	if(!m_frameOpen)
+	{
+		return;
+	}
+
+	// Passes do not nest, a new one ends the last.
+	EndPass();
+
+	frame = &m_frames[m_frameIndex % GPU_PROFILER_FRAMES];
+	if(frame->markerCount >= GPU_PROFILER_MAX_PASSES)
+	{
+		return;
+	}
+
+	pass = FindPass(name);
+	if(pass < 0)
+	{
+		return;
+	}
+
+	frame->passes[frame->markerCount] = pass;
+	m_Device->EndQuery(frame->passBeginQueries[frame->markerCount]);
+
+	m_passOpen = true;
+
+	return;
+}
+
+
+void GpuProfilerClass::EndPass()
+{
+	FrameType* frame;
+
+
+	if(!m_passOpen)
+	{
+		return;
+	}
+
+	frame = &m_frames[m_frameIndex % GPU_PROFILER_FRAMES];
+	m_Device->EndQuery(frame->passEndQueries[frame->markerCount]);
+	frame->markerCount++;
+
+	m_passOpen = false;
+
+	return;
+}
+
+
+int GpuProfilerClass::GetPassCount()
+{
+	return m_passCount;
+}
+
+
+const char* GpuProfilerClass::GetPassName(int pass)
+{
+	if(pass < 0 || pass >= m_passCount)
+	{
+		return 0;
+	}
+
+	return m_passes[pass].name;
+}
+
+
+float GpuProfilerClass::GetPassTime(int pass)
+{
+	if(pass < 0 || pass >= m_passCount || m_historyCount == 0)
+	{
+		return 0.0f;
+	}
+
+	return (float)(m_passes[pass].total / (double)m_historyCount);
+}
+
+
+float GpuProfilerClass::GetLastPassTime(int pass)
+{
+	if(pass < 0 || pass >= m_passCount || m_historyCount == 0)
+	{
+		return 0.0f;
+	}
+
+	return m_passes[pass].history[(m_historyIndex + GPU_PROFILER_HISTORY - 1) % GPU_PROFILER_HISTORY];
+}
+
+
+float GpuProfilerClass::GetFrameTime()
+{
+	if(m_historyCount == 0)
+	{
+		return 0.0f;
+	}
+
+	return (float)(m_frameTotal / (double)m_historyCount);
+}
+
+
+float GpuProfilerClass::GetLastFrameTime()
+{
+	if(m_historyCount == 0)
+	{
+		return 0.0f;
+	}
+
+	return m_frameHistory[(m_historyIndex + GPU_PROFILER_HISTORY - 1) % GPU_PROFILER_HISTORY];
+}
+
+
+int GpuProfilerClass::GetFrameIndex()
+{
+	return m_frameIndex;
+}
+
+
+int GpuProfilerClass::GetReadFrameIndex()
+{
+	return m_readIndex;
+}
+
+
+bool GpuProfilerClass::GetRecordedFrameTime(int frame, float& time)
+{
+	int i;
+
+
+	// Look for the frame in the rolling window, a dropped or disjoint frame was never recorded.
+	for(i=0; i<m_historyCount; i++)
+	{
+		if(m_frameIndices[i] == frame)
+		{
+			time = m_frameHistory[i];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+int GpuProfilerClass::GetCompletedFrameCount()
+{
+	return m_completedFrames;
+}
+
+
+int GpuProfilerClass::GetDroppedFrameCount()
+{
+	return m_droppedFrames;
+}
+
+
+int GpuProfilerClass::GetDisjointFrameCount()
+{
+	return m_disjointFrames;
+}
+
+
+bool GpuProfilerClass::WriteReport(const char* filename)
+{
+	ofstream fout;
+	int i;
+
+
+	fout.open(filename, ios::out);
+	if(fout.fail())
+	{
+		return false;
+	}
+
+	// Write one row for every pass and one for the whole frame, in milliseconds.
+	fout << "pass,last,average,maximum" << endl;
+
+	for(i=0; i<m_passCount; i++)
+	{
+		fout << m_passes[i].name << "," << GetLastPassTime(i) << "," << GetPassTime(i) << "," << GetMaximum(m_passes[i].history) << endl;
+	}
+
+	fout << "frame," << GetLastFrameTime() << "," << GetFrameTime() << "," << GetMaximum(m_frameHistory) << endl;
+
+	fout.close();
+
+	return !fout.fail();
+}
+
+
+int GpuProfilerClass::FindPass(const char* name)
+{
+	int i;
+
+
+	if(!name)
+	{
+		return -1;
+	}
+
+	for(i=0; i<m_passCount; i++)
+	{
+		if(strcmp(m_passes[i].name, name) == 0)
+		{
+			return i;
+		}
+	}
+
+	if(m_passCount == GPU_PROFILER_MAX_PASSES)
+	{
+		return -1;
+	}
+
+	// A new pass took no time in the frames read before it first appeared.
+	strncpy(m_passes[m_passCount].name, name, GPU_PROFILER_MAX_NAME - 1);
+	m_passes[m_passCount].name[GPU_PROFILER_MAX_NAME - 1] = 0;
+	memset(m_passes[m_passCount].history, 0, sizeof(m_passes[m_passCount].history));
+	m_passes[m_passCount].total = 0.0;
+	m_passCount++;
+
+	return m_passCount - 1;
+}
+
+
+void GpuProfilerClass::CollectFrames()
+{
+	// Read the frames in the order they were issued and stop at the first one the GPU has not finished.
+	while(m_readIndex < m_frameIndex)
+	{
+		if(!ReadFrame(m_frames[m_readIndex % GPU_PROFILER_FRAMES]))
+		{
+			break;
+		}
+
+		m_readIndex++;
+	}
+
+	return;
+}
+
+
+bool GpuProfilerClass::ReadFrame(FrameType& frame)
+{
+	float passTimes[GPU_PROFILER_MAX_PASSES];
+	unsigned long long frequency, frameBegin, frameEnd, begin, end;
+	float frameTime;
+	int i;
+
+
+	if(!m_Device->GetQueryData(frame.disjointQuery, frequency))
+	{
+		return false;
+	}
+
+	if(!m_Device->GetQueryData(frame.beginQuery, frameBegin) || !m_Device->GetQueryData(frame.endQuery, frameEnd))
+	{
+		return false;
+	}
+
+	// Add up the time of every pass, a pass can be drawn more than once in a frame.
+	memset(passTimes, 0, sizeof(passTimes));
+
+	for(i=0; i<frame.markerCount; i++)
+	{
+		if(!m_Device->GetQueryData(frame.passBeginQueries[i], begin) || !m_Device->GetQueryData(frame.passEndQueries[i], end))
+		{
+			return false;
+		}
+
+		if(frequency && end > begin)
+		{
+			passTimes[frame.passes[i]] += (float)((double)(end - begin) * 1000.0 / (double)frequency);
+		}
+	}
+
+	// The frame is finished but its timestamps are worthless when the clock changed frequency in the middle of it.
+	if(frequency == 0)
+	{
+		m_disjointFrames++;
+		return true;
+	}
+
+	frameTime = (frameEnd > frameBegin) ? (float)((double)(frameEnd - frameBegin) * 1000.0 / (double)frequency) : 0.0f;
+
+	// Replace the oldest sample of the rolling window with this frame.
+	for(i=0; i<m_passCount; i++)
+	{
+		m_passes[i].total += passTimes[i] - m_passes[i].history[m_historyIndex];
+		m_passes[i].history[m_historyIndex] = passTimes[i];
+	}
+
+	m_frameTotal += frameTime - m_frameHistory[m_historyIndex];
+	m_frameHistory[m_historyIndex] = frameTime;
+	m_frameIndices[m_historyIndex] = m_readIndex;
+
+	m_historyIndex = (m_historyIndex + 1) % GPU_PROFILER_HISTORY;
+	if(m_historyCount < GPU_PROFILER_HISTORY)
+	{
+		m_historyCount++;
+	}
+
+	m_completedFrames++;
+
+	return true;
+}
+
+
+float GpuProfilerClass::GetMaximum(const float* history)
+{
+	float maximum;
+	int i;
+
+
+	maximum = 0.0f;
+	for(i=0; i<m_historyCount; i++)
+	{
+		if(history[i] > maximum)
+		{
+			maximum = history[i];
+		}
+	}
+
+	return maximum;
+}
\ No newline at end of file
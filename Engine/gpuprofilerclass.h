@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: gpuprofilerclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _GPUPROFILERCLASS_H_
+#define _GPUPROFILERCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <string.h>
+#include <fstream>
+using namespace std;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int GPU_PROFILER_FRAMES = 4;
+const int GPU_PROFILER_MAX_PASSES = 16;
+const int GPU_PROFILER_MAX_NAME = 32;
+const int GPU_PROFILER_HISTORY = 64;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: GpuProfilerClass
+//
+// Measures how long the GPU spends on every pass of a frame with timestamp queries.  Each frame in flight has its own
+// set of queries in a ring, and a frame is only read back once the device says all its results are there, so reading
+// never waits on the GPU.  When the ring fills up before the oldest frame is ready that frame is dropped instead.  The
+// pass times are averaged over the last frames read, a pass that was not drawn in a frame counts as taking no time.
+////////////////////////////////////////////////////////////////////////////////
+class GpuProfilerClass
+{
+private:
+	struct PassType
+	{
+		char name[GPU_PROFILER_MAX_NAME];
+		float history[GPU_PROFILER_HISTORY];
+		double total;
+	};
+
+	// The queries of one frame of the ring and the pass each pair of markers belongs to.
+	struct FrameType
+	{
+		int disjointQuery;
+		int beginQuery, endQuery;
+		int passBeginQueries[GPU_PROFILER_MAX_PASSES];
+		int passEndQueries[GPU_PROFILER_MAX_PASSES];
+		int passes[GPU_PROFILER_MAX_PASSES];
+		int markerCount;
+	};
+
+public:
+	GpuProfilerClass();
+	GpuProfilerClass(const GpuProfilerClass&);
+	~GpuProfilerClass();
+
+	bool Initialize(RenderDeviceClass*);
+	void Shutdown();
+
+	void BeginFrame();
+	void EndFrame();
+	void BeginPass(const char*);
+	void EndPass();
+
+	int GetPassCount();
+	const char* GetPassName(int);
+	float GetPassTime(int);
+	float GetLastPassTime(int);
+	float GetFrameTime();
+	float GetLastFrameTime();
+
+	int GetFrameIndex();
+	int GetReadFrameIndex();
+	bool GetRecordedFrameTime(int, float&);
+
+	int GetCompletedFrameCount();
+	int GetDroppedFrameCount();
+	int GetDisjointFrameCount();
+
+	bool WriteReport(const char*);
+
+private:
+	int FindPass(const char*);
+	void CollectFrames();
+	bool ReadFrame(FrameType&);
+	float GetMaximum(const float*);
+
+private:
+	RenderDeviceClass* m_Device;
+	FrameType m_frames[GPU_PROFILER_FRAMES];
+	int m_frameIndex, m_readIndex;
+	bool m_frameOpen, m_passOpen;
+
+	PassType m_passes[GPU_PROFILER_MAX_PASSES];
+	int m_passCount;
+	float m_frameHistory[GPU_PROFILER_HISTORY];
+	int m_frameIndices[GPU_PROFILER_HISTORY];
+	double m_frameTotal;
+	int m_historyIndex, m_historyCount;
+
+	int m_completedFrames, m_droppedFrames, m_disjointFrames;
+};
+
+#endif
\ No newline at end of file
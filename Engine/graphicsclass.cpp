@@ -2,25 +2,57 @@
 // Filename: graphicsclass.cpp
 ////////////////////////////////////////////////////////////////////////////////
 #include "graphicsclass.h"
-#include "directxmath.h"
+
+#include <algorithm>
+#include <functional>
 
 
 GraphicsClass::GraphicsClass()
 {
-	m_Input = 0;
+#ifdef _WIN32
 	m_D3D = 0;
+#endif
+	m_NullDevice = 0;
+	m_SoftwareDevice = 0;
+	m_Device = 0;
 	m_Timer = 0;
+	m_FrameStats = 0;
+	m_WorkerPool = 0;
 	m_ShaderManager = 0;
 	m_Light = 0;
 	m_Position = 0;
 	m_Camera = 0;
-	m_TerrainModel = 0;
-	m_AirplaneModel = 0;
-	m_ControlTower = 0;
-	m_AirfieldModel = 0;
-	m_Drone = 0;
-	m_BigBuilding = 0;
-	m_PredatorModel = 0;
+	m_Scene = 0;
+	m_Models = 0;
+	m_SkyTexture = 0;
+	m_Terrain = 0;
+	m_TerrainTexture = 0;
+	m_Swarm = 0;
+	m_swarmPrefab = -1;
+	m_Transforms = 0;
+	m_Entities = 0;
+	m_Clusters = 0;
+	m_DeferredBuffers = 0;
+	m_Shadows = 0;
+	m_DynamicResolution = 0;
+	m_GpuProfiler = 0;
+	m_Benchmark = 0;
+	m_Latency = 0;
+	m_InputLog = 0;
+	m_rotation = 0.0f;
+	m_simulationTime = 0.0f;
+	m_interpolation = 0.0f;
+	m_pendingKeys = 0;
+	m_deferredShading = false;
+	m_dynamicResolution = false;
+	m_screenWidth = 0;
+	m_screenHeight = 0;
+	m_renderItems = 0;
+	m_renderItemCount = 0;
+	m_benchmarkFilename[0] = 0;
+	m_benchmarkSummaryFilename[0] = 0;
+
+	SetSceneFiles(SCENE_FILENAME, SKY_TEXTURE_FILENAME);
 }
 
 
@@ -34,40 +66,130 @@ GraphicsClass::~GraphicsClass()
 }
 
 
-bool GraphicsClass::Initialize(HINSTANCE hinstance, HWND hwnd, int screenWidth, int screenHeight)
+#ifdef _WIN32
+bool GraphicsClass::Initialize(HWND hwnd, int screenWidth, int screenHeight)
 {
 	bool result;
 
-	// Create the input object.  The input object will be used to handle reading the keyboard and mouse input from the user.
-	m_Input = new InputClass;
-	if (!m_Input)
+	// Create the Direct3D object.
+	m_D3D = new D3DClass;
+	if(!m_D3D)
 	{
 		return false;
 	}
 
-	// Initialize the input object.
-	result = m_Input->Initialize(hinstance, hwnd, screenWidth, screenHeight);
-	if (!result)
+	// Initialize the Direct3D object.
+	result = m_D3D->Initialize(screenWidth, screenHeight, VSYNC_ENABLED, hwnd, FULL_SCREEN, SCREEN_DEPTH, SCREEN_NEAR, REVERSE_DEPTH_ENABLED);
+	if(!result)
 	{
-		MessageBox(hwnd, L"Could not initialize the input object.", L"Error", MB_OK);
+		ShowError(hwnd, L"Could not initialize Direct3D.");
 		return false;
 	}
 
-	// Create the Direct3D object.
-	m_D3D = new D3DClass;
-	if(!m_D3D)
+	// Everything past this point only talks to the renderer through the device interface.
+	m_Device = m_D3D;
+
+	// Create the rest of the renderer on top of the device.
+	result = InitializeRenderer(hwnd, screenWidth, screenHeight);
+	if(!result)
 	{
 		return false;
 	}
 
-	// Initialize the Direct3D object.
-	result = m_D3D->Initialize(screenWidth, screenHeight, VSYNC_ENABLED, hwnd, FULL_SCREEN, SCREEN_DEPTH, SCREEN_NEAR);
+	return true;
+}
+#endif
+
+
+bool GraphicsClass::InitializeHeadless(int screenWidth, int screenHeight)
+{
+	bool result;
+
+
+	// Create the null device object.  It records what the renderer does instead of drawing, so there is no window,
+	// no input object and no GPU needed.
+	m_NullDevice = new NullDeviceClass;
+	if(!m_NullDevice)
+	{
+		return false;
+	}
+
+	// Initialize the null device object.
+	result = m_NullDevice->Initialize(screenWidth, screenHeight, SCREEN_DEPTH, SCREEN_NEAR, REVERSE_DEPTH_ENABLED);
+	if(!result)
+	{
+		return false;
+	}
+
+	m_Device = m_NullDevice;
+
+	// Create the rest of the renderer on top of the device.
+	result = InitializeRenderer(NULL, screenWidth, screenHeight);
+	if(!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+bool GraphicsClass::InitializeSoftware(int screenWidth, int screenHeight, int threadCount)
+{
+	bool result;
+
+
+	// Create the software device object.  It draws the frames on the CPU into its own framebuffer, so like the null
+	// device there is no window, no input object and no GPU needed.
+	m_SoftwareDevice = new SoftwareDeviceClass;
+	if(!m_SoftwareDevice)
+	{
+		return false;
+	}
+
+	// Initialize the software device object, a thread count of 0 uses every core.
+	result = m_SoftwareDevice->Initialize(screenWidth, screenHeight, SCREEN_DEPTH, SCREEN_NEAR, threadCount, REVERSE_DEPTH_ENABLED);
 	if(!result)
 	{
-		MessageBox(hwnd, L"Could not initialize Direct3D.", L"Error", MB_OK);
 		return false;
 	}
 
+	m_Device = m_SoftwareDevice;
+
+	// Create the rest of the renderer on top of the device.
+	result = InitializeRenderer(NULL, screenWidth, screenHeight);
+	if(!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void GraphicsClass::SetSceneFiles(const char* sceneFilename, const wchar_t* skyTextureFilename)
+{
+	// Pick the scene file and the sky texture the next initialize loads, the defaults are the ones the game ships with.
+	strncpy(m_sceneFilename, sceneFilename, SCENE_MAX_PATH - 1);
+	m_sceneFilename[SCENE_MAX_PATH - 1] = 0;
+
+	wcsncpy(m_skyTextureFilename, skyTextureFilename, SCENE_MAX_PATH - 1);
+	m_skyTextureFilename[SCENE_MAX_PATH - 1] = 0;
+
+	return;
+}
+
+
+bool GraphicsClass::InitializeRenderer(HWND hwnd, int screenWidth, int screenHeight)
+{
+	CpuZoneClass zone("InitializeRenderer");
+	bool result;
+
+
+	// Store the screen size, the G-buffer is created to match it.
+	m_screenWidth = screenWidth;
+	m_screenHeight = screenHeight;
+
 	// Create the shader manager object.
 	m_ShaderManager = new ShaderManagerClass;
 	if(!m_ShaderManager)
@@ -76,10 +198,10 @@ bool GraphicsClass::Initialize(HINSTANCE hinstance, HWND hwnd, int screenWidth,
 	}
 
 	// Initialize the shader manager object.
-	result = m_ShaderManager->Initialize(m_D3D->GetDevice(), hwnd);
+	result = m_ShaderManager->Initialize(m_Device);
 	if(!result)
 	{
-		MessageBox(hwnd, L"Could not initialize the shader manager object.", L"Error", MB_OK);
+		ShowError(hwnd, L"Could not initialize the shader manager object.");
 		return false;
 	}
 
@@ -94,7 +216,36 @@ bool GraphicsClass::Initialize(HINSTANCE hinstance, HWND hwnd, int screenWidth,
 	result = m_Timer->Initialize();
 	if (!result)
 	{
-		MessageBox(hwnd, L"Could not initialize the timer object.", L"Error", MB_OK);
+		ShowError(hwnd, L"Could not initialize the timer object.");
+		return false;
+	}
+
+	// Create the frame statistics object.
+	m_FrameStats = new FrameStatsClass;
+	if(!m_FrameStats)
+	{
+		return false;
+	}
+
+	// Initialize the frame statistics object with a window of frames and the 60 Hz budget.
+	result = m_FrameStats->Initialize(FRAME_STATS_HISTORY, FRAME_STATS_BUDGET);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Create the worker pool object.
+	m_WorkerPool = new WorkerPoolClass;
+	if(!m_WorkerPool)
+	{
+		return false;
+	}
+
+	// Initialize the worker pool object with one thread for every core, the swarm, the entity systems and the light
+	// binning all split their work across it.
+	result = m_WorkerPool->Initialize((int)thread::hardware_concurrency());
+	if(!result)
+	{
 		return false;
 	}
 
@@ -130,183 +281,176 @@ bool GraphicsClass::Initialize(HINSTANCE hinstance, HWND hwnd, int screenWidth,
 	m_Light->SetSpecularColor(1.0f, 1.0f, 1.0f, 1.0f);
 	m_Light->SetSpecularPower(64.0f);
 
-	// Create and Initialize the Terrain model.
-	m_TerrainModel = new ModelClass;
-	if(!m_TerrainModel)
-	{
-		return false;
-	}
-
-	result = m_TerrainModel->Initialize(m_D3D->GetDevice(), "../Engine/data/terrainModel.txt", L"../Engine/data/lol.dds");
+	// Load the scene description and create one model for each prefab in it.
+	result = InitializeScene(hwnd, m_sceneFilename);
 	if(!result)
-	{
-		MessageBox(hwnd, L"Could not initialize the Terrain model.", L"Error", MB_OK);
-		return false;
-	}
-
-	// Create and Initialize the Sky-Domes model.
-	m_SkyDomes = new ModelClass;
-	if (!m_SkyDomes)
 	{
 		return false;
 	}
 
-	result = m_SkyDomes->Initialize(m_D3D->GetDevice(), "../Engine/data/skyDome.txt", L"../Engine/data/skyTexture.dds");
-	if (!result)
-	{
-		MessageBox(hwnd, L"Could not initialize the Sky-Domes model.", L"Error", MB_OK);
-		return false;
-	}
-
-	// Create and Initialize the Airplane Model.
-	m_AirplaneModel = new ModelClass;
-	if(!m_AirplaneModel)
+	// Create the light cluster object.
+	m_Clusters = new ClusterClass;
+	if(!m_Clusters)
 	{
 		return false;
 	}
 
-	result = m_AirplaneModel->Initialize(m_D3D->GetDevice(), "../Engine/data/tal16.txt", L"../Engine/data/tal512.dds");
+	// Initialize the light cluster object, the binning is split across the worker pool.
+	result = m_Clusters->Initialize(m_Device, screenWidth, screenHeight, SCREEN_DEPTH, m_WorkerPool);
 	if(!result)
 	{
-		MessageBox(hwnd, L"Could not initialize the Tal 16 model.", L"Error", MB_OK);
+		ShowError(hwnd, L"Could not initialize the light cluster object.");
 		return false;
 	}
 
-	// Create and Initialize the Control Tower model.
-	m_ControlTower = new ModelClass;
-	if(!m_ControlTower)
+	// Hand the point lights of the scene to the clusters.
+	result = InitializePointLights();
+	if(!result)
 	{
+		ShowError(hwnd, L"Too many point lights in the scene.");
 		return false;
 	}
 
-	result = m_ControlTower->Initialize(m_D3D->GetDevice(), "../Engine/data/controlTower.txt", L"../Engine/data/controlTowerTexture.dds");
-	if (!result)
+	// Create the shadow object.
+	m_Shadows = new ShadowClass;
+	if(!m_Shadows)
 	{
-		MessageBox(hwnd, L"Could not initialize the Control Tower model.", L"Error", MB_OK);
 		return false;
 	}
 
-	// Create and Initialize the Airfield model.
-	m_AirfieldModel = new ModelClass;
-	if (!m_AirfieldModel)
+	// Initialize the shadow object with the cascades of the directional light.
+	result = m_Shadows->Initialize(m_Device, SHADOW_MAP_SIZE, SHADOW_DISTANCE, SCREEN_NEAR);
+	if(!result)
 	{
+		ShowError(hwnd, L"Could not initialize the shadow object.");
 		return false;
 	}
 
-	result = m_AirfieldModel->Initialize(m_D3D->GetDevice(), "../Engine/data/airfieldModel.txt", L"../Engine/data/airfieldTexture.dds");
-	if (!result)
+	// Create the GPU profiler object.
+	m_GpuProfiler = new GpuProfilerClass;
+	if(!m_GpuProfiler)
 	{
-		MessageBox(hwnd, L"Could not initialize the Airfield model.", L"Error", MB_OK);
 		return false;
 	}
 
-	// Create and Inizialize the Big Building model.
-	m_BigBuilding = new ModelClass;
-	if (!m_BigBuilding)
+	// Initialize the GPU profiler object with its ring of timestamp queries.
+	result = m_GpuProfiler->Initialize(m_Device);
+	if(!result)
 	{
+		ShowError(hwnd, L"Could not initialize the GPU profiler object.");
 		return false;
 	}
 
-	result = m_BigBuilding->Initialize(m_D3D->GetDevice(), "../Engine/data/bigBuilding.txt", L"../Engine/data/bigBuildingTextures.dds");
-	if (!result)
+	// Create the benchmark object, it only takes over the camera once a benchmark is started.
+	m_Benchmark = new BenchmarkClass;
+	if(!m_Benchmark)
 	{
-		MessageBox(hwnd, L"Could not initialize the Big Building model.", L"Error", MB_OK);
 		return false;
 	}
 
-	// Create and Inizialize the Drone model.
-	m_Drone = new ModelClass;
-	if (!m_Drone)
+	// Initialize the benchmark object with the profiler it takes the GPU times from.
+	result = m_Benchmark->Initialize(m_GpuProfiler);
+	if(!result)
 	{
 		return false;
 	}
 
-	result = m_Drone->Initialize(m_D3D->GetDevice(), "../Engine/data/smallDrone.txt", L"../Engine/data/smallDroneTexture.dds");
-	if (!result)
+	// Pick forward or deferred shading for the lit objects.
+	result = SetDeferredShading(DEFERRED_SHADING_ENABLED);
+	if(!result)
 	{
-		MessageBox(hwnd, L"Could not initialize the Drone model.", L"Error", MB_OK);
+		ShowError(hwnd, L"Could not initialize the deferred buffers object.");
 		return false;
 	}
 
-	// Create and Inizialize the Predator model.
-	m_PredatorModel = new ModelClass;
-	if (!m_PredatorModel)
+	// Draw the scene at a resolution that follows the GPU frame time, or straight into the back buffer.
+	result = SetDynamicResolution(DYNAMIC_RESOLUTION_ENABLED);
+	if(!result)
 	{
+		ShowError(hwnd, L"Could not initialize the dynamic resolution object.");
 		return false;
 	}
 
-	result = m_PredatorModel->Initialize(m_D3D->GetDevice(), "../Engine/data/predator.txt", L"../Engine/data/predatorTexture.dds");
-	if (!result)
-	{
-		MessageBox(hwnd, L"Could not initialize the Predator model.", L"Error", MB_OK);
-		return false;
-	}
+	// Start the simulation from the loaded scene.
+	ResetSimulation();
 
+	// Restart the timer so the first frame does not include the loading.
+	m_Timer->Frame();
 
 	return true;
-
 }
 
 
 void GraphicsClass::Shutdown()
 {
-	// Release the model objects.
-	if(m_TerrainModel)
+	// Close the input log and release the input log object.
+	if(m_InputLog)
 	{
-		m_TerrainModel->Shutdown();
-		delete m_TerrainModel;
-		m_TerrainModel = 0;
+		m_InputLog->Shutdown();
+		delete m_InputLog;
+		m_InputLog = 0;
 	}
 
-	if (m_SkyDomes)
+	// Close the latency file and release the latency object.
+	if(m_Latency)
 	{
-		m_SkyDomes->Shutdown();
-		delete m_SkyDomes;
-		m_SkyDomes = 0;
+		m_Latency->Shutdown();
+		delete m_Latency;
+		m_Latency = 0;
 	}
 
-	if(m_AirplaneModel)
+	// Release the benchmark object.
+	if(m_Benchmark)
 	{
-		m_AirplaneModel->Shutdown();
-		delete m_AirplaneModel;
-		m_AirplaneModel = 0;
+		m_Benchmark->Shutdown();
+		delete m_Benchmark;
+		m_Benchmark = 0;
 	}
 
-	if(m_ControlTower)
+	// Write out the pass timings and release the GPU profiler object.
+	if(m_GpuProfiler)
 	{
-		m_ControlTower->Shutdown();
-		delete m_ControlTower;
-		m_ControlTower = 0;
+		m_GpuProfiler->WriteReport(GPU_PROFILE_FILENAME);
+		m_GpuProfiler->Shutdown();
+		delete m_GpuProfiler;
+		m_GpuProfiler = 0;
 	}
 
-	if (m_AirfieldModel)
+	// Release the shadow object.
+	if(m_Shadows)
 	{
-		m_AirfieldModel->Shutdown();
-		delete m_AirfieldModel;
-		m_AirfieldModel = 0;
+		m_Shadows->Shutdown();
+		delete m_Shadows;
+		m_Shadows = 0;
 	}
 
-	if (m_BigBuilding)
+	// Release the dynamic resolution object.
+	if(m_DynamicResolution)
 	{
-		m_BigBuilding->Shutdown();
-		delete m_BigBuilding;
-		m_BigBuilding = 0;
+		m_DynamicResolution->Shutdown();
+		delete m_DynamicResolution;
+		m_DynamicResolution = 0;
 	}
 
-	if (m_Drone)
+	// Release the deferred buffers object.
+	if(m_DeferredBuffers)
 	{
-		m_Drone->Shutdown();
-		delete m_Drone;
-		m_Drone = 0;
+		m_DeferredBuffers->Shutdown();
+		delete m_DeferredBuffers;
+		m_DeferredBuffers = 0;
 	}
 
-	if (m_PredatorModel)
+	// Release the light cluster object.
+	if(m_Clusters)
 	{
-		m_PredatorModel->Shutdown();
-		delete m_PredatorModel;
-		m_PredatorModel = 0;
+		m_Clusters->Shutdown();
+		delete m_Clusters;
+		m_Clusters = 0;
 	}
 
+	// Release the scene models and instances.
+	ShutdownScene();
+
 	// Release the light object.
 	if(m_Light)
 	{
@@ -336,6 +480,22 @@ void GraphicsClass::Shutdown()
 		m_ShaderManager = 0;
 	}
 
+	// Release the frame statistics object.
+	if(m_FrameStats)
+	{
+		m_FrameStats->Shutdown();
+		delete m_FrameStats;
+		m_FrameStats = 0;
+	}
+
+	// Release the worker pool object.
+	if(m_WorkerPool)
+	{
+		m_WorkerPool->Shutdown();
+		delete m_WorkerPool;
+		m_WorkerPool = 0;
+	}
+
 	// Release the timer object.
 	if (m_Timer)
 	{
@@ -343,6 +503,7 @@ void GraphicsClass::Shutdown()
 		m_Timer = 0;
 	}
 
+#ifdef _WIN32
 	// Release the D3D object.
 	if(m_D3D)
 	{
@@ -350,283 +511,1593 @@ void GraphicsClass::Shutdown()
 		delete m_D3D;
 		m_D3D = 0;
 	}
+#endif
 
-	// Release the input object.
-	if (m_Input)
+	// Release the null device object.
+	if(m_NullDevice)
 	{
-		m_Input->Shutdown();
-		delete m_Input;
-		m_Input = 0;
+		m_NullDevice->Shutdown();
+		delete m_NullDevice;
+		m_NullDevice = 0;
 	}
 
+	// Release the software device object.
+	if(m_SoftwareDevice)
+	{
+		m_SoftwareDevice->Shutdown();
+		delete m_SoftwareDevice;
+		m_SoftwareDevice = 0;
+	}
+
+	m_Device = 0;
+
 	return;
 }
 
 
-bool GraphicsClass::Frame()
+bool GraphicsClass::InitializeScene(HWND hwnd, const char* sceneFilename)
 {
+	SceneClass::PrefabType* prefab;
+	wchar_t textureFilename[SCENE_MAX_PATH];
 	bool result;
+	int i;
 
-	// Update the system stats.
-	m_Timer->Frame();
 
-	// Read the user input.
-	result = m_Input->Frame();
-	if (!result)
+	// Create the scene object.
+	m_Scene = new SceneClass;
+	if(!m_Scene)
 	{
 		return false;
 	}
 
-	// Check if the user pressed escape and wants to exit the application.
-	if (m_Input->IsEscapePressed() == true)
+	// Load the prefabs and instances from the scene file.
+	result = m_Scene->Initialize(sceneFilename);
+	if(!result)
 	{
+		ShowError(hwnd, L"Could not load the scene file.");
 		return false;
 	}
 
-	// Do the frame input processing.
-	result = HandleMovementInput(m_Timer->GetTime());
-	if (!result)
+	// Create the list of models, one for each prefab.
+	m_Models = new ModelClass*[m_Scene->GetPrefabCount()];
+	if(!m_Models)
 	{
 		return false;
 	}
 
-	// Render the graphics.
-	result = Render();
-	if (!result)
+	for(i=0; i<m_Scene->GetPrefabCount(); i++)
 	{
-		return false;
+		m_Models[i] = 0;
 	}
 
-	return true;
-}
-
-bool GraphicsClass::HandleMovementInput(float frameTime)
-{
-	bool keyDown;
-	float posX, posY, posZ, rotX, rotY, rotZ;
-
-	// Set the frame time for calculating the updated position.
-	m_Position->SetFrameTime(frameTime);
-
-	// Handle the input.
-	keyDown = m_Input->IsAPressed();
-	m_Position->TurnLeft(keyDown);
-
-	keyDown = m_Input->IsDPressed();
-	m_Position->TurnRight(keyDown);
+	// Create and initialize the model of each prefab.
+	for(i=0; i<m_Scene->GetPrefabCount(); i++)
+	{
+		prefab = m_Scene->GetPrefab(i);
+
+		m_Models[i] = new ModelClass;
+		if(!m_Models[i])
+		{
+			return false;
+		}
+
+		// The texture loader takes a wide character filename.
+		mbstowcs(textureFilename, prefab->textureFilename, SCENE_MAX_PATH - 1);
+		textureFilename[SCENE_MAX_PATH - 1] = 0;
+
+		result = m_Models[i]->Initialize(m_Device, prefab->modelFilename, textureFilename);
+		if(!result)
+		{
+			ShowError(hwnd, L"Could not initialize a scene model.");
+			return false;
+		}
+	}
 
-	keyDown = m_Input->IsWPressed();
-	m_Position->MoveForward(keyDown);
+	// Create the sky texture, the sky is drawn around the viewer without a mesh.
+	m_SkyTexture = new TextureClass;
+	if(!m_SkyTexture)
+	{
+		return false;
+	}
 
-	keyDown = m_Input->IsSPressed();
-	m_Position->MoveBackward(keyDown);
+	result = m_SkyTexture->Initialize(m_Device, m_skyTextureFilename);
+	if(!result)
+	{
+		ShowError(hwnd, L"Could not load the sky texture.");
+		return false;
+	}
 
-	keyDown = m_Input->IsIPressed();
-	m_Position->MoveUpward(keyDown);
+	// Create the terrain, its height field is generated from the seed and drawn in chunks picked by the view.
+	m_Terrain = new TerrainClass;
+	if(!m_Terrain)
+	{
+		return false;
+	}
 
-	keyDown = m_Input->IsKPressed();
-	m_Position->MoveDownward(keyDown);
+	result = m_Terrain->Initialize(m_Device, TERRAIN_SEED);
+	if(!result)
+	{
+		ShowError(hwnd, L"Could not initialize the terrain.");
+		return false;
+	}
 
-	keyDown = m_Input->IsLPressed();
-	m_Position->LookDownward(keyDown);
+	m_TerrainTexture = new TextureClass;
+	if(!m_TerrainTexture)
+	{
+		return false;
+	}
 
-	keyDown = m_Input->IsJPressed();
-	m_Position->LookUpward(keyDown);
+	result = m_TerrainTexture->Initialize(m_Device, TERRAIN_TEXTURE_FILENAME);
+	if(!result)
+	{
+		ShowError(hwnd, L"Could not load the terrain texture.");
+		return false;
+	}
 
-	keyDown = m_Input->IsF1Pressed();
-	m_Position->Camera1(keyDown);
+	// Create the drone swarm, it flies over the terrain and is drawn with the model of its prefab.
+	m_swarmPrefab = m_Scene->FindPrefab(SWARM_PREFAB_NAME);
+	if(m_swarmPrefab < 0)
+	{
+		return false;
+	}
 
-	keyDown = m_Input->IsF2Pressed();
-	m_Position->Camera2(keyDown);
+	m_Swarm = new SwarmClass;
+	if(!m_Swarm)
+	{
+		return false;
+	}
 
-	keyDown = m_Input->IsF3Pressed();
-	m_Position->Camera0(keyDown);
+	result = m_Swarm->Initialize(m_Device, m_Terrain, SWARM_DRONE_COUNT, m_WorkerPool, SWARM_SEED);
+	if(!result)
+	{
+		ShowError(hwnd, L"Could not initialize the drone swarm.");
+		return false;
+	}
 
-	// Get the view point position/rotation.
-	m_Position->GetPosition(posX, posY, posZ);
-	m_Position->GetRotation(rotX, rotY, rotZ);
+	// Create an entity with a transform node for every instance.
+	result = InitializeEntities();
+	if(!result)
+	{
+		return false;
+	}
 
-	// Set the position of the camera.
-	m_Camera->SetPosition(posX, posY, posZ);
-	m_Camera->SetRotation(rotX, rotY, rotZ);
+	// Create the per frame render list, there is at most one entry for each instance.
+	m_renderItems = new RenderItemType[m_Scene->GetInstanceCount()];
+	if(!m_renderItems)
+	{
+		return false;
+	}
 
 	return true;
 }
 
-bool GraphicsClass::Render()
-{
-	XMMATRIX worldMatrix, viewMatrix, projectionMatrix, translateMatrix, scalingMatrix, orbitMatrix;
-	XMFLOAT3 cameraPosition;
-	
-	bool result;
-	
-	static float rotation = 0.0f;
-
-	// Update the rotation variable each frame.
-	rotation += (float)XM_PI * 0.0005f * m_Timer->GetTime();
-
-	// Clear the buffers to begin the scene.
-	m_D3D->BeginScene(0.0f, 0.0f, 0.0f, 1.0f);
 
-	// Generate the view matrix based on the camera's position.
-	m_Camera->Render();
+void GraphicsClass::ShutdownScene()
+{
+	int i;
 
-	// Get the world, view, and projection matrices from the camera and d3d objects.
-	m_D3D->GetWorldMatrix(worldMatrix);
-	m_Camera->GetViewMatrix(viewMatrix);
-	m_D3D->GetProjectionMatrix(projectionMatrix);
 
-	// Get the position of the camera
-	cameraPosition = m_Camera->GetPosition();
-	
-
-	// Setup the rotation and translation of the Sky-Domes model.
-	worldMatrix = XMMatrixScaling(100.f, 100.f, 100.f);
-	
-	// Render the Sky-Domes model using the texture shader.
-	m_SkyDomes->Render(m_D3D->GetDeviceContext());
-	result = m_ShaderManager->RenderTextureShader(m_D3D->GetDeviceContext(), m_SkyDomes->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix,
-												m_SkyDomes->GetTexture());
-	if (!result)
+	// Release the render list.
+	if(m_renderItems)
 	{
-		return false;
+		delete [] m_renderItems;
+		m_renderItems = 0;
 	}
 
-
-	// Setup the rotation and translation of the Terrain model.
-	translateMatrix = XMMatrixTranslation(0.0f, 0.0f, 0.0f);
-	worldMatrix = XMMatrixMultiply(worldMatrix, translateMatrix);
-
-	// Render the Terrain model using the texture shader.
-	m_TerrainModel->Render(m_D3D->GetDeviceContext());
-	result = m_ShaderManager->RenderTextureShader(m_D3D->GetDeviceContext(), m_TerrainModel->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, 
-												  m_TerrainModel->GetTexture());
-	if(!result)
+	// Release the transform hierarchy.
+	if(m_Transforms)
 	{
-		return false;
+		m_Transforms->Shutdown();
+		delete m_Transforms;
+		m_Transforms = 0;
 	}
 
+	// Release the entities.
+	if(m_Entities)
+	{
+		m_Entities->Shutdown();
+		delete m_Entities;
+		m_Entities = 0;
+	}
 
-	// Setup the rotation, translation and movement of the Airplane model.
-	m_D3D->GetWorldMatrix(worldMatrix);
-
-	orbitMatrix = XMMatrixRotationY(rotation * 0.5); // moltiply or divide for an x value for decrease or increase the speed of the orbit
+	// Release the drone swarm.
+	if(m_Swarm)
+	{
+		m_Swarm->Shutdown();
+		delete m_Swarm;
+		m_Swarm = 0;
+	}
 
-	translateMatrix = XMMatrixTranslation(500.0f, 500.0f, 0.0f);
-	
-	worldMatrix = XMMatrixMultiply(worldMatrix, translateMatrix);
-	worldMatrix = XMMatrixMultiply(worldMatrix, orbitMatrix);
-		
-	// Render the Delta 747 using the light shader.
-	m_AirplaneModel->Render(m_D3D->GetDeviceContext());
-	result = m_ShaderManager->RenderLightShader(m_D3D->GetDeviceContext(), m_AirplaneModel->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, 
-									   m_AirplaneModel->GetTexture(), m_Light->GetDirection(), m_Light->GetAmbientColor(), m_Light->GetDiffuseColor(), 
-									   m_Camera->GetPosition(), m_Light->GetSpecularColor(), m_Light->GetSpecularPower());
-	if(!result)
+	// Release the terrain.
+	if(m_TerrainTexture)
 	{
-		return false;
+		m_TerrainTexture->Shutdown();
+		delete m_TerrainTexture;
+		m_TerrainTexture = 0;
 	}
-	
 
-	// Setup the rotation and translation of the Control Tower model.
-	m_D3D->GetWorldMatrix(worldMatrix);
+	if(m_Terrain)
+	{
+		m_Terrain->Shutdown();
+		delete m_Terrain;
+		m_Terrain = 0;
+	}
 
-	translateMatrix = XMMatrixTranslation(-100.0f, 0.0f, 50.0f);
-	
-	worldMatrix = XMMatrixScaling(4.f, 4.f, 4.f);
-	worldMatrix = XMMatrixMultiply(worldMatrix, translateMatrix);
+	// Release the sky texture.
+	if(m_SkyTexture)
+	{
+		m_SkyTexture->Shutdown();
+		delete m_SkyTexture;
+		m_SkyTexture = 0;
+	}
 
-	// Render the Control Tower model.
-	m_ControlTower->Render(m_D3D->GetDeviceContext());
-	result = m_ShaderManager->RenderLightShader(m_D3D->GetDeviceContext(), m_ControlTower->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix,
-										m_ControlTower->GetTexture(), m_Light->GetDirection(), m_Light->GetAmbientColor(), m_Light->GetDiffuseColor(),
-										m_Camera->GetPosition(), m_Light->GetSpecularColor(), m_Light->GetSpecularPower());
-	if(!result)
+	// Release the prefab models.
+	if(m_Models)
 	{
-		return false;
+		for(i=0; i<m_Scene->GetPrefabCount(); i++)
+		{
+			if(m_Models[i])
+			{
+				m_Models[i]->Shutdown();
+				delete m_Models[i];
+				m_Models[i] = 0;
+			}
+		}
+
+		delete [] m_Models;
+		m_Models = 0;
 	}
 
+	// Release the scene object.
+	if(m_Scene)
+	{
+		m_Scene->Shutdown();
+		delete m_Scene;
+		m_Scene = 0;
+	}
 
-	// Setup the rotation and translation of the Airfield model.
-	m_D3D->GetWorldMatrix(worldMatrix);
+	return;
+}
 
-	translateMatrix = XMMatrixTranslation(-3.0f, 1.f, 0.0f);
-	worldMatrix = XMMatrixMultiply(worldMatrix, translateMatrix);
 
-	// Render the Airfield model.
-	m_AirfieldModel->Render(m_D3D->GetDeviceContext());
-	result = m_ShaderManager->RenderLightShader(m_D3D->GetDeviceContext(), m_AirfieldModel->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix,
-										m_AirfieldModel->GetTexture(), m_Light->GetDirection(), m_Light->GetAmbientColor(), m_Light->GetDiffuseColor(),
-										m_Camera->GetPosition(), m_Light->GetSpecularColor(), m_Light->GetSpecularPower());
-	if (!result)
+void GraphicsClass::ShowError(HWND hwnd, const wchar_t* message)
+{
+	// Only the windowed renderer has a window to show the message over, the others just fail.
+#ifdef _WIN32
+	if(hwnd)
 	{
-		return false;
+		MessageBox(hwnd, message, L"Error", MB_OK);
 	}
+#endif
 
+	return;
+}
 
-	// Setup the rotation and translation of the Big Building model.
-	m_D3D->GetWorldMatrix(worldMatrix);
 
-	translateMatrix = XMMatrixTranslation(300.0f, 0.f, 500.0f);
-	worldMatrix = XMMatrixMultiply(worldMatrix, translateMatrix);
+bool GraphicsClass::InitializePointLights()
+{
+	SceneClass::LightDataType* lights;
+	vector<ClusterClass::PointLightType> pointLights;
+	int i;
 
-	// Render the Big Building model.
-	m_BigBuilding->Render(m_D3D->GetDeviceContext());
-	result = m_ShaderManager->RenderLightShader(m_D3D->GetDeviceContext(), m_BigBuilding->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix,
-										m_BigBuilding->GetTexture(), m_Light->GetDirection(), m_Light->GetAmbientColor(), m_Light->GetDiffuseColor(),
-										m_Camera->GetPosition(), m_Light->GetSpecularColor(), m_Light->GetSpecularPower());
-	if (!result)
+
+	// Gather the flat light arrays of the scene into the layout of the light buffer.
+	lights = m_Scene->GetLights();
+	pointLights.resize(m_Scene->GetLightCount());
+
+	for(i=0; i<m_Scene->GetLightCount(); i++)
 	{
-		return false;
+		pointLights[i].position = XMFLOAT3(lights->positionX[i], lights->positionY[i], lights->positionZ[i]);
+		pointLights[i].radius = lights->radius[i];
+		pointLights[i].color = XMFLOAT3(lights->colorR[i], lights->colorG[i], lights->colorB[i]);
+		pointLights[i].padding = 0.0f;
 	}
 
+	return m_Clusters->SetLights(pointLights.data(), (int)pointLights.size());
+}
 
-	// Setup the rotation and translation of the Drone model.
-	m_D3D->GetWorldMatrix(worldMatrix);
 
-	// Pass the camera position at the translate matrix.
-	translateMatrix = XMMatrixTranslation(cameraPosition.x, cameraPosition.y + 50, cameraPosition.z);
-	orbitMatrix = XMMatrixRotationY(rotation * 0.5);
+bool GraphicsClass::InitializeEntities()
+{
+	SceneClass::InstanceDataType* instances;
+	EntityClass::ArchetypeType* type;
+	unsigned int mask;
+	int* orbitNodes;
+	int i, pass, instanceCount, archetype, row;
+	bool result;
 
-	worldMatrix = XMMatrixMultiply(worldMatrix, translateMatrix);
 
-	// Make the Drone model rotate from the starting point to the camera position.
-	worldMatrix = XMMatrixMultiply(translateMatrix, orbitMatrix);
+	instances = m_Scene->GetInstances();
+	instanceCount = m_Scene->GetInstanceCount();
 
-	// Render the Drone model.
-	m_Drone->Render(m_D3D->GetDeviceContext());
-	result = m_ShaderManager->RenderLightShader(m_D3D->GetDeviceContext(), m_Drone->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix,
-										m_Drone->GetTexture(), m_Light->GetDirection(), m_Light->GetAmbientColor(), m_Light->GetDiffuseColor(),
-										m_Camera->GetPosition(), m_Light->GetSpecularColor(), m_Light->GetSpecularPower());
-	if (!result)
+	// Create the transform object with room for an orbit pivot and a node for every instance.
+	m_Transforms = new TransformClass;
+	if(!m_Transforms)
 	{
 		return false;
 	}
 
-	// Setup the rotation and translation of the Predator model.
-	m_D3D->GetWorldMatrix(worldMatrix);
+	result = m_Transforms->Initialize(instanceCount * 2);
+	if(!result)
+	{
+		return false;
+	}
 
-	translateMatrix = XMMatrixTranslation(-3.0f, 0.9f, 10.0f);
-	worldMatrix = XMMatrixScaling(0.1f, 0.1f, 0.1f);
-	orbitMatrix = XMMatrixRotationY(rotation * 1);
+	// Create the entity object, the systems split their work across the worker pool.
+	m_Entities = new EntityClass;
+	if(!m_Entities)
+	{
+		return false;
+	}
 
-	worldMatrix = XMMatrixMultiply(worldMatrix, translateMatrix);
-	worldMatrix = XMMatrixMultiply(worldMatrix, orbitMatrix);
+	result = m_Entities->Initialize(m_WorkerPool);
+	if(!result)
+	{
+		return false;
+	}
 
-	// Render the Predetor model.
-	m_PredatorModel->Render(m_D3D->GetDeviceContext());
-	result = m_ShaderManager->RenderLightShader(m_D3D->GetDeviceContext(), m_PredatorModel->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix,
-										m_PredatorModel->GetTexture(), m_Light->GetDirection(), m_Light->GetAmbientColor(), m_Light->GetDiffuseColor(),
-										m_Camera->GetPosition(), m_Light->GetSpecularColor(), m_Light->GetSpecularPower());
-	if (!result)
+	orbitNodes = new int[instanceCount];
+	if(!orbitNodes)
 	{
 		return false;
 	}
 
+	// The orbiting instances hang under a pivot node at the world origin that spins around Y.  The pivots are
+	// added first so they form the top level of the breadth first node arrays.
+	for(i=0; i<instanceCount; i++)
+	{
+		orbitNodes[i] = -1;
+		if(instances->orbitSpeed[i] != 0.0f)
+		{
+			orbitNodes[i] = m_Transforms->AddNode(-1);
+		}
+	}
 
-	// Present the rendered scene to the screen.
-	m_D3D->EndScene();
+	// Create an entity for each instance with the components its scene entry asks for.  The instances at the top level
+	// go in on the first pass and the orbiting ones under their pivots on the second, so the nodes stay breadth first.
+	for(pass=0; pass<2; pass++)
+	{
+		for(i=0; i<instanceCount; i++)
+		{
+			if((orbitNodes[i] >= 0) != (pass == 1))
+			{
+				continue;
+			}
+
+			mask = EntityClass::COMPONENT_TRANSFORM | EntityClass::COMPONENT_MESH;
+			if(orbitNodes[i] >= 0)
+			{
+				mask |= EntityClass::COMPONENT_ORBIT;
+			}
+			if(instances->followCamera[i])
+			{
+				mask |= EntityClass::COMPONENT_FOLLOW;
+			}
+
+			row = m_Entities->CreateEntity(mask, archetype);
+			if(row < 0)
+			{
+				delete [] orbitNodes;
+				return false;
+			}
+
+			type = m_Entities->GetArchetype(archetype);
+
+			// Add the transform node with the scale, rotation and position from the scene file.
+			type->transformNode[row] = m_Transforms->AddNode(orbitNodes[i]);
+			if(type->transformNode[row] < 0)
+			{
+				delete [] orbitNodes;
+				return false;
+			}
+
+			m_Transforms->SetLocal(type->transformNode[row], instances->positionX[i], instances->positionY[i], instances->positionZ[i],
+								   instances->rotationX[i] * 0.0174532925f, instances->rotationY[i] * 0.0174532925f,
+								   instances->rotationZ[i] * 0.0174532925f, instances->scale[i]);
+
+			type->mesh[row] = instances->prefab[i];
+
+			if(mask & EntityClass::COMPONENT_ORBIT)
+			{
+				type->orbitNode[row] = orbitNodes[i];
+				type->orbitSpeed[row] = instances->orbitSpeed[i];
+			}
+
+			// The followers use their scene position as an offset from the camera.
+			if(mask & EntityClass::COMPONENT_FOLLOW)
+			{
+				type->followOffsetX[row] = instances->positionX[i];
+				type->followOffsetY[row] = instances->positionY[i];
+				type->followOffsetZ[row] = instances->positionZ[i];
+			}
+		}
+	}
 
+	delete [] orbitNodes;
+	orbitNodes = 0;
+
+	return true;
+}
+
+
+bool GraphicsClass::Frame(const InputSnapshotClass* input)
+{
+	CpuZoneClass frameZone("Frame");
+	CpuZoneClass zone("Timer");
+	RenderDeviceClass::StatisticsType statistics;
+	float frameTime;
+	bool result;
+
+	// Update the system stats.
+	m_Timer->Frame();
+	m_FrameStats->AddFrame(m_Timer->GetPreciseTime());
+
+	// A benchmark steps the simulation by a fixed time instead of the time the last frame took.  A replay takes the
+	// frame time and the input from the log instead, the application ends when the log runs out.
+	if(m_Benchmark->IsRunning())
+	{
+		frameTime = m_Benchmark->GetTimestep();
+		m_Benchmark->BeginFrame();
+	}
+	else if(m_InputLog && m_InputLog->IsReplaying())
+	{
+		result = m_InputLog->ReplayFrame(frameTime);
+		if(!result)
+		{
+			return false;
+		}
+
+		input = &m_InputLog->GetSnapshot();
+	}
+	else
+	{
+		frameTime = m_Timer->GetTime();
+	}
+
+	// Write the input of the frame and the time it steps by to the log.
+	if(m_InputLog && m_InputLog->IsRecording() && input)
+	{
+		result = m_InputLog->RecordFrame(*input, frameTime);
+		if(!result)
+		{
+			return false;
+		}
+	}
+
+	// Run as many fixed simulation steps as the frame time covers.
+	zone.Begin("UpdateSimulation");
+
+	result = UpdateSimulation(frameTime, input);
+	if (!result)
+	{
+		return false;
+	}
+
+	// Render the graphics.
+	zone.Begin("Render");
+
+	result = Render();
+	if (!result)
+	{
+		return false;
+	}
+
+	// Record the frame for the benchmark and write out the results once it has run through, which ends the application.
+	if(m_Benchmark->IsRunning())
+	{
+		m_Device->GetStatistics(statistics);
+		m_Benchmark->EndFrame(statistics);
+
+		if(m_Benchmark->IsFinished())
+		{
+			m_Benchmark->WriteReport(m_benchmarkFilename);
+			m_Benchmark->WriteSummary(m_benchmarkSummaryFilename);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+RenderDeviceClass* GraphicsClass::GetRenderDevice()
+{
+	return m_Device;
+}
+
+
+SoftwareDeviceClass* GraphicsClass::GetSoftwareDevice()
+{
+	return m_SoftwareDevice;
+}
+
+
+GpuProfilerClass* GraphicsClass::GetGpuProfiler()
+{
+	return m_GpuProfiler;
+}
+
+
+FrameStatsClass* GraphicsClass::GetFrameStats()
+{
+	return m_FrameStats;
+}
+
+
+CameraClass* GraphicsClass::GetCamera()
+{
+	return m_Camera;
+}
+
+
+BenchmarkClass* GraphicsClass::GetBenchmark()
+{
+	return m_Benchmark;
+}
+
+
+bool GraphicsClass::StartLatencyMeasurement()
+{
+	bool result;
+
+
+	if(m_Latency)
+	{
+		return true;
+	}
+
+	// Create the latency object.
+	m_Latency = new LatencyClass;
+	if(!m_Latency)
+	{
+		return false;
+	}
+
+	// Initialize the latency object with the file every frame is written to.
+	result = m_Latency->Initialize(LATENCY_FILENAME);
+	if(!result)
+	{
+		m_Latency->Shutdown();
+		delete m_Latency;
+		m_Latency = 0;
+		return false;
+	}
+
+	return true;
+}
+
+
+LatencyClass* GraphicsClass::GetLatency()
+{
+	return m_Latency;
+}
+
+
+bool GraphicsClass::StartInputRecording(const char* filename)
+{
+	float posX, posY, posZ, rotX, rotY, rotZ;
+	bool result;
+
+
+	result = CreateInputLog();
+	if(!result)
+	{
+		return false;
+	}
+
+	// Start the animations over and write down where the viewer starts, so a replay begins from the same state.
+	ResetSimulation();
+
+	m_Position->GetPosition(posX, posY, posZ);
+	m_Position->GetRotation(rotX, rotY, rotZ);
+
+	return m_InputLog->StartRecording(filename, posX, posY, posZ, rotX, rotY, rotZ);
+}
+
+
+bool GraphicsClass::StartInputReplay(const char* filename)
+{
+	float posX, posY, posZ, rotX, rotY, rotZ;
+	bool result;
+
+
+	result = CreateInputLog();
+	if(!result)
+	{
+		return false;
+	}
+
+	result = m_InputLog->StartReplay(filename);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Put the viewer where the recording started and start the animations over, at the full resolution.
+	m_InputLog->GetStartCamera(posX, posY, posZ, rotX, rotY, rotZ);
+	m_Position->SetPosition(posX, posY, posZ);
+	m_Position->SetRotation(rotX, rotY, rotZ);
+
+	ResetSimulation();
+
+	if(m_DynamicResolution)
+	{
+		m_DynamicResolution->SetScale(RESOLUTION_MAX_SCALE);
+	}
+
+	return true;
+}
+
+
+InputLogClass* GraphicsClass::GetInputLog()
+{
+	return m_InputLog;
+}
+
+
+void GraphicsClass::WaitForFrame()
+{
+	CpuZoneClass zone("WaitForFrame");
+
+
+	if(m_Latency)
+	{
+		m_Latency->BeginFrame();
+	}
+
+	// Wait for the swap chain before anything of the frame is read, only the Direct3D device has to wait.
+#ifdef _WIN32
+	if(m_D3D)
+	{
+		m_D3D->WaitForFrame();
+	}
+#endif
+
+	// The input is read right after the wait for the swap chain, the latency is measured from here.
+	if(m_Latency)
+	{
+		m_Latency->MarkInput();
+	}
+
+	return;
+}
+
+
+bool GraphicsClass::StartBenchmark(int warmupFrames, int frameCount, const char* reportFilename, const char* summaryFilename)
+{
+	// Keep where the results go once the run is through.
+	strncpy(m_benchmarkFilename, reportFilename, SCENE_MAX_PATH - 1);
+	m_benchmarkFilename[SCENE_MAX_PATH - 1] = 0;
+
+	strncpy(m_benchmarkSummaryFilename, summaryFilename, SCENE_MAX_PATH - 1);
+	m_benchmarkSummaryFilename[SCENE_MAX_PATH - 1] = 0;
+
+	// Start the objects from where they were loaded so every run renders the same frames, at the full resolution.
+	ResetSimulation();
+
+	if(m_DynamicResolution)
+	{
+		m_DynamicResolution->SetScale(RESOLUTION_MAX_SCALE);
+	}
+
+	return m_Benchmark->Start(warmupFrames, frameCount, BENCHMARK_TIMESTEP);
+}
+
+
+bool GraphicsClass::SetDeferredShading(bool enabled)
+{
+	bool result;
+
+
+	// Create the G-buffer the first time deferred shading is turned on, it is kept for switching back and forth.
+	if(enabled && !m_DeferredBuffers)
+	{
+		m_DeferredBuffers = new DeferredBuffersClass;
+		if(!m_DeferredBuffers)
+		{
+			return false;
+		}
+
+		result = m_DeferredBuffers->Initialize(m_Device, m_screenWidth, m_screenHeight);
+		if(!result)
+		{
+			m_DeferredBuffers->Shutdown();
+			delete m_DeferredBuffers;
+			m_DeferredBuffers = 0;
+			return false;
+		}
+	}
+
+	m_deferredShading = enabled;
+
+	return true;
+}
+
+
+bool GraphicsClass::SetDynamicResolution(bool enabled)
+{
+	bool result;
+
+
+	// Create the scene targets the first time dynamic resolution is turned on, they are kept for switching back and forth.
+	if(enabled && !m_DynamicResolution)
+	{
+		m_DynamicResolution = new DynamicResolutionClass;
+		if(!m_DynamicResolution)
+		{
+			return false;
+		}
+
+		result = m_DynamicResolution->Initialize(m_Device, m_screenWidth, m_screenHeight, (float)FRAME_STATS_BUDGET);
+		if(!result)
+		{
+			m_DynamicResolution->Shutdown();
+			delete m_DynamicResolution;
+			m_DynamicResolution = 0;
+			return false;
+		}
+	}
+
+	m_dynamicResolution = enabled;
+
+	return true;
+}
+
+
+DynamicResolutionClass* GraphicsClass::GetDynamicResolution()
+{
+	return m_DynamicResolution;
+}
+
+
+bool GraphicsClass::HandleMovementInput(float frameTime, unsigned int keys)
+{
+	bool keyDown;
+	float posX, posY, posZ, rotX, rotY, rotZ;
+
+	// Set the frame time for calculating the updated position.
+	m_Position->SetFrameTime(frameTime);
+
+	// Fly the benchmark path while a benchmark runs, otherwise move by the keys that were down during the step.
+	// Without any input no key is down and the viewer stays where it is.
+	if(m_Benchmark->IsRunning())
+	{
+		m_Benchmark->GetCamera(posX, posY, posZ, rotX, rotY, rotZ);
+		m_Position->SetPosition(posX, posY, posZ);
+		m_Position->SetRotation(rotX, rotY, rotZ);
+	}
+	else
+	{
+		keyDown = (keys & InputSnapshotClass::GetKeyBit(InputSnapshotClass::KEY_A)) != 0;
+		m_Position->TurnLeft(keyDown);
+
+		keyDown = (keys & InputSnapshotClass::GetKeyBit(InputSnapshotClass::KEY_D)) != 0;
+		m_Position->TurnRight(keyDown);
+
+		keyDown = (keys & InputSnapshotClass::GetKeyBit(InputSnapshotClass::KEY_W)) != 0;
+		m_Position->MoveForward(keyDown);
+
+		keyDown = (keys & InputSnapshotClass::GetKeyBit(InputSnapshotClass::KEY_S)) != 0;
+		m_Position->MoveBackward(keyDown);
+
+		keyDown = (keys & InputSnapshotClass::GetKeyBit(InputSnapshotClass::KEY_I)) != 0;
+		m_Position->MoveUpward(keyDown);
+
+		keyDown = (keys & InputSnapshotClass::GetKeyBit(InputSnapshotClass::KEY_K)) != 0;
+		m_Position->MoveDownward(keyDown);
+
+		keyDown = (keys & InputSnapshotClass::GetKeyBit(InputSnapshotClass::KEY_L)) != 0;
+		m_Position->LookDownward(keyDown);
+
+		keyDown = (keys & InputSnapshotClass::GetKeyBit(InputSnapshotClass::KEY_J)) != 0;
+		m_Position->LookUpward(keyDown);
+
+		keyDown = (keys & InputSnapshotClass::GetKeyBit(InputSnapshotClass::KEY_F1)) != 0;
+		m_Position->Camera1(keyDown);
+
+		keyDown = (keys & InputSnapshotClass::GetKeyBit(InputSnapshotClass::KEY_F2)) != 0;
+		m_Position->Camera2(keyDown);
+
+		keyDown = (keys & InputSnapshotClass::GetKeyBit(InputSnapshotClass::KEY_F3)) != 0;
+		m_Position->Camera0(keyDown);
+	}
+
+	return true;
+}
+
+
+bool GraphicsClass::UpdateSimulation(float frameTime, const InputSnapshotClass* input)
+{
+	unsigned int keys;
+	double from, to;
+	bool result, stepped;
+
+
+	// Bank the frame time, after a stall only a few steps are caught up on instead of falling further behind.
+	m_simulationTime += frameTime;
+	if(m_simulationTime > SIMULATION_TIMESTEP * (float)SIMULATION_MAX_STEPS)
+	{
+		m_simulationTime = SIMULATION_TIMESTEP * (float)SIMULATION_MAX_STEPS;
+	}
+
+	// Step the viewer and the animations by the fixed time, so they behave the same at any frame rate.
+	from = -DBL_MAX;
+	stepped = false;
+	while(m_simulationTime >= SIMULATION_TIMESTEP)
+	{
+		m_previousState = m_currentState;
+
+		// Each step takes the input samples of its own part of the frame, which ends where the time still banked after
+		// the step begins.  The first step also takes everything before and the last one everything after, so every
+		// sample of the frame is seen by exactly one step.
+		keys = m_pendingKeys;
+		if(input)
+		{
+			to = input->GetTime() - (double)(m_simulationTime - SIMULATION_TIMESTEP);
+			if(m_simulationTime - SIMULATION_TIMESTEP < SIMULATION_TIMESTEP)
+			{
+				to = input->GetTime();
+			}
+
+			keys |= input->GetKeys(from, to);
+			from = to;
+		}
+		m_pendingKeys = 0;
+
+		result = HandleMovementInput(SIMULATION_TIMESTEP, keys);
+		if(!result)
+		{
+			return false;
+		}
+
+		m_rotation += (float)XM_PI * 0.0005f * SIMULATION_TIMESTEP;
+
+		m_Swarm->Update(SIMULATION_TIMESTEP);
+
+		GetSimulationState(m_currentState);
+
+		m_simulationTime -= SIMULATION_TIMESTEP;
+		stepped = true;
+	}
+
+	// A frame too short for a step hands its keys on to the next step, so a tap between two steps is not lost.
+	if(!stepped && input)
+	{
+		m_pendingKeys |= input->GetKeys(-DBL_MAX, input->GetTime());
+	}
+
+	// The frame is drawn this far between the last two steps.
+	m_interpolation = m_simulationTime / SIMULATION_TIMESTEP;
+
+	return true;
+}
+
+
+bool GraphicsClass::CreateInputLog()
+{
+	if(m_InputLog)
+	{
+		return true;
+	}
+
+	// Create the input log object.
+	m_InputLog = new InputLogClass;
+	if(!m_InputLog)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void GraphicsClass::ResetSimulation()
+{
+	// Start the animations over and hold the viewer where it is, with no time banked.
+	m_rotation = 0.0f;
+	m_simulationTime = 0.0f;
+	m_interpolation = 0.0f;
+	m_pendingKeys = 0;
+
+	GetSimulationState(m_currentState);
+	m_previousState = m_currentState;
+
+	return;
+}
+
+
+void GraphicsClass::GetSimulationState(SimulationStateType& state)
+{
+	m_Position->GetPosition(state.position.x, state.position.y, state.position.z);
+	m_Position->GetRotation(state.rotation.x, state.rotation.y, state.rotation.z);
+	state.animation = m_rotation;
+
+	return;
+}
+
+
+void GraphicsClass::InterpolateSimulationState(SimulationStateType& state)
+{
+	XMStoreFloat3(&state.position, XMVectorLerp(XMLoadFloat3(&m_previousState.position), XMLoadFloat3(&m_currentState.position), m_interpolation));
+
+	state.rotation.x = InterpolateAngle(m_previousState.rotation.x, m_currentState.rotation.x, m_interpolation);
+	state.rotation.y = InterpolateAngle(m_previousState.rotation.y, m_currentState.rotation.y, m_interpolation);
+	state.rotation.z = InterpolateAngle(m_previousState.rotation.z, m_currentState.rotation.z, m_interpolation);
+
+	state.animation = m_previousState.animation + (m_currentState.animation - m_previousState.animation) * m_interpolation;
+
+	return;
+}
+
+
+float GraphicsClass::InterpolateAngle(float first, float second, float t)
+{
+	float difference;
+
+
+	// Turn the short way round when the angle has wrapped past 0 or 360 degrees.
+	difference = second - first;
+	if(difference > 180.0f)
+	{
+		difference -= 360.0f;
+	}
+	else if(difference < -180.0f)
+	{
+		difference += 360.0f;
+	}
+
+	return first + difference * t;
+}
+
+bool GraphicsClass::Render()
+{
+	CpuZoneClass zone;
+	XMMATRIX worldMatrix, viewMatrix, projectionMatrix;
+	XMFLOAT3 cameraPosition;
+	SimulationStateType state;
+	EntityClass::ArchetypeType* type;
+	int i, j, shader, sceneWidth, sceneHeight;
+	bool result, dynamic;
+
+
+	// Draw the viewer and the animations between the last two simulation steps.
+	InterpolateSimulationState(state);
+
+	m_Camera->SetPosition(state.position.x, state.position.y, state.position.z);
+	m_Camera->SetRotation(state.rotation.x, state.rotation.y, state.rotation.z);
+
+	// Pick the resolution of this frame from the GPU times read back so far, a benchmark or a replay keeps the full
+	// resolution so every run draws the same work.
+	if(m_dynamicResolution && !m_Benchmark->IsRunning() && !(m_InputLog && m_InputLog->IsReplaying()))
+	{
+		m_DynamicResolution->Update(m_GpuProfiler);
+	}
+
+	// Start counting the draw and state traffic of this frame.
+	m_Device->ResetStatistics();
+
+	// Start timing the frame on the GPU, the clear is part of it.
+	m_GpuProfiler->BeginFrame();
+
+	// Clear the buffers to begin the scene.
+	m_Device->BeginScene(0.0f, 0.0f, 0.0f, 1.0f);
+
+	// Draw into the scene targets instead when the resolution is scaled.
+	if(m_dynamicResolution)
+	{
+		m_DynamicResolution->SetRenderTargets();
+		m_DynamicResolution->ClearRenderTargets();
+	}
+
+	// Hand the camera the projection of the device and bring its view up to date, which only costs anything when the
+	// viewer moved.
+	m_Device->GetProjectionMatrix(projectionMatrix);
+	m_Camera->SetProjectionMatrix(projectionMatrix);
+	m_Camera->Render();
+
+	// Get the view matrix from the camera.
+	m_Camera->GetViewMatrix(viewMatrix);
+
+	// Get the position of the camera
+	cameraPosition = m_Camera->GetPosition();
+
+	// Run the entity systems and bring the world matrices of everything they moved up to date.
+	zone.Begin("UpdateEntities");
+	UpdateEntities(state.animation, cameraPosition);
+
+	// Start a new list of opaque objects for this frame.
+	zone.Begin("BuildRenderList");
+	m_renderItemCount = 0;
+
+	// Add every opaque mesh entity to the render list, walking each archetype's dense arrays in order.
+	for(i=0; i<m_Entities->GetArchetypeCount(); i++)
+	{
+		type = m_Entities->GetArchetype(i);
+		if((type->mask & (EntityClass::COMPONENT_MESH | EntityClass::COMPONENT_TRANSFORM)) != (EntityClass::COMPONENT_MESH | EntityClass::COMPONENT_TRANSFORM))
+		{
+			continue;
+		}
+
+		// The orbiting and following entities move every frame, everything else is static.
+		dynamic = (type->mask & (EntityClass::COMPONENT_ORBIT | EntityClass::COMPONENT_FOLLOW)) != 0;
+
+		for(j=0; j<type->count; j++)
+		{
+			shader = m_Scene->GetPrefab(type->mesh[j])->shader;
+			worldMatrix = XMLoadFloat4x4(m_Transforms->GetWorldMatrix(type->transformNode[j]));
+			AddRenderItem(m_Models[type->mesh[j]], worldMatrix, shader, dynamic, viewMatrix);
+		}
+	}
+
+	// Sort the opaque objects front to back so the nearest surfaces fill the depth buffer first.
+	zone.Begin("SortRenderItems");
+	SortRenderItems();
+
+	// Pick the terrain chunks detailed enough for this view and cull the ones outside it.
+	zone.Begin("UpdateTerrain");
+	result = m_Terrain->Update(m_Camera, projectionMatrix, m_screenHeight);
+	if(!result)
+	{
+		return false;
+	}
+	zone.End();
+
+	// Bin the point lights into the clusters of this view and bind them for the light shader, spread over the pixels
+	// drawn this frame.
+	zone.Begin("ClusterLights");
+	GetSceneSize(sceneWidth, sceneHeight);
+	m_Clusters->SetScreenSize(sceneWidth, sceneHeight);
+	m_Clusters->Bin(viewMatrix);
+
+	result = m_Clusters->Render();
+	if(!result)
+	{
+		return false;
+	}
+	zone.End();
+
+	if(SHADOWS_ENABLED)
+	{
+		// Fit the cascades to this view and draw the casters the cached cascades do not already hold.
+		m_Shadows->Update(viewMatrix, projectionMatrix, m_Light->GetDirection());
+
+		m_GpuProfiler->BeginPass("shadows");
+
+		result = RenderShadowMaps();
+		if(!result)
+		{
+			return false;
+		}
+
+		m_GpuProfiler->EndPass();
+	}
+
+	// Bind the shadow maps for the light shaders, they are left unshadowed until the first update.
+	result = m_Shadows->Render();
+	if(!result)
+	{
+		return false;
+	}
+
+	if(DEPTH_PREPASS_ENABLED)
+	{
+		// Lay down the depth of all the opaque objects without running any pixel shader.
+		m_GpuProfiler->BeginPass("prepass");
+		m_Device->SetDepthState(RenderDeviceClass::DEPTH_STATE_PREPASS);
+
+		result = RenderDepthPrepass(viewMatrix, projectionMatrix);
+		if(!result)
+		{
+			return false;
+		}
+
+		m_GpuProfiler->EndPass();
+
+		// The main pass now only shades the visible pixel of each object.
+		m_Device->SetDepthState(RenderDeviceClass::DEPTH_STATE_EQUAL);
+
+		// With the depth already laid down the draw order no longer matters, so group the draws by pipeline and model to
+		// cut the state changes.
+		zone.Begin("SortRenderItems");
+		SortRenderItemsByPipeline();
+		zone.End();
+	}
+
+	if(m_deferredShading)
+	{
+		// Write the lit objects into the G-buffer and light all their visible pixels in one fullscreen pass, the
+		// remaining objects are then drawn forward on top.
+		m_GpuProfiler->BeginPass("deferred");
+
+		result = RenderDeferredItems(viewMatrix, projectionMatrix, DEPTH_PREPASS_ENABLED ? RenderDeviceClass::DEPTH_STATE_EQUAL :
+									 RenderDeviceClass::DEPTH_STATE_DEFAULT);
+		if(!result)
+		{
+			return false;
+		}
+
+		m_GpuProfiler->EndPass();
+	}
+
+	// Render the opaque objects with their shaders.
+	m_GpuProfiler->BeginPass("opaque");
+
+	result = RenderOpaqueItems(viewMatrix, projectionMatrix);
+	if(!result)
+	{
+		return false;
+	}
+
+	m_GpuProfiler->EndPass();
+
+	// Render the terrain chunks after the objects, it covers most of the screen but the objects hide some of it.
+	m_GpuProfiler->BeginPass("terrain");
+	m_Device->SetDepthState(RenderDeviceClass::DEPTH_STATE_DEFAULT);
+
+	result = RenderTerrain(viewMatrix, projectionMatrix);
+	if(!result)
+	{
+		return false;
+	}
+
+	m_GpuProfiler->EndPass();
+
+	// Render the whole drone swarm in one instanced draw.
+	m_GpuProfiler->BeginPass("swarm");
+
+	result = RenderSwarm(viewMatrix, projectionMatrix);
+	if(!result)
+	{
+		return false;
+	}
+
+	m_GpuProfiler->EndPass();
+
+	// Render the sky last as one fullscreen triangle at the far plane so only the uncovered pixels pay for it.
+	m_GpuProfiler->BeginPass("sky");
+	m_Device->SetDepthState(RenderDeviceClass::DEPTH_STATE_SKY);
+
+	result = m_ShaderManager->RenderSkyShader(viewMatrix, projectionMatrix, m_SkyTexture->GetTexture());
+	if(!result)
+	{
+		return false;
+	}
+
+	m_GpuProfiler->EndPass();
+
+	// Stretch the scene drawn at the lower resolution over the back buffer.
+	if(m_dynamicResolution)
+	{
+		m_GpuProfiler->BeginPass("upscale");
+
+		result = RenderUpscale();
+		if(!result)
+		{
+			return false;
+		}
+
+		m_GpuProfiler->EndPass();
+	}
+
+	// Restore the default depth state for the next frame.
+	m_Device->SetDepthState(RenderDeviceClass::DEPTH_STATE_DEFAULT);
+
+	// Close the frame on the GPU and read back the earlier frames that have finished.
+	m_GpuProfiler->EndFrame();
+
+	// Present the rendered scene to the screen.
+	zone.Begin("Present");
+	m_Device->EndScene();
+
+	if(m_Latency)
+	{
+		m_Latency->MarkPresent();
+	}
+	zone.End();
+
+
+	return true;
+}
+
+
+void GraphicsClass::UpdateEntities(float rotation, const XMFLOAT3& cameraPosition)
+{
+	// Spin the orbit pivots and move the camera followers, static entities are not touched.
+	m_Entities->UpdateOrbits(m_Transforms, rotation);
+	m_Entities->UpdateFollowers(m_Transforms, cameraPosition.x, cameraPosition.y, cameraPosition.z);
+
+	// Recompute the dirty subtrees.
+	m_Transforms->Update();
+
+	return;
+}
+
+
+void GraphicsClass::AddRenderItem(ModelClass* model, const XMMATRIX& worldMatrix, int shader, bool dynamic, const XMMATRIX& viewMatrix)
+{
+	XMVECTOR viewPosition;
+
+
+	// Ignore the object if the list is already full.
+	if(m_renderItemCount >= m_Scene->GetInstanceCount())
+	{
+		return;
+	}
+
+	// Store the model, its world matrix, which shader it uses and whether it moves.
+	m_renderItems[m_renderItemCount].model = model;
+	XMStoreFloat4x4(&m_renderItems[m_renderItemCount].world, worldMatrix);
+	m_renderItems[m_renderItemCount].shader = shader;
+	m_renderItems[m_renderItemCount].dynamic = dynamic;
+
+	// The pipeline handle of the shader doubles as the state sort key.
+	if(shader == SceneClass::SHADER_LIGHT && m_deferredShading)
+	{
+		m_renderItems[m_renderItemCount].pipeline = m_ShaderManager->GetDeferredPipeline();
+	}
+	else if(shader == SceneClass::SHADER_LIGHT)
+	{
+		m_renderItems[m_renderItemCount].pipeline = m_ShaderManager->GetLightPipeline();
+	}
+	else
+	{
+		m_renderItems[m_renderItemCount].pipeline = m_ShaderManager->GetTexturePipeline();
+	}
+
+	// Use the view space depth of the object origin as the sort key.
+	viewPosition = XMVector3TransformCoord(worldMatrix.r[3], viewMatrix);
+	m_renderItems[m_renderItemCount].depth = XMVectorGetZ(viewPosition);
+
+	m_renderItemCount++;
+
+	return;
+}
+
+
+bool GraphicsClass::CompareRenderItemDepth(const RenderItemType& first, const RenderItemType& second)
+{
+	return first.depth < second.depth;
+}
+
+
+void GraphicsClass::SortRenderItems()
+{
+	// Sort on view depth so the list runs front to back.
+	sort(m_renderItems, m_renderItems + m_renderItemCount, CompareRenderItemDepth);
+
+	return;
+}
+
+
+bool GraphicsClass::CompareRenderItemPipeline(const RenderItemType& first, const RenderItemType& second)
+{
+	if(first.pipeline != second.pipeline)
+	{
+		return first.pipeline < second.pipeline;
+	}
+
+	return less<ModelClass*>()(first.model, second.model);
+}
+
+
+void GraphicsClass::SortRenderItemsByPipeline()
+{
+	// Keep the front to back order within each group of the same pipeline and model.
+	stable_sort(m_renderItems, m_renderItems + m_renderItemCount, CompareRenderItemPipeline);
+
+	return;
+}
+
+
+bool GraphicsClass::RenderShadowMaps()
+{
+	XMMATRIX lightViewMatrix, lightProjectionMatrix;
+	bool result;
+	int i;
+
+
+	// The casters are drawn depth only, the shadow maps keep the usual depth direction whatever the scene uses.
+	m_Device->SetDepthState(RenderDeviceClass::DEPTH_STATE_SHADOW);
+
+	for(i=0; i<SHADOW_CASCADES; i++)
+	{
+		m_Shadows->GetCascadeMatrices(i, lightViewMatrix, lightProjectionMatrix);
+
+		// Redraw the static casters of a cached cascade only when it has been refitted.
+		if(m_Shadows->NeedsStaticUpdate(i))
+		{
+			m_Shadows->SetStaticTarget(i);
+
+			result = RenderShadowCasters(lightViewMatrix, lightProjectionMatrix, true, false);
+			if(!result)
+			{
+				return false;
+			}
+		}
+
+		// Start the live map from the static casters of a cached cascade and add the dynamic ones, the near cascades
+		// draw everything.
+		m_Shadows->SetTarget(i);
+
+		result = RenderShadowCasters(lightViewMatrix, lightProjectionMatrix, !m_Shadows->IsCascadeCached(i), true);
+		if(!result)
+		{
+			return false;
+		}
+	}
+
+	// Go back to the scene targets and the scene depth test for the main passes.
+	SetSceneTargets();
+	m_Device->SetDepthState(RenderDeviceClass::DEPTH_STATE_DEFAULT);
+
+	return true;
+}
+
+
+bool GraphicsClass::RenderShadowCasters(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, bool staticCasters, bool dynamicCasters)
+{
+	XMMATRIX worldMatrix;
+	bool result;
+	int i;
+
+
+	for(i=0; i<m_renderItemCount; i++)
+	{
+		if((m_renderItems[i].dynamic && !dynamicCasters) || (!m_renderItems[i].dynamic && !staticCasters))
+		{
+			continue;
+		}
+
+		worldMatrix = XMLoadFloat4x4(&m_renderItems[i].world);
+
+		// Render the position only stream of the model with the depth shader.
+		m_renderItems[i].model->RenderPositions();
+		result = m_ShaderManager->RenderDepthShader(m_renderItems[i].model->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix);
+		if(!result)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+bool GraphicsClass::RenderDepthPrepass(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix)
+{
+	XMMATRIX worldMatrix;
+	bool result;
+	int i;
+
+
+	for(i=0; i<m_renderItemCount; i++)
+	{
+		worldMatrix = XMLoadFloat4x4(&m_renderItems[i].world);
+
+		// Render the position only stream of the model with the depth shader.
+		m_renderItems[i].model->RenderPositions();
+		result = m_ShaderManager->RenderDepthShader(m_renderItems[i].model->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix);
+		if(!result)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+bool GraphicsClass::RenderOpaqueItems(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix)
+{
+	XMMATRIX worldMatrix;
+	bool result;
+	int i;
+
+
+	for(i=0; i<m_renderItemCount; i++)
+	{
+		// The lit objects were already drawn by the deferred pass.
+		if(m_deferredShading && m_renderItems[i].shader == SceneClass::SHADER_LIGHT)
+		{
+			continue;
+		}
+
+		worldMatrix = XMLoadFloat4x4(&m_renderItems[i].world);
+
+		// Put the model vertex and index buffers on the pipeline.
+		m_renderItems[i].model->Render();
+
+		if(m_renderItems[i].shader == SceneClass::SHADER_LIGHT)
+		{
+			// Render the model using the light shader.
+			result = m_ShaderManager->RenderLightShader(m_renderItems[i].model->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, m_renderItems[i].model->GetTexture(), m_Light->GetDirection(),
+														m_Light->GetAmbientColor(), m_Light->GetDiffuseColor(), m_Camera->GetPosition(),
+														m_Light->GetSpecularColor(), m_Light->GetSpecularPower());
+		}
+		else
+		{
+			// Render the model using the texture shader.
+			result = m_ShaderManager->RenderTextureShader(m_renderItems[i].model->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix,
+														  m_renderItems[i].model->GetTexture());
+		}
+
+		if(!result)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+bool GraphicsClass::RenderTerrain(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix)
+{
+	XMMATRIX worldMatrix;
+	int i, indexCount;
+	bool result;
+
+
+	// The terrain vertices are already in world space.
+	worldMatrix = XMMatrixIdentity();
+
+	for(i=0; i<m_Terrain->GetVisibleNodeCount(); i++)
+	{
+		// Put the chunk vertex buffer and the index buffer stitched to its neighbours on the pipeline.
+		indexCount = m_Terrain->RenderNode(i);
+
+		// Render the chunk using the light shader, the ground has no specular highlight.
+		result = m_ShaderManager->RenderLightShader(indexCount, worldMatrix, viewMatrix, projectionMatrix, m_TerrainTexture->GetTexture(), m_Light->GetDirection(),
+													m_Light->GetAmbientColor(), m_Light->GetDiffuseColor(), m_Camera->GetPosition(),
+													XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f), m_Light->GetSpecularPower());
+		if(!result)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+bool GraphicsClass::RenderSwarm(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix)
+{
+	ModelClass* model;
+	XMMATRIX worldMatrix;
+	bool result;
+
+
+	// Put the world matrices of the drones in view on the pipeline, placed between the last two simulation steps.
+	result = m_Swarm->Render(m_Camera, m_interpolation);
+	if(!result)
+	{
+		return false;
+	}
+
+	if(m_Swarm->GetVisibleCount() == 0)
+	{
+		return true;
+	}
+
+	// Every instance carries its own world matrix.
+	worldMatrix = XMMatrixIdentity();
+
+	model = m_Models[m_swarmPrefab];
+	model->Render();
+
+	result = m_ShaderManager->RenderLightShaderInstanced(model->GetIndexCount(), m_Swarm->GetVisibleCount(), worldMatrix, viewMatrix, projectionMatrix,
+														 model->GetTexture(), m_Light->GetDirection(), m_Light->GetAmbientColor(), m_Light->GetDiffuseColor(),
+														 m_Camera->GetPosition(), m_Light->GetSpecularColor(), m_Light->GetSpecularPower());
+	if(!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+bool GraphicsClass::RenderDeferredItems(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, RenderDeviceClass::DepthStateType depthState)
+{
+	XMMATRIX worldMatrix;
+	bool result;
+	int i;
+
+
+	// Draw into the cleared G-buffer, with the depth buffer and test of the main pass.  A scaled scene only fills the
+	// same corner of it.
+	if(m_dynamicResolution)
+	{
+		m_DeferredBuffers->SetRenderTargets(m_DynamicResolution->GetDepthTarget());
+		m_Device->SetViewport(m_DynamicResolution->GetWidth(), m_DynamicResolution->GetHeight());
+	}
+	else
+	{
+		m_DeferredBuffers->SetRenderTargets(0);
+	}
+	m_DeferredBuffers->ClearRenderTargets();
+
+	for(i=0; i<m_renderItemCount; i++)
+	{
+		if(m_renderItems[i].shader != SceneClass::SHADER_LIGHT)
+		{
+			continue;
+		}
+
+		worldMatrix = XMLoadFloat4x4(&m_renderItems[i].world);
+
+		// Render the model material into the G-buffer using the deferred shader.
+		m_renderItems[i].model->Render();
+		result = m_ShaderManager->RenderDeferredShader(m_renderItems[i].model->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix,
+													   m_renderItems[i].model->GetTexture(), m_Light->GetSpecularPower());
+		if(!result)
+		{
+			return false;
+		}
+	}
+
+	// Go back to the scene targets and light them from the G-buffer.  The depth test is off as the G-buffer already
+	// holds only the visible surfaces, and the pixels it left empty are kept for the sky.
+	SetSceneTargets();
+	m_Device->SetDepthState(RenderDeviceClass::DEPTH_STATE_DISABLED);
+
+	result = m_ShaderManager->RenderDeferredLightShader(m_DeferredBuffers->GetTexture(DeferredBuffersClass::BUFFER_COLOR),
+														m_DeferredBuffers->GetTexture(DeferredBuffersClass::BUFFER_NORMAL),
+														m_DeferredBuffers->GetTexture(DeferredBuffersClass::BUFFER_DEPTH), viewMatrix,
+														projectionMatrix, m_Light->GetDirection(), m_Light->GetAmbientColor(),
+														m_Light->GetDiffuseColor(), m_Light->GetSpecularColor());
+	if(!result)
+	{
+		return false;
+	}
+
+	// Restore the depth test for the forward objects.
+	m_Device->SetDepthState(depthState);
+
+	return true;
+}
+
+
+void GraphicsClass::SetSceneTargets()
+{
+	// The scene is drawn into the scene targets when the resolution is scaled, otherwise straight into the back buffer.
+	if(m_dynamicResolution)
+	{
+		m_DynamicResolution->SetRenderTargets();
+	}
+	else
+	{
+		m_Device->SetRenderTargets(NULL, 0, 0);
+	}
+
+	return;
+}
+
+
+void GraphicsClass::GetSceneSize(int& width, int& height)
+{
+	width = m_dynamicResolution ? m_DynamicResolution->GetWidth() : m_screenWidth;
+	height = m_dynamicResolution ? m_DynamicResolution->GetHeight() : m_screenHeight;
+
+	return;
+}
+
+
+bool GraphicsClass::RenderUpscale()
+{
+	bool result;
+
+
+	// Draw over the whole back buffer without the depth test.
+	m_Device->SetRenderTargets(NULL, 0, 0);
+	m_Device->SetDepthState(RenderDeviceClass::DEPTH_STATE_DISABLED);
+
+	result = m_ShaderManager->RenderUpscaleShader(m_DynamicResolution->GetTexture(), m_DynamicResolution->GetTextureWidth(),
+												  m_DynamicResolution->GetTextureHeight(), m_DynamicResolution->GetWidth(),
+												  m_DynamicResolution->GetHeight(), UPSCALE_SHARPNESS);
+	if(!result)
+	{
+		return false;
+	}
 
 	return true;
 }
\ No newline at end of file
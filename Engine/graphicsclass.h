@@ -5,18 +5,47 @@
 #define _GRAPHICSCLASS_H_
 
 
+//////////////
+// INCLUDES //
+//////////////
+#include <float.h>
+#include <wchar.h>
+
+
 ///////////////////////
 // MY CLASS INCLUDES //
 ///////////////////////
-#include "inputclass.h"
+#include "inputsnapshotclass.h"
+#include "renderdeviceclass.h"
+#ifdef _WIN32
 #include "d3dclass.h"
+#endif
+#include "nulldeviceclass.h"
+#include "softwaredeviceclass.h"
 #include "timerclass.h"
+#include "workerpoolclass.h"
+#include "framestatsclass.h"
 #include "shadermanagerclass.h"
 #include "positionclass.h"
 #include "cameraclass.h"
 #include "lightclass.h"
 #include "modelclass.h"
+#include "textureclass.h"
+#include "terrainclass.h"
+#include "swarmclass.h"
 #include "bumpmodelclass.h"
+#include "sceneclass.h"
+#include "transformclass.h"
+#include "entityclass.h"
+#include "clusterclass.h"
+#include "deferredbuffersclass.h"
+#include "shadowclass.h"
+#include "dynamicresolutionclass.h"
+#include "gpuprofilerclass.h"
+#include "benchmarkclass.h"
+#include "latencyclass.h"
+#include "inputlogclass.h"
+#include "cpuprofilerclass.h"
 
 
 /////////////
@@ -26,6 +55,28 @@ const bool FULL_SCREEN = false;
 const bool VSYNC_ENABLED = true;
 const float SCREEN_DEPTH = 10000.0f;
 const float SCREEN_NEAR = 0.1f;
+const bool REVERSE_DEPTH_ENABLED = true;
+const bool DEPTH_PREPASS_ENABLED = true;
+const bool DEFERRED_SHADING_ENABLED = false;
+const bool SHADOWS_ENABLED = true;
+const bool DYNAMIC_RESOLUTION_ENABLED = true;
+const float UPSCALE_SHARPNESS = 0.2f;
+const float SIMULATION_TIMESTEP = 1000.0f / 60.0f;
+const int SIMULATION_MAX_STEPS = 5;
+const char* const GPU_PROFILE_FILENAME = "../Engine/gpuprofile.csv";
+const char* const BENCHMARK_FILENAME = "../Engine/benchmark.csv";
+const char* const BENCHMARK_SUMMARY_FILENAME = "../Engine/benchmarksummary.csv";
+const char* const LATENCY_FILENAME = "../Engine/latency.csv";
+const char* const INPUT_LOG_FILENAME = "../Engine/input.log";
+const char* const SCENE_FILENAME = "../Engine/data/scene.txt";
+const wchar_t* const SKY_TEXTURE_FILENAME = L"../Engine/data/skyTexture.dds";
+const wchar_t* const TERRAIN_TEXTURE_FILENAME = L"../Engine/data/lol.dds";
+const char* const SWARM_PREFAB_NAME = "swarmDrone";
+
+// Only the windowed renderer has a window, the headless and software renderers pass a null handle.
+#ifndef _WIN32
+typedef void* HWND;
+#endif
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -33,37 +84,136 @@ const float SCREEN_NEAR = 0.1f;
 ////////////////////////////////////////////////////////////////////////////////
 class GraphicsClass
 {
+private:
+	struct RenderItemType
+	{
+		ModelClass* model;
+		XMFLOAT4X4 world;
+		int shader;
+		int pipeline;
+		float depth;
+		bool dynamic;
+	};
+
+	// Everything a simulation step changes that the frame is drawn from.
+	struct SimulationStateType
+	{
+		XMFLOAT3 position;
+		XMFLOAT3 rotation;
+		float animation;
+	};
+
 public:
 	GraphicsClass();
 	GraphicsClass(const GraphicsClass&);
 	~GraphicsClass();
 
-	bool Initialize(HINSTANCE, HWND, int, int);
+#ifdef _WIN32
+	bool Initialize(HWND, int, int);
+#endif
+	bool InitializeHeadless(int, int);
+	bool InitializeSoftware(int, int, int);
+	void SetSceneFiles(const char*, const wchar_t*);
 	void Shutdown();
-	bool Frame();
+	void WaitForFrame();
+	bool Frame(const InputSnapshotClass*);
+
+	RenderDeviceClass* GetRenderDevice();
+	SoftwareDeviceClass* GetSoftwareDevice();
+	GpuProfilerClass* GetGpuProfiler();
+	FrameStatsClass* GetFrameStats();
+	CameraClass* GetCamera();
+
+	bool SetDeferredShading(bool);
+	bool SetDynamicResolution(bool);
+	DynamicResolutionClass* GetDynamicResolution();
+	bool StartBenchmark(int, int, const char*, const char*);
+	BenchmarkClass* GetBenchmark();
+	bool StartLatencyMeasurement();
+	LatencyClass* GetLatency();
+	bool StartInputRecording(const char*);
+	bool StartInputReplay(const char*);
+	InputLogClass* GetInputLog();
 
 private:
 	//bool Render(float);
 	//Xu
-	bool HandleMovementInput(float);
+	bool HandleMovementInput(float, unsigned int);
+	bool UpdateSimulation(float, const InputSnapshotClass*);
+	bool CreateInputLog();
+	void ResetSimulation();
+	void GetSimulationState(SimulationStateType&);
+	void InterpolateSimulationState(SimulationStateType&);
+	static float InterpolateAngle(float, float, float);
 	bool Render();
 
+	bool InitializeRenderer(HWND, int, int);
+	bool InitializeScene(HWND, const char*);
+	bool InitializePointLights();
+	void ShutdownScene();
+	void ShowError(HWND, const wchar_t*);
+	bool InitializeEntities();
+	void UpdateEntities(float, const XMFLOAT3&);
+
+	void AddRenderItem(ModelClass*, const XMMATRIX&, int, bool, const XMMATRIX&);
+	void SortRenderItems();
+	static bool CompareRenderItemDepth(const RenderItemType&, const RenderItemType&);
+	void SortRenderItemsByPipeline();
+	static bool CompareRenderItemPipeline(const RenderItemType&, const RenderItemType&);
+	bool RenderShadowMaps();
+	bool RenderShadowCasters(const XMMATRIX&, const XMMATRIX&, bool, bool);
+	bool RenderDepthPrepass(const XMMATRIX&, const XMMATRIX&);
+	bool RenderOpaqueItems(const XMMATRIX&, const XMMATRIX&);
+	bool RenderTerrain(const XMMATRIX&, const XMMATRIX&);
+	bool RenderSwarm(const XMMATRIX&, const XMMATRIX&);
+	bool RenderDeferredItems(const XMMATRIX&, const XMMATRIX&, RenderDeviceClass::DepthStateType);
+	void SetSceneTargets();
+	void GetSceneSize(int&, int&);
+	bool RenderUpscale();
+
 private:
-	InputClass* m_Input;
+#ifdef _WIN32
 	D3DClass* m_D3D;
+#endif
+	NullDeviceClass* m_NullDevice;
+	SoftwareDeviceClass* m_SoftwareDevice;
+	RenderDeviceClass* m_Device;
 	TimerClass* m_Timer;
+	FrameStatsClass* m_FrameStats;
+	WorkerPoolClass* m_WorkerPool;
 	ShaderManagerClass* m_ShaderManager;
 	PositionClass* m_Position;
 	CameraClass* m_Camera;
 	LightClass* m_Light;
-	ModelClass* m_TerrainModel;
-	ModelClass* m_SkyDomes;
-	ModelClass* m_AirplaneModel;
-	ModelClass* m_ControlTower;
-	ModelClass* m_AirfieldModel;
-	ModelClass* m_Drone;
-	ModelClass* m_BigBuilding;
-	ModelClass* m_PredatorModel;
+	SceneClass* m_Scene;
+	ModelClass** m_Models;
+	TextureClass* m_SkyTexture;
+	TerrainClass* m_Terrain;
+	TextureClass* m_TerrainTexture;
+	SwarmClass* m_Swarm;
+	int m_swarmPrefab;
+	TransformClass* m_Transforms;
+	EntityClass* m_Entities;
+	ClusterClass* m_Clusters;
+	DeferredBuffersClass* m_DeferredBuffers;
+	ShadowClass* m_Shadows;
+	DynamicResolutionClass* m_DynamicResolution;
+	GpuProfilerClass* m_GpuProfiler;
+	BenchmarkClass* m_Benchmark;
+	LatencyClass* m_Latency;
+	InputLogClass* m_InputLog;
+	float m_rotation;
+	float m_simulationTime, m_interpolation;
+	unsigned int m_pendingKeys;
+	SimulationStateType m_previousState, m_currentState;
+	bool m_deferredShading, m_dynamicResolution;
+	int m_screenWidth, m_screenHeight;
+	char m_sceneFilename[SCENE_MAX_PATH];
+	wchar_t m_skyTextureFilename[SCENE_MAX_PATH];
+	char m_benchmarkFilename[SCENE_MAX_PATH], m_benchmarkSummaryFilename[SCENE_MAX_PATH];
+
+	RenderItemType* m_renderItems;
+	int m_renderItemCount;
 };
 
 #endif
\ No newline at end of file
@@ -9,6 +9,12 @@ InputClass::InputClass()
 	m_directInput = 0;
 	m_keyboard = 0;
 	m_mouse = 0;
+	m_frame = 0;
+	m_threadRunning = false;
+	m_threadFailed = false;
+	m_ringHead = 0;
+	m_ringTail = 0;
+	m_droppedSamples = 0;
 }
 
 
@@ -35,6 +41,14 @@ bool InputClass::Initialize(HINSTANCE hinstance, HWND hwnd, int screenWidth, int
 	m_mouseX = 0;
 	m_mouseY = 0;
 
+	// Start with no key down and the mouse still, a device that cannot be read yet leaves its state as it was.
+	memset(m_keyboardState, 0, sizeof(m_keyboardState));
+	memset(&m_mouseState, 0, sizeof(m_mouseState));
+
+	// The samples and the snapshots are timed from here.
+	m_startTime = chrono::steady_clock::now();
+	m_frame = 0;
+
 	// Initialize the main direct input interface.
 	result = DirectInput8Create(hinstance, DIRECTINPUT_VERSION, IID_IDirectInput8, (void**)&m_directInput, NULL);
 	if(FAILED(result))
@@ -98,12 +112,30 @@ bool InputClass::Initialize(HINSTANCE hinstance, HWND hwnd, int screenWidth, int
 		return false;
 	}
 
+	// Start sampling the devices on the input thread.
+	if(INPUT_THREAD_ENABLED)
+	{
+		m_ringHead = 0;
+		m_ringTail = 0;
+		m_droppedSamples = 0;
+		m_threadFailed = false;
+		m_threadRunning = true;
+		m_thread = thread(SampleThread, this);
+	}
+
 	return true;
 }
 
 
 void InputClass::Shutdown()
 {
+	// Stop the input thread before the devices it reads go away.
+	if(m_thread.joinable())
+	{
+		m_threadRunning = false;
+		m_thread.join();
+	}
+
 	// Release the mouse.
 	if(m_mouse)
 	{
@@ -133,30 +165,62 @@ void InputClass::Shutdown()
 
 bool InputClass::Frame()
 {
+	InputSnapshotClass::SampleType sample;
+	unsigned int head, tail;
 	bool result;
 
 
-	// Read the current state of the keyboard.
-	result = ReadKeyboard();
-	if(!result)
+	// The keys carry over from the end of the last snapshot.
+	m_snapshot.Begin(m_frame, m_snapshot.GetKeys());
+	m_frame++;
+
+	if(m_thread.joinable())
 	{
-		return false;
-	}
+		// The input thread could not read the devices any more.
+		if(m_threadFailed.load(memory_order_acquire))
+		{
+			return false;
+		}
 
-	// Read the current state of the mouse.
-	result = ReadMouse();
-	if(!result)
+		// Take every sample the input thread wrote since the last frame.
+		tail = m_ringTail.load(memory_order_relaxed);
+		head = m_ringHead.load(memory_order_acquire);
+		while(tail != head)
+		{
+			m_snapshot.AddSample(m_ring[tail % INPUT_RING_SIZE]);
+			tail++;
+		}
+
+		// Hand the read slots back to the input thread.
+		m_ringTail.store(tail, memory_order_release);
+	}
+	else
 	{
-		return false;
+		// Read the devices once for the whole frame.
+		result = ReadSample(sample);
+		if(!result)
+		{
+			return false;
+		}
+
+		m_snapshot.AddSample(sample);
 	}
 
 	// Process the changes in the mouse and keyboard.
 	ProcessInput();
 
+	m_snapshot.End(GetTime(), m_mouseX, m_mouseY);
+
 	return true;
 }
 
 
+const InputSnapshotClass& InputClass::GetSnapshot()
+{
+	return m_snapshot;
+}
+
+
 bool InputClass::ReadKeyboard()
 {
 	HRESULT result;
@@ -205,162 +269,123 @@ bool InputClass::ReadMouse()
 }
 
 
-void InputClass::ProcessInput()
-{
-	// Update the location of the mouse cursor based on the change of the mouse location during the frame.
-	m_mouseX += m_mouseState.lX;
-	m_mouseY += m_mouseState.lY;
-
-	// Ensure the mouse location doesn't exceed the screen width or height.
-	if(m_mouseX < 0)  { m_mouseX = 0; }
-	if(m_mouseY < 0)  { m_mouseY = 0; }
-	
-	if(m_mouseX > m_screenWidth)  { m_mouseX = m_screenWidth; }
-	if(m_mouseY > m_screenHeight) { m_mouseY = m_screenHeight; }
-	
-	return;
-}
-
-
-void InputClass::GetMouseLocation(int& mouseX, int& mouseY)
+bool InputClass::ReadSample(InputSnapshotClass::SampleType& sample)
 {
-	mouseX = m_mouseX;
-	mouseY = m_mouseY;
-	return;
-}
+	bool result;
+	int i;
 
 
-bool InputClass::IsEscapePressed()
-{
-	// Do a bitwise and on the keyboard state to check if the escape key is currently being pressed.
-	if(m_keyboardState[DIK_ESCAPE] & 0x80)
+	// Read the current state of the keyboard.
+	result = ReadKeyboard();
+	if(!result)
 	{
-		return true;
+		return false;
 	}
 
-	return false;
-}
-
-
-bool InputClass::IsAPressed()
-{
-	// Do a bitwise and on the keyboard state to check if the key is currently being pressed.
-	if(m_keyboardState[DIK_A] & 0x80)
+	// Read the current state of the mouse.
+	result = ReadMouse();
+	if(!result)
 	{
-		return true;
+		return false;
 	}
 
-	return false;
-}
-
-
-bool InputClass::IsDPressed()
-{
-	// Do a bitwise and on the keyboard state to check if the key is currently being pressed.
-	if(m_keyboardState[DIK_D] & 0x80)
+	// Keep the keys the engine uses as one bit each.
+	sample.time = GetTime();
+	sample.keys = 0;
+	for(i=0; i<InputSnapshotClass::KEY_COUNT; i++)
 	{
-		return true;
+		if(m_keyboardState[INPUT_KEY_CODES[i]] & 0x80)
+		{
+			sample.keys |= InputSnapshotClass::GetKeyBit((InputSnapshotClass::KeyType)i);
+		}
 	}
 
-	return false;
+	sample.mouseDeltaX = m_mouseState.lX;
+	sample.mouseDeltaY = m_mouseState.lY;
+
+	return true;
 }
 
 
-bool InputClass::IsWPressed()
+void InputClass::ProcessInput()
 {
-	// Do a bitwise and on the keyboard state to check if the key is currently being pressed.
-	if(m_keyboardState[DIK_W] & 0x80)
-	{
-		return true;
-	}
-
-	return false;
-}
+	int mouseDeltaX, mouseDeltaY;
 
 
-bool InputClass::IsSPressed()
-{
-	// Do a bitwise and on the keyboard state to check if the key is currently being pressed.
-	if(m_keyboardState[DIK_S] & 0x80)
-	{
-		return true;
-	}
+	// Update the location of the mouse cursor based on the change of the mouse location during the frame.
+	m_snapshot.GetMouseDelta(mouseDeltaX, mouseDeltaY);
+	m_mouseX += mouseDeltaX;
+	m_mouseY += mouseDeltaY;
 
-	return false;
+	// Ensure the mouse location doesn't exceed the screen width or height.
+	if(m_mouseX < 0)  { m_mouseX = 0; }
+	if(m_mouseY < 0)  { m_mouseY = 0; }
+	
+	if(m_mouseX > m_screenWidth)  { m_mouseX = m_screenWidth; }
+	if(m_mouseY > m_screenHeight) { m_mouseY = m_screenHeight; }
+	
+	return;
 }
 
 
-bool InputClass::IsIPressed()
+void InputClass::GetMouseLocation(int& mouseX, int& mouseY)
 {
-	// Do a bitwise and on the keyboard state to check if the key is currently being pressed.
-	if(m_keyboardState[DIK_I] & 0x80)
-	{
-		return true;
-	}
-
-	return false;
+	mouseX = m_mouseX;
+	mouseY = m_mouseY;
+	return;
 }
 
 
-bool InputClass::IsKPressed()
+int InputClass::GetDroppedSampleCount()
 {
-	// Do a bitwise and on the keyboard state to check if the key is currently being pressed.
-	if(m_keyboardState[DIK_K] & 0x80)
-	{
-		return true;
-	}
-
-	return false;
+	return m_droppedSamples.load(memory_order_relaxed);
 }
 
 
-bool InputClass::IsJPressed()
+double InputClass::GetTime()
 {
-	// Do a bitwise and on the keyboard state to check if the key is currently being pressed.
-	if(m_keyboardState[DIK_J] & 0x80)
-	{
-		return true;
-	}
-
-	return false;
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - m_startTime).count();
 }
 
-bool InputClass::IsLPressed()
-{
-	if (m_keyboardState[DIK_L] & 0x80)
-	{
-		return true;
-	}
-
-	return false;
-}
 
-bool InputClass::IsF1Pressed()
+void InputClass::SampleThread(InputClass* input)
 {
-	if (m_keyboardState[DIK_F1] & 0x80)
-	{
-		return true;
-	}
+	InputSnapshotClass::SampleType sample;
+	chrono::steady_clock::time_point next;
+	unsigned int head, tail;
+	bool result;
 
-	return false;
-}
 
-bool InputClass::IsF2Pressed()
-{
-	if (m_keyboardState[DIK_F2] & 0x80)
+	CpuProfilerClass::SetThreadName("Input");
+
+	next = chrono::steady_clock::now();
+	while(input->m_threadRunning.load(memory_order_acquire))
 	{
-		return true;
-	}
+		// Tell the frame to stop when a device cannot be read any more.
+		result = input->ReadSample(sample);
+		if(!result)
+		{
+			input->m_threadFailed.store(true, memory_order_release);
+			return;
+		}
 
-	return false;
-}
+		// Only this thread writes the head and only the frame moves the tail.
+		head = input->m_ringHead.load(memory_order_relaxed);
+		tail = input->m_ringTail.load(memory_order_acquire);
+		if(head - tail == (unsigned int)INPUT_RING_SIZE)
+		{
+			input->m_droppedSamples.fetch_add(1, memory_order_relaxed);
+		}
+		else
+		{
+			input->m_ring[head % INPUT_RING_SIZE] = sample;
+			input->m_ringHead.store(head + 1, memory_order_release);
+		}
 
-bool InputClass::IsF3Pressed()
-{
-	if (m_keyboardState[DIK_F3] & 0x80)
-	{
-		return true;
+		// Sample at a steady rate whatever the read took.
+		next += chrono::microseconds(INPUT_SAMPLE_INTERVAL);
+		this_thread::sleep_until(next);
 	}
 
-	return false;
-}
+	return;
+}
\ No newline at end of file
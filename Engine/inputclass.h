@@ -22,10 +22,41 @@
 // INCLUDES //
 //////////////
 #include <dinput.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+using namespace std;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "inputsnapshotclass.h"
+#include "cpuprofilerclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const bool INPUT_THREAD_ENABLED = false;
+const int INPUT_SAMPLE_INTERVAL = 1000;
+const int INPUT_RING_SIZE = 256;
+
+// The DirectInput key code of every key of the snapshot, in the order of its key enum.
+const unsigned char INPUT_KEY_CODES[InputSnapshotClass::KEY_COUNT] =
+{
+	DIK_ESCAPE, DIK_A, DIK_D, DIK_W, DIK_S, DIK_I, DIK_K, DIK_J, DIK_L, DIK_F1, DIK_F2, DIK_F3
+};
 
 
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: InputClass
+//
+// Reads the keyboard and the mouse once a frame into an input snapshot, which is all the rest of the engine sees of
+// the input.  With the input thread on, a thread of its own samples the devices every INPUT_SAMPLE_INTERVAL
+// microseconds into a ring that one thread writes and one thread reads without a lock, and the frame takes every
+// sample since the last frame into the snapshot.  A sample that finds the ring full is dropped and counted.
 ////////////////////////////////////////////////////////////////////////////////
 class InputClass
 {
@@ -38,25 +69,17 @@ public:
 	void Shutdown();
 	bool Frame();
 
+	const InputSnapshotClass& GetSnapshot();
 	void GetMouseLocation(int&, int&);
-
-	bool IsEscapePressed();
-	bool IsAPressed();
-	bool IsDPressed();
-	bool IsWPressed();
-	bool IsSPressed();
-	bool IsIPressed();
-	bool IsKPressed();
-	bool IsJPressed();
-	bool IsLPressed();
-	bool IsF1Pressed();
-	bool IsF2Pressed();
-	bool IsF3Pressed();
+	int GetDroppedSampleCount();
 
 private:
 	bool ReadKeyboard();
 	bool ReadMouse();
+	bool ReadSample(InputSnapshotClass::SampleType&);
 	void ProcessInput();
+	double GetTime();
+	static void SampleThread(InputClass*);
 
 private:
 	IDirectInput8* m_directInput;
@@ -68,6 +91,16 @@ private:
 
 	int m_screenWidth, m_screenHeight;
 	int m_mouseX, m_mouseY;
+
+	InputSnapshotClass m_snapshot;
+	unsigned int m_frame;
+	chrono::steady_clock::time_point m_startTime;
+
+	thread m_thread;
+	atomic<bool> m_threadRunning, m_threadFailed;
+	InputSnapshotClass::SampleType m_ring[INPUT_RING_SIZE];
+	atomic<unsigned int> m_ringHead, m_ringTail;
+	atomic<int> m_droppedSamples;
 };
 
 #endif
\ No newline at end of file
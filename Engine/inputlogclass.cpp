@@ -0,0 +1,292 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: inputlogclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "inputlogclass.h"
+
+
+InputLogClass::InputLogClass()
+{
+	memset(m_camera, 0, sizeof(m_camera));
+	m_frame = 0;
+	m_recording = false;
+	m_replaying = false;
+}
+
+
+InputLogClass::InputLogClass(const InputLogClass& other)
+{
+}
+
+
+InputLogClass::~InputLogClass()
+{
+}
+
+
+bool InputLogClass::StartRecording(const char* filename, float positionX, float positionY, float positionZ, float rotationX, float rotationY, float rotationZ)
+{
+	unsigned int version;
+
+
+	Shutdown();
+
+	m_fout.open(filename, ios::out | ios::binary);
+	if(m_fout.fail())
+	{
+		return false;
+	}
+
+	// Write the header with the pose of the viewer the recording starts from.
+	m_camera[0] = positionX;
+	m_camera[1] = positionY;
+	m_camera[2] = positionZ;
+	m_camera[3] = rotationX;
+	m_camera[4] = rotationY;
+	m_camera[5] = rotationZ;
+
+	version = INPUT_LOG_VERSION;
+	m_fout.write(INPUT_LOG_MAGIC, sizeof(INPUT_LOG_MAGIC));
+	m_fout.write((const char*)&version, sizeof(version));
+	m_fout.write((const char*)m_camera, sizeof(m_camera));
+	if(m_fout.fail())
+	{
+		m_fout.close();
+		return false;
+	}
+
+	m_frame = 0;
+	m_recording = true;
+
+	return true;
+}
+
+
+bool InputLogClass::StartReplay(const char* filename)
+{
+	ifstream fin;
+	char magic[4];
+	unsigned int version;
+	bool result;
+
+
+	Shutdown();
+
+	fin.open(filename, ios::in | ios::binary);
+	if(fin.fail())
+	{
+		return false;
+	}
+
+	// Check the header is one this version of the log can play.
+	fin.read(magic, sizeof(magic));
+	fin.read((char*)&version, sizeof(version));
+	fin.read((char*)m_camera, sizeof(m_camera));
+	if(fin.fail() || memcmp(magic, INPUT_LOG_MAGIC, sizeof(magic)) != 0 || version != INPUT_LOG_VERSION)
+	{
+		return false;
+	}
+
+	// Read every frame up front.
+	result = ReadFrames(fin);
+	if(!result)
+	{
+		m_frames.clear();
+		m_samples.clear();
+		return false;
+	}
+
+	m_frame = 0;
+	m_replaying = true;
+
+	return true;
+}
+
+
+void InputLogClass::Shutdown()
+{
+	if(m_fout.is_open())
+	{
+		m_fout.close();
+	}
+
+	m_frames.clear();
+	m_frames.shrink_to_fit();
+	m_samples.clear();
+	m_samples.shrink_to_fit();
+	m_recording = false;
+	m_replaying = false;
+
+	return;
+}
+
+
+bool InputLogClass::IsRecording()
+{
+	return m_recording;
+}
+
+
+bool InputLogClass::IsReplaying()
+{
+	return m_replaying;
+}
+
+
+bool InputLogClass::RecordFrame(const InputSnapshotClass& snapshot, float frameTime)
+{
+	const InputSnapshotClass::SampleType* sample;
+	unsigned short keys, sampleCount;
+	short mouseDeltaX, mouseDeltaY;
+	double time;
+	int mouseX, mouseY, i;
+
+
+	if(!m_recording)
+	{
+		return false;
+	}
+
+	// Write the frame time, the keys held going into the frame and where the mouse ended up.
+	time = snapshot.GetTime();
+	keys = (unsigned short)snapshot.GetBaseKeys();
+	snapshot.GetMouseLocation(mouseX, mouseY);
+	sampleCount = (unsigned short)snapshot.GetSampleCount();
+
+	m_fout.write((const char*)&frameTime, sizeof(frameTime));
+	m_fout.write((const char*)&time, sizeof(time));
+	m_fout.write((const char*)&keys, sizeof(keys));
+	m_fout.write((const char*)&mouseX, sizeof(mouseX));
+	m_fout.write((const char*)&mouseY, sizeof(mouseY));
+	m_fout.write((const char*)&sampleCount, sizeof(sampleCount));
+
+	// Write the samples, a mouse movement past the range of a short is clamped.
+	for(i=0; i<sampleCount; i++)
+	{
+		sample = &snapshot.GetSample(i);
+		keys = (unsigned short)sample->keys;
+		mouseDeltaX = (short)max(-32768, min(sample->mouseDeltaX, 32767));
+		mouseDeltaY = (short)max(-32768, min(sample->mouseDeltaY, 32767));
+
+		m_fout.write((const char*)&sample->time, sizeof(sample->time));
+		m_fout.write((const char*)&keys, sizeof(keys));
+		m_fout.write((const char*)&mouseDeltaX, sizeof(mouseDeltaX));
+		m_fout.write((const char*)&mouseDeltaY, sizeof(mouseDeltaY));
+	}
+
+	if(m_fout.fail())
+	{
+		return false;
+	}
+
+	m_frame++;
+
+	return true;
+}
+
+
+bool InputLogClass::ReplayFrame(float& frameTime)
+{
+	const FrameType* frame;
+	int i;
+
+
+	// The replay is over once every frame was played.
+	if(!m_replaying || m_frame >= (int)m_frames.size())
+	{
+		m_replaying = false;
+		return false;
+	}
+
+	// Build the snapshot of the frame from the log just as the input object built it.
+	frame = &m_frames[m_frame];
+
+	m_snapshot.Begin((unsigned int)m_frame, frame->baseKeys);
+	for(i=0; i<frame->sampleCount; i++)
+	{
+		m_snapshot.AddSample(m_samples[frame->firstSample + i]);
+	}
+	m_snapshot.End(frame->time, frame->mouseX, frame->mouseY);
+
+	frameTime = frame->frameTime;
+	m_frame++;
+
+	return true;
+}
+
+
+const InputSnapshotClass& InputLogClass::GetSnapshot()
+{
+	return m_snapshot;
+}
+
+
+void InputLogClass::GetStartCamera(float& positionX, float& positionY, float& positionZ, float& rotationX, float& rotationY, float& rotationZ)
+{
+	positionX = m_camera[0];
+	positionY = m_camera[1];
+	positionZ = m_camera[2];
+	rotationX = m_camera[3];
+	rotationY = m_camera[4];
+	rotationZ = m_camera[5];
+	return;
+}
+
+
+int InputLogClass::GetFrameCount()
+{
+	return m_recording ? m_frame : (int)m_frames.size();
+}
+
+
+bool InputLogClass::ReadFrames(ifstream& fin)
+{
+	FrameType frame;
+	InputSnapshotClass::SampleType sample;
+	unsigned short keys, sampleCount;
+	short mouseDeltaX, mouseDeltaY;
+	int i;
+
+
+	m_frames.clear();
+	m_samples.clear();
+
+	// Read frames until the end of the file, a frame cut short means the log is damaged.
+	while(fin.read((char*)&frame.frameTime, sizeof(frame.frameTime)))
+	{
+		fin.read((char*)&frame.time, sizeof(frame.time));
+		fin.read((char*)&keys, sizeof(keys));
+		fin.read((char*)&frame.mouseX, sizeof(frame.mouseX));
+		fin.read((char*)&frame.mouseY, sizeof(frame.mouseY));
+		fin.read((char*)&sampleCount, sizeof(sampleCount));
+		if(fin.fail() || sampleCount > INPUT_MAX_SAMPLES)
+		{
+			return false;
+		}
+
+		frame.baseKeys = keys;
+		frame.firstSample = (int)m_samples.size();
+		frame.sampleCount = sampleCount;
+
+		for(i=0; i<sampleCount; i++)
+		{
+			fin.read((char*)&sample.time, sizeof(sample.time));
+			fin.read((char*)&keys, sizeof(keys));
+			fin.read((char*)&mouseDeltaX, sizeof(mouseDeltaX));
+			fin.read((char*)&mouseDeltaY, sizeof(mouseDeltaY));
+			if(fin.fail())
+			{
+				return false;
+			}
+
+			sample.keys = keys;
+			sample.mouseDeltaX = mouseDeltaX;
+			sample.mouseDeltaY = mouseDeltaY;
+			m_samples.push_back(sample);
+		}
+
+		m_frames.push_back(frame);
+	}
+
+	// Only a clean end of the file ends the frames.
+	return fin.eof() && fin.gcount() == 0;
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: inputlogclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _INPUTLOGCLASS_H_
+#define _INPUTLOGCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <vector>
+using namespace std;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "inputsnapshotclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const char INPUT_LOG_MAGIC[4] = { 'I', 'L', 'O', 'G' };
+const unsigned int INPUT_LOG_VERSION = 1;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: InputLogClass
+//
+// Records the input snapshot and the frame time of every frame into a binary log, and plays a log back as the same
+// snapshots and frame times.  The log starts with the pose of the viewer so a replay starts where the recording did,
+// then each frame holds its frame time, the keys held going into it, the mouse location and its samples with the keys
+// packed into 16 bits.  The values are written as they are in memory, which is little endian on every platform the
+// engine runs on.  A replay reads the whole log up front so playing it back does no file access, and it needs nothing
+// of DirectInput so it also runs headless.
+////////////////////////////////////////////////////////////////////////////////
+class InputLogClass
+{
+private:
+	struct FrameType
+	{
+		float frameTime;
+		double time;
+		unsigned int baseKeys;
+		int mouseX, mouseY;
+		int firstSample, sampleCount;
+	};
+
+public:
+	InputLogClass();
+	InputLogClass(const InputLogClass&);
+	~InputLogClass();
+
+	bool StartRecording(const char*, float, float, float, float, float, float);
+	bool StartReplay(const char*);
+	void Shutdown();
+
+	bool IsRecording();
+	bool IsReplaying();
+
+	bool RecordFrame(const InputSnapshotClass&, float);
+	bool ReplayFrame(float&);
+	const InputSnapshotClass& GetSnapshot();
+
+	void GetStartCamera(float&, float&, float&, float&, float&, float&);
+	int GetFrameCount();
+
+private:
+	bool ReadFrames(ifstream&);
+
+private:
+	ofstream m_fout;
+	vector<FrameType> m_frames;
+	vector<InputSnapshotClass::SampleType> m_samples;
+	InputSnapshotClass m_snapshot;
+	float m_camera[6];
+	int m_frame;
+	bool m_recording, m_replaying;
+};
+
+#endif
\ No newline at end of file
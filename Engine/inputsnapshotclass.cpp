@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: inputsnapshotclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "inputsnapshotclass.h"
+
+
+InputSnapshotClass::InputSnapshotClass()
+{
+	m_frame = 0;
+	m_time = 0.0;
+	m_baseKeys = 0;
+	m_sampleCount = 0;
+	m_mouseX = 0;
+	m_mouseY = 0;
+	m_mouseDeltaX = 0;
+	m_mouseDeltaY = 0;
+}
+
+
+InputSnapshotClass::InputSnapshotClass(const InputSnapshotClass& other)
+{
+	int i;
+
+
+	m_frame = other.m_frame;
+	m_time = other.m_time;
+	m_baseKeys = other.m_baseKeys;
+	m_sampleCount = other.m_sampleCount;
+	for(i=0; i<m_sampleCount; i++)
+	{
+		m_samples[i] = other.m_samples[i];
+	}
+	m_mouseX = other.m_mouseX;
+	m_mouseY = other.m_mouseY;
+	m_mouseDeltaX = other.m_mouseDeltaX;
+	m_mouseDeltaY = other.m_mouseDeltaY;
+}
+
+
+InputSnapshotClass::~InputSnapshotClass()
+{
+}
+
+
+void InputSnapshotClass::Begin(unsigned int frame, unsigned int baseKeys)
+{
+	// The base keys are the ones held going into the frame, until its first sample.
+	m_baseKeys = baseKeys;
+	m_frame = frame;
+	m_sampleCount = 0;
+	m_mouseDeltaX = 0;
+	m_mouseDeltaY = 0;
+
+	return;
+}
+
+
+bool InputSnapshotClass::AddSample(const SampleType& sample)
+{
+	// A full snapshot folds the sample into the last one, so the newest state is never lost.
+	if(m_sampleCount == INPUT_MAX_SAMPLES)
+	{
+		m_samples[m_sampleCount - 1].time = sample.time;
+		m_samples[m_sampleCount - 1].keys |= sample.keys;
+		m_samples[m_sampleCount - 1].mouseDeltaX += sample.mouseDeltaX;
+		m_samples[m_sampleCount - 1].mouseDeltaY += sample.mouseDeltaY;
+		m_mouseDeltaX += sample.mouseDeltaX;
+		m_mouseDeltaY += sample.mouseDeltaY;
+		return false;
+	}
+
+	m_samples[m_sampleCount] = sample;
+	m_sampleCount++;
+
+	m_mouseDeltaX += sample.mouseDeltaX;
+	m_mouseDeltaY += sample.mouseDeltaY;
+
+	return true;
+}
+
+
+void InputSnapshotClass::End(double time, int mouseX, int mouseY)
+{
+	m_time = time;
+	m_mouseX = mouseX;
+	m_mouseY = mouseY;
+
+	return;
+}
+
+
+unsigned int InputSnapshotClass::GetFrame() const
+{
+	return m_frame;
+}
+
+
+double InputSnapshotClass::GetTime() const
+{
+	return m_time;
+}
+
+
+unsigned int InputSnapshotClass::GetBaseKeys() const
+{
+	return m_baseKeys;
+}
+
+
+unsigned int InputSnapshotClass::GetKeys() const
+{
+	return m_sampleCount > 0 ? m_samples[m_sampleCount - 1].keys : m_baseKeys;
+}
+
+
+unsigned int InputSnapshotClass::GetKeys(double from, double to) const
+{
+	unsigned int keys;
+	int i;
+
+
+	// Start from the keys held going into the window.
+	keys = m_baseKeys;
+	for(i=0; i<m_sampleCount && m_samples[i].time <= from; i++)
+	{
+		keys = m_samples[i].keys;
+	}
+
+	// Add every key that was down in a sample inside the window, a short tap still counts.
+	for(; i<m_sampleCount && m_samples[i].time <= to; i++)
+	{
+		keys |= m_samples[i].keys;
+	}
+
+	return keys;
+}
+
+
+bool InputSnapshotClass::IsKeyDown(KeyType key) const
+{
+	return (GetKeys() & GetKeyBit(key)) != 0;
+}
+
+
+int InputSnapshotClass::GetSampleCount() const
+{
+	return m_sampleCount;
+}
+
+
+const InputSnapshotClass::SampleType& InputSnapshotClass::GetSample(int index) const
+{
+	return m_samples[index];
+}
+
+
+void InputSnapshotClass::GetMouseLocation(int& mouseX, int& mouseY) const
+{
+	mouseX = m_mouseX;
+	mouseY = m_mouseY;
+	return;
+}
+
+
+void InputSnapshotClass::GetMouseDelta(int& mouseDeltaX, int& mouseDeltaY) const
+{
+	mouseDeltaX = m_mouseDeltaX;
+	mouseDeltaY = m_mouseDeltaY;
+	return;
+}
+
+
+unsigned int InputSnapshotClass::GetKeyBit(KeyType key)
+{
+	return 1u << (unsigned int)key;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: inputsnapshotclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _INPUTSNAPSHOTCLASS_H_
+#define _INPUTSNAPSHOTCLASS_H_
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int INPUT_MAX_SAMPLES = 64;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: InputSnapshotClass
+//
+// The input of one frame, read once and then only looked at.  The keys the engine uses are held as bits, together with
+// every sample taken since the last snapshot and the time each was taken at, so a fixed simulation step can ask which
+// keys were down during its own part of the frame.  A key counts as down in a window when it was down in any sample in
+// the window, or, with no sample in it, when it was down in the last sample before.  A snapshot holds nothing of
+// DirectInput, so it can be built without a window as well.
+////////////////////////////////////////////////////////////////////////////////
+class InputSnapshotClass
+{
+public:
+	enum KeyType
+	{
+		KEY_ESCAPE,
+		KEY_A,
+		KEY_D,
+		KEY_W,
+		KEY_S,
+		KEY_I,
+		KEY_K,
+		KEY_J,
+		KEY_L,
+		KEY_F1,
+		KEY_F2,
+		KEY_F3,
+		KEY_COUNT
+	};
+
+	struct SampleType
+	{
+		double time;
+		unsigned int keys;
+		int mouseDeltaX, mouseDeltaY;
+	};
+
+public:
+	InputSnapshotClass();
+	InputSnapshotClass(const InputSnapshotClass&);
+	~InputSnapshotClass();
+
+	void Begin(unsigned int, unsigned int);
+	bool AddSample(const SampleType&);
+	void End(double, int, int);
+
+	unsigned int GetFrame() const;
+	double GetTime() const;
+	unsigned int GetBaseKeys() const;
+	unsigned int GetKeys() const;
+	unsigned int GetKeys(double, double) const;
+	bool IsKeyDown(KeyType) const;
+	int GetSampleCount() const;
+	const SampleType& GetSample(int) const;
+	void GetMouseLocation(int&, int&) const;
+	void GetMouseDelta(int&, int&) const;
+
+	static unsigned int GetKeyBit(KeyType);
+
+private:
+	unsigned int m_frame;
+	double m_time;
+	unsigned int m_baseKeys;
+	SampleType m_samples[INPUT_MAX_SAMPLES];
+	int m_sampleCount;
+	int m_mouseX, m_mouseY;
+	int m_mouseDeltaX, m_mouseDeltaY;
+};
+
+#endif
\ No newline at end of file
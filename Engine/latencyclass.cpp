@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: latencyclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "latencyclass.h"
+
+
+LatencyClass::LatencyClass()
+{
+	m_frameOpen = false;
+	m_inputRead = false;
+	m_frameCount = 0;
+	m_waitTime = 0.0f;
+	m_latency = 0.0f;
+}
+
+
+LatencyClass::LatencyClass(const LatencyClass& other)
+{
+}
+
+
+LatencyClass::~LatencyClass()
+{
+}
+
+
+bool LatencyClass::Initialize(const char* filename)
+{
+	bool result;
+
+
+	result = m_statistics.Initialize(FRAME_STATS_HISTORY, FRAME_STATS_BUDGET);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Open the file the frames are written to as they end, the times are in milliseconds.
+	m_fout.open(filename, ios::out);
+	if(m_fout.fail())
+	{
+		return false;
+	}
+
+	m_fout << "frame,wait,latency" << endl;
+
+	m_frameOpen = false;
+	m_inputRead = false;
+	m_frameCount = 0;
+
+	return true;
+}
+
+
+void LatencyClass::Shutdown()
+{
+	if(m_fout.is_open())
+	{
+		m_fout.close();
+	}
+
+	m_statistics.Shutdown();
+
+	return;
+}
+
+
+void LatencyClass::BeginFrame()
+{
+	// The frame starts before it waits on the swap chain.
+	m_frameStart = chrono::steady_clock::now();
+	m_frameOpen = true;
+	m_inputRead = false;
+
+	return;
+}
+
+
+void LatencyClass::MarkInput()
+{
+	// A frame that was not begun has no wait.
+	m_inputTime = chrono::steady_clock::now();
+	if(!m_frameOpen)
+	{
+		m_frameStart = m_inputTime;
+	}
+
+	m_inputRead = true;
+
+	return;
+}
+
+
+void LatencyClass::MarkPresent()
+{
+	chrono::steady_clock::time_point presentTime;
+
+
+	if(!m_inputRead)
+	{
+		return;
+	}
+
+	presentTime = chrono::steady_clock::now();
+
+	m_waitTime = chrono::duration<float, milli>(m_inputTime - m_frameStart).count();
+	m_latency = chrono::duration<float, milli>(presentTime - m_inputTime).count();
+
+	m_statistics.AddFrame(m_latency);
+
+	// Write the frame out straight away.  The file is buffered, so it is not flushed each frame.
+	if(m_fout.is_open())
+	{
+		m_fout << m_frameCount << "," << m_waitTime << "," << m_latency << "\n";
+	}
+
+	m_frameCount++;
+	m_frameOpen = false;
+	m_inputRead = false;
+
+	return;
+}
+
+
+float LatencyClass::GetLastWaitTime()
+{
+	return m_waitTime;
+}
+
+
+float LatencyClass::GetLastLatency()
+{
+	return m_latency;
+}
+
+
+FrameStatsClass* LatencyClass::GetStatistics()
+{
+	return &m_statistics;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: latencyclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _LATENCYCLASS_H_
+#define _LATENCYCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <chrono>
+#include <fstream>
+using namespace std;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "framestatsclass.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: LatencyClass
+//
+// Measures every frame from the moment the input is read to the moment Present returns, which is the part of the
+// input to photon latency the engine controls, along with how long the frame waited on the swap chain before that.
+// Each frame is written to a file as it ends and kept in the statistics for the percentiles.
+////////////////////////////////////////////////////////////////////////////////
+class LatencyClass
+{
+public:
+	LatencyClass();
+	LatencyClass(const LatencyClass&);
+	~LatencyClass();
+
+	bool Initialize(const char*);
+	void Shutdown();
+
+	void BeginFrame();
+	void MarkInput();
+	void MarkPresent();
+
+	float GetLastWaitTime();
+	float GetLastLatency();
+	FrameStatsClass* GetStatistics();
+
+private:
+	ofstream m_fout;
+	FrameStatsClass m_statistics;
+	chrono::steady_clock::time_point m_frameStart, m_inputTime;
+	bool m_frameOpen, m_inputRead;
+	int m_frameCount;
+	float m_waitTime, m_latency;
+};
+
+#endif
\ No newline at end of file
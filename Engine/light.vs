@@ -30,19 +30,32 @@ struct VertexInputType
 	float3 normal : NORMAL;
 };
 
+struct InstanceInputType
+{
+    float4 position : POSITION;
+    float2 tex : TEXCOORD0;
+	float3 normal : NORMAL;
+	float4 world0 : WORLD0;
+	float4 world1 : WORLD1;
+	float4 world2 : WORLD2;
+	float4 world3 : WORLD3;
+};
+
 struct PixelInputType
 {
     float4 position : SV_POSITION;
     float2 tex : TEXCOORD0;
 	float3 normal : NORMAL;
 	float3 viewDirection : TEXCOORD1;
+	float3 worldPosition : TEXCOORD2;
+	float viewDepth : TEXCOORD3;
 };
 
 
 ////////////////////////////////////////////////////////////////////////////////
 // Vertex Shader
 ////////////////////////////////////////////////////////////////////////////////
-PixelInputType LightVertexShader(VertexInputType input)
+PixelInputType TransformVertex(VertexInputType input, matrix world)
 {
     PixelInputType output;
 	float4 worldPosition;
@@ -52,7 +65,7 @@ PixelInputType LightVertexShader(VertexInputType input)
     input.position.w = 1.0f;
 
 	// Calculate the position of the vertex against the world, view, and projection matrices.
-    output.position = mul(input.position, worldMatrix);
+    output.position = mul(input.position, world);
     output.position = mul(output.position, viewMatrix);
     output.position = mul(output.position, projectionMatrix);
     
@@ -60,13 +73,13 @@ PixelInputType LightVertexShader(VertexInputType input)
 	output.tex = input.tex;
     
 	// Calculate the normal vector against the world matrix only.
-    output.normal = mul(input.normal, (float3x3)worldMatrix);
+    output.normal = mul(input.normal, (float3x3)world);
 	
     // Normalize the normal vector.
     output.normal = normalize(output.normal);
 
 	// Calculate the position of the vertex in the world.
-    worldPosition = mul(input.position, worldMatrix);
+    worldPosition = mul(input.position, world);
 
     // Determine the viewing direction based on the position of the camera and the position of the vertex in the world.
     output.viewDirection = cameraPosition.xyz - worldPosition.xyz;
@@ -74,5 +87,32 @@ PixelInputType LightVertexShader(VertexInputType input)
     // Normalize the viewing direction vector.
     output.viewDirection = normalize(output.viewDirection);
 
+	// Pass on the world position and the view depth so the pixel shader can find its cluster of point lights.
+	output.worldPosition = worldPosition.xyz;
+	output.viewDepth = mul(worldPosition, viewMatrix).z;
+
     return output;
+}
+
+
+PixelInputType LightVertexShader(VertexInputType input)
+{
+	return TransformVertex(input, worldMatrix);
+}
+
+
+PixelInputType LightInstancedVertexShader(InstanceInputType input)
+{
+	VertexInputType vertex;
+	matrix instanceWorld;
+
+
+	// Place the model with the world matrix of its instance in front of the world matrix of the draw.
+	instanceWorld = mul(float4x4(input.world0, input.world1, input.world2, input.world3), worldMatrix);
+
+	vertex.position = input.position;
+	vertex.tex = input.tex;
+	vertex.normal = input.normal;
+
+	return TransformVertex(vertex, instanceWorld);
 }
\ No newline at end of file
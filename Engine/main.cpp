@@ -7,9 +7,33 @@
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pScmdline, int iCmdshow)
 {
 	SystemClass* System;
+	ShaderCacheClass* ShaderCache;
 	bool result;
 	
 	
+	// The post build step runs the engine with -buildshaders to compile every shader into the cache ahead of the first
+	// launch, the exit code fails the build when a shader does not compile and the build prints the log.
+	if(strcmp(pScmdline, "-buildshaders") == 0)
+	{
+		ShaderCache = new ShaderCacheClass;
+		if(!ShaderCache)
+		{
+			return 1;
+		}
+
+		result = ShaderCache->Initialize(L"../Engine/shadercache");
+		if(result)
+		{
+			result = ShaderCache->BuildList("../Engine/data/shaders.txt", "../Engine/shadercache/build.log");
+		}
+
+		ShaderCache->Shutdown();
+		delete ShaderCache;
+		ShaderCache = 0;
+
+		return result ? 0 : 1;
+	}
+
 	// Create the system object.
 	System = new SystemClass;
 	if(!System)
@@ -17,8 +41,33 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pScmdline,
 		return 0;
 	}
 
-	// Initialize and run the system object.
+	// Initialize the system object.
 	result = System->Initialize();
+
+	// Run the scripted flythrough instead of taking the camera from the user when asked to.
+	if(result && strcmp(pScmdline, "-benchmark") == 0)
+	{
+		result = System->StartBenchmark();
+	}
+
+	// Write out the latency of every frame when asked to.
+	if(result && strcmp(pScmdline, "-latency") == 0)
+	{
+		result = System->StartLatencyMeasurement();
+	}
+
+	// Record the input of the run, or play a recorded run back, when asked to.
+	if(result && strcmp(pScmdline, "-record") == 0)
+	{
+		result = System->StartInputRecording();
+	}
+
+	if(result && strcmp(pScmdline, "-replay") == 0)
+	{
+		result = System->StartInputReplay();
+	}
+
+	// Run the system object.
 	if(result)
 	{
 		System->Run();
@@ -6,8 +6,10 @@
 
 ModelClass::ModelClass()
 {
+	m_Device = 0;
 	m_vertexBuffer = 0;
 	m_indexBuffer = 0;
+	m_positionBuffer = 0;
 	m_Texture = 0;
 	m_model = 0;
 }
@@ -23,11 +25,14 @@ ModelClass::~ModelClass()
 }
 
 
-bool ModelClass::Initialize(ID3D11Device* device, char* modelFilename, WCHAR* textureFilename)
+bool ModelClass::Initialize(RenderDeviceClass* device, char* modelFilename, const wchar_t* textureFilename)
 {
 	bool result;
 
 
+	// Store the device the buffers and texture are created on.
+	m_Device = device;
+
 	// Load in the model data,
 	result = LoadModel(modelFilename);
 	if(!result)
@@ -36,14 +41,14 @@ bool ModelClass::Initialize(ID3D11Device* device, char* modelFilename, WCHAR* te
 	}
 
 	// Initialize the vertex and index buffers.
-	result = InitializeBuffers(device);
+	result = InitializeBuffers();
 	if(!result)
 	{
 		return false;
 	}
 
 	// Load the texture for this model.
-	result = LoadTexture(device, textureFilename);
+	result = LoadTexture(textureFilename);
 	if(!result)
 	{
 		return false;
@@ -68,10 +73,19 @@ void ModelClass::Shutdown()
 }
 
 
-void ModelClass::Render(ID3D11DeviceContext* deviceContext)
+void ModelClass::Render()
 {
 	// Put the vertex and index buffers on the graphics pipeline to prepare them for drawing.
-	RenderBuffers(deviceContext);
+	RenderBuffers();
+
+	return;
+}
+
+
+void ModelClass::RenderPositions()
+{
+	// Put the position only vertex stream and the index buffer on the pipeline for the depth prepass.
+	RenderPositionBuffers();
 
 	return;
 }
@@ -83,19 +97,17 @@ int ModelClass::GetIndexCount()
 }
 
 
-ID3D11ShaderResourceView* ModelClass::GetTexture()
+int ModelClass::GetTexture()
 {
 	return m_Texture->GetTexture();
 }
 
 
-bool ModelClass::InitializeBuffers(ID3D11Device* device)
+bool ModelClass::InitializeBuffers()
 {
 	VertexType* vertices;
-	unsigned long* indices;
-	D3D11_BUFFER_DESC vertexBufferDesc, indexBufferDesc;
-    D3D11_SUBRESOURCE_DATA vertexData, indexData;
-	HRESULT result;
+	XMFLOAT3* positions;
+	unsigned int* indices;
 	int i;
 
 
@@ -106,8 +118,15 @@ bool ModelClass::InitializeBuffers(ID3D11Device* device)
 		return false;
 	}
 
+	// Create the position only array used by the depth prepass.
+	positions = new XMFLOAT3[m_vertexCount];
+	if(!positions)
+	{
+		return false;
+	}
+
 	// Create the index array.
-	indices = new unsigned long[m_indexCount];
+	indices = new unsigned int[m_indexCount];
 	if(!indices)
 	{
 		return false;
@@ -120,45 +139,29 @@ bool ModelClass::InitializeBuffers(ID3D11Device* device)
 		vertices[i].texture = XMFLOAT2(m_model[i].tu, m_model[i].tv);
 		vertices[i].normal = XMFLOAT3(m_model[i].nx, m_model[i].ny, m_model[i].nz);
 
+		positions[i] = XMFLOAT3(m_model[i].x, m_model[i].y, m_model[i].z);
+
 		indices[i] = i;
 	}
 
-	// Set up the description of the static vertex buffer.
-    vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-    vertexBufferDesc.ByteWidth = sizeof(VertexType) * m_vertexCount;
-    vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-    vertexBufferDesc.CPUAccessFlags = 0;
-    vertexBufferDesc.MiscFlags = 0;
-	vertexBufferDesc.StructureByteStride = 0;
-
-	// Give the subresource structure a pointer to the vertex data.
-    vertexData.pSysMem = vertices;
-	vertexData.SysMemPitch = 0;
-	vertexData.SysMemSlicePitch = 0;
-
-	// Now create the vertex buffer.
-    result = device->CreateBuffer(&vertexBufferDesc, &vertexData, &m_vertexBuffer);
-	if(FAILED(result))
+	// Now create the static vertex buffer.
+	m_vertexBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_VERTEX_BUFFER, vertices, sizeof(VertexType) * m_vertexCount);
+	if(!m_vertexBuffer)
+	{
+		return false;
+	}
+
+	// Create the static position only vertex buffer.  Keeping the positions in their own tightly packed stream means the
+	// depth prepass only fetches 12 bytes per vertex instead of the full 32 byte vertex.
+	m_positionBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_VERTEX_BUFFER, positions, sizeof(XMFLOAT3) * m_vertexCount);
+	if(!m_positionBuffer)
 	{
 		return false;
 	}
 
-	// Set up the description of the static index buffer.
-    indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-    indexBufferDesc.ByteWidth = sizeof(unsigned long) * m_indexCount;
-    indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-    indexBufferDesc.CPUAccessFlags = 0;
-    indexBufferDesc.MiscFlags = 0;
-	indexBufferDesc.StructureByteStride = 0;
-
-	// Give the subresource structure a pointer to the index data.
-    indexData.pSysMem = indices;
-	indexData.SysMemPitch = 0;
-	indexData.SysMemSlicePitch = 0;
-
-	// Create the index buffer.
-	result = device->CreateBuffer(&indexBufferDesc, &indexData, &m_indexBuffer);
-	if(FAILED(result))
+	// Create the static index buffer.
+	m_indexBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_INDEX_BUFFER, indices, sizeof(unsigned int) * m_indexCount);
+	if(!m_indexBuffer)
 	{
 		return false;
 	}
@@ -167,6 +170,9 @@ bool ModelClass::InitializeBuffers(ID3D11Device* device)
 	delete [] vertices;
 	vertices = 0;
 
+	delete [] positions;
+	positions = 0;
+
 	delete [] indices;
 	indices = 0;
 
@@ -179,14 +185,21 @@ void ModelClass::ShutdownBuffers()
 	// Release the index buffer.
 	if(m_indexBuffer)
 	{
-		m_indexBuffer->Release();
+		m_Device->ReleaseResource(m_indexBuffer);
 		m_indexBuffer = 0;
 	}
 
+	// Release the position vertex buffer.
+	if(m_positionBuffer)
+	{
+		m_Device->ReleaseResource(m_positionBuffer);
+		m_positionBuffer = 0;
+	}
+
 	// Release the vertex buffer.
 	if(m_vertexBuffer)
 	{
-		m_vertexBuffer->Release();
+		m_Device->ReleaseResource(m_vertexBuffer);
 		m_vertexBuffer = 0;
 	}
 
@@ -194,31 +207,33 @@ void ModelClass::ShutdownBuffers()
 }
 
 
-void ModelClass::RenderBuffers(ID3D11DeviceContext* deviceContext)
+void ModelClass::RenderBuffers()
 {
-	unsigned int stride;
-	unsigned int offset;
+	// Set the vertex buffer to active in the input assembler so it can be rendered.
+	m_Device->SetVertexBuffer(m_vertexBuffer, sizeof(VertexType));
 
+	// Set the index buffer to active in the input assembler so it can be rendered.
+	m_Device->SetIndexBuffer(m_indexBuffer);
+
+	return;
+}
 
-	// Set vertex buffer stride and offset.
-	stride = sizeof(VertexType); 
-	offset = 0;
-    
-	// Set the vertex buffer to active in the input assembler so it can be rendered.
-	deviceContext->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
 
-    // Set the index buffer to active in the input assembler so it can be rendered.
-	deviceContext->IASetIndexBuffer(m_indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+void ModelClass::RenderPositionBuffers()
+{
+	// Set the position only vertex buffer to active in the input assembler.
+	m_Device->SetVertexBuffer(m_positionBuffer, sizeof(XMFLOAT3));
 
-    // Set the type of primitive that should be rendered from this vertex buffer, in this case triangles.
-	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	// Set the index buffer to active in the input assembler so it can be rendered.
+	m_Device->SetIndexBuffer(m_indexBuffer);
 
 	return;
 }
 
 
-bool ModelClass::LoadTexture(ID3D11Device* device, WCHAR* filename)
+bool ModelClass::LoadTexture(const wchar_t* filename)
 {
+	CpuZoneClass zone("LoadTexture");
 	bool result;
 
 
@@ -230,7 +245,7 @@ bool ModelClass::LoadTexture(ID3D11Device* device, WCHAR* filename)
 	}
 
 	// Initialize the texture object.
-	result = m_Texture->Initialize(device, filename);
+	result = m_Texture->Initialize(m_Device, filename);
 	if(!result)
 	{
 		return false;
@@ -256,6 +271,7 @@ void ModelClass::ReleaseTexture()
 
 bool ModelClass::LoadModel(char* filename)
 {
+	CpuZoneClass zone("LoadModel");
 	ifstream fin;
 	char input;
 	int i;
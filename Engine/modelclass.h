@@ -8,7 +8,6 @@
 //////////////
 // INCLUDES //
 //////////////
-#include <d3d11_1.h>
 #include <DirectXMath.h> 
 using namespace DirectX;
 
@@ -19,7 +18,9 @@ using namespace std;
 ///////////////////////
 // MY CLASS INCLUDES //
 ///////////////////////
+#include "renderdeviceclass.h"
 #include "textureclass.h"
+#include "cpuprofilerclass.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -47,26 +48,29 @@ public:
 	ModelClass(const ModelClass&);
 	~ModelClass();
 
-	bool Initialize(ID3D11Device*, char*, WCHAR*);
+	bool Initialize(RenderDeviceClass*, char*, const wchar_t*);
 	void Shutdown();
-	void Render(ID3D11DeviceContext*);
+	void Render();
+	void RenderPositions();
 
 	int GetIndexCount();
-	ID3D11ShaderResourceView* GetTexture();
+	int GetTexture();
 
 private:
-	bool InitializeBuffers(ID3D11Device*);
+	bool InitializeBuffers();
 	void ShutdownBuffers();
-	void RenderBuffers(ID3D11DeviceContext*);
+	void RenderBuffers();
+	void RenderPositionBuffers();
 
-	bool LoadTexture(ID3D11Device*, WCHAR*);
+	bool LoadTexture(const wchar_t*);
 	void ReleaseTexture();
 
 	bool LoadModel(char*);
 	void ReleaseModel();
 
 private:
-	ID3D11Buffer *m_vertexBuffer, *m_indexBuffer;
+	RenderDeviceClass* m_Device;
+	int m_vertexBuffer, m_indexBuffer, m_positionBuffer;
 	int m_vertexCount, m_indexCount;
 	TextureClass* m_Texture;
 	ModelType* m_model;
@@ -0,0 +1,795 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: nulldeviceclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "nulldeviceclass.h"
+
+
+NullDeviceClass::NullDeviceClass()
+{
+	m_screenWidth = 0;
+	m_screenHeight = 0;
+	m_targetWidth = 0;
+	m_targetHeight = 0;
+	m_frameCount = 0;
+	m_renderTargetCount = 0;
+	m_depthTarget = 0;
+	m_targetConflicts = 0;
+	m_timestamp = 0;
+	m_timestampFrequency = NULL_TIMESTAMP_FREQUENCY;
+	m_queryLatency = NULL_QUERY_LATENCY;
+}
+
+
+NullDeviceClass::NullDeviceClass(const NullDeviceClass& other)
+{
+}
+
+
+NullDeviceClass::~NullDeviceClass()
+{
+}
+
+
+bool NullDeviceClass::Initialize(int screenWidth, int screenHeight, float screenDepth, float screenNear, bool reverseDepth)
+{
+	float fieldOfView, screenAspect;
+
+
+	if(screenWidth <= 0 || screenHeight <= 0)
+	{
+		return false;
+	}
+
+	// Build the same matrices as the Direct3D backend so the renderer sees identical transforms.
+	fieldOfView = (float)XM_PI / 4.0f;
+	screenAspect = (float)screenWidth / (float)screenHeight;
+
+	m_reverseDepth = reverseDepth;
+	XMStoreFloat4x4(&m_projectionMatrix, BuildProjectionMatrix(fieldOfView, screenAspect, screenNear, screenDepth, reverseDepth));
+	XMStoreFloat4x4(&m_worldMatrix, XMMatrixIdentity());
+	XMStoreFloat4x4(&m_orthoMatrix, XMMatrixOrthographicLH((float)screenWidth, (float)screenHeight, screenNear, screenDepth));
+
+	m_screenWidth = screenWidth;
+	m_screenHeight = screenHeight;
+	m_targetWidth = screenWidth;
+	m_targetHeight = screenHeight;
+	m_frameCount = 0;
+	m_renderTargetCount = 0;
+	m_depthTarget = 0;
+	m_targetConflicts = 0;
+	m_timestamp = 0;
+	ResetStatistics();
+
+	return true;
+}
+
+
+void NullDeviceClass::Shutdown()
+{
+	ClearPipelines();
+	m_resources.clear();
+	m_commands.clear();
+
+	return;
+}
+
+
+void NullDeviceClass::BeginScene(float red, float green, float blue, float alpha)
+{
+	// Start a new command list for this frame.
+	m_commands.clear();
+	AddCommand(COMMAND_BEGIN_SCENE, 0, 0, 0);
+	m_targetConflicts = 0;
+
+	return;
+}
+
+
+void NullDeviceClass::EndScene()
+{
+	AddCommand(COMMAND_END_SCENE, 0, 0, 0);
+	m_frameCount++;
+
+	return;
+}
+
+
+int NullDeviceClass::CreateBuffer(ResourceType type, const void* data, int bytes)
+{
+	if(bytes <= 0)
+	{
+		return 0;
+	}
+
+	// Static buffers must be created with their contents, constant and instance buffers are filled later.
+	if(type != RESOURCE_CONSTANT_BUFFER && type != RESOURCE_INSTANCE_BUFFER && !data)
+	{
+		return 0;
+	}
+
+	if(type != RESOURCE_VERTEX_BUFFER && type != RESOURCE_INDEX_BUFFER && type != RESOURCE_CONSTANT_BUFFER && type != RESOURCE_INSTANCE_BUFFER)
+	{
+		return 0;
+	}
+
+	return AddResource(type, bytes);
+}
+
+
+bool NullDeviceClass::UpdateBuffer(int handle, const void* data, int bytes)
+{
+	// Only the constant, structured and instance buffers can be rewritten and never past their end.
+	if((!IsResource(handle, RESOURCE_CONSTANT_BUFFER) && !IsResource(handle, RESOURCE_STRUCTURED_BUFFER) &&
+		!IsResource(handle, RESOURCE_INSTANCE_BUFFER)) || !data || bytes > m_resources[handle - 1].bytes)
+	{
+		return false;
+	}
+
+	AddCommand(COMMAND_UPDATE_BUFFER, handle, bytes, 0);
+
+	m_statistics.bufferUpdates++;
+	m_statistics.bufferUpdateBytes += bytes;
+
+	return true;
+}
+
+
+int NullDeviceClass::CreateTexture(const wchar_t* filename)
+{
+	int bytes;
+
+
+	// There are no texels to upload so the texture is only measured, but a missing file fails the same as on the GPU.
+	bytes = GetFileBytes(filename);
+	if(bytes < 0)
+	{
+		return 0;
+	}
+
+	return AddResource(RESOURCE_TEXTURE, bytes);
+}
+
+
+int NullDeviceClass::CreateVertexShader(const wchar_t* filename, const char* entryPoint, VertexFormatType format)
+{
+	int bytes;
+
+
+	// The shader source must exist even though it is never compiled.
+	bytes = GetFileBytes(filename);
+	if(bytes < 0 || !entryPoint)
+	{
+		return 0;
+	}
+
+	return AddResource(RESOURCE_VERTEX_SHADER, bytes);
+}
+
+
+int NullDeviceClass::CreatePixelShader(const wchar_t* filename, const char* entryPoint)
+{
+	int bytes;
+
+
+	// The shader source must exist even though it is never compiled.
+	bytes = GetFileBytes(filename);
+	if(bytes < 0 || !entryPoint)
+	{
+		return 0;
+	}
+
+	return AddResource(RESOURCE_PIXEL_SHADER, bytes);
+}
+
+
+int NullDeviceClass::CreateSampler()
+{
+	return AddResource(RESOURCE_SAMPLER, 0);
+}
+
+
+int NullDeviceClass::CreateStructuredBuffer(int elementBytes, int elementCount)
+{
+	if(elementBytes <= 0 || elementCount <= 0)
+	{
+		return 0;
+	}
+
+	return AddResource(RESOURCE_STRUCTURED_BUFFER, elementBytes * elementCount);
+}
+
+
+int NullDeviceClass::CreateRenderTarget(int width, int height, RenderTargetFormatType format)
+{
+	int handle;
+
+
+	if(width <= 0 || height <= 0 || GetPixelBytes(format) == 0)
+	{
+		return 0;
+	}
+
+	handle = AddResource(RESOURCE_RENDER_TARGET, width * height * GetPixelBytes(format));
+	m_resources[handle - 1].width = width;
+	m_resources[handle - 1].height = height;
+	m_resources[handle - 1].format = format;
+
+	return handle;
+}
+
+
+int NullDeviceClass::CreateDepthTarget(int width, int height)
+{
+	int handle;
+
+
+	if(width <= 0 || height <= 0)
+	{
+		return 0;
+	}
+
+	// Depth targets are 32 bit float.
+	handle = AddResource(RESOURCE_DEPTH_TARGET, width * height * 4);
+	m_resources[handle - 1].width = width;
+	m_resources[handle - 1].height = height;
+
+	return handle;
+}
+
+
+int NullDeviceClass::CreateQuery(ResourceType type)
+{
+	if(type != RESOURCE_TIMESTAMP_QUERY && type != RESOURCE_DISJOINT_QUERY)
+	{
+		return 0;
+	}
+
+	return AddResource(type, 0);
+}
+
+
+void NullDeviceClass::ReleaseResource(int handle)
+{
+	// Ignore null and already released handles.
+	if(handle <= 0 || handle > (int)m_resources.size())
+	{
+		return;
+	}
+
+	// Mark the slot as free so the next resource created can reuse it.
+	m_resources[handle - 1].type = -1;
+	m_resources[handle - 1].bytes = 0;
+
+	return;
+}
+
+
+void NullDeviceClass::SetVertexBuffer(int handle, int stride)
+{
+	if(!IsResource(handle, RESOURCE_VERTEX_BUFFER))
+	{
+		return;
+	}
+
+	AddCommand(COMMAND_SET_VERTEX_BUFFER, handle, stride, 0);
+	m_statistics.geometryChanges++;
+
+	return;
+}
+
+
+void NullDeviceClass::SetIndexBuffer(int handle)
+{
+	if(!IsResource(handle, RESOURCE_INDEX_BUFFER))
+	{
+		return;
+	}
+
+	AddCommand(COMMAND_SET_INDEX_BUFFER, handle, 0, 0);
+	m_statistics.geometryChanges++;
+
+	return;
+}
+
+
+void NullDeviceClass::SetInstanceBuffer(int handle, int stride)
+{
+	if(!IsResource(handle, RESOURCE_INSTANCE_BUFFER))
+	{
+		return;
+	}
+
+	AddCommand(COMMAND_SET_INSTANCE_BUFFER, handle, stride, 0);
+	m_statistics.geometryChanges++;
+
+	return;
+}
+
+
+void NullDeviceClass::SetShaders(int vertexShader, int pixelShader)
+{
+	// A pixel shader handle of 0 is allowed, it unbinds the pixel shader for the depth only passes.
+	if(!IsResource(vertexShader, RESOURCE_VERTEX_SHADER) || (pixelShader && !IsResource(pixelShader, RESOURCE_PIXEL_SHADER)))
+	{
+		return;
+	}
+
+	AddCommand(COMMAND_SET_SHADERS, vertexShader, pixelShader, 0);
+	m_statistics.shaderChanges++;
+
+	return;
+}
+
+
+void NullDeviceClass::SetConstantBuffer(ShaderStageType stage, int slot, int handle)
+{
+	if(!IsResource(handle, RESOURCE_CONSTANT_BUFFER))
+	{
+		return;
+	}
+
+	AddCommand(COMMAND_SET_CONSTANT_BUFFER, stage, slot, handle);
+	m_statistics.constantBufferChanges++;
+
+	return;
+}
+
+
+void NullDeviceClass::SetTexture(int slot, int handle)
+{
+	// Render and depth targets are read through the same slots as a texture.
+	if(!IsResource(handle, RESOURCE_TEXTURE) && !IsResource(handle, RESOURCE_RENDER_TARGET) && !IsResource(handle, RESOURCE_DEPTH_TARGET))
+	{
+		return;
+	}
+
+	if(IsBoundRenderTarget(handle))
+	{
+		m_targetConflicts++;
+	}
+
+	AddCommand(COMMAND_SET_TEXTURE, slot, handle, 0);
+	m_statistics.textureChanges++;
+
+	return;
+}
+
+
+void NullDeviceClass::SetShaderBuffer(int slot, int handle)
+{
+	if(!IsResource(handle, RESOURCE_STRUCTURED_BUFFER))
+	{
+		return;
+	}
+
+	AddCommand(COMMAND_SET_SHADER_BUFFER, slot, handle, 0);
+	m_statistics.shaderBufferChanges++;
+
+	return;
+}
+
+
+void NullDeviceClass::SetSampler(int slot, int handle)
+{
+	if(!IsResource(handle, RESOURCE_SAMPLER))
+	{
+		return;
+	}
+
+	AddCommand(COMMAND_SET_SAMPLER, slot, handle, 0);
+	m_statistics.samplerChanges++;
+
+	return;
+}
+
+
+void NullDeviceClass::SetDepthState(DepthStateType state)
+{
+	AddCommand(COMMAND_SET_DEPTH_STATE, state, 0, 0);
+	m_statistics.depthStateChanges++;
+
+	return;
+}
+
+
+void NullDeviceClass::SetRenderTargets(const int* targets, int count, int depthTarget)
+{
+	int i, width, height;
+
+
+	if(count < 0 || count > RENDER_MAX_TARGETS || (count > 0 && !targets))
+	{
+		return;
+	}
+
+	// The set is as big as its depth buffer, the back buffer depth is screen sized.
+	width = m_screenWidth;
+	height = m_screenHeight;
+
+	if(depthTarget)
+	{
+		if(!IsResource(depthTarget, RESOURCE_DEPTH_TARGET))
+		{
+			return;
+		}
+
+		width = m_resources[depthTarget - 1].width;
+		height = m_resources[depthTarget - 1].height;
+	}
+
+	// Every target of the set must be a live render target of the same size as the depth buffer.
+	for(i=0; i<count; i++)
+	{
+		if(!IsResource(targets[i], RESOURCE_RENDER_TARGET) || m_resources[targets[i] - 1].width != width || m_resources[targets[i] - 1].height != height)
+		{
+			return;
+		}
+	}
+
+	// Record the count, the first target and the depth target, no targets at all means the back buffer.
+	for(i=0; i<count; i++)
+	{
+		m_renderTargets[i] = targets[i];
+	}
+	m_renderTargetCount = count;
+	m_depthTarget = depthTarget;
+	m_targetWidth = width;
+	m_targetHeight = height;
+
+	AddCommand(COMMAND_SET_RENDER_TARGETS, count, count > 0 ? targets[0] : 0, depthTarget);
+	m_statistics.renderTargetChanges++;
+
+	return;
+}
+
+
+void NullDeviceClass::SetViewport(int width, int height)
+{
+	// Record the viewport as it is clamped to the bound targets.
+	width = max(1, min(width, m_targetWidth));
+	height = max(1, min(height, m_targetHeight));
+
+	AddCommand(COMMAND_SET_VIEWPORT, width, height, 0);
+
+	return;
+}
+
+
+void NullDeviceClass::ClearRenderTarget(int handle, float red, float green, float blue, float alpha)
+{
+	if(!IsResource(handle, RESOURCE_RENDER_TARGET))
+	{
+		return;
+	}
+
+	AddCommand(COMMAND_CLEAR_RENDER_TARGET, handle, 0, 0);
+
+	return;
+}
+
+
+void NullDeviceClass::ClearDepthTarget(int handle, float depth)
+{
+	if(!IsResource(handle, RESOURCE_DEPTH_TARGET))
+	{
+		return;
+	}
+
+	AddCommand(COMMAND_CLEAR_DEPTH_TARGET, handle, 0, 0);
+
+	return;
+}
+
+
+void NullDeviceClass::CopyTarget(int destination, int source)
+{
+	// Both must be render targets or both depth targets, and of the same size.
+	if(destination == source || (!IsResource(source, RESOURCE_RENDER_TARGET) && !IsResource(source, RESOURCE_DEPTH_TARGET)) ||
+	   !IsResource(destination, m_resources[source - 1].type) || m_resources[destination - 1].bytes != m_resources[source - 1].bytes ||
+	   m_resources[destination - 1].width != m_resources[source - 1].width || m_resources[destination - 1].height != m_resources[source - 1].height)
+	{
+		return;
+	}
+
+	AddCommand(COMMAND_COPY_TARGET, destination, source, 0);
+
+	return;
+}
+
+
+void NullDeviceClass::DrawIndexed(int indexCount)
+{
+	AddCommand(COMMAND_DRAW_INDEXED, indexCount, 0, 0);
+	m_timestamp += indexCount;
+
+	m_statistics.drawCalls++;
+	m_statistics.indexCount += indexCount;
+
+	return;
+}
+
+
+void NullDeviceClass::DrawIndexedInstanced(int indexCount, int instanceCount)
+{
+	AddCommand(COMMAND_DRAW_INDEXED_INSTANCED, indexCount, instanceCount, 0);
+	m_timestamp += indexCount * instanceCount;
+
+	m_statistics.drawCalls++;
+	m_statistics.indexCount += indexCount * instanceCount;
+
+	return;
+}
+
+
+void NullDeviceClass::Draw(int vertexCount)
+{
+	AddCommand(COMMAND_DRAW, vertexCount, 0, 0);
+	m_timestamp += vertexCount;
+
+	m_statistics.drawCalls++;
+	m_statistics.indexCount += vertexCount;
+
+	return;
+}
+
+
+void NullDeviceClass::BeginQuery(int handle)
+{
+	if(!IsResource(handle, RESOURCE_DISJOINT_QUERY))
+	{
+		return;
+	}
+
+	AddCommand(COMMAND_BEGIN_QUERY, handle, 0, 0);
+
+	return;
+}
+
+
+void NullDeviceClass::EndQuery(int handle)
+{
+	if(!IsResource(handle, RESOURCE_TIMESTAMP_QUERY) && !IsResource(handle, RESOURCE_DISJOINT_QUERY))
+	{
+		return;
+	}
+
+	// Latch the clock or the frequency now, the result is held back until the query is old enough.
+	m_resources[handle - 1].queryValue = IsResource(handle, RESOURCE_TIMESTAMP_QUERY) ? m_timestamp : m_timestampFrequency;
+	m_resources[handle - 1].queryFrame = m_frameCount;
+
+	AddCommand(COMMAND_END_QUERY, handle, 0, 0);
+
+	return;
+}
+
+
+bool NullDeviceClass::GetQueryData(int handle, unsigned long long& value)
+{
+	if(!IsResource(handle, RESOURCE_TIMESTAMP_QUERY) && !IsResource(handle, RESOURCE_DISJOINT_QUERY))
+	{
+		return false;
+	}
+
+	if(m_resources[handle - 1].queryFrame < 0 || m_frameCount - m_resources[handle - 1].queryFrame < m_queryLatency)
+	{
+		return false;
+	}
+
+	value = m_resources[handle - 1].queryValue;
+
+	return true;
+}
+
+
+void NullDeviceClass::SetQueryLatency(int frames)
+{
+	m_queryLatency = (frames > 0) ? frames : 0;
+	return;
+}
+
+
+void NullDeviceClass::SetTimestampFrequency(unsigned long long frequency)
+{
+	// A frequency of 0 makes every frame from now on disjoint.
+	m_timestampFrequency = frequency;
+	return;
+}
+
+
+void NullDeviceClass::GetProjectionMatrix(XMMATRIX& projectionMatrix)
+{
+	projectionMatrix = XMLoadFloat4x4(&m_projectionMatrix);
+	return;
+}
+
+
+void NullDeviceClass::GetWorldMatrix(XMMATRIX& worldMatrix)
+{
+	worldMatrix = XMLoadFloat4x4(&m_worldMatrix);
+	return;
+}
+
+
+void NullDeviceClass::GetOrthoMatrix(XMMATRIX& orthoMatrix)
+{
+	orthoMatrix = XMLoadFloat4x4(&m_orthoMatrix);
+	return;
+}
+
+
+int NullDeviceClass::GetResourceBytes()
+{
+	unsigned int i;
+	int bytes;
+
+
+	// Add up the size of every live resource.
+	bytes = 0;
+	for(i=0; i<m_resources.size(); i++)
+	{
+		if(m_resources[i].type != -1)
+		{
+			bytes += m_resources[i].bytes;
+		}
+	}
+
+	return bytes;
+}
+
+
+int NullDeviceClass::GetResourceCount()
+{
+	unsigned int i;
+	int count;
+
+
+	// Count the live resources, a leak shows up as a non zero count after shutdown.
+	count = 0;
+	for(i=0; i<m_resources.size(); i++)
+	{
+		if(m_resources[i].type != -1)
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
+
+
+int NullDeviceClass::GetFrameCount()
+{
+	return m_frameCount;
+}
+
+
+int NullDeviceClass::GetRenderTargetCount()
+{
+	return m_renderTargetCount;
+}
+
+
+int NullDeviceClass::GetRenderTarget(int index)
+{
+	if(index < 0 || index >= m_renderTargetCount)
+	{
+		return 0;
+	}
+
+	return m_renderTargets[index];
+}
+
+
+int NullDeviceClass::GetRenderTargetFormat(int handle)
+{
+	// Only a render target has a format, anything else reads as -1.
+	if(!IsResource(handle, RESOURCE_RENDER_TARGET))
+	{
+		return -1;
+	}
+
+	return m_resources[handle - 1].format;
+}
+
+
+int NullDeviceClass::GetDepthTarget()
+{
+	return m_depthTarget;
+}
+
+
+int NullDeviceClass::GetTargetConflictCount()
+{
+	return m_targetConflicts;
+}
+
+
+int NullDeviceClass::GetCommandCount()
+{
+	return (int)m_commands.size();
+}
+
+
+const NullDeviceClass::CommandType* NullDeviceClass::GetCommand(int index)
+{
+	if(index < 0 || index >= (int)m_commands.size())
+	{
+		return 0;
+	}
+
+	return &m_commands[index];
+}
+
+
+int NullDeviceClass::AddResource(int type, int bytes)
+{
+	NullResourceType resource;
+	unsigned int i;
+
+
+	resource.type = type;
+	resource.bytes = bytes;
+	resource.width = 0;
+	resource.height = 0;
+	resource.format = -1;
+	resource.queryValue = 0;
+	resource.queryFrame = -1;
+
+	// Reuse the first released slot if there is one.
+	for(i=0; i<m_resources.size(); i++)
+	{
+		if(m_resources[i].type == -1)
+		{
+			m_resources[i] = resource;
+			return i + 1;
+		}
+	}
+
+	// Otherwise grow the table, handles are the slot index plus one so that 0 stays invalid.
+	m_resources.push_back(resource);
+
+	return (int)m_resources.size();
+}
+
+
+bool NullDeviceClass::IsResource(int handle, int type)
+{
+	if(handle <= 0 || handle > (int)m_resources.size())
+	{
+		return false;
+	}
+
+	return m_resources[handle - 1].type == type;
+}
+
+
+bool NullDeviceClass::IsBoundRenderTarget(int handle)
+{
+	int i;
+
+
+	for(i=0; i<m_renderTargetCount; i++)
+	{
+		if(m_renderTargets[i] == handle)
+		{
+			return true;
+		}
+	}
+
+	return m_depthTarget && handle == m_depthTarget;
+}
+
+
+void NullDeviceClass::AddCommand(int code, int arg0, int arg1, int arg2)
+{
+	CommandType command;
+
+
+	command.code = code;
+	command.arg0 = arg0;
+	command.arg1 = arg1;
+	command.arg2 = arg2;
+	m_commands.push_back(command);
+
+	return;
+}
\ No newline at end of file
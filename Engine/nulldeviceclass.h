@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: nulldeviceclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _NULLDEVICECLASS_H_
+#define _NULLDEVICECLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <algorithm>
+#include <vector>
+using namespace std;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const unsigned long long NULL_TIMESTAMP_FREQUENCY = 1000000000;
+const int NULL_QUERY_LATENCY = 2;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: NullDeviceClass
+//
+// A renderer backend without a GPU.  It checks the handles it is given, records the size of every resource and keeps
+// the commands of the current frame so the renderer can run headless and have its draw and state traffic inspected.
+// Binding a render or depth target as a texture while it is still being drawn to is counted as a conflict, Direct3D
+// would silently read black instead.  The timestamp queries read a fake clock that advances one tick for every index or
+// vertex drawn, and their results only become available a few frames later the way they would from a GPU running
+// behind the CPU.
+////////////////////////////////////////////////////////////////////////////////
+class NullDeviceClass : public RenderDeviceClass
+{
+public:
+	enum CommandCode
+	{
+		COMMAND_BEGIN_SCENE,
+		COMMAND_END_SCENE,
+		COMMAND_UPDATE_BUFFER,
+		COMMAND_SET_VERTEX_BUFFER,
+		COMMAND_SET_INDEX_BUFFER,
+		COMMAND_SET_INSTANCE_BUFFER,
+		COMMAND_SET_SHADERS,
+		COMMAND_SET_CONSTANT_BUFFER,
+		COMMAND_SET_TEXTURE,
+		COMMAND_SET_SAMPLER,
+		COMMAND_SET_SHADER_BUFFER,
+		COMMAND_SET_DEPTH_STATE,
+		COMMAND_SET_RENDER_TARGETS,
+		COMMAND_SET_VIEWPORT,
+		COMMAND_CLEAR_RENDER_TARGET,
+		COMMAND_CLEAR_DEPTH_TARGET,
+		COMMAND_COPY_TARGET,
+		COMMAND_DRAW_INDEXED,
+		COMMAND_DRAW_INDEXED_INSTANCED,
+		COMMAND_DRAW,
+		COMMAND_BEGIN_QUERY,
+		COMMAND_END_QUERY
+	};
+
+	struct CommandType
+	{
+		int code;
+		int arg0, arg1, arg2;
+	};
+
+private:
+	struct NullResourceType
+	{
+		int type;
+		int bytes;
+		int width, height;
+		int format;
+		unsigned long long queryValue;
+		int queryFrame;
+	};
+
+public:
+	NullDeviceClass();
+	NullDeviceClass(const NullDeviceClass&);
+	~NullDeviceClass();
+
+	bool Initialize(int, int, float, float, bool);
+	void Shutdown();
+
+	void BeginScene(float, float, float, float);
+	void EndScene();
+
+	int CreateBuffer(ResourceType, const void*, int);
+	bool UpdateBuffer(int, const void*, int);
+	int CreateTexture(const wchar_t*);
+	int CreateVertexShader(const wchar_t*, const char*, VertexFormatType);
+	int CreatePixelShader(const wchar_t*, const char*);
+	int CreateSampler();
+	int CreateStructuredBuffer(int, int);
+	int CreateRenderTarget(int, int, RenderTargetFormatType);
+	int CreateDepthTarget(int, int);
+	int CreateQuery(ResourceType);
+	void ReleaseResource(int);
+
+	void SetVertexBuffer(int, int);
+	void SetIndexBuffer(int);
+	void SetInstanceBuffer(int, int);
+	void SetConstantBuffer(ShaderStageType, int, int);
+	void SetTexture(int, int);
+	void SetShaderBuffer(int, int);
+	void SetDepthState(DepthStateType);
+	void SetRenderTargets(const int*, int, int);
+	void SetViewport(int, int);
+	void ClearRenderTarget(int, float, float, float, float);
+	void ClearDepthTarget(int, float);
+	void CopyTarget(int, int);
+	void DrawIndexed(int);
+	void DrawIndexedInstanced(int, int);
+	void Draw(int);
+
+	void BeginQuery(int);
+	void EndQuery(int);
+	bool GetQueryData(int, unsigned long long&);
+	void SetQueryLatency(int);
+	void SetTimestampFrequency(unsigned long long);
+
+	void GetProjectionMatrix(XMMATRIX&);
+	void GetWorldMatrix(XMMATRIX&);
+	void GetOrthoMatrix(XMMATRIX&);
+
+	int GetResourceBytes();
+	int GetResourceCount();
+	int GetFrameCount();
+	int GetRenderTargetCount();
+	int GetRenderTarget(int);
+	int GetRenderTargetFormat(int);
+	int GetDepthTarget();
+	int GetTargetConflictCount();
+
+	int GetCommandCount();
+	const CommandType* GetCommand(int);
+
+protected:
+	void SetShaders(int, int);
+	void SetSampler(int, int);
+
+private:
+	int AddResource(int, int);
+	bool IsResource(int, int);
+	bool IsBoundRenderTarget(int);
+	void AddCommand(int, int, int, int);
+
+private:
+	XMFLOAT4X4 m_projectionMatrix;
+	XMFLOAT4X4 m_worldMatrix;
+	XMFLOAT4X4 m_orthoMatrix;
+	int m_screenWidth, m_screenHeight;
+	int m_targetWidth, m_targetHeight;
+	int m_frameCount;
+	int m_renderTargets[RENDER_MAX_TARGETS];
+	int m_renderTargetCount, m_depthTarget;
+	int m_targetConflicts;
+	unsigned long long m_timestamp, m_timestampFrequency;
+	int m_queryLatency;
+
+	vector<NullResourceType> m_resources;
+	vector<CommandType> m_commands;
+};
+
+#endif
\ No newline at end of file
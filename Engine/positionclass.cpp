@@ -356,9 +356,10 @@ void PositionClass::Camera0(bool keydown)
 {
 	if (keydown)
 	{
-		SetPosition(1.f, 15.f, -200.f);
-		SetRotation(0.f, 0.f, 0.f);
+		SetCameraPreset(0);
 	}
+
+	return;
 }
 
 // Camera 1 key F1
@@ -366,8 +367,7 @@ void PositionClass::Camera1(bool keydown)
 {
 	if (keydown)
 	{
-		SetPosition(900.f, 350.f, 200.f);
-		SetRotation(5.f, -90.f, 0.f);
+		SetCameraPreset(1);
 	}
 
 	return;
@@ -378,9 +378,22 @@ void PositionClass::Camera2(bool keydown)
 {
 	if (keydown)
 	{
-		SetPosition(0.f, 600.f, -625.f);
-		SetRotation(27.f, 0.f, 0.f);
+		SetCameraPreset(2);
 	}
 
 	return;
 }
+
+
+void PositionClass::SetCameraPreset(int preset)
+{
+	if(preset < 0 || preset >= CAMERA_PRESET_COUNT)
+	{
+		return;
+	}
+
+	SetPosition(CAMERA_PRESETS[preset][0], CAMERA_PRESETS[preset][1], CAMERA_PRESETS[preset][2]);
+	SetRotation(CAMERA_PRESETS[preset][3], CAMERA_PRESETS[preset][4], CAMERA_PRESETS[preset][5]);
+
+	return;
+}
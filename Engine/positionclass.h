@@ -11,6 +11,20 @@
 #include <math.h>
 
 
+/////////////
+// GLOBALS //
+/////////////
+const int CAMERA_PRESET_COUNT = 3;
+
+// The position and rotation of the viewpoints on F3, F1 and F2.
+const float CAMERA_PRESETS[CAMERA_PRESET_COUNT][6] =
+{
+	{ 1.0f, 15.0f, -200.0f, 0.0f, 0.0f, 0.0f },
+	{ 900.0f, 350.0f, 200.0f, 5.0f, -90.0f, 0.0f },
+	{ 0.0f, 600.0f, -625.0f, 27.0f, 0.0f, 0.0f }
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: PositionClass
 ////////////////////////////////////////////////////////////////////////////////
@@ -41,6 +55,8 @@ public:
 	void Camera1(bool);
 	void Camera2(bool);
 
+	void SetCameraPreset(int);
+
 
 private:
 	float m_positionX, m_positionY, m_positionZ;
@@ -0,0 +1,462 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: renderdeviceclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "renderdeviceclass.h"
+
+
+RenderDeviceClass::RenderDeviceClass()
+{
+	m_boundPipeline = 0;
+	m_reverseDepth = false;
+	ResetStatistics();
+}
+
+
+RenderDeviceClass::~RenderDeviceClass()
+{
+}
+
+
+bool RenderDeviceClass::IsReverseDepth()
+{
+	return m_reverseDepth;
+}
+
+
+float RenderDeviceClass::GetFarDepth()
+{
+	return m_reverseDepth ? 0.0f : 1.0f;
+}
+
+
+XMMATRIX RenderDeviceClass::BuildProjectionMatrix(float fieldOfView, float screenAspect, float screenNear, float screenDepth, bool reverseDepth)
+{
+	float scaleX, scaleY;
+
+
+	if(!reverseDepth)
+	{
+		return XMMatrixPerspectiveFovLH(fieldOfView, screenAspect, screenNear, screenDepth);
+	}
+
+	// Map the near plane to 1 and infinity to 0, the depth is screenNear / z so the float depth buffer keeps its
+	// precision far away where the depth gets small.  The far plane is not used.
+	scaleY = 1.0f / tanf(fieldOfView * 0.5f);
+	scaleX = scaleY / screenAspect;
+
+	return XMMATRIX(scaleX, 0.0f, 0.0f, 0.0f,
+					0.0f, scaleY, 0.0f, 0.0f,
+					0.0f, 0.0f, 0.0f, 1.0f,
+					0.0f, 0.0f, screenNear, 0.0f);
+}
+
+
+RenderDeviceClass::DepthComparisonType RenderDeviceClass::GetDepthComparison(DepthStateType state, bool reverseDepth)
+{
+	switch(state)
+	{
+		// Only the pixel that wrote the depth in the prepass passes.
+		case DEPTH_STATE_EQUAL:
+			return DEPTH_COMPARISON_EQUAL;
+
+		// The sky sits exactly on the far plane, so it has to pass against the cleared depth as well.
+		case DEPTH_STATE_SKY:
+			return reverseDepth ? DEPTH_COMPARISON_GREATER_EQUAL : DEPTH_COMPARISON_LESS_EQUAL;
+
+		case DEPTH_STATE_DISABLED:
+			return DEPTH_COMPARISON_ALWAYS;
+
+		// The shadow maps keep the usual direction whichever way the scene depth runs.
+		case DEPTH_STATE_SHADOW:
+			return DEPTH_COMPARISON_LESS;
+
+		// The default and prepass states keep the surface nearest the camera.
+		default:
+			return reverseDepth ? DEPTH_COMPARISON_GREATER : DEPTH_COMPARISON_LESS;
+	}
+}
+
+
+int RenderDeviceClass::CreatePipeline(const PipelineDescType& desc)
+{
+	unsigned long long vertexHash, pixelHash, samplerHash, hash;
+	vector<unsigned char> vertexKey, pixelKey, samplerKey, key;
+	PipelineType pipeline;
+	unsigned int i;
+	int kind;
+
+
+	// Describe every object the pipeline needs by its kind and its contents.  The names keep their terminator so one
+	// cannot run on into the next field.
+	kind = RESOURCE_VERTEX_SHADER;
+	AddKeyBytes(vertexKey, &kind, sizeof(kind));
+	AddKeyBytes(vertexKey, desc.vertexShaderFilename, (wcslen(desc.vertexShaderFilename) + 1) * sizeof(wchar_t));
+	AddKeyBytes(vertexKey, desc.vertexShaderEntryPoint, strlen(desc.vertexShaderEntryPoint) + 1);
+	AddKeyBytes(vertexKey, &desc.vertexFormat, sizeof(desc.vertexFormat));
+
+	if(desc.pixelShaderFilename)
+	{
+		kind = RESOURCE_PIXEL_SHADER;
+		AddKeyBytes(pixelKey, &kind, sizeof(kind));
+		AddKeyBytes(pixelKey, desc.pixelShaderFilename, (wcslen(desc.pixelShaderFilename) + 1) * sizeof(wchar_t));
+		AddKeyBytes(pixelKey, desc.pixelShaderEntryPoint, strlen(desc.pixelShaderEntryPoint) + 1);
+	}
+
+	if(desc.sampler != SAMPLER_NONE)
+	{
+		kind = RESOURCE_SAMPLER;
+		AddKeyBytes(samplerKey, &kind, sizeof(kind));
+		AddKeyBytes(samplerKey, &desc.sampler, sizeof(desc.sampler));
+	}
+
+	// The pipeline is described by its objects together, each starts with its kind so the parts cannot be mistaken.
+	key = vertexKey;
+	key.insert(key.end(), pixelKey.begin(), pixelKey.end());
+	key.insert(key.end(), samplerKey.begin(), samplerKey.end());
+
+	vertexHash = HashKey(vertexKey);
+	pixelHash = HashKey(pixelKey);
+	samplerHash = HashKey(samplerKey);
+	hash = HashKey(key);
+
+	// Hand out the existing pipeline when one was already built from the same description.
+	for(i=0; i<m_pipelines.size(); i++)
+	{
+		if(m_pipelines[i].references > 0 && m_pipelines[i].hash == hash && IsSameKey(m_pipelines[i].key, key))
+		{
+			m_pipelines[i].references++;
+			return i + 1;
+		}
+	}
+
+	pipeline.hash = hash;
+	pipeline.key = key;
+	pipeline.references = 1;
+	pipeline.pixelShader = 0;
+	pipeline.sampler = 0;
+
+	// Create the vertex shader unless another pipeline already did.
+	pipeline.vertexShader = AcquireShared(vertexHash, vertexKey);
+	if(!pipeline.vertexShader)
+	{
+		pipeline.vertexShader = CreateVertexShader(desc.vertexShaderFilename, desc.vertexShaderEntryPoint, desc.vertexFormat);
+		if(!pipeline.vertexShader)
+		{
+			return 0;
+		}
+
+		AddShared(vertexHash, vertexKey, pipeline.vertexShader);
+	}
+
+	// Create the pixel shader the same way.
+	if(desc.pixelShaderFilename)
+	{
+		pipeline.pixelShader = AcquireShared(pixelHash, pixelKey);
+		if(!pipeline.pixelShader)
+		{
+			pipeline.pixelShader = CreatePixelShader(desc.pixelShaderFilename, desc.pixelShaderEntryPoint);
+			if(!pipeline.pixelShader)
+			{
+				ReleaseShared(pipeline.vertexShader);
+				return 0;
+			}
+
+			AddShared(pixelHash, pixelKey, pipeline.pixelShader);
+		}
+	}
+
+	// Every pipeline sampling with the same filter shares one sampler object.
+	if(desc.sampler != SAMPLER_NONE)
+	{
+		pipeline.sampler = AcquireShared(samplerHash, samplerKey);
+		if(!pipeline.sampler)
+		{
+			pipeline.sampler = CreateSampler();
+			if(!pipeline.sampler)
+			{
+				ReleaseShared(pipeline.pixelShader);
+				ReleaseShared(pipeline.vertexShader);
+				return 0;
+			}
+
+			AddShared(samplerHash, samplerKey, pipeline.sampler);
+		}
+	}
+
+	// Reuse the first released slot if there is one, otherwise grow the table.
+	for(i=0; i<m_pipelines.size(); i++)
+	{
+		if(m_pipelines[i].references == 0)
+		{
+			m_pipelines[i] = pipeline;
+			return i + 1;
+		}
+	}
+
+	m_pipelines.push_back(pipeline);
+
+	return (int)m_pipelines.size();
+}
+
+
+void RenderDeviceClass::ReleasePipeline(int handle)
+{
+	PipelineType* pipeline;
+
+
+	if(handle <= 0 || handle > (int)m_pipelines.size() || m_pipelines[handle - 1].references == 0)
+	{
+		return;
+	}
+
+	pipeline = &m_pipelines[handle - 1];
+
+	// The objects of a pipeline are released when the last user of the pipeline lets go of it.
+	pipeline->references--;
+	if(pipeline->references > 0)
+	{
+		return;
+	}
+
+	ReleaseShared(pipeline->sampler);
+	ReleaseShared(pipeline->pixelShader);
+	ReleaseShared(pipeline->vertexShader);
+
+	// A released handle can come back for a new object, so forget what is bound rather than compare against it.
+	m_boundPipeline = 0;
+
+	return;
+}
+
+
+void RenderDeviceClass::SetPipeline(int handle)
+{
+	const PipelineType* pipeline;
+	const PipelineType* bound;
+
+
+	// Binding the pipeline that is already bound costs a single compare.
+	if(handle == m_boundPipeline)
+	{
+		return;
+	}
+
+	if(handle <= 0 || handle > (int)m_pipelines.size() || m_pipelines[handle - 1].references == 0)
+	{
+		return;
+	}
+
+	pipeline = &m_pipelines[handle - 1];
+	bound = m_boundPipeline ? &m_pipelines[m_boundPipeline - 1] : 0;
+
+	// Only send the parts of the state that differ from the bound pipeline.
+	if(!bound || bound->vertexShader != pipeline->vertexShader || bound->pixelShader != pipeline->pixelShader)
+	{
+		SetShaders(pipeline->vertexShader, pipeline->pixelShader);
+	}
+
+	if(pipeline->sampler && (!bound || bound->sampler != pipeline->sampler))
+	{
+		SetSampler(0, pipeline->sampler);
+	}
+
+	m_boundPipeline = handle;
+	m_statistics.pipelineChanges++;
+
+	return;
+}
+
+
+int RenderDeviceClass::GetPipelineCount()
+{
+	unsigned int i;
+	int count;
+
+
+	// Count the live pipelines.
+	count = 0;
+	for(i=0; i<m_pipelines.size(); i++)
+	{
+		if(m_pipelines[i].references > 0)
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
+
+
+void RenderDeviceClass::GetStatistics(StatisticsType& statistics)
+{
+	statistics = m_statistics;
+	return;
+}
+
+
+void RenderDeviceClass::ResetStatistics()
+{
+	// Clear the per frame command counters.
+	memset(&m_statistics, 0, sizeof(m_statistics));
+	return;
+}
+
+
+void RenderDeviceClass::ClearPipelines()
+{
+	// The backend is shutting down and releases every resource itself, so only the tables are emptied.
+	m_pipelines.clear();
+	m_sharedObjects.clear();
+	m_boundPipeline = 0;
+
+	return;
+}
+
+
+int RenderDeviceClass::GetFileBytes(const wchar_t* filename)
+{
+	char path[256];
+	ifstream fin;
+	size_t length;
+
+
+	// Convert the wide file name so it can be opened with the standard library.
+	length = wcstombs(path, filename, sizeof(path));
+	if(length == (size_t)-1 || length >= sizeof(path))
+	{
+		return -1;
+	}
+
+	// Open the file at its end so the read position is the size of the file.
+	fin.open(path, ios::binary | ios::ate);
+	if(fin.fail())
+	{
+		return -1;
+	}
+
+	return (int)fin.tellg();
+}
+
+
+int RenderDeviceClass::GetPixelBytes(RenderTargetFormatType format)
+{
+	switch(format)
+	{
+		case RENDER_TARGET_RGBA8:
+		case RENDER_TARGET_RG16_SNORM:
+		case RENDER_TARGET_R32_FLOAT:
+			return 4;
+		default:
+			return 0;
+	}
+}
+
+
+void RenderDeviceClass::AddKeyBytes(vector<unsigned char>& key, const void* data, size_t bytes)
+{
+	key.insert(key.end(), (const unsigned char*)data, (const unsigned char*)data + bytes);
+	return;
+}
+
+
+unsigned long long RenderDeviceClass::HashKey(const vector<unsigned char>& key)
+{
+	unsigned long long hash;
+	size_t i;
+
+
+	// Hash the description with the 64 bit FNV-1a hash.
+	hash = 14695981039346656037ULL;
+	for(i=0; i<key.size(); i++)
+	{
+		hash = (hash ^ key[i]) * 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+
+bool RenderDeviceClass::IsSameKey(const vector<unsigned char>& key, const vector<unsigned char>& otherKey)
+{
+	if(key.size() != otherKey.size())
+	{
+		return false;
+	}
+
+	return key.empty() || memcmp(key.data(), otherKey.data(), key.size()) == 0;
+}
+
+
+int RenderDeviceClass::AcquireShared(unsigned long long hash, const vector<unsigned char>& key)
+{
+	unsigned int i;
+
+
+	// Find the live object with this description and add a reference to it, the hash rules out almost every other
+	// object with one compare and the description settles the rest.
+	for(i=0; i<m_sharedObjects.size(); i++)
+	{
+		if(m_sharedObjects[i].references > 0 && m_sharedObjects[i].hash == hash && IsSameKey(m_sharedObjects[i].key, key))
+		{
+			m_sharedObjects[i].references++;
+			return m_sharedObjects[i].handle;
+		}
+	}
+
+	return 0;
+}
+
+
+void RenderDeviceClass::AddShared(unsigned long long hash, const vector<unsigned char>& key, int handle)
+{
+	SharedObjectType object;
+	unsigned int i;
+
+
+	object.hash = hash;
+	object.key = key;
+	object.references = 1;
+	object.handle = handle;
+
+	// Reuse the first released slot if there is one.
+	for(i=0; i<m_sharedObjects.size(); i++)
+	{
+		if(m_sharedObjects[i].references == 0)
+		{
+			m_sharedObjects[i] = object;
+			return;
+		}
+	}
+
+	m_sharedObjects.push_back(object);
+
+	return;
+}
+
+
+void RenderDeviceClass::ReleaseShared(int handle)
+{
+	unsigned int i;
+
+
+	if(!handle)
+	{
+		return;
+	}
+
+	// Drop a reference and release the backend object with the last one.
+	for(i=0; i<m_sharedObjects.size(); i++)
+	{
+		if(m_sharedObjects[i].references > 0 && m_sharedObjects[i].handle == handle)
+		{
+			m_sharedObjects[i].references--;
+			if(m_sharedObjects[i].references == 0)
+			{
+				ReleaseResource(handle);
+			}
+			return;
+		}
+	}
+
+	return;
+}
\ No newline at end of file
@@ -0,0 +1,255 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: renderdeviceclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _RENDERDEVICECLASS_H_
+#define _RENDERDEVICECLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <math.h>
+#include <string.h>
+#include <stdlib.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <fstream>
+#include <vector>
+using namespace std;
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int RENDER_MAX_TARGETS = 4;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: RenderDeviceClass
+//
+// The interface every renderer backend implements.  Resources are referred to by integer handles, a handle of 0 is
+// never valid so it can be used the same way as a null pointer.  The pipelines are built on top of the backend in this
+// class, which shares the shader and sampler objects between every pipeline that uses them.  The pipelines and the
+// shared objects are found by a hash of their description, and the description itself is kept next to the hash so two
+// different ones that happen to hash the same are never taken for each other.  Structured buffers are rewritten with
+// UpdateBuffer like the constant buffers and share the pixel shader resource slots with the textures.  Instance buffers
+// are rewritten the same way and hold one world matrix for every instance of an instanced draw, which the instanced
+// vertex format reads next to the vertices of the model.  Render targets share the texture slots as well, a render
+// target is read by binding its handle with SetTexture once it is no longer being drawn to.  Depth targets are depth
+// buffers of their own that can be read the same way.  SetRenderTargets takes the color targets and a depth target, a
+// depth target of 0 is the depth buffer of the back buffer and no color targets with it means the back buffer itself,
+// while no color targets with a depth target is a depth only pass.  Binding targets covers them whole with the
+// viewport, SetViewport then narrows drawing to the top left corner of them.  Queries are read back later without
+// waiting, GetQueryData returns false until the result is there.  A timestamp query gives the tick count when the
+// commands before it finished and a disjoint query, begun and ended around a frame, gives the tick frequency or 0 when
+// the timestamps of that frame cannot be trusted.  With reverse depth the projection maps the near plane to a depth of
+// 1 and an infinite far plane to 0, the depth buffer is cleared to 0 and the depth states test GREATER instead of LESS,
+// except the shadow state which keeps the usual direction for the shadow maps.  GetDepthComparison gives the test of
+// every depth state in either mode so all the devices agree on it.
+////////////////////////////////////////////////////////////////////////////////
+class RenderDeviceClass
+{
+public:
+	enum ResourceType
+	{
+		RESOURCE_VERTEX_BUFFER,
+		RESOURCE_INDEX_BUFFER,
+		RESOURCE_INSTANCE_BUFFER,
+		RESOURCE_CONSTANT_BUFFER,
+		RESOURCE_TEXTURE,
+		RESOURCE_VERTEX_SHADER,
+		RESOURCE_PIXEL_SHADER,
+		RESOURCE_SAMPLER,
+		RESOURCE_STRUCTURED_BUFFER,
+		RESOURCE_RENDER_TARGET,
+		RESOURCE_DEPTH_TARGET,
+		RESOURCE_TIMESTAMP_QUERY,
+		RESOURCE_DISJOINT_QUERY
+	};
+
+	// The vertex layouts used by the engine, the backend builds the matching input layout for a vertex shader.  A vertex
+	// shader without any vertex input builds its vertices from their index and is drawn with Draw.  The instanced
+	// layout adds the rows of the world matrix of each instance from the instance buffer.
+	enum VertexFormatType
+	{
+		VERTEX_FORMAT_NONE,
+		VERTEX_FORMAT_POSITION,
+		VERTEX_FORMAT_POSITION_TEXTURE,
+		VERTEX_FORMAT_POSITION_TEXTURE_NORMAL,
+		VERTEX_FORMAT_BUMPMAP,
+		VERTEX_FORMAT_POSITION_TEXTURE_NORMAL_INSTANCED
+	};
+
+	enum ShaderStageType
+	{
+		SHADER_STAGE_VERTEX,
+		SHADER_STAGE_PIXEL
+	};
+
+	enum DepthStateType
+	{
+		DEPTH_STATE_DEFAULT,
+		DEPTH_STATE_PREPASS,
+		DEPTH_STATE_EQUAL,
+		DEPTH_STATE_SKY,
+		DEPTH_STATE_DISABLED,
+		DEPTH_STATE_SHADOW
+	};
+
+	enum DepthComparisonType
+	{
+		DEPTH_COMPARISON_LESS,
+		DEPTH_COMPARISON_LESS_EQUAL,
+		DEPTH_COMPARISON_GREATER,
+		DEPTH_COMPARISON_GREATER_EQUAL,
+		DEPTH_COMPARISON_EQUAL,
+		DEPTH_COMPARISON_ALWAYS
+	};
+
+	enum RenderTargetFormatType
+	{
+		RENDER_TARGET_RGBA8,
+		RENDER_TARGET_RG16_SNORM,
+		RENDER_TARGET_R32_FLOAT
+	};
+
+	enum SamplerType
+	{
+		SAMPLER_NONE,
+		SAMPLER_LINEAR_WRAP
+	};
+
+	// Everything a draw binds besides its buffers, textures and the depth state of the pass.  A pixel shader filename
+	// of null makes a depth only pipeline.
+	struct PipelineDescType
+	{
+		const wchar_t* vertexShaderFilename;
+		const char* vertexShaderEntryPoint;
+		VertexFormatType vertexFormat;
+		const wchar_t* pixelShaderFilename;
+		const char* pixelShaderEntryPoint;
+		SamplerType sampler;
+	};
+
+	struct StatisticsType
+	{
+		int drawCalls;
+		int indexCount;
+		int bufferUpdates;
+		int bufferUpdateBytes;
+		int geometryChanges;
+		int shaderChanges;
+		int constantBufferChanges;
+		int textureChanges;
+		int samplerChanges;
+		int shaderBufferChanges;
+		int depthStateChanges;
+		int pipelineChanges;
+		int renderTargetChanges;
+	};
+
+public:
+	RenderDeviceClass();
+	virtual ~RenderDeviceClass();
+
+	virtual void BeginScene(float, float, float, float) = 0;
+	virtual void EndScene() = 0;
+
+	virtual int CreateBuffer(ResourceType, const void*, int) = 0;
+	virtual bool UpdateBuffer(int, const void*, int) = 0;
+	virtual int CreateTexture(const wchar_t*) = 0;
+	virtual int CreateVertexShader(const wchar_t*, const char*, VertexFormatType) = 0;
+	virtual int CreatePixelShader(const wchar_t*, const char*) = 0;
+	virtual int CreateSampler() = 0;
+	virtual int CreateStructuredBuffer(int, int) = 0;
+	virtual int CreateRenderTarget(int, int, RenderTargetFormatType) = 0;
+	virtual int CreateDepthTarget(int, int) = 0;
+	virtual int CreateQuery(ResourceType) = 0;
+	virtual void ReleaseResource(int) = 0;
+
+	virtual void SetVertexBuffer(int, int) = 0;
+	virtual void SetIndexBuffer(int) = 0;
+	virtual void SetInstanceBuffer(int, int) = 0;
+	virtual void SetConstantBuffer(ShaderStageType, int, int) = 0;
+	virtual void SetTexture(int, int) = 0;
+	virtual void SetShaderBuffer(int, int) = 0;
+	virtual void SetDepthState(DepthStateType) = 0;
+	virtual void SetRenderTargets(const int*, int, int) = 0;
+	virtual void SetViewport(int, int) = 0;
+	virtual void ClearRenderTarget(int, float, float, float, float) = 0;
+	virtual void ClearDepthTarget(int, float) = 0;
+	virtual void CopyTarget(int, int) = 0;
+	virtual void DrawIndexed(int) = 0;
+	virtual void DrawIndexedInstanced(int, int) = 0;
+	virtual void Draw(int) = 0;
+
+	virtual void BeginQuery(int) = 0;
+	virtual void EndQuery(int) = 0;
+	virtual bool GetQueryData(int, unsigned long long&) = 0;
+
+	virtual void GetProjectionMatrix(XMMATRIX&) = 0;
+	virtual void GetWorldMatrix(XMMATRIX&) = 0;
+	virtual void GetOrthoMatrix(XMMATRIX&) = 0;
+
+	virtual int GetResourceBytes() = 0;
+
+	bool IsReverseDepth();
+	float GetFarDepth();
+	static XMMATRIX BuildProjectionMatrix(float, float, float, float, bool);
+	static DepthComparisonType GetDepthComparison(DepthStateType, bool);
+
+	int CreatePipeline(const PipelineDescType&);
+	void ReleasePipeline(int);
+	void SetPipeline(int);
+	int GetPipelineCount();
+
+	void GetStatistics(StatisticsType&);
+	void ResetStatistics();
+
+protected:
+	// The shaders and samplers are only ever bound through a pipeline.
+	virtual void SetShaders(int, int) = 0;
+	virtual void SetSampler(int, int) = 0;
+
+	void ClearPipelines();
+	static int GetFileBytes(const wchar_t*);
+	static int GetPixelBytes(RenderTargetFormatType);
+
+private:
+	struct PipelineType
+	{
+		unsigned long long hash;
+		vector<unsigned char> key;
+		int references;
+		int vertexShader;
+		int pixelShader;
+		int sampler;
+	};
+
+	struct SharedObjectType
+	{
+		unsigned long long hash;
+		vector<unsigned char> key;
+		int references;
+		int handle;
+	};
+
+	static void AddKeyBytes(vector<unsigned char>&, const void*, size_t);
+	static unsigned long long HashKey(const vector<unsigned char>&);
+	static bool IsSameKey(const vector<unsigned char>&, const vector<unsigned char>&);
+	int AcquireShared(unsigned long long, const vector<unsigned char>&);
+	void AddShared(unsigned long long, const vector<unsigned char>&, int);
+	void ReleaseShared(int);
+
+protected:
+	StatisticsType m_statistics;
+	bool m_reverseDepth;
+
+private:
+	vector<PipelineType> m_pipelines;
+	vector<SharedObjectType> m_sharedObjects;
+	int m_boundPipeline;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: resolutioncontrollerclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "resolutioncontrollerclass.h"
+
+
+ResolutionControllerClass::ResolutionControllerClass()
+{
+	m_budget = 0.0f;
+	m_minScale = RESOLUTION_MIN_SCALE;
+	m_maxScale = RESOLUTION_MAX_SCALE;
+	m_scale = RESOLUTION_MAX_SCALE;
+	m_averageTime = 0.0f;
+	m_settleFrames = 0;
+	m_hasAverage = false;
+}
+
+
+ResolutionControllerClass::ResolutionControllerClass(const ResolutionControllerClass& other)
+{
+}
+
+
+ResolutionControllerClass::~ResolutionControllerClass()
+{
+}
+
+
+bool ResolutionControllerClass::Initialize(float budget, float minScale, float maxScale)
+{
+	if(budget <= 0.0f || minScale <= 0.0f || maxScale < minScale)
+	{
+		return false;
+	}
+
+	m_budget = budget;
+	m_minScale = minScale;
+	m_maxScale = maxScale;
+
+	// Start at the full scale and let the frame times bring it down.
+	Reset(maxScale);
+
+	return true;
+}
+
+
+void ResolutionControllerClass::Reset(float scale)
+{
+	m_scale = min(max(scale, m_minScale), m_maxScale);
+	m_averageTime = 0.0f;
+	m_settleFrames = 0;
+	m_hasAverage = false;
+
+	return;
+}
+
+
+void ResolutionControllerClass::Update(float frameTime)
+{
+	float aim, desiredScale;
+
+
+	// A frame the GPU could not time says nothing.
+	if(frameTime <= 0.0f)
+	{
+		return;
+	}
+
+	// The frames still in flight after a change were drawn at the old scale.
+	if(m_settleFrames > 0)
+	{
+		m_settleFrames--;
+		return;
+	}
+
+	// Follow a rise in the frame time faster than a fall.
+	if(!m_hasAverage)
+	{
+		m_averageTime = frameTime;
+		m_hasAverage = true;
+	}
+	else if(frameTime > m_averageTime)
+	{
+		m_averageTime += (frameTime - m_averageTime) * RESOLUTION_RISE_SMOOTHING;
+	}
+	else
+	{
+		m_averageTime += (frameTime - m_averageTime) * RESOLUTION_FALL_SMOOTHING;
+	}
+
+	// Leave the scale alone while the average is close enough to the aim.
+	aim = m_budget * RESOLUTION_HEADROOM;
+	if(m_averageTime <= aim * (1.0f + RESOLUTION_DEADBAND) && m_averageTime >= aim * (1.0f - RESOLUTION_DEADBAND))
+	{
+		return;
+	}
+
+	// Scale the pixel count by how far off the aim the average is, one limited step at a time.
+	desiredScale = m_scale * sqrtf(aim / m_averageTime);
+	desiredScale = min(max(desiredScale, m_scale - RESOLUTION_MAX_DECREASE), m_scale + RESOLUTION_MAX_INCREASE);
+	desiredScale = min(max(desiredScale, m_minScale), m_maxScale);
+
+	if(desiredScale == m_scale)
+	{
+		return;
+	}
+
+	// Expect the average to follow the pixel count until the new times come in.
+	m_averageTime *= (desiredScale * desiredScale) / (m_scale * m_scale);
+	m_scale = desiredScale;
+	m_settleFrames = RESOLUTION_SETTLE_FRAMES;
+
+	return;
+}
+
+
+float ResolutionControllerClass::GetScale()
+{
+	return m_scale;
+}
+
+
+float ResolutionControllerClass::GetAverageTime()
+{
+	return m_averageTime;
+}
+
+
+float ResolutionControllerClass::GetBudget()
+{
+	return m_budget;
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: resolutioncontrollerclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _RESOLUTIONCONTROLLERCLASS_H_
+#define _RESOLUTIONCONTROLLERCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <math.h>
+#include <algorithm>
+using namespace std;
+
+
+/////////////
+// GLOBALS //
+/////////////
+const float RESOLUTION_MIN_SCALE = 0.5f;
+const float RESOLUTION_MAX_SCALE = 1.0f;
+const float RESOLUTION_HEADROOM = 0.9f;
+const float RESOLUTION_DEADBAND = 0.1f;
+const float RESOLUTION_RISE_SMOOTHING = 0.5f;
+const float RESOLUTION_FALL_SMOOTHING = 0.1f;
+const float RESOLUTION_MAX_DECREASE = 0.15f;
+const float RESOLUTION_MAX_INCREASE = 0.05f;
+const int RESOLUTION_SETTLE_FRAMES = 4;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: ResolutionControllerClass
+//
+// Picks the resolution scale of the scene from the measured GPU frame times, so a heavy view is drawn with fewer pixels
+// instead of missing the frame budget.  The frame times are averaged with more weight on a rise than a fall, so the
+// scale drops quickly under load and creeps back up once it passes.  The scale aims a little under the budget and is
+// left alone while the average stays within a band around that aim.  The GPU time is taken to grow with the pixel
+// count, so the scale moves by the square root of how far off the average is, limited to a step per update.  After a
+// change the next few times are skipped as they were still drawn at the old scale.  It only does arithmetic on the
+// times it is given, so the same times always give the same scales.
+////////////////////////////////////////////////////////////////////////////////
+class ResolutionControllerClass
+{
+public:
+	ResolutionControllerClass();
+	ResolutionControllerClass(const ResolutionControllerClass&);
+	~ResolutionControllerClass();
+
+	bool Initialize(float, float, float);
+	void Reset(float);
+
+	void Update(float);
+
+	float GetScale();
+	float GetAverageTime();
+	float GetBudget();
+
+private:
+	float m_budget, m_minScale, m_maxScale;
+	float m_scale, m_averageTime;
+	int m_settleFrames;
+	bool m_hasAverage;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,444 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: sceneclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "sceneclass.h"
+
+
+SceneClass::SceneClass()
+{
+	m_prefabCount = 0;
+	m_prefabs = 0;
+	m_instanceCount = 0;
+	memset(&m_instances, 0, sizeof(m_instances));
+	m_lightCount = 0;
+	memset(&m_lights, 0, sizeof(m_lights));
+}
+
+
+SceneClass::SceneClass(const SceneClass& other)
+{
+}
+
+
+SceneClass::~SceneClass()
+{
+}
+
+
+bool SceneClass::Initialize(const char* filename)
+{
+	ifstream fin;
+	bool result;
+
+
+	// Open the scene file.
+	fin.open(filename);
+
+	// If it could not open the file then exit.
+	if(fin.fail())
+	{
+		return false;
+	}
+
+	// Read the prefabs and instances from the file.
+	result = Load(fin);
+
+	// Close the scene file.
+	fin.close();
+
+	return result;
+}
+
+
+bool SceneClass::Load(istream& in)
+{
+	bool result;
+
+
+	// Release anything from a previous load.
+	Shutdown();
+
+	// Read in the prefab list first since the instances refer to the prefabs by name.
+	result = ReadPrefabs(in);
+	if(!result)
+	{
+		Shutdown();
+		return false;
+	}
+
+	// Read in the instance list.
+	result = ReadInstances(in);
+	if(!result)
+	{
+		Shutdown();
+		return false;
+	}
+
+	// The point light rows are optional and come last.
+	if(SkipToData(in))
+	{
+		result = ReadLights(in);
+		if(!result)
+		{
+			Shutdown();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+void SceneClass::Shutdown()
+{
+	// Release the light arrays.
+	ReleaseLights();
+
+	// Release the instance arrays.
+	ReleaseInstances();
+
+	// Release the prefab list.
+	ReleasePrefabs();
+
+	return;
+}
+
+
+int SceneClass::GetPrefabCount()
+{
+	return m_prefabCount;
+}
+
+
+SceneClass::PrefabType* SceneClass::GetPrefab(int index)
+{
+	if((index < 0) || (index >= m_prefabCount))
+	{
+		return 0;
+	}
+
+	return &m_prefabs[index];
+}
+
+
+int SceneClass::FindPrefab(const char* name)
+{
+	int i;
+
+
+	for(i=0; i<m_prefabCount; i++)
+	{
+		if(strcmp(m_prefabs[i].name, name) == 0)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+
+int SceneClass::GetInstanceCount()
+{
+	return m_instanceCount;
+}
+
+
+SceneClass::InstanceDataType* SceneClass::GetInstances()
+{
+	return &m_instances;
+}
+
+
+int SceneClass::GetLightCount()
+{
+	return m_lightCount;
+}
+
+
+SceneClass::LightDataType* SceneClass::GetLights()
+{
+	return &m_lights;
+}
+
+
+bool SceneClass::ReadPrefabs(istream& in)
+{
+	char shaderName[SCENE_MAX_NAME];
+	int i;
+
+
+	// Read up to the value of prefab count.
+	if(!SkipToData(in))
+	{
+		return false;
+	}
+
+	// Read in the prefab count.
+	in >> m_prefabCount;
+	if(in.fail() || (m_prefabCount < 0))
+	{
+		m_prefabCount = 0;
+		return false;
+	}
+
+	// Create the prefab list using the count that was read in.
+	m_prefabs = new PrefabType[m_prefabCount];
+	if(!m_prefabs)
+	{
+		return false;
+	}
+
+	// Read up to the beginning of the prefab data.
+	if(!SkipToData(in))
+	{
+		return false;
+	}
+
+	// Read in the name, model, texture and shader of each prefab.
+	for(i=0; i<m_prefabCount; i++)
+	{
+		in >> setw(SCENE_MAX_NAME) >> m_prefabs[i].name;
+		in >> setw(SCENE_MAX_PATH) >> m_prefabs[i].modelFilename;
+		in >> setw(SCENE_MAX_PATH) >> m_prefabs[i].textureFilename;
+		in >> setw(SCENE_MAX_NAME) >> shaderName;
+		if(in.fail())
+		{
+			return false;
+		}
+
+		m_prefabs[i].shader = FindShader(shaderName);
+		if(m_prefabs[i].shader < 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+bool SceneClass::ReadInstances(istream& in)
+{
+	char prefabName[SCENE_MAX_NAME];
+	int i, follow;
+
+
+	// Read up to the value of instance count.
+	if(!SkipToData(in))
+	{
+		return false;
+	}
+
+	// Read in the instance count.
+	in >> m_instanceCount;
+	if(in.fail() || (m_instanceCount < 0))
+	{
+		m_instanceCount = 0;
+		return false;
+	}
+
+	// Create one flat array for each instance attribute.
+	m_instances.prefab = new int[m_instanceCount];
+	m_instances.positionX = new float[m_instanceCount];
+	m_instances.positionY = new float[m_instanceCount];
+	m_instances.positionZ = new float[m_instanceCount];
+	m_instances.rotationX = new float[m_instanceCount];
+	m_instances.rotationY = new float[m_instanceCount];
+	m_instances.rotationZ = new float[m_instanceCount];
+	m_instances.scale = new float[m_instanceCount];
+	m_instances.orbitSpeed = new float[m_instanceCount];
+	m_instances.followCamera = new bool[m_instanceCount];
+
+	// Read up to the beginning of the instance data.
+	if(!SkipToData(in))
+	{
+		return false;
+	}
+
+	// Read in the prefab name, position, rotation in degrees, uniform scale, orbit speed and camera follow flag of each instance.
+	for(i=0; i<m_instanceCount; i++)
+	{
+		in >> setw(SCENE_MAX_NAME) >> prefabName;
+		in >> m_instances.positionX[i] >> m_instances.positionY[i] >> m_instances.positionZ[i];
+		in >> m_instances.rotationX[i] >> m_instances.rotationY[i] >> m_instances.rotationZ[i];
+		in >> m_instances.scale[i] >> m_instances.orbitSpeed[i] >> follow;
+		if(in.fail())
+		{
+			return false;
+		}
+
+		m_instances.prefab[i] = FindPrefab(prefabName);
+		if(m_instances.prefab[i] < 0)
+		{
+			return false;
+		}
+
+		m_instances.followCamera[i] = (follow != 0);
+	}
+
+	return true;
+}
+
+
+bool SceneClass::ReadLights(istream& in)
+{
+	float* rows;
+	int rowCount, i, j, light;
+	int* counts;
+
+
+	// Read in the light row count, the label was already skipped.
+	in >> rowCount;
+	if(in.fail() || (rowCount < 0))
+	{
+		return false;
+	}
+
+	// Create a temporary list for the rows, each one is a start position, a step, a radius and a color.
+	rows = new float[rowCount * 10 + 1];
+	counts = new int[rowCount + 1];
+
+	// Read up to the beginning of the light row data.
+	if(!SkipToData(in))
+	{
+		delete [] counts;
+		delete [] rows;
+		return false;
+	}
+
+	// Read in the light count, start position, step, radius and color of each row.
+	m_lightCount = 0;
+	for(i=0; i<rowCount; i++)
+	{
+		in >> counts[i];
+		for(j=0; j<10; j++)
+		{
+			in >> rows[i * 10 + j];
+		}
+
+		if(in.fail() || (counts[i] < 1))
+		{
+			delete [] counts;
+			delete [] rows;
+			return false;
+		}
+
+		m_lightCount += counts[i];
+	}
+
+	// Create one flat array for each light attribute.
+	m_lights.positionX = new float[m_lightCount];
+	m_lights.positionY = new float[m_lightCount];
+	m_lights.positionZ = new float[m_lightCount];
+	m_lights.radius = new float[m_lightCount];
+	m_lights.colorR = new float[m_lightCount];
+	m_lights.colorG = new float[m_lightCount];
+	m_lights.colorB = new float[m_lightCount];
+
+	// Expand every row into its lights.
+	light = 0;
+	for(i=0; i<rowCount; i++)
+	{
+		for(j=0; j<counts[i]; j++)
+		{
+			m_lights.positionX[light] = rows[i * 10 + 0] + rows[i * 10 + 3] * (float)j;
+			m_lights.positionY[light] = rows[i * 10 + 1] + rows[i * 10 + 4] * (float)j;
+			m_lights.positionZ[light] = rows[i * 10 + 2] + rows[i * 10 + 5] * (float)j;
+			m_lights.radius[light] = rows[i * 10 + 6];
+			m_lights.colorR[light] = rows[i * 10 + 7];
+			m_lights.colorG[light] = rows[i * 10 + 8];
+			m_lights.colorB[light] = rows[i * 10 + 9];
+			light++;
+		}
+	}
+
+	// Release the temporary row list.
+	delete [] counts;
+	delete [] rows;
+
+	return true;
+}
+
+
+bool SceneClass::SkipToData(istream& in)
+{
+	char input;
+
+
+	// Read up to and including the next ':' that ends a section label.
+	in.get(input);
+	while(in.good() && (input != ':'))
+	{
+		in.get(input);
+	}
+
+	return in.good();
+}
+
+
+int SceneClass::FindShader(const char* name)
+{
+	if(strcmp(name, "texture") == 0)
+	{
+		return SHADER_TEXTURE;
+	}
+
+	if(strcmp(name, "light") == 0)
+	{
+		return SHADER_LIGHT;
+	}
+
+	return -1;
+}
+
+
+void SceneClass::ReleasePrefabs()
+{
+	if(m_prefabs)
+	{
+		delete [] m_prefabs;
+		m_prefabs = 0;
+	}
+
+	m_prefabCount = 0;
+
+	return;
+}
+
+
+void SceneClass::ReleaseInstances()
+{
+	delete [] m_instances.prefab;
+	delete [] m_instances.positionX;
+	delete [] m_instances.positionY;
+	delete [] m_instances.positionZ;
+	delete [] m_instances.rotationX;
+	delete [] m_instances.rotationY;
+	delete [] m_instances.rotationZ;
+	delete [] m_instances.scale;
+	delete [] m_instances.orbitSpeed;
+	delete [] m_instances.followCamera;
+
+	memset(&m_instances, 0, sizeof(m_instances));
+	m_instanceCount = 0;
+
+	return;
+}
+
+
+void SceneClass::ReleaseLights()
+{
+	delete [] m_lights.positionX;
+	delete [] m_lights.positionY;
+	delete [] m_lights.positionZ;
+	delete [] m_lights.radius;
+	delete [] m_lights.colorR;
+	delete [] m_lights.colorG;
+	delete [] m_lights.colorB;
+
+	memset(&m_lights, 0, sizeof(m_lights));
+	m_lightCount = 0;
+
+	return;
+}
\ No newline at end of file
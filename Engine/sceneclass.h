@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: sceneclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SCENECLASS_H_
+#define _SCENECLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <fstream>
+#include <iomanip>
+#include <string.h>
+using namespace std;
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int SCENE_MAX_NAME = 64;
+const int SCENE_MAX_PATH = 256;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: SceneClass
+////////////////////////////////////////////////////////////////////////////////
+class SceneClass
+{
+public:
+	enum ShaderType
+	{
+		SHADER_TEXTURE = 0,
+		SHADER_LIGHT = 1
+	};
+
+	// A prefab is one mesh and texture pair drawn with one shader, it is loaded once and shared by all its instances.
+	struct PrefabType
+	{
+		char name[SCENE_MAX_NAME];
+		char modelFilename[SCENE_MAX_PATH];
+		char textureFilename[SCENE_MAX_PATH];
+		int shader;
+	};
+
+	// The instances are stored as one flat array per attribute so systems can stream through them.
+	struct InstanceDataType
+	{
+		int* prefab;
+		float* positionX;
+		float* positionY;
+		float* positionZ;
+		float* rotationX;
+		float* rotationY;
+		float* rotationZ;
+		float* scale;
+		float* orbitSpeed;
+		bool* followCamera;
+	};
+
+	// The point lights are written as rows of evenly spaced lights and expanded into one flat array per attribute.
+	struct LightDataType
+	{
+		float* positionX;
+		float* positionY;
+		float* positionZ;
+		float* radius;
+		float* colorR;
+		float* colorG;
+		float* colorB;
+	};
+
+public:
+	SceneClass();
+	SceneClass(const SceneClass&);
+	~SceneClass();
+
+	bool Initialize(const char*);
+	bool Load(istream&);
+	void Shutdown();
+
+	int GetPrefabCount();
+	PrefabType* GetPrefab(int);
+	int FindPrefab(const char*);
+
+	int GetInstanceCount();
+	InstanceDataType* GetInstances();
+
+	int GetLightCount();
+	LightDataType* GetLights();
+
+private:
+	bool ReadPrefabs(istream&);
+	bool ReadInstances(istream&);
+	bool ReadLights(istream&);
+	bool SkipToData(istream&);
+	int FindShader(const char*);
+
+	void ReleasePrefabs();
+	void ReleaseInstances();
+	void ReleaseLights();
+
+private:
+	int m_prefabCount;
+	PrefabType* m_prefabs;
+	int m_instanceCount;
+	InstanceDataType m_instances;
+	int m_lightCount;
+	LightDataType m_lights;
+};
+
+#endif
\ No newline at end of file
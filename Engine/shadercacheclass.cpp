@@ -0,0 +1,247 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: shadercacheclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "shadercacheclass.h"
+
+
+ShaderCacheClass::ShaderCacheClass()
+{
+	m_directory[0] = 0;
+	m_hitCount = 0;
+	m_missCount = 0;
+}
+
+
+ShaderCacheClass::ShaderCacheClass(const ShaderCacheClass& other)
+{
+}
+
+
+ShaderCacheClass::~ShaderCacheClass()
+{
+}
+
+
+bool ShaderCacheClass::Initialize(const wchar_t* directory)
+{
+	// Store the cache directory, leaving room for the blob filenames.
+	if(wcslen(directory) + 64 >= SHADER_CACHE_MAX_PATH)
+	{
+		return false;
+	}
+
+	wcscpy_s(m_directory, SHADER_CACHE_MAX_PATH, directory);
+
+	// When the directory cannot be created every lookup misses and the shaders are compiled like before.
+	CreateDirectory(m_directory, NULL);
+
+	m_hitCount = 0;
+	m_missCount = 0;
+
+	return true;
+}
+
+
+void ShaderCacheClass::Shutdown()
+{
+	return;
+}
+
+
+bool ShaderCacheClass::GetShader(const wchar_t* filename, const char* entryPoint, const char* target, ID3D10Blob** shaderBuffer,
+								 ID3D10Blob** errorMessage)
+{
+	vector<char> source;
+	wchar_t cacheFilename[SHADER_CACHE_MAX_PATH];
+	HRESULT result;
+
+
+	// Initialize the pointers this function will use to null.
+	*shaderBuffer = 0;
+	*errorMessage = 0;
+
+	// The key needs the source text, a missing file fails the same way the compiler would.
+	if(!ReadSource(filename, source))
+	{
+		return false;
+	}
+
+	swprintf_s(cacheFilename, SHADER_CACHE_MAX_PATH, L"%s/%S_%S_%016llx.cso", m_directory, entryPoint, target, HashKey(source, entryPoint, target));
+
+	// Load the bytecode straight from the cache if this exact shader has been compiled before.
+	result = D3DReadFileToBlob(cacheFilename, shaderBuffer);
+	if(SUCCEEDED(result))
+	{
+		m_hitCount++;
+		return true;
+	}
+
+	// Otherwise compile the shader code and store the bytecode for the next run.
+	m_missCount++;
+
+	result = D3DCompileFromFile(filename, NULL, NULL, entryPoint, target, SHADER_COMPILE_FLAGS, 0, shaderBuffer, errorMessage);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
+	// A cache that cannot be written only costs the next run a compile.
+	D3DWriteBlobToFile(*shaderBuffer, cacheFilename, TRUE);
+
+	return true;
+}
+
+
+bool ShaderCacheClass::BuildList(const char* listFilename, const char* logFilename)
+{
+	ifstream fin;
+	ofstream log;
+	char filename[SHADER_CACHE_MAX_PATH], entryPoint[128], target[16], message[SHADER_CACHE_MAX_PATH + 256];
+	wchar_t wideFilename[SHADER_CACHE_MAX_PATH];
+	ID3D10Blob* shaderBuffer;
+	ID3D10Blob* errorMessage;
+	size_t convertedCount;
+	int compiledCount, failedCount;
+
+
+	// The post build step runs a Windows subsystem exe with no console, so the compiler output goes to a log file the
+	// build prints on failure and to the debugger output.
+	log.open(logFilename);
+
+	// Open the list of shaders, one source file, entry point and profile per line.
+	fin.open(listFilename);
+	if(fin.fail())
+	{
+		sprintf_s(message, sizeof(message), "%s: error: could not open the shader list\n", listFilename);
+		WriteLog(log, message);
+		return false;
+	}
+
+	compiledCount = 0;
+	failedCount = 0;
+	while(fin >> filename >> entryPoint >> target)
+	{
+		mbstowcs_s(&convertedCount, wideFilename, SHADER_CACHE_MAX_PATH, filename, _TRUNCATE);
+
+		// Compile the shader into the cache, logging the compiler output of any that fail.  The compiler already writes
+		// its errors as file(line,column): error, which Visual Studio lists like any other build error.
+		if(!GetShader(wideFilename, entryPoint, target, &shaderBuffer, &errorMessage))
+		{
+			sprintf_s(message, sizeof(message), "%s: error: %s %s failed to compile%s\n", filename, entryPoint, target,
+					  errorMessage ? "" : ", the file could not be read");
+			WriteLog(log, message);
+
+			if(errorMessage)
+			{
+				WriteLog(log, string((const char*)errorMessage->GetBufferPointer(), errorMessage->GetBufferSize()).c_str());
+				WriteLog(log, "\n");
+				errorMessage->Release();
+			}
+
+			failedCount++;
+			continue;
+		}
+
+		shaderBuffer->Release();
+		compiledCount++;
+	}
+
+	fin.close();
+
+	sprintf_s(message, sizeof(message), "%d shaders cached, %d failed\n", compiledCount, failedCount);
+	WriteLog(log, message);
+
+	log.close();
+
+	return (failedCount == 0);
+}
+
+
+int ShaderCacheClass::GetHitCount()
+{
+	return m_hitCount;
+}
+
+
+int ShaderCacheClass::GetMissCount()
+{
+	return m_missCount;
+}
+
+
+bool ShaderCacheClass::ReadSource(const wchar_t* filename, vector<char>& source)
+{
+	ifstream fin;
+	streamoff bytes;
+
+
+	fin.open(filename, ios::in | ios::binary | ios::ate);
+	if(fin.fail())
+	{
+		return false;
+	}
+
+	bytes = fin.tellg();
+	source.resize((size_t)bytes);
+
+	fin.seekg(0, ios::beg);
+	if(bytes > 0)
+	{
+		fin.read(&source[0], bytes);
+	}
+	fin.close();
+
+	return true;
+}
+
+
+unsigned long long ShaderCacheClass::HashKey(const vector<char>& source, const char* entryPoint, const char* target)
+{
+	unsigned long long hash;
+	size_t i;
+
+
+	// 64 bit FNV-1a over the source, the entry point, the profile and the compile flags.
+	hash = 14695981039346656037ULL;
+
+	for(i=0; i<source.size(); i++)
+	{
+		hash = (hash ^ (unsigned char)source[i]) * 1099511628211ULL;
+	}
+
+	for(i=0; entryPoint[i]; i++)
+	{
+		hash = (hash ^ (unsigned char)entryPoint[i]) * 1099511628211ULL;
+	}
+
+	// Fold in a zero byte after each string so the entry point and profile cannot run together.
+	hash = hash * 1099511628211ULL;
+
+	for(i=0; target[i]; i++)
+	{
+		hash = (hash ^ (unsigned char)target[i]) * 1099511628211ULL;
+	}
+	hash = hash * 1099511628211ULL;
+
+	for(i=0; i<sizeof(SHADER_COMPILE_FLAGS); i++)
+	{
+		hash = (hash ^ ((SHADER_COMPILE_FLAGS >> (i * 8)) & 0xff)) * 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+
+void ShaderCacheClass::WriteLog(ofstream& log, const char* text)
+{
+	// Send the text to the debugger output and to the log file when it could be opened.
+	OutputDebugStringA(text);
+
+	if(log.is_open())
+	{
+		log << text;
+		log.flush();
+	}
+
+	return;
+}
\ No newline at end of file
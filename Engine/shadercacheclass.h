@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: shadercacheclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SHADERCACHECLASS_H_
+#define _SHADERCACHECLASS_H_
+
+
+/////////////
+// LINKING //
+/////////////
+#pragma comment(lib, "d3dcompiler.lib")
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <windows.h>
+#include <d3dcompiler.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <vector>
+#include <string>
+using namespace std;
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int SHADER_CACHE_MAX_PATH = 260;
+const UINT SHADER_COMPILE_FLAGS = D3D10_SHADER_ENABLE_STRICTNESS;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: ShaderCacheClass
+//
+// Keeps compiled shader bytecode on disk so the shaders are only compiled when their source changes.  Every blob is
+// stored under a key hashed from the source text, the entry point, the profile and the compile flags, so an edited
+// shader simply misses the cache.  BuildList fills the cache ahead of time and is run by the post build step, it logs
+// the compiler output to a file since the exe has no console.
+////////////////////////////////////////////////////////////////////////////////
+class ShaderCacheClass
+{
+public:
+	ShaderCacheClass();
+	ShaderCacheClass(const ShaderCacheClass&);
+	~ShaderCacheClass();
+
+	bool Initialize(const wchar_t*);
+	void Shutdown();
+
+	bool GetShader(const wchar_t*, const char*, const char*, ID3D10Blob**, ID3D10Blob**);
+	bool BuildList(const char*, const char*);
+
+	int GetHitCount();
+	int GetMissCount();
+
+private:
+	bool ReadSource(const wchar_t*, vector<char>&);
+	unsigned long long HashKey(const vector<char>&, const char*, const char*);
+	void WriteLog(ofstream&, const char*);
+
+private:
+	wchar_t m_directory[SHADER_CACHE_MAX_PATH];
+	int m_hitCount;
+	int m_missCount;
+};
+
+#endif
\ No newline at end of file
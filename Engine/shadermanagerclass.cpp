@@ -4,11 +4,50 @@
 #include "shadermanagerclass.h"
 
 
+template <class T>
+static bool CreateOnFirstUse(T*& shader, RenderDeviceClass* device)
+{
+	bool result;
+
+
+	// Nothing to do once the shader exists.
+	if(shader)
+	{
+		return true;
+	}
+
+	// Create the shader object.
+	shader = new T;
+	if(!shader)
+	{
+		return false;
+	}
+
+	// Initialize the shader object.
+	result = shader->Initialize(device);
+	if(!result)
+	{
+		shader->Shutdown();
+		delete shader;
+		shader = 0;
+		return false;
+	}
+
+	return true;
+}
+
+
 ShaderManagerClass::ShaderManagerClass()
 {
+	m_Device = 0;
 	m_TextureShader = 0;
+	m_SkyShader = 0;
+	m_DepthShader = 0;
 	m_LightShader = 0;
 	m_BumpMapShader = 0;
+	m_DeferredShader = 0;
+	m_DeferredLightShader = 0;
+	m_UpscaleShader = 0;
 }
 
 
@@ -22,62 +61,46 @@ ShaderManagerClass::~ShaderManagerClass()
 }
 
 
-bool ShaderManagerClass::Initialize(ID3D11Device* device, HWND hwnd)
+bool ShaderManagerClass::Initialize(RenderDeviceClass* device)
 {
-	bool result;
-
-
-	// Create the texture shader object.
-	m_TextureShader = new TextureShaderClass;
-	if(!m_TextureShader)
+	if(!device)
 	{
 		return false;
 	}
 
-	// Initialize the texture shader object.
-	result = m_TextureShader->Initialize(device, hwnd);
-	if(!result)
-	{
-		MessageBox(hwnd, L"Could not initialize the texture shader object.", L"Error", MB_OK);
-		return false;
-	}
+	// Store the device, the shader objects are created on their first draw.
+	m_Device = device;
 
-	// Create the light shader object.
-	m_LightShader = new LightShaderClass;
-	if(!m_LightShader)
-	{
-		return false;
-	}
+	return true;
+}
 
-	// Initialize the light shader object.
-	result = m_LightShader->Initialize(device, hwnd);
-	if(!result)
+
+void ShaderManagerClass::Shutdown()
+{
+	// Release the upscale shader object.
+	if(m_UpscaleShader)
 	{
-		MessageBox(hwnd, L"Could not initialize the light shader object.", L"Error", MB_OK);
-		return false;
+		m_UpscaleShader->Shutdown();
+		delete m_UpscaleShader;
+		m_UpscaleShader = 0;
 	}
 
-	// Create the bump map shader object.
-	m_BumpMapShader = new BumpMapShaderClass;
-	if(!m_BumpMapShader)
+	// Release the deferred light shader object.
+	if(m_DeferredLightShader)
 	{
-		return false;
+		m_DeferredLightShader->Shutdown();
+		delete m_DeferredLightShader;
+		m_DeferredLightShader = 0;
 	}
 
-	// Initialize the bump map shader object.
-	result = m_BumpMapShader->Initialize(device, hwnd);
-	if(!result)
+	// Release the deferred shader object.
+	if(m_DeferredShader)
 	{
-		MessageBox(hwnd, L"Could not initialize the bump map shader object.", L"Error", MB_OK);
-		return false;
+		m_DeferredShader->Shutdown();
+		delete m_DeferredShader;
+		m_DeferredShader = 0;
 	}
 
-	return true;
-}
-
-
-void ShaderManagerClass::Shutdown()
-{
 	// Release the bump map shader object.
 	if(m_BumpMapShader)
 	{
@@ -94,6 +117,22 @@ void ShaderManagerClass::Shutdown()
 		m_LightShader = 0;
 	}
 
+	// Release the depth shader object.
+	if(m_DepthShader)
+	{
+		m_DepthShader->Shutdown();
+		delete m_DepthShader;
+		m_DepthShader = 0;
+	}
+
+	// Release the sky shader object.
+	if(m_SkyShader)
+	{
+		m_SkyShader->Shutdown();
+		delete m_SkyShader;
+		m_SkyShader = 0;
+	}
+
 	// Release the texture shader object.
 	if(m_TextureShader)
 	{
@@ -106,14 +145,67 @@ void ShaderManagerClass::Shutdown()
 }
 
 
-bool ShaderManagerClass::RenderTextureShader(ID3D11DeviceContext* device, int indexCount, const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix,
-											 ID3D11ShaderResourceView* texture)
+bool ShaderManagerClass::RenderTextureShader(int indexCount, const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix,
+											 int texture)
 {
 	bool result;
 
 
+	// Create the shader object the first time it is used.
+	result = CreateOnFirstUse(m_TextureShader, m_Device);
+	if(!result)
+	{
+		return false;
+	}
+
 	// Render the model using the texture shader.
-	result = m_TextureShader->Render(device, indexCount, worldMatrix, viewMatrix, projectionMatrix, texture);
+	result = m_TextureShader->Render(indexCount, worldMatrix, viewMatrix, projectionMatrix, texture);
+	if(!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+bool ShaderManagerClass::RenderSkyShader(const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix, int texture)
+{
+	bool result;
+
+
+	// Create the shader object the first time it is used.
+	result = CreateOnFirstUse(m_SkyShader, m_Device);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Render the sky behind everything drawn so far using the sky shader.
+	result = m_SkyShader->Render(viewMatrix, projectionMatrix, texture);
+	if(!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+bool ShaderManagerClass::RenderDepthShader(int indexCount, const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix)
+{
+	bool result;
+
+
+	// Create the shader object the first time it is used.
+	result = CreateOnFirstUse(m_DepthShader, m_Device);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Render the model depth only using the depth shader.
+	result = m_DepthShader->Render(indexCount, worldMatrix, viewMatrix, projectionMatrix);
 	if(!result)
 	{
 		return false;
@@ -123,15 +215,21 @@ bool ShaderManagerClass::RenderTextureShader(ID3D11DeviceContext* device, int in
 }
 
 
-bool ShaderManagerClass::RenderLightShader(ID3D11DeviceContext* deviceContext, int indexCount, const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix,
-	ID3D11ShaderResourceView* texture, XMFLOAT3 lightDirection, XMFLOAT4 ambient, XMFLOAT4 diffuse,
-	XMFLOAT3 cameraPosition, XMFLOAT4 specular, float specularPower)
+bool ShaderManagerClass::RenderLightShader(int indexCount, const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix,
+	int texture, XMFLOAT3 lightDirection, XMFLOAT4 ambient, XMFLOAT4 diffuse, XMFLOAT3 cameraPosition, XMFLOAT4 specular, float specularPower)
 {
 	bool result;
 
 
+	// Create the shader object the first time it is used.
+	result = CreateOnFirstUse(m_LightShader, m_Device);
+	if(!result)
+	{
+		return false;
+	}
+
 	// Render the model using the light shader.
-	result = m_LightShader->Render(deviceContext, indexCount, worldMatrix, viewMatrix, projectionMatrix, texture, lightDirection, ambient, diffuse, cameraPosition, 
+	result = m_LightShader->Render(indexCount, worldMatrix, viewMatrix, projectionMatrix, texture, lightDirection, ambient, diffuse, cameraPosition, 
 								   specular, specularPower);
 	if(!result)
 	{
@@ -142,19 +240,171 @@ bool ShaderManagerClass::RenderLightShader(ID3D11DeviceContext* deviceContext, i
 }
 
 
-bool ShaderManagerClass::RenderBumpMapShader(ID3D11DeviceContext* deviceContext, int indexCount, const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix,
-	ID3D11ShaderResourceView* colorTexture, ID3D11ShaderResourceView* normalTexture, XMFLOAT3 lightDirection,
-											 XMFLOAT4 diffuse)
+bool ShaderManagerClass::RenderLightShaderInstanced(int indexCount, int instanceCount, const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix,
+	const XMMATRIX &projectionMatrix, int texture, XMFLOAT3 lightDirection, XMFLOAT4 ambient, XMFLOAT4 diffuse, XMFLOAT3 cameraPosition,
+	XMFLOAT4 specular, float specularPower)
+{
+	bool result;
+
+
+	// Create the shader object the first time it is used.
+	result = CreateOnFirstUse(m_LightShader, m_Device);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Render every instance of the model using the light shader.
+	result = m_LightShader->RenderInstanced(indexCount, instanceCount, worldMatrix, viewMatrix, projectionMatrix, texture, lightDirection, ambient,
+											diffuse, cameraPosition, specular, specularPower);
+	if(!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+bool ShaderManagerClass::RenderBumpMapShader(int indexCount, const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix,
+	int colorTexture, int normalTexture, XMFLOAT3 lightDirection, XMFLOAT4 diffuse)
 {
 	bool result;
 
 
+	// Create the shader object the first time it is used.
+	result = CreateOnFirstUse(m_BumpMapShader, m_Device);
+	if(!result)
+	{
+		return false;
+	}
+
 	// Render the model using the bump map shader.
-	result = m_BumpMapShader->Render(deviceContext, indexCount, worldMatrix, viewMatrix, projectionMatrix, colorTexture, normalTexture, lightDirection, diffuse);
+	result = m_BumpMapShader->Render(indexCount, worldMatrix, viewMatrix, projectionMatrix, colorTexture, normalTexture, lightDirection, diffuse);
+	if(!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+bool ShaderManagerClass::RenderDeferredShader(int indexCount, const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix,
+	const XMMATRIX &projectionMatrix, int texture, float specularPower)
+{
+	bool result;
+
+
+	// Create the shader object the first time it is used.
+	result = CreateOnFirstUse(m_DeferredShader, m_Device);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Render the model into the G-buffer using the deferred shader.
+	result = m_DeferredShader->Render(indexCount, worldMatrix, viewMatrix, projectionMatrix, texture, specularPower);
+	if(!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+bool ShaderManagerClass::RenderDeferredLightShader(int colorTexture, int normalTexture, int depthTexture, const XMMATRIX &viewMatrix,
+	const XMMATRIX &projectionMatrix, XMFLOAT3 lightDirection, XMFLOAT4 ambient, XMFLOAT4 diffuse, XMFLOAT4 specular)
+{
+	bool result;
+
+
+	// Create the shader object the first time it is used.
+	result = CreateOnFirstUse(m_DeferredLightShader, m_Device);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Light the G-buffer using the deferred light shader.
+	result = m_DeferredLightShader->Render(colorTexture, normalTexture, depthTexture, viewMatrix, projectionMatrix, lightDirection, ambient,
+										   diffuse, specular);
+	if(!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+bool ShaderManagerClass::RenderUpscaleShader(int texture, int textureWidth, int textureHeight, int drawnWidth, int drawnHeight, float sharpness)
+{
+	bool result;
+
+
+	// Create the shader object the first time it is used.
+	result = CreateOnFirstUse(m_UpscaleShader, m_Device);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Stretch the scene over the screen using the upscale shader.
+	result = m_UpscaleShader->Render(texture, textureWidth, textureHeight, drawnWidth, drawnHeight, sharpness);
 	if(!result)
 	{
 		return false;
 	}
 
 	return true;
+}
+
+
+int ShaderManagerClass::GetTexturePipeline()
+{
+	bool result;
+
+
+	// The caller is about to draw with the shader, so create it now if it does not exist yet.
+	result = CreateOnFirstUse(m_TextureShader, m_Device);
+	if(!result)
+	{
+		return 0;
+	}
+
+	return m_TextureShader->GetPipeline();
+}
+
+
+int ShaderManagerClass::GetLightPipeline()
+{
+	bool result;
+
+
+	// The caller is about to draw with the shader, so create it now if it does not exist yet.
+	result = CreateOnFirstUse(m_LightShader, m_Device);
+	if(!result)
+	{
+		return 0;
+	}
+
+	return m_LightShader->GetPipeline();
+}
+
+
+int ShaderManagerClass::GetDeferredPipeline()
+{
+	bool result;
+
+
+	// The caller is about to draw with the shader, so create it now if it does not exist yet.
+	result = CreateOnFirstUse(m_DeferredShader, m_Device);
+	if(!result)
+	{
+		return 0;
+	}
+
+	return m_DeferredShader->GetPipeline();
 }
\ No newline at end of file
@@ -8,14 +8,22 @@
 ///////////////////////
 // MY CLASS INCLUDES //
 ///////////////////////
-#include "d3dclass.h"
+#include "renderdeviceclass.h"
 #include "textureshaderclass.h"
+#include "skyshaderclass.h"
+#include "depthshaderclass.h"
 #include "lightshaderclass.h"
 #include "bumpmapshaderclass.h"
+#include "deferredshaderclass.h"
+#include "deferredlightshaderclass.h"
+#include "upscaleshaderclass.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: ShaderManagerClass
+//
+// Owns the shader objects and creates each one the first time something is drawn with it, so a scene that never uses
+// a shader never loads it.
 ////////////////////////////////////////////////////////////////////////////////
 class ShaderManagerClass
 {
@@ -24,21 +32,42 @@ public:
 	ShaderManagerClass(const ShaderManagerClass&);
 	~ShaderManagerClass();
 
-	bool Initialize(ID3D11Device*, HWND);
+	bool Initialize(RenderDeviceClass*);
 	void Shutdown();
 
-	bool RenderTextureShader(ID3D11DeviceContext*, int, const XMMATRIX&, const XMMATRIX&, const XMMATRIX&, ID3D11ShaderResourceView*);
+	bool RenderTextureShader(int, const XMMATRIX&, const XMMATRIX&, const XMMATRIX&, int);
 
-	bool RenderLightShader(ID3D11DeviceContext*, int, const XMMATRIX&, const XMMATRIX&, const XMMATRIX&, ID3D11ShaderResourceView*,
-		XMFLOAT3, XMFLOAT4, XMFLOAT4, XMFLOAT3, XMFLOAT4, float);
+	bool RenderSkyShader(const XMMATRIX&, const XMMATRIX&, int);
 
-	bool RenderBumpMapShader(ID3D11DeviceContext*, int, const XMMATRIX&, const XMMATRIX&, const XMMATRIX&, ID3D11ShaderResourceView*,
-		ID3D11ShaderResourceView*, XMFLOAT3, XMFLOAT4);
+	bool RenderDepthShader(int, const XMMATRIX&, const XMMATRIX&, const XMMATRIX&);
+
+	bool RenderLightShader(int, const XMMATRIX&, const XMMATRIX&, const XMMATRIX&, int, XMFLOAT3, XMFLOAT4, XMFLOAT4, XMFLOAT3, XMFLOAT4,
+		float);
+	bool RenderLightShaderInstanced(int, int, const XMMATRIX&, const XMMATRIX&, const XMMATRIX&, int, XMFLOAT3, XMFLOAT4, XMFLOAT4, XMFLOAT3,
+		XMFLOAT4, float);
+
+	bool RenderBumpMapShader(int, const XMMATRIX&, const XMMATRIX&, const XMMATRIX&, int, int, XMFLOAT3, XMFLOAT4);
+
+	bool RenderDeferredShader(int, const XMMATRIX&, const XMMATRIX&, const XMMATRIX&, int, float);
+
+	bool RenderDeferredLightShader(int, int, int, const XMMATRIX&, const XMMATRIX&, XMFLOAT3, XMFLOAT4, XMFLOAT4, XMFLOAT4);
+
+	bool RenderUpscaleShader(int, int, int, int, int, float);
+
+	int GetTexturePipeline();
+	int GetLightPipeline();
+	int GetDeferredPipeline();
 
 private:
+	RenderDeviceClass* m_Device;
 	TextureShaderClass* m_TextureShader;
+	SkyShaderClass* m_SkyShader;
+	DepthShaderClass* m_DepthShader;
 	LightShaderClass* m_LightShader;
 	BumpMapShaderClass* m_BumpMapShader;
+	DeferredShaderClass* m_DeferredShader;
+	DeferredLightShaderClass* m_DeferredLightShader;
+	UpscaleShaderClass* m_UpscaleShader;
 };
 
 #endif
\ No newline at end of file
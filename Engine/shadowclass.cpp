@@ -0,0 +1,412 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: shadowclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "shadowclass.h"
+
+
+ShadowClass::ShadowClass()
+{
+	int i;
+
+
+	m_Device = 0;
+	m_mapSize = 0;
+	m_screenNear = 0.0f;
+	m_cascadeCount = 0;
+	m_staticUpdateCount = 0;
+	m_shadowBuffer = 0;
+
+	for(i=0; i<SHADOW_CASCADES; i++)
+	{
+		m_splits[i] = 0.0f;
+		m_maps[i] = 0;
+		m_staticMaps[i] = 0;
+	}
+}
+
+
+ShadowClass::ShadowClass(const ShadowClass& other)
+{
+}
+
+
+ShadowClass::~ShadowClass()
+{
+}
+
+
+bool ShadowClass::Initialize(RenderDeviceClass* device, int mapSize, float shadowDistance, float screenNear)
+{
+	float fraction, logSplit, linearSplit;
+	int i;
+
+
+	if(!device || mapSize <= 0 || screenNear <= 0.0f || shadowDistance <= screenNear)
+	{
+		return false;
+	}
+
+	m_Device = device;
+	m_mapSize = mapSize;
+	m_screenNear = screenNear;
+
+	// Place the splits between the logarithmic and the even spacing of the shadow distance, the logarithmic one keeps
+	// the texel density even on screen and the even one stops the near cascade from getting too thin.
+	for(i=0; i<SHADOW_CASCADES; i++)
+	{
+		fraction = (float)(i + 1) / (float)SHADOW_CASCADES;
+		logSplit = screenNear * powf(shadowDistance / screenNear, fraction);
+		linearSplit = screenNear + (shadowDistance - screenNear) * fraction;
+		m_splits[i] = SHADOW_SPLIT_LAMBDA * logSplit + (1.0f - SHADOW_SPLIT_LAMBDA) * linearSplit;
+	}
+
+	// Nothing has been rendered into the maps yet.
+	memset(m_cascades, 0, sizeof(m_cascades));
+	m_cascadeCount = 0;
+	m_staticUpdateCount = 0;
+
+	// Create a live depth map for every cascade and a map for the static casters of every cached cascade.
+	for(i=0; i<SHADOW_CASCADES; i++)
+	{
+		m_maps[i] = m_Device->CreateDepthTarget(mapSize, mapSize);
+		if(!m_maps[i])
+		{
+			return false;
+		}
+
+		if(i >= SHADOW_FIRST_CACHED_CASCADE)
+		{
+			m_staticMaps[i] = m_Device->CreateDepthTarget(mapSize, mapSize);
+			if(!m_staticMaps[i])
+			{
+				return false;
+			}
+		}
+	}
+
+	// Create the dynamic shadow constant buffer that is in the light pixel shaders.
+	m_shadowBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_CONSTANT_BUFFER, NULL, sizeof(ShadowBufferType));
+	if(!m_shadowBuffer)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void ShadowClass::Shutdown()
+{
+	int i;
+
+
+	// Release the constant buffer and the depth maps.
+	if(m_Device)
+	{
+		m_Device->ReleaseResource(m_shadowBuffer);
+		for(i=0; i<SHADOW_CASCADES; i++)
+		{
+			m_Device->ReleaseResource(m_staticMaps[i]);
+			m_Device->ReleaseResource(m_maps[i]);
+		}
+	}
+
+	m_shadowBuffer = 0;
+	for(i=0; i<SHADOW_CASCADES; i++)
+	{
+		m_staticMaps[i] = 0;
+		m_maps[i] = 0;
+	}
+
+	m_Device = 0;
+
+	return;
+}
+
+
+void ShadowClass::Update(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, const XMFLOAT3& lightDirection)
+{
+	XMMATRIX inverseViewMatrix;
+	XMFLOAT3 direction, center;
+	XMFLOAT4X4 projection;
+	float tanX, tanY, nearDepth, radius, distance, angle;
+	int i;
+
+
+	// The half angle tangents of the view frustum come straight from the projection scale.
+	XMStoreFloat4x4(&projection, projectionMatrix);
+	tanX = 1.0f / projection._11;
+	tanY = 1.0f / projection._22;
+
+	inverseViewMatrix = XMMatrixInverse(NULL, viewMatrix);
+	XMStoreFloat3(&direction, XMVector3Normalize(XMLoadFloat3(&lightDirection)));
+
+	for(i=0; i<SHADOW_CASCADES; i++)
+	{
+		// Find the bounding sphere of the slice of the view frustum the cascade covers.
+		nearDepth = (i == 0) ? m_screenNear : m_splits[i - 1];
+		FitSphere(nearDepth, m_splits[i], tanX, tanY, inverseViewMatrix, center, radius);
+
+		// The near cascades follow the sphere every frame.
+		if(i < SHADOW_FIRST_CACHED_CASCADE)
+		{
+			BuildMatrices(i, center, radius, direction);
+			m_cascades[i].staticUpdate = false;
+			continue;
+		}
+
+		// A cached cascade stays valid while the light has barely turned and the slice is still inside the padded sphere
+		// its static casters were rendered for.
+		if(m_cascades[i].cached)
+		{
+			angle = XMVectorGetX(XMVector3Dot(XMLoadFloat3(&direction), XMLoadFloat3(&m_cascades[i].lightDirection)));
+			distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&center), XMLoadFloat3(&m_cascades[i].center))));
+
+			if(angle >= SHADOW_CACHE_ANGLE && distance + radius <= m_cascades[i].radius)
+			{
+				m_cascades[i].staticUpdate = false;
+				continue;
+			}
+		}
+
+		// Otherwise refit it around the slice with room for the camera to move, the static casters must be drawn again.
+		m_cascades[i].lightDirection = direction;
+		m_cascades[i].cached = true;
+		m_cascades[i].staticUpdate = true;
+		BuildMatrices(i, center, radius * SHADOW_CACHE_PADDING, direction);
+		m_staticUpdateCount++;
+	}
+
+	m_cascadeCount = SHADOW_CASCADES;
+
+	return;
+}
+
+
+void ShadowClass::Invalidate()
+{
+	int i;
+
+
+	// Make every cached cascade draw its static casters again on the next update.
+	for(i=0; i<SHADOW_CASCADES; i++)
+	{
+		m_cascades[i].cached = false;
+	}
+
+	return;
+}
+
+
+bool ShadowClass::IsCascadeCached(int cascade)
+{
+	return cascade >= SHADOW_FIRST_CACHED_CASCADE && cascade < SHADOW_CASCADES;
+}
+
+
+bool ShadowClass::NeedsStaticUpdate(int cascade)
+{
+	if(cascade < 0 || cascade >= SHADOW_CASCADES)
+	{
+		return false;
+	}
+
+	return m_cascades[cascade].staticUpdate;
+}
+
+
+void ShadowClass::GetCascadeMatrices(int cascade, XMMATRIX& viewMatrix, XMMATRIX& projectionMatrix)
+{
+	if(cascade < 0 || cascade >= SHADOW_CASCADES)
+	{
+		return;
+	}
+
+	viewMatrix = XMLoadFloat4x4(&m_cascades[cascade].viewMatrix);
+	projectionMatrix = XMLoadFloat4x4(&m_cascades[cascade].projectionMatrix);
+
+	return;
+}
+
+
+void ShadowClass::GetCascadeSphere(int cascade, XMFLOAT3& center, float& radius)
+{
+	if(cascade < 0 || cascade >= SHADOW_CASCADES)
+	{
+		return;
+	}
+
+	center = m_cascades[cascade].center;
+	radius = m_cascades[cascade].radius;
+
+	return;
+}
+
+
+float ShadowClass::GetSplitDepth(int cascade)
+{
+	if(cascade < 0 || cascade >= SHADOW_CASCADES)
+	{
+		return 0.0f;
+	}
+
+	return m_splits[cascade];
+}
+
+
+int ShadowClass::GetStaticUpdateCount()
+{
+	return m_staticUpdateCount;
+}
+
+
+void ShadowClass::SetStaticTarget(int cascade)
+{
+	if(!IsCascadeCached(cascade))
+	{
+		return;
+	}
+
+	// Draw the static casters into their own cleared map.
+	m_Device->SetRenderTargets(NULL, 0, m_staticMaps[cascade]);
+	m_Device->ClearDepthTarget(m_staticMaps[cascade], 1.0f);
+
+	return;
+}
+
+
+void ShadowClass::SetTarget(int cascade)
+{
+	if(cascade < 0 || cascade >= SHADOW_CASCADES)
+	{
+		return;
+	}
+
+	// A cached cascade starts from its static casters, the others from an empty map.
+	if(IsCascadeCached(cascade))
+	{
+		m_Device->CopyTarget(m_maps[cascade], m_staticMaps[cascade]);
+		m_Device->SetRenderTargets(NULL, 0, m_maps[cascade]);
+	}
+	else
+	{
+		m_Device->SetRenderTargets(NULL, 0, m_maps[cascade]);
+		m_Device->ClearDepthTarget(m_maps[cascade], 1.0f);
+	}
+
+	return;
+}
+
+
+bool ShadowClass::Render()
+{
+	ShadowBufferType shadowBuffer;
+	XMMATRIX textureMatrix;
+	float splits[4], bias[4];
+	bool result;
+	int i;
+
+
+	// Map the light clip space to texture coordinates, y points down in the texture.
+	textureMatrix = XMMatrixSet(0.5f, 0.0f, 0.0f, 0.0f,
+								0.0f, -0.5f, 0.0f, 0.0f,
+								0.0f, 0.0f, 1.0f, 0.0f,
+								0.5f, 0.5f, 0.0f, 1.0f);
+
+	memset(splits, 0, sizeof(splits));
+	memset(bias, 0, sizeof(bias));
+	memset(&shadowBuffer, 0, sizeof(shadowBuffer));
+
+	// Transpose the matrices to prepare them for the shader.
+	for(i=0; i<SHADOW_CASCADES; i++)
+	{
+		shadowBuffer.shadowMatrices[i] = XMMatrixTranspose(XMLoadFloat4x4(&m_cascades[i].viewMatrix) * XMLoadFloat4x4(&m_cascades[i].projectionMatrix) *
+														   textureMatrix);
+		splits[i] = m_splits[i];
+		bias[i] = m_cascades[i].bias;
+	}
+
+	// A cascade count of 0 until the first update leaves everything unshadowed.
+	shadowBuffer.cascadeSplits = XMFLOAT4(splits[0], splits[1], splits[2], splits[3]);
+	shadowBuffer.cascadeBias = XMFLOAT4(bias[0], bias[1], bias[2], bias[3]);
+	shadowBuffer.cascadeCount = (unsigned int)m_cascadeCount;
+	shadowBuffer.mapSize = (float)m_mapSize;
+
+	result = m_Device->UpdateBuffer(m_shadowBuffer, &shadowBuffer, sizeof(ShadowBufferType));
+	if(!result)
+	{
+		return false;
+	}
+
+	// Bind the buffer and the live maps for the light shaders, the maps follow the cluster buffers.
+	m_Device->SetConstantBuffer(RenderDeviceClass::SHADER_STAGE_PIXEL, 3, m_shadowBuffer);
+	for(i=0; i<SHADOW_CASCADES; i++)
+	{
+		m_Device->SetTexture(6 + i, m_maps[i]);
+	}
+
+	return true;
+}
+
+
+void ShadowClass::FitSphere(float nearDepth, float farDepth, float tanX, float tanY, const XMMATRIX& inverseViewMatrix, XMFLOAT3& center,
+							float& radius)
+{
+	float slope, centerDepth;
+
+
+	// The sphere through the near and far corners of the slice has its center on the view axis.  When the slice is wide
+	// compared to its depth the center would land past the far plane, then the far corners alone bound it.
+	slope = tanX * tanX + tanY * tanY;
+	centerDepth = 0.5f * (farDepth + nearDepth) * (1.0f + slope);
+
+	if(centerDepth >= farDepth)
+	{
+		centerDepth = farDepth;
+		radius = farDepth * sqrtf(slope);
+	}
+	else
+	{
+		radius = sqrtf((farDepth - centerDepth) * (farDepth - centerDepth) + farDepth * farDepth * slope);
+	}
+
+	// Round the radius up so the size of the cascade does not flicker with float noise.
+	radius = ceilf(radius);
+
+	XMStoreFloat3(&center, XMVector3TransformCoord(XMVectorSet(0.0f, 0.0f, centerDepth, 1.0f), inverseViewMatrix));
+
+	return;
+}
+
+
+void ShadowClass::BuildMatrices(int cascade, const XMFLOAT3& center, float radius, const XMFLOAT3& direction)
+{
+	XMMATRIX viewMatrix;
+	XMVECTOR up;
+	XMFLOAT3 lightCenter;
+	float texelSize;
+
+
+	// Look along the light from the origin, with a different up vector when the light points straight up or down.
+	up = (fabsf(direction.y) > 0.99f) ? XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f) : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+	viewMatrix = XMMatrixLookToLH(XMVectorZero(), XMLoadFloat3(&direction), up);
+
+	// Snap the center of the sphere in light space to whole texels so the shadow edges do not crawl as the camera moves.
+	texelSize = 2.0f * radius / (float)m_mapSize;
+	XMStoreFloat3(&lightCenter, XMVector3TransformCoord(XMLoadFloat3(&center), viewMatrix));
+	lightCenter.x = floorf(lightCenter.x / texelSize) * texelSize;
+	lightCenter.y = floorf(lightCenter.y / texelSize) * texelSize;
+
+	// Cover the sphere with the box and stretch it toward the light so casters outside the view still land in the map.
+	XMStoreFloat4x4(&m_cascades[cascade].viewMatrix, viewMatrix);
+	XMStoreFloat4x4(&m_cascades[cascade].projectionMatrix, XMMatrixOrthographicOffCenterLH(lightCenter.x - radius, lightCenter.x + radius,
+					lightCenter.y - radius, lightCenter.y + radius, lightCenter.z - radius - SHADOW_CASTER_DISTANCE, lightCenter.z + radius));
+
+	// Push the compared depth back by a couple of texels of world distance to stop the surfaces shadowing themselves.
+	m_cascades[cascade].bias = SHADOW_DEPTH_BIAS * texelSize / (2.0f * radius + SHADOW_CASTER_DISTANCE);
+
+	m_cascades[cascade].center = center;
+	m_cascades[cascade].radius = radius;
+
+	return;
+}
\ No newline at end of file
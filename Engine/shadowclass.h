@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: shadowclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SHADOWCLASS_H_
+#define _SHADOWCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <math.h>
+#include <string.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int SHADOW_CASCADES = 3;
+const int SHADOW_MAP_SIZE = 2048;
+const float SHADOW_DISTANCE = 800.0f;
+const float SHADOW_SPLIT_LAMBDA = 0.75f;
+const int SHADOW_FIRST_CACHED_CASCADE = 1;
+const float SHADOW_CACHE_PADDING = 1.25f;
+const float SHADOW_CACHE_ANGLE = 0.9999f;
+const float SHADOW_CASTER_DISTANCE = 500.0f;
+const float SHADOW_DEPTH_BIAS = 2.0f;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: ShadowClass
+//
+// Cascaded shadow maps for the directional light.  The view frustum up to the shadow distance is split into cascades
+// and each one is covered by a light space box around the bounding sphere of its slice.  The far cascades only change
+// when the light turns or the camera leaves the padded sphere they were rendered for, so their static casters are kept
+// in a map of their own that is copied into the live map every frame before the dynamic casters are drawn on top.  The
+// near cascade follows the camera every frame.  The fitting and the caching decisions only need the matrices, so they
+// can be checked without drawing anything.
+////////////////////////////////////////////////////////////////////////////////
+class ShadowClass
+{
+private:
+	// The layout of the ShadowBuffer in light.ps and deferredlight.ps.
+	struct ShadowBufferType
+	{
+		XMMATRIX shadowMatrices[SHADOW_CASCADES];
+		XMFLOAT4 cascadeSplits;
+		XMFLOAT4 cascadeBias;
+		unsigned int cascadeCount;
+		float mapSize;
+		XMFLOAT2 padding;
+	};
+
+	struct CascadeType
+	{
+		XMFLOAT3 center;
+		float radius;
+		XMFLOAT3 lightDirection;
+		bool cached;
+		bool staticUpdate;
+		XMFLOAT4X4 viewMatrix;
+		XMFLOAT4X4 projectionMatrix;
+		float bias;
+	};
+
+public:
+	ShadowClass();
+	ShadowClass(const ShadowClass&);
+	~ShadowClass();
+
+	bool Initialize(RenderDeviceClass*, int, float, float);
+	void Shutdown();
+
+	void Update(const XMMATRIX&, const XMMATRIX&, const XMFLOAT3&);
+	void Invalidate();
+
+	bool IsCascadeCached(int);
+	bool NeedsStaticUpdate(int);
+	void GetCascadeMatrices(int, XMMATRIX&, XMMATRIX&);
+	void GetCascadeSphere(int, XMFLOAT3&, float&);
+	float GetSplitDepth(int);
+	int GetStaticUpdateCount();
+
+	void SetStaticTarget(int);
+	void SetTarget(int);
+	bool Render();
+
+private:
+	static void FitSphere(float, float, float, float, const XMMATRIX&, XMFLOAT3&, float&);
+	void BuildMatrices(int, const XMFLOAT3&, float, const XMFLOAT3&);
+
+private:
+	RenderDeviceClass* m_Device;
+	int m_mapSize;
+	float m_screenNear;
+	float m_splits[SHADOW_CASCADES];
+	CascadeType m_cascades[SHADOW_CASCADES];
+	int m_cascadeCount;
+	int m_staticUpdateCount;
+
+	int m_maps[SHADOW_CASCADES];
+	int m_staticMaps[SHADOW_CASCADES];
+	int m_shadowBuffer;
+};
+
+#endif
\ No newline at end of file
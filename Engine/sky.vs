@@ -0,0 +1,48 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: sky.vs
+////////////////////////////////////////////////////////////////////////////////
+
+
+/////////////
+// GLOBALS //
+/////////////
+cbuffer SkyBuffer
+{
+	matrix inverseViewProjectionMatrix;
+	float farDepth;
+	float3 padding;
+};
+
+
+//////////////
+// TYPEDEFS //
+//////////////
+struct PixelInputType
+{
+	float4 position : SV_POSITION;
+	float3 ray : TEXCOORD0;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Vertex Shader
+////////////////////////////////////////////////////////////////////////////////
+PixelInputType SkyVertexShader(uint vertexId : SV_VertexID)
+{
+	PixelInputType output;
+	float4 nearPoint;
+	float2 tex;
+
+
+	// Build one triangle that covers the whole screen from the vertex index and put it on the far plane, so it only
+	// passes the depth test where no geometry was drawn.
+	tex = float2((vertexId << 1) & 2, vertexId & 2);
+	output.position = float4(tex.x * 2.0f - 1.0f, 1.0f - tex.y * 2.0f, farDepth, 1.0f);
+
+	// Take the corner back onto the near plane with the inverse view projection, which leaves out the camera position so
+	// the point is the direction of the view ray.  The point moves linearly across the screen so it can be interpolated.
+	nearPoint = mul(float4(output.position.xy, 1.0f - farDepth, 1.0f), inverseViewProjectionMatrix);
+	output.ray = nearPoint.xyz / nearPoint.w;
+
+	return output;
+}
\ No newline at end of file
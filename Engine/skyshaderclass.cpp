@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: skyshaderclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "skyshaderclass.h"
+
+
+SkyShaderClass::SkyShaderClass()
+{
+	m_Device = 0;
+	m_pipeline = 0;
+	m_skyBuffer = 0;
+}
+
+
+SkyShaderClass::SkyShaderClass(const SkyShaderClass& other)
+{
+}
+
+
+SkyShaderClass::~SkyShaderClass()
+{
+}
+
+
+bool SkyShaderClass::Initialize(RenderDeviceClass* device)
+{
+	bool result;
+
+
+	// Store the device the shader objects are created on.
+	m_Device = device;
+
+	// Initialize the vertex and pixel shaders.
+	result = InitializeShader(L"../Engine/sky.vs", L"../Engine/sky.ps");
+	if(!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void SkyShaderClass::Shutdown()
+{
+	// Shutdown the vertex and pixel shaders as well as the related objects.
+	ShutdownShader();
+
+	return;
+}
+
+
+bool SkyShaderClass::Render(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, int texture)
+{
+	bool result;
+
+
+	// Set the shader parameters that it will use for rendering.
+	result = SetShaderParameters(viewMatrix, projectionMatrix, texture);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Now cover the screen with the sky.
+	RenderShader();
+
+	return true;
+}
+
+
+int SkyShaderClass::GetPipeline()
+{
+	return m_pipeline;
+}
+
+
+bool SkyShaderClass::InitializeShader(const wchar_t* vsFilename, const wchar_t* psFilename)
+{
+	RenderDeviceClass::PipelineDescType pipelineDesc;
+
+
+	// Describe the pipeline, the vertex shader has no input and the sky texture wraps around the viewer.
+	pipelineDesc.vertexShaderFilename = vsFilename;
+	pipelineDesc.vertexShaderEntryPoint = "SkyVertexShader";
+	pipelineDesc.vertexFormat = RenderDeviceClass::VERTEX_FORMAT_NONE;
+	pipelineDesc.pixelShaderFilename = psFilename;
+	pipelineDesc.pixelShaderEntryPoint = "SkyPixelShader";
+	pipelineDesc.sampler = RenderDeviceClass::SAMPLER_LINEAR_WRAP;
+
+	// Create the pipeline.
+	m_pipeline = m_Device->CreatePipeline(pipelineDesc);
+	if(!m_pipeline)
+	{
+		return false;
+	}
+
+	// Create the dynamic sky constant buffer that is in the vertex shader.
+	m_skyBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_CONSTANT_BUFFER, NULL, sizeof(SkyBufferType));
+	if(!m_skyBuffer)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void SkyShaderClass::ShutdownShader()
+{
+	// Release the sky constant buffer.
+	if(m_skyBuffer)
+	{
+		m_Device->ReleaseResource(m_skyBuffer);
+		m_skyBuffer = 0;
+	}
+
+	// Release the pipeline.
+	if(m_pipeline)
+	{
+		m_Device->ReleasePipeline(m_pipeline);
+		m_pipeline = 0;
+	}
+
+	return;
+}
+
+
+bool SkyShaderClass::SetShaderParameters(const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, int texture)
+{
+	SkyBufferType skyBuffer;
+	XMMATRIX rotationMatrix;
+	bool result;
+
+
+	// Leave the camera position out of the view so the sky stays infinitely far away and the rays start at the origin.
+	rotationMatrix = viewMatrix;
+	rotationMatrix.r[3] = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+
+	// Transpose the inverse view projection to prepare it for the shader, the far depth pins the triangle behind
+	// everything whichever way the depth runs.
+	skyBuffer.inverseViewProjection = XMMatrixTranspose(XMMatrixInverse(NULL, XMMatrixMultiply(rotationMatrix, projectionMatrix)));
+	skyBuffer.farDepth = m_Device->GetFarDepth();
+	skyBuffer.padding = XMFLOAT3(0.0f, 0.0f, 0.0f);
+
+	result = m_Device->UpdateBuffer(m_skyBuffer, &skyBuffer, sizeof(SkyBufferType));
+	if(!result)
+	{
+		return false;
+	}
+
+	m_Device->SetConstantBuffer(RenderDeviceClass::SHADER_STAGE_VERTEX, 0, m_skyBuffer);
+
+	// Bind the sky texture.
+	m_Device->SetTexture(0, texture);
+
+	return true;
+}
+
+
+void SkyShaderClass::RenderShader()
+{
+	// Bind the shaders and the sampler in one go, the pipeline has no input layout.
+	m_Device->SetPipeline(m_pipeline);
+
+	// Render the fullscreen triangle.
+	m_Device->Draw(3);
+
+	return;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: skyshaderclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SKYSHADERCLASS_H_
+#define _SKYSHADERCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <DirectXMath.h>
+using namespace DirectX;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: SkyShaderClass
+//
+// Draws the sky as one fullscreen triangle on the far plane after the opaque geometry, so only the pixels nothing else
+// covered are shaded and there is no mesh to transform.  Each pixel rebuilds its view ray from the inverse view
+// projection without the camera position and looks the sky texture up by the direction of the ray.
+////////////////////////////////////////////////////////////////////////////////
+class SkyShaderClass
+{
+private:
+	struct SkyBufferType
+	{
+		XMMATRIX inverseViewProjection;
+		float farDepth;
+		XMFLOAT3 padding;
+	};
+
+public:
+	SkyShaderClass();
+	SkyShaderClass(const SkyShaderClass&);
+	~SkyShaderClass();
+
+	bool Initialize(RenderDeviceClass*);
+	void Shutdown();
+	bool Render(const XMMATRIX&, const XMMATRIX&, int);
+
+	int GetPipeline();
+
+private:
+	bool InitializeShader(const wchar_t*, const wchar_t*);
+	void ShutdownShader();
+
+	bool SetShaderParameters(const XMMATRIX&, const XMMATRIX&, int);
+	void RenderShader();
+
+private:
+	RenderDeviceClass* m_Device;
+	int m_pipeline;
+	int m_skyBuffer;
+};
+
+#endif
\ No newline at end of file
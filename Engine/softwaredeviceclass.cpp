@@ -0,0 +1,1681 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: softwaredeviceclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "softwaredeviceclass.h"
+
+
+static float ElapsedMilliseconds(chrono::high_resolution_clock::time_point start)
+{
+	return chrono::duration<float, milli>(chrono::high_resolution_clock::now() - start).count();
+}
+
+
+SoftwareDeviceClass::SoftwareDeviceClass()
+{
+	m_screenWidth = 0;
+	m_screenHeight = 0;
+	m_tileColumns = 0;
+	m_tileRows = 0;
+	m_threadCount = 1;
+	m_targetWidth = 0;
+	m_targetHeight = 0;
+	m_viewportWidth = 0;
+	m_viewportHeight = 0;
+	m_targetColumns = 0;
+	m_targetRows = 0;
+}
+
+
+SoftwareDeviceClass::SoftwareDeviceClass(const SoftwareDeviceClass& other)
+{
+}
+
+
+SoftwareDeviceClass::~SoftwareDeviceClass()
+{
+}
+
+
+bool SoftwareDeviceClass::Initialize(int screenWidth, int screenHeight, float screenDepth, float screenNear, int threadCount, bool reverseDepth)
+{
+	float fieldOfView, screenAspect;
+	int i;
+
+
+	if(screenWidth <= 0 || screenHeight <= 0)
+	{
+		return false;
+	}
+
+	m_screenWidth = screenWidth;
+	m_screenHeight = screenHeight;
+
+	// Build the same matrices as the Direct3D backend so the renderer sees identical transforms.
+	fieldOfView = (float)XM_PI / 4.0f;
+	screenAspect = (float)screenWidth / (float)screenHeight;
+
+	m_reverseDepth = reverseDepth;
+	XMStoreFloat4x4(&m_projectionMatrix, BuildProjectionMatrix(fieldOfView, screenAspect, screenNear, screenDepth, reverseDepth));
+	XMStoreFloat4x4(&m_worldMatrix, XMMatrixIdentity());
+	XMStoreFloat4x4(&m_orthoMatrix, XMMatrixOrthographicLH((float)screenWidth, (float)screenHeight, screenNear, screenDepth));
+
+	// Store the number of threads the tiles are rasterized on, a count of 0 uses one thread per core.
+	m_threadCount = threadCount;
+	if(m_threadCount < 1)
+	{
+		m_threadCount = (int)thread::hardware_concurrency();
+	}
+	if(m_threadCount < 1)
+	{
+		m_threadCount = 1;
+	}
+	if(m_threadCount > SOFTWARE_MAX_THREADS)
+	{
+		m_threadCount = SOFTWARE_MAX_THREADS;
+	}
+
+	// Split the screen into tiles, each with its own bin of triangles.  The render passes start out on the screen.
+	m_tileColumns = (screenWidth + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+	m_tileRows = (screenHeight + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+	m_tileTimes.assign(m_tileColumns * m_tileRows, 0.0f);
+	SetTargetSize(screenWidth, screenHeight);
+
+	// Create the color and depth buffers.
+	m_colorBuffer.assign(screenWidth * screenHeight * 4, 0);
+	m_depthBuffer.assign(screenWidth * screenHeight, GetFarDepth());
+
+	// Nothing is bound yet.
+	m_vertexBuffer = 0;
+	m_vertexStride = 0;
+	m_indexBuffer = 0;
+	m_instanceBuffer = 0;
+	m_instanceStride = 0;
+	m_vertexShader = 0;
+	m_pixelShader = 0;
+	memset(m_constantBuffers, 0, sizeof(m_constantBuffers));
+	for(i=0; i<SOFTWARE_MAX_TEXTURES; i++)
+	{
+		m_textures[i] = 0;
+	}
+	for(i=0; i<SOFTWARE_MAX_SHADER_BUFFERS; i++)
+	{
+		m_shaderBuffers[i] = 0;
+	}
+	m_depthState = DEPTH_STATE_DEFAULT;
+	m_renderTargetCount = 0;
+	m_depthTarget = 0;
+	m_clearColorPending = false;
+	m_clearDepthPending = false;
+
+	memset(m_clearColor, 0, sizeof(m_clearColor));
+	memset(&m_stageTimes, 0, sizeof(m_stageTimes));
+	ResetStatistics();
+
+	return true;
+}
+
+
+void SoftwareDeviceClass::Shutdown()
+{
+	unsigned int i;
+
+
+	// Release the resources the renderer left behind, pipelines included.
+	ClearPipelines();
+	for(i=0; i<m_resources.size(); i++)
+	{
+		ReleaseResource(i + 1);
+	}
+	m_resources.clear();
+
+	m_draws.clear();
+	m_triangles.clear();
+	m_planes.clear();
+	m_bins.clear();
+	m_colorBuffer.clear();
+	m_depthBuffer.clear();
+
+	return;
+}
+
+
+void SoftwareDeviceClass::BeginScene(float red, float green, float blue, float alpha)
+{
+	unsigned int i;
+
+
+	// Keep the clear color, every tile clears its own pixels the first time it is rasterized.
+	m_clearColor[0] = (unsigned char)(red * 255.0f + 0.5f);
+	m_clearColor[1] = (unsigned char)(green * 255.0f + 0.5f);
+	m_clearColor[2] = (unsigned char)(blue * 255.0f + 0.5f);
+	m_clearColor[3] = (unsigned char)(alpha * 255.0f + 0.5f);
+	m_clearColorPending = true;
+	m_clearDepthPending = true;
+
+	// Empty the draws and bins of the last frame, the vectors keep their memory.
+	m_draws.clear();
+	m_triangles.clear();
+	m_planes.clear();
+	for(i=0; i<m_bins.size(); i++)
+	{
+		m_bins[i].clear();
+	}
+
+	memset(&m_stageTimes, 0, sizeof(m_stageTimes));
+	m_tileTimes.assign(m_tileTimes.size(), 0.0f);
+
+	return;
+}
+
+
+void SoftwareDeviceClass::EndScene()
+{
+	// Finish the last pass of the frame.
+	Flush();
+
+	return;
+}
+
+
+int SoftwareDeviceClass::CreateBuffer(ResourceType type, const void* data, int bytes)
+{
+	SoftwareResourceType resource;
+
+
+	if(bytes <= 0)
+	{
+		return 0;
+	}
+
+	// Static buffers must be created with their contents, constant and instance buffers are filled later.
+	if(type != RESOURCE_CONSTANT_BUFFER && type != RESOURCE_INSTANCE_BUFFER && !data)
+	{
+		return 0;
+	}
+
+	if(type != RESOURCE_VERTEX_BUFFER && type != RESOURCE_INDEX_BUFFER && type != RESOURCE_CONSTANT_BUFFER && type != RESOURCE_INSTANCE_BUFFER)
+	{
+		return 0;
+	}
+
+	resource.type = type;
+	resource.bytes = bytes;
+	resource.program = -1;
+	resource.texture = 0;
+	resource.data.assign(bytes, 0);
+	if(data)
+	{
+		memcpy(&resource.data[0], data, bytes);
+	}
+
+	return AddResource(resource);
+}
+
+
+bool SoftwareDeviceClass::UpdateBuffer(int handle, const void* data, int bytes)
+{
+	// Only the constant, structured and instance buffers can be rewritten and never past their end.  A structured buffer
+	// is read when the tiles are shaded, so a frame must not rewrite one after drawing with it.
+	if((!IsResource(handle, RESOURCE_CONSTANT_BUFFER) && !IsResource(handle, RESOURCE_STRUCTURED_BUFFER) &&
+		!IsResource(handle, RESOURCE_INSTANCE_BUFFER)) || !data || bytes > m_resources[handle - 1].bytes)
+	{
+		return false;
+	}
+
+	memcpy(&m_resources[handle - 1].data[0], data, bytes);
+
+	m_statistics.bufferUpdates++;
+	m_statistics.bufferUpdateBytes += bytes;
+
+	return true;
+}
+
+
+int SoftwareDeviceClass::CreateTexture(const wchar_t* filename)
+{
+	SoftwareResourceType resource;
+	bool result;
+
+
+	// Decode the texture and build its mip chain.
+	resource.texture = new SoftwareTextureClass;
+	if(!resource.texture)
+	{
+		return 0;
+	}
+
+	result = resource.texture->Initialize(filename);
+	if(!result)
+	{
+		delete resource.texture;
+		return 0;
+	}
+
+	resource.type = RESOURCE_TEXTURE;
+	resource.bytes = resource.texture->GetBytes();
+	resource.program = -1;
+
+	return AddResource(resource);
+}
+
+
+int SoftwareDeviceClass::CreateVertexShader(const wchar_t* filename, const char* entryPoint, VertexFormatType format)
+{
+	SoftwareResourceType resource;
+
+
+	// The shader source must exist even though the C++ version of its entry point is what runs.
+	resource.bytes = GetFileBytes(filename);
+	if(resource.bytes < 0 || !entryPoint)
+	{
+		return 0;
+	}
+
+	resource.program = SoftwareShaderClass::FindVertexProgram(entryPoint);
+	if(resource.program < 0)
+	{
+		return 0;
+	}
+
+	resource.type = RESOURCE_VERTEX_SHADER;
+	resource.texture = 0;
+
+	return AddResource(resource);
+}
+
+
+int SoftwareDeviceClass::CreatePixelShader(const wchar_t* filename, const char* entryPoint)
+{
+	SoftwareResourceType resource;
+
+
+	// The shader source must exist even though the C++ version of its entry point is what runs.
+	resource.bytes = GetFileBytes(filename);
+	if(resource.bytes < 0 || !entryPoint)
+	{
+		return 0;
+	}
+
+	resource.program = SoftwareShaderClass::FindPixelProgram(entryPoint);
+	if(resource.program < 0)
+	{
+		return 0;
+	}
+
+	resource.type = RESOURCE_PIXEL_SHADER;
+	resource.texture = 0;
+
+	return AddResource(resource);
+}
+
+
+int SoftwareDeviceClass::CreateSampler()
+{
+	SoftwareResourceType resource;
+
+
+	// Textures are always sampled trilinear with wrapping like the sampler the shaders create, so there is no state.
+	resource.type = RESOURCE_SAMPLER;
+	resource.bytes = 0;
+	resource.program = -1;
+	resource.texture = 0;
+
+	return AddResource(resource);
+}
+
+
+int SoftwareDeviceClass::CreateStructuredBuffer(int elementBytes, int elementCount)
+{
+	SoftwareResourceType resource;
+
+
+	if(elementBytes <= 0 || elementCount <= 0)
+	{
+		return 0;
+	}
+
+	// The pixel programs read the elements straight from the bytes, so the buffer only needs its size.
+	resource.type = RESOURCE_STRUCTURED_BUFFER;
+	resource.bytes = elementBytes * elementCount;
+	resource.program = -1;
+	resource.texture = 0;
+	resource.data.assign(resource.bytes, 0);
+
+	return AddResource(resource);
+}
+
+
+int SoftwareDeviceClass::CreateRenderTarget(int width, int height, RenderTargetFormatType format)
+{
+	SoftwareResourceType resource;
+
+
+	if(width <= 0 || height <= 0 || GetPixelBytes(format) == 0)
+	{
+		return 0;
+	}
+
+	// Keep every format as four floats per texel, the values are rounded to the precision of the format when written.
+	resource.type = RESOURCE_RENDER_TARGET;
+	resource.bytes = width * height * GetPixelBytes(format);
+	resource.program = -1;
+	resource.texture = 0;
+	resource.width = width;
+	resource.height = height;
+	resource.format = format;
+	resource.texels.assign(width * height * 4, 0.0f);
+
+	return AddResource(resource);
+}
+
+
+int SoftwareDeviceClass::CreateDepthTarget(int width, int height)
+{
+	SoftwareResourceType resource;
+
+
+	if(width <= 0 || height <= 0)
+	{
+		return 0;
+	}
+
+	// A depth target holds one float per texel, starting out at the far plane.
+	resource.type = RESOURCE_DEPTH_TARGET;
+	resource.bytes = width * height * 4;
+	resource.program = -1;
+	resource.texture = 0;
+	resource.width = width;
+	resource.height = height;
+	resource.format = RENDER_TARGET_R32_FLOAT;
+	resource.texels.assign(width * height, GetFarDepth());
+
+	return AddResource(resource);
+}
+
+
+int SoftwareDeviceClass::CreateQuery(ResourceType type)
+{
+	SoftwareResourceType resource;
+
+
+	if(type != RESOURCE_TIMESTAMP_QUERY && type != RESOURCE_DISJOINT_QUERY)
+	{
+		return 0;
+	}
+
+	resource.type = type;
+	resource.bytes = 0;
+	resource.program = -1;
+	resource.texture = 0;
+	resource.queryValue = 0;
+
+	return AddResource(resource);
+}
+
+
+void SoftwareDeviceClass::ReleaseResource(int handle)
+{
+	SoftwareResourceType* resource;
+	int i;
+	bool bound;
+
+
+	// Ignore null and already released handles.
+	if(handle <= 0 || handle > (int)m_resources.size() || m_resources[handle - 1].type == -1)
+	{
+		return;
+	}
+
+	// Finish the draws that may still write to or read from a render or depth target and fall back to the back buffer
+	// if it is bound.
+	if(m_resources[handle - 1].type == RESOURCE_RENDER_TARGET || m_resources[handle - 1].type == RESOURCE_DEPTH_TARGET)
+	{
+		Flush();
+		bound = (m_depthTarget == handle);
+		for(i=0; i<m_renderTargetCount; i++)
+		{
+			if(m_renderTargets[i] == handle)
+			{
+				bound = true;
+			}
+		}
+
+		if(bound)
+		{
+			m_renderTargetCount = 0;
+			m_depthTarget = 0;
+			SetTargetSize(m_screenWidth, m_screenHeight);
+		}
+	}
+
+	resource = &m_resources[handle - 1];
+
+	if(resource->texture)
+	{
+		resource->texture->Shutdown();
+		delete resource->texture;
+		resource->texture = 0;
+	}
+
+	// Mark the slot as free so the next resource created can reuse it.
+	vector<unsigned char>().swap(resource->data);
+	vector<float>().swap(resource->texels);
+	resource->type = -1;
+	resource->bytes = 0;
+	resource->program = -1;
+
+	return;
+}
+
+
+void SoftwareDeviceClass::SetVertexBuffer(int handle, int stride)
+{
+	if(!IsResource(handle, RESOURCE_VERTEX_BUFFER))
+	{
+		return;
+	}
+
+	m_vertexBuffer = handle;
+	m_vertexStride = stride;
+	m_statistics.geometryChanges++;
+
+	return;
+}
+
+
+void SoftwareDeviceClass::SetIndexBuffer(int handle)
+{
+	if(!IsResource(handle, RESOURCE_INDEX_BUFFER))
+	{
+		return;
+	}
+
+	m_indexBuffer = handle;
+	m_statistics.geometryChanges++;
+
+	return;
+}
+
+
+void SoftwareDeviceClass::SetInstanceBuffer(int handle, int stride)
+{
+	if(!IsResource(handle, RESOURCE_INSTANCE_BUFFER))
+	{
+		return;
+	}
+
+	m_instanceBuffer = handle;
+	m_instanceStride = stride;
+	m_statistics.geometryChanges++;
+
+	return;
+}
+
+
+void SoftwareDeviceClass::SetShaders(int vertexShader, int pixelShader)
+{
+	// A pixel shader handle of 0 is allowed, it unbinds the pixel shader for the depth only passes.
+	if(!IsResource(vertexShader, RESOURCE_VERTEX_SHADER) || (pixelShader && !IsResource(pixelShader, RESOURCE_PIXEL_SHADER)))
+	{
+		return;
+	}
+
+	m_vertexShader = vertexShader;
+	m_pixelShader = pixelShader;
+	m_statistics.shaderChanges++;
+
+	return;
+}
+
+
+void SoftwareDeviceClass::SetConstantBuffer(ShaderStageType stage, int slot, int handle)
+{
+	if(!IsResource(handle, RESOURCE_CONSTANT_BUFFER) || slot < 0 || slot >= SOFTWARE_MAX_CONSTANT_BUFFERS)
+	{
+		return;
+	}
+
+	m_constantBuffers[stage][slot] = handle;
+	m_statistics.constantBufferChanges++;
+
+	return;
+}
+
+
+void SoftwareDeviceClass::SetTexture(int slot, int handle)
+{
+	if((!IsResource(handle, RESOURCE_TEXTURE) && !IsResource(handle, RESOURCE_RENDER_TARGET) && !IsResource(handle, RESOURCE_DEPTH_TARGET)) ||
+	   slot < 0 || slot >= SOFTWARE_MAX_TEXTURES)
+	{
+		return;
+	}
+
+	m_textures[slot] = handle;
+	m_statistics.textureChanges++;
+
+	return;
+}
+
+
+void SoftwareDeviceClass::SetShaderBuffer(int slot, int handle)
+{
+	if(!IsResource(handle, RESOURCE_STRUCTURED_BUFFER) || slot < 0 || slot >= SOFTWARE_MAX_SHADER_BUFFERS)
+	{
+		return;
+	}
+
+	m_shaderBuffers[slot] = handle;
+	m_statistics.shaderBufferChanges++;
+
+	return;
+}
+
+
+void SoftwareDeviceClass::SetSampler(int slot, int handle)
+{
+	if(!IsResource(handle, RESOURCE_SAMPLER))
+	{
+		return;
+	}
+
+	m_statistics.samplerChanges++;
+
+	return;
+}
+
+
+void SoftwareDeviceClass::SetDepthState(DepthStateType state)
+{
+	m_depthState = state;
+	m_statistics.depthStateChanges++;
+
+	return;
+}
+
+
+void SoftwareDeviceClass::SetRenderTargets(const int* targets, int count, int depthTarget)
+{
+	int i, width, height;
+
+
+	if(count < 0 || count > RENDER_MAX_TARGETS || (count > 0 && !targets))
+	{
+		return;
+	}
+
+	// The set is as big as its depth buffer, the back buffer depth is screen sized.
+	width = m_screenWidth;
+	height = m_screenHeight;
+
+	if(depthTarget)
+	{
+		if(!IsResource(depthTarget, RESOURCE_DEPTH_TARGET))
+		{
+			return;
+		}
+
+		width = m_resources[depthTarget - 1].width;
+		height = m_resources[depthTarget - 1].height;
+	}
+
+	// Every target of the set must be a live render target of the same size as the depth buffer.
+	for(i=0; i<count; i++)
+	{
+		if(!IsResource(targets[i], RESOURCE_RENDER_TARGET) || m_resources[targets[i] - 1].width != width || m_resources[targets[i] - 1].height != height)
+		{
+			return;
+		}
+	}
+
+	// Finish the pass drawn into the old targets before switching, no targets at all means the back buffer.
+	Flush();
+
+	for(i=0; i<count; i++)
+	{
+		m_renderTargets[i] = targets[i];
+	}
+	m_renderTargetCount = count;
+	m_depthTarget = depthTarget;
+
+	// Cover the new targets with the tiles.
+	SetTargetSize(width, height);
+
+	m_statistics.renderTargetChanges++;
+
+	return;
+}
+
+
+void SoftwareDeviceClass::SetViewport(int width, int height)
+{
+	// The triangles already binned were projected with the old viewport, so only the draws from here on use the new one.
+	m_viewportWidth = max(1, min(width, m_targetWidth));
+	m_viewportHeight = max(1, min(height, m_targetHeight));
+
+	return;
+}
+
+
+void SoftwareDeviceClass::ClearRenderTarget(int handle, float red, float green, float blue, float alpha)
+{
+	SoftwareResourceType* resource;
+	float color[4], texel[4];
+	int i;
+
+
+	if(!IsResource(handle, RESOURCE_RENDER_TARGET))
+	{
+		return;
+	}
+
+	// Draws waiting for the tiles may still write to the target.
+	Flush();
+
+	color[0] = red;
+	color[1] = green;
+	color[2] = blue;
+	color[3] = alpha;
+
+	resource = &m_resources[handle - 1];
+	StoreTexel(texel, resource->format, color);
+
+	for(i=0; i<resource->width * resource->height; i++)
+	{
+		memcpy(&resource->texels[i * 4], texel, sizeof(texel));
+	}
+
+	return;
+}
+
+
+void SoftwareDeviceClass::ClearDepthTarget(int handle, float depth)
+{
+	if(!IsResource(handle, RESOURCE_DEPTH_TARGET))
+	{
+		return;
+	}
+
+	// Draws waiting for the tiles may still test against the target.
+	Flush();
+
+	m_resources[handle - 1].texels.assign(m_resources[handle - 1].texels.size(), depth);
+
+	return;
+}
+
+
+void SoftwareDeviceClass::CopyTarget(int destination, int source)
+{
+	SoftwareResourceType *destinationResource, *sourceResource;
+
+
+	// Both must be render targets of the same format or both depth targets, and of the same size.
+	if(destination == source || (!IsResource(source, RESOURCE_RENDER_TARGET) && !IsResource(source, RESOURCE_DEPTH_TARGET)) ||
+	   !IsResource(destination, m_resources[source - 1].type))
+	{
+		return;
+	}
+
+	destinationResource = &m_resources[destination - 1];
+	sourceResource = &m_resources[source - 1];
+	if(destinationResource->format != sourceResource->format || destinationResource->width != sourceResource->width ||
+	   destinationResource->height != sourceResource->height)
+	{
+		return;
+	}
+
+	// The source may still be waiting to be drawn.
+	Flush();
+
+	memcpy(&destinationResource->texels[0], &sourceResource->texels[0], sourceResource->texels.size() * sizeof(float));
+
+	return;
+}
+
+
+void SoftwareDeviceClass::DrawIndexed(int indexCount)
+{
+	m_statistics.drawCalls++;
+	m_statistics.indexCount += indexCount;
+
+	// The index buffer must hold enough indices for the draw.
+	if(!IsResource(m_indexBuffer, RESOURCE_INDEX_BUFFER) || indexCount <= 0 || indexCount * (int)sizeof(unsigned int) > m_resources[m_indexBuffer - 1].bytes)
+	{
+		return;
+	}
+
+	SubmitDraw((const unsigned int*)&m_resources[m_indexBuffer - 1].data[0], indexCount, 0);
+
+	return;
+}
+
+
+void SoftwareDeviceClass::DrawIndexedInstanced(int indexCount, int instanceCount)
+{
+	const unsigned char* instanceData;
+	int i;
+
+
+	m_statistics.drawCalls++;
+	m_statistics.indexCount += indexCount * instanceCount;
+
+	// The index buffer must hold enough indices for the draw and the instance buffer a world matrix for every instance.
+	if(!IsResource(m_indexBuffer, RESOURCE_INDEX_BUFFER) || indexCount <= 0 || indexCount * (int)sizeof(unsigned int) > m_resources[m_indexBuffer - 1].bytes)
+	{
+		return;
+	}
+
+	if(!IsResource(m_instanceBuffer, RESOURCE_INSTANCE_BUFFER) || m_instanceStride < (int)sizeof(XMFLOAT4X4) || instanceCount <= 0 ||
+	   instanceCount * m_instanceStride > m_resources[m_instanceBuffer - 1].bytes)
+	{
+		return;
+	}
+
+	// Draw the instances one after the other, each placed by its own world matrix.
+	instanceData = &m_resources[m_instanceBuffer - 1].data[0];
+	for(i=0; i<instanceCount; i++)
+	{
+		SubmitDraw((const unsigned int*)&m_resources[m_indexBuffer - 1].data[0], indexCount, (const XMFLOAT4X4*)(instanceData + i * m_instanceStride));
+	}
+
+	return;
+}
+
+
+void SoftwareDeviceClass::Draw(int vertexCount)
+{
+	m_statistics.drawCalls++;
+	m_statistics.indexCount += vertexCount;
+
+	if(vertexCount <= 0)
+	{
+		return;
+	}
+
+	SubmitDraw(0, vertexCount, 0);
+
+	return;
+}
+
+
+void SoftwareDeviceClass::BeginQuery(int handle)
+{
+	// The clock never changes frequency, so a disjoint query has nothing to start.
+	return;
+}
+
+
+void SoftwareDeviceClass::EndQuery(int handle)
+{
+	if(IsResource(handle, RESOURCE_TIMESTAMP_QUERY))
+	{
+		// Finish the draws before the timestamp and read the clock in nanoseconds.
+		Flush();
+
+		m_resources[handle - 1].queryValue = (unsigned long long)chrono::duration_cast<chrono::nanoseconds>(
+			chrono::high_resolution_clock::now().time_since_epoch()).count();
+	}
+	else if(IsResource(handle, RESOURCE_DISJOINT_QUERY))
+	{
+		m_resources[handle - 1].queryValue = 1000000000;
+	}
+
+	return;
+}
+
+
+bool SoftwareDeviceClass::GetQueryData(int handle, unsigned long long& value)
+{
+	// The draws are finished by the time a query ends, so its result is there straight away.  A query that has not
+	// ended yet still holds 0.
+	if((!IsResource(handle, RESOURCE_TIMESTAMP_QUERY) && !IsResource(handle, RESOURCE_DISJOINT_QUERY)) ||
+	   m_resources[handle - 1].queryValue == 0)
+	{
+		return false;
+	}
+
+	value = m_resources[handle - 1].queryValue;
+
+	return true;
+}
+
+
+void SoftwareDeviceClass::GetProjectionMatrix(XMMATRIX& projectionMatrix)
+{
+	projectionMatrix = XMLoadFloat4x4(&m_projectionMatrix);
+	return;
+}
+
+
+void SoftwareDeviceClass::GetWorldMatrix(XMMATRIX& worldMatrix)
+{
+	worldMatrix = XMLoadFloat4x4(&m_worldMatrix);
+	return;
+}
+
+
+void SoftwareDeviceClass::GetOrthoMatrix(XMMATRIX& orthoMatrix)
+{
+	orthoMatrix = XMLoadFloat4x4(&m_orthoMatrix);
+	return;
+}
+
+
+int SoftwareDeviceClass::GetResourceBytes()
+{
+	unsigned int i;
+	int bytes;
+
+
+	// Add up the size of every live resource.
+	bytes = 0;
+	for(i=0; i<m_resources.size(); i++)
+	{
+		if(m_resources[i].type != -1)
+		{
+			bytes += m_resources[i].bytes;
+		}
+	}
+
+	return bytes;
+}
+
+
+int SoftwareDeviceClass::GetThreadCount()
+{
+	return m_threadCount;
+}
+
+
+void SoftwareDeviceClass::GetStageTimes(StageTimesType& stageTimes)
+{
+	stageTimes = m_stageTimes;
+	return;
+}
+
+
+int SoftwareDeviceClass::GetTileCount()
+{
+	return m_tileColumns * m_tileRows;
+}
+
+
+float SoftwareDeviceClass::GetTileTime(int tile)
+{
+	if(tile < 0 || tile >= (int)m_tileTimes.size())
+	{
+		return 0.0f;
+	}
+
+	return m_tileTimes[tile];
+}
+
+
+const unsigned char* SoftwareDeviceClass::GetFramebuffer()
+{
+	return m_colorBuffer.empty() ? 0 : &m_colorBuffer[0];
+}
+
+
+bool SoftwareDeviceClass::WriteFramebuffer(const char* filename)
+{
+	ofstream fout;
+	unsigned char header[18], pixel[4];
+	int i;
+
+
+	if(m_colorBuffer.empty())
+	{
+		return false;
+	}
+
+	fout.open(filename, ios::out | ios::binary);
+	if(fout.fail())
+	{
+		return false;
+	}
+
+	// Write an uncompressed 32 bit targa header with the origin in the top left corner.
+	memset(header, 0, sizeof(header));
+	header[2] = 2;
+	header[12] = (unsigned char)(m_screenWidth & 0xff);
+	header[13] = (unsigned char)(m_screenWidth >> 8);
+	header[14] = (unsigned char)(m_screenHeight & 0xff);
+	header[15] = (unsigned char)(m_screenHeight >> 8);
+	header[16] = 32;
+	header[17] = 0x28;
+	fout.write((const char*)header, sizeof(header));
+
+	// Targa stores the pixels as BGRA.
+	for(i=0; i<m_screenWidth * m_screenHeight; i++)
+	{
+		pixel[0] = m_colorBuffer[i * 4 + 2];
+		pixel[1] = m_colorBuffer[i * 4 + 1];
+		pixel[2] = m_colorBuffer[i * 4 + 0];
+		pixel[3] = m_colorBuffer[i * 4 + 3];
+		fout.write((const char*)pixel, sizeof(pixel));
+	}
+
+	fout.close();
+
+	return !fout.fail();
+}
+
+
+int SoftwareDeviceClass::AddResource(const SoftwareResourceType& resource)
+{
+	unsigned int i;
+
+
+	// Reuse the first released slot if there is one.
+	for(i=0; i<m_resources.size(); i++)
+	{
+		if(m_resources[i].type == -1)
+		{
+			m_resources[i] = resource;
+			return i + 1;
+		}
+	}
+
+	// Otherwise grow the table, handles are the slot index plus one so that 0 stays invalid.
+	m_resources.push_back(resource);
+
+	return (int)m_resources.size();
+}
+
+
+bool SoftwareDeviceClass::IsResource(int handle, int type)
+{
+	if(handle <= 0 || handle > (int)m_resources.size())
+	{
+		return false;
+	}
+
+	return m_resources[handle - 1].type == type;
+}
+
+
+const unsigned char* SoftwareDeviceClass::GetConstants(int handle)
+{
+	if(!IsResource(handle, RESOURCE_CONSTANT_BUFFER))
+	{
+		return 0;
+	}
+
+	return &m_resources[handle - 1].data[0];
+}
+
+
+void SoftwareDeviceClass::SubmitDraw(const unsigned int* indices, int indexCount, const XMFLOAT4X4* instanceWorld)
+{
+	const unsigned char* vertexConstants[SOFTWARE_MAX_CONSTANT_BUFFERS];
+	const unsigned char* pixelConstants[SOFTWARE_MAX_CONSTANT_BUFFERS];
+	SoftwareShaderClass::VertexConstantsType constants;
+	XMMATRIX world;
+	thread workers[SOFTWARE_MAX_THREADS];
+	chrono::high_resolution_clock::time_point start;
+	ClipVertexType vertices[3], clipped[4];
+	DrawType draw;
+	const unsigned char* vertexData;
+	unsigned int index;
+	int i, j, program, varyingCount, vertexCount, drawIndex, verticesPerThread, first, last, outside[6], clippedCount;
+	bool vertexInput;
+
+
+	// A draw needs a vertex shader.
+	if(!IsResource(m_vertexShader, RESOURCE_VERTEX_SHADER) || (m_pixelShader && !IsResource(m_pixelShader, RESOURCE_PIXEL_SHADER)))
+	{
+		return;
+	}
+
+	for(i=0; i<SOFTWARE_MAX_CONSTANT_BUFFERS; i++)
+	{
+		vertexConstants[i] = GetConstants(m_constantBuffers[SHADER_STAGE_VERTEX][i]);
+		pixelConstants[i] = GetConstants(m_constantBuffers[SHADER_STAGE_PIXEL][i]);
+	}
+
+	program = m_resources[m_vertexShader - 1].program;
+	varyingCount = SoftwareShaderClass::GetVaryingCount(program);
+	vertexInput = SoftwareShaderClass::HasVertexInput(program);
+
+	// Every vertex program with vertex input reads the vertex buffer and the matrix buffer, the others make up their
+	// vertices from the index.
+	if(vertexInput)
+	{
+		if(!IsResource(m_vertexBuffer, RESOURCE_VERTEX_BUFFER) || m_vertexStride < (int)sizeof(XMFLOAT3) || !vertexConstants[0])
+		{
+			return;
+		}
+
+		vertexCount = m_resources[m_vertexBuffer - 1].bytes / m_vertexStride;
+		vertexData = &m_resources[m_vertexBuffer - 1].data[0];
+	}
+	else
+	{
+		vertexCount = indices ? 0 : indexCount;
+		vertexData = 0;
+	}
+
+	SoftwareShaderClass::PrepareVertexConstants(program, vertexConstants, constants);
+
+	// An instance is placed by its own world matrix in front of the matrices of the draw.
+	if(instanceWorld)
+	{
+		world = XMLoadFloat4x4(instanceWorld);
+		XMStoreFloat4x4(&constants.world, XMMatrixMultiply(world, XMLoadFloat4x4(&constants.world)));
+		XMStoreFloat4x4(&constants.worldViewProjection, XMMatrixMultiply(world, XMLoadFloat4x4(&constants.worldViewProjection)));
+	}
+
+	// Record the pixel state of the draw for when its tiles are shaded.
+	draw.pixelProgram = m_pixelShader ? m_resources[m_pixelShader - 1].program : -1;
+	draw.depthState = m_depthState;
+	draw.varyingCount = varyingCount;
+	draw.outputCount = SoftwareShaderClass::GetOutputCount(draw.pixelProgram);
+	SoftwareShaderClass::PreparePixelConstants(draw.pixelProgram, pixelConstants, draw.constants);
+	for(i=0; i<SOFTWARE_MAX_TEXTURES; i++)
+	{
+		draw.textures[i] = IsResource(m_textures[i], RESOURCE_TEXTURE) ? m_resources[m_textures[i] - 1].texture : 0;
+
+		draw.targets[i].texels = 0;
+		draw.targets[i].width = 0;
+		draw.targets[i].height = 0;
+		draw.targets[i].channels = 0;
+		if(IsResource(m_textures[i], RESOURCE_RENDER_TARGET) || IsResource(m_textures[i], RESOURCE_DEPTH_TARGET))
+		{
+			draw.targets[i].texels = &m_resources[m_textures[i] - 1].texels[0];
+			draw.targets[i].width = m_resources[m_textures[i] - 1].width;
+			draw.targets[i].height = m_resources[m_textures[i] - 1].height;
+			draw.targets[i].channels = (m_resources[m_textures[i] - 1].type == RESOURCE_DEPTH_TARGET) ? 1 : 4;
+		}
+	}
+	for(i=0; i<SOFTWARE_MAX_SHADER_BUFFERS; i++)
+	{
+		draw.buffers[i].data = IsResource(m_shaderBuffers[i], RESOURCE_STRUCTURED_BUFFER) ? &m_resources[m_shaderBuffers[i] - 1].data[0] : 0;
+		draw.buffers[i].bytes = draw.buffers[i].data ? m_resources[m_shaderBuffers[i] - 1].bytes : 0;
+	}
+
+	m_draws.push_back(draw);
+	drawIndex = (int)m_draws.size() - 1;
+
+	// Run the vertex program over the whole vertex buffer, split into one block per thread when it is large.  Vertices
+	// made from their index are never split as the program numbers them from the start of its block.
+	start = chrono::high_resolution_clock::now();
+
+	m_positions.resize(vertexCount);
+	m_varyings.resize(vertexCount * varyingCount);
+
+	if((m_threadCount == 1) || (vertexCount < SOFTWARE_PARALLEL_MIN_VERTICES) || !vertexInput)
+	{
+		TransformVertices(program, &constants, vertexData, m_vertexStride, vertexCount, m_positions.data(), m_varyings.data());
+	}
+	else
+	{
+		verticesPerThread = (vertexCount + m_threadCount - 1) / m_threadCount;
+		for(i=0; i<m_threadCount; i++)
+		{
+			first = i * verticesPerThread;
+			last = (first + verticesPerThread < vertexCount) ? first + verticesPerThread : vertexCount;
+			workers[i] = thread(TransformVertices, program, &constants, vertexData + first * m_vertexStride, m_vertexStride, last - first,
+								m_positions.data() + first, m_varyings.data() + first * varyingCount);
+		}
+
+		for(i=0; i<m_threadCount; i++)
+		{
+			workers[i].join();
+		}
+	}
+
+	m_stageTimes.vertexTime += ElapsedMilliseconds(start);
+
+	// Assemble the triangles, clip them against the near plane and bin them into the tiles they cover.  Without an index
+	// buffer the vertices are taken in order.
+	start = chrono::high_resolution_clock::now();
+
+	for(i=0; i+2<indexCount; i+=3)
+	{
+		memset(outside, 0, sizeof(outside));
+
+		for(j=0; j<3; j++)
+		{
+			index = indices ? indices[i + j] : (unsigned int)(i + j);
+			if(index >= (unsigned int)vertexCount)
+			{
+				break;
+			}
+
+			vertices[j].position = m_positions[index];
+			if(varyingCount > 0)
+			{
+				memcpy(vertices[j].varyings, &m_varyings[index * varyingCount], varyingCount * sizeof(float));
+			}
+
+			// Count the vertices outside each clip plane, the near plane is at z = w with reverse depth.
+			outside[0] += (vertices[j].position.x < -vertices[j].position.w) ? 1 : 0;
+			outside[1] += (vertices[j].position.x > vertices[j].position.w) ? 1 : 0;
+			outside[2] += (vertices[j].position.y < -vertices[j].position.w) ? 1 : 0;
+			outside[3] += (vertices[j].position.y > vertices[j].position.w) ? 1 : 0;
+			outside[4] += (GetNearDistance(vertices[j].position) < 0.0f) ? 1 : 0;
+			outside[5] += (GetNearDistance(vertices[j].position) > vertices[j].position.w) ? 1 : 0;
+		}
+
+		// Skip triangles with bad indices and triangles completely outside one of the planes.
+		if(j < 3 || outside[0] == 3 || outside[1] == 3 || outside[2] == 3 || outside[3] == 3 || outside[4] == 3 || outside[5] == 3)
+		{
+			continue;
+		}
+
+		// Only the near plane is clipped, the rest is handled by the screen bounds of each triangle.
+		if(outside[4] == 0)
+		{
+			SetupTriangle(drawIndex, vertices[0], vertices[1], vertices[2]);
+			continue;
+		}
+
+		clippedCount = ClipNearPlane(vertices, clipped, varyingCount);
+		for(j=1; j+1<clippedCount; j++)
+		{
+			SetupTriangle(drawIndex, clipped[0], clipped[j], clipped[j + 1]);
+		}
+	}
+
+	m_stageTimes.setupTime += ElapsedMilliseconds(start);
+
+	return;
+}
+
+
+void SoftwareDeviceClass::SetTargetSize(int width, int height)
+{
+	// Split the targets into tiles, the bins only ever grow so switching between targets does not reallocate.  The
+	// viewport covers the new targets whole.
+	m_targetWidth = width;
+	m_targetHeight = height;
+	m_viewportWidth = width;
+	m_viewportHeight = height;
+	m_targetColumns = (width + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+	m_targetRows = (height + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+
+	if((int)m_bins.size() < m_targetColumns * m_targetRows)
+	{
+		m_bins.resize(m_targetColumns * m_targetRows);
+	}
+
+	return;
+}
+
+
+void SoftwareDeviceClass::Flush()
+{
+	thread workers[SOFTWARE_MAX_THREADS];
+	chrono::high_resolution_clock::time_point start;
+	unsigned int j;
+	int i;
+
+
+	// Rasterize the tiles when triangles are waiting or the frame has not cleared the back buffer yet.
+	if(!m_triangles.empty() || (m_clearDepthPending && !m_depthTarget) || (m_clearColorPending && m_renderTargetCount == 0 && !m_depthTarget))
+	{
+		start = chrono::high_resolution_clock::now();
+
+		// Let every thread take the next unclaimed tile until none are left.
+		m_nextTile = 0;
+		if(m_threadCount == 1)
+		{
+			RasterizeTiles(this);
+		}
+		else
+		{
+			for(i=0; i<m_threadCount; i++)
+			{
+				workers[i] = thread(RasterizeTiles, this);
+			}
+
+			for(i=0; i<m_threadCount; i++)
+			{
+				workers[i].join();
+			}
+		}
+
+		m_stageTimes.rasterTime += ElapsedMilliseconds(start);
+
+		// The back buffer depth is shared by every render target, the back buffer color only clears once it has been
+		// drawn to.  Passes into a depth target leave both alone.
+		if(!m_depthTarget)
+		{
+			m_clearDepthPending = false;
+			if(m_renderTargetCount == 0)
+			{
+				m_clearColorPending = false;
+			}
+		}
+	}
+
+	// Empty the draws and bins of the pass, the vectors keep their memory.
+	m_draws.clear();
+	m_triangles.clear();
+	m_planes.clear();
+	for(j=0; j<m_bins.size(); j++)
+	{
+		m_bins[j].clear();
+	}
+
+	return;
+}
+
+
+void SoftwareDeviceClass::StoreTexel(float* texel, int format, const float* color)
+{
+	int i;
+
+
+	// Round the color to what the format can hold, a format without some of the channels reads them as 0 and alpha as 1
+	// like on the GPU.
+	switch(format)
+	{
+		case RENDER_TARGET_RGBA8:
+			for(i=0; i<4; i++)
+			{
+				texel[i] = floorf(min(max(color[i], 0.0f), 1.0f) * 255.0f + 0.5f) / 255.0f;
+			}
+			break;
+
+		case RENDER_TARGET_RG16_SNORM:
+			texel[0] = roundf(min(max(color[0], -1.0f), 1.0f) * 32767.0f) / 32767.0f;
+			texel[1] = roundf(min(max(color[1], -1.0f), 1.0f) * 32767.0f) / 32767.0f;
+			texel[2] = 0.0f;
+			texel[3] = 1.0f;
+			break;
+
+		default:
+			texel[0] = color[0];
+			texel[1] = 0.0f;
+			texel[2] = 0.0f;
+			texel[3] = 1.0f;
+			break;
+	}
+
+	return;
+}
+
+
+void SoftwareDeviceClass::SetupTriangle(int draw, const ClipVertexType& vertex0, const ClipVertexType& vertex1, const ClipVertexType& vertex2)
+{
+	const ClipVertexType* vertices[3];
+	TriangleType triangle;
+	float x[3], y[3], invW[3], values[3];
+	float area, minX, minY, maxX, maxY, deltaX, deltaY, gradientX, gradientY;
+	int i, j, varyingCount, triangleIndex, tileX, tileY;
+
+
+	vertices[0] = &vertex0;
+	vertices[1] = &vertex1;
+	vertices[2] = &vertex2;
+
+	// Project the vertices to pixel coordinates with y pointing down like the Direct3D viewport.
+	for(i=0; i<3; i++)
+	{
+		invW[i] = 1.0f / vertices[i]->position.w;
+		x[i] = (vertices[i]->position.x * invW[i] * 0.5f + 0.5f) * (float)m_viewportWidth;
+		y[i] = (0.5f - vertices[i]->position.y * invW[i] * 0.5f) * (float)m_viewportHeight;
+	}
+
+	// Clockwise triangles are front facing, cull the back faces and the degenerate ones.
+	area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if(!(area > 0.0f))
+	{
+		return;
+	}
+
+	// Clamp the bounding box to the viewport before converting it, the clipped vertices can project very far out.
+	minX = max(0.0f, floorf(min(x[0], min(x[1], x[2]))));
+	minY = max(0.0f, floorf(min(y[0], min(y[1], y[2]))));
+	maxX = min((float)(m_viewportWidth - 1), ceilf(max(x[0], max(x[1], x[2]))));
+	maxY = min((float)(m_viewportHeight - 1), ceilf(max(y[0], max(y[1], y[2]))));
+	if(minX > maxX || minY > maxY)
+	{
+		return;
+	}
+
+	triangle.draw = draw;
+	triangle.minX = (int)minX;
+	triangle.minY = (int)minY;
+	triangle.maxX = (int)maxX;
+	triangle.maxY = (int)maxY;
+
+	// Build the edge functions, a pixel is inside when all three are positive or zero on a top or left edge.
+	for(i=0; i<3; i++)
+	{
+		j = (i + 1) % 3;
+		deltaX = x[j] - x[i];
+		deltaY = y[j] - y[i];
+
+		triangle.edgeA[i] = -deltaY;
+		triangle.edgeB[i] = deltaX;
+		triangle.edgeC[i] = deltaY * x[i] - deltaX * y[i];
+		triangle.topLeft[i] = (deltaY < 0.0f) || (deltaY == 0.0f && deltaX > 0.0f);
+	}
+
+	// Build a screen space plane for the depth, for 1/w and for every varying divided by w.  The divided values are
+	// linear in screen space, dividing them by the interpolated 1/w gives the perspective correct varyings.
+	triangle.planes = (int)m_planes.size();
+	varyingCount = m_draws[draw].varyingCount;
+
+	for(i=0; i<varyingCount + 2; i++)
+	{
+		for(j=0; j<3; j++)
+		{
+			if(i == 0)
+			{
+				values[j] = vertices[j]->position.z * invW[j];
+			}
+			else if(i == 1)
+			{
+				values[j] = invW[j];
+			}
+			else
+			{
+				values[j] = vertices[j]->varyings[i - 2] * invW[j];
+			}
+		}
+
+		gradientX = ((values[1] - values[0]) * (y[2] - y[0]) - (values[2] - values[0]) * (y[1] - y[0])) / area;
+		gradientY = ((values[2] - values[0]) * (x[1] - x[0]) - (values[1] - values[0]) * (x[2] - x[0])) / area;
+
+		m_planes.push_back(values[0] - gradientX * x[0] - gradientY * y[0]);
+		m_planes.push_back(gradientX);
+		m_planes.push_back(gradientY);
+	}
+
+	m_triangles.push_back(triangle);
+	triangleIndex = (int)m_triangles.size() - 1;
+
+	// Add the triangle to the bin of every tile its bounding box touches.
+	for(tileY=triangle.minY / SOFTWARE_TILE_SIZE; tileY<=triangle.maxY / SOFTWARE_TILE_SIZE; tileY++)
+	{
+		for(tileX=triangle.minX / SOFTWARE_TILE_SIZE; tileX<=triangle.maxX / SOFTWARE_TILE_SIZE; tileX++)
+		{
+			m_bins[tileY * m_targetColumns + tileX].push_back(triangleIndex);
+		}
+	}
+
+	return;
+}
+
+
+int SoftwareDeviceClass::ClipNearPlane(const ClipVertexType* input, ClipVertexType* output, int varyingCount)
+{
+	const ClipVertexType *current, *next;
+	float t, currentDistance, nextDistance;
+	int i, j, count;
+
+
+	// Walk the edges keeping the vertices in front of the near plane and adding a vertex wherever an edge crosses it.
+	count = 0;
+	for(i=0; i<3; i++)
+	{
+		current = &input[i];
+		next = &input[(i + 1) % 3];
+		currentDistance = GetNearDistance(current->position);
+		nextDistance = GetNearDistance(next->position);
+
+		if(currentDistance >= 0.0f)
+		{
+			output[count++] = *current;
+		}
+
+		if((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+		{
+			t = currentDistance / (currentDistance - nextDistance);
+
+			output[count].position.x = current->position.x + (next->position.x - current->position.x) * t;
+			output[count].position.y = current->position.y + (next->position.y - current->position.y) * t;
+			output[count].position.w = current->position.w + (next->position.w - current->position.w) * t;
+			output[count].position.z = m_reverseDepth ? output[count].position.w : 0.0f;
+			for(j=0; j<varyingCount; j++)
+			{
+				output[count].varyings[j] = current->varyings[j] + (next->varyings[j] - current->varyings[j]) * t;
+			}
+			count++;
+		}
+	}
+
+	return count;
+}
+
+
+float SoftwareDeviceClass::GetNearDistance(const XMFLOAT4& position)
+{
+	// The near plane is at z = 0, or at z = w with reverse depth.
+	return m_reverseDepth ? position.w - position.z : position.z;
+}
+
+
+void SoftwareDeviceClass::TransformVertices(int program, const SoftwareShaderClass::VertexConstantsType* constants, const unsigned char* vertices,
+	int stride, int count, XMFLOAT4* positions, float* varyings)
+{
+	SoftwareShaderClass::RunVertexProgram(program, *constants, vertices, stride, count, positions, varyings);
+	return;
+}
+
+
+void SoftwareDeviceClass::RasterizeTiles(SoftwareDeviceClass* device)
+{
+	CpuZoneClass zone("RasterizeTiles");
+	chrono::high_resolution_clock::time_point start;
+	int tile;
+	bool screenTiles;
+
+
+	// Only the passes over screen sized targets add to the tile times.
+	screenTiles = (device->m_targetWidth == device->m_screenWidth) && (device->m_targetHeight == device->m_screenHeight);
+
+	// Claim tiles until they are all done, the atomic counter balances the uneven tiles across the threads.
+	while(true)
+	{
+		tile = device->m_nextTile.fetch_add(1);
+		if(tile >= device->m_targetColumns * device->m_targetRows)
+		{
+			break;
+		}
+
+		start = chrono::high_resolution_clock::now();
+		device->RasterizeTile(tile);
+		if(screenTiles)
+		{
+			device->m_tileTimes[tile] += ElapsedMilliseconds(start);
+		}
+	}
+
+	return;
+}
+
+
+void SoftwareDeviceClass::RasterizeTile(int tile)
+{
+	float varyings[SOFTWARE_MAX_VARYINGS], derivatives[4], color[SOFTWARE_MAX_OUTPUTS * 4], edges[3];
+	float* targets[RENDER_MAX_TARGETS];
+	int formats[RENDER_MAX_TARGETS];
+	const TriangleType* triangle;
+	const DrawType* draw;
+	const vector<int>* bin;
+	const float* planes;
+	float* depthBuffer;
+	float pixelX, pixelY, depth, w, farDepth;
+	DepthComparisonType comparison;
+	unsigned char* output;
+	int tileX, tileY, tileMaxX, tileMaxY, startX, startY, endX, endY, x, y, i, k, pixel;
+	bool inside, pass, backBuffer;
+
+
+	tileX = (tile % m_targetColumns) * SOFTWARE_TILE_SIZE;
+	tileY = (tile / m_targetColumns) * SOFTWARE_TILE_SIZE;
+	tileMaxX = min(tileX + SOFTWARE_TILE_SIZE, m_targetWidth) - 1;
+	tileMaxY = min(tileY + SOFTWARE_TILE_SIZE, m_targetHeight) - 1;
+
+	// Test against the bound depth target or the depth buffer of the back buffer.  The back buffer color is only written
+	// when nothing else is bound.
+	depthBuffer = m_depthTarget ? &m_resources[m_depthTarget - 1].texels[0] : &m_depthBuffer[0];
+	backBuffer = (m_renderTargetCount == 0) && !m_depthTarget;
+	farDepth = GetFarDepth();
+
+	// Clear the pixels of the tile the frame has not cleared yet.
+	if(!m_depthTarget)
+	{
+		for(y=tileY; y<=tileMaxY; y++)
+		{
+			for(x=tileX; x<=tileMaxX; x++)
+			{
+				pixel = y * m_targetWidth + x;
+				if(m_clearColorPending && backBuffer)
+				{
+					memcpy(&m_colorBuffer[pixel * 4], m_clearColor, 4);
+				}
+				if(m_clearDepthPending)
+				{
+					m_depthBuffer[pixel] = farDepth;
+				}
+			}
+		}
+	}
+
+	// Look up the texels of the bound render targets once for the tile.
+	for(k=0; k<m_renderTargetCount; k++)
+	{
+		targets[k] = &m_resources[m_renderTargets[k] - 1].texels[0];
+		formats[k] = m_resources[m_renderTargets[k] - 1].format;
+	}
+
+	// Rasterize the binned triangles in the order they were drawn.
+	bin = &m_bins[tile];
+	for(i=0; i<(int)bin->size(); i++)
+	{
+		triangle = &m_triangles[(*bin)[i]];
+		draw = &m_draws[triangle->draw];
+		planes = &m_planes[triangle->planes];
+		comparison = GetDepthComparison((DepthStateType)draw->depthState, m_reverseDepth);
+
+		startX = max(triangle->minX, tileX);
+		startY = max(triangle->minY, tileY);
+		endX = min(triangle->maxX, tileMaxX);
+		endY = min(triangle->maxY, tileMaxY);
+
+		for(y=startY; y<=endY; y++)
+		{
+			// Sample at the pixel centers and step the edge functions along the row.
+			pixelY = (float)y + 0.5f;
+			pixelX = (float)startX + 0.5f;
+			for(k=0; k<3; k++)
+			{
+				edges[k] = triangle->edgeA[k] * pixelX + triangle->edgeB[k] * pixelY + triangle->edgeC[k];
+			}
+
+			for(x=startX; x<=endX; x++, pixelX+=1.0f)
+			{
+				inside = true;
+				for(k=0; k<3; k++)
+				{
+					if(edges[k] < 0.0f || (edges[k] == 0.0f && !triangle->topLeft[k]))
+					{
+						inside = false;
+					}
+					edges[k] += triangle->edgeA[k];
+				}
+
+				if(!inside)
+				{
+					continue;
+				}
+
+				// Clamp the depth to the viewport range like the GPU does, so the sky lands exactly on the far plane.
+				// The test runs before shading as none of the pixel programs change the depth, the write waits for the pixel
+				// program in case it discards the pixel.
+				pixel = y * m_targetWidth + x;
+				depth = min(max(planes[0] + planes[1] * pixelX + planes[2] * pixelY, 0.0f), 1.0f);
+
+				switch(comparison)
+				{
+					case DEPTH_COMPARISON_LESS:
+						pass = (depth < depthBuffer[pixel]);
+						break;
+					case DEPTH_COMPARISON_LESS_EQUAL:
+						pass = (depth <= depthBuffer[pixel]);
+						break;
+					case DEPTH_COMPARISON_GREATER:
+						pass = (depth > depthBuffer[pixel]);
+						break;
+					case DEPTH_COMPARISON_GREATER_EQUAL:
+						pass = (depth >= depthBuffer[pixel]);
+						break;
+					case DEPTH_COMPARISON_EQUAL:
+						pass = (depth == depthBuffer[pixel]);
+						break;
+					default:
+						pass = true;
+						break;
+				}
+
+				if(!pass)
+				{
+					continue;
+				}
+
+				// Depth only passes have no pixel program.
+				if(draw->pixelProgram < 0)
+				{
+					if(draw->depthState == DEPTH_STATE_DEFAULT || draw->depthState == DEPTH_STATE_PREPASS)
+					{
+						depthBuffer[pixel] = depth;
+					}
+					continue;
+				}
+
+				// Recover the perspective correct varyings and the screen space derivatives of the texture coordinates.
+				w = 1.0f / (planes[3] + planes[4] * pixelX + planes[5] * pixelY);
+				for(k=0; k<draw->varyingCount; k++)
+				{
+					varyings[k] = (planes[6 + k * 3] + planes[7 + k * 3] * pixelX + planes[8 + k * 3] * pixelY) * w;
+				}
+
+				memset(derivatives, 0, sizeof(derivatives));
+				if(draw->varyingCount >= 2)
+				{
+					for(k=0; k<2; k++)
+					{
+						derivatives[k] = (planes[7 + k * 3] - varyings[k] * planes[4]) * w;
+						derivatives[2 + k] = (planes[8 + k * 3] - varyings[k] * planes[5]) * w;
+					}
+				}
+
+				if(!SoftwareShaderClass::RunPixelProgram(draw->pixelProgram, draw->constants, draw->textures, draw->targets, draw->buffers, pixelX,
+														 pixelY, varyings, derivatives, color))
+				{
+					continue;
+				}
+
+				if(draw->depthState == DEPTH_STATE_DEFAULT || draw->depthState == DEPTH_STATE_PREPASS)
+				{
+					depthBuffer[pixel] = depth;
+				}
+
+				// Write the colors to the bound render targets, the pixel program fills one color per target it writes.
+				if(backBuffer)
+				{
+					output = &m_colorBuffer[pixel * 4];
+					for(k=0; k<4; k++)
+					{
+						output[k] = (unsigned char)(min(max(color[k], 0.0f), 1.0f) * 255.0f + 0.5f);
+					}
+				}
+				else
+				{
+					for(k=0; k<m_renderTargetCount && k<draw->outputCount; k++)
+					{
+						StoreTexel(targets[k] + pixel * 4, formats[k], color + k * 4);
+					}
+				}
+			}
+		}
+	}
+
+	return;
+}
\ No newline at end of file
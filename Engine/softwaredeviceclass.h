@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: softwaredeviceclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SOFTWAREDEVICECLASS_H_
+#define _SOFTWAREDEVICECLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <vector>
+using namespace std;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+#include "softwareshaderclass.h"
+#include "softwaretextureclass.h"
+#include "cpuprofilerclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int SOFTWARE_MAX_THREADS = 16;
+const int SOFTWARE_TILE_SIZE = 64;
+const int SOFTWARE_PARALLEL_MIN_VERTICES = 4096;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: SoftwareDeviceClass
+//
+// A renderer backend that draws on the CPU into an in-memory framebuffer.  Draws run the vertex stage straight away and
+// bin their triangles into screen tiles, EndScene then rasterizes and shades the tiles across the worker threads.  An
+// instanced draw runs as one draw for every instance with the world matrix of the instance in front of its own.  The
+// tiles are also flushed whenever the render targets change or one is cleared or copied, so every pass is finished
+// before the next one reads it.  The tiles cover whatever size the bound targets are, depth targets keep one float per
+// texel.  The time spent in every stage and on every screen sized tile of the last frame is kept for profiling.  A
+// timestamp query flushes the tiles first, so it reads the clock once the draws before it have really been drawn.
+////////////////////////////////////////////////////////////////////////////////
+class SoftwareDeviceClass : public RenderDeviceClass
+{
+public:
+	struct StageTimesType
+	{
+		float vertexTime;
+		float setupTime;
+		float rasterTime;
+	};
+
+private:
+	struct SoftwareResourceType
+	{
+		int type;
+		int bytes;
+		int program;
+		vector<unsigned char> data;
+		SoftwareTextureClass* texture;
+		int width, height, format;
+		vector<float> texels;
+		unsigned long long queryValue;
+	};
+
+	// The pixel state a draw had when it was submitted, the tiles are shaded after the renderer has moved on.
+	struct DrawType
+	{
+		int pixelProgram;
+		int depthState;
+		int varyingCount;
+		int outputCount;
+		SoftwareShaderClass::PixelConstantsType constants;
+		SoftwareTextureClass* textures[SOFTWARE_MAX_TEXTURES];
+		SoftwareShaderClass::RenderTargetType targets[SOFTWARE_MAX_TEXTURES];
+		SoftwareShaderClass::ShaderBufferType buffers[SOFTWARE_MAX_SHADER_BUFFERS];
+	};
+
+	struct TriangleType
+	{
+		int draw;
+		int minX, minY, maxX, maxY;
+		float edgeA[3], edgeB[3], edgeC[3];
+		bool topLeft[3];
+		int planes;
+	};
+
+	struct ClipVertexType
+	{
+		XMFLOAT4 position;
+		float varyings[SOFTWARE_MAX_VARYINGS];
+	};
+
+public:
+	SoftwareDeviceClass();
+	SoftwareDeviceClass(const SoftwareDeviceClass&);
+	~SoftwareDeviceClass();
+
+	bool Initialize(int, int, float, float, int, bool);
+	void Shutdown();
+
+	void BeginScene(float, float, float, float);
+	void EndScene();
+
+	int CreateBuffer(ResourceType, const void*, int);
+	bool UpdateBuffer(int, const void*, int);
+	int CreateTexture(const wchar_t*);
+	int CreateVertexShader(const wchar_t*, const char*, VertexFormatType);
+	int CreatePixelShader(const wchar_t*, const char*);
+	int CreateSampler();
+	int CreateStructuredBuffer(int, int);
+	int CreateRenderTarget(int, int, RenderTargetFormatType);
+	int CreateDepthTarget(int, int);
+	int CreateQuery(ResourceType);
+	void ReleaseResource(int);
+
+	void SetVertexBuffer(int, int);
+	void SetIndexBuffer(int);
+	void SetInstanceBuffer(int, int);
+	void SetConstantBuffer(ShaderStageType, int, int);
+	void SetTexture(int, int);
+	void SetShaderBuffer(int, int);
+	void SetDepthState(DepthStateType);
+	void SetRenderTargets(const int*, int, int);
+	void SetViewport(int, int);
+	void ClearRenderTarget(int, float, float, float, float);
+	void ClearDepthTarget(int, float);
+	void CopyTarget(int, int);
+	void DrawIndexed(int);
+	void DrawIndexedInstanced(int, int);
+	void Draw(int);
+
+	void BeginQuery(int);
+	void EndQuery(int);
+	bool GetQueryData(int, unsigned long long&);
+
+	void GetProjectionMatrix(XMMATRIX&);
+	void GetWorldMatrix(XMMATRIX&);
+	void GetOrthoMatrix(XMMATRIX&);
+
+	int GetResourceBytes();
+	int GetThreadCount();
+
+	void GetStageTimes(StageTimesType&);
+	int GetTileCount();
+	float GetTileTime(int);
+
+	const unsigned char* GetFramebuffer();
+	bool WriteFramebuffer(const char*);
+
+protected:
+	void SetShaders(int, int);
+	void SetSampler(int, int);
+
+private:
+	int AddResource(const SoftwareResourceType&);
+	bool IsResource(int, int);
+	const unsigned char* GetConstants(int);
+
+	void SubmitDraw(const unsigned int*, int, const XMFLOAT4X4*);
+	void SetTargetSize(int, int);
+	void Flush();
+	static void StoreTexel(float*, int, const float*);
+
+	void SetupTriangle(int, const ClipVertexType&, const ClipVertexType&, const ClipVertexType&);
+	int ClipNearPlane(const ClipVertexType*, ClipVertexType*, int);
+	float GetNearDistance(const XMFLOAT4&);
+
+	static void TransformVertices(int, const SoftwareShaderClass::VertexConstantsType*, const unsigned char*, int, int, XMFLOAT4*, float*);
+	static void RasterizeTiles(SoftwareDeviceClass*);
+	void RasterizeTile(int);
+
+private:
+	int m_screenWidth, m_screenHeight;
+	int m_tileColumns, m_tileRows;
+	int m_threadCount;
+	XMFLOAT4X4 m_projectionMatrix;
+	XMFLOAT4X4 m_worldMatrix;
+	XMFLOAT4X4 m_orthoMatrix;
+
+	vector<SoftwareResourceType> m_resources;
+
+	int m_vertexBuffer, m_vertexStride, m_indexBuffer;
+	int m_instanceBuffer, m_instanceStride;
+	int m_vertexShader, m_pixelShader;
+	int m_constantBuffers[2][SOFTWARE_MAX_CONSTANT_BUFFERS];
+	int m_textures[SOFTWARE_MAX_TEXTURES];
+	int m_shaderBuffers[SOFTWARE_MAX_SHADER_BUFFERS];
+	int m_depthState;
+	int m_renderTargets[RENDER_MAX_TARGETS];
+	int m_renderTargetCount, m_depthTarget;
+	int m_targetWidth, m_targetHeight;
+	int m_viewportWidth, m_viewportHeight;
+	int m_targetColumns, m_targetRows;
+	bool m_clearColorPending, m_clearDepthPending;
+
+	vector<XMFLOAT4> m_positions;
+	vector<float> m_varyings;
+
+	vector<DrawType> m_draws;
+	vector<TriangleType> m_triangles;
+	vector<float> m_planes;
+	vector< vector<int> > m_bins;
+	atomic<int> m_nextTile;
+
+	unsigned char m_clearColor[4];
+	vector<unsigned char> m_colorBuffer;
+	vector<float> m_depthBuffer;
+
+	StageTimesType m_stageTimes;
+	vector<float> m_tileTimes;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,895 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: softwareshaderclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "softwareshaderclass.h"
+
+
+int SoftwareShaderClass::FindVertexProgram(const char* entryPoint)
+{
+	if(strcmp(entryPoint, "TextureVertexShader") == 0)
+	{
+		return VERTEX_PROGRAM_TEXTURE;
+	}
+	if(strcmp(entryPoint, "SkyVertexShader") == 0)
+	{
+		return VERTEX_PROGRAM_SKY;
+	}
+	// The instanced light shader runs the same program, the device puts the world matrix of each instance in front.
+	if(strcmp(entryPoint, "LightVertexShader") == 0 || strcmp(entryPoint, "LightInstancedVertexShader") == 0)
+	{
+		return VERTEX_PROGRAM_LIGHT;
+	}
+	if(strcmp(entryPoint, "BumpMapVertexShader") == 0)
+	{
+		return VERTEX_PROGRAM_BUMPMAP;
+	}
+	if(strcmp(entryPoint, "DepthVertexShader") == 0)
+	{
+		return VERTEX_PROGRAM_DEPTH;
+	}
+	if(strcmp(entryPoint, "DeferredVertexShader") == 0)
+	{
+		return VERTEX_PROGRAM_DEFERRED;
+	}
+	if(strcmp(entryPoint, "DeferredLightVertexShader") == 0 || strcmp(entryPoint, "UpscaleVertexShader") == 0)
+	{
+		return VERTEX_PROGRAM_FULLSCREEN;
+	}
+
+	return -1;
+}
+
+
+int SoftwareShaderClass::FindPixelProgram(const char* entryPoint)
+{
+	if(strcmp(entryPoint, "TexturePixelShader") == 0)
+	{
+		return PIXEL_PROGRAM_TEXTURE;
+	}
+	if(strcmp(entryPoint, "SkyPixelShader") == 0)
+	{
+		return PIXEL_PROGRAM_SKY;
+	}
+	if(strcmp(entryPoint, "LightPixelShader") == 0)
+	{
+		return PIXEL_PROGRAM_LIGHT;
+	}
+	if(strcmp(entryPoint, "BumpMapPixelShader") == 0)
+	{
+		return PIXEL_PROGRAM_BUMPMAP;
+	}
+	if(strcmp(entryPoint, "DeferredPixelShader") == 0)
+	{
+		return PIXEL_PROGRAM_DEFERRED;
+	}
+	if(strcmp(entryPoint, "DeferredLightPixelShader") == 0)
+	{
+		return PIXEL_PROGRAM_DEFERRED_LIGHT;
+	}
+	if(strcmp(entryPoint, "UpscalePixelShader") == 0)
+	{
+		return PIXEL_PROGRAM_UPSCALE;
+	}
+
+	return -1;
+}
+
+
+int SoftwareShaderClass::GetVaryingCount(int program)
+{
+	// The texture coordinates always come first so the rasterizer can take their derivatives for mip selection.
+	switch(program)
+	{
+		case VERTEX_PROGRAM_TEXTURE:
+			return 2;
+		case VERTEX_PROGRAM_SKY:
+			return 3;
+		case VERTEX_PROGRAM_LIGHT:
+			return 12;
+		case VERTEX_PROGRAM_BUMPMAP:
+			return 11;
+		case VERTEX_PROGRAM_DEFERRED:
+			return 6;
+		case VERTEX_PROGRAM_FULLSCREEN:
+			return 2;
+		default:
+			return 0;
+	}
+}
+
+
+int SoftwareShaderClass::GetOutputCount(int program)
+{
+	// The deferred pixel shader writes the albedo, the normal and the depth of the G-buffer at once.
+	if(program == PIXEL_PROGRAM_DEFERRED)
+	{
+		return 3;
+	}
+
+	return (program < 0) ? 0 : 1;
+}
+
+
+bool SoftwareShaderClass::HasVertexInput(int program)
+{
+	// The fullscreen triangles are built from the vertex index alone.
+	return program != VERTEX_PROGRAM_FULLSCREEN && program != VERTEX_PROGRAM_SKY;
+}
+
+
+void SoftwareShaderClass::PrepareVertexConstants(int program, const unsigned char* const* constants, VertexConstantsType& output)
+{
+	XMFLOAT4X4 matrices[3];
+	XMMATRIX world, view, projection;
+
+
+	memset(&output, 0, sizeof(output));
+
+	// The fullscreen triangle has no matrix buffer.
+	if(!constants[0])
+	{
+		return;
+	}
+
+	// The SkyBuffer holds the transposed inverse view projection and the far depth.
+	if(program == VERTEX_PROGRAM_SKY)
+	{
+		memcpy(&output.inverseViewProjection, constants[0], 64);
+		XMStoreFloat4x4(&output.inverseViewProjection, XMMatrixTranspose(XMLoadFloat4x4(&output.inverseViewProjection)));
+		memcpy(&output.farDepth, constants[0] + 64, 4);
+		return;
+	}
+
+	// Slot 0 holds the transposed world, view and projection matrices of the MatrixBuffer.
+	memcpy(matrices, constants[0], sizeof(matrices));
+
+	world = XMMatrixTranspose(XMLoadFloat4x4(&matrices[0]));
+	view = XMMatrixTranspose(XMLoadFloat4x4(&matrices[1]));
+	projection = XMMatrixTranspose(XMLoadFloat4x4(&matrices[2]));
+
+	XMStoreFloat4x4(&output.world, world);
+	XMStoreFloat4x4(&output.worldViewProjection, XMMatrixMultiply(XMMatrixMultiply(world, view), projection));
+
+	// The light shader has the CameraBuffer in slot 1.
+	output.cameraPosition = XMFLOAT3(0.0f, 0.0f, 0.0f);
+	if(program == VERTEX_PROGRAM_LIGHT && constants[1])
+	{
+		memcpy(&output.cameraPosition, constants[1], sizeof(XMFLOAT3));
+	}
+
+	return;
+}
+
+
+void SoftwareShaderClass::PreparePixelConstants(int program, const unsigned char* const* constants, PixelConstantsType& output)
+{
+	memset(&output, 0, sizeof(output));
+
+	if(!constants[0])
+	{
+		return;
+	}
+
+	// Unpack the LightBuffer layouts of the light and bump map shaders.
+	if(program == PIXEL_PROGRAM_LIGHT)
+	{
+		memcpy(&output.ambientColor, constants[0], 16);
+		memcpy(&output.diffuseColor, constants[0] + 16, 16);
+		memcpy(&output.lightDirection, constants[0] + 32, 12);
+		memcpy(&output.specularPower, constants[0] + 44, 4);
+		memcpy(&output.specularColor, constants[0] + 48, 16);
+
+		// Slot 1 holds the ClusterBuffer that tells the pixel which cluster of point lights it is in.
+		if(constants[1])
+		{
+			memcpy(&output.clusterScaleX, constants[1], 4);
+			memcpy(&output.clusterScaleY, constants[1] + 4, 4);
+			memcpy(&output.depthScale, constants[1] + 8, 4);
+			memcpy(&output.depthBias, constants[1] + 12, 4);
+			memcpy(&output.clusterColumns, constants[1] + 16, 4);
+			memcpy(&output.clusterRows, constants[1] + 20, 4);
+			memcpy(&output.clusterSlices, constants[1] + 24, 4);
+		}
+
+		PrepareShadowConstants(constants[3], output);
+	}
+	else if(program == PIXEL_PROGRAM_BUMPMAP)
+	{
+		memcpy(&output.diffuseColor, constants[0], 16);
+		memcpy(&output.lightDirection, constants[0] + 16, 12);
+	}
+	else if(program == PIXEL_PROGRAM_DEFERRED)
+	{
+		// The MaterialBuffer only holds the specular power that goes into the G-buffer.
+		memcpy(&output.specularPower, constants[0], 4);
+	}
+
+	// The deferred light shader has the light and cluster buffers of the light shader and the CameraBuffer in slot 2, the
+	// specular power comes from the G-buffer instead.
+	if(program == PIXEL_PROGRAM_DEFERRED_LIGHT)
+	{
+		memcpy(&output.ambientColor, constants[0], 16);
+		memcpy(&output.diffuseColor, constants[0] + 16, 16);
+		memcpy(&output.lightDirection, constants[0] + 32, 12);
+		memcpy(&output.specularColor, constants[0] + 48, 16);
+
+		if(constants[1])
+		{
+			memcpy(&output.clusterScaleX, constants[1], 4);
+			memcpy(&output.clusterScaleY, constants[1] + 4, 4);
+			memcpy(&output.depthScale, constants[1] + 8, 4);
+			memcpy(&output.depthBias, constants[1] + 12, 4);
+			memcpy(&output.clusterColumns, constants[1] + 16, 4);
+			memcpy(&output.clusterRows, constants[1] + 20, 4);
+			memcpy(&output.clusterSlices, constants[1] + 24, 4);
+		}
+
+		if(constants[2])
+		{
+			memcpy(&output.inverseView, constants[2], 64);
+			XMStoreFloat4x4(&output.inverseView, XMMatrixTranspose(XMLoadFloat4x4(&output.inverseView)));
+			memcpy(&output.projectionScaleX, constants[2] + 64, 4);
+			memcpy(&output.projectionScaleY, constants[2] + 68, 4);
+		}
+
+		PrepareShadowConstants(constants[3], output);
+	}
+
+	// The UpscaleBuffer maps the screen onto the drawn corner of the scene texture.
+	if(program == PIXEL_PROGRAM_UPSCALE)
+	{
+		memcpy(output.uvScale, constants[0], 8);
+		memcpy(output.uvMin, constants[0] + 8, 8);
+		memcpy(output.uvMax, constants[0] + 16, 8);
+		memcpy(output.texelSize, constants[0] + 24, 8);
+		memcpy(&output.sharpness, constants[0] + 32, 4);
+	}
+
+	return;
+}
+
+
+void SoftwareShaderClass::PrepareShadowConstants(const unsigned char* constants, PixelConstantsType& output)
+{
+	int i;
+
+
+	// Without the ShadowBuffer in slot 3 the cascade count stays 0 and nothing is shadowed.
+	if(!constants)
+	{
+		return;
+	}
+
+	// The matrices are stored transposed for the GPU, the per cascade values are packed in a float4 each.
+	for(i=0; i<SOFTWARE_MAX_CASCADES; i++)
+	{
+		memcpy(&output.shadowMatrices[i], constants + i * 64, 64);
+		XMStoreFloat4x4(&output.shadowMatrices[i], XMMatrixTranspose(XMLoadFloat4x4(&output.shadowMatrices[i])));
+	}
+
+	memcpy(output.cascadeSplits, constants + SOFTWARE_MAX_CASCADES * 64, SOFTWARE_MAX_CASCADES * 4);
+	memcpy(output.cascadeBias, constants + SOFTWARE_MAX_CASCADES * 64 + 16, SOFTWARE_MAX_CASCADES * 4);
+	memcpy(&output.cascadeCount, constants + SOFTWARE_MAX_CASCADES * 64 + 32, 4);
+	memcpy(&output.shadowMapSize, constants + SOFTWARE_MAX_CASCADES * 64 + 36, 4);
+
+	output.cascadeCount = min(output.cascadeCount, (unsigned int)SOFTWARE_MAX_CASCADES);
+
+	return;
+}
+
+
+void SoftwareShaderClass::RunVertexProgram(int program, const VertexConstantsType& constants, const unsigned char* vertices, int stride,
+	int count, XMFLOAT4* positions, float* varyings)
+{
+	XMMATRIX world;
+	XMVECTOR normal, tangent, binormal, worldPosition, viewDirection, nearPoint;
+	XMFLOAT3 value;
+	const unsigned char* vertex;
+	float* output;
+	int i, varyingCount;
+
+
+	// Build the triangle that covers the whole screen from the vertex index, its texture coordinates run from 0 to 2 so
+	// the visible part maps 0 to 1 across the screen.
+	if(program == VERTEX_PROGRAM_FULLSCREEN)
+	{
+		for(i=0; i<count; i++)
+		{
+			output = varyings + i * 2;
+			output[0] = (float)((i << 1) & 2);
+			output[1] = (float)(i & 2);
+			positions[i] = XMFLOAT4(output[0] * 2.0f - 1.0f, 1.0f - output[1] * 2.0f, 0.0f, 1.0f);
+		}
+
+		return;
+	}
+
+	// The sky triangle sits on the far plane and passes on the view ray, the point on the near plane without the camera
+	// position.
+	if(program == VERTEX_PROGRAM_SKY)
+	{
+		for(i=0; i<count; i++)
+		{
+			output = varyings + i * 3;
+			positions[i] = XMFLOAT4((float)((i << 1) & 2) * 2.0f - 1.0f, 1.0f - (float)(i & 2) * 2.0f, constants.farDepth, 1.0f);
+
+			nearPoint = XMVector4Transform(XMVectorSet(positions[i].x, positions[i].y, 1.0f - constants.farDepth, 1.0f),
+										   XMLoadFloat4x4(&constants.inverseViewProjection));
+			XMStoreFloat3((XMFLOAT3*)output, XMVectorDivide(nearPoint, XMVectorSplatW(nearPoint)));
+		}
+
+		return;
+	}
+
+	// Transform every position with the combined matrix in one SIMD stream, the position is the first element of every
+	// vertex layout.  All the programs share this so the depth prepass writes exactly the depth the main pass tests.
+	XMVector3TransformStream(positions, sizeof(XMFLOAT4), (const XMFLOAT3*)vertices, stride, count, XMLoadFloat4x4(&constants.worldViewProjection));
+
+	varyingCount = GetVaryingCount(program);
+	world = XMLoadFloat4x4(&constants.world);
+
+	for(i=0; i<count; i++)
+	{
+		vertex = vertices + i * stride;
+		output = varyings + i * varyingCount;
+
+		switch(program)
+		{
+			case VERTEX_PROGRAM_TEXTURE:
+				memcpy(output, vertex + 12, 8);
+				break;
+
+			case VERTEX_PROGRAM_LIGHT:
+				memcpy(output, vertex + 12, 8);
+
+				// Calculate the normal vector against the world matrix only and normalize it.
+				memcpy(&value, vertex + 20, 12);
+				normal = XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&value), world));
+				XMStoreFloat3((XMFLOAT3*)(output + 2), normal);
+
+				// Determine the normalized viewing direction from the vertex in the world to the camera.
+				memcpy(&value, vertex, 12);
+				worldPosition = XMVector3Transform(XMLoadFloat3(&value), world);
+				viewDirection = XMVector3Normalize(XMVectorSubtract(XMLoadFloat3(&constants.cameraPosition), worldPosition));
+				XMStoreFloat3((XMFLOAT3*)(output + 5), viewDirection);
+
+				// Pass on the world position and the view depth for the point lights, the projection copies the view depth
+				// into w.
+				XMStoreFloat3((XMFLOAT3*)(output + 8), worldPosition);
+				output[11] = positions[i].w;
+				break;
+
+			case VERTEX_PROGRAM_DEFERRED:
+				memcpy(output, vertex + 12, 8);
+
+				memcpy(&value, vertex + 20, 12);
+				normal = XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&value), world));
+				XMStoreFloat3((XMFLOAT3*)(output + 2), normal);
+
+				// The projection copies the view depth into w.
+				output[5] = positions[i].w;
+				break;
+
+			case VERTEX_PROGRAM_BUMPMAP:
+				memcpy(output, vertex + 12, 8);
+
+				// Calculate the normal, tangent and binormal against the world matrix only and normalize them.
+				memcpy(&value, vertex + 20, 12);
+				normal = XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&value), world));
+				XMStoreFloat3((XMFLOAT3*)(output + 2), normal);
+
+				memcpy(&value, vertex + 32, 12);
+				tangent = XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&value), world));
+				XMStoreFloat3((XMFLOAT3*)(output + 5), tangent);
+
+				memcpy(&value, vertex + 44, 12);
+				binormal = XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&value), world));
+				XMStoreFloat3((XMFLOAT3*)(output + 8), binormal);
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	return;
+}
+
+
+bool SoftwareShaderClass::RunPixelProgram(int program, const PixelConstantsType& constants, SoftwareTextureClass* const* textures,
+	const RenderTargetType* targets, const ShaderBufferType* buffers, float x, float y, const float* varyings, const float* derivatives,
+	float* color)
+{
+	float textureColor[4], bumpMap[4], normal[4], depth[4], lightVaryings[12], bumpNormal[3], neighbour[4], neighbours[4], skyCoordinates[2], skyDerivatives[4];
+	float lightIntensity, length, viewX, viewY, u, v;
+	int i, j;
+
+
+	switch(program)
+	{
+		case PIXEL_PROGRAM_TEXTURE:
+			SampleTexture(textures[0], varyings, derivatives, color);
+			break;
+
+		case PIXEL_PROGRAM_SKY:
+			// Look the sky up by the longitude and latitude of the view ray, always in the top mip.
+			length = sqrtf(varyings[0] * varyings[0] + varyings[1] * varyings[1] + varyings[2] * varyings[2]);
+			u = atan2f(varyings[2], varyings[0]) * (0.5f / XM_PI) - 0.25f;
+			skyCoordinates[0] = u - floorf(u);
+			skyCoordinates[1] = acosf(max(-1.0f, min(varyings[1] / length, 1.0f))) * (1.0f / XM_PI);
+
+			memset(skyDerivatives, 0, sizeof(skyDerivatives));
+			SampleTexture(textures[0], skyCoordinates, skyDerivatives, color);
+			color[3] = 1.0f;
+			break;
+
+		case PIXEL_PROGRAM_LIGHT:
+			SampleTexture(textures[0], varyings, derivatives, textureColor);
+			ApplyLight(constants, targets, buffers, x, y, varyings, textureColor, constants.specularPower, color);
+			break;
+
+		case PIXEL_PROGRAM_BUMPMAP:
+			SampleTexture(textures[0], varyings, derivatives, textureColor);
+			SampleTexture(textures[1], varyings, derivatives, bumpMap);
+
+			// Expand the bump map to the -1 to +1 range and bend the normal with it.
+			for(i=0; i<3; i++)
+			{
+				bumpNormal[i] = varyings[2 + i] + (bumpMap[0] * 2.0f - 1.0f) * varyings[5 + i] + (bumpMap[1] * 2.0f - 1.0f) * varyings[8 + i];
+			}
+			length = sqrtf(bumpNormal[0] * bumpNormal[0] + bumpNormal[1] * bumpNormal[1] + bumpNormal[2] * bumpNormal[2]);
+			if(length > 0.0f)
+			{
+				for(i=0; i<3; i++)
+				{
+					bumpNormal[i] /= length;
+				}
+			}
+
+			lightIntensity = Saturate(-(bumpNormal[0] * constants.lightDirection.x + bumpNormal[1] * constants.lightDirection.y +
+										bumpNormal[2] * constants.lightDirection.z));
+
+			color[0] = Saturate(constants.diffuseColor.x * lightIntensity) * textureColor[0];
+			color[1] = Saturate(constants.diffuseColor.y * lightIntensity) * textureColor[1];
+			color[2] = Saturate(constants.diffuseColor.z * lightIntensity) * textureColor[2];
+			color[3] = Saturate(constants.diffuseColor.w * lightIntensity) * textureColor[3];
+			break;
+
+		case PIXEL_PROGRAM_DEFERRED:
+			// Write the albedo with the specular power in its alpha, the octahedral normal and the linear view depth.
+			SampleTexture(textures[0], varyings, derivatives, color);
+			color[3] = constants.specularPower / 255.0f;
+
+			EncodeNormal(varyings + 2, color + 4);
+			color[6] = 0.0f;
+			color[7] = 1.0f;
+
+			color[8] = varyings[5];
+			color[9] = 0.0f;
+			color[10] = 0.0f;
+			color[11] = 1.0f;
+			break;
+
+		case PIXEL_PROGRAM_DEFERRED_LIGHT:
+			LoadTexel(targets[0], x, y, textureColor);
+			LoadTexel(targets[4], x, y, normal);
+			LoadTexel(targets[5], x, y, depth);
+
+			// Leave the pixels no geometry was written to for the sky.
+			if(depth[0] <= 0.0f)
+			{
+				return false;
+			}
+
+			// Rebuild the view space position from the screen position and the depth, then move it to the world with the
+			// inverse view matrix whose last row is the camera position.
+			viewX = ((varyings[0] * 2.0f - 1.0f) * depth[0]) * constants.projectionScaleX;
+			viewY = ((1.0f - varyings[1] * 2.0f) * depth[0]) * constants.projectionScaleY;
+
+			XMStoreFloat3((XMFLOAT3*)(lightVaryings + 8), XMVector3Transform(XMVectorSet(viewX, viewY, depth[0], 1.0f),
+																			   XMLoadFloat4x4(&constants.inverseView)));
+			XMStoreFloat3((XMFLOAT3*)(lightVaryings + 5), XMVector3Normalize(XMVectorSubtract(XMVectorSet(constants.inverseView._41,
+				constants.inverseView._42, constants.inverseView._43, 0.0f), XMLoadFloat3((XMFLOAT3*)(lightVaryings + 8)))));
+
+			// Lay out the rest the way the light vertex program passes them so the forward lighting can be reused.
+			DecodeNormal(normal, lightVaryings + 2);
+			lightVaryings[0] = varyings[0];
+			lightVaryings[1] = varyings[1];
+			lightVaryings[11] = depth[0];
+
+			ApplyLight(constants, targets, buffers, x, y, lightVaryings, textureColor, textureColor[3] * 255.0f, color);
+			color[3] = 1.0f;
+			break;
+
+		case PIXEL_PROGRAM_UPSCALE:
+			u = varyings[0] * constants.uvScale[0];
+			v = varyings[1] * constants.uvScale[1];
+			SampleScene(constants, targets[0], u, v, color);
+
+			// Sharpen against the four neighbours a scene texel away.
+			if(constants.sharpness > 0.0f)
+			{
+				memset(neighbours, 0, sizeof(neighbours));
+				for(j=0; j<4; j++)
+				{
+					SampleScene(constants, targets[0], u + SOFTWARE_UPSCALE_OFFSETS[j][0] * constants.texelSize[0],
+								v + SOFTWARE_UPSCALE_OFFSETS[j][1] * constants.texelSize[1], neighbour);
+					for(i=0; i<4; i++)
+					{
+						neighbours[i] += neighbour[i];
+					}
+				}
+
+				for(i=0; i<4; i++)
+				{
+					color[i] = Saturate(color[i] + (color[i] * 4.0f - neighbours[i]) * constants.sharpness);
+				}
+			}
+
+			color[3] = 1.0f;
+			break;
+
+		default:
+			color[0] = color[1] = color[2] = color[3] = 0.0f;
+			break;
+	}
+
+	return true;
+}
+
+
+void SoftwareShaderClass::SampleTexture(SoftwareTextureClass* texture, const float* varyings, const float* derivatives, float* color)
+{
+	float width, height, footprintX, footprintY, footprint, lod;
+
+
+	// An unbound texture reads as black like on the GPU.
+	if(!texture)
+	{
+		color[0] = color[1] = color[2] = color[3] = 0.0f;
+		return;
+	}
+
+	// Pick the mip level from the larger of the screen space texel footprints in x and y.
+	width = (float)texture->GetWidth();
+	height = (float)texture->GetHeight();
+
+	footprintX = (derivatives[0] * width) * (derivatives[0] * width) + (derivatives[1] * height) * (derivatives[1] * height);
+	footprintY = (derivatives[2] * width) * (derivatives[2] * width) + (derivatives[3] * height) * (derivatives[3] * height);
+	footprint = footprintX > footprintY ? footprintX : footprintY;
+
+	lod = (footprint > 1.0f) ? 0.5f * log2f(footprint) : 0.0f;
+
+	texture->Sample(varyings[0], varyings[1], lod, color);
+
+	return;
+}
+
+
+void SoftwareShaderClass::LoadTexel(const RenderTargetType& target, float x, float y, float* color)
+{
+	int column, row;
+
+
+	// An unbound target reads as black like on the GPU.
+	column = (int)x;
+	row = (int)y;
+	if(!target.texels || column < 0 || row < 0 || column >= target.width || row >= target.height)
+	{
+		color[0] = color[1] = color[2] = color[3] = 0.0f;
+		return;
+	}
+
+	// A depth target only has the red channel.
+	if(target.channels == 1)
+	{
+		color[0] = target.texels[row * target.width + column];
+		color[1] = color[2] = 0.0f;
+		color[3] = 1.0f;
+		return;
+	}
+
+	memcpy(color, target.texels + (row * target.width + column) * 4, 4 * sizeof(float));
+
+	return;
+}
+
+
+void SoftwareShaderClass::SampleTarget(const RenderTargetType& target, float u, float v, float* color)
+{
+	const float* texels[4];
+	float x, y, fractionX, fractionY;
+	int column, row, nextColumn, nextRow, i;
+
+
+	// An unbound target reads as black like on the GPU.
+	if(!target.texels || target.channels != 4)
+	{
+		color[0] = color[1] = color[2] = color[3] = 0.0f;
+		return;
+	}
+
+	// Find the four texels around the sample point the way the linear filter does, with the texel centers at the halves.
+	x = u * (float)target.width - 0.5f;
+	y = v * (float)target.height - 0.5f;
+	column = (int)floorf(x);
+	row = (int)floorf(y);
+	fractionX = x - (float)column;
+	fractionY = y - (float)row;
+
+	// The callers keep the point inside the target, so clamping only catches the texels that have no weight.
+	nextColumn = min(max(column + 1, 0), target.width - 1);
+	nextRow = min(max(row + 1, 0), target.height - 1);
+	column = min(max(column, 0), target.width - 1);
+	row = min(max(row, 0), target.height - 1);
+
+	texels[0] = target.texels + (row * target.width + column) * 4;
+	texels[1] = target.texels + (row * target.width + nextColumn) * 4;
+	texels[2] = target.texels + (nextRow * target.width + column) * 4;
+	texels[3] = target.texels + (nextRow * target.width + nextColumn) * 4;
+
+	for(i=0; i<4; i++)
+	{
+		color[i] = (texels[0][i] * (1.0f - fractionX) + texels[1][i] * fractionX) * (1.0f - fractionY) +
+				   (texels[2][i] * (1.0f - fractionX) + texels[3][i] * fractionX) * fractionY;
+	}
+
+	return;
+}
+
+
+void SoftwareShaderClass::SampleScene(const PixelConstantsType& constants, const RenderTargetType& target, float u, float v, float* color)
+{
+	// Stay half a texel inside the drawn corner of the scene texture like upscale.ps.
+	u = min(max(u, constants.uvMin[0]), constants.uvMax[0]);
+	v = min(max(v, constants.uvMin[1]), constants.uvMax[1]);
+
+	SampleTarget(target, u, v, color);
+
+	return;
+}
+
+
+void SoftwareShaderClass::ApplyLight(const PixelConstantsType& constants, const RenderTargetType* targets, const ShaderBufferType* buffers,
+	float x, float y, const float* varyings, const float* textureColor, float specularPower, float* color)
+{
+	float lightDir[3], reflection[3];
+	float lightIntensity, specular, length, shadow;
+	int i;
+
+
+	// Start from the ambient light and invert the light direction for the calculations.
+	color[0] = constants.ambientColor.x;
+	color[1] = constants.ambientColor.y;
+	color[2] = constants.ambientColor.z;
+	color[3] = constants.ambientColor.w;
+	specular = 0.0f;
+
+	lightDir[0] = -constants.lightDirection.x;
+	lightDir[1] = -constants.lightDirection.y;
+	lightDir[2] = -constants.lightDirection.z;
+
+	lightIntensity = Saturate(varyings[2] * lightDir[0] + varyings[3] * lightDir[1] + varyings[4] * lightDir[2]);
+	if(lightIntensity > 0.0f)
+	{
+		// Only the directional light is shadowed, the cascades cover the diffuse and the specular part of it.
+		shadow = GetShadow(constants, targets, varyings);
+
+		// Add the diffuse light and saturate.
+		color[0] = Saturate(color[0] + constants.diffuseColor.x * lightIntensity * shadow);
+		color[1] = Saturate(color[1] + constants.diffuseColor.y * lightIntensity * shadow);
+		color[2] = Saturate(color[2] + constants.diffuseColor.z * lightIntensity * shadow);
+		color[3] = Saturate(color[3] + constants.diffuseColor.w * lightIntensity * shadow);
+
+		// Reflect the light about the normal and compare it with the viewing direction.
+		for(i=0; i<3; i++)
+		{
+			reflection[i] = 2.0f * lightIntensity * varyings[2 + i] - lightDir[i];
+		}
+		length = sqrtf(reflection[0] * reflection[0] + reflection[1] * reflection[1] + reflection[2] * reflection[2]);
+		if(length > 0.0f)
+		{
+			for(i=0; i<3; i++)
+			{
+				reflection[i] /= length;
+			}
+		}
+
+		specular = powf(Saturate(reflection[0] * varyings[5] + reflection[1] * varyings[6] + reflection[2] * varyings[7]), specularPower) * shadow;
+	}
+
+	// Add the point lights of the cluster the pixel is in.
+	AddClusterLights(constants, buffers, x, y, varyings, color);
+
+	// Multiply with the texture and add the specular component last.
+	for(i=0; i<4; i++)
+	{
+		color[i] = Saturate(color[i] * textureColor[i] + specular);
+	}
+
+	return;
+}
+
+
+float SoftwareShaderClass::GetShadow(const PixelConstantsType& constants, const RenderTargetType* targets, const float* varyings)
+{
+	XMFLOAT4 position;
+	float depth[4];
+	float column, row, lit;
+	int cascade, x, y, size;
+
+
+	// Pick the first cascade whose far split is past the view depth, beyond the last one nothing is shadowed.
+	cascade = 0;
+	while(cascade < (int)constants.cascadeCount && varyings[11] > constants.cascadeSplits[cascade])
+	{
+		cascade++;
+	}
+
+	if(cascade >= (int)constants.cascadeCount)
+	{
+		return 1.0f;
+	}
+
+	// Move the world position into the shadow map, the matrix maps it to texture coordinates and light depth.
+	XMStoreFloat4(&position, XMVector3TransformCoord(XMVectorSet(varyings[8], varyings[9], varyings[10], 1.0f),
+													 XMLoadFloat4x4(&constants.shadowMatrices[cascade])));
+	if(position.x < 0.0f || position.x > 1.0f || position.y < 0.0f || position.y > 1.0f || position.z > 1.0f)
+	{
+		return 1.0f;
+	}
+
+	// Filter with the nine texels around the position, clamped to the edge of the map.
+	size = (int)constants.shadowMapSize;
+	column = floorf(position.x * constants.shadowMapSize);
+	row = floorf(position.y * constants.shadowMapSize);
+
+	lit = 0.0f;
+	for(y=-1; y<=1; y++)
+	{
+		for(x=-1; x<=1; x++)
+		{
+			LoadTexel(targets[6 + cascade], min(max(column + (float)x, 0.0f), (float)(size - 1)), min(max(row + (float)y, 0.0f), (float)(size - 1)), depth);
+			lit += (position.z - constants.cascadeBias[cascade] <= depth[0]) ? 1.0f : 0.0f;
+		}
+	}
+
+	return lit / 9.0f;
+}
+
+
+void SoftwareShaderClass::EncodeNormal(const float* normal, float* output)
+{
+	float length, x, y;
+
+
+	// Project the normal onto the octahedron and fold the lower half over the upper one.
+	length = fabsf(normal[0]) + fabsf(normal[1]) + fabsf(normal[2]);
+	if(length <= 0.0f)
+	{
+		output[0] = output[1] = 0.0f;
+		return;
+	}
+
+	x = normal[0] / length;
+	y = normal[1] / length;
+	if(normal[2] < 0.0f)
+	{
+		output[0] = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		output[1] = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+	}
+	else
+	{
+		output[0] = x;
+		output[1] = y;
+	}
+
+	return;
+}
+
+
+void SoftwareShaderClass::DecodeNormal(const float* input, float* normal)
+{
+	float fold, length;
+
+
+	// Unfold the lower half of the octahedron and normalize.
+	normal[0] = input[0];
+	normal[1] = input[1];
+	normal[2] = 1.0f - fabsf(input[0]) - fabsf(input[1]);
+
+	fold = Saturate(-normal[2]);
+	normal[0] += (normal[0] >= 0.0f) ? -fold : fold;
+	normal[1] += (normal[1] >= 0.0f) ? -fold : fold;
+
+	length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+	normal[0] /= length;
+	normal[1] /= length;
+	normal[2] /= length;
+
+	return;
+}
+
+
+void SoftwareShaderClass::AddClusterLights(const PixelConstantsType& constants, const ShaderBufferType* buffers, float x, float y,
+	const float* varyings, float* color)
+{
+	const unsigned int* range;
+	const unsigned int* indices;
+	const float* light;
+	float toLight[3], diffuse[3], distance, intensity, attenuation;
+	unsigned int column, row, slice, cluster, i, index;
+	int k;
+
+
+	// Nothing to do when the clusters are not bound.
+	if(!buffers[1].data || !buffers[2].data || !buffers[3].data || constants.clusterColumns == 0)
+	{
+		return;
+	}
+
+	// Find the cluster from the screen position and the view depth the same way light.ps does.
+	column = min((unsigned int)(x * constants.clusterScaleX), constants.clusterColumns - 1);
+	row = min((unsigned int)(y * constants.clusterScaleY), constants.clusterRows - 1);
+	slice = (unsigned int)min(max(logf(varyings[11]) * constants.depthScale + constants.depthBias, 0.0f), (float)(constants.clusterSlices - 1));
+	cluster = (slice * constants.clusterRows + row) * constants.clusterColumns + column;
+
+	if((cluster + 1) * 8 > (unsigned int)buffers[2].bytes)
+	{
+		return;
+	}
+
+	range = (const unsigned int*)buffers[2].data + cluster * 2;
+	indices = (const unsigned int*)buffers[3].data;
+
+	diffuse[0] = diffuse[1] = diffuse[2] = 0.0f;
+
+	for(i=0; i<range[1]; i++)
+	{
+		if((range[0] + i + 1) * 4 > (unsigned int)buffers[3].bytes)
+		{
+			break;
+		}
+
+		index = indices[range[0] + i];
+		if((index + 1) * 32 > (unsigned int)buffers[1].bytes)
+		{
+			continue;
+		}
+
+		// The light is a position, a radius and a color padded to 32 bytes.
+		light = (const float*)(buffers[1].data + index * 32);
+
+		for(k=0; k<3; k++)
+		{
+			toLight[k] = light[k] - varyings[8 + k];
+		}
+		distance = sqrtf(toLight[0] * toLight[0] + toLight[1] * toLight[1] + toLight[2] * toLight[2]);
+		if(distance <= 0.0f || distance >= light[3])
+		{
+			continue;
+		}
+
+		// Fall off with the square of the distance over the radius so the light fades to nothing at its edge.
+		attenuation = 1.0f - distance / light[3];
+		intensity = Saturate((varyings[2] * toLight[0] + varyings[3] * toLight[1] + varyings[4] * toLight[2]) / distance) * attenuation * attenuation;
+
+		for(k=0; k<3; k++)
+		{
+			diffuse[k] += light[4 + k] * intensity;
+		}
+	}
+
+	for(k=0; k<3; k++)
+	{
+		color[k] = Saturate(color[k] + diffuse[k]);
+	}
+
+	return;
+}
+
+
+float SoftwareShaderClass::Saturate(float value)
+{
+	return value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: softwareshaderclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SOFTWARESHADERCLASS_H_
+#define _SOFTWARESHADERCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <DirectXMath.h>
+using namespace DirectX;
+using namespace std;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "softwaretextureclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int SOFTWARE_MAX_VARYINGS = 12;
+const int SOFTWARE_MAX_CONSTANT_BUFFERS = 4;
+const int SOFTWARE_MAX_TEXTURES = 9;
+const int SOFTWARE_MAX_SHADER_BUFFERS = 4;
+const int SOFTWARE_MAX_OUTPUTS = 4;
+const int SOFTWARE_MAX_CASCADES = 3;
+const float SOFTWARE_UPSCALE_OFFSETS[4][2] = { { 1.0f, 0.0f }, { -1.0f, 0.0f }, { 0.0f, 1.0f }, { 0.0f, -1.0f } };
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: SoftwareShaderClass
+//
+// C++ versions of the vertex and pixel shaders in the .vs and .ps files, picked by the same entry point names.  The
+// vertex programs read the vertex layouts of the model classes and the constant buffers exactly as the shader classes
+// fill them, so the software device can run the renderer unchanged.  Render and depth targets are read texel by texel
+// like the Load calls of the deferred light and shadow lookups or filtered like the upscale, and a pixel program can write
+// up to four colors for the bound targets.
+////////////////////////////////////////////////////////////////////////////////
+class SoftwareShaderClass
+{
+public:
+	enum VertexProgramType
+	{
+		VERTEX_PROGRAM_TEXTURE,
+		VERTEX_PROGRAM_SKY,
+		VERTEX_PROGRAM_LIGHT,
+		VERTEX_PROGRAM_BUMPMAP,
+		VERTEX_PROGRAM_DEPTH,
+		VERTEX_PROGRAM_DEFERRED,
+		VERTEX_PROGRAM_FULLSCREEN
+	};
+
+	enum PixelProgramType
+	{
+		PIXEL_PROGRAM_TEXTURE,
+		PIXEL_PROGRAM_SKY,
+		PIXEL_PROGRAM_LIGHT,
+		PIXEL_PROGRAM_BUMPMAP,
+		PIXEL_PROGRAM_DEFERRED,
+		PIXEL_PROGRAM_DEFERRED_LIGHT,
+		PIXEL_PROGRAM_UPSCALE
+	};
+
+	// The constants of a draw, unpacked once from the raw constant buffers.
+	struct VertexConstantsType
+	{
+		XMFLOAT4X4 world;
+		XMFLOAT4X4 worldViewProjection;
+		XMFLOAT3 cameraPosition;
+		XMFLOAT4X4 inverseViewProjection;
+		float farDepth;
+	};
+
+	struct PixelConstantsType
+	{
+		XMFLOAT4 ambientColor;
+		XMFLOAT4 diffuseColor;
+		XMFLOAT4 specularColor;
+		XMFLOAT3 lightDirection;
+		float specularPower;
+		float clusterScaleX, clusterScaleY;
+		float depthScale, depthBias;
+		unsigned int clusterColumns, clusterRows, clusterSlices;
+		XMFLOAT4X4 inverseView;
+		float projectionScaleX, projectionScaleY;
+		XMFLOAT4X4 shadowMatrices[SOFTWARE_MAX_CASCADES];
+		float cascadeSplits[SOFTWARE_MAX_CASCADES];
+		float cascadeBias[SOFTWARE_MAX_CASCADES];
+		unsigned int cascadeCount;
+		float shadowMapSize;
+		float uvScale[2], uvMin[2], uvMax[2], texelSize[2];
+		float sharpness;
+	};
+
+	struct ShaderBufferType
+	{
+		const unsigned char* data;
+		int bytes;
+	};
+
+	// A render or depth target bound for reading, with four floats per texel for a render target and one for a depth
+	// target.
+	struct RenderTargetType
+	{
+		const float* texels;
+		int width, height, channels;
+	};
+
+public:
+	static int FindVertexProgram(const char*);
+	static int FindPixelProgram(const char*);
+	static int GetVaryingCount(int);
+	static int GetOutputCount(int);
+	static bool HasVertexInput(int);
+
+	static void PrepareVertexConstants(int, const unsigned char* const*, VertexConstantsType&);
+	static void PreparePixelConstants(int, const unsigned char* const*, PixelConstantsType&);
+
+	static void RunVertexProgram(int, const VertexConstantsType&, const unsigned char*, int, int, XMFLOAT4*, float*);
+	static bool RunPixelProgram(int, const PixelConstantsType&, SoftwareTextureClass* const*, const RenderTargetType*, const ShaderBufferType*,
+								float, float, const float*, const float*, float*);
+
+private:
+	static void SampleTexture(SoftwareTextureClass*, const float*, const float*, float*);
+	static void LoadTexel(const RenderTargetType&, float, float, float*);
+	static void SampleTarget(const RenderTargetType&, float, float, float*);
+	static void SampleScene(const PixelConstantsType&, const RenderTargetType&, float, float, float*);
+	static void ApplyLight(const PixelConstantsType&, const RenderTargetType*, const ShaderBufferType*, float, float, const float*, const float*,
+						   float, float*);
+	static void PrepareShadowConstants(const unsigned char*, PixelConstantsType&);
+	static float GetShadow(const PixelConstantsType&, const RenderTargetType*, const float*);
+	static void EncodeNormal(const float*, float*);
+	static void DecodeNormal(const float*, float*);
+	static void AddClusterLights(const PixelConstantsType&, const ShaderBufferType*, float, float, const float*, float*);
+	static float Saturate(float);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,473 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: softwaretextureclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "softwaretextureclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+static const unsigned int DDS_MAGIC = 0x20534444;
+static const unsigned int DDS_FOURCC = 0x4;
+static const unsigned int DDS_RGB = 0x40;
+static const unsigned int DDS_ALPHAPIXELS = 0x1;
+
+
+SoftwareTextureClass::SoftwareTextureClass()
+{
+}
+
+
+SoftwareTextureClass::SoftwareTextureClass(const SoftwareTextureClass& other)
+{
+}
+
+
+SoftwareTextureClass::~SoftwareTextureClass()
+{
+}
+
+
+bool SoftwareTextureClass::Initialize(const wchar_t* filename)
+{
+	char path[256];
+	size_t length;
+	bool result;
+
+
+	// Convert the wide file name so it can be opened with the standard library.
+	length = wcstombs(path, filename, sizeof(path));
+	if(length == (size_t)-1 || length >= sizeof(path))
+	{
+		return false;
+	}
+
+	// Decode the top level of the texture.
+	result = LoadDDS(path);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Filter it down into the rest of the mip levels.
+	BuildMipChain();
+
+	return true;
+}
+
+
+void SoftwareTextureClass::Shutdown()
+{
+	m_levels.clear();
+	return;
+}
+
+
+int SoftwareTextureClass::GetWidth()
+{
+	return m_levels.empty() ? 0 : m_levels[0].width;
+}
+
+
+int SoftwareTextureClass::GetHeight()
+{
+	return m_levels.empty() ? 0 : m_levels[0].height;
+}
+
+
+int SoftwareTextureClass::GetBytes()
+{
+	unsigned int i;
+	int bytes;
+
+
+	bytes = 0;
+	for(i=0; i<m_levels.size(); i++)
+	{
+		bytes += (int)m_levels[i].texels.size();
+	}
+
+	return bytes;
+}
+
+
+void SoftwareTextureClass::Sample(float u, float v, float lod, float* color)
+{
+	float first[4], second[4], blend;
+	int level, i;
+
+
+	// Sample like MIN_MAG_MIP_LINEAR, bilinear in the two nearest mip levels and a blend between them.
+	if(lod <= 0.0f)
+	{
+		SampleBilinear(m_levels[0], u, v, color);
+		return;
+	}
+
+	level = (int)lod;
+	if(level >= (int)m_levels.size() - 1)
+	{
+		SampleBilinear(m_levels[m_levels.size() - 1], u, v, color);
+		return;
+	}
+
+	blend = lod - (float)level;
+
+	SampleBilinear(m_levels[level], u, v, first);
+	SampleBilinear(m_levels[level + 1], u, v, second);
+
+	for(i=0; i<4; i++)
+	{
+		color[i] = first[i] + (second[i] - first[i]) * blend;
+	}
+
+	return;
+}
+
+
+bool SoftwareTextureClass::LoadDDS(const char* filename)
+{
+	ifstream fin;
+	unsigned int header[32];
+	unsigned int flags, fourCC, bitCount, masks[4];
+	vector<unsigned char> data;
+	unsigned char block[64];
+	int width, height, blocksWide, blocksHigh, blockBytes, x, y, bx, by, i, shift[4];
+	unsigned int pixel;
+	unsigned char* texel;
+	bool hasAlpha;
+	streamoff size;
+
+
+	// Open the file and read the magic number and the 124 byte header.
+	fin.open(filename, ios::binary);
+	if(fin.fail())
+	{
+		return false;
+	}
+
+	fin.read((char*)header, sizeof(header));
+	if(fin.fail() || header[0] != DDS_MAGIC || header[1] != 124)
+	{
+		return false;
+	}
+
+	height = (int)header[3];
+	width = (int)header[4];
+	flags = header[20];
+	fourCC = header[21];
+	bitCount = header[22];
+	masks[0] = header[23];
+	masks[1] = header[24];
+	masks[2] = header[25];
+	masks[3] = header[26];
+
+	if(width <= 0 || height <= 0)
+	{
+		return false;
+	}
+
+	// Read the rest of the file, only the top level is used.
+	fin.seekg(0, ios::end);
+	size = (streamoff)fin.tellg() - (streamoff)sizeof(header);
+	fin.seekg(sizeof(header), ios::beg);
+
+	data.resize((size_t)size);
+	fin.read((char*)&data[0], size);
+	if(fin.fail())
+	{
+		return false;
+	}
+
+	fin.close();
+
+	m_levels.resize(1);
+	m_levels[0].width = width;
+	m_levels[0].height = height;
+	m_levels[0].texels.resize(width * height * 4);
+
+	if(flags & DDS_FOURCC)
+	{
+		// Block compressed, DXT1 has 8 byte blocks and DXT3 and DXT5 16 byte blocks.
+		if(fourCC == 0x31545844)
+		{
+			blockBytes = 8;
+		}
+		else if(fourCC == 0x33545844 || fourCC == 0x35545844)
+		{
+			blockBytes = 16;
+		}
+		else
+		{
+			return false;
+		}
+
+		blocksWide = (width + 3) / 4;
+		blocksHigh = (height + 3) / 4;
+		if((int)data.size() < blocksWide * blocksHigh * blockBytes)
+		{
+			return false;
+		}
+
+		for(by=0; by<blocksHigh; by++)
+		{
+			for(bx=0; bx<blocksWide; bx++)
+			{
+				const unsigned char* source = &data[(by * blocksWide + bx) * blockBytes];
+
+				// Decode the 4x4 block, the alpha block comes first in the 16 byte formats.
+				if(blockBytes == 8)
+				{
+					DecodeColorBlock(source, block, true);
+				}
+				else
+				{
+					DecodeColorBlock(source + 8, block, false);
+
+					if(fourCC == 0x35545844)
+					{
+						DecodeAlphaBlock(source, block);
+					}
+					else
+					{
+						for(i=0; i<16; i++)
+						{
+							block[i * 4 + 3] = (unsigned char)(((source[i / 2] >> ((i & 1) * 4)) & 0xF) * 17);
+						}
+					}
+				}
+
+				// Copy the block into the image, clipping the edge blocks of images that are not a multiple of four.
+				for(y=0; y<4; y++)
+				{
+					for(x=0; x<4; x++)
+					{
+						if((bx * 4 + x) < width && (by * 4 + y) < height)
+						{
+							memcpy(&m_levels[0].texels[((by * 4 + y) * width + (bx * 4 + x)) * 4], &block[(y * 4 + x) * 4], 4);
+						}
+					}
+				}
+			}
+		}
+	}
+	else if((flags & DDS_RGB) && bitCount == 32)
+	{
+		if((int)data.size() < width * height * 4)
+		{
+			return false;
+		}
+
+		// Find how far each channel mask is shifted, a missing alpha channel reads as opaque.
+		hasAlpha = (flags & DDS_ALPHAPIXELS) && masks[3];
+		for(i=0; i<4; i++)
+		{
+			shift[i] = 0;
+			while(masks[i] && !((masks[i] >> shift[i]) & 1))
+			{
+				shift[i]++;
+			}
+		}
+
+		for(i=0; i<width*height; i++)
+		{
+			memcpy(&pixel, &data[i * 4], 4);
+			texel = &m_levels[0].texels[i * 4];
+
+			texel[0] = (unsigned char)((pixel & masks[0]) >> shift[0]);
+			texel[1] = (unsigned char)((pixel & masks[1]) >> shift[1]);
+			texel[2] = (unsigned char)((pixel & masks[2]) >> shift[2]);
+			texel[3] = hasAlpha ? (unsigned char)((pixel & masks[3]) >> shift[3]) : 255;
+		}
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void SoftwareTextureClass::DecodeColorBlock(const unsigned char* source, unsigned char* block, bool allowTransparent)
+{
+	unsigned char palette[4][4];
+	unsigned int color0, color1, indices;
+	int i, j;
+
+
+	color0 = source[0] | (source[1] << 8);
+	color1 = source[2] | (source[3] << 8);
+	indices = source[4] | (source[5] << 8) | (source[6] << 16) | ((unsigned int)source[7] << 24);
+
+	// Expand the two 565 end points to 8 bits per channel.
+	palette[0][0] = (unsigned char)(((color0 >> 11) & 31) * 255 / 31);
+	palette[0][1] = (unsigned char)(((color0 >> 5) & 63) * 255 / 63);
+	palette[0][2] = (unsigned char)((color0 & 31) * 255 / 31);
+	palette[0][3] = 255;
+
+	palette[1][0] = (unsigned char)(((color1 >> 11) & 31) * 255 / 31);
+	palette[1][1] = (unsigned char)(((color1 >> 5) & 63) * 255 / 63);
+	palette[1][2] = (unsigned char)((color1 & 31) * 255 / 31);
+	palette[1][3] = 255;
+
+	// DXT1 blocks with the end points in this order have a single mid point and a transparent entry.
+	if(allowTransparent && color0 <= color1)
+	{
+		for(j=0; j<3; j++)
+		{
+			palette[2][j] = (unsigned char)((palette[0][j] + palette[1][j]) / 2);
+			palette[3][j] = 0;
+		}
+		palette[2][3] = 255;
+		palette[3][3] = 0;
+	}
+	else
+	{
+		for(j=0; j<3; j++)
+		{
+			palette[2][j] = (unsigned char)((2 * palette[0][j] + palette[1][j]) / 3);
+			palette[3][j] = (unsigned char)((palette[0][j] + 2 * palette[1][j]) / 3);
+		}
+		palette[2][3] = 255;
+		palette[3][3] = 255;
+	}
+
+	for(i=0; i<16; i++)
+	{
+		memcpy(&block[i * 4], palette[(indices >> (i * 2)) & 3], 4);
+	}
+
+	return;
+}
+
+
+void SoftwareTextureClass::DecodeAlphaBlock(const unsigned char* source, unsigned char* block)
+{
+	unsigned char palette[8];
+	unsigned long long indices;
+	int i;
+
+
+	palette[0] = source[0];
+	palette[1] = source[1];
+
+	// Interpolate six values between the end points, or four plus fully transparent and opaque.
+	if(palette[0] > palette[1])
+	{
+		for(i=1; i<7; i++)
+		{
+			palette[i + 1] = (unsigned char)(((7 - i) * palette[0] + i * palette[1]) / 7);
+		}
+	}
+	else
+	{
+		for(i=1; i<5; i++)
+		{
+			palette[i + 1] = (unsigned char)(((5 - i) * palette[0] + i * palette[1]) / 5);
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	// The 16 three bit indices are packed into the next six bytes.
+	indices = 0;
+	for(i=0; i<6; i++)
+	{
+		indices |= (unsigned long long)source[2 + i] << (i * 8);
+	}
+
+	for(i=0; i<16; i++)
+	{
+		block[i * 4 + 3] = palette[(indices >> (i * 3)) & 7];
+	}
+
+	return;
+}
+
+
+void SoftwareTextureClass::BuildMipChain()
+{
+	MipLevelType level;
+	int x, y, c, sourceX, sourceY, sum;
+
+
+	// Halve the image until it is a single texel, averaging a 2x2 footprint that is clamped at odd edges.
+	while(m_levels.back().width > 1 || m_levels.back().height > 1)
+	{
+		const MipLevelType& source = m_levels.back();
+
+		level.width = source.width > 1 ? source.width / 2 : 1;
+		level.height = source.height > 1 ? source.height / 2 : 1;
+		level.texels.resize(level.width * level.height * 4);
+
+		for(y=0; y<level.height; y++)
+		{
+			for(x=0; x<level.width; x++)
+			{
+				sourceX = x * 2;
+				sourceY = y * 2;
+
+				for(c=0; c<4; c++)
+				{
+					sum = source.texels[(sourceY * source.width + sourceX) * 4 + c];
+					sum += source.texels[(sourceY * source.width + min(sourceX + 1, source.width - 1)) * 4 + c];
+					sum += source.texels[(min(sourceY + 1, source.height - 1) * source.width + sourceX) * 4 + c];
+					sum += source.texels[(min(sourceY + 1, source.height - 1) * source.width + min(sourceX + 1, source.width - 1)) * 4 + c];
+
+					level.texels[(y * level.width + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+				}
+			}
+		}
+
+		m_levels.push_back(level);
+	}
+
+	return;
+}
+
+
+void SoftwareTextureClass::SampleBilinear(const MipLevelType& level, float u, float v, float* color)
+{
+	float x, y, fractionX, fractionY, top, bottom;
+	int x0, y0, x1, y1, c;
+	const unsigned char *t00, *t10, *t01, *t11;
+
+
+	// Move to texel space with the texel centres on the half coordinates.
+	x = u * (float)level.width - 0.5f;
+	y = v * (float)level.height - 0.5f;
+
+	x0 = (int)floorf(x);
+	y0 = (int)floorf(y);
+	fractionX = x - (float)x0;
+	fractionY = y - (float)y0;
+
+	// Wrap the four texel coordinates like the WRAP address mode.
+	x0 = x0 % level.width;
+	y0 = y0 % level.height;
+	if(x0 < 0)
+	{
+		x0 += level.width;
+	}
+	if(y0 < 0)
+	{
+		y0 += level.height;
+	}
+	x1 = (x0 + 1) % level.width;
+	y1 = (y0 + 1) % level.height;
+
+	t00 = &level.texels[(y0 * level.width + x0) * 4];
+	t10 = &level.texels[(y0 * level.width + x1) * 4];
+	t01 = &level.texels[(y1 * level.width + x0) * 4];
+	t11 = &level.texels[(y1 * level.width + x1) * 4];
+
+	for(c=0; c<4; c++)
+	{
+		top = (float)t00[c] + ((float)t10[c] - (float)t00[c]) * fractionX;
+		bottom = (float)t01[c] + ((float)t11[c] - (float)t01[c]) * fractionX;
+		color[c] = (top + (bottom - top) * fractionY) * (1.0f / 255.0f);
+	}
+
+	return;
+}
\ No newline at end of file
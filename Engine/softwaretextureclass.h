@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: softwaretextureclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SOFTWARETEXTURECLASS_H_
+#define _SOFTWARETEXTURECLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <fstream>
+#include <vector>
+using namespace std;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: SoftwareTextureClass
+//
+// A DDS texture decoded to 8 bit RGBA for the software renderer, with a box filtered mip chain built from the top level.
+// Reads DXT1, DXT3, DXT5 and uncompressed 32 bit files, which covers every texture in the data folder.
+////////////////////////////////////////////////////////////////////////////////
+class SoftwareTextureClass
+{
+private:
+	struct MipLevelType
+	{
+		int width, height;
+		vector<unsigned char> texels;
+	};
+
+public:
+	SoftwareTextureClass();
+	SoftwareTextureClass(const SoftwareTextureClass&);
+	~SoftwareTextureClass();
+
+	bool Initialize(const wchar_t*);
+	void Shutdown();
+
+	int GetWidth();
+	int GetHeight();
+	int GetBytes();
+
+	void Sample(float, float, float, float*);
+
+private:
+	bool LoadDDS(const char*);
+	void DecodeColorBlock(const unsigned char*, unsigned char*, bool);
+	void DecodeAlphaBlock(const unsigned char*, unsigned char*);
+	void BuildMipChain();
+	void SampleBilinear(const MipLevelType&, float, float, float*);
+
+private:
+	vector<MipLevelType> m_levels;
+};
+
+#endif
\ No newline at end of file
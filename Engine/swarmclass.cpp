@@ -0,0 +1,675 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: swarmclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "swarmclass.h"
+
+
+SwarmClass::SwarmClass()
+{
+	m_Device = 0;
+	m_Terrain = 0;
+	m_WorkerPool = 0;
+	m_droneCount = 0;
+	m_streamSize = 0;
+	m_threadCount = 1;
+	m_bucketMask = 0;
+	m_kernel = 0;
+	m_kernelValue = 0.0f;
+	m_blockSize = 0;
+	m_instanceBuffer = 0;
+	m_visibleCount = 0;
+}
+
+
+SwarmClass::SwarmClass(const SwarmClass& other)
+{
+}
+
+
+SwarmClass::~SwarmClass()
+{
+}
+
+
+bool SwarmClass::Initialize(RenderDeviceClass* device, TerrainClass* terrain, int droneCount, WorkerPoolClass* workerPool, unsigned int seed)
+{
+	float angle, distance, heading, speed;
+	unsigned int random, bucketCount;
+	int i;
+
+
+	if(droneCount <= 0)
+	{
+		return false;
+	}
+
+	m_Device = device;
+	m_Terrain = terrain;
+	m_WorkerPool = workerPool;
+	m_droneCount = droneCount;
+
+	// Store the number of threads the kernels may split the drones across, without a pool they run on this thread.
+	m_threadCount = m_WorkerPool ? m_WorkerPool->GetThreadCount() : 1;
+	if(m_threadCount > SWARM_MAX_THREADS)
+	{
+		m_threadCount = SWARM_MAX_THREADS;
+	}
+
+	// The streams are padded to whole groups of four and one group more, so a group read at the end of a run never
+	// reads past the end of a stream.
+	m_streamSize = ((m_droneCount + 3) & ~3) + 4;
+	for(i=0; i<STREAM_COUNT; i++)
+	{
+		m_streams[i].assign(m_streamSize, 0.0f);
+		m_sortedStreams[i].assign(m_streamSize, 0.0f);
+	}
+
+	for(i=0; i<3; i++)
+	{
+		m_acceleration[i].assign(m_streamSize, 0.0f);
+	}
+
+	// Give the hash table at least twice as many buckets as there are drones so few cells share a bucket.
+	bucketCount = 1;
+	while(bucketCount < (unsigned int)m_droneCount * 2)
+	{
+		bucketCount *= 2;
+	}
+
+	m_bucketMask = bucketCount - 1;
+	m_buckets.resize(m_droneCount);
+	m_bucketStart.resize(bucketCount + 1);
+	m_bucketCursor.resize(bucketCount);
+
+	// Scatter the drones over the airfield at their flying height, heading every which way.
+	random = seed ? seed : 1;
+	for(i=0; i<m_droneCount; i++)
+	{
+		angle = Random(random) * XM_2PI;
+		distance = sqrtf(Random(random)) * SWARM_HOME_RADIUS * 0.8f;
+		heading = Random(random) * XM_2PI;
+		speed = SWARM_MIN_SPEED + (SWARM_MAX_SPEED - SWARM_MIN_SPEED) * Random(random);
+
+		m_streams[STREAM_POSITION_X][i] = cosf(angle) * distance;
+		m_streams[STREAM_POSITION_Z][i] = sinf(angle) * distance;
+		m_streams[STREAM_POSITION_Y][i] = m_Terrain->GetHeight(m_streams[STREAM_POSITION_X][i], m_streams[STREAM_POSITION_Z][i]) + SWARM_ALTITUDE +
+										  (Random(random) - 0.5f) * SWARM_ALTITUDE * 0.5f;
+		m_streams[STREAM_VELOCITY_X][i] = sinf(heading) * speed;
+		m_streams[STREAM_VELOCITY_Y][i] = 0.0f;
+		m_streams[STREAM_VELOCITY_Z][i] = cosf(heading) * speed;
+		m_streams[STREAM_PREVIOUS_X][i] = m_streams[STREAM_POSITION_X][i];
+		m_streams[STREAM_PREVIOUS_Y][i] = m_streams[STREAM_POSITION_Y][i];
+		m_streams[STREAM_PREVIOUS_Z][i] = m_streams[STREAM_POSITION_Z][i];
+	}
+
+	// Create the instance buffer with room for every drone, it is rewritten with the drones in view every frame.
+	m_instances.resize(m_droneCount);
+
+	m_instanceBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_INSTANCE_BUFFER, 0, sizeof(XMFLOAT4X4) * m_droneCount);
+	if(!m_instanceBuffer)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void SwarmClass::Shutdown()
+{
+	int i;
+
+
+	// Release the instance buffer.
+	if(m_instanceBuffer)
+	{
+		m_Device->ReleaseResource(m_instanceBuffer);
+		m_instanceBuffer = 0;
+	}
+
+	// Release the streams and the hash table.
+	for(i=0; i<STREAM_COUNT; i++)
+	{
+		m_streams[i].clear();
+		m_streams[i].shrink_to_fit();
+		m_sortedStreams[i].clear();
+		m_sortedStreams[i].shrink_to_fit();
+	}
+
+	for(i=0; i<3; i++)
+	{
+		m_acceleration[i].clear();
+		m_acceleration[i].shrink_to_fit();
+	}
+
+	m_buckets.clear();
+	m_buckets.shrink_to_fit();
+	m_bucketStart.clear();
+	m_bucketStart.shrink_to_fit();
+	m_bucketCursor.clear();
+	m_bucketCursor.shrink_to_fit();
+	m_instances.clear();
+	m_instances.shrink_to_fit();
+
+	m_droneCount = 0;
+	m_visibleCount = 0;
+	m_WorkerPool = 0;
+	m_Terrain = 0;
+	m_Device = 0;
+
+	return;
+}
+
+
+void SwarmClass::Update(float frameTime)
+{
+	CpuZoneClass zone;
+	float time;
+
+
+	// The steering works in units per second.
+	time = frameTime * 0.001f;
+
+	// Sort the drones by the cell they are in so the neighbours of every drone sit together in the streams.
+	zone.Begin("SwarmGrid");
+	BuildGrid();
+
+	// Work out how every drone wants to turn from where its neighbours were at the start of the step.
+	zone.Begin("SwarmSteer");
+	Dispatch(SteerDrones, m_droneCount, time);
+
+	// Then move them all, four at a time.
+	zone.Begin("SwarmMove");
+	Dispatch(MoveDrones, (m_droneCount + 3) & ~3, time);
+
+	return;
+}
+
+
+bool SwarmClass::Render(CameraClass* camera, float interpolation)
+{
+	CpuZoneClass zone("SwarmInstances");
+	int i, blockCount;
+	bool result;
+
+
+	// Take a copy of the frustum planes, the camera updates them on demand so the threads must not ask it themselves.
+	camera->GetFrustumPlanes(m_frustumPlanes);
+
+	// Every block writes the world matrices of its drones in view to the start of its own part of the instances.
+	memset(m_blockCounts, 0, sizeof(m_blockCounts));
+	Dispatch(WriteInstances, m_droneCount, interpolation);
+
+	// Close the gaps between the blocks.
+	m_visibleCount = m_blockCounts[0];
+	blockCount = (m_droneCount + m_blockSize - 1) / m_blockSize;
+	for(i=1; i<blockCount; i++)
+	{
+		if(m_blockCounts[i] > 0)
+		{
+			memmove(&m_instances[m_visibleCount], &m_instances[i * m_blockSize], sizeof(XMFLOAT4X4) * m_blockCounts[i]);
+			m_visibleCount += m_blockCounts[i];
+		}
+	}
+
+	// There is nothing to draw when the whole swarm is out of view.
+	if(m_visibleCount == 0)
+	{
+		return true;
+	}
+
+	// Copy the world matrices into the instance buffer and put it on the pipeline next to the drone model.
+	result = m_Device->UpdateBuffer(m_instanceBuffer, &m_instances[0], sizeof(XMFLOAT4X4) * m_visibleCount);
+	if(!result)
+	{
+		return false;
+	}
+
+	m_Device->SetInstanceBuffer(m_instanceBuffer, sizeof(XMFLOAT4X4));
+
+	return true;
+}
+
+
+int SwarmClass::GetDroneCount()
+{
+	return m_droneCount;
+}
+
+
+int SwarmClass::GetVisibleCount()
+{
+	return m_visibleCount;
+}
+
+
+void SwarmClass::BuildGrid()
+{
+	const float* positionX;
+	const float* positionY;
+	const float* positionZ;
+	unsigned int bucket;
+	int i, j, start, count, slot;
+
+
+	positionX = &m_streams[STREAM_POSITION_X][0];
+	positionY = &m_streams[STREAM_POSITION_Y][0];
+	positionZ = &m_streams[STREAM_POSITION_Z][0];
+
+	// Hash the cell of every drone and count the drones in every bucket.
+	memset(&m_bucketStart[0], 0, sizeof(int) * m_bucketStart.size());
+	for(i=0; i<m_droneCount; i++)
+	{
+		bucket = GetBucket((int)floorf(positionX[i] / SWARM_NEIGHBOUR_RADIUS), (int)floorf(positionY[i] / SWARM_NEIGHBOUR_RADIUS),
+						   (int)floorf(positionZ[i] / SWARM_NEIGHBOUR_RADIUS));
+		m_buckets[i] = bucket;
+		m_bucketStart[bucket]++;
+	}
+
+	// Turn the counts into the first slot of every bucket, the extra entry at the end closes the last one.
+	start = 0;
+	for(i=0; i<(int)m_bucketMask + 1; i++)
+	{
+		count = m_bucketStart[i];
+		m_bucketStart[i] = start;
+		m_bucketCursor[i] = start;
+		start += count;
+	}
+	m_bucketStart[m_bucketMask + 1] = start;
+
+	// Move every drone to the next slot of its bucket, the drones of a bucket keep their order so the sort is the same
+	// every run.
+	for(i=0; i<m_droneCount; i++)
+	{
+		slot = m_bucketCursor[m_buckets[i]]++;
+		for(j=0; j<STREAM_COUNT; j++)
+		{
+			m_sortedStreams[j][slot] = m_streams[j][i];
+		}
+	}
+
+	for(j=0; j<STREAM_COUNT; j++)
+	{
+		m_streams[j].swap(m_sortedStreams[j]);
+	}
+
+	return;
+}
+
+
+void SwarmClass::Dispatch(KernelType kernel, int count, float value)
+{
+	// A small swarm is not worth waking the workers for.
+	if((m_threadCount == 1) || (count < SWARM_PARALLEL_MIN_COUNT))
+	{
+		m_blockSize = max(count, 1);
+		kernel(this, 0, count, value);
+		return;
+	}
+
+	// Split the drones into one contiguous block per thread, the blocks start on a group of four for the kernels that
+	// work four drones at a time.
+	m_blockSize = (((count + m_threadCount - 1) / m_threadCount) + 3) & ~3;
+	m_kernel = kernel;
+	m_kernelValue = value;
+	m_WorkerPool->Run(RunKernel, this, count, m_blockSize);
+
+	return;
+}
+
+
+unsigned int SwarmClass::GetBucket(int cellX, int cellY, int cellZ)
+{
+	// The cells along x fall in consecutive buckets, so a row of cells is one run of the sorted streams.
+	return ((unsigned int)cellX + (unsigned int)cellY * 73856093u + (unsigned int)cellZ * 19349663u) & m_bucketMask;
+}
+
+
+float SwarmClass::Random(unsigned int& state)
+{
+	// Step a xorshift generator and keep the top bits as a fraction.
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+
+	return (float)(state >> 8) * (1.0f / 16777216.0f);
+}
+
+
+void SwarmClass::RunKernel(void* context, int first, int last)
+{
+	SwarmClass* swarm;
+
+
+	// Run the kernel of the current dispatch on one block of the drones.
+	swarm = (SwarmClass*)context;
+	swarm->m_kernel(swarm, first, last, swarm->m_kernelValue);
+
+	return;
+}
+
+
+void SwarmClass::SteerDrones(SwarmClass* swarm, int first, int last, float /*time*/)
+{
+	const float* positionX;
+	const float* positionY;
+	const float* positionZ;
+	const float* velocityX;
+	const float* velocityY;
+	const float* velocityZ;
+	RunType runs[18];
+	XMVECTOR selfX, selfY, selfZ, lanes, one, zero, neighbourLimit, separationLimit, tiny;
+	XMVECTOR countSum, offsetX, offsetY, offsetZ, headingX, headingY, headingZ, separationX, separationY, separationZ;
+	XMVECTOR deltaX, deltaY, deltaZ, distance, inside, close, weight;
+	XMFLOAT4 sums[10];
+	float neighbours, accelerationX, accelerationY, accelerationZ, target, range, length;
+	int i, j, k, runCount, count, cellX, cellY, cellZ, y, z, start, end;
+
+
+	positionX = &swarm->m_streams[STREAM_POSITION_X][0];
+	positionY = &swarm->m_streams[STREAM_POSITION_Y][0];
+	positionZ = &swarm->m_streams[STREAM_POSITION_Z][0];
+	velocityX = &swarm->m_streams[STREAM_VELOCITY_X][0];
+	velocityY = &swarm->m_streams[STREAM_VELOCITY_Y][0];
+	velocityZ = &swarm->m_streams[STREAM_VELOCITY_Z][0];
+
+	lanes = XMVectorSet(0.0f, 1.0f, 2.0f, 3.0f);
+	one = XMVectorReplicate(1.0f);
+	zero = XMVectorZero();
+	tiny = XMVectorReplicate(1.0e-4f);
+	neighbourLimit = XMVectorReplicate(SWARM_NEIGHBOUR_RADIUS * SWARM_NEIGHBOUR_RADIUS);
+	separationLimit = XMVectorReplicate(SWARM_SEPARATION_RADIUS * SWARM_SEPARATION_RADIUS);
+
+	for(i=first; i<last; i++)
+	{
+		// Every row of three cells around the drone is a run of three buckets, or two runs where it wraps around the end
+		// of the table.  Keep the runs in order of their first bucket.
+		cellX = (int)floorf(positionX[i] / SWARM_NEIGHBOUR_RADIUS);
+		cellY = (int)floorf(positionY[i] / SWARM_NEIGHBOUR_RADIUS);
+		cellZ = (int)floorf(positionZ[i] / SWARM_NEIGHBOUR_RADIUS);
+
+		runCount = 0;
+		for(z=-1; z<=1; z++)
+		{
+			for(y=-1; y<=1; y++)
+			{
+				start = swarm->GetBucket(cellX - 1, cellY + y, cellZ + z);
+				end = start + 2;
+				if(end > (int)swarm->m_bucketMask)
+				{
+					for(k=runCount; k>0; k--)
+					{
+						runs[k] = runs[k - 1];
+					}
+					runs[0].start = 0;
+					runs[0].end = end - (int)swarm->m_bucketMask - 1;
+					runCount++;
+					end = (int)swarm->m_bucketMask;
+				}
+
+				for(k=runCount; k>0 && runs[k - 1].start > start; k--)
+				{
+					runs[k] = runs[k - 1];
+				}
+				runs[k].start = start;
+				runs[k].end = end;
+				runCount++;
+			}
+		}
+
+		// Join the runs that share or follow on from each other's buckets, so no drone is read twice, and turn them into
+		// runs of the streams.
+		count = 0;
+		for(k=0; k<runCount; k++)
+		{
+			if(count > 0 && runs[k].start <= runs[count - 1].end + 1)
+			{
+				runs[count - 1].end = max(runs[count - 1].end, runs[k].end);
+				continue;
+			}
+
+			runs[count++] = runs[k];
+		}
+		runCount = count;
+
+		for(k=0; k<runCount; k++)
+		{
+			runs[k].start = swarm->m_bucketStart[runs[k].start];
+			runs[k].end = swarm->m_bucketStart[runs[k].end + 1];
+		}
+
+		selfX = XMVectorReplicate(positionX[i]);
+		selfY = XMVectorReplicate(positionY[i]);
+		selfZ = XMVectorReplicate(positionZ[i]);
+
+		countSum = offsetX = offsetY = offsetZ = zero;
+		headingX = headingY = headingZ = zero;
+		separationX = separationY = separationZ = zero;
+
+		// Test the drones of every run four at a time, a lane counts when it is inside the run, is not the drone
+		// itself and is within the neighbour radius.
+		for(k=0; k<runCount; k++)
+		{
+			start = runs[k].start;
+			end = runs[k].end;
+			for(j=start; j<end; j+=4)
+			{
+				deltaX = XMVectorSubtract(XMLoadFloat4((const XMFLOAT4*)&positionX[j]), selfX);
+				deltaY = XMVectorSubtract(XMLoadFloat4((const XMFLOAT4*)&positionY[j]), selfY);
+				deltaZ = XMVectorSubtract(XMLoadFloat4((const XMFLOAT4*)&positionZ[j]), selfZ);
+				distance = XMVectorMultiplyAdd(deltaX, deltaX, XMVectorMultiplyAdd(deltaY, deltaY, XMVectorMultiply(deltaZ, deltaZ)));
+
+				inside = XMVectorAndInt(XMVectorLess(lanes, XMVectorReplicate((float)(end - j))),
+										XMVectorAndInt(XMVectorGreater(distance, zero), XMVectorLess(distance, neighbourLimit)));
+				close = XMVectorAndInt(inside, XMVectorLess(distance, separationLimit));
+
+				countSum = XMVectorAdd(countSum, XMVectorAndInt(one, inside));
+				offsetX = XMVectorAdd(offsetX, XMVectorAndInt(deltaX, inside));
+				offsetY = XMVectorAdd(offsetY, XMVectorAndInt(deltaY, inside));
+				offsetZ = XMVectorAdd(offsetZ, XMVectorAndInt(deltaZ, inside));
+				headingX = XMVectorAdd(headingX, XMVectorAndInt(XMLoadFloat4((const XMFLOAT4*)&velocityX[j]), inside));
+				headingY = XMVectorAdd(headingY, XMVectorAndInt(XMLoadFloat4((const XMFLOAT4*)&velocityY[j]), inside));
+				headingZ = XMVectorAdd(headingZ, XMVectorAndInt(XMLoadFloat4((const XMFLOAT4*)&velocityZ[j]), inside));
+
+				// The drones that are too close push harder the closer they are.
+				weight = XMVectorDivide(XMVectorAndInt(one, close), XMVectorMax(distance, tiny));
+				separationX = XMVectorSubtract(separationX, XMVectorMultiply(deltaX, weight));
+				separationY = XMVectorSubtract(separationY, XMVectorMultiply(deltaY, weight));
+				separationZ = XMVectorSubtract(separationZ, XMVectorMultiply(deltaZ, weight));
+			}
+		}
+
+		// Add up the lanes.
+		XMStoreFloat4(&sums[0], countSum);
+		XMStoreFloat4(&sums[1], offsetX);
+		XMStoreFloat4(&sums[2], offsetY);
+		XMStoreFloat4(&sums[3], offsetZ);
+		XMStoreFloat4(&sums[4], headingX);
+		XMStoreFloat4(&sums[5], headingY);
+		XMStoreFloat4(&sums[6], headingZ);
+		XMStoreFloat4(&sums[7], separationX);
+		XMStoreFloat4(&sums[8], separationY);
+		XMStoreFloat4(&sums[9], separationZ);
+
+		neighbours = sums[0].x + sums[0].y + sums[0].z + sums[0].w;
+
+		accelerationX = 0.0f;
+		accelerationY = 0.0f;
+		accelerationZ = 0.0f;
+
+		// Steer towards the middle of the neighbours, along with their heading and away from the ones too close.
+		if(neighbours > 0.0f)
+		{
+			accelerationX += (sums[1].x + sums[1].y + sums[1].z + sums[1].w) / neighbours * SWARM_COHESION_WEIGHT;
+			accelerationY += (sums[2].x + sums[2].y + sums[2].z + sums[2].w) / neighbours * SWARM_COHESION_WEIGHT;
+			accelerationZ += (sums[3].x + sums[3].y + sums[3].z + sums[3].w) / neighbours * SWARM_COHESION_WEIGHT;
+
+			accelerationX += ((sums[4].x + sums[4].y + sums[4].z + sums[4].w) / neighbours - velocityX[i]) * SWARM_ALIGNMENT_WEIGHT;
+			accelerationY += ((sums[5].x + sums[5].y + sums[5].z + sums[5].w) / neighbours - velocityY[i]) * SWARM_ALIGNMENT_WEIGHT;
+			accelerationZ += ((sums[6].x + sums[6].y + sums[6].z + sums[6].w) / neighbours - velocityZ[i]) * SWARM_ALIGNMENT_WEIGHT;
+
+			accelerationX += (sums[7].x + sums[7].y + sums[7].z + sums[7].w) * SWARM_SEPARATION_WEIGHT;
+			accelerationY += (sums[8].x + sums[8].y + sums[8].z + sums[8].w) * SWARM_SEPARATION_WEIGHT;
+			accelerationZ += (sums[9].x + sums[9].y + sums[9].z + sums[9].w) * SWARM_SEPARATION_WEIGHT;
+		}
+
+		// Hold the flying height over the ground below, damping the climb so the drones do not bob around it.
+		target = swarm->m_Terrain->GetHeight(positionX[i], positionZ[i]) + SWARM_ALTITUDE;
+		accelerationY += (target - positionY[i]) * SWARM_ALTITUDE_WEIGHT - velocityY[i] * SWARM_CLIMB_DAMPING;
+
+		// Pull the drones that strayed too far from the airfield back towards it.
+		range = sqrtf(positionX[i] * positionX[i] + positionZ[i] * positionZ[i]);
+		if(range > SWARM_HOME_RADIUS)
+		{
+			accelerationX -= positionX[i] / range * (range - SWARM_HOME_RADIUS) * SWARM_HOME_WEIGHT;
+			accelerationZ -= positionZ[i] / range * (range - SWARM_HOME_RADIUS) * SWARM_HOME_WEIGHT;
+		}
+
+		// Limit how hard a drone can turn.
+		length = sqrtf(accelerationX * accelerationX + accelerationY * accelerationY + accelerationZ * accelerationZ);
+		if(length > SWARM_MAX_ACCELERATION)
+		{
+			accelerationX *= SWARM_MAX_ACCELERATION / length;
+			accelerationY *= SWARM_MAX_ACCELERATION / length;
+			accelerationZ *= SWARM_MAX_ACCELERATION / length;
+		}
+
+		swarm->m_acceleration[0][i] = accelerationX;
+		swarm->m_acceleration[1][i] = accelerationY;
+		swarm->m_acceleration[2][i] = accelerationZ;
+	}
+
+	return;
+}
+
+
+void SwarmClass::MoveDrones(SwarmClass* swarm, int first, int last, float time)
+{
+	float* stream[STREAM_COUNT];
+	XMVECTOR step, minimum, maximum, tiny, positionX, positionY, positionZ, velocityX, velocityY, velocityZ, speed, scale;
+	int i;
+
+
+	for(i=0; i<STREAM_COUNT; i++)
+	{
+		stream[i] = &swarm->m_streams[i][0];
+	}
+
+	step = XMVectorReplicate(time);
+	minimum = XMVectorReplicate(SWARM_MIN_SPEED);
+	maximum = XMVectorReplicate(SWARM_MAX_SPEED);
+	tiny = XMVectorReplicate(1.0e-4f);
+
+	for(i=first; i<last; i+=4)
+	{
+		positionX = XMLoadFloat4((const XMFLOAT4*)&stream[STREAM_POSITION_X][i]);
+		positionY = XMLoadFloat4((const XMFLOAT4*)&stream[STREAM_POSITION_Y][i]);
+		positionZ = XMLoadFloat4((const XMFLOAT4*)&stream[STREAM_POSITION_Z][i]);
+
+		// Keep where the drones were for drawing them between the steps.
+		XMStoreFloat4((XMFLOAT4*)&stream[STREAM_PREVIOUS_X][i], positionX);
+		XMStoreFloat4((XMFLOAT4*)&stream[STREAM_PREVIOUS_Y][i], positionY);
+		XMStoreFloat4((XMFLOAT4*)&stream[STREAM_PREVIOUS_Z][i], positionZ);
+
+		velocityX = XMVectorMultiplyAdd(XMLoadFloat4((const XMFLOAT4*)&swarm->m_acceleration[0][i]), step,
+										XMLoadFloat4((const XMFLOAT4*)&stream[STREAM_VELOCITY_X][i]));
+		velocityY = XMVectorMultiplyAdd(XMLoadFloat4((const XMFLOAT4*)&swarm->m_acceleration[1][i]), step,
+										XMLoadFloat4((const XMFLOAT4*)&stream[STREAM_VELOCITY_Y][i]));
+		velocityZ = XMVectorMultiplyAdd(XMLoadFloat4((const XMFLOAT4*)&swarm->m_acceleration[2][i]), step,
+										XMLoadFloat4((const XMFLOAT4*)&stream[STREAM_VELOCITY_Z][i]));
+
+		// Keep the speed between the slowest a drone can hover along at and its top speed, the padding past the last
+		// drone has no speed and stays put.
+		speed = XMVectorSqrt(XMVectorMultiplyAdd(velocityX, velocityX, XMVectorMultiplyAdd(velocityY, velocityY, XMVectorMultiply(velocityZ, velocityZ))));
+		scale = XMVectorDivide(XMVectorClamp(speed, minimum, maximum), XMVectorMax(speed, tiny));
+		scale = XMVectorAndInt(scale, XMVectorGreater(speed, tiny));
+		velocityX = XMVectorMultiply(velocityX, scale);
+		velocityY = XMVectorMultiply(velocityY, scale);
+		velocityZ = XMVectorMultiply(velocityZ, scale);
+
+		XMStoreFloat4((XMFLOAT4*)&stream[STREAM_VELOCITY_X][i], velocityX);
+		XMStoreFloat4((XMFLOAT4*)&stream[STREAM_VELOCITY_Y][i], velocityY);
+		XMStoreFloat4((XMFLOAT4*)&stream[STREAM_VELOCITY_Z][i], velocityZ);
+
+		XMStoreFloat4((XMFLOAT4*)&stream[STREAM_POSITION_X][i], XMVectorMultiplyAdd(velocityX, step, positionX));
+		XMStoreFloat4((XMFLOAT4*)&stream[STREAM_POSITION_Y][i], XMVectorMultiplyAdd(velocityY, step, positionY));
+		XMStoreFloat4((XMFLOAT4*)&stream[STREAM_POSITION_Z][i], XMVectorMultiplyAdd(velocityZ, step, positionZ));
+	}
+
+	return;
+}
+
+
+void SwarmClass::WriteInstances(SwarmClass* swarm, int first, int last, float interpolation)
+{
+	XMFLOAT4X4* instances;
+	XMFLOAT4X4* world;
+	const XMFLOAT4* plane;
+	XMFLOAT3 position, velocity;
+	float speed, forwardX, forwardY, forwardZ, level, rightX, rightZ;
+	int i, k, count;
+
+
+	instances = &swarm->m_instances[first];
+	count = 0;
+
+	for(i=first; i<last; i++)
+	{
+		// Draw the drone between where it was at the last two steps.
+		position.x = swarm->m_streams[STREAM_PREVIOUS_X][i] + (swarm->m_streams[STREAM_POSITION_X][i] - swarm->m_streams[STREAM_PREVIOUS_X][i]) * interpolation;
+		position.y = swarm->m_streams[STREAM_PREVIOUS_Y][i] + (swarm->m_streams[STREAM_POSITION_Y][i] - swarm->m_streams[STREAM_PREVIOUS_Y][i]) * interpolation;
+		position.z = swarm->m_streams[STREAM_PREVIOUS_Z][i] + (swarm->m_streams[STREAM_POSITION_Z][i] - swarm->m_streams[STREAM_PREVIOUS_Z][i]) * interpolation;
+
+		// Skip the drone once it is wholly behind any one of the frustum planes.
+		for(k=0; k<CAMERA_FRUSTUM_PLANES; k++)
+		{
+			plane = &swarm->m_frustumPlanes[k];
+			if(plane->x * position.x + plane->y * position.y + plane->z * position.z + plane->w < -SWARM_DRONE_RADIUS)
+			{
+				break;
+			}
+		}
+		if(k < CAMERA_FRUSTUM_PLANES)
+		{
+			continue;
+		}
+
+		// Point the nose of the drone along its velocity and keep its wings level, the rows of the world matrix are the
+		// right, up and forward axes of the drone followed by its position.
+		velocity.x = swarm->m_streams[STREAM_VELOCITY_X][i];
+		velocity.y = swarm->m_streams[STREAM_VELOCITY_Y][i];
+		velocity.z = swarm->m_streams[STREAM_VELOCITY_Z][i];
+
+		speed = sqrtf(velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
+		forwardX = velocity.x / speed;
+		forwardY = velocity.y / speed;
+		forwardZ = velocity.z / speed;
+
+		level = sqrtf(forwardX * forwardX + forwardZ * forwardZ);
+		rightX = (level > 1.0e-4f) ? forwardZ / level : 1.0f;
+		rightZ = (level > 1.0e-4f) ? -forwardX / level : 0.0f;
+
+		world = &instances[count];
+		world->_11 = rightX;
+		world->_12 = 0.0f;
+		world->_13 = rightZ;
+		world->_14 = 0.0f;
+		world->_21 = forwardY * rightZ;
+		world->_22 = forwardZ * rightX - forwardX * rightZ;
+		world->_23 = -forwardY * rightX;
+		world->_24 = 0.0f;
+		world->_31 = forwardX;
+		world->_32 = forwardY;
+		world->_33 = forwardZ;
+		world->_34 = 0.0f;
+		world->_41 = position.x;
+		world->_42 = position.y;
+		world->_43 = position.z;
+		world->_44 = 1.0f;
+		count++;
+	}
+
+	swarm->m_blockCounts[first / swarm->m_blockSize] = count;
+
+	return;
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: swarmclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SWARMCLASS_H_
+#define _SWARMCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include <DirectXMath.h>
+using namespace DirectX;
+using namespace std;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+#include "cameraclass.h"
+#include "terrainclass.h"
+#include "cpuprofilerclass.h"
+#include "workerpoolclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int SWARM_DRONE_COUNT = 4096;
+const int SWARM_MAX_THREADS = 8;
+const int SWARM_PARALLEL_MIN_COUNT = 1024;
+const unsigned int SWARM_SEED = 4242;
+const float SWARM_NEIGHBOUR_RADIUS = 16.0f;
+const float SWARM_SEPARATION_RADIUS = 6.0f;
+const float SWARM_SEPARATION_WEIGHT = 40.0f;
+const float SWARM_ALIGNMENT_WEIGHT = 1.0f;
+const float SWARM_COHESION_WEIGHT = 0.4f;
+const float SWARM_ALTITUDE = 60.0f;
+const float SWARM_ALTITUDE_WEIGHT = 0.5f;
+const float SWARM_CLIMB_DAMPING = 1.0f;
+const float SWARM_HOME_RADIUS = 500.0f;
+const float SWARM_HOME_WEIGHT = 0.05f;
+const float SWARM_MIN_SPEED = 8.0f;
+const float SWARM_MAX_SPEED = 24.0f;
+const float SWARM_MAX_ACCELERATION = 30.0f;
+const float SWARM_DRONE_RADIUS = 2.0f;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: SwarmClass
+//
+// Flies a swarm of drones that steer like boids, away from the drones that are too close, along with the heading of
+// their neighbours and towards the middle of them, while holding a height above the terrain and turning back once they
+// stray too far from the airfield.  The drones are kept as separate streams of floats, one for each component, so the
+// steering and the movement work on four drones at a time.  Every step the streams are sorted by a hash of the grid
+// cell each drone is in, and as the hash keeps the cells along a row next to each other the neighbours of a drone are
+// read from a handful of runs of the streams, one for each row of cells around it.  Both the steering and the movement
+// split the drones into one contiguous block per thread of the shared worker pool, and each drone only reads the state from before the step, so
+// the swarm moves the same whatever the number of threads.  The world matrices of the drones in view are written
+// straight into an instance buffer and drawn with one instanced draw.
+////////////////////////////////////////////////////////////////////////////////
+class SwarmClass
+{
+private:
+	enum StreamType
+	{
+		STREAM_POSITION_X,
+		STREAM_POSITION_Y,
+		STREAM_POSITION_Z,
+		STREAM_VELOCITY_X,
+		STREAM_VELOCITY_Y,
+		STREAM_VELOCITY_Z,
+		STREAM_PREVIOUS_X,
+		STREAM_PREVIOUS_Y,
+		STREAM_PREVIOUS_Z,
+		STREAM_COUNT
+	};
+
+	struct RunType
+	{
+		int start, end;
+	};
+
+	typedef void (*KernelType)(SwarmClass*, int, int, float);
+
+public:
+	SwarmClass();
+	SwarmClass(const SwarmClass&);
+	~SwarmClass();
+
+	bool Initialize(RenderDeviceClass*, TerrainClass*, int, WorkerPoolClass*, unsigned int);
+	void Shutdown();
+
+	void Update(float);
+	bool Render(CameraClass*, float);
+
+	int GetDroneCount();
+	int GetVisibleCount();
+
+private:
+	void BuildGrid();
+	void Dispatch(KernelType, int, float);
+	unsigned int GetBucket(int, int, int);
+	static float Random(unsigned int&);
+	static void RunKernel(void*, int, int);
+
+	static void SteerDrones(SwarmClass*, int, int, float);
+	static void MoveDrones(SwarmClass*, int, int, float);
+	static void WriteInstances(SwarmClass*, int, int, float);
+
+private:
+	RenderDeviceClass* m_Device;
+	TerrainClass* m_Terrain;
+	WorkerPoolClass* m_WorkerPool;
+	int m_droneCount, m_streamSize, m_threadCount;
+	vector<float> m_streams[STREAM_COUNT];
+	vector<float> m_sortedStreams[STREAM_COUNT];
+	vector<float> m_acceleration[3];
+	vector<unsigned int> m_buckets;
+	vector<int> m_bucketStart, m_bucketCursor;
+	unsigned int m_bucketMask;
+	XMFLOAT4 m_frustumPlanes[CAMERA_FRUSTUM_PLANES];
+	vector<XMFLOAT4X4> m_instances;
+	KernelType m_kernel;
+	float m_kernelValue;
+	int m_blockSize, m_blockCounts[SWARM_MAX_THREADS];
+	int m_instanceBuffer;
+	int m_visibleCount;
+};
+
+#endif
\ No newline at end of file
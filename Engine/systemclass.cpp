@@ -27,6 +27,10 @@ bool SystemClass::Initialize()
 	bool result;
 
 
+	// Start recording the CPU zones so the startup shows up in the trace.
+	CpuProfilerClass::Initialize();
+	CpuProfilerClass::SetThreadName("Main");
+
 	// Initialize the width and height of the screen to zero before sending the variables into the function.
 	screenWidth = 0;
 	screenHeight = 0;
@@ -34,7 +38,7 @@ bool SystemClass::Initialize()
 	// Initialize the windows api.
 	InitializeWindows(screenWidth, screenHeight);
 
-	// Create the input object.  This object will be used to handle reading the keyboard input from the user.
+	// Create the input object.  This object reads the keyboard and the mouse once a frame for the whole application.
 	m_Input = new InputClass;
 	if (!m_Input)
 	{
@@ -42,7 +46,12 @@ bool SystemClass::Initialize()
 	}
 
 	// Initialize the input object.
-	m_Input->Initialize(m_hinstance, m_hwnd, screenWidth, screenHeight);
+	result = m_Input->Initialize(m_hinstance, m_hwnd, screenWidth, screenHeight);
+	if (!result)
+	{
+		MessageBox(m_hwnd, L"Could not initialize the input object.", L"Error", MB_OK);
+		return false;
+	}
 
 	// Create the graphics object.  This object will handle rendering all the graphics for this application.
 	m_Graphics = new GraphicsClass;
@@ -52,7 +61,7 @@ bool SystemClass::Initialize()
 	}
 
 	// Initialize the graphics object.
-	result = m_Graphics->Initialize(m_hinstance, m_hwnd, screenWidth, screenHeight);
+	result = m_Graphics->Initialize(m_hwnd, screenWidth, screenHeight);
 	if (!result)
 	{
 		return false;
@@ -75,6 +84,7 @@ void SystemClass::Shutdown()
 	// Release the input object.
 	if (m_Input)
 	{
+		m_Input->Shutdown();
 		delete m_Input;
 		m_Input = 0;
 	}
@@ -82,10 +92,42 @@ void SystemClass::Shutdown()
 	// Shutdown the window.
 	ShutdownWindows();
 
+	// Write out the CPU zones of the whole run.
+	CpuProfilerClass::WriteTrace(CPU_TRACE_FILENAME);
+	CpuProfilerClass::Shutdown();
+
 	return;
 }
 
 
+bool SystemClass::StartBenchmark()
+{
+	// Hand the camera over to the benchmark path, the application ends once the results are written.
+	return m_Graphics->StartBenchmark(BENCHMARK_WARMUP_FRAMES, BENCHMARK_FRAMES, BENCHMARK_FILENAME, BENCHMARK_SUMMARY_FILENAME);
+}
+
+
+bool SystemClass::StartLatencyMeasurement()
+{
+	// Write the time from reading the input to presenting of every frame out.
+	return m_Graphics->StartLatencyMeasurement();
+}
+
+
+bool SystemClass::StartInputRecording()
+{
+	// Write the input and the frame time of every frame to the input log.
+	return m_Graphics->StartInputRecording(INPUT_LOG_FILENAME);
+}
+
+
+bool SystemClass::StartInputReplay()
+{
+	// Play the input log back in place of the user, the application ends with the log.
+	return m_Graphics->StartInputReplay(INPUT_LOG_FILENAME);
+}
+
+
 void SystemClass::Run()
 {
 	MSG msg;
@@ -99,19 +141,20 @@ void SystemClass::Run()
 	done = false;
 	while (!done)
 	{
-		// Handle the windows messages.
-		if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+		// Handle all the waiting windows messages, so a burst of messages does not hold back the frames one at a time.
+		while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
 		{
 			TranslateMessage(&msg);
 			DispatchMessage(&msg);
-		}
 
-		// If windows signals to end the application then exit out.
-		if (msg.message == WM_QUIT)
-		{
-			done = true;
+			// If windows signals to end the application then exit out.
+			if (msg.message == WM_QUIT)
+			{
+				done = true;
+			}
 		}
-		else
+
+		if (!done)
 		{
 			// Otherwise do the frame processing.
 			result = Frame();
@@ -129,23 +172,30 @@ void SystemClass::Run()
 
 bool SystemClass::Frame()
 {
+	CpuZoneClass frameZone("Frame");
+	CpuZoneClass inputZone;
 	bool result;
 
-	// Read the user input.
+	// Wait until the swap chain can take the frame, everything after this is as fresh as it can be when it is shown.
+	m_Graphics->WaitForFrame();
+
+	// Read the user input, this is the only read of the frame and everything after works from the snapshot.
+	inputZone.Begin("Input");
 	result = m_Input->Frame();
 	if (!result)
 	{
 		return false;
 	}
+	inputZone.End();
 
 	// Check if the user pressed escape and wants to exit the application.
-	if (m_Input->IsEscapePressed() == true)
+	if (m_Input->GetSnapshot().IsKeyDown(InputSnapshotClass::KEY_ESCAPE) == true)
 	{
 		return false;
 	}
 
 	// Do the frame processing for the graphics object.
-	result = m_Graphics->Frame();
+	result = m_Graphics->Frame(&m_Input->GetSnapshot());
 	if (!result)
 	{
 		return false;
@@ -37,6 +37,10 @@ public:
 	bool Initialize();
 	void Shutdown();
 	void Run();
+	bool StartBenchmark();
+	bool StartLatencyMeasurement();
+	bool StartInputRecording();
+	bool StartInputReplay();
 
 	LRESULT CALLBACK MessageHandler(HWND, UINT, WPARAM, LPARAM);
 
@@ -66,6 +70,7 @@ static LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
 // GLOBALS //
 /////////////
 static SystemClass* ApplicationHandle = 0;
+const char* const CPU_TRACE_FILENAME = "../Engine/cputrace.json";
 
 
 #endif
\ No newline at end of file
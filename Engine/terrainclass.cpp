@@ -0,0 +1,833 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: terrainclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "terrainclass.h"
+
+
+TerrainClass::TerrainClass()
+{
+	int i;
+
+
+	m_Device = 0;
+	m_frame = 0;
+
+	for(i=0; i<TERRAIN_STITCH_COUNT; i++)
+	{
+		m_indexBuffers[i] = 0;
+		m_indexCounts[i] = 0;
+	}
+}
+
+
+TerrainClass::TerrainClass(const TerrainClass& other)
+{
+}
+
+
+TerrainClass::~TerrainClass()
+{
+}
+
+
+bool TerrainClass::Initialize(RenderDeviceClass* device, unsigned int seed)
+{
+	CpuZoneClass zone("InitializeTerrain");
+	bool result;
+	int i;
+
+
+	// Store the device the buffers are created on.
+	m_Device = device;
+
+	// Generate the heightmap and work out the height range and the geometric error of every node of the quadtree.
+	GenerateHeights(seed);
+
+	m_nodes.resize(TERRAIN_NODE_COUNT);
+	for(i=0; i<TERRAIN_NODE_COUNT; i++)
+	{
+		m_nodes[i].cacheSlot = -1;
+	}
+
+	ComputeNodeBounds();
+	ComputeNodeErrors();
+
+	// Create the index buffers every node shares, one for each combination of edges next to a coarser node.
+	result = InitializeIndexBuffers();
+	if(!result)
+	{
+		return false;
+	}
+
+	// Keep room for the selection so a frame does not allocate.
+	m_cellDepth.resize(TERRAIN_GRID * TERRAIN_GRID);
+	m_visibleNodes.reserve(TERRAIN_GRID * TERRAIN_GRID);
+	m_cache.reserve(TERRAIN_CACHE_SIZE);
+	m_vertices.resize((TERRAIN_CHUNK_QUADS + 1) * (TERRAIN_CHUNK_QUADS + 1));
+
+	return true;
+}
+
+
+void TerrainClass::Shutdown()
+{
+	unsigned int i;
+
+
+	// Release the vertex buffers of the cached nodes.
+	for(i=0; i<m_cache.size(); i++)
+	{
+		if(m_cache[i].vertexBuffer)
+		{
+			m_Device->ReleaseResource(m_cache[i].vertexBuffer);
+		}
+	}
+	m_cache.clear();
+
+	// Release the shared index buffers.
+	for(i=0; i<TERRAIN_STITCH_COUNT; i++)
+	{
+		if(m_indexBuffers[i])
+		{
+			m_Device->ReleaseResource(m_indexBuffers[i]);
+			m_indexBuffers[i] = 0;
+		}
+		m_indexCounts[i] = 0;
+	}
+
+	m_heights.clear();
+	m_heights.shrink_to_fit();
+	m_nodes.clear();
+	m_visibleNodes.clear();
+
+	return;
+}
+
+
+bool TerrainClass::Update(CameraClass* camera, const XMMATRIX& projectionMatrix, int screenHeight)
+{
+	CpuZoneClass zone("SelectTerrain");
+	XMFLOAT4X4 projection;
+	XMFLOAT3 position;
+	float projectionScale;
+	int budget, excess, attempt, slot;
+	unsigned int i;
+
+
+	m_frame++;
+
+	// An error of one unit at a distance of one unit covers this many pixels.
+	XMStoreFloat4x4(&projection, projectionMatrix);
+	projectionScale = 0.5f * (float)screenHeight * projection._22;
+	position = camera->GetPosition();
+
+	// Split the nodes with the largest error first until the budget is spent, then keep the neighbours within one level.
+	// Keeping them in step splits more nodes, so a selection over the budget is done again with a budget smaller by
+	// the difference.
+	budget = TERRAIN_MAX_NODES;
+	for(attempt=0; attempt<TERRAIN_SELECT_ATTEMPTS; attempt++)
+	{
+		Select(camera, position, projectionScale, budget);
+		Balance();
+		CollectVisibleNodes(camera);
+
+		excess = (int)m_visibleNodes.size() - TERRAIN_MAX_NODES;
+		if(excess <= 0)
+		{
+			break;
+		}
+
+		budget = max(1, budget - excess);
+	}
+
+	// Make sure every visible node has its vertex buffer.
+	for(i=0; i<m_visibleNodes.size(); i++)
+	{
+		slot = m_nodes[m_visibleNodes[i].node].cacheSlot;
+		if(slot < 0)
+		{
+			slot = AcquireCacheSlot(m_visibleNodes[i].node);
+
+			m_cache[slot].vertexBuffer = BuildNodeMesh(m_visibleNodes[i].depth, m_visibleNodes[i].x, m_visibleNodes[i].y);
+			if(!m_cache[slot].vertexBuffer)
+			{
+				return false;
+			}
+		}
+
+		m_cache[slot].lastFrame = m_frame;
+	}
+
+	return true;
+}
+
+
+int TerrainClass::GetVisibleNodeCount()
+{
+	return (int)m_visibleNodes.size();
+}
+
+
+int TerrainClass::GetVisibleTriangleCount()
+{
+	int count;
+	unsigned int i;
+
+
+	count = 0;
+	for(i=0; i<m_visibleNodes.size(); i++)
+	{
+		count += m_indexCounts[m_visibleNodes[i].stitch] / 3;
+	}
+
+	return count;
+}
+
+
+int TerrainClass::RenderNode(int index)
+{
+	const VisibleNodeType& node = m_visibleNodes[index];
+
+
+	// Put the vertex buffer of the node and the index buffer for its edges on the pipeline.
+	m_Device->SetVertexBuffer(m_cache[m_nodes[node.node].cacheSlot].vertexBuffer, sizeof(VertexType));
+	m_Device->SetIndexBuffer(m_indexBuffers[node.stitch]);
+
+	return m_indexCounts[node.stitch];
+}
+
+
+float TerrainClass::GetHeight(float positionX, float positionZ)
+{
+	float sampleX, sampleZ, fractionX, fractionZ, top, bottom;
+	int x, z;
+
+
+	// Find the samples around the position and blend between them.
+	sampleX = positionX / TERRAIN_SPACING + (float)(TERRAIN_SIZE - 1) * 0.5f;
+	sampleZ = positionZ / TERRAIN_SPACING + (float)(TERRAIN_SIZE - 1) * 0.5f;
+	sampleX = max(0.0f, min(sampleX, (float)(TERRAIN_SIZE - 1)));
+	sampleZ = max(0.0f, min(sampleZ, (float)(TERRAIN_SIZE - 1)));
+
+	x = min((int)sampleX, TERRAIN_SIZE - 2);
+	z = min((int)sampleZ, TERRAIN_SIZE - 2);
+	fractionX = sampleX - (float)x;
+	fractionZ = sampleZ - (float)z;
+
+	bottom = GetSample(x, z) + (GetSample(x + 1, z) - GetSample(x, z)) * fractionX;
+	top = GetSample(x, z + 1) + (GetSample(x + 1, z + 1) - GetSample(x, z + 1)) * fractionX;
+
+	return bottom + (top - bottom) * fractionZ;
+}
+
+
+void TerrainClass::GenerateHeights(unsigned int seed)
+{
+	float positionX, positionZ, frequency, amplitude, total, noise, distance, blend;
+	int x, z, i;
+
+
+	m_heights.resize(TERRAIN_SIZE * TERRAIN_SIZE);
+
+	for(z=0; z<TERRAIN_SIZE; z++)
+	{
+		for(x=0; x<TERRAIN_SIZE; x++)
+		{
+			// Add up the octaves of value noise, each at twice the frequency and half the amplitude of the one before.
+			noise = 0.0f;
+			total = 0.0f;
+			frequency = 1.0f / 256.0f;
+			amplitude = 1.0f;
+			for(i=0; i<TERRAIN_OCTAVES; i++)
+			{
+				noise += SmoothNoise((float)x * frequency, (float)z * frequency, seed + i) * amplitude;
+				total += amplitude;
+				frequency *= 2.0f;
+				amplitude *= 0.5f;
+			}
+
+			// Square the noise so the valleys are wide and the peaks narrow.
+			noise /= total;
+			noise *= noise;
+
+			// Fade the heights out towards the flat ground around the origin.
+			positionX = GetWorldCoordinate(x);
+			positionZ = GetWorldCoordinate(z);
+			distance = sqrtf(positionX * positionX + positionZ * positionZ);
+			blend = max(0.0f, min((distance - TERRAIN_FLAT_RADIUS) / (TERRAIN_BLEND_RADIUS - TERRAIN_FLAT_RADIUS), 1.0f));
+			blend = blend * blend * (3.0f - 2.0f * blend);
+
+			m_heights[z * TERRAIN_SIZE + x] = noise * TERRAIN_HEIGHT * blend;
+		}
+	}
+
+	return;
+}
+
+
+void TerrainClass::ComputeNodeBounds()
+{
+	NodeType* node;
+	NodeType* child;
+	float height;
+	int depth, count, size, x, y, i, j, k;
+
+
+	// The leaves take the height range of their samples, edges included.
+	size = TERRAIN_CHUNK_QUADS;
+	for(y=0; y<TERRAIN_GRID; y++)
+	{
+		for(x=0; x<TERRAIN_GRID; x++)
+		{
+			node = &m_nodes[GetNodeIndex(TERRAIN_DEPTH, x, y)];
+			node->minHeight = FLT_MAX;
+			node->maxHeight = -FLT_MAX;
+
+			for(j=0; j<=size; j++)
+			{
+				for(i=0; i<=size; i++)
+				{
+					height = GetSample(x * size + i, y * size + j);
+					node->minHeight = min(node->minHeight, height);
+					node->maxHeight = max(node->maxHeight, height);
+				}
+			}
+		}
+	}
+
+	// Every other node takes the range of its four children.
+	for(depth=TERRAIN_DEPTH-1; depth>=0; depth--)
+	{
+		count = 1 << depth;
+		for(y=0; y<count; y++)
+		{
+			for(x=0; x<count; x++)
+			{
+				node = &m_nodes[GetNodeIndex(depth, x, y)];
+				node->minHeight = FLT_MAX;
+				node->maxHeight = -FLT_MAX;
+
+				for(k=0; k<4; k++)
+				{
+					child = &m_nodes[GetNodeIndex(depth + 1, x * 2 + (k & 1), y * 2 + (k >> 1))];
+					node->minHeight = min(node->minHeight, child->minHeight);
+					node->maxHeight = max(node->maxHeight, child->maxHeight);
+				}
+			}
+		}
+	}
+
+	return;
+}
+
+
+void TerrainClass::ComputeNodeErrors()
+{
+	NodeType* node;
+	float fractionX, fractionZ, heightA, heightB, heightC, heightD, height, error;
+	int depth, count, size, stride, x, y, i, j, k, cellX, cellZ, originX, originZ;
+
+
+	// The leaves are drawn at the full resolution of the heightmap.
+	for(i=GetNodeIndex(TERRAIN_DEPTH, 0, 0); i<TERRAIN_NODE_COUNT; i++)
+	{
+		m_nodes[i].error = 0.0f;
+	}
+
+	// The error of a coarser node is the furthest any sample under it is from the triangles the node draws there.
+	for(depth=TERRAIN_DEPTH-1; depth>=0; depth--)
+	{
+		count = 1 << depth;
+		size = (TERRAIN_SIZE - 1) >> depth;
+		stride = size / TERRAIN_CHUNK_QUADS;
+
+		for(y=0; y<count; y++)
+		{
+			for(x=0; x<count; x++)
+			{
+				originX = x * size;
+				originZ = y * size;
+				error = 0.0f;
+
+				for(j=0; j<=size; j++)
+				{
+					cellZ = min(j / stride, TERRAIN_CHUNK_QUADS - 1);
+					fractionZ = (float)(j - cellZ * stride) / (float)stride;
+
+					for(i=0; i<=size; i++)
+					{
+						cellX = min(i / stride, TERRAIN_CHUNK_QUADS - 1);
+						fractionX = (float)(i - cellX * stride) / (float)stride;
+
+						// Interpolate over the same triangle of the quad the index buffers use.
+						heightA = GetSample(originX + cellX * stride, originZ + cellZ * stride);
+						heightB = GetSample(originX + (cellX + 1) * stride, originZ + cellZ * stride);
+						heightC = GetSample(originX + cellX * stride, originZ + (cellZ + 1) * stride);
+						heightD = GetSample(originX + (cellX + 1) * stride, originZ + (cellZ + 1) * stride);
+
+						if(fractionZ >= fractionX)
+						{
+							height = heightA + (heightD - heightC) * fractionX + (heightC - heightA) * fractionZ;
+						}
+						else
+						{
+							height = heightA + (heightB - heightA) * fractionX + (heightD - heightB) * fractionZ;
+						}
+
+						error = max(error, fabsf(GetSample(originX + i, originZ + j) - height));
+					}
+				}
+
+				// A node is never more accurate than its children.
+				node = &m_nodes[GetNodeIndex(depth, x, y)];
+				node->error = error;
+				for(k=0; k<4; k++)
+				{
+					node->error = max(node->error, m_nodes[GetNodeIndex(depth + 1, x * 2 + (k & 1), y * 2 + (k >> 1))].error);
+				}
+			}
+		}
+	}
+
+	return;
+}
+
+
+bool TerrainClass::InitializeIndexBuffers()
+{
+	vector<unsigned int> indices;
+	unsigned int corners[6], triangle[3];
+	int stitch, i, j, k, vertexX, vertexZ;
+
+
+	indices.reserve(TERRAIN_CHUNK_QUADS * TERRAIN_CHUNK_QUADS * 6);
+
+	// Bit 0 to 3 of the stitch are the -x, +x, -z and +z edges that border a coarser node.
+	for(stitch=0; stitch<TERRAIN_STITCH_COUNT; stitch++)
+	{
+		indices.clear();
+
+		for(j=0; j<TERRAIN_CHUNK_QUADS; j++)
+		{
+			for(i=0; i<TERRAIN_CHUNK_QUADS; i++)
+			{
+				// Split every quad along the same diagonal into two clockwise triangles.
+				corners[0] = (j * (TERRAIN_CHUNK_QUADS + 1) + i);
+				corners[1] = ((j + 1) * (TERRAIN_CHUNK_QUADS + 1) + i);
+				corners[2] = ((j + 1) * (TERRAIN_CHUNK_QUADS + 1) + i + 1);
+				corners[3] = corners[0];
+				corners[4] = corners[2];
+				corners[5] = (j * (TERRAIN_CHUNK_QUADS + 1) + i + 1);
+
+				for(k=0; k<6; k++)
+				{
+					// Snap an odd vertex on a stitched edge onto the even one before it, the edge then runs straight
+					// between the vertices the coarser neighbour has.
+					vertexX = corners[k] % (TERRAIN_CHUNK_QUADS + 1);
+					vertexZ = corners[k] / (TERRAIN_CHUNK_QUADS + 1);
+
+					if((((stitch & 1) && vertexX == 0) || ((stitch & 2) && vertexX == TERRAIN_CHUNK_QUADS)) && (vertexZ & 1))
+					{
+						vertexZ--;
+					}
+					if((((stitch & 4) && vertexZ == 0) || ((stitch & 8) && vertexZ == TERRAIN_CHUNK_QUADS)) && (vertexX & 1))
+					{
+						vertexX--;
+					}
+
+					triangle[k % 3] = vertexZ * (TERRAIN_CHUNK_QUADS + 1) + vertexX;
+
+					// Drop the triangles the snapping collapsed.
+					if(k % 3 == 2 && triangle[0] != triangle[1] && triangle[1] != triangle[2] && triangle[0] != triangle[2])
+					{
+						indices.insert(indices.end(), triangle, triangle + 3);
+					}
+				}
+			}
+		}
+
+		m_indexCounts[stitch] = (int)indices.size();
+		m_indexBuffers[stitch] = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_INDEX_BUFFER, &indices[0],
+														  sizeof(unsigned int) * m_indexCounts[stitch]);
+		if(!m_indexBuffers[stitch])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+void TerrainClass::Select(CameraClass* camera, const XMFLOAT3& position, float projectionScale, int budget)
+{
+	float error;
+	int leafCount, depth, x, y, k, childX, childY;
+
+
+	// Start from the root covering everything.
+	fill(m_cellDepth.begin(), m_cellDepth.end(), (unsigned char)0);
+	m_splits = priority_queue<SplitType>();
+
+	leafCount = 0;
+	if(IsNodeVisible(camera, 0, 0, 0))
+	{
+		m_splits.push(SplitType(GetScreenError(0, 0, 0, position, projectionScale), 0));
+		leafCount = 1;
+	}
+
+	// Split the visible node that shows the most error until the error is small enough everywhere or the budget is spent,
+	// the nodes out of view stay as coarse as they are.
+	while(!m_splits.empty())
+	{
+		if(m_splits.top().first <= TERRAIN_PIXEL_ERROR || leafCount + 3 > budget)
+		{
+			break;
+		}
+
+		GetNodeCoordinates(m_splits.top().second, depth, x, y);
+		m_splits.pop();
+
+		if(depth == TERRAIN_DEPTH)
+		{
+			continue;
+		}
+
+		SplitLeaf(depth, x, y);
+		leafCount--;
+
+		for(k=0; k<4; k++)
+		{
+			childX = x * 2 + (k & 1);
+			childY = y * 2 + (k >> 1);
+			if(IsNodeVisible(camera, depth + 1, childX, childY))
+			{
+				error = GetScreenError(depth + 1, childX, childY, position, projectionScale);
+				m_splits.push(SplitType(error, GetNodeIndex(depth + 1, childX, childY)));
+				leafCount++;
+			}
+		}
+	}
+
+	return;
+}
+
+
+void TerrainClass::Balance()
+{
+	const int offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+	bool changed;
+	int cellX, cellY, neighbourX, neighbourY, depth, neighbourDepth, k;
+
+
+	// Split any leaf more than one level coarser than a neighbour until none is left, the leaves are read from the depth
+	// of the finest cells they cover.
+	do
+	{
+		changed = false;
+
+		for(cellY=0; cellY<TERRAIN_GRID; cellY++)
+		{
+			for(cellX=0; cellX<TERRAIN_GRID; cellX++)
+			{
+				depth = m_cellDepth[cellY * TERRAIN_GRID + cellX];
+				if(depth < 2)
+				{
+					continue;
+				}
+
+				for(k=0; k<4; k++)
+				{
+					neighbourX = cellX + offsets[k][0];
+					neighbourY = cellY + offsets[k][1];
+					if(neighbourX < 0 || neighbourX >= TERRAIN_GRID || neighbourY < 0 || neighbourY >= TERRAIN_GRID)
+					{
+						continue;
+					}
+
+					neighbourDepth = m_cellDepth[neighbourY * TERRAIN_GRID + neighbourX];
+					if(neighbourDepth < depth - 1)
+					{
+						SplitLeaf(neighbourDepth, neighbourX >> (TERRAIN_DEPTH - neighbourDepth), neighbourY >> (TERRAIN_DEPTH - neighbourDepth));
+						changed = true;
+					}
+				}
+			}
+		}
+	}
+	while(changed);
+
+	return;
+}
+
+
+void TerrainClass::CollectVisibleNodes(CameraClass* camera)
+{
+	VisibleNodeType node;
+	int cellX, cellY, size;
+
+
+	m_visibleNodes.clear();
+
+	// Every leaf starts at the cell in its corner.
+	for(cellY=0; cellY<TERRAIN_GRID; cellY++)
+	{
+		for(cellX=0; cellX<TERRAIN_GRID; cellX++)
+		{
+			node.depth = m_cellDepth[cellY * TERRAIN_GRID + cellX];
+			size = 1 << (TERRAIN_DEPTH - node.depth);
+			if((cellX % size) != 0 || (cellY % size) != 0)
+			{
+				continue;
+			}
+
+			node.x = cellX / size;
+			node.y = cellY / size;
+			if(!IsNodeVisible(camera, node.depth, node.x, node.y))
+			{
+				continue;
+			}
+
+			// Stitch the edges that border a coarser leaf, after the balancing it is exactly one level coarser along the
+			// whole edge.
+			node.node = GetNodeIndex(node.depth, node.x, node.y);
+			node.stitch = 0;
+			if(cellX > 0 && m_cellDepth[cellY * TERRAIN_GRID + cellX - 1] < node.depth)
+			{
+				node.stitch |= 1;
+			}
+			if(cellX + size < TERRAIN_GRID && m_cellDepth[cellY * TERRAIN_GRID + cellX + size] < node.depth)
+			{
+				node.stitch |= 2;
+			}
+			if(cellY > 0 && m_cellDepth[(cellY - 1) * TERRAIN_GRID + cellX] < node.depth)
+			{
+				node.stitch |= 4;
+			}
+			if(cellY + size < TERRAIN_GRID && m_cellDepth[(cellY + size) * TERRAIN_GRID + cellX] < node.depth)
+			{
+				node.stitch |= 8;
+			}
+
+			m_visibleNodes.push_back(node);
+		}
+	}
+
+	return;
+}
+
+
+void TerrainClass::SplitLeaf(int depth, int x, int y)
+{
+	int size, cellX, cellY;
+
+
+	// The four children of the leaf take over its cells.
+	size = 1 << (TERRAIN_DEPTH - depth);
+	for(cellY=y*size; cellY<(y+1)*size; cellY++)
+	{
+		for(cellX=x*size; cellX<(x+1)*size; cellX++)
+		{
+			m_cellDepth[cellY * TERRAIN_GRID + cellX] = (unsigned char)(depth + 1);
+		}
+	}
+
+	return;
+}
+
+
+bool TerrainClass::IsNodeVisible(CameraClass* camera, int depth, int x, int y)
+{
+	const NodeType& node = m_nodes[GetNodeIndex(depth, x, y)];
+	XMFLOAT3 center, extents;
+	int size;
+
+
+	// Test the box around the samples of the node against the view frustum.
+	size = (TERRAIN_SIZE - 1) >> depth;
+	extents.x = (float)size * TERRAIN_SPACING * 0.5f;
+	extents.y = (node.maxHeight - node.minHeight) * 0.5f;
+	extents.z = extents.x;
+	center.x = GetWorldCoordinate(x * size) + extents.x;
+	center.y = (node.maxHeight + node.minHeight) * 0.5f;
+	center.z = GetWorldCoordinate(y * size) + extents.z;
+
+	return camera->CheckBox(center, extents);
+}
+
+
+float TerrainClass::GetScreenError(int depth, int x, int y, const XMFLOAT3& position, float projectionScale)
+{
+	const NodeType& node = m_nodes[GetNodeIndex(depth, x, y)];
+	float minX, maxX, minZ, maxZ, distanceX, distanceY, distanceZ, distance;
+	int size;
+
+
+	// Measure from the viewer to the nearest point of the box around the node.
+	size = (TERRAIN_SIZE - 1) >> depth;
+	minX = GetWorldCoordinate(x * size);
+	maxX = GetWorldCoordinate((x + 1) * size);
+	minZ = GetWorldCoordinate(y * size);
+	maxZ = GetWorldCoordinate((y + 1) * size);
+
+	distanceX = max(0.0f, max(minX - position.x, position.x - maxX));
+	distanceY = max(0.0f, max(node.minHeight - position.y, position.y - node.maxHeight));
+	distanceZ = max(0.0f, max(minZ - position.z, position.z - maxZ));
+	distance = max(sqrtf(distanceX * distanceX + distanceY * distanceY + distanceZ * distanceZ), TERRAIN_SPACING);
+
+	// Project the geometric error of the node onto the screen at that distance.
+	return node.error * projectionScale / distance;
+}
+
+
+int TerrainClass::AcquireCacheSlot(int node)
+{
+	int slot;
+	unsigned int i;
+
+
+	// Take the node drawn the longest time ago once the cache is full, a node drawn this frame is never taken so the
+	// cache grows past its size rather than drop a visible node.
+	slot = -1;
+	if((int)m_cache.size() >= TERRAIN_CACHE_SIZE)
+	{
+		for(i=0; i<m_cache.size(); i++)
+		{
+			if(m_cache[i].lastFrame != m_frame && (slot < 0 || m_cache[i].lastFrame < m_cache[slot].lastFrame))
+			{
+				slot = (int)i;
+			}
+		}
+	}
+
+	if(slot < 0)
+	{
+		m_cache.push_back(CacheEntryType());
+		slot = (int)m_cache.size() - 1;
+	}
+	else
+	{
+		// Release the mesh of the node the slot held.
+		m_nodes[m_cache[slot].node].cacheSlot = -1;
+		m_Device->ReleaseResource(m_cache[slot].vertexBuffer);
+	}
+
+	m_cache[slot].node = node;
+	m_cache[slot].vertexBuffer = 0;
+	m_cache[slot].lastFrame = m_frame;
+	m_nodes[node].cacheSlot = slot;
+
+	return slot;
+}
+
+
+int TerrainClass::BuildNodeMesh(int depth, int x, int y)
+{
+	VertexType* vertex;
+	float slopeX, slopeZ, length;
+	int size, stride, sampleX, sampleZ, i, j;
+
+
+	size = (TERRAIN_SIZE - 1) >> depth;
+	stride = size / TERRAIN_CHUNK_QUADS;
+
+	for(j=0; j<=TERRAIN_CHUNK_QUADS; j++)
+	{
+		for(i=0; i<=TERRAIN_CHUNK_QUADS; i++)
+		{
+			vertex = &m_vertices[j * (TERRAIN_CHUNK_QUADS + 1) + i];
+			sampleX = x * size + i * stride;
+			sampleZ = y * size + j * stride;
+
+			vertex->position = XMFLOAT3(GetWorldCoordinate(sampleX), GetSample(sampleX, sampleZ), GetWorldCoordinate(sampleZ));
+			vertex->texture = XMFLOAT2(vertex->position.x / TERRAIN_TEXTURE_REPEAT, vertex->position.z / TERRAIN_TEXTURE_REPEAT);
+
+			// Take the normal from the slope of the full resolution heightmap, so a coarse node is lit like the finer
+			// ones that replace it.
+			slopeX = (GetSample(min(sampleX + 1, TERRAIN_SIZE - 1), sampleZ) - GetSample(max(sampleX - 1, 0), sampleZ)) /
+					 ((float)(min(sampleX + 1, TERRAIN_SIZE - 1) - max(sampleX - 1, 0)) * TERRAIN_SPACING);
+			slopeZ = (GetSample(sampleX, min(sampleZ + 1, TERRAIN_SIZE - 1)) - GetSample(sampleX, max(sampleZ - 1, 0))) /
+					 ((float)(min(sampleZ + 1, TERRAIN_SIZE - 1) - max(sampleZ - 1, 0)) * TERRAIN_SPACING);
+
+			length = sqrtf(slopeX * slopeX + 1.0f + slopeZ * slopeZ);
+			vertex->normal = XMFLOAT3(-slopeX / length, 1.0f / length, -slopeZ / length);
+		}
+	}
+
+	return m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_VERTEX_BUFFER, &m_vertices[0], sizeof(VertexType) * (int)m_vertices.size());
+}
+
+
+int TerrainClass::GetNodeIndex(int depth, int x, int y)
+{
+	// The levels are stored one after the other, row by row.
+	return ((1 << (2 * depth)) - 1) / 3 + y * (1 << depth) + x;
+}
+
+
+void TerrainClass::GetNodeCoordinates(int index, int& depth, int& x, int& y)
+{
+	int offset;
+
+
+	// Find the level the index falls in.
+	depth = 0;
+	while(depth < TERRAIN_DEPTH && index >= ((1 << (2 * (depth + 1))) - 1) / 3)
+	{
+		depth++;
+	}
+
+	offset = index - ((1 << (2 * depth)) - 1) / 3;
+	x = offset % (1 << depth);
+	y = offset / (1 << depth);
+
+	return;
+}
+
+
+float TerrainClass::GetSample(int x, int z)
+{
+	return m_heights[z * TERRAIN_SIZE + x];
+}
+
+
+float TerrainClass::GetWorldCoordinate(int sample)
+{
+	// The heightmap is centred on the origin.
+	return ((float)sample - (float)(TERRAIN_SIZE - 1) * 0.5f) * TERRAIN_SPACING;
+}
+
+
+float TerrainClass::Noise(int x, int y, unsigned int seed)
+{
+	unsigned int hash;
+
+
+	// Hash the lattice point into a value from 0 to 1.
+	hash = (unsigned int)x * 374761393u + (unsigned int)y * 668265263u + seed * 2246822519u;
+	hash = (hash ^ (hash >> 13)) * 1274126177u;
+	hash ^= hash >> 16;
+
+	return (float)(hash & 0xffffff) / 16777216.0f;
+}
+
+
+float TerrainClass::SmoothNoise(float x, float y, unsigned int seed)
+{
+	float fractionX, fractionY, bottom, top;
+	int cellX, cellY;
+
+
+	// Blend the lattice values around the point with a smooth curve so the noise has no creases.
+	cellX = (int)floorf(x);
+	cellY = (int)floorf(y);
+	fractionX = x - (float)cellX;
+	fractionY = y - (float)cellY;
+	fractionX = fractionX * fractionX * (3.0f - 2.0f * fractionX);
+	fractionY = fractionY * fractionY * (3.0f - 2.0f * fractionY);
+
+	bottom = Noise(cellX, cellY, seed) + (Noise(cellX + 1, cellY, seed) - Noise(cellX, cellY, seed)) * fractionX;
+	top = Noise(cellX, cellY + 1, seed) + (Noise(cellX + 1, cellY + 1, seed) - Noise(cellX, cellY + 1, seed)) * fractionX;
+
+	return bottom + (top - bottom) * fractionY;
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: terrainclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _TERRAINCLASS_H_
+#define _TERRAINCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <queue>
+#include <vector>
+#include <DirectXMath.h>
+using namespace DirectX;
+using namespace std;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+#include "cameraclass.h"
+#include "cpuprofilerclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int TERRAIN_CHUNK_QUADS = 32;
+const int TERRAIN_DEPTH = 6;
+const int TERRAIN_GRID = 1 << TERRAIN_DEPTH;
+const int TERRAIN_SIZE = TERRAIN_CHUNK_QUADS * TERRAIN_GRID + 1;
+const int TERRAIN_NODE_COUNT = ((1 << (2 * (TERRAIN_DEPTH + 1))) - 1) / 3;
+const int TERRAIN_STITCH_COUNT = 16;
+const float TERRAIN_SPACING = 4.0f;
+const float TERRAIN_HEIGHT = 600.0f;
+const float TERRAIN_FLAT_RADIUS = 800.0f;
+const float TERRAIN_BLEND_RADIUS = 2500.0f;
+const float TERRAIN_TEXTURE_REPEAT = 128.0f;
+const int TERRAIN_OCTAVES = 7;
+const unsigned int TERRAIN_SEED = 1337;
+const float TERRAIN_PIXEL_ERROR = 2.0f;
+const int TERRAIN_MAX_NODES = 384;
+const int TERRAIN_CACHE_SIZE = 768;
+const int TERRAIN_SELECT_ATTEMPTS = 4;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: TerrainClass
+//
+// A heightmap terrain drawn as a quadtree of chunks.  Every node of the tree is a grid of the same number of quads over
+// its part of the heightmap, so a node one level up covers four times the ground at half the sample density and all the
+// nodes share one set of index buffers.  Each frame the visible nodes whose geometric error would show as more than a
+// couple of pixels are split, largest error first, until the node budget runs out, so the triangle count stays bounded
+// whatever the size of the heightmap.  Neighbouring nodes are then kept within one level of each other and a node next
+// to a coarser one snaps the odd vertices of that edge onto the even ones, which closes the cracks.  The vertex buffers
+// of the nodes are built the first time a node is drawn and kept in a cache that drops the least recently drawn node.
+// The heightmap is generated from noise and flattened around the origin for the airfield.
+////////////////////////////////////////////////////////////////////////////////
+class TerrainClass
+{
+private:
+	struct VertexType
+	{
+		XMFLOAT3 position;
+		XMFLOAT2 texture;
+		XMFLOAT3 normal;
+	};
+
+	struct NodeType
+	{
+		float minHeight, maxHeight;
+		float error;
+		int cacheSlot;
+	};
+
+	struct CacheEntryType
+	{
+		int node;
+		int vertexBuffer;
+		unsigned int lastFrame;
+	};
+
+	struct VisibleNodeType
+	{
+		int node;
+		int depth, x, y;
+		int stitch;
+	};
+
+	typedef pair<float, int> SplitType;
+
+public:
+	TerrainClass();
+	TerrainClass(const TerrainClass&);
+	~TerrainClass();
+
+	bool Initialize(RenderDeviceClass*, unsigned int);
+	void Shutdown();
+	bool Update(CameraClass*, const XMMATRIX&, int);
+
+	int GetVisibleNodeCount();
+	int GetVisibleTriangleCount();
+	int RenderNode(int);
+	float GetHeight(float, float);
+
+private:
+	void GenerateHeights(unsigned int);
+	void ComputeNodeBounds();
+	void ComputeNodeErrors();
+	bool InitializeIndexBuffers();
+
+	void Select(CameraClass*, const XMFLOAT3&, float, int);
+	void Balance();
+	void CollectVisibleNodes(CameraClass*);
+	void SplitLeaf(int, int, int);
+	bool IsNodeVisible(CameraClass*, int, int, int);
+	float GetScreenError(int, int, int, const XMFLOAT3&, float);
+
+	int AcquireCacheSlot(int);
+	int BuildNodeMesh(int, int, int);
+
+	int GetNodeIndex(int, int, int);
+	void GetNodeCoordinates(int, int&, int&, int&);
+	float GetSample(int, int);
+	float GetWorldCoordinate(int);
+	static float Noise(int, int, unsigned int);
+	static float SmoothNoise(float, float, unsigned int);
+
+private:
+	RenderDeviceClass* m_Device;
+	vector<float> m_heights;
+	vector<NodeType> m_nodes;
+	vector<unsigned char> m_cellDepth;
+	vector<CacheEntryType> m_cache;
+	vector<VisibleNodeType> m_visibleNodes;
+	vector<VertexType> m_vertices;
+	priority_queue<SplitType> m_splits;
+	int m_indexBuffers[TERRAIN_STITCH_COUNT];
+	int m_indexCounts[TERRAIN_STITCH_COUNT];
+	unsigned int m_frame;
+};
+
+#endif
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 TextureClass::TextureClass()
 {
+	m_Device = 0;
 	m_texture = 0;
 }
 
@@ -20,15 +21,14 @@ TextureClass::~TextureClass()
 }
 
 
-bool TextureClass::Initialize(ID3D11Device* device, WCHAR* filename)
+bool TextureClass::Initialize(RenderDeviceClass* device, const wchar_t* filename)
 {
-	HRESULT result;
-
+	// Store the device the texture is created on so it can be released there.
+	m_Device = device;
 
 	// Load the texture in.
-	result = CreateDDSTextureFromFile(device, filename, NULL, &m_texture, NULL);
-
-	if(FAILED(result))
+	m_texture = m_Device->CreateTexture(filename);
+	if(!m_texture)
 	{
 		return false;
 	}
@@ -42,7 +42,7 @@ void TextureClass::Shutdown()
 	// Release the texture resource.
 	if(m_texture)
 	{
-		m_texture->Release();
+		m_Device->ReleaseResource(m_texture);
 		m_texture = 0;
 	}
 
@@ -50,7 +50,7 @@ void TextureClass::Shutdown()
 }
 
 
-ID3D11ShaderResourceView* TextureClass::GetTexture()
+int TextureClass::GetTexture()
 {
 	return m_texture;
 }
\ No newline at end of file
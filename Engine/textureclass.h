@@ -5,13 +5,10 @@
 #define _TEXTURECLASS_H_
 
 
-//////////////
-// INCLUDES //
-//////////////
-#include <d3d11_1.h>
-#include "DDSTextureLoader.h"
-
-using namespace DirectX;
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -24,13 +21,14 @@ public:
 	TextureClass(const TextureClass&);
 	~TextureClass();
 
-	bool Initialize(ID3D11Device*, WCHAR*);
+	bool Initialize(RenderDeviceClass*, const wchar_t*);
 	void Shutdown();
 
-	ID3D11ShaderResourceView* GetTexture();
+	int GetTexture();
 
 private:
-	ID3D11ShaderResourceView* m_texture;
+	RenderDeviceClass* m_Device;
+	int m_texture;
 };
 
 #endif
\ No newline at end of file
@@ -8,13 +8,14 @@
 //////////////
 // INCLUDES //
 //////////////
-#include <d3d11_1.h>
-#include <d3dcompiler.h>
 #include <DirectXMath.h>
 using namespace DirectX;
 
-#include <fstream>
-using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -35,24 +36,23 @@ public:
 	TextureShaderClass(const TextureShaderClass&);
 	~TextureShaderClass();
 
-	bool Initialize(ID3D11Device*, HWND);
+	bool Initialize(RenderDeviceClass*);
 	void Shutdown();
-	bool Render(ID3D11DeviceContext*, int, const XMMATRIX&, const XMMATRIX&, const XMMATRIX&, ID3D11ShaderResourceView*);
+	bool Render(int, const XMMATRIX&, const XMMATRIX&, const XMMATRIX&, int);
+
+	int GetPipeline();
 
 private:
-	bool InitializeShader(ID3D11Device*, HWND, WCHAR*, WCHAR*);
+	bool InitializeShader(const wchar_t*, const wchar_t*);
 	void ShutdownShader();
-	void OutputShaderErrorMessage(ID3D10Blob*, HWND, WCHAR*);
 
-	bool SetShaderParameters(ID3D11DeviceContext*, const XMMATRIX&, const XMMATRIX&, const XMMATRIX&, ID3D11ShaderResourceView*);
-	void RenderShader(ID3D11DeviceContext*, int);
+	bool SetShaderParameters(const XMMATRIX&, const XMMATRIX&, const XMMATRIX&, int);
+	void RenderShader(int);
 
 private:
-	ID3D11VertexShader* m_vertexShader;
-	ID3D11PixelShader* m_pixelShader;
-	ID3D11InputLayout* m_layout;
-	ID3D11Buffer* m_matrixBuffer;
-	ID3D11SamplerState* m_sampleState;
+	RenderDeviceClass* m_Device;
+	int m_pipeline;
+	int m_matrixBuffer;
 };
 
 #endif
\ No newline at end of file
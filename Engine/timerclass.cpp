@@ -6,6 +6,7 @@
 
 TimerClass::TimerClass()
 {
+	m_frameTime = 0.0;
 }
 
 
@@ -21,17 +22,9 @@ TimerClass::~TimerClass()
 
 bool TimerClass::Initialize()
 {
-	// Check to see if this system supports high performance timers.
-	QueryPerformanceFrequency((LARGE_INTEGER*)&m_frequency);
-	if(m_frequency == 0)
-	{
-		return false;
-	}
-
-	// Find out how many times the frequency counter ticks every millisecond.
-	m_ticksPerMs = (float)(m_frequency / 1000);
-
-	QueryPerformanceCounter((LARGE_INTEGER*)&m_startTime);
+	// Start timing from now.
+	m_startTime = chrono::steady_clock::now();
+	m_frameTime = 0.0;
 
 	return true;
 }
@@ -39,18 +32,14 @@ bool TimerClass::Initialize()
 
 void TimerClass::Frame()
 {
-	INT64 currentTime;
-	float timeDifference;
+	chrono::steady_clock::time_point currentTime;
 
 
 	// Query the current time.
-	QueryPerformanceCounter((LARGE_INTEGER*)&currentTime);
+	currentTime = chrono::steady_clock::now();
 
-	// Calculate the difference in time since the last time we queried for the current time.
-	timeDifference = (float)(currentTime - m_startTime);
-
-	// Calculate the frame time by the time difference over the timer speed resolution.
-	m_frameTime = timeDifference / m_ticksPerMs;
+	// Calculate the frame time in milliseconds since the last time we queried for the current time.
+	m_frameTime = chrono::duration<double, milli>(currentTime - m_startTime).count();
 
 	// Restart the timer.
 	m_startTime = currentTime;
@@ -60,6 +49,12 @@ void TimerClass::Frame()
 
 
 float TimerClass::GetTime()
+{
+	return (float)m_frameTime;
+}
+
+
+double TimerClass::GetPreciseTime()
 {
 	return m_frameTime;
 }
\ No newline at end of file
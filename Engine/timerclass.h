@@ -8,11 +8,15 @@
 //////////////
 // INCLUDES //
 //////////////
-#include <windows.h>
+#include <chrono>
+using namespace std;
 
 
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: TimerClass
+//
+// Measures the time between frames with the steady clock in double precision, which is the performance counter on
+// Windows and works the same on the headless Linux runs.
 ////////////////////////////////////////////////////////////////////////////////
 class TimerClass
 {
@@ -25,12 +29,11 @@ public:
 	void Frame();
 
 	float GetTime();
+	double GetPreciseTime();
 
 private:
-	INT64 m_frequency;
-	float m_ticksPerMs;
-	INT64 m_startTime;
-	float m_frameTime;
+	chrono::steady_clock::time_point m_startTime;
+	double m_frameTime;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,315 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: transformclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "transformclass.h"
+
+
+TransformClass::TransformClass()
+{
+	m_maxNodes = 0;
+	m_nodeCount = 0;
+	m_parent = 0;
+	m_depth = 0;
+	m_positionX = 0;
+	m_positionY = 0;
+	m_positionZ = 0;
+	m_rotationX = 0;
+	m_rotationY = 0;
+	m_rotationZ = 0;
+	m_scale = 0;
+	m_dirty = 0;
+	m_changed = 0;
+	m_rebuild = 0;
+	m_local = 0;
+	m_world = 0;
+}
+
+
+TransformClass::TransformClass(const TransformClass& other)
+{
+}
+
+
+TransformClass::~TransformClass()
+{
+}
+
+
+bool TransformClass::Initialize(int maxNodes)
+{
+	// Store the capacity of the node arrays.
+	m_maxNodes = maxNodes;
+	m_nodeCount = 0;
+
+	// Create one flat array for each node attribute.
+	m_parent = new int[m_maxNodes];
+	m_depth = new int[m_maxNodes];
+	m_positionX = new float[m_maxNodes];
+	m_positionY = new float[m_maxNodes];
+	m_positionZ = new float[m_maxNodes];
+	m_rotationX = new float[m_maxNodes];
+	m_rotationY = new float[m_maxNodes];
+	m_rotationZ = new float[m_maxNodes];
+	m_scale = new float[m_maxNodes];
+	m_dirty = new unsigned char[m_maxNodes];
+	m_changed = new unsigned char[m_maxNodes];
+	m_rebuild = new int[m_maxNodes];
+	m_local = new XMFLOAT4X4[m_maxNodes];
+	m_world = new XMFLOAT4X4[m_maxNodes];
+	if(!m_parent || !m_depth || !m_positionX || !m_positionY || !m_positionZ || !m_rotationX || !m_rotationY || !m_rotationZ || !m_scale ||
+	   !m_dirty || !m_changed || !m_rebuild || !m_local || !m_world)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void TransformClass::Shutdown()
+{
+	// Release the node arrays.
+	delete [] m_world;
+	delete [] m_local;
+	delete [] m_rebuild;
+	delete [] m_changed;
+	delete [] m_dirty;
+	delete [] m_scale;
+	delete [] m_rotationZ;
+	delete [] m_rotationY;
+	delete [] m_rotationX;
+	delete [] m_positionZ;
+	delete [] m_positionY;
+	delete [] m_positionX;
+	delete [] m_depth;
+	delete [] m_parent;
+
+	m_world = 0;
+	m_local = 0;
+	m_rebuild = 0;
+	m_changed = 0;
+	m_dirty = 0;
+	m_scale = 0;
+	m_rotationZ = 0;
+	m_rotationY = 0;
+	m_rotationX = 0;
+	m_positionZ = 0;
+	m_positionY = 0;
+	m_positionX = 0;
+	m_depth = 0;
+	m_parent = 0;
+
+	m_maxNodes = 0;
+	m_nodeCount = 0;
+
+	return;
+}
+
+
+int TransformClass::AddNode(int parent)
+{
+	int index, depth;
+
+
+	// Check there is room for another node and that the parent already exists.
+	if((m_nodeCount >= m_maxNodes) || (parent >= m_nodeCount))
+	{
+		return -1;
+	}
+
+	// Nodes must be added one tree level at a time to keep the arrays breadth first.
+	depth = (parent < 0) ? 0 : m_depth[parent] + 1;
+	if((m_nodeCount > 0) && (depth < m_depth[m_nodeCount - 1]))
+	{
+		return -1;
+	}
+
+	index = m_nodeCount;
+	m_nodeCount++;
+
+	// Start the node as an identity transform that still needs its matrices built.
+	m_parent[index] = parent;
+	m_depth[index] = depth;
+	m_positionX[index] = 0.0f;
+	m_positionY[index] = 0.0f;
+	m_positionZ[index] = 0.0f;
+	m_rotationX[index] = 0.0f;
+	m_rotationY[index] = 0.0f;
+	m_rotationZ[index] = 0.0f;
+	m_scale[index] = 1.0f;
+	m_dirty[index] = 1;
+	m_changed[index] = 0;
+
+	return index;
+}
+
+
+void TransformClass::SetLocal(int index, float positionX, float positionY, float positionZ, float rotationX, float rotationY, float rotationZ,
+							  float scale)
+{
+	m_positionX[index] = positionX;
+	m_positionY[index] = positionY;
+	m_positionZ[index] = positionZ;
+	m_rotationX[index] = rotationX;
+	m_rotationY[index] = rotationY;
+	m_rotationZ[index] = rotationZ;
+	m_scale[index] = scale;
+	m_dirty[index] = 1;
+	return;
+}
+
+
+void TransformClass::SetLocalPosition(int index, float x, float y, float z)
+{
+	m_positionX[index] = x;
+	m_positionY[index] = y;
+	m_positionZ[index] = z;
+	m_dirty[index] = 1;
+	return;
+}
+
+
+void TransformClass::SetLocalRotation(int index, float x, float y, float z)
+{
+	m_rotationX[index] = x;
+	m_rotationY[index] = y;
+	m_rotationZ[index] = z;
+	m_dirty[index] = 1;
+	return;
+}
+
+
+int TransformClass::Update()
+{
+	XMMATRIX localMatrix, parentMatrix;
+	int i, parent, rebuildCount, updatedCount;
+
+
+	// Gather the nodes that were changed themselves, their local matrices do not depend on the tree so they are built
+	// four at a time in one batch before the hierarchy walk.
+	rebuildCount = 0;
+	for(i=0; i<m_nodeCount; i++)
+	{
+		if(m_dirty[i])
+		{
+			m_rebuild[rebuildCount] = i;
+			rebuildCount++;
+		}
+	}
+
+	for(i=0; i<rebuildCount; i+=4)
+	{
+		UpdateLocalMatrices(&m_rebuild[i], min(rebuildCount - i, 4));
+	}
+
+	updatedCount = 0;
+
+	// Walk the nodes in breadth first order.  A node is concatenated only if it was changed itself or its parent world
+	// matrix changed this update, so static branches keep their cached world matrices.
+	for(i=0; i<m_nodeCount; i++)
+	{
+		parent = m_parent[i];
+
+		if(!m_dirty[i] && ((parent < 0) || !m_changed[parent]))
+		{
+			m_changed[i] = 0;
+			continue;
+		}
+
+		m_dirty[i] = 0;
+
+		// Concatenate with the parent world matrix which is already up to date.
+		localMatrix = XMLoadFloat4x4(&m_local[i]);
+		if(parent >= 0)
+		{
+			parentMatrix = XMLoadFloat4x4(&m_world[parent]);
+			localMatrix = XMMatrixMultiply(localMatrix, parentMatrix);
+		}
+
+		XMStoreFloat4x4(&m_world[i], localMatrix);
+
+		m_changed[i] = 1;
+		updatedCount++;
+	}
+
+	return updatedCount;
+}
+
+
+int TransformClass::GetNodeCount()
+{
+	return m_nodeCount;
+}
+
+
+int TransformClass::GetParent(int index)
+{
+	return m_parent[index];
+}
+
+
+const XMFLOAT4X4* TransformClass::GetWorldMatrix(int index)
+{
+	return &m_world[index];
+}
+
+
+const XMFLOAT4X4* TransformClass::GetWorldMatrices()
+{
+	return m_world;
+}
+
+
+void TransformClass::UpdateLocalMatrices(const int* nodes, int count)
+{
+	XMVECTOR sinX, cosX, sinY, cosY, sinZ, cosZ, scale, sinXsinY, sinXcosY, zero;
+	XMMATRIX row0, row1, row2, row3, localMatrix;
+	int lane[4];
+	int i;
+
+
+	// Pad a short group by repeating its last node, the spare lanes compute a matrix that is never stored.
+	for(i=0; i<4; i++)
+	{
+		lane[i] = nodes[(i < count) ? i : (count - 1)];
+	}
+
+	// Load the same attribute of the four nodes into the lanes of one vector and take all the sines and cosines at once.
+	XMVectorSinCos(&sinX, &cosX, XMVectorSet(m_rotationX[lane[0]], m_rotationX[lane[1]], m_rotationX[lane[2]], m_rotationX[lane[3]]));
+	XMVectorSinCos(&sinY, &cosY, XMVectorSet(m_rotationY[lane[0]], m_rotationY[lane[1]], m_rotationY[lane[2]], m_rotationY[lane[3]]));
+	XMVectorSinCos(&sinZ, &cosZ, XMVectorSet(m_rotationZ[lane[0]], m_rotationZ[lane[1]], m_rotationZ[lane[2]], m_rotationZ[lane[3]]));
+	scale = XMVectorSet(m_scale[lane[0]], m_scale[lane[1]], m_scale[lane[2]], m_scale[lane[3]]);
+
+	sinXsinY = XMVectorMultiply(sinX, sinY);
+	sinXcosY = XMVectorMultiply(sinX, cosY);
+	zero = XMVectorZero();
+
+	// Build the uniform scale times the roll, pitch, yaw rotation (z, then x, then y for row vectors, the same rotation
+	// XMQuaternionRotationRollPitchYaw gives).  Each vector holds one matrix element of the four nodes, so transposing
+	// the x, y, z columns of a row gives that row of each node.
+	row0 = XMMatrixTranspose(XMMATRIX(XMVectorMultiply(XMVectorMultiplyAdd(sinZ, sinXsinY, XMVectorMultiply(cosZ, cosY)), scale),
+									  XMVectorMultiply(XMVectorMultiply(sinZ, cosX), scale),
+									  XMVectorMultiply(XMVectorSubtract(XMVectorMultiply(sinZ, sinXcosY), XMVectorMultiply(cosZ, sinY)), scale),
+									  zero));
+	row1 = XMMatrixTranspose(XMMATRIX(XMVectorMultiply(XMVectorSubtract(XMVectorMultiply(cosZ, sinXsinY), XMVectorMultiply(sinZ, cosY)), scale),
+									  XMVectorMultiply(XMVectorMultiply(cosZ, cosX), scale),
+									  XMVectorMultiply(XMVectorMultiplyAdd(cosZ, sinXcosY, XMVectorMultiply(sinZ, sinY)), scale),
+									  zero));
+	row2 = XMMatrixTranspose(XMMATRIX(XMVectorMultiply(XMVectorMultiply(cosX, sinY), scale),
+									  XMVectorMultiply(XMVectorNegate(sinX), scale),
+									  XMVectorMultiply(XMVectorMultiply(cosX, cosY), scale),
+									  zero));
+	row3 = XMMatrixTranspose(XMMATRIX(XMVectorSet(m_positionX[lane[0]], m_positionX[lane[1]], m_positionX[lane[2]], m_positionX[lane[3]]),
+									  XMVectorSet(m_positionY[lane[0]], m_positionY[lane[1]], m_positionY[lane[2]], m_positionY[lane[3]]),
+									  XMVectorSet(m_positionZ[lane[0]], m_positionZ[lane[1]], m_positionZ[lane[2]], m_positionZ[lane[3]]),
+									  XMVectorSplatOne()));
+
+	// Scatter the rows back to each node's local matrix.
+	for(i=0; i<count; i++)
+	{
+		localMatrix = XMMATRIX(row0.r[i], row1.r[i], row2.r[i], row3.r[i]);
+		XMStoreFloat4x4(&m_local[nodes[i]], localMatrix);
+	}
+
+	return;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: transformclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _TRANSFORMCLASS_H_
+#define _TRANSFORMCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <DirectXMath.h>
+#include <algorithm>
+using namespace DirectX;
+using namespace std;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: TransformClass
+////////////////////////////////////////////////////////////////////////////////
+class TransformClass
+{
+public:
+	TransformClass();
+	TransformClass(const TransformClass&);
+	~TransformClass();
+
+	bool Initialize(int);
+	void Shutdown();
+
+	int AddNode(int);
+	void SetLocal(int, float, float, float, float, float, float, float);
+	void SetLocalPosition(int, float, float, float);
+	void SetLocalRotation(int, float, float, float);
+
+	int Update();
+
+	int GetNodeCount();
+	int GetParent(int);
+	const XMFLOAT4X4* GetWorldMatrix(int);
+	const XMFLOAT4X4* GetWorldMatrices();
+
+private:
+	void UpdateLocalMatrices(const int*, int);
+
+private:
+	int m_maxNodes, m_nodeCount;
+
+	// The nodes are stored breadth first, every parent comes before its children so one linear pass updates the tree.
+	int* m_parent;
+	int* m_depth;
+
+	float *m_positionX, *m_positionY, *m_positionZ;
+	float *m_rotationX, *m_rotationY, *m_rotationZ;
+	float* m_scale;
+
+	unsigned char* m_dirty;
+	unsigned char* m_changed;
+
+	// The indices of the dirty nodes gathered at the start of Update for the batched local matrix build.
+	int* m_rebuild;
+
+	XMFLOAT4X4* m_local;
+	XMFLOAT4X4* m_world;
+};
+
+#endif
\ No newline at end of file
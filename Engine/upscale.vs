@@ -0,0 +1,30 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: upscale.vs
+////////////////////////////////////////////////////////////////////////////////
+
+
+//////////////
+// TYPEDEFS //
+//////////////
+struct PixelInputType
+{
+	float4 position : SV_POSITION;
+	float2 tex : TEXCOORD0;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Vertex Shader
+////////////////////////////////////////////////////////////////////////////////
+PixelInputType UpscaleVertexShader(uint vertexId : SV_VertexID)
+{
+	PixelInputType output;
+
+
+	// Build one triangle that covers the whole screen from the vertex index, the texture coordinates map 0 to 1 across
+	// the visible part of it.
+	output.tex = float2((vertexId << 1) & 2, vertexId & 2);
+	output.position = float4(output.tex.x * 2.0f - 1.0f, 1.0f - output.tex.y * 2.0f, 0.0f, 1.0f);
+
+	return output;
+}
\ No newline at end of file
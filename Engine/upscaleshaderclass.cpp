@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: upscaleshaderclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "upscaleshaderclass.h"
+
+
+UpscaleShaderClass::UpscaleShaderClass()
+{
+	m_Device = 0;
+	m_pipeline = 0;
+	m_upscaleBuffer = 0;
+}
+
+
+UpscaleShaderClass::UpscaleShaderClass(const UpscaleShaderClass& other)
+{
+}
+
+
+UpscaleShaderClass::~UpscaleShaderClass()
+{
+}
+
+
+bool UpscaleShaderClass::Initialize(RenderDeviceClass* device)
+{
+	bool result;
+
+
+	// Store the device the shader objects are created on.
+	m_Device = device;
+
+	// Initialize the vertex and pixel shaders.
+	result = InitializeShader(L"../Engine/upscale.vs", L"../Engine/upscale.ps");
+	if(!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void UpscaleShaderClass::Shutdown()
+{
+	// Shutdown the vertex and pixel shaders as well as the related objects.
+	ShutdownShader();
+
+	return;
+}
+
+
+bool UpscaleShaderClass::Render(int texture, int textureWidth, int textureHeight, int drawnWidth, int drawnHeight, float sharpness)
+{
+	bool result;
+
+
+	// Set the shader parameters that it will use for rendering.
+	result = SetShaderParameters(texture, textureWidth, textureHeight, drawnWidth, drawnHeight, sharpness);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Now stretch the drawn corner over the whole screen with the shader.
+	RenderShader();
+
+	return true;
+}
+
+
+int UpscaleShaderClass::GetPipeline()
+{
+	return m_pipeline;
+}
+
+
+bool UpscaleShaderClass::InitializeShader(const wchar_t* vsFilename, const wchar_t* psFilename)
+{
+	RenderDeviceClass::PipelineDescType pipelineDesc;
+
+
+	// Describe the pipeline, the vertex shader has no input and the scene is filtered with the linear sampler.  The
+	// pixel shader keeps the coordinates inside the drawn corner so the wrapping is never seen.
+	pipelineDesc.vertexShaderFilename = vsFilename;
+	pipelineDesc.vertexShaderEntryPoint = "UpscaleVertexShader";
+	pipelineDesc.vertexFormat = RenderDeviceClass::VERTEX_FORMAT_NONE;
+	pipelineDesc.pixelShaderFilename = psFilename;
+	pipelineDesc.pixelShaderEntryPoint = "UpscalePixelShader";
+	pipelineDesc.sampler = RenderDeviceClass::SAMPLER_LINEAR_WRAP;
+
+	// Create the pipeline, it shares any shader or sampler another pipeline already created.
+	m_pipeline = m_Device->CreatePipeline(pipelineDesc);
+	if(!m_pipeline)
+	{
+		return false;
+	}
+
+	// Create the dynamic upscale constant buffer that is in the pixel shader.
+	m_upscaleBuffer = m_Device->CreateBuffer(RenderDeviceClass::RESOURCE_CONSTANT_BUFFER, NULL, sizeof(UpscaleBufferType));
+	if(!m_upscaleBuffer)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+void UpscaleShaderClass::ShutdownShader()
+{
+	// Release the upscale constant buffer.
+	if(m_upscaleBuffer)
+	{
+		m_Device->ReleaseResource(m_upscaleBuffer);
+		m_upscaleBuffer = 0;
+	}
+
+	// Release the pipeline.
+	if(m_pipeline)
+	{
+		m_Device->ReleasePipeline(m_pipeline);
+		m_pipeline = 0;
+	}
+
+	return;
+}
+
+
+bool UpscaleShaderClass::SetShaderParameters(int texture, int textureWidth, int textureHeight, int drawnWidth, int drawnHeight,
+	float sharpness)
+{
+	UpscaleBufferType upscaleBuffer;
+	bool result;
+
+
+	if(textureWidth <= 0 || textureHeight <= 0 || drawnWidth <= 0 || drawnHeight <= 0)
+	{
+		return false;
+	}
+
+	// The screen maps onto the drawn corner of the texture, and the filter is kept half a texel inside it.
+	upscaleBuffer.texelSize = XMFLOAT2(1.0f / (float)textureWidth, 1.0f / (float)textureHeight);
+	upscaleBuffer.uvScale = XMFLOAT2((float)drawnWidth / (float)textureWidth, (float)drawnHeight / (float)textureHeight);
+	upscaleBuffer.uvMin = XMFLOAT2(0.5f * upscaleBuffer.texelSize.x, 0.5f * upscaleBuffer.texelSize.y);
+	upscaleBuffer.uvMax = XMFLOAT2(upscaleBuffer.uvScale.x - upscaleBuffer.uvMin.x, upscaleBuffer.uvScale.y - upscaleBuffer.uvMin.y);
+	upscaleBuffer.sharpness = sharpness;
+	upscaleBuffer.padding = XMFLOAT3(0.0f, 0.0f, 0.0f);
+
+	result = m_Device->UpdateBuffer(m_upscaleBuffer, &upscaleBuffer, sizeof(UpscaleBufferType));
+	if(!result)
+	{
+		return false;
+	}
+
+	m_Device->SetConstantBuffer(RenderDeviceClass::SHADER_STAGE_PIXEL, 0, m_upscaleBuffer);
+
+	// Bind the scene texture.
+	m_Device->SetTexture(0, texture);
+
+	return true;
+}
+
+
+void UpscaleShaderClass::RenderShader()
+{
+	// Bind the shaders and the sampler in one go, the pipeline has no input layout.
+	m_Device->SetPipeline(m_pipeline);
+
+	// Render the fullscreen triangle.
+	m_Device->Draw(3);
+
+	return;
+}
\ No newline at end of file
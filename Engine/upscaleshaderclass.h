@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: upscaleshaderclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _UPSCALESHADERCLASS_H_
+#define _UPSCALESHADERCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <DirectXMath.h>
+using namespace DirectX;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "renderdeviceclass.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: UpscaleShaderClass
+//
+// Stretches the top left corner of a render target the scene was drawn into over the whole screen with one fullscreen
+// triangle.  The corner is filtered bilinearly and can be sharpened against its four neighbours, a sharpness of 0 is
+// the plain bilinear filter.
+////////////////////////////////////////////////////////////////////////////////
+class UpscaleShaderClass
+{
+private:
+	struct UpscaleBufferType
+	{
+		XMFLOAT2 uvScale;
+		XMFLOAT2 uvMin;
+		XMFLOAT2 uvMax;
+		XMFLOAT2 texelSize;
+		float sharpness;
+		XMFLOAT3 padding;
+	};
+
+public:
+	UpscaleShaderClass();
+	UpscaleShaderClass(const UpscaleShaderClass&);
+	~UpscaleShaderClass();
+
+	bool Initialize(RenderDeviceClass*);
+	void Shutdown();
+	bool Render(int, int, int, int, int, float);
+
+	int GetPipeline();
+
+private:
+	bool InitializeShader(const wchar_t*, const wchar_t*);
+	void ShutdownShader();
+
+	bool SetShaderParameters(int, int, int, int, int, float);
+	void RenderShader();
+
+private:
+	RenderDeviceClass* m_Device;
+	int m_pipeline;
+	int m_upscaleBuffer;
+};
+
+#endif
\ No newline at end of file
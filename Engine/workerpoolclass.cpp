@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: workerpoolclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "workerpoolclass.h"
+
+
+WorkerPoolClass::WorkerPoolClass()
+{
+	m_quit = false;
+	m_generation = 0;
+	m_busyWorkers = 0;
+	m_job = 0;
+	m_context = 0;
+	m_count = 0;
+	m_blockSize = 1;
+	m_blockCount = 0;
+	m_nextBlock = 0;
+	m_pendingBlocks = 0;
+}
+
+
+WorkerPoolClass::WorkerPoolClass(const WorkerPoolClass& other)
+{
+}
+
+
+WorkerPoolClass::~WorkerPoolClass()
+{
+}
+
+
+bool WorkerPoolClass::Initialize(int threadCount)
+{
+	int i;
+
+
+	// The calling thread works on the jobs as well, so the pool only starts the threads beyond the first.
+	if(threadCount < 1)
+	{
+		threadCount = 1;
+	}
+	if(threadCount > WORKER_POOL_MAX_THREADS)
+	{
+		threadCount = WORKER_POOL_MAX_THREADS;
+	}
+
+	m_quit = false;
+	m_generation = 0;
+	m_busyWorkers = 0;
+
+	for(i=1; i<threadCount; i++)
+	{
+		m_workers.push_back(thread(WorkerThread, this));
+	}
+
+	return true;
+}
+
+
+void WorkerPoolClass::Shutdown()
+{
+	unsigned int i;
+
+
+	// Wake the workers up to quit and wait for them to leave.
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+
+	for(i=0; i<m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+	m_workers.clear();
+
+	return;
+}
+
+
+void WorkerPoolClass::Run(JobType job, void* context, int count, int blockSize)
+{
+	int start;
+
+
+	if(blockSize < 1)
+	{
+		blockSize = 1;
+	}
+
+	// Without workers or with a single block the job is run right here, block by block.
+	if(m_workers.empty() || (count <= blockSize))
+	{
+		for(start=0; start<count; start+=blockSize)
+		{
+			job(context, start, (start + blockSize < count) ? start + blockSize : count);
+		}
+
+		return;
+	}
+
+	// Wait for the workers still leaving the previous job before it is replaced, then hand out the new one.
+	{
+		unique_lock<mutex> lock(m_mutex);
+		while(m_busyWorkers > 0)
+		{
+			m_done.wait(lock);
+		}
+
+		m_job = job;
+		m_context = context;
+		m_count = count;
+		m_blockSize = blockSize;
+		m_blockCount = (count + blockSize - 1) / blockSize;
+		m_nextBlock = 0;
+		m_pendingBlocks = m_blockCount;
+		m_generation++;
+	}
+	m_wake.notify_all();
+
+	// Take blocks alongside the workers and then wait for the blocks they are still running.
+	RunBlocks();
+
+	{
+		unique_lock<mutex> lock(m_mutex);
+		while(m_pendingBlocks > 0)
+		{
+			m_done.wait(lock);
+		}
+	}
+
+	return;
+}
+
+
+int WorkerPoolClass::GetThreadCount()
+{
+	return (int)m_workers.size() + 1;
+}
+
+
+void WorkerPoolClass::RunBlocks()
+{
+	int block, start, end;
+
+
+	// Take the next block until there are none left, the thread that finishes the last one wakes up Run.
+	for(block=m_nextBlock++; block<m_blockCount; block=m_nextBlock++)
+	{
+		start = block * m_blockSize;
+		end = (start + m_blockSize < m_count) ? start + m_blockSize : m_count;
+		m_job(m_context, start, end);
+
+		if(--m_pendingBlocks == 0)
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_done.notify_all();
+		}
+	}
+
+	return;
+}
+
+
+void WorkerPoolClass::WorkerThread(WorkerPoolClass* pool)
+{
+	unsigned int generation;
+
+
+	generation = 0;
+
+	unique_lock<mutex> lock(pool->m_mutex);
+	while(true)
+	{
+		// Sleep until there is a new job or the pool shuts down.
+		while(!pool->m_quit && (pool->m_generation == generation))
+		{
+			pool->m_wake.wait(lock);
+		}
+
+		if(pool->m_quit)
+		{
+			break;
+		}
+
+		generation = pool->m_generation;
+		pool->m_busyWorkers++;
+		lock.unlock();
+
+		pool->RunBlocks();
+
+		// Let a waiting Run know once the last worker has left the job.
+		lock.lock();
+		pool->m_busyWorkers--;
+		if(pool->m_busyWorkers == 0)
+		{
+			pool->m_done.notify_all();
+		}
+	}
+
+	return;
+}
\ No newline at end of file
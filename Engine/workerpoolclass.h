@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: workerpoolclass.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _WORKERPOOLCLASS_H_
+#define _WORKERPOOLCLASS_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int WORKER_POOL_MAX_THREADS = 16;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: WorkerPoolClass
+//
+// Keeps a set of worker threads asleep between frames so the systems that split their work across threads do not
+// start and join new threads every time.  A job is a function that is handed a context and a range of items, Run cuts
+// the items into blocks of the given size that the workers and the calling thread take one at a time, and returns once
+// every block is done.  The pool runs one job at a time and a job must not start another one on the same pool.
+////////////////////////////////////////////////////////////////////////////////
+class WorkerPoolClass
+{
+public:
+	typedef void (*JobType)(void*, int, int);
+
+public:
+	WorkerPoolClass();
+	WorkerPoolClass(const WorkerPoolClass&);
+	~WorkerPoolClass();
+
+	bool Initialize(int);
+	void Shutdown();
+
+	void Run(JobType, void*, int, int);
+
+	int GetThreadCount();
+
+private:
+	void RunBlocks();
+	static void WorkerThread(WorkerPoolClass*);
+
+private:
+	vector<thread> m_workers;
+	mutex m_mutex;
+	condition_variable m_wake, m_done;
+	bool m_quit;
+	unsigned int m_generation;
+	int m_busyWorkers;
+
+	JobType m_job;
+	void* m_context;
+	int m_count, m_blockSize, m_blockCount;
+	atomic<int> m_nextBlock, m_pendingBlocks;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: benchmarktest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Runs a short benchmark of the game headless on the null device until it ends the application, then reads the report
+// back.  It must hold a row for every recorded frame with the draws and triangles of the frame, and as the benchmark
+// flies a fixed path at a fixed step a second run must draw exactly the same.
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <vector>
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "graphicsclass.h"
+#include "testscene.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int TEST_SCREEN_WIDTH = 320;
+const int TEST_SCREEN_HEIGHT = 180;
+const int TEST_WARMUP_FRAMES = 5;
+const int TEST_BENCHMARK_FRAMES = 60;
+
+
+struct ReportRowType
+{
+	int frame, drawCalls, triangles;
+};
+
+
+// Reads the frame, draws and triangles of every row of the report, the times differ from run to run.
+static bool ReadReport(const char* filename, vector<ReportRowType>& rows)
+{
+	ifstream fin;
+	istringstream fields;
+	string line, field;
+	ReportRowType row;
+	int i;
+
+
+	rows.clear();
+
+	fin.open(filename);
+	if(fin.fail() || !getline(fin, line) || line != "frame,time,cpu,gpu,draws,triangles")
+	{
+		return false;
+	}
+
+	while(getline(fin, line))
+	{
+		fields.clear();
+		fields.str(line);
+		for(i=0; i<6; i++)
+		{
+			if(!getline(fields, field, ','))
+			{
+				return false;
+			}
+
+			if(i == 0)
+			{
+				row.frame = atoi(field.c_str());
+			}
+			if(i == 4)
+			{
+				row.drawCalls = atoi(field.c_str());
+			}
+			if(i == 5)
+			{
+				row.triangles = atoi(field.c_str());
+			}
+		}
+
+		rows.push_back(row);
+	}
+
+	return true;
+}
+
+
+static bool RunBenchmark(const char* name, vector<ReportRowType>& rows)
+{
+	GraphicsClass graphics;
+	char reportFilename[SCENE_MAX_PATH], summaryFilename[SCENE_MAX_PATH], filename[SCENE_MAX_PATH / 2];
+	int frameCount;
+
+
+	snprintf(filename, sizeof(filename), "%s.csv", name);
+	GetOutputPath(filename, reportFilename, sizeof(reportFilename));
+	snprintf(filename, sizeof(filename), "%s.summary.csv", name);
+	GetOutputPath(filename, summaryFilename, sizeof(summaryFilename));
+	remove(reportFilename);
+	remove(summaryFilename);
+
+	if(!SetTestScene(graphics, "benchmarktest") || !graphics.InitializeHeadless(TEST_SCREEN_WIDTH, TEST_SCREEN_HEIGHT) ||
+	   !graphics.StartBenchmark(TEST_WARMUP_FRAMES, TEST_BENCHMARK_FRAMES, reportFilename, summaryFilename))
+	{
+		graphics.Shutdown();
+		return false;
+	}
+
+	// The benchmark ends the application once it has written its results.
+	frameCount = 0;
+	while(graphics.Frame(0))
+	{
+		frameCount++;
+	}
+
+	CHECK(frameCount >= TEST_WARMUP_FRAMES + TEST_BENCHMARK_FRAMES - 1);
+	CHECK(graphics.GetBenchmark()->IsFinished());
+	CHECK(graphics.GetBenchmark()->GetRecordedFrameCount() == TEST_BENCHMARK_FRAMES);
+
+	graphics.Shutdown();
+
+	CHECK(IsFile(summaryFilename));
+
+	return ReadReport(reportFilename, rows);
+}
+
+
+static void TestHeadlessBenchmark()
+{
+	vector<ReportRowType> first, second;
+	int i;
+
+
+	CHECK(RunBenchmark("benchmarktest.first", first));
+	CHECK(RunBenchmark("benchmarktest.second", second));
+
+	// Every recorded frame has its row, and every frame drew something.
+	CHECK(first.size() == TEST_BENCHMARK_FRAMES);
+	CHECK(second.size() == first.size());
+	if(second.size() != first.size())
+	{
+		return;
+	}
+
+	for(i=0; i<(int)first.size(); i++)
+	{
+		CHECK(first[i].frame == i);
+		CHECK(first[i].drawCalls > 0 && first[i].triangles > 0);
+
+		// Both runs fly the same path at the same step, so they draw the same.
+		CHECK(first[i].drawCalls == second[i].drawCalls);
+		CHECK(first[i].triangles == second[i].triangles);
+	}
+
+	return;
+}
+
+
+int main()
+{
+	TestHeadlessBenchmark();
+
+	return TestResult("benchmarktest");
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: benchmarktimer.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _BENCHMARKTIMER_H_
+#define _BENCHMARKTIMER_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+using namespace std;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Function name: GetMilliseconds
+////////////////////////////////////////////////////////////////////////////////
+// Reads the steady clock in milliseconds, the same clock TimerClass uses.
+static inline double GetMilliseconds()
+{
+	return chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Function name: GetMedian
+////////////////////////////////////////////////////////////////////////////////
+// Benchmarks report the median sample so a single preempted run does not skew the result.
+static inline double GetMedian(vector<double> samples)
+{
+	if(samples.empty())
+	{
+		return 0.0;
+	}
+
+	sort(samples.begin(), samples.end());
+
+	return samples[samples.size() / 2];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Function name: GetArgument
+////////////////////////////////////////////////////////////////////////////////
+// Reads an optional positive integer command line argument so the sizes can be changed without rebuilding.
+static inline int GetArgument(int argc, char** argv, int index, int defaultValue)
+{
+	int value;
+
+
+	if(index >= argc)
+	{
+		return defaultValue;
+	}
+
+	value = atoi(argv[index]);
+
+	return (value > 0) ? value : defaultValue;
+}
+
+#endif
\ No newline at end of file
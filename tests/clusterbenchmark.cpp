@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: clusterbenchmark.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Times ClusterClass::Bin for 128 to 1024 point lights spread through the view, on 1, 2, 4 ... threads up to the core
+// count, and reports the median bin time and the number of light indices written.
+//
+//   clusterbenchmark [iterations] [maxThreads]
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <thread>
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "nulldeviceclass.h"
+#include "clusterclass.h"
+#include "benchmarktimer.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int SCREEN_WIDTH = 1920;
+const int SCREEN_HEIGHT = 1080;
+const float SCREEN_DEPTH = 1000.0f;
+const int DEFAULT_ITERATIONS = 200;
+const int LIGHT_COUNTS[] = { 128, 256, 512, 1024 };
+
+
+static float Random(unsigned int& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+
+	return (float)(state & 0xFFFF) / 65535.0f;
+}
+
+
+int main(int argc, char** argv)
+{
+	NullDeviceClass device;
+	WorkerPoolClass workerPool;
+	ClusterClass clusters;
+	vector<ClusterClass::PointLightType> lights;
+	vector<double> samples;
+	XMMATRIX viewMatrix;
+	double start;
+	unsigned int seed;
+	int iterations, maxThreads, threadCount, lightCount, i, c;
+
+
+	iterations = GetArgument(argc, argv, 1, DEFAULT_ITERATIONS);
+	maxThreads = min(max(GetArgument(argc, argv, 2, (int)thread::hardware_concurrency()), 1), CLUSTER_MAX_THREADS);
+
+	if(!device.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, 0.1f, false))
+	{
+		return 1;
+	}
+
+	// Street light sized lights scattered in front of a camera looking down the z axis.
+	seed = 99;
+	lights.resize(CLUSTER_MAX_LIGHTS);
+	for(i=0; i<CLUSTER_MAX_LIGHTS; i++)
+	{
+		lights[i].position = XMFLOAT3(Random(seed) * 600.0f - 300.0f, Random(seed) * 40.0f - 10.0f, Random(seed) * 600.0f);
+		lights[i].radius = 5.0f + Random(seed) * 25.0f;
+		lights[i].color = XMFLOAT3(1.0f, 1.0f, 1.0f);
+		lights[i].padding = 0.0f;
+	}
+	viewMatrix = XMMatrixLookAtLH(XMVectorSet(0.0f, 10.0f, -20.0f, 1.0f), XMVectorSet(0.0f, 5.0f, 100.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+
+	printf("cluster binning, %d x %d x %d clusters, median of %d, %d cores\n", CLUSTER_COLUMNS, CLUSTER_ROWS, CLUSTER_SLICES, iterations,
+		   (int)thread::hardware_concurrency());
+	printf("  lights  threads   bin ms   indices\n");
+
+	for(c=0; c<(int)(sizeof(LIGHT_COUNTS) / sizeof(LIGHT_COUNTS[0])); c++)
+	{
+		lightCount = LIGHT_COUNTS[c];
+		for(threadCount=1; threadCount<=maxThreads; threadCount*=2)
+		{
+			if(!workerPool.Initialize(threadCount) || !clusters.Initialize(&device, SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, &workerPool) ||
+			   !clusters.SetLights(lights.data(), lightCount))
+			{
+				return 1;
+			}
+
+			// Bin once to warm the caches, then time the rest.
+			clusters.Bin(viewMatrix);
+
+			samples.clear();
+			for(i=0; i<iterations; i++)
+			{
+				start = GetMilliseconds();
+				clusters.Bin(viewMatrix);
+				samples.push_back(GetMilliseconds() - start);
+			}
+
+			printf("  %6d  %7d  %7.3f  %8d\n", lightCount, threadCount, GetMedian(samples), clusters.GetIndexCount());
+
+			clusters.Shutdown();
+			workerPool.Shutdown();
+		}
+	}
+
+	device.Shutdown();
+
+	return 0;
+}
\ No newline at end of file
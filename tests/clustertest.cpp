@@ -0,0 +1,265 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: clustertest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Compares the SIMD and multithreaded light binning of ClusterClass with a scalar double precision sphere against
+// froxel box test written out independently here, and checks the threaded binning matches the single threaded one.
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <vector>
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "nulldeviceclass.h"
+#include "clusterclass.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int SCREEN_WIDTH = 1280;
+const int SCREEN_HEIGHT = 720;
+const float SCREEN_DEPTH = 1000.0f;
+const float SCREEN_NEAR = 0.1f;
+const int LIGHT_COUNT = 300;
+const double BOUNDARY_TOLERANCE = 1e-3;
+
+
+static float Random(unsigned int& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+
+	return (float)(state & 0xFFFF) / 65535.0f;
+}
+
+
+static void MakeLights(vector<ClusterClass::PointLightType>& lights, int count, unsigned int seed)
+{
+	int i;
+
+
+	// Scatter the lights around and behind the camera at the origin looking down +z, some past the far plane.
+	lights.resize(count);
+	for(i=0; i<count; i++)
+	{
+		lights[i].position = XMFLOAT3(Random(seed) * 400.0f - 200.0f, Random(seed) * 200.0f - 100.0f, Random(seed) * 1100.0f - 50.0f);
+		lights[i].radius = 2.0f + Random(seed) * 60.0f;
+		lights[i].color = XMFLOAT3(1.0f, 1.0f, 1.0f);
+		lights[i].padding = 0.0f;
+	}
+
+	return;
+}
+
+
+static double ReferenceDistance(const ClusterClass::PointLightType& light, double scaleX, double scaleY, int column, int row, int slice)
+{
+	double depthRange, nearDepth, farDepth, left, right, top, bottom, minX, maxX, minY, maxY, dx, dy, dz;
+
+
+	// The slice depths grow exponentially from the cluster near depth to the far plane, the first slice starts at 0.
+	depthRange = log((double)SCREEN_DEPTH / (double)CLUSTER_NEAR_DEPTH);
+	nearDepth = (slice == 0) ? 0.0 : CLUSTER_NEAR_DEPTH * exp(depthRange * slice / CLUSTER_SLICES);
+	farDepth = (slice == CLUSTER_SLICES - 1) ? SCREEN_DEPTH : CLUSTER_NEAR_DEPTH * exp(depthRange * (slice + 1) / CLUSTER_SLICES);
+
+	// The box around the piece of the tile frustum between the two depths, rows count down from the top.
+	left = -1.0 + 2.0 * column / CLUSTER_COLUMNS;
+	right = -1.0 + 2.0 * (column + 1) / CLUSTER_COLUMNS;
+	top = 1.0 - 2.0 * row / CLUSTER_ROWS;
+	bottom = 1.0 - 2.0 * (row + 1) / CLUSTER_ROWS;
+
+	minX = min(left * nearDepth, left * farDepth) * scaleX;
+	maxX = max(right * nearDepth, right * farDepth) * scaleX;
+	minY = min(bottom * nearDepth, bottom * farDepth) * scaleY;
+	maxY = max(top * nearDepth, top * farDepth) * scaleY;
+
+	// Distance from the sphere center to the box, the view matrix is the identity so world space is view space.
+	dx = max(max(minX - light.position.x, light.position.x - maxX), 0.0);
+	dy = max(max(minY - light.position.y, light.position.y - maxY), 0.0);
+	dz = max(max(nearDepth - light.position.z, light.position.z - farDepth), 0.0);
+
+	return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+
+static void TestAgainstReference(int threadCount)
+{
+	NullDeviceClass device;
+	WorkerPoolClass workerPool;
+	ClusterClass clusters;
+	vector<ClusterClass::PointLightType> lights;
+	XMMATRIX projectionMatrix;
+	XMFLOAT4X4 projection;
+	const unsigned int* clusterLights;
+	double scaleX, scaleY, distance;
+	int column, row, slice, cluster, i, found, clusterCount, mismatchCount, totalCount;
+
+
+	CHECK(device.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SCREEN_NEAR, false));
+	CHECK(workerPool.Initialize(threadCount));
+	CHECK(clusters.Initialize(&device, SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, &workerPool));
+
+	device.GetProjectionMatrix(projectionMatrix);
+	XMStoreFloat4x4(&projection, projectionMatrix);
+	scaleX = 1.0 / projection._11;
+	scaleY = 1.0 / projection._22;
+
+	MakeLights(lights, LIGHT_COUNT, 777);
+	CHECK(clusters.SetLights(lights.data(), LIGHT_COUNT));
+	clusters.Bin(XMMatrixIdentity());
+
+	// Every light the reference finds touching a cluster must be in that cluster's list and no other light may be,
+	// apart from lights that only graze the box to within float rounding.
+	mismatchCount = 0;
+	totalCount = 0;
+	for(slice=0; slice<CLUSTER_SLICES; slice++)
+	{
+		for(row=0; row<CLUSTER_ROWS; row++)
+		{
+			for(column=0; column<CLUSTER_COLUMNS; column++)
+			{
+				cluster = clusters.GetCluster(column, row, slice);
+				clusterLights = clusters.GetClusterLights(cluster);
+				clusterCount = clusters.GetClusterLightCount(cluster);
+				CHECK(clusterCount < CLUSTER_MAX_LIGHTS_PER_CLUSTER);
+				totalCount += clusterCount;
+
+				found = 0;
+				for(i=0; i<LIGHT_COUNT; i++)
+				{
+					distance = ReferenceDistance(lights[i], scaleX, scaleY, column, row, slice);
+					if(found < clusterCount && clusterLights[found] == (unsigned int)i)
+					{
+						found++;
+						if(distance > lights[i].radius * (1.0 + BOUNDARY_TOLERANCE))
+						{
+							mismatchCount++;
+						}
+					}
+					else if(distance < lights[i].radius * (1.0 - BOUNDARY_TOLERANCE))
+					{
+						mismatchCount++;
+					}
+				}
+
+				// The lists are in light order, so walking the lights in order must have consumed the whole list.
+				CHECK(found == clusterCount);
+			}
+		}
+	}
+
+	CHECK(mismatchCount == 0);
+	CHECK(totalCount == clusters.GetIndexCount());
+	CHECK(totalCount > LIGHT_COUNT);
+
+	clusters.Shutdown();
+	CHECK(device.GetResourceCount() == 0);
+	device.Shutdown();
+	workerPool.Shutdown();
+
+	return;
+}
+
+
+static void TestThreadsMatch()
+{
+	NullDeviceClass device;
+	WorkerPoolClass workerPool;
+	ClusterClass single, threaded;
+	vector<ClusterClass::PointLightType> lights;
+	XMMATRIX viewMatrix;
+	int cluster;
+	bool same;
+
+
+	CHECK(device.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SCREEN_NEAR, false));
+	CHECK(workerPool.Initialize(CLUSTER_MAX_THREADS));
+	CHECK(single.Initialize(&device, SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, 0));
+	CHECK(threaded.Initialize(&device, SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, &workerPool));
+
+	// A turned camera puts the lights through the view transform stream as well.
+	MakeLights(lights, CLUSTER_MAX_LIGHTS, 4242);
+	viewMatrix = XMMatrixLookAtLH(XMVectorSet(10.0f, 20.0f, -30.0f, 1.0f), XMVectorSet(40.0f, 0.0f, 300.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+
+	CHECK(single.SetLights(lights.data(), CLUSTER_MAX_LIGHTS));
+	CHECK(threaded.SetLights(lights.data(), CLUSTER_MAX_LIGHTS));
+	single.Bin(viewMatrix);
+	threaded.Bin(viewMatrix);
+
+	CHECK(single.GetIndexCount() == threaded.GetIndexCount());
+	same = true;
+	for(cluster=0; cluster<CLUSTER_COUNT; cluster++)
+	{
+		same = same && (single.GetClusterLightCount(cluster) == threaded.GetClusterLightCount(cluster));
+		if(same && single.GetClusterLightCount(cluster) > 0)
+		{
+			same = (memcmp(single.GetClusterLights(cluster), threaded.GetClusterLights(cluster), sizeof(unsigned int) * single.GetClusterLightCount(cluster)) == 0);
+		}
+	}
+	CHECK(same);
+
+	// Too many lights are refused and an empty list bins to nothing.
+	CHECK(!single.SetLights(lights.data(), CLUSTER_MAX_LIGHTS + 1));
+	CHECK(single.SetLights(0, 0));
+	single.Bin(viewMatrix);
+	CHECK(single.GetIndexCount() == 0);
+
+	threaded.Shutdown();
+	single.Shutdown();
+	device.Shutdown();
+	workerPool.Shutdown();
+
+	return;
+}
+
+
+static void TestSlices()
+{
+	NullDeviceClass device;
+	ClusterClass clusters;
+	double depthRange, sliceDepth;
+	int slice;
+	bool valid;
+
+
+	CHECK(device.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SCREEN_NEAR, false));
+	CHECK(clusters.Initialize(&device, SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, 0));
+
+	// Depths in front of the cluster near depth go to the first slice, depths past the far plane to the last.
+	CHECK(clusters.GetSlice(0.0f) == 0);
+	CHECK(clusters.GetSlice(CLUSTER_NEAR_DEPTH) == 0);
+	CHECK(clusters.GetSlice(SCREEN_DEPTH * 2.0f) == CLUSTER_SLICES - 1);
+
+	// Just past each slice boundary lands in that slice.
+	depthRange = log((double)SCREEN_DEPTH / (double)CLUSTER_NEAR_DEPTH);
+	valid = true;
+	for(slice=1; slice<CLUSTER_SLICES; slice++)
+	{
+		sliceDepth = CLUSTER_NEAR_DEPTH * exp(depthRange * slice / CLUSTER_SLICES);
+		valid = valid && (clusters.GetSlice((float)(sliceDepth * 1.001)) == slice) && (clusters.GetSlice((float)(sliceDepth * 0.999)) == slice - 1);
+	}
+	CHECK(valid);
+
+	clusters.Shutdown();
+	device.Shutdown();
+
+	return;
+}
+
+
+int main()
+{
+	TestAgainstReference(1);
+	TestAgainstReference(4);
+	TestThreadsMatch();
+	TestSlices();
+
+	return TestResult("clustertest");
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: cpuprofilerbenchmark.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Times the cost of one CpuZoneClass zone, scoped and as a phase of a longer zone, next to the bare cost of the two
+// counter reads a zone needs and the cost of a zone while the profiler is off.  The zones are meant to stay under 50 ns.
+//
+//   cpuprofilerbenchmark [zones] [iterations]
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "cpuprofilerclass.h"
+#include "benchmarktimer.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int DEFAULT_ZONE_COUNT = 1000000;
+const int DEFAULT_ITERATIONS = 15;
+const double ZONE_TARGET_NS = 50.0;
+
+enum CaseType
+{
+	CASE_COUNTER_READS,
+	CASE_SCOPED_ZONE,
+	CASE_PHASE_ZONE,
+	CASE_DISABLED_ZONE
+};
+
+
+static volatile unsigned long long g_sink;
+
+
+static void RunCase(int caseType, int zoneCount)
+{
+	unsigned long long sum;
+	int i;
+
+
+	switch(caseType)
+	{
+		case CASE_COUNTER_READS:
+		{
+			sum = 0;
+			for(i=0; i<zoneCount; i++)
+			{
+				sum += CpuProfilerClass::GetTime();
+				sum += CpuProfilerClass::GetTime();
+			}
+			g_sink = sum;
+			break;
+		}
+
+		case CASE_SCOPED_ZONE:
+		case CASE_DISABLED_ZONE:
+		{
+			for(i=0; i<zoneCount; i++)
+			{
+				CpuZoneClass zone("Zone");
+			}
+			break;
+		}
+
+		case CASE_PHASE_ZONE:
+		{
+			CpuZoneClass zone;
+
+			for(i=0; i<zoneCount; i++)
+			{
+				zone.Begin("Phase");
+			}
+			break;
+		}
+	}
+
+	return;
+}
+
+
+static double TimeCase(int caseType, int zoneCount, int iterations)
+{
+	vector<double> samples;
+	double start;
+	int i;
+
+
+	for(i=0; i<iterations; i++)
+	{
+		start = GetMilliseconds();
+		RunCase(caseType, zoneCount);
+		samples.push_back((GetMilliseconds() - start) * 1000000.0 / (double)zoneCount);
+	}
+
+	return GetMedian(samples);
+}
+
+
+int main(int argc, char** argv)
+{
+	int zoneCount, iterations;
+	double counterTime, scopedTime, phaseTime, disabledTime;
+
+
+	zoneCount = GetArgument(argc, argv, 1, DEFAULT_ZONE_COUNT);
+	iterations = GetArgument(argc, argv, 2, DEFAULT_ITERATIONS);
+
+	if(!CpuProfilerClass::Initialize())
+	{
+		return 1;
+	}
+
+	// Warm up the ring of this thread so the first sample does not pay for handing it out.
+	RunCase(CASE_SCOPED_ZONE, 1000);
+
+	counterTime = TimeCase(CASE_COUNTER_READS, zoneCount, iterations);
+	scopedTime = TimeCase(CASE_SCOPED_ZONE, zoneCount, iterations);
+	phaseTime = TimeCase(CASE_PHASE_ZONE, zoneCount, iterations);
+
+	CpuProfilerClass::Shutdown();
+
+	disabledTime = TimeCase(CASE_DISABLED_ZONE, zoneCount, iterations);
+
+	printf("cpu zone cost, %d zones, median of %d\n", zoneCount, iterations);
+	printf("  two counter reads  %7.2f ns\n", counterTime);
+	printf("  scoped zone        %7.2f ns  %s the %.0f ns target\n", scopedTime, (scopedTime < ZONE_TARGET_NS) ? "under" : "over",
+		   ZONE_TARGET_NS);
+	printf("  phase zone         %7.2f ns  %s the %.0f ns target\n", phaseTime, (phaseTime < ZONE_TARGET_NS) ? "under" : "over",
+		   ZONE_TARGET_NS);
+	printf("  profiler off       %7.2f ns\n", disabledTime);
+
+	return 0;
+}
\ No newline at end of file
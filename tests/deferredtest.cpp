@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: deferredtest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Renders the game headless with deferred shading on and follows the deferred pass through the null device command
+// list.  The G-buffer must be three targets in the documented formats, the geometry pass must draw into all three at
+// once and the lighting pass must light the screen with a single fullscreen draw with the depth test off, reading the
+// three targets only once they are no longer bound.
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <algorithm>
+#include <vector>
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "graphicsclass.h"
+#include "nulldeviceclass.h"
+#include "deferredbuffersclass.h"
+#include "testscene.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int TEST_SCREEN_WIDTH = 320;
+const int TEST_SCREEN_HEIGHT = 180;
+const int TEST_FRAME_COUNT = 3;
+
+
+static bool IsDraw(const NullDeviceClass::CommandType* command)
+{
+	return command->code == NullDeviceClass::COMMAND_DRAW_INDEXED || command->code == NullDeviceClass::COMMAND_DRAW_INDEXED_INSTANCED ||
+		   command->code == NullDeviceClass::COMMAND_DRAW;
+}
+
+
+static void CheckDeferredFrame(NullDeviceClass* device)
+{
+	const NullDeviceClass::CommandType* command;
+	vector<int> targets, lightTextures;
+	int i, commandCount, geometryStart, geometryEnd, lightStart, lightEnd, geometryDraws, lightDraws;
+
+
+	commandCount = device->GetCommandCount();
+
+	// The geometry pass starts where the three G-buffer targets are bound.
+	geometryStart = -1;
+	for(i=0; i<commandCount && geometryStart<0; i++)
+	{
+		command = device->GetCommand(i);
+		if(command->code == NullDeviceClass::COMMAND_SET_RENDER_TARGETS && command->arg0 == DEFERRED_BUFFER_COUNT)
+		{
+			geometryStart = i;
+		}
+	}
+
+	CHECK(geometryStart >= 0);
+	if(geometryStart < 0)
+	{
+		return;
+	}
+
+	// It ends where the scene targets are bound again, in between the G-buffer targets are cleared and drawn into.
+	geometryEnd = commandCount;
+	geometryDraws = 0;
+	for(i=geometryStart+1; i<commandCount && geometryEnd==commandCount; i++)
+	{
+		command = device->GetCommand(i);
+		if(command->code == NullDeviceClass::COMMAND_SET_RENDER_TARGETS)
+		{
+			geometryEnd = i;
+		}
+		if(command->code == NullDeviceClass::COMMAND_CLEAR_RENDER_TARGET)
+		{
+			targets.push_back(command->arg0);
+		}
+		if(IsDraw(command))
+		{
+			geometryDraws++;
+		}
+	}
+
+	CHECK(geometryDraws > 0);
+	CHECK(geometryEnd < commandCount);
+
+	// The three cleared targets are the G-buffer in the order of the buffer types, the first of them is the one bound
+	// first.  Each has the documented format.
+	CHECK(targets.size() == DEFERRED_BUFFER_COUNT);
+	if(targets.size() != DEFERRED_BUFFER_COUNT)
+	{
+		return;
+	}
+
+	CHECK(device->GetCommand(geometryStart)->arg1 == targets[DeferredBuffersClass::BUFFER_COLOR]);
+	CHECK(targets[0] != targets[1] && targets[1] != targets[2] && targets[0] != targets[2]);
+	CHECK(device->GetRenderTargetFormat(targets[DeferredBuffersClass::BUFFER_COLOR]) == RenderDeviceClass::RENDER_TARGET_RGBA8);
+	CHECK(device->GetRenderTargetFormat(targets[DeferredBuffersClass::BUFFER_NORMAL]) == RenderDeviceClass::RENDER_TARGET_RG16_SNORM);
+	CHECK(device->GetRenderTargetFormat(targets[DeferredBuffersClass::BUFFER_DEPTH]) == RenderDeviceClass::RENDER_TARGET_R32_FLOAT);
+
+	// The lighting pass turns the depth test off right after the geometry pass and runs up to the next depth state.
+	lightStart = -1;
+	for(i=geometryEnd+1; i<commandCount && lightStart<0; i++)
+	{
+		command = device->GetCommand(i);
+		if(command->code == NullDeviceClass::COMMAND_SET_DEPTH_STATE)
+		{
+			CHECK(command->arg0 == RenderDeviceClass::DEPTH_STATE_DISABLED);
+			lightStart = i;
+		}
+	}
+
+	CHECK(lightStart >= 0);
+	if(lightStart < 0)
+	{
+		return;
+	}
+
+	lightEnd = commandCount;
+	lightDraws = 0;
+	for(i=lightStart+1; i<commandCount && lightEnd==commandCount; i++)
+	{
+		command = device->GetCommand(i);
+		if(command->code == NullDeviceClass::COMMAND_SET_DEPTH_STATE)
+		{
+			lightEnd = i;
+		}
+		if(command->code == NullDeviceClass::COMMAND_SET_TEXTURE)
+		{
+			lightTextures.push_back(command->arg1);
+		}
+		if(IsDraw(command))
+		{
+			// A fullscreen triangle.
+			CHECK(command->code == NullDeviceClass::COMMAND_DRAW && command->arg0 == 3);
+			lightDraws++;
+		}
+	}
+
+	CHECK(lightDraws == 1);
+
+	// The light pass reads all three targets.
+	CHECK(find(lightTextures.begin(), lightTextures.end(), targets[0]) != lightTextures.end());
+	CHECK(find(lightTextures.begin(), lightTextures.end(), targets[1]) != lightTextures.end());
+	CHECK(find(lightTextures.begin(), lightTextures.end(), targets[2]) != lightTextures.end());
+
+	return;
+}
+
+
+static void TestDeferredShading()
+{
+	GraphicsClass graphics;
+	NullDeviceClass* device;
+	int i, resourceCount;
+	bool result;
+
+
+	CHECK(SetTestScene(graphics, "deferredtest"));
+
+	result = graphics.InitializeHeadless(TEST_SCREEN_WIDTH, TEST_SCREEN_HEIGHT);
+	CHECK(result);
+	if(!result)
+	{
+		graphics.Shutdown();
+		return;
+	}
+
+	device = (NullDeviceClass*)graphics.GetRenderDevice();
+
+	// Turning deferred shading on creates the G-buffer.
+	resourceCount = device->GetResourceCount();
+	CHECK(graphics.SetDeferredShading(true));
+	CHECK(device->GetResourceCount() >= resourceCount + DEFERRED_BUFFER_COUNT);
+
+	for(i=0; i<TEST_FRAME_COUNT; i++)
+	{
+		CHECK(graphics.Frame(0));
+		CheckDeferredFrame(device);
+
+		// No pass samples a target while it is bound for drawing.
+		CHECK(device->GetTargetConflictCount() == 0);
+	}
+
+	graphics.Shutdown();
+
+	return;
+}
+
+
+int main()
+{
+	TestDeferredShading();
+
+	return TestResult("deferredtest");
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: framestatstest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Checks the frame time statistics on known sequences: the nearest rank percentiles, the minimum, mean and maximum and
+// the frames over budget, including once the window is full and the oldest frames drop out of it.
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "framestatsclass.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const double TEST_BUDGET = 10.0;
+
+
+static void TestPercentiles()
+{
+	FrameStatsClass stats;
+	FrameStatsClass::SummaryType summary;
+	int i;
+
+
+	CHECK(!stats.Initialize(0, TEST_BUDGET));
+	CHECK(!stats.Initialize(100, 0.0));
+	CHECK(stats.Initialize(100, TEST_BUDGET));
+
+	// An empty window reads as zero.
+	CHECK(stats.GetFrameCount() == 0);
+	CHECK(stats.GetPercentile(50.0) == 0.0 && stats.GetMinimum() == 0.0 && stats.GetMaximum() == 0.0 && stats.GetMean() == 0.0);
+
+	// Add the frame times 1 to 100 out of order.
+	for(i=0; i<100; i++)
+	{
+		stats.AddFrame((double)((i * 37) % 100 + 1));
+	}
+
+	CHECK(stats.GetFrameCount() == 100);
+	CHECK(stats.GetTotalFrameCount() == 100);
+	CHECK(stats.GetMinimum() == 1.0);
+	CHECK(stats.GetMaximum() == 100.0);
+	CHECK_NEAR(stats.GetMean(), 50.5, 1e-9);
+
+	// With 100 frames the nearest rank of a percentile is the frame time of the same number.
+	CHECK(stats.GetPercentile(50.0) == 50.0);
+	CHECK(stats.GetPercentile(95.0) == 95.0);
+	CHECK(stats.GetPercentile(99.0) == 99.0);
+	CHECK(stats.GetPercentile(100.0) == 100.0);
+	CHECK(stats.GetPercentile(0.0) == 1.0);
+	CHECK(stats.GetPercentile(94.5) == 95.0);
+
+	// The frames from 11 up are over the budget of 10.
+	CHECK(stats.GetOverBudgetCount() == 90);
+	CHECK(stats.GetTotalOverBudgetCount() == 90);
+
+	stats.GetSummary(summary);
+	CHECK(summary.frameCount == 100);
+	CHECK(summary.minimum == 1.0 && summary.maximum == 100.0);
+	CHECK(summary.median == 50.0 && summary.percentile95 == 95.0 && summary.percentile99 == 99.0);
+	CHECK_NEAR(summary.mean, 50.5, 1e-9);
+	CHECK(summary.overBudgetCount == 90);
+
+	stats.Shutdown();
+
+	// With 10 frames the 95th and 99th percentiles round up to the slowest frame.
+	CHECK(stats.Initialize(10, TEST_BUDGET));
+	for(i=10; i>0; i--)
+	{
+		stats.AddFrame((double)i);
+	}
+
+	CHECK(stats.GetPercentile(50.0) == 5.0);
+	CHECK(stats.GetPercentile(95.0) == 10.0);
+	CHECK(stats.GetPercentile(99.0) == 10.0);
+	CHECK(stats.GetPercentile(1.0) == 1.0);
+	CHECK(stats.GetOverBudgetCount() == 0);
+
+	stats.Shutdown();
+
+	return;
+}
+
+
+static void TestWrap()
+{
+	FrameStatsClass stats;
+	int i;
+
+
+	CHECK(stats.Initialize(8, TEST_BUDGET));
+
+	// Fill the window with slow frames, then push all of them out with fast ones.
+	for(i=0; i<8; i++)
+	{
+		stats.AddFrame(100.0 + (double)i);
+	}
+
+	CHECK(stats.GetOverBudgetCount() == 8);
+	CHECK(stats.GetMaximum() == 107.0);
+
+	for(i=1; i<=4; i++)
+	{
+		stats.AddFrame((double)i);
+	}
+
+	// Half way the window holds the four newest slow frames and the four fast ones.
+	CHECK(stats.GetFrameCount() == 8);
+	CHECK(stats.GetMinimum() == 1.0);
+	CHECK(stats.GetMaximum() == 107.0);
+	CHECK(stats.GetPercentile(50.0) == 4.0);
+	CHECK(stats.GetPercentile(62.5) == 104.0);
+	CHECK_NEAR(stats.GetMean(), (1.0 + 2.0 + 3.0 + 4.0 + 104.0 + 105.0 + 106.0 + 107.0) / 8.0, 1e-9);
+	CHECK(stats.GetOverBudgetCount() == 4);
+
+	for(i=5; i<=8; i++)
+	{
+		stats.AddFrame((double)i);
+	}
+
+	// Every slow frame has left the window, only the totals remember them.
+	CHECK(stats.GetFrameCount() == 8);
+	CHECK(stats.GetTotalFrameCount() == 16);
+	CHECK(stats.GetMinimum() == 1.0);
+	CHECK(stats.GetMaximum() == 8.0);
+	CHECK(stats.GetPercentile(50.0) == 4.0);
+	CHECK(stats.GetPercentile(95.0) == 8.0);
+	CHECK(stats.GetPercentile(99.0) == 8.0);
+	CHECK_NEAR(stats.GetMean(), 4.5, 1e-9);
+	CHECK(stats.GetOverBudgetCount() == 0);
+	CHECK(stats.GetTotalOverBudgetCount() == 8);
+
+	stats.Shutdown();
+
+	// Equal frame times leave the window one at a time.
+	CHECK(stats.Initialize(3, TEST_BUDGET));
+	stats.AddFrame(2.0);
+	stats.AddFrame(2.0);
+	stats.AddFrame(2.0);
+	stats.AddFrame(50.0);
+	CHECK(stats.GetFrameCount() == 3);
+	CHECK(stats.GetMinimum() == 2.0 && stats.GetMaximum() == 50.0);
+	CHECK(stats.GetPercentile(50.0) == 2.0);
+	CHECK(stats.GetPercentile(99.0) == 50.0);
+
+	stats.AddFrame(50.0);
+	stats.AddFrame(50.0);
+	CHECK(stats.GetMinimum() == 50.0);
+	CHECK(stats.GetPercentile(50.0) == 50.0);
+	CHECK(stats.GetOverBudgetCount() == 3);
+
+	// A reset empties the window and the totals.
+	stats.Reset();
+	CHECK(stats.GetFrameCount() == 0 && stats.GetTotalFrameCount() == 0);
+	CHECK(stats.GetOverBudgetCount() == 0 && stats.GetTotalOverBudgetCount() == 0);
+	stats.AddFrame(7.0);
+	CHECK(stats.GetPercentile(99.0) == 7.0 && stats.GetMean() == 7.0);
+
+	stats.Shutdown();
+
+	return;
+}
+
+
+int main()
+{
+	TestPercentiles();
+	TestWrap();
+
+	return TestResult("framestatstest");
+}
\ No newline at end of file
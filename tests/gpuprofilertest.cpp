@@ -0,0 +1,263 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: gpuprofilertest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Drives GpuProfilerClass with the fake timestamps of the null device, where every drawn index is one nanosecond, and
+// checks the query latency, the wraparound of the query ring, dropped and disjoint frames and the rolling averages.
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "nulldeviceclass.h"
+#include "gpuprofilerclass.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const float TIME_TOLERANCE = 1e-5f;
+const int PASS_A_INDICES = 1000000;
+const int PASS_B_INDICES = 250000;
+const int UNTRACKED_INDICES = 7;
+
+
+static void RenderFrame(NullDeviceClass& device, GpuProfilerClass& profiler, int passA, int passB)
+{
+	// Pass a, some untracked work between the passes and pass b when it has anything to draw.
+	profiler.BeginFrame();
+	device.BeginScene(0.0f, 0.0f, 0.0f, 1.0f);
+
+	profiler.BeginPass("a");
+	device.DrawIndexed(passA);
+	profiler.EndPass();
+
+	device.DrawIndexed(UNTRACKED_INDICES);
+
+	if(passB > 0)
+	{
+		profiler.BeginPass("b");
+		device.DrawIndexed(passB);
+		device.Draw(passB);
+		profiler.EndPass();
+	}
+
+	profiler.EndFrame();
+	device.EndScene();
+
+	return;
+}
+
+
+static void TestLatency()
+{
+	NullDeviceClass device;
+	GpuProfilerClass profiler;
+	int frame;
+
+
+	CHECK(device.Initialize(800, 600, 1000.0f, 0.1f, false));
+	CHECK(profiler.Initialize(&device));
+	CHECK(device.GetResourceCount() > 0);
+
+	// Nothing is read back before the queries are NULL_QUERY_LATENCY frames old, after that one frame per frame.
+	for(frame=0; frame<12; frame++)
+	{
+		RenderFrame(device, profiler, PASS_A_INDICES, 0);
+
+		CHECK(profiler.GetFrameIndex() == frame + 1);
+		CHECK(profiler.GetReadFrameIndex() == ((frame + 1 > NULL_QUERY_LATENCY) ? frame + 1 - NULL_QUERY_LATENCY : 0));
+		CHECK(profiler.GetCompletedFrameCount() == profiler.GetReadFrameIndex());
+	}
+
+	CHECK(profiler.GetDroppedFrameCount() == 0);
+	CHECK(profiler.GetDisjointFrameCount() == 0);
+
+	// The queries of the ring are released with the profiler.
+	profiler.Shutdown();
+	CHECK(device.GetResourceCount() == 0);
+	device.Shutdown();
+
+	return;
+}
+
+
+static void TestAggregation()
+{
+	NullDeviceClass device;
+	GpuProfilerClass profiler;
+	float time, expected;
+	int frame;
+
+
+	CHECK(device.Initialize(800, 600, 1000.0f, 0.1f, false));
+	CHECK(profiler.Initialize(&device));
+	device.SetQueryLatency(1);
+
+	CHECK(profiler.GetPassTime(0) == 0.0f);
+	CHECK(profiler.GetFrameTime() == 0.0f);
+
+	// Pass b only runs on odd frames.  With a latency of one, frames 0 to 8 have been read after ten frames.
+	for(frame=0; frame<10; frame++)
+	{
+		RenderFrame(device, profiler, PASS_A_INDICES, (frame & 1) ? PASS_B_INDICES : 0);
+	}
+
+	CHECK(profiler.GetCompletedFrameCount() == 9);
+	CHECK(profiler.GetPassCount() == 2);
+	CHECK(profiler.GetPassName(0) != 0 && profiler.GetPassName(0)[0] == 'a');
+	CHECK(profiler.GetPassName(1) != 0 && profiler.GetPassName(1)[0] == 'b');
+	CHECK(profiler.GetPassName(2) == 0);
+
+	// A frame without pass b counts as zero for it, four of the nine frames read had it.
+	CHECK_NEAR(profiler.GetPassTime(0), 1.0f, TIME_TOLERANCE);
+	CHECK_NEAR(profiler.GetPassTime(1), 0.5f * 4.0f / 9.0f, TIME_TOLERANCE);
+	CHECK_NEAR(profiler.GetLastPassTime(0), 1.0f, TIME_TOLERANCE);
+	CHECK_NEAR(profiler.GetLastPassTime(1), 0.0f, TIME_TOLERANCE);
+
+	// The frame covers the passes and the untracked work between them.
+	expected = 1.0f + (float)UNTRACKED_INDICES * 1e-6f;
+	CHECK_NEAR(profiler.GetLastFrameTime(), expected, TIME_TOLERANCE);
+	CHECK_NEAR(profiler.GetFrameTime(), expected + 0.5f * 4.0f / 9.0f, TIME_TOLERANCE);
+
+	CHECK(profiler.GetRecordedFrameTime(7, time));
+	CHECK_NEAR(time, expected + 0.5f, TIME_TOLERANCE);
+	CHECK(!profiler.GetRecordedFrameTime(9, time));
+
+	// A pass drawn twice in one frame is added up.
+	profiler.BeginFrame();
+	device.BeginScene(0.0f, 0.0f, 0.0f, 1.0f);
+	profiler.BeginPass("a");
+	device.DrawIndexed(PASS_A_INDICES);
+	profiler.BeginPass("b");
+	device.DrawIndexed(PASS_B_INDICES);
+	profiler.BeginPass("a");
+	device.DrawIndexed(PASS_A_INDICES);
+	profiler.EndFrame();
+	device.EndScene();
+	RenderFrame(device, profiler, PASS_A_INDICES, 0);
+
+	CHECK_NEAR(profiler.GetLastPassTime(0), 2.0f, TIME_TOLERANCE);
+	CHECK_NEAR(profiler.GetLastPassTime(1), 0.25f, TIME_TOLERANCE);
+
+	// Once the window has wrapped around only the last GPU_PROFILER_HISTORY frames count and the old ones are gone.
+	for(frame=0; frame<GPU_PROFILER_HISTORY + 1; frame++)
+	{
+		RenderFrame(device, profiler, 2 * PASS_A_INDICES, 0);
+	}
+
+	CHECK_NEAR(profiler.GetPassTime(0), 2.0f, TIME_TOLERANCE);
+	CHECK_NEAR(profiler.GetPassTime(1), 0.0f, TIME_TOLERANCE);
+	CHECK(!profiler.GetRecordedFrameTime(7, time));
+	CHECK(profiler.GetRecordedFrameTime(profiler.GetReadFrameIndex() - 1, time));
+	CHECK(profiler.GetRecordedFrameTime(profiler.GetReadFrameIndex() - GPU_PROFILER_HISTORY, time));
+	CHECK(!profiler.GetRecordedFrameTime(profiler.GetReadFrameIndex() - GPU_PROFILER_HISTORY - 1, time));
+
+	profiler.Shutdown();
+	device.Shutdown();
+
+	return;
+}
+
+
+static void TestDroppedFrames()
+{
+	NullDeviceClass device;
+	GpuProfilerClass profiler;
+	int frame, completed;
+
+
+	CHECK(device.Initialize(800, 600, 1000.0f, 0.1f, false));
+	CHECK(profiler.Initialize(&device));
+
+	// A GPU as far behind as the ring is deep still gets every frame read just in time.
+	device.SetQueryLatency(GPU_PROFILER_FRAMES);
+	for(frame=0; frame<20; frame++)
+	{
+		RenderFrame(device, profiler, PASS_A_INDICES, 0);
+	}
+
+	CHECK(profiler.GetDroppedFrameCount() == 0);
+	CHECK(profiler.GetCompletedFrameCount() == 20 - GPU_PROFILER_FRAMES);
+
+	// One frame further behind and the oldest slot is never ready when it is needed, every frame is dropped.
+	completed = profiler.GetCompletedFrameCount();
+	device.SetQueryLatency(GPU_PROFILER_FRAMES + 1);
+	for(frame=0; frame<20; frame++)
+	{
+		RenderFrame(device, profiler, PASS_A_INDICES, 0);
+	}
+
+	CHECK(profiler.GetDroppedFrameCount() == 20);
+	CHECK(profiler.GetCompletedFrameCount() == completed);
+	CHECK(profiler.GetFrameIndex() - profiler.GetReadFrameIndex() <= GPU_PROFILER_FRAMES);
+
+	// The profiler recovers when the GPU catches up.
+	device.SetQueryLatency(1);
+	for(frame=0; frame<10; frame++)
+	{
+		RenderFrame(device, profiler, PASS_A_INDICES, 0);
+	}
+
+	CHECK(profiler.GetDroppedFrameCount() == 20);
+	CHECK(profiler.GetReadFrameIndex() == profiler.GetFrameIndex() - 1);
+	CHECK_NEAR(profiler.GetPassTime(0), 1.0f, TIME_TOLERANCE);
+
+	profiler.Shutdown();
+	device.Shutdown();
+
+	return;
+}
+
+
+static void TestDisjointFrames()
+{
+	NullDeviceClass device;
+	GpuProfilerClass profiler;
+	float passTime, frameTime;
+	int frame, completed;
+
+
+	CHECK(device.Initialize(800, 600, 1000.0f, 0.1f, false));
+	CHECK(profiler.Initialize(&device));
+	device.SetQueryLatency(1);
+
+	for(frame=0; frame<5; frame++)
+	{
+		RenderFrame(device, profiler, PASS_A_INDICES, PASS_B_INDICES);
+	}
+
+	completed = profiler.GetCompletedFrameCount();
+	passTime = profiler.GetPassTime(0);
+	frameTime = profiler.GetFrameTime();
+
+	// Frames timed while the clock frequency was unknown are read but leave the averages alone.  The last frame before the
+	// switch and two of the three after it are read by now.
+	device.SetTimestampFrequency(0);
+	for(frame=0; frame<3; frame++)
+	{
+		RenderFrame(device, profiler, 3 * PASS_A_INDICES, 0);
+	}
+
+	CHECK(profiler.GetDisjointFrameCount() == 2);
+	CHECK(profiler.GetCompletedFrameCount() == completed + 1);
+	CHECK(profiler.GetPassTime(0) == passTime);
+	CHECK(profiler.GetFrameTime() == frameTime);
+	CHECK(profiler.GetDroppedFrameCount() == 0);
+
+	profiler.Shutdown();
+	device.Shutdown();
+
+	return;
+}
+
+
+int main()
+{
+	TestLatency();
+	TestAggregation();
+	TestDroppedFrames();
+	TestDisjointFrames();
+
+	return TestResult("gpuprofilertest");
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: graphicstest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Runs the whole renderer on the null device with the game scene and checks what each frame sends to the device: the
+// draws the statistics count are the draws in the command list, the sorted draws share a handful of pipelines, the
+// depth prepass draws every object under the prepass state before the main pass draws it again under EQUAL, and no
+// pass reads a target it is drawing to.
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "graphicsclass.h"
+#include "nulldeviceclass.h"
+#include "testscene.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int TEST_SCREEN_WIDTH = 640;
+const int TEST_SCREEN_HEIGHT = 360;
+const int TEST_FRAME_COUNT = 4;
+
+
+static void CountDraws(NullDeviceClass* device, int& drawCount, int& depthStateCount, int& prepassDraws, int& equalDraws,
+					   int& equalBeforePrepass)
+{
+	const NullDeviceClass::CommandType* command;
+	int i, depthState;
+
+
+	drawCount = 0;
+	depthStateCount = 0;
+	prepassDraws = 0;
+	equalDraws = 0;
+	equalBeforePrepass = 0;
+	depthState = -1;
+
+	// Walk the command list keeping track of the depth state each draw was made under.
+	for(i=0; i<device->GetCommandCount(); i++)
+	{
+		command = device->GetCommand(i);
+		if(command->code == NullDeviceClass::COMMAND_SET_DEPTH_STATE)
+		{
+			depthState = command->arg0;
+			depthStateCount++;
+		}
+
+		if(command->code == NullDeviceClass::COMMAND_DRAW_INDEXED || command->code == NullDeviceClass::COMMAND_DRAW_INDEXED_INSTANCED ||
+		   command->code == NullDeviceClass::COMMAND_DRAW)
+		{
+			drawCount++;
+			if(depthState == RenderDeviceClass::DEPTH_STATE_PREPASS)
+			{
+				prepassDraws++;
+			}
+			if(depthState == RenderDeviceClass::DEPTH_STATE_EQUAL)
+			{
+				equalDraws++;
+				if(prepassDraws == 0)
+				{
+					equalBeforePrepass++;
+				}
+			}
+		}
+	}
+
+	return;
+}
+
+
+static void TestFrames()
+{
+	GraphicsClass graphics;
+	NullDeviceClass* device;
+	RenderDeviceClass::StatisticsType statistics;
+	int i, drawCount, depthStateCount, prepassDraws, equalDraws, equalBeforePrepass;
+	bool result;
+
+
+	CHECK(SetTestScene(graphics, "graphicstest"));
+
+	result = graphics.InitializeHeadless(TEST_SCREEN_WIDTH, TEST_SCREEN_HEIGHT);
+	CHECK(result);
+	if(!result)
+	{
+		graphics.Shutdown();
+		return;
+	}
+
+	device = (NullDeviceClass*)graphics.GetRenderDevice();
+	CHECK(device != 0 && graphics.GetSoftwareDevice() == 0);
+
+	for(i=0; i<TEST_FRAME_COUNT; i++)
+	{
+		CHECK(graphics.Frame(0));
+
+		device->GetStatistics(statistics);
+		CountDraws(device, drawCount, depthStateCount, prepassDraws, equalDraws, equalBeforePrepass);
+
+		// The statistics count what the command list holds.
+		CHECK(statistics.drawCalls > 0);
+		CHECK(statistics.drawCalls == drawCount);
+		CHECK(statistics.indexCount > 0);
+		CHECK(statistics.depthStateChanges == depthStateCount);
+
+		// The draws are sorted by pipeline, so far fewer pipelines are bound than there are draws.
+		CHECK(statistics.pipelineChanges > 0);
+		CHECK(statistics.pipelineChanges < statistics.drawCalls / 4);
+		CHECK(statistics.shaderChanges > 0);
+		CHECK(statistics.renderTargetChanges > 0);
+
+		// The prepass lays down the depth of every object, the main pass then shades each one once under EQUAL.
+		CHECK(prepassDraws > 0);
+		CHECK(equalDraws == prepassDraws);
+		CHECK(equalBeforePrepass == 0);
+
+		CHECK(device->GetTargetConflictCount() == 0);
+	}
+
+	graphics.Shutdown();
+
+	return;
+}
+
+
+int main()
+{
+	TestFrames();
+
+	return TestResult("graphicstest");
+}
\ No newline at end of file
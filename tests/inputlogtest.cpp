@@ -0,0 +1,317 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: inputlogtest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Records a run of input snapshots to a log and plays it back, which must give the same snapshots, keys, sample times,
+// mouse movements and frame times.  A log cut short, or with the wrong magic or version, must be refused.  The game is
+// then replayed headless twice from one log, and both replays must fly the viewer along the same poses and submit the
+// same draws every frame.
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <vector>
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "inputlogclass.h"
+#include "graphicsclass.h"
+#include "nulldeviceclass.h"
+#include "testscene.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int TEST_SCREEN_WIDTH = 320;
+const int TEST_SCREEN_HEIGHT = 180;
+const int LOG_FRAME_COUNT = 40;
+const int REPLAY_FRAME_COUNT = 120;
+const double LOG_FRAME_TIME = 16.0;
+
+
+struct ReplayFrameType
+{
+	XMFLOAT3 position, rotation;
+	int drawCalls, indexCount;
+};
+
+
+// Builds the snapshot of a made up frame: a few samples spread over the frame with keys that change as the frames go
+// on, and mouse movements of both signs.
+static void BuildSnapshot(InputSnapshotClass& snapshot, int frame)
+{
+	InputSnapshotClass::SampleType sample;
+	unsigned int baseKeys;
+	int i, sampleCount;
+
+
+	baseKeys = ((frame / 10) % 2 == 0) ? InputSnapshotClass::GetKeyBit(InputSnapshotClass::KEY_W) : 0;
+	sampleCount = frame % 4;
+
+	snapshot.Begin((unsigned int)frame, baseKeys);
+	for(i=0; i<sampleCount; i++)
+	{
+		sample.time = (double)frame * LOG_FRAME_TIME + (double)(i + 1) * 3.5;
+		sample.keys = baseKeys | (((frame + i) % 3 == 0) ? InputSnapshotClass::GetKeyBit(InputSnapshotClass::KEY_A) : 0);
+		sample.mouseDeltaX = (frame * 7 + i) % 23 - 11;
+		sample.mouseDeltaY = -((frame * 5 + i) % 17);
+		snapshot.AddSample(sample);
+	}
+	snapshot.End((double)(frame + 1) * LOG_FRAME_TIME, 400 + frame * 3, 300 - frame);
+
+	return;
+}
+
+
+static bool WriteLog(const char* filename, int frameCount)
+{
+	InputLogClass log;
+	InputSnapshotClass snapshot;
+	int i;
+
+
+	if(!log.StartRecording(filename, 1.0f, 15.0f, -200.0f, 0.0f, 10.0f, 0.0f))
+	{
+		return false;
+	}
+
+	for(i=0; i<frameCount; i++)
+	{
+		BuildSnapshot(snapshot, i);
+		if(!log.RecordFrame(snapshot, (float)LOG_FRAME_TIME + (float)(i % 3)))
+		{
+			return false;
+		}
+	}
+
+	log.Shutdown();
+
+	return true;
+}
+
+
+static void TestRoundTrip()
+{
+	InputLogClass log;
+	InputSnapshotClass snapshot;
+	const InputSnapshotClass* replayed;
+	const InputSnapshotClass::SampleType* sample;
+	const InputSnapshotClass::SampleType* replayedSample;
+	char filename[SCENE_MAX_PATH];
+	float frameTime, positionX, positionY, positionZ, rotationX, rotationY, rotationZ;
+	int i, j, mouseX, mouseY, replayedX, replayedY;
+
+
+	GetOutputPath("inputlogtest.log", filename, sizeof(filename));
+	CHECK(WriteLog(filename, LOG_FRAME_COUNT));
+
+	CHECK(log.StartReplay(filename));
+	CHECK(log.IsReplaying() && !log.IsRecording());
+	CHECK(log.GetFrameCount() == LOG_FRAME_COUNT);
+
+	// The replay starts from the pose the recording started from.
+	log.GetStartCamera(positionX, positionY, positionZ, rotationX, rotationY, rotationZ);
+	CHECK(positionX == 1.0f && positionY == 15.0f && positionZ == -200.0f);
+	CHECK(rotationX == 0.0f && rotationY == 10.0f && rotationZ == 0.0f);
+
+	// Every frame comes back exactly as it was recorded.
+	for(i=0; i<LOG_FRAME_COUNT; i++)
+	{
+		BuildSnapshot(snapshot, i);
+
+		CHECK(log.ReplayFrame(frameTime));
+		CHECK(frameTime == (float)LOG_FRAME_TIME + (float)(i % 3));
+
+		replayed = &log.GetSnapshot();
+		CHECK(replayed->GetFrame() == (unsigned int)i);
+		CHECK(replayed->GetTime() == snapshot.GetTime());
+		CHECK(replayed->GetBaseKeys() == snapshot.GetBaseKeys());
+		CHECK(replayed->GetKeys() == snapshot.GetKeys());
+		CHECK(replayed->GetSampleCount() == snapshot.GetSampleCount());
+
+		for(j=0; j<snapshot.GetSampleCount() && j<replayed->GetSampleCount(); j++)
+		{
+			sample = &snapshot.GetSample(j);
+			replayedSample = &replayed->GetSample(j);
+			CHECK(replayedSample->time == sample->time);
+			CHECK(replayedSample->keys == sample->keys);
+			CHECK(replayedSample->mouseDeltaX == sample->mouseDeltaX);
+			CHECK(replayedSample->mouseDeltaY == sample->mouseDeltaY);
+		}
+
+		snapshot.GetMouseLocation(mouseX, mouseY);
+		replayed->GetMouseLocation(replayedX, replayedY);
+		CHECK(replayedX == mouseX && replayedY == mouseY);
+
+		snapshot.GetMouseDelta(mouseX, mouseY);
+		replayed->GetMouseDelta(replayedX, replayedY);
+		CHECK(replayedX == mouseX && replayedY == mouseY);
+	}
+
+	// The replay ends once the log runs out.
+	CHECK(!log.ReplayFrame(frameTime));
+	CHECK(!log.IsReplaying());
+
+	log.Shutdown();
+
+	return;
+}
+
+
+static bool WriteBytes(const char* filename, const vector<char>& bytes)
+{
+	ofstream fout;
+
+
+	fout.open(filename, ios::out | ios::binary);
+	fout.write(bytes.data(), bytes.size());
+	fout.close();
+
+	return !fout.fail();
+}
+
+
+static void TestDamagedLogs()
+{
+	InputLogClass log;
+	ifstream fin;
+	vector<char> bytes, damaged;
+	char filename[SCENE_MAX_PATH], damagedFilename[SCENE_MAX_PATH];
+	unsigned int version;
+
+
+	GetOutputPath("inputlogtest.log", filename, sizeof(filename));
+	GetOutputPath("inputlogtest.damaged.log", damagedFilename, sizeof(damagedFilename));
+	CHECK(WriteLog(filename, LOG_FRAME_COUNT));
+
+	fin.open(filename, ios::in | ios::binary);
+	bytes.assign(istreambuf_iterator<char>(fin), istreambuf_iterator<char>());
+	fin.close();
+	CHECK(bytes.size() > 64);
+
+	// A missing file is refused.
+	CHECK(!log.StartReplay("missing.log"));
+
+	// A log cut short in the last frame, in the first frame or in the header is refused.
+	damaged.assign(bytes.begin(), bytes.end() - 3);
+	CHECK(WriteBytes(damagedFilename, damaged));
+	CHECK(!log.StartReplay(damagedFilename));
+	CHECK(!log.IsReplaying() && log.GetFrameCount() == 0);
+
+	damaged.assign(bytes.begin(), bytes.begin() + sizeof(INPUT_LOG_MAGIC) + sizeof(version) + 6 * sizeof(float) + 5);
+	CHECK(WriteBytes(damagedFilename, damaged));
+	CHECK(!log.StartReplay(damagedFilename));
+
+	damaged.assign(bytes.begin(), bytes.begin() + 6);
+	CHECK(WriteBytes(damagedFilename, damaged));
+	CHECK(!log.StartReplay(damagedFilename));
+
+	// A log with a different magic or a different version is refused.
+	damaged = bytes;
+	damaged[0] = 'X';
+	CHECK(WriteBytes(damagedFilename, damaged));
+	CHECK(!log.StartReplay(damagedFilename));
+
+	damaged = bytes;
+	version = INPUT_LOG_VERSION + 1;
+	memcpy(&damaged[sizeof(INPUT_LOG_MAGIC)], &version, sizeof(version));
+	CHECK(WriteBytes(damagedFilename, damaged));
+	CHECK(!log.StartReplay(damagedFilename));
+
+	// The undamaged log still plays.
+	CHECK(WriteBytes(damagedFilename, bytes));
+	CHECK(log.StartReplay(damagedFilename));
+	CHECK(log.GetFrameCount() == LOG_FRAME_COUNT);
+
+	log.Shutdown();
+
+	return;
+}
+
+
+// Replays the log with the game headless and keeps the pose of the viewer and the draws of every frame.
+static bool ReplayGame(const char* filename, vector<ReplayFrameType>& frames)
+{
+	GraphicsClass graphics;
+	RenderDeviceClass::StatisticsType statistics;
+	ReplayFrameType frame;
+
+
+	frames.clear();
+
+	if(!SetTestScene(graphics, "inputlogtest") || !graphics.InitializeHeadless(TEST_SCREEN_WIDTH, TEST_SCREEN_HEIGHT) ||
+	   !graphics.StartInputReplay(filename))
+	{
+		graphics.Shutdown();
+		return false;
+	}
+
+	// The replay ends the game once the log runs out.
+	while(graphics.Frame(0))
+	{
+		graphics.GetRenderDevice()->GetStatistics(statistics);
+
+		frame.position = graphics.GetCamera()->GetPosition();
+		frame.rotation = graphics.GetCamera()->GetRotation();
+		frame.drawCalls = statistics.drawCalls;
+		frame.indexCount = statistics.indexCount;
+		frames.push_back(frame);
+	}
+
+	graphics.Shutdown();
+
+	return true;
+}
+
+
+static void TestReplayGame()
+{
+	vector<ReplayFrameType> first, second;
+	char filename[SCENE_MAX_PATH];
+	int i;
+
+
+	GetOutputPath("inputlogtest.replay.log", filename, sizeof(filename));
+	CHECK(WriteLog(filename, REPLAY_FRAME_COUNT));
+
+	CHECK(ReplayGame(filename, first));
+	CHECK(ReplayGame(filename, second));
+
+	// Every frame of the log is played once.
+	CHECK(first.size() == REPLAY_FRAME_COUNT);
+	CHECK(second.size() == first.size());
+	if(first.empty() || second.size() != first.size())
+	{
+		return;
+	}
+
+	// The keys in the log flew the viewer away from where it started.
+	CHECK(first.back().position.z != first.front().position.z);
+	CHECK(first.back().rotation.y != first.front().rotation.y);
+
+	// Both replays pass through the same poses and submit the same draws.
+	for(i=0; i<(int)first.size(); i++)
+	{
+		CHECK(memcmp(&first[i].position, &second[i].position, sizeof(XMFLOAT3)) == 0);
+		CHECK(memcmp(&first[i].rotation, &second[i].rotation, sizeof(XMFLOAT3)) == 0);
+		CHECK(first[i].drawCalls > 0);
+		CHECK(first[i].drawCalls == second[i].drawCalls);
+		CHECK(first[i].indexCount == second[i].indexCount);
+	}
+
+	return;
+}
+
+
+int main()
+{
+	TestRoundTrip();
+	TestDamagedLogs();
+	TestReplayGame();
+
+	return TestResult("inputlogtest");
+}
\ No newline at end of file
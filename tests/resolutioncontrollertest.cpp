@@ -0,0 +1,280 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: resolutioncontrollertest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Runs ResolutionControllerClass against a made up GPU whose frame time grows with the pixel count, steps the load up
+// and back down and checks the scale settles inside the dead band without overshooting or oscillating, moves no faster
+// than the step limits and always comes out the same for the same times.  DynamicResolutionClass is then driven through
+// the GPU profiler on the null device, where the frames only reach the controller a few frames late.
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <vector>
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "nulldeviceclass.h"
+#include "gpuprofilerclass.h"
+#include "dynamicresolutionclass.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const float FRAME_BUDGET = 16.667f;
+const float LIGHT_COST = 10.0f;
+const float HEAVY_COST = 30.0f;
+const float OVERLOAD_COST = 100.0f;
+const int LIGHT_FRAMES = 10;
+const int HEAVY_FRAMES = 60;
+const int RECOVERY_FRAMES = 60;
+const int SETTLE_LIMIT = 20;
+const int RECOVERY_LIMIT = 40;
+const float SCALE_TOLERANCE = 1e-5f;
+
+
+static float GetGpuTime(float cost, float scale)
+{
+	// The made up GPU spends all of its time on pixels.
+	return cost * scale * scale;
+}
+
+
+static void RunSteps(ResolutionControllerClass& controller, vector<float>& scales, vector<float>& times)
+{
+	float cost;
+	int frame;
+
+
+	// Light, then a step up to a load the full scale cannot hold, then back to light.
+	scales.clear();
+	times.clear();
+	for(frame=0; frame<LIGHT_FRAMES + HEAVY_FRAMES + RECOVERY_FRAMES; frame++)
+	{
+		cost = (frame >= LIGHT_FRAMES && frame < LIGHT_FRAMES + HEAVY_FRAMES) ? HEAVY_COST : LIGHT_COST;
+		times.push_back(GetGpuTime(cost, controller.GetScale()));
+		controller.Update(times.back());
+		scales.push_back(controller.GetScale());
+	}
+
+	return;
+}
+
+
+static void TestInitialize()
+{
+	ResolutionControllerClass controller;
+
+
+	CHECK(!controller.Initialize(0.0f, RESOLUTION_MIN_SCALE, RESOLUTION_MAX_SCALE));
+	CHECK(!controller.Initialize(FRAME_BUDGET, 0.0f, RESOLUTION_MAX_SCALE));
+	CHECK(!controller.Initialize(FRAME_BUDGET, RESOLUTION_MAX_SCALE, RESOLUTION_MIN_SCALE));
+	CHECK(controller.Initialize(FRAME_BUDGET, RESOLUTION_MIN_SCALE, RESOLUTION_MAX_SCALE));
+	CHECK(controller.GetScale() == RESOLUTION_MAX_SCALE);
+	CHECK(controller.GetBudget() == FRAME_BUDGET);
+
+	// A frame that could not be timed is ignored.
+	controller.Update(0.0f);
+	controller.Update(-1.0f);
+	CHECK(controller.GetScale() == RESOLUTION_MAX_SCALE);
+	CHECK(controller.GetAverageTime() == 0.0f);
+
+	// Reset keeps the scale in range.
+	controller.Reset(0.1f);
+	CHECK(controller.GetScale() == RESOLUTION_MIN_SCALE);
+	controller.Reset(2.0f);
+	CHECK(controller.GetScale() == RESOLUTION_MAX_SCALE);
+
+	return;
+}
+
+
+static void TestStepResponse()
+{
+	ResolutionControllerClass controller, repeat;
+	vector<float> scales, times, repeatScales, repeatTimes;
+	float aim, change;
+	int frame, lastChange, settledFrame, recoveredFrame;
+
+
+	CHECK(controller.Initialize(FRAME_BUDGET, RESOLUTION_MIN_SCALE, RESOLUTION_MAX_SCALE));
+	RunSteps(controller, scales, times);
+	aim = FRAME_BUDGET * RESOLUTION_HEADROOM;
+
+	// The light load fits at the full scale and nothing moves.
+	for(frame=0; frame<LIGHT_FRAMES; frame++)
+	{
+		CHECK(scales[frame] == RESOLUTION_MAX_SCALE);
+	}
+
+	// Every change stays within the step limits, and after a change the frames still in flight are left alone.
+	lastChange = -RESOLUTION_SETTLE_FRAMES - 1;
+	for(frame=1; frame<(int)scales.size(); frame++)
+	{
+		change = scales[frame] - scales[frame - 1];
+		CHECK(change >= -RESOLUTION_MAX_DECREASE - SCALE_TOLERANCE);
+		CHECK(change <= RESOLUTION_MAX_INCREASE + SCALE_TOLERANCE);
+		CHECK(scales[frame] >= RESOLUTION_MIN_SCALE && scales[frame] <= RESOLUTION_MAX_SCALE);
+
+		if(change != 0.0f)
+		{
+			CHECK(frame - lastChange > RESOLUTION_SETTLE_FRAMES);
+			lastChange = frame;
+		}
+	}
+
+	// The first heavy frame pulls the average half way up, and the pixel count is cut by how far that is over the aim.
+	CHECK_NEAR(scales[LIGHT_FRAMES], sqrtf(aim / (LIGHT_COST + (HEAVY_COST - LIGHT_COST) * RESOLUTION_RISE_SMOOTHING)), SCALE_TOLERANCE);
+
+	// Under the heavy load the scale only goes down and settles within the limit.
+	settledFrame = -1;
+	for(frame=LIGHT_FRAMES + 1; frame<LIGHT_FRAMES + HEAVY_FRAMES; frame++)
+	{
+		CHECK(scales[frame] <= scales[frame - 1]);
+		if(settledFrame < 0 && scales[frame] == scales[LIGHT_FRAMES + HEAVY_FRAMES - 1])
+		{
+			settledFrame = frame;
+		}
+	}
+
+	CHECK(settledFrame >= 0 && settledFrame - LIGHT_FRAMES <= SETTLE_LIMIT);
+
+	// Once settled the GPU time sits inside the dead band around the aim, under the budget, and the scale holds still.
+	for(frame=settledFrame + 1; frame<LIGHT_FRAMES + HEAVY_FRAMES; frame++)
+	{
+		CHECK(times[frame] >= aim * (1.0f - RESOLUTION_DEADBAND) && times[frame] <= aim * (1.0f + RESOLUTION_DEADBAND));
+		CHECK(times[frame] < FRAME_BUDGET);
+		CHECK(scales[frame] == scales[settledFrame]);
+	}
+
+	// When the load goes away the scale creeps back up without overshooting the budget and ends at the full scale.
+	recoveredFrame = -1;
+	for(frame=LIGHT_FRAMES + HEAVY_FRAMES; frame<(int)scales.size(); frame++)
+	{
+		CHECK(scales[frame] >= scales[frame - 1]);
+		CHECK(times[frame] < FRAME_BUDGET);
+		if(recoveredFrame < 0 && scales[frame] == RESOLUTION_MAX_SCALE)
+		{
+			recoveredFrame = frame;
+		}
+	}
+
+	CHECK(recoveredFrame >= 0 && recoveredFrame - (LIGHT_FRAMES + HEAVY_FRAMES) <= RECOVERY_LIMIT);
+
+	// The controller only does arithmetic on the times, the same run gives the very same scales.
+	CHECK(repeat.Initialize(FRAME_BUDGET, RESOLUTION_MIN_SCALE, RESOLUTION_MAX_SCALE));
+	RunSteps(repeat, repeatScales, repeatTimes);
+	CHECK(repeatScales == scales);
+
+	return;
+}
+
+
+static void TestOverload()
+{
+	ResolutionControllerClass controller;
+	int frame;
+
+
+	CHECK(controller.Initialize(FRAME_BUDGET, RESOLUTION_MIN_SCALE, RESOLUTION_MAX_SCALE));
+
+	// A load the lowest scale cannot hold pins the scale there.
+	for(frame=0; frame<60; frame++)
+	{
+		controller.Update(GetGpuTime(OVERLOAD_COST, controller.GetScale()));
+	}
+
+	CHECK(controller.GetScale() == RESOLUTION_MIN_SCALE);
+
+	// Reset starts over from the given scale with no average.
+	controller.Reset(0.75f);
+	CHECK(controller.GetScale() == 0.75f);
+	CHECK(controller.GetAverageTime() == 0.0f);
+
+	return;
+}
+
+
+static void RenderFrame(NullDeviceClass& device, GpuProfilerClass& profiler, DynamicResolutionClass& resolution, float cost)
+{
+	// One drawn index is a nanosecond on the null device.
+	profiler.BeginFrame();
+	device.BeginScene(0.0f, 0.0f, 0.0f, 1.0f);
+
+	profiler.BeginPass("scene");
+	resolution.SetRenderTargets();
+	device.DrawIndexed((int)(GetGpuTime(cost, resolution.GetScale()) * 1000000.0f));
+	profiler.EndPass();
+
+	profiler.EndFrame();
+	device.EndScene();
+
+	resolution.Update(&profiler);
+
+	return;
+}
+
+
+static void TestDynamicResolution()
+{
+	NullDeviceClass device;
+	GpuProfilerClass profiler;
+	DynamicResolutionClass resolution;
+	ResolutionControllerClass controller;
+	float aim, time;
+	int frame;
+
+
+	CHECK(device.Initialize(1280, 720, 1000.0f, 0.1f, false));
+	CHECK(profiler.Initialize(&device));
+	CHECK(resolution.Initialize(&device, 1280, 720, FRAME_BUDGET));
+	CHECK(resolution.GetTextureWidth() == 1280 && resolution.GetTextureHeight() == 720);
+	CHECK(resolution.GetWidth() == 1280 && resolution.GetHeight() == 720);
+
+	// The frames reach the controller NULL_QUERY_LATENCY frames late, the settle frames cover that.
+	for(frame=0; frame<HEAVY_FRAMES; frame++)
+	{
+		RenderFrame(device, profiler, resolution, HEAVY_COST);
+	}
+
+	aim = FRAME_BUDGET * RESOLUTION_HEADROOM;
+	time = GetGpuTime(HEAVY_COST, resolution.GetScale());
+	CHECK(time >= aim * (1.0f - RESOLUTION_DEADBAND) && time <= aim * (1.0f + RESOLUTION_DEADBAND));
+	CHECK(resolution.GetWidth() == (int)(1280.0f * resolution.GetScale() + 0.5f));
+	CHECK(resolution.GetHeight() == (int)(720.0f * resolution.GetScale() + 0.5f));
+
+	// With no latency in the way it lands on the same scale as the bare controller.
+	CHECK(controller.Initialize(FRAME_BUDGET, RESOLUTION_MIN_SCALE, RESOLUTION_MAX_SCALE));
+	for(frame=0; frame<HEAVY_FRAMES; frame++)
+	{
+		controller.Update(GetGpuTime(HEAVY_COST, controller.GetScale()));
+	}
+	CHECK_NEAR(resolution.GetScale(), controller.GetScale(), 0.05f);
+
+	// SetScale restarts from the given scale.
+	resolution.SetScale(0.6f);
+	CHECK(resolution.GetScale() == 0.6f);
+	CHECK(resolution.GetWidth() == 768 && resolution.GetHeight() == 432);
+
+	resolution.Shutdown();
+	profiler.Shutdown();
+	CHECK(device.GetResourceCount() == 0);
+	device.Shutdown();
+
+	return;
+}
+
+
+int main()
+{
+	TestInitialize();
+	TestStepResponse();
+	TestOverload();
+	TestDynamicResolution();
+
+	return TestResult("resolutioncontrollertest");
+}
\ No newline at end of file
@@ -0,0 +1,230 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: reversedepthtest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Checks the reverse depth mode: the infinite projection maps the near plane to 1 and infinity towards 0, the devices
+// clear to the far depth of their mode, every depth state picks the test that goes with the mode and the shadow state
+// keeps LESS.  The software device then renders the same frame in both modes, which must come out nearly the same.
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <vector>
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "nulldeviceclass.h"
+#include "softwaredeviceclass.h"
+#include "shadermanagerclass.h"
+#include "modelclass.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int SCREEN_WIDTH = 320;
+const int SCREEN_HEIGHT = 240;
+const float SCREEN_DEPTH = 1000.0f;
+const float SCREEN_NEAR = 0.1f;
+const float FIELD_OF_VIEW = (float)XM_PI / 4.0f;
+const float MAX_CHANGED_PIXELS = 0.01f;
+
+
+static float GetProjectedDepth(const XMMATRIX& projectionMatrix, float z, float& w)
+{
+	XMFLOAT4 position;
+
+
+	XMStoreFloat4(&position, XMVector4Transform(XMVectorSet(1.0f, 2.0f, z, 1.0f), projectionMatrix));
+	w = position.w;
+
+	return position.z / position.w;
+}
+
+
+static void TestProjection()
+{
+	XMMATRIX forwardMatrix, reverseMatrix;
+	XMFLOAT4X4 forward, reverse;
+	float depth, lastDepth, w, z;
+
+
+	forwardMatrix = RenderDeviceClass::BuildProjectionMatrix(FIELD_OF_VIEW, 4.0f / 3.0f, SCREEN_NEAR, SCREEN_DEPTH, false);
+	reverseMatrix = RenderDeviceClass::BuildProjectionMatrix(FIELD_OF_VIEW, 4.0f / 3.0f, SCREEN_NEAR, SCREEN_DEPTH, true);
+
+	// The forward projection runs from 0 at the near plane to 1 at the far plane.
+	CHECK_NEAR(GetProjectedDepth(forwardMatrix, SCREEN_NEAR, w), 0.0f, 1e-6f);
+	CHECK_NEAR(GetProjectedDepth(forwardMatrix, SCREEN_DEPTH, w), 1.0f, 1e-6f);
+
+	// Both keep the same x and y and a w of the view depth, only the depth differs.
+	XMStoreFloat4x4(&forward, forwardMatrix);
+	XMStoreFloat4x4(&reverse, reverseMatrix);
+	CHECK(forward._11 == reverse._11 && forward._22 == reverse._22);
+	CHECK(reverse._12 == 0.0f && reverse._21 == 0.0f && reverse._31 == 0.0f && reverse._32 == 0.0f);
+
+	// The reverse projection puts the near plane at exactly 1 and the depth falls off as near / z with no far plane, so
+	// it is past 0 only at infinity.
+	CHECK(GetProjectedDepth(reverseMatrix, SCREEN_NEAR, w) == 1.0f);
+	CHECK_NEAR(w, SCREEN_NEAR, 1e-7f);
+
+	lastDepth = 1.0f;
+	for(z=1.0f; z<1e30f; z*=10.0f)
+	{
+		depth = GetProjectedDepth(reverseMatrix, z, w);
+		CHECK_NEAR(depth, SCREEN_NEAR / z, SCREEN_NEAR / z * 1e-5f);
+		CHECK_NEAR(w, z, z * 1e-6f);
+		CHECK(depth < lastDepth && depth > 0.0f);
+		lastDepth = depth;
+	}
+
+	// The far plane is not used, a point well past it is still in front of the far depth of 0.
+	CHECK(GetProjectedDepth(reverseMatrix, SCREEN_DEPTH * 100.0f, w) > 0.0f);
+	CHECK(lastDepth < 1e-29f);
+
+	return;
+}
+
+
+static void TestFarDepth()
+{
+	NullDeviceClass forwardDevice, reverseDevice;
+	XMMATRIX projectionMatrix;
+	float w;
+
+
+	CHECK(forwardDevice.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SCREEN_NEAR, false));
+	CHECK(reverseDevice.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SCREEN_NEAR, true));
+
+	CHECK(!forwardDevice.IsReverseDepth());
+	CHECK(forwardDevice.GetFarDepth() == 1.0f);
+	CHECK(reverseDevice.IsReverseDepth());
+	CHECK(reverseDevice.GetFarDepth() == 0.0f);
+
+	// The devices build their projection the same way.
+	reverseDevice.GetProjectionMatrix(projectionMatrix);
+	CHECK(GetProjectedDepth(projectionMatrix, SCREEN_NEAR, w) == 1.0f);
+	forwardDevice.GetProjectionMatrix(projectionMatrix);
+	CHECK_NEAR(GetProjectedDepth(projectionMatrix, SCREEN_DEPTH, w), 1.0f, 1e-6f);
+
+	forwardDevice.Shutdown();
+	reverseDevice.Shutdown();
+
+	return;
+}
+
+
+static void TestComparisons()
+{
+	// The default and prepass states keep the nearest surface, the larger depth with reverse depth.
+	CHECK(RenderDeviceClass::GetDepthComparison(RenderDeviceClass::DEPTH_STATE_DEFAULT, false) == RenderDeviceClass::DEPTH_COMPARISON_LESS);
+	CHECK(RenderDeviceClass::GetDepthComparison(RenderDeviceClass::DEPTH_STATE_DEFAULT, true) == RenderDeviceClass::DEPTH_COMPARISON_GREATER);
+	CHECK(RenderDeviceClass::GetDepthComparison(RenderDeviceClass::DEPTH_STATE_PREPASS, false) == RenderDeviceClass::DEPTH_COMPARISON_LESS);
+	CHECK(RenderDeviceClass::GetDepthComparison(RenderDeviceClass::DEPTH_STATE_PREPASS, true) == RenderDeviceClass::DEPTH_COMPARISON_GREATER);
+
+	// The sky lands on the far depth and must pass where nothing else was drawn.
+	CHECK(RenderDeviceClass::GetDepthComparison(RenderDeviceClass::DEPTH_STATE_SKY, false) == RenderDeviceClass::DEPTH_COMPARISON_LESS_EQUAL);
+	CHECK(RenderDeviceClass::GetDepthComparison(RenderDeviceClass::DEPTH_STATE_SKY, true) == RenderDeviceClass::DEPTH_COMPARISON_GREATER_EQUAL);
+
+	// The shadow maps stay LESS in both modes, the rest do not depend on the direction.
+	CHECK(RenderDeviceClass::GetDepthComparison(RenderDeviceClass::DEPTH_STATE_SHADOW, false) == RenderDeviceClass::DEPTH_COMPARISON_LESS);
+	CHECK(RenderDeviceClass::GetDepthComparison(RenderDeviceClass::DEPTH_STATE_SHADOW, true) == RenderDeviceClass::DEPTH_COMPARISON_LESS);
+	CHECK(RenderDeviceClass::GetDepthComparison(RenderDeviceClass::DEPTH_STATE_EQUAL, false) == RenderDeviceClass::DEPTH_COMPARISON_EQUAL);
+	CHECK(RenderDeviceClass::GetDepthComparison(RenderDeviceClass::DEPTH_STATE_EQUAL, true) == RenderDeviceClass::DEPTH_COMPARISON_EQUAL);
+	CHECK(RenderDeviceClass::GetDepthComparison(RenderDeviceClass::DEPTH_STATE_DISABLED, false) == RenderDeviceClass::DEPTH_COMPARISON_ALWAYS);
+	CHECK(RenderDeviceClass::GetDepthComparison(RenderDeviceClass::DEPTH_STATE_DISABLED, true) == RenderDeviceClass::DEPTH_COMPARISON_ALWAYS);
+
+	return;
+}
+
+
+static bool RenderFrame(bool reverseDepth, vector<unsigned char>& image)
+{
+	SoftwareDeviceClass device;
+	ShaderManagerClass shaders;
+	ModelClass model;
+	XMMATRIX worldMatrix, viewMatrix, projectionMatrix;
+	bool result;
+
+
+	if(!device.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SCREEN_NEAR, 1, reverseDepth) || !shaders.Initialize(&device) ||
+	   !model.Initialize(&device, (char*)"data/predator.txt", L"data/predatorTexture.dds"))
+	{
+		return false;
+	}
+
+	device.GetWorldMatrix(worldMatrix);
+	device.GetProjectionMatrix(projectionMatrix);
+	viewMatrix = XMMatrixLookAtLH(XMVectorSet(0.0f, 60.0f, -25.0f, 1.0f), XMVectorSet(0.0f, 60.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+
+	// Depth prepass, shading with the equal test and the sky behind, the same as the scene is drawn.
+	device.BeginScene(0.2f, 0.3f, 0.4f, 1.0f);
+
+	device.SetDepthState(RenderDeviceClass::DEPTH_STATE_PREPASS);
+	model.RenderPositions();
+	result = shaders.RenderDepthShader(model.GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix);
+
+	device.SetDepthState(RenderDeviceClass::DEPTH_STATE_EQUAL);
+	model.Render();
+	result = result && shaders.RenderTextureShader(model.GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, model.GetTexture());
+
+	device.SetDepthState(RenderDeviceClass::DEPTH_STATE_SKY);
+	result = result && shaders.RenderSkyShader(viewMatrix, projectionMatrix, model.GetTexture());
+
+	device.EndScene();
+
+	image.assign(device.GetFramebuffer(), device.GetFramebuffer() + SCREEN_WIDTH * SCREEN_HEIGHT * 4);
+
+	model.Shutdown();
+	shaders.Shutdown();
+	device.Shutdown();
+
+	return result;
+}
+
+
+static void TestSoftwareDevice()
+{
+	vector<unsigned char> forward, reverse;
+	int i, changedCount, backgroundCount;
+
+
+	CHECK(RenderFrame(false, forward));
+	CHECK(RenderFrame(true, reverse));
+	CHECK(forward.size() == reverse.size());
+
+	// The sky covers every pixel the model does not in both modes, so the far depth and the sky test agree.
+	backgroundCount = 0;
+	changedCount = 0;
+	for(i=0; i<(int)reverse.size() / 4; i++)
+	{
+		if(reverse[i * 4] == 51 && reverse[i * 4 + 1] == 77 && reverse[i * 4 + 2] == 102)
+		{
+			backgroundCount++;
+		}
+		if(reverse[i * 4] != forward[i * 4] || reverse[i * 4 + 1] != forward[i * 4 + 1] || reverse[i * 4 + 2] != forward[i * 4 + 2])
+		{
+			changedCount++;
+		}
+	}
+
+	CHECK(backgroundCount == 0);
+
+	// Only the odd edge pixel may flip where the depths of two surfaces round differently.
+	CHECK((float)changedCount <= MAX_CHANGED_PIXELS * (float)(SCREEN_WIDTH * SCREEN_HEIGHT));
+
+	return;
+}
+
+
+int main()
+{
+	TestProjection();
+	TestFarDepth();
+	TestComparisons();
+	TestSoftwareDevice();
+
+	return TestResult("reversedepthtest");
+}
\ No newline at end of file
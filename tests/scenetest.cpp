@@ -0,0 +1,243 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: scenetest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Loads scene files through SceneClass::Load and checks the prefab list, the flat instance and light arrays and the
+// rejection of malformed files, then loads the real data/scene.txt the game ships with.
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <sstream>
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "sceneclass.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+static const char* VALID_SCENE =
+	"Prefab Count: 2\n"
+	"\n"
+	"Prefabs:\n"
+	"tower tower.txt tower.dds light\n"
+	"crate crate.txt crate.dds texture\n"
+	"\n"
+	"Instance Count: 3\n"
+	"\n"
+	"Instances:\n"
+	"crate 1 2 3 10 20 30 0.5 0 0\n"
+	"tower -4 5 -6 0 90 0 2 1.5 1\n"
+	"crate 7 8 9 0 0 0 1 0 0\n"
+	"\n"
+	"Light Row Count: 2\n"
+	"\n"
+	"Light Rows:\n"
+	"3 0 1 0 5 0 -2 8 1 0.5 0.25\n"
+	"1 10 20 30 0 0 0 4 0 1 0\n";
+
+static const char* HEADER =
+	"Prefab Count: 1\n"
+	"Prefabs:\n"
+	"tower tower.txt tower.dds light\n";
+
+
+static bool LoadText(SceneClass& scene, const char* text)
+{
+	istringstream in(text);
+
+
+	return scene.Load(in);
+}
+
+
+static bool LoadInstances(SceneClass& scene, const char* instances)
+{
+	string text;
+
+
+	text = HEADER;
+	text += instances;
+
+	return LoadText(scene, text.c_str());
+}
+
+
+static void TestValidScene()
+{
+	SceneClass scene;
+	SceneClass::InstanceDataType* instances;
+	SceneClass::LightDataType* lights;
+
+
+	CHECK(LoadText(scene, VALID_SCENE));
+
+	// The prefabs keep their file order and resolve by name.
+	CHECK(scene.GetPrefabCount() == 2);
+	CHECK(strcmp(scene.GetPrefab(0)->name, "tower") == 0);
+	CHECK(strcmp(scene.GetPrefab(1)->modelFilename, "crate.txt") == 0);
+	CHECK(strcmp(scene.GetPrefab(1)->textureFilename, "crate.dds") == 0);
+	CHECK(scene.GetPrefab(0)->shader == SceneClass::SHADER_LIGHT);
+	CHECK(scene.GetPrefab(1)->shader == SceneClass::SHADER_TEXTURE);
+	CHECK(scene.GetPrefab(2) == 0);
+	CHECK(scene.GetPrefab(-1) == 0);
+	CHECK(scene.FindPrefab("crate") == 1);
+	CHECK(scene.FindPrefab("missing") == -1);
+
+	// Instance i of the file lives at index i of every attribute array.
+	CHECK(scene.GetInstanceCount() == 3);
+	instances = scene.GetInstances();
+	CHECK(instances->prefab[0] == 1);
+	CHECK(instances->prefab[1] == 0);
+	CHECK(instances->prefab[2] == 1);
+	CHECK(instances->positionX[0] == 1.0f);
+	CHECK(instances->positionY[0] == 2.0f);
+	CHECK(instances->positionZ[0] == 3.0f);
+	CHECK(instances->rotationX[0] == 10.0f);
+	CHECK(instances->rotationY[0] == 20.0f);
+	CHECK(instances->rotationZ[0] == 30.0f);
+	CHECK(instances->scale[0] == 0.5f);
+	CHECK(instances->positionX[1] == -4.0f);
+	CHECK(instances->positionZ[1] == -6.0f);
+	CHECK(instances->rotationY[1] == 90.0f);
+	CHECK(instances->scale[1] == 2.0f);
+	CHECK(instances->orbitSpeed[1] == 1.5f);
+	CHECK(instances->followCamera[1]);
+	CHECK(!instances->followCamera[0]);
+	CHECK(instances->positionX[2] == 7.0f);
+	CHECK(instances->positionZ[2] == 9.0f);
+
+	// Each light row expands into count lights stepping from the start position, rows are laid out back to back.
+	CHECK(scene.GetLightCount() == 4);
+	lights = scene.GetLights();
+	CHECK(lights->positionX[0] == 0.0f);
+	CHECK(lights->positionX[1] == 5.0f);
+	CHECK(lights->positionY[2] == 1.0f);
+	CHECK(lights->positionZ[2] == -4.0f);
+	CHECK(lights->radius[2] == 8.0f);
+	CHECK(lights->colorG[0] == 0.5f);
+	CHECK(lights->colorB[2] == 0.25f);
+	CHECK(lights->positionX[3] == 10.0f);
+	CHECK(lights->positionZ[3] == 30.0f);
+	CHECK(lights->radius[3] == 4.0f);
+	CHECK(lights->colorR[3] == 0.0f);
+	CHECK(lights->colorG[3] == 1.0f);
+
+	// Loading again replaces the previous contents instead of appending to them.
+	CHECK(LoadInstances(scene, "Instance Count: 1\nInstances:\ntower 0 0 0 0 0 0 1 0 0\n"));
+	CHECK(scene.GetPrefabCount() == 1);
+	CHECK(scene.GetInstanceCount() == 1);
+	CHECK(scene.GetLightCount() == 0);
+	CHECK(scene.GetLights()->positionX == 0);
+
+	scene.Shutdown();
+	CHECK(scene.GetPrefabCount() == 0);
+	CHECK(scene.GetInstanceCount() == 0);
+	CHECK(scene.GetInstances()->prefab == 0);
+
+	return;
+}
+
+
+static void TestMalformedScenes()
+{
+	SceneClass scene;
+
+
+	// Missing sections, bad counts and short lines all fail the load.
+	CHECK(!LoadText(scene, ""));
+	CHECK(!LoadText(scene, "Prefab Count: two\n"));
+	CHECK(!LoadText(scene, "Prefab Count: -1\nPrefabs:\n"));
+	CHECK(!LoadText(scene, "Prefab Count: 2\nPrefabs:\ntower tower.txt tower.dds light\n"));
+	CHECK(!LoadText(scene, "Prefab Count: 1\nPrefabs:\ntower tower.txt tower.dds wireframe\n"));
+	CHECK(!LoadInstances(scene, ""));
+	CHECK(!LoadInstances(scene, "Instance Count: x\nInstances:\n"));
+	CHECK(!LoadInstances(scene, "Instance Count: -3\nInstances:\n"));
+	CHECK(!LoadInstances(scene, "Instance Count: 2\nInstances:\ntower 0 0 0 0 0 0 1 0 0\n"));
+	CHECK(!LoadInstances(scene, "Instance Count: 1\nInstances:\ntower 0 0 0 0 0 0 1 zero 0\n"));
+	CHECK(!LoadInstances(scene, "Instance Count: 1\nInstances:\ntower 0 0 0\n"));
+	CHECK(!LoadInstances(scene, "Instance Count: 0\nInstances:\nLight Row Count: 1\nLight Rows:\n0 0 0 0 0 0 0 1 1 1 1\n"));
+	CHECK(!LoadInstances(scene, "Instance Count: 0\nInstances:\nLight Row Count: 1\nLight Rows:\n2 0 0 0 0 0\n"));
+	CHECK(!LoadInstances(scene, "Instance Count: 0\nInstances:\nLight Row Count: -1\nLight Rows:\n"));
+
+	// A failed load leaves the scene empty rather than half filled.
+	CHECK(scene.GetPrefabCount() == 0);
+	CHECK(scene.GetInstanceCount() == 0);
+	CHECK(scene.GetLightCount() == 0);
+	CHECK(scene.GetInstances()->positionX == 0);
+
+	// An empty instance list and a missing light section are both valid.
+	CHECK(LoadInstances(scene, "Instance Count: 0\nInstances:\n"));
+	CHECK(scene.GetPrefabCount() == 1);
+	CHECK(scene.GetInstanceCount() == 0);
+	CHECK(scene.GetLightCount() == 0);
+
+	scene.Shutdown();
+
+	return;
+}
+
+
+static void TestUnknownPrefab()
+{
+	SceneClass scene;
+
+
+	// An instance that names a prefab that was never declared fails the load, whatever its position in the list.
+	CHECK(!LoadInstances(scene, "Instance Count: 1\nInstances:\nhangar 0 0 0 0 0 0 1 0 0\n"));
+	CHECK(!LoadInstances(scene, "Instance Count: 2\nInstances:\ntower 0 0 0 0 0 0 1 0 0\nTower 0 0 0 0 0 0 1 0 0\n"));
+	CHECK(scene.GetPrefabCount() == 0);
+	CHECK(scene.GetInstanceCount() == 0);
+
+	scene.Shutdown();
+
+	return;
+}
+
+
+static void TestShippedScene()
+{
+	SceneClass scene;
+	char filename[] = "data/scene.txt";
+	int i;
+	bool valid;
+
+
+	// The tests run from the engine directory, the same relative paths the game uses.
+	CHECK(scene.Initialize(filename));
+	CHECK(scene.GetPrefabCount() == 7);
+	CHECK(scene.GetInstanceCount() == 6);
+	CHECK(scene.GetLightCount() == 257);
+	CHECK(scene.FindPrefab("swarmDrone") == 6);
+
+	// Every instance refers to a prefab in range.
+	valid = true;
+	for(i=0; i<scene.GetInstanceCount(); i++)
+	{
+		valid = valid && (scene.GetInstances()->prefab[i] >= 0) && (scene.GetInstances()->prefab[i] < scene.GetPrefabCount());
+	}
+	CHECK(valid);
+
+	scene.Shutdown();
+
+	// A missing file fails cleanly.
+	CHECK(!scene.Initialize((char*)"data/missing.txt"));
+
+	return;
+}
+
+
+int main()
+{
+	TestValidScene();
+	TestMalformedScenes();
+	TestUnknownPrefab();
+	TestShippedScene();
+
+	return TestResult("scenetest");
+}
\ No newline at end of file
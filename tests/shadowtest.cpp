@@ -0,0 +1,270 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: shadowtest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Checks the cascade split distances, that every cascade covers its slice of the view frustum and is snapped to whole
+// texels, and when the cached cascades keep their static casters and when they are refit.
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "nulldeviceclass.h"
+#include "shadowclass.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int SCREEN_WIDTH = 1280;
+const int SCREEN_HEIGHT = 720;
+const float SCREEN_NEAR = 0.1f;
+const int MAP_SIZE = 1024;
+
+
+static XMMATRIX ViewMatrix(float x, float y, float z)
+{
+	// Look a little down the z axis from the given position, moving the camera only translates the frustum.
+	return XMMatrixLookToLH(XMVectorSet(x, y, z, 1.0f), XMVectorSet(0.0f, -0.2f, 1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+}
+
+
+static XMMATRIX ProjectionMatrix()
+{
+	return XMMatrixPerspectiveFovLH(XM_PIDIV4, (float)SCREEN_WIDTH / (float)SCREEN_HEIGHT, SCREEN_NEAR, 1000.0f);
+}
+
+
+static XMFLOAT3 RotateLight(const XMFLOAT3& direction, float degrees)
+{
+	XMFLOAT3 rotated;
+
+
+	XMStoreFloat3(&rotated, XMVector3TransformNormal(XMLoadFloat3(&direction), XMMatrixRotationY(degrees * XM_PI / 180.0f)));
+
+	return rotated;
+}
+
+
+static XMFLOAT3 ShadowMapPosition(ShadowClass& shadow, int cascade, const XMFLOAT3& point)
+{
+	XMMATRIX viewMatrix, projectionMatrix;
+	XMFLOAT3 position;
+
+
+	// Project a world point into the texels and depth of a cascade's map.
+	shadow.GetCascadeMatrices(cascade, viewMatrix, projectionMatrix);
+	XMStoreFloat3(&position, XMVector3TransformCoord(XMLoadFloat3(&point), viewMatrix * projectionMatrix));
+	position.x = (position.x * 0.5f + 0.5f) * (float)MAP_SIZE;
+	position.y = (position.y * 0.5f + 0.5f) * (float)MAP_SIZE;
+
+	return position;
+}
+
+
+static void TestSplits()
+{
+	NullDeviceClass device;
+	ShadowClass shadow;
+	double fraction, expected;
+	int i;
+
+
+	CHECK(device.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, 1000.0f, SCREEN_NEAR, false));
+
+	CHECK(!shadow.Initialize(0, MAP_SIZE, SHADOW_DISTANCE, SCREEN_NEAR));
+	CHECK(!shadow.Initialize(&device, MAP_SIZE, SCREEN_NEAR, SCREEN_NEAR));
+	CHECK(shadow.Initialize(&device, MAP_SIZE, SHADOW_DISTANCE, SCREEN_NEAR));
+
+	// Each split blends the logarithmic and the even spacing, the last one lands on the shadow distance.
+	for(i=0; i<SHADOW_CASCADES; i++)
+	{
+		fraction = (double)(i + 1) / (double)SHADOW_CASCADES;
+		expected = SHADOW_SPLIT_LAMBDA * SCREEN_NEAR * pow(SHADOW_DISTANCE / SCREEN_NEAR, fraction) +
+				   (1.0 - SHADOW_SPLIT_LAMBDA) * (SCREEN_NEAR + (SHADOW_DISTANCE - SCREEN_NEAR) * fraction);
+		CHECK_NEAR(shadow.GetSplitDepth(i), expected, expected * 1e-5);
+		if(i > 0)
+		{
+			CHECK(shadow.GetSplitDepth(i) > shadow.GetSplitDepth(i - 1));
+		}
+	}
+	CHECK_NEAR(shadow.GetSplitDepth(SHADOW_CASCADES - 1), SHADOW_DISTANCE, 0.01);
+	CHECK(shadow.GetSplitDepth(-1) == 0.0f);
+	CHECK(shadow.GetSplitDepth(SHADOW_CASCADES) == 0.0f);
+
+	shadow.Shutdown();
+	CHECK(device.GetResourceCount() == 0);
+	device.Shutdown();
+
+	return;
+}
+
+
+static void TestFitting()
+{
+	NullDeviceClass device;
+	ShadowClass shadow;
+	XMMATRIX viewMatrix, projectionMatrix, inverseViewMatrix, lightViewMatrix, lightProjectionMatrix;
+	XMFLOAT4X4 projection;
+	XMFLOAT3 light, corner, before, after, point;
+	float tanX, tanY, nearDepth, farDepth, depth, radius, firstRadius;
+	int cascade, i, step, outsideCount;
+	bool snapped;
+
+
+	CHECK(device.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, 1000.0f, SCREEN_NEAR, false));
+	CHECK(shadow.Initialize(&device, MAP_SIZE, SHADOW_DISTANCE, SCREEN_NEAR));
+
+	light = XMFLOAT3(0.5f, -0.7f, 0.3f);
+	projectionMatrix = ProjectionMatrix();
+	XMStoreFloat4x4(&projection, projectionMatrix);
+	tanX = 1.0f / projection._11;
+	tanY = 1.0f / projection._22;
+
+	viewMatrix = ViewMatrix(30.0f, 40.0f, -80.0f);
+	shadow.Update(viewMatrix, projectionMatrix, light);
+
+	// All eight corners of every cascade's slice of the view frustum land inside its map and depth range.
+	inverseViewMatrix = XMMatrixInverse(NULL, viewMatrix);
+	outsideCount = 0;
+	for(cascade=0; cascade<SHADOW_CASCADES; cascade++)
+	{
+		shadow.GetCascadeMatrices(cascade, lightViewMatrix, lightProjectionMatrix);
+		nearDepth = (cascade == 0) ? SCREEN_NEAR : shadow.GetSplitDepth(cascade - 1);
+		farDepth = shadow.GetSplitDepth(cascade);
+
+		for(i=0; i<8; i++)
+		{
+			depth = (i & 4) ? farDepth : nearDepth;
+			XMStoreFloat3(&corner, XMVector3TransformCoord(XMVectorSet(((i & 1) ? tanX : -tanX) * depth, ((i & 2) ? tanY : -tanY) * depth, depth, 1.0f),
+														   inverseViewMatrix));
+			XMStoreFloat3(&corner, XMVector3TransformCoord(XMLoadFloat3(&corner), lightViewMatrix * lightProjectionMatrix));
+			if(fabsf(corner.x) > 1.0f || fabsf(corner.y) > 1.0f || corner.z < 0.0f || corner.z > 1.0f)
+			{
+				outsideCount++;
+			}
+		}
+	}
+	CHECK(outsideCount == 0);
+
+	// The near cascade follows the camera every frame.  Moving by fractions of a texel must move a fixed world point in
+	// its map by whole texels only, otherwise the shadow edges crawl.
+	point = XMFLOAT3(35.0f, 2.0f, -60.0f);
+	shadow.GetCascadeSphere(0, corner, firstRadius);
+	before = ShadowMapPosition(shadow, 0, point);
+	snapped = true;
+	for(step=1; step<=20; step++)
+	{
+		shadow.Update(ViewMatrix(30.0f + 0.037f * (float)step, 40.0f, -80.0f + 0.021f * (float)step), projectionMatrix, light);
+		after = ShadowMapPosition(shadow, 0, point);
+		snapped = snapped && (fabsf((after.x - before.x) - roundf(after.x - before.x)) < 0.01f);
+		snapped = snapped && (fabsf((after.y - before.y) - roundf(after.y - before.y)) < 0.01f);
+
+		// The sphere size only depends on the projection, so the texel size does not change as the camera moves.
+		shadow.GetCascadeSphere(0, corner, radius);
+		snapped = snapped && (radius == firstRadius);
+	}
+	CHECK(snapped);
+
+	// Turning the camera moves the sphere but keeps its size, the radius is rounded up to whole units.
+	shadow.Update(XMMatrixRotationY(1.0f) * ViewMatrix(30.0f, 40.0f, -80.0f), projectionMatrix, light);
+	shadow.GetCascadeSphere(0, corner, radius);
+	CHECK(radius == firstRadius);
+	CHECK(radius == ceilf(radius));
+
+	shadow.Shutdown();
+	device.Shutdown();
+
+	return;
+}
+
+
+static void TestCaching()
+{
+	NullDeviceClass device;
+	ShadowClass shadow;
+	XMMATRIX projectionMatrix;
+	XMFLOAT3 light, center;
+	float radius, threshold, farThreshold;
+	int updates;
+
+
+	CHECK(device.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, 1000.0f, SCREEN_NEAR, false));
+	CHECK(shadow.Initialize(&device, MAP_SIZE, SHADOW_DISTANCE, SCREEN_NEAR));
+
+	light = XMFLOAT3(0.5f, -0.7f, 0.3f);
+	projectionMatrix = ProjectionMatrix();
+
+	CHECK(!shadow.IsCascadeCached(0));
+	CHECK(shadow.IsCascadeCached(SHADOW_FIRST_CACHED_CASCADE));
+	CHECK(!shadow.IsCascadeCached(SHADOW_CASCADES));
+
+	// The first update renders the static casters of every cached cascade, the near one never has a static map.
+	shadow.Update(ViewMatrix(0.0f, 40.0f, -80.0f), projectionMatrix, light);
+	CHECK(!shadow.NeedsStaticUpdate(0));
+	CHECK(shadow.NeedsStaticUpdate(1));
+	CHECK(shadow.NeedsStaticUpdate(2));
+	CHECK(shadow.GetStaticUpdateCount() == SHADOW_CASCADES - SHADOW_FIRST_CACHED_CASCADE);
+	updates = shadow.GetStaticUpdateCount();
+
+	// The same view reuses them.
+	shadow.Update(ViewMatrix(0.0f, 40.0f, -80.0f), projectionMatrix, light);
+	CHECK(!shadow.NeedsStaticUpdate(1));
+	CHECK(!shadow.NeedsStaticUpdate(2));
+	CHECK(shadow.GetStaticUpdateCount() == updates);
+
+	// A cached sphere is padded, the slice may move by the padding before it leaves it.  Moving the camera moves the
+	// slice spheres by the same amount.
+	shadow.GetCascadeSphere(1, center, radius);
+	threshold = radius - radius / SHADOW_CACHE_PADDING;
+	shadow.GetCascadeSphere(2, center, radius);
+	farThreshold = radius - radius / SHADOW_CACHE_PADDING;
+	CHECK(farThreshold > threshold * 1.1f);
+
+	shadow.Update(ViewMatrix(threshold * 0.95f, 40.0f, -80.0f), projectionMatrix, light);
+	CHECK(!shadow.NeedsStaticUpdate(1));
+	CHECK(!shadow.NeedsStaticUpdate(2));
+	CHECK(shadow.GetStaticUpdateCount() == updates);
+
+	// Just past the threshold of the middle cascade only that one is refit, the far one still covers the move.
+	shadow.Update(ViewMatrix(threshold * 1.05f, 40.0f, -80.0f), projectionMatrix, light);
+	CHECK(shadow.NeedsStaticUpdate(1));
+	CHECK(!shadow.NeedsStaticUpdate(2));
+	CHECK(shadow.GetStaticUpdateCount() == updates + 1);
+	updates = shadow.GetStaticUpdateCount();
+
+	// A light that turns by half a degree keeps the maps, one and a half degrees is past the angle limit.
+	shadow.Update(ViewMatrix(threshold * 1.05f, 40.0f, -80.0f), projectionMatrix, RotateLight(light, 0.5f));
+	CHECK(!shadow.NeedsStaticUpdate(1));
+	CHECK(!shadow.NeedsStaticUpdate(2));
+	shadow.Update(ViewMatrix(threshold * 1.05f, 40.0f, -80.0f), projectionMatrix, RotateLight(light, 1.5f));
+	CHECK(shadow.NeedsStaticUpdate(1));
+	CHECK(shadow.NeedsStaticUpdate(2));
+	CHECK(shadow.GetStaticUpdateCount() == updates + 2);
+	updates = shadow.GetStaticUpdateCount();
+
+	// Invalidating refits every cached cascade on the next update, once.
+	shadow.Invalidate();
+	shadow.Update(ViewMatrix(threshold * 1.05f, 40.0f, -80.0f), projectionMatrix, RotateLight(light, 1.5f));
+	CHECK(shadow.NeedsStaticUpdate(1));
+	CHECK(shadow.NeedsStaticUpdate(2));
+	shadow.Update(ViewMatrix(threshold * 1.05f, 40.0f, -80.0f), projectionMatrix, RotateLight(light, 1.5f));
+	CHECK(!shadow.NeedsStaticUpdate(1));
+	CHECK(!shadow.NeedsStaticUpdate(2));
+	CHECK(shadow.GetStaticUpdateCount() == updates + 2);
+
+	shadow.Shutdown();
+	device.Shutdown();
+
+	return;
+}
+
+
+int main()
+{
+	TestSplits();
+	TestFitting();
+	TestCaching();
+
+	return TestResult("shadowtest");
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: softwarebenchmark.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Renders a frame of lit models and sky on the software device with 1, 2, 4 ... worker threads up to the core count and
+// reports the median vertex, setup and raster stage times with the speedup of each stage over one thread.  The slowest
+// tile bounds how far the raster stage can scale however many threads there are.
+//
+//   softwarebenchmark [width] [height] [frames] [maxThreads]
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <thread>
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "softwaredeviceclass.h"
+#include "shadermanagerclass.h"
+#include "modelclass.h"
+#include "benchmarktimer.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int DEFAULT_WIDTH = 1280;
+const int DEFAULT_HEIGHT = 720;
+const int DEFAULT_FRAMES = 20;
+const int MODEL_GRID = 3;
+
+
+static void RenderFrame(SoftwareDeviceClass& device, ShaderManagerClass& shaders, ModelClass& model)
+{
+	XMMATRIX worldMatrix, viewMatrix, projectionMatrix;
+	int x, y;
+
+
+	device.GetProjectionMatrix(projectionMatrix);
+	viewMatrix = XMMatrixLookAtLH(XMVectorSet(0.0f, 60.0f, -60.0f, 1.0f), XMVectorSet(0.0f, 55.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+
+	device.BeginScene(0.2f, 0.3f, 0.4f, 1.0f);
+
+	// A grid of models, every one large enough for its vertex stage to be split across the threads.
+	model.Render();
+	for(y=0; y<MODEL_GRID; y++)
+	{
+		for(x=0; x<MODEL_GRID; x++)
+		{
+			worldMatrix = XMMatrixTranslation((float)(x - MODEL_GRID / 2) * 25.0f, (float)(y - MODEL_GRID / 2) * 12.0f, (float)(x + y) * 5.0f);
+			shaders.RenderLightShader(model.GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, model.GetTexture(), XMFLOAT3(0.5f, -0.5f, 0.7f),
+									  XMFLOAT4(0.2f, 0.2f, 0.2f, 1.0f), XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f), XMFLOAT3(0.0f, 60.0f, -60.0f),
+									  XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f), 32.0f);
+		}
+	}
+
+	device.SetDepthState(RenderDeviceClass::DEPTH_STATE_SKY);
+	shaders.RenderSkyShader(viewMatrix, projectionMatrix, model.GetTexture());
+	device.SetDepthState(RenderDeviceClass::DEPTH_STATE_DEFAULT);
+
+	device.EndScene();
+
+	return;
+}
+
+
+int main(int argc, char** argv)
+{
+	SoftwareDeviceClass device;
+	ShaderManagerClass shaders;
+	ModelClass model;
+	SoftwareDeviceClass::StageTimesType times;
+	vector<double> vertexTimes, setupTimes, rasterTimes, tileTimes;
+	double vertexTime, setupTime, rasterTime, baseVertex, baseSetup, baseRaster, slowestTile;
+	int width, height, frames, maxThreads, threadCount, i, j;
+
+
+	width = GetArgument(argc, argv, 1, DEFAULT_WIDTH);
+	height = GetArgument(argc, argv, 2, DEFAULT_HEIGHT);
+	frames = GetArgument(argc, argv, 3, DEFAULT_FRAMES);
+	maxThreads = min(max(GetArgument(argc, argv, 4, (int)thread::hardware_concurrency()), 1), SOFTWARE_MAX_THREADS);
+
+	printf("software device, %dx%d, %d x %d models, median of %d frames, %d cores\n", width, height, MODEL_GRID, MODEL_GRID, frames,
+		   (int)thread::hardware_concurrency());
+	printf("  threads   vertex ms      setup ms      raster ms     slowest tile ms\n");
+
+	baseVertex = baseSetup = baseRaster = 0.0;
+	for(threadCount=1; threadCount<=maxThreads; threadCount*=2)
+	{
+		if(!device.Initialize(width, height, 1000.0f, 0.1f, threadCount, false) || !shaders.Initialize(&device) ||
+		   !model.Initialize(&device, (char*)"data/predator.txt", L"data/predatorTexture.dds"))
+		{
+			printf("failed to create the device, run from the Engine directory\n");
+			return 1;
+		}
+
+		// The first frame creates the pipelines and is not counted.
+		RenderFrame(device, shaders, model);
+
+		vertexTimes.clear();
+		setupTimes.clear();
+		rasterTimes.clear();
+		tileTimes.clear();
+		for(i=0; i<frames; i++)
+		{
+			RenderFrame(device, shaders, model);
+
+			device.GetStageTimes(times);
+			vertexTimes.push_back(times.vertexTime);
+			setupTimes.push_back(times.setupTime);
+			rasterTimes.push_back(times.rasterTime);
+
+			slowestTile = 0.0;
+			for(j=0; j<device.GetTileCount(); j++)
+			{
+				slowestTile = max(slowestTile, (double)device.GetTileTime(j));
+			}
+			tileTimes.push_back(slowestTile);
+		}
+
+		vertexTime = GetMedian(vertexTimes);
+		setupTime = GetMedian(setupTimes);
+		rasterTime = GetMedian(rasterTimes);
+		if(threadCount == 1)
+		{
+			baseVertex = vertexTime;
+			baseSetup = setupTime;
+			baseRaster = rasterTime;
+		}
+
+		printf("  %7d  %7.2f %4.2fx  %7.2f %4.2fx  %7.2f %4.2fx  %7.2f\n", threadCount, vertexTime, baseVertex / vertexTime, setupTime,
+			   baseSetup / setupTime, rasterTime, baseRaster / rasterTime, GetMedian(tileTimes));
+
+		model.Shutdown();
+		shaders.Shutdown();
+		device.Shutdown();
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: softwaredevicetest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Renders the same lit, depth prepassed and sky covered frame on the software device with one and with several worker
+// threads.  The images must match bit for bit and the per stage and per tile timings must add up.
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <vector>
+#include <string.h>
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "softwaredeviceclass.h"
+#include "shadermanagerclass.h"
+#include "modelclass.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int SCREEN_WIDTH = 320;
+const int SCREEN_HEIGHT = 240;
+const int THREAD_COUNTS[] = { 1, 2, 4 };
+
+
+static bool RenderFrame(SoftwareDeviceClass& device, ShaderManagerClass& shaders, ModelClass& model)
+{
+	XMMATRIX worldMatrix, viewMatrix, projectionMatrix;
+	bool result;
+
+
+	device.GetWorldMatrix(worldMatrix);
+	device.GetProjectionMatrix(projectionMatrix);
+	viewMatrix = XMMatrixLookAtLH(XMVectorSet(0.0f, 60.0f, -25.0f, 1.0f), XMVectorSet(0.0f, 60.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+
+	device.BeginScene(0.2f, 0.3f, 0.4f, 1.0f);
+
+	// The predator has more vertices than SOFTWARE_PARALLEL_MIN_VERTICES so its vertex stage is split across the threads.
+	device.SetDepthState(RenderDeviceClass::DEPTH_STATE_PREPASS);
+	model.RenderPositions();
+	result = shaders.RenderDepthShader(model.GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix);
+
+	device.SetDepthState(RenderDeviceClass::DEPTH_STATE_EQUAL);
+	model.Render();
+	result = result && shaders.RenderLightShader(model.GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, model.GetTexture(),
+												 XMFLOAT3(0.5f, -0.5f, 0.7f), XMFLOAT4(0.2f, 0.2f, 0.2f, 1.0f), XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f),
+												 XMFLOAT3(0.0f, 60.0f, -25.0f), XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f), 32.0f);
+
+	device.SetDepthState(RenderDeviceClass::DEPTH_STATE_SKY);
+	result = result && shaders.RenderSkyShader(viewMatrix, projectionMatrix, model.GetTexture());
+
+	device.EndScene();
+
+	return result;
+}
+
+
+static void TestThreadCounts()
+{
+	SoftwareDeviceClass device;
+	ShaderManagerClass shaders;
+	ModelClass model;
+	SoftwareDeviceClass::StageTimesType times;
+	vector<unsigned char> reference;
+	float tileSum;
+	int i, t, threadCount, backgroundCount;
+	bool tilesValid;
+
+
+	for(t=0; t<(int)(sizeof(THREAD_COUNTS) / sizeof(THREAD_COUNTS[0])); t++)
+	{
+		threadCount = THREAD_COUNTS[t];
+
+		CHECK(device.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, 1000.0f, 0.1f, threadCount, false));
+		CHECK(device.GetThreadCount() == threadCount);
+		CHECK(shaders.Initialize(&device));
+		CHECK(model.Initialize(&device, (char*)"data/predator.txt", L"data/predatorTexture.dds"));
+
+		// Render twice so the second frame's timings do not include creating the pipelines.
+		CHECK(RenderFrame(device, shaders, model));
+		CHECK(RenderFrame(device, shaders, model));
+
+		// The tiles are claimed in whatever order the threads get to them, but each pixel belongs to exactly one tile so
+		// the image cannot depend on the thread count.
+		if(threadCount == 1)
+		{
+			reference.assign(device.GetFramebuffer(), device.GetFramebuffer() + SCREEN_WIDTH * SCREEN_HEIGHT * 4);
+
+			// Most of the frame is sky and model, the clear color only shows where neither covers it.
+			backgroundCount = 0;
+			for(i=0; i<SCREEN_WIDTH * SCREEN_HEIGHT; i++)
+			{
+				if(reference[i * 4] == 51 && reference[i * 4 + 1] == 77 && reference[i * 4 + 2] == 102)
+				{
+					backgroundCount++;
+				}
+			}
+			CHECK(backgroundCount == 0);
+		}
+		else
+		{
+			CHECK(memcmp(reference.data(), device.GetFramebuffer(), reference.size()) == 0);
+		}
+
+		// Every stage ran, and the tile times are measured inside the raster stage on each of the threads so together
+		// they can not add up to more than the raster time on all of them.
+		device.GetStageTimes(times);
+		CHECK(times.vertexTime > 0.0f);
+		CHECK(times.setupTime > 0.0f);
+		CHECK(times.rasterTime > 0.0f);
+		CHECK(device.GetTileCount() == ((SCREEN_WIDTH + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE) *
+									   ((SCREEN_HEIGHT + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE));
+
+		tileSum = 0.0f;
+		tilesValid = true;
+		for(i=0; i<device.GetTileCount(); i++)
+		{
+			tilesValid = tilesValid && (device.GetTileTime(i) > 0.0f);
+			tileSum += device.GetTileTime(i);
+		}
+		CHECK(tilesValid);
+		CHECK(tileSum <= times.rasterTime * (float)threadCount * 1.01f + 0.01f);
+		CHECK(device.GetTileTime(-1) == 0.0f);
+		CHECK(device.GetTileTime(device.GetTileCount()) == 0.0f);
+
+		// Releasing everything leaves no device memory behind.
+		model.Shutdown();
+		shaders.Shutdown();
+		CHECK(device.GetResourceBytes() == 0);
+		device.Shutdown();
+	}
+
+	return;
+}
+
+
+int main()
+{
+	TestThreadCounts();
+
+	return TestResult("softwaredevicetest");
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: softwarerender.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Loads the game scene on the software device, renders it from the start pose and writes the last frame to
+// softwarerender.tga in the build directory, so the whole renderer can be looked at without a GPU or a window.
+//
+//   softwarerender [width] [height] [frames] [threads]
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "graphicsclass.h"
+#include "testscene.h"
+#include "benchmarktimer.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int DEFAULT_WIDTH = 1280;
+const int DEFAULT_HEIGHT = 720;
+const int DEFAULT_FRAMES = 1;
+
+
+int main(int argc, char** argv)
+{
+	GraphicsClass graphics;
+	char filename[SCENE_MAX_PATH];
+	double start;
+	int width, height, frameCount, threadCount, i;
+
+
+	width = GetArgument(argc, argv, 1, DEFAULT_WIDTH);
+	height = GetArgument(argc, argv, 2, DEFAULT_HEIGHT);
+	frameCount = GetArgument(argc, argv, 3, DEFAULT_FRAMES);
+	threadCount = GetArgument(argc, argv, 4, 0);
+
+	// Load the scene through the software device, a thread count of 0 uses every core.
+	if(!SetTestScene(graphics, "softwarerender") || !graphics.InitializeSoftware(width, height, threadCount))
+	{
+		printf("softwarerender: could not load the scene\n");
+		graphics.Shutdown();
+		return 1;
+	}
+
+	start = GetMilliseconds();
+	for(i=0; i<frameCount; i++)
+	{
+		if(!graphics.Frame(0))
+		{
+			printf("softwarerender: could not render frame %d\n", i);
+			graphics.Shutdown();
+			return 1;
+		}
+	}
+
+	GetOutputPath("softwarerender.tga", filename, sizeof(filename));
+	if(!graphics.GetSoftwareDevice()->WriteFramebuffer(filename))
+	{
+		printf("softwarerender: could not write %s\n", filename);
+		graphics.Shutdown();
+		return 1;
+	}
+
+	printf("softwarerender: %d frames of %dx%d in %.1f ms, wrote %s\n", frameCount, width, height, GetMilliseconds() - start,
+		   filename);
+
+	graphics.Shutdown();
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: softwarescenetest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Loads the game scene through GraphicsClass::InitializeSoftware, renders a frame on the software device and writes it
+// out as a targa.  The file must read back as the framebuffer, and the frame must be more than the clear colour.
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "graphicsclass.h"
+#include "testscene.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int TEST_SCREEN_WIDTH = 320;
+const int TEST_SCREEN_HEIGHT = 180;
+const int TEST_THREAD_COUNT = 2;
+const int TARGA_HEADER_SIZE = 18;
+const float MIN_DRAWN_PIXELS = 0.5f;
+
+
+static void TestRenderScene()
+{
+	GraphicsClass graphics;
+	ifstream fin;
+	vector<unsigned char> file;
+	const unsigned char* framebuffer;
+	const unsigned char* pixel;
+	char filename[SCENE_MAX_PATH];
+	int i, pixelCount, drawnCount, mismatchCount;
+	bool result;
+
+
+	CHECK(SetTestScene(graphics, "softwarescenetest"));
+
+	result = graphics.InitializeSoftware(TEST_SCREEN_WIDTH, TEST_SCREEN_HEIGHT, TEST_THREAD_COUNT);
+	CHECK(result);
+	if(!result)
+	{
+		graphics.Shutdown();
+		return;
+	}
+
+	CHECK(graphics.GetSoftwareDevice() != 0);
+	CHECK(graphics.Frame(0));
+
+	GetOutputPath("softwarescenetest.tga", filename, sizeof(filename));
+	CHECK(graphics.GetSoftwareDevice()->WriteFramebuffer(filename));
+
+	// Read the targa back, a 32 bit image of the screen size with the origin in the top left corner.
+	fin.open(filename, ios::in | ios::binary);
+	file.assign(istreambuf_iterator<char>(fin), istreambuf_iterator<char>());
+	fin.close();
+
+	pixelCount = TEST_SCREEN_WIDTH * TEST_SCREEN_HEIGHT;
+	CHECK((int)file.size() == TARGA_HEADER_SIZE + pixelCount * 4);
+	if((int)file.size() != TARGA_HEADER_SIZE + pixelCount * 4)
+	{
+		graphics.Shutdown();
+		return;
+	}
+
+	CHECK(file[2] == 2 && file[16] == 32 && file[17] == 0x28);
+	CHECK((file[12] | (file[13] << 8)) == TEST_SCREEN_WIDTH);
+	CHECK((file[14] | (file[15] << 8)) == TEST_SCREEN_HEIGHT);
+
+	// The pixels are the framebuffer in BGRA order, and most of them were drawn over the black clear colour.
+	framebuffer = graphics.GetSoftwareDevice()->GetFramebuffer();
+	drawnCount = 0;
+	mismatchCount = 0;
+	for(i=0; i<pixelCount; i++)
+	{
+		pixel = &file[TARGA_HEADER_SIZE + i * 4];
+		if(pixel[0] != framebuffer[i * 4 + 2] || pixel[1] != framebuffer[i * 4 + 1] || pixel[2] != framebuffer[i * 4 + 0] ||
+		   pixel[3] != framebuffer[i * 4 + 3])
+		{
+			mismatchCount++;
+		}
+
+		if(pixel[0] != 0 || pixel[1] != 0 || pixel[2] != 0)
+		{
+			drawnCount++;
+		}
+	}
+
+	CHECK(mismatchCount == 0);
+	CHECK((float)drawnCount > MIN_DRAWN_PIXELS * (float)pixelCount);
+
+	graphics.Shutdown();
+
+	return;
+}
+
+
+int main()
+{
+	TestRenderScene();
+
+	return TestResult("softwarescenetest");
+}
\ No newline at end of file
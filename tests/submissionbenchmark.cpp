@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: submissionbenchmark.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Times GraphicsClass::Frame for the game scene on the null device, so the time is the CPU cost of updating the scene and
+// submitting its draws with no GPU or driver behind them, and reports the median frame time along with the draws and
+// state changes the frame sent and the submission time per draw.
+//
+//   submissionbenchmark [iterations] [width] [height]
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "graphicsclass.h"
+#include "nulldeviceclass.h"
+#include "testscene.h"
+#include "benchmarktimer.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int DEFAULT_ITERATIONS = 200;
+const int DEFAULT_WIDTH = 1280;
+const int DEFAULT_HEIGHT = 720;
+const int WARMUP_FRAMES = 30;
+
+
+int main(int argc, char** argv)
+{
+	GraphicsClass graphics;
+	NullDeviceClass* device;
+	RenderDeviceClass::StatisticsType statistics;
+	vector<double> samples;
+	double start, frameTime;
+	int iterations, width, height, i;
+
+
+	iterations = GetArgument(argc, argv, 1, DEFAULT_ITERATIONS);
+	width = GetArgument(argc, argv, 2, DEFAULT_WIDTH);
+	height = GetArgument(argc, argv, 3, DEFAULT_HEIGHT);
+
+	if(!SetTestScene(graphics, "submissionbenchmark") || !graphics.InitializeHeadless(width, height))
+	{
+		graphics.Shutdown();
+		return 1;
+	}
+
+	device = (NullDeviceClass*)graphics.GetRenderDevice();
+
+	// Let the caches, the shadow maps and the worker pool settle first.
+	for(i=0; i<WARMUP_FRAMES; i++)
+	{
+		if(!graphics.Frame(0))
+		{
+			graphics.Shutdown();
+			return 1;
+		}
+	}
+
+	for(i=0; i<iterations; i++)
+	{
+		start = GetMilliseconds();
+		if(!graphics.Frame(0))
+		{
+			graphics.Shutdown();
+			return 1;
+		}
+		samples.push_back(GetMilliseconds() - start);
+	}
+
+	// The statistics are the ones of the last frame, the scene draws about the same every frame.
+	device->GetStatistics(statistics);
+	frameTime = GetMedian(samples);
+
+	printf("submission, %dx%d, median of %d\n", width, height, iterations);
+	printf("  frame ms  draws  commands  pipelines  shaders  constants  textures  depth  targets  us per draw\n");
+	printf("  %8.3f  %5d  %8d  %9d  %7d  %9d  %8d  %5d  %7d  %11.3f\n", frameTime, statistics.drawCalls, device->GetCommandCount(),
+		   statistics.pipelineChanges, statistics.shaderChanges, statistics.constantBufferChanges, statistics.textureChanges,
+		   statistics.depthStateChanges, statistics.renderTargetChanges,
+		   frameTime * 1000.0 / (double)max(statistics.drawCalls, 1));
+
+	graphics.Shutdown();
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: swarmbenchmark.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Times SwarmClass::Update and SwarmClass::Render for a swarm flying over the terrain on 1, 2, 4 ... threads of a worker
+// pool up to the core count, and reports the median step and render time along with the step time per 10k drones.
+//
+//   swarmbenchmark [droneCount] [iterations] [maxThreads]
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <thread>
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "nulldeviceclass.h"
+#include "cameraclass.h"
+#include "terrainclass.h"
+#include "swarmclass.h"
+#include "workerpoolclass.h"
+#include "benchmarktimer.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int SCREEN_WIDTH = 1280;
+const int SCREEN_HEIGHT = 720;
+const float SCREEN_DEPTH = 10000.0f;
+const float SCREEN_NEAR = 0.1f;
+const float STEP_TIME = 1000.0f / 60.0f;
+const int DEFAULT_DRONE_COUNT = 10000;
+const int DEFAULT_ITERATIONS = 100;
+const int WARMUP_STEPS = 120;
+const int REFERENCE_DRONES = 10000;
+
+
+int main(int argc, char** argv)
+{
+	NullDeviceClass device;
+	TerrainClass terrain;
+	CameraClass camera;
+	WorkerPoolClass workerPool;
+	SwarmClass swarm;
+	vector<double> stepSamples, renderSamples;
+	XMMATRIX projectionMatrix;
+	double start, stepTime;
+	int droneCount, iterations, maxThreads, threadCount, i;
+
+
+	droneCount = max(GetArgument(argc, argv, 1, DEFAULT_DRONE_COUNT), 1);
+	iterations = GetArgument(argc, argv, 2, DEFAULT_ITERATIONS);
+	maxThreads = min(max(GetArgument(argc, argv, 3, (int)thread::hardware_concurrency()), 1), SWARM_MAX_THREADS);
+
+	if(!device.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SCREEN_NEAR, false) || !terrain.Initialize(&device, TERRAIN_SEED))
+	{
+		return 1;
+	}
+
+	// Look down on the airfield from behind so a good part of the swarm is in view.
+	device.GetProjectionMatrix(projectionMatrix);
+	camera.SetProjectionMatrix(projectionMatrix);
+	camera.SetPosition(0.0f, 300.0f, -900.0f);
+	camera.SetRotation(15.0f, 0.0f, 0.0f);
+	camera.Render();
+
+	printf("swarm, %d drones, median of %d, %d cores\n", droneCount, iterations, (int)thread::hardware_concurrency());
+	printf("  threads  step ms  render ms  visible  step ms per 10k\n");
+
+	for(threadCount=1; threadCount<=maxThreads; threadCount*=2)
+	{
+		if(!workerPool.Initialize(threadCount) || !swarm.Initialize(&device, &terrain, droneCount, &workerPool, SWARM_SEED))
+		{
+			return 1;
+		}
+
+		// Let the drones gather into flocks first, the neighbour search costs more once they have.
+		for(i=0; i<WARMUP_STEPS; i++)
+		{
+			swarm.Update(STEP_TIME);
+		}
+
+		stepSamples.clear();
+		renderSamples.clear();
+		for(i=0; i<iterations; i++)
+		{
+			start = GetMilliseconds();
+			swarm.Update(STEP_TIME);
+			stepSamples.push_back(GetMilliseconds() - start);
+
+			start = GetMilliseconds();
+			if(!swarm.Render(&camera, 0.5f))
+			{
+				return 1;
+			}
+			renderSamples.push_back(GetMilliseconds() - start);
+		}
+
+		stepTime = GetMedian(stepSamples);
+		printf("  %7d  %7.3f  %9.3f  %7d  %15.3f\n", threadCount, stepTime, GetMedian(renderSamples), swarm.GetVisibleCount(),
+			   stepTime * (double)REFERENCE_DRONES / (double)droneCount);
+
+		swarm.Shutdown();
+		workerPool.Shutdown();
+	}
+
+	terrain.Shutdown();
+	device.Shutdown();
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,385 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: terraintest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Selects the terrain chunks from a range of views and reads the vertex and index buffers TerrainClass hands the
+// device back.  The nodes must stay within the budget, neighbours must be at most one level apart, the edges next to a
+// coarser node must be stitched and only those, and every vertex must sit on the heightmap.
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <map>
+#include <vector>
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "nulldeviceclass.h"
+#include "cameraclass.h"
+#include "terrainclass.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int SCREEN_WIDTH = 1280;
+const int SCREEN_HEIGHT = 720;
+const float SCREEN_DEPTH = 10000.0f;
+const float SCREEN_NEAR = 0.1f;
+const int CHUNK_VERTICES = TERRAIN_CHUNK_QUADS + 1;
+const float HEIGHT_TOLERANCE = 1e-3f;
+const int DETAIL_SCALE = 32;
+
+// Camera position and rotation in degrees of every view tested.
+const float VIEWS[][5] =
+{
+	{ 0.0f, 50.0f, -200.0f, 5.0f, 0.0f },
+	{ 0.0f, 3000.0f, 0.0f, 90.0f, 0.0f },
+	{ 2500.0f, 620.0f, 2500.0f, 10.0f, 225.0f },
+	{ -3000.0f, 300.0f, 1000.0f, 0.0f, 90.0f },
+	{ 1500.0f, 40.0f, -3500.0f, -5.0f, 30.0f },
+	{ -4000.0f, 800.0f, -4000.0f, 20.0f, 45.0f },
+	{ 3900.0f, 200.0f, 0.0f, 0.0f, 270.0f }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: RecordingDeviceClass
+//
+// A null device that keeps a copy of the buffers created on it and the buffers last bound, so the test can read the
+// meshes the terrain builds.
+////////////////////////////////////////////////////////////////////////////////
+class RecordingDeviceClass : public NullDeviceClass
+{
+public:
+	RecordingDeviceClass()
+	{
+		m_vertexBuffer = 0;
+		m_vertexStride = 0;
+		m_indexBuffer = 0;
+	}
+
+	int CreateBuffer(ResourceType type, const void* data, int bytes)
+	{
+		int handle;
+
+
+		handle = NullDeviceClass::CreateBuffer(type, data, bytes);
+		if(handle && data)
+		{
+			m_buffers[handle].assign((const unsigned char*)data, (const unsigned char*)data + bytes);
+		}
+
+		return handle;
+	}
+
+	void ReleaseResource(int handle)
+	{
+		m_buffers.erase(handle);
+		NullDeviceClass::ReleaseResource(handle);
+
+		return;
+	}
+
+	void SetVertexBuffer(int handle, int stride)
+	{
+		m_vertexBuffer = handle;
+		m_vertexStride = stride;
+		NullDeviceClass::SetVertexBuffer(handle, stride);
+
+		return;
+	}
+
+	void SetIndexBuffer(int handle)
+	{
+		m_indexBuffer = handle;
+		NullDeviceClass::SetIndexBuffer(handle);
+
+		return;
+	}
+
+	map<int, vector<unsigned char> > m_buffers;
+	int m_vertexBuffer, m_vertexStride, m_indexBuffer;
+};
+
+
+// The vertex layout of the terrain chunks.
+struct VertexType
+{
+	XMFLOAT3 position;
+	XMFLOAT2 texture;
+	XMFLOAT3 normal;
+};
+
+
+struct NodeType
+{
+	int depth, x, y, size;
+	vector<VertexType> vertices;
+	vector<unsigned int> indices;
+};
+
+
+static int GetSampleIndex(float position)
+{
+	return (int)(position / TERRAIN_SPACING + (float)(TERRAIN_SIZE - 1) * 0.5f + 0.5f);
+}
+
+
+static bool ReadNode(RecordingDeviceClass& device, TerrainClass& terrain, int index, NodeType& node)
+{
+	vector<unsigned char>* data;
+	int indexCount, sampleX, sampleZ, samples;
+
+
+	// Let the terrain bind the buffers of the node and copy them out.
+	indexCount = terrain.RenderNode(index);
+	if(device.m_vertexStride != (int)sizeof(VertexType) || !device.m_buffers.count(device.m_vertexBuffer) ||
+	   !device.m_buffers.count(device.m_indexBuffer))
+	{
+		return false;
+	}
+
+	data = &device.m_buffers[device.m_vertexBuffer];
+	if(data->size() != sizeof(VertexType) * CHUNK_VERTICES * CHUNK_VERTICES)
+	{
+		return false;
+	}
+	node.vertices.resize(CHUNK_VERTICES * CHUNK_VERTICES);
+	memcpy(&node.vertices[0], &(*data)[0], data->size());
+
+	data = &device.m_buffers[device.m_indexBuffer];
+	if(indexCount <= 0 || data->size() != sizeof(unsigned int) * indexCount)
+	{
+		return false;
+	}
+	node.indices.resize(indexCount);
+	memcpy(&node.indices[0], &(*data)[0], data->size());
+
+	// Work out which node of the quadtree it is from the corners of the mesh, in cells of the finest level.
+	sampleX = GetSampleIndex(node.vertices[0].position.x);
+	sampleZ = GetSampleIndex(node.vertices[0].position.z);
+	samples = GetSampleIndex(node.vertices[CHUNK_VERTICES - 1].position.x) - sampleX;
+	if(samples < TERRAIN_CHUNK_QUADS || (samples % TERRAIN_CHUNK_QUADS) != 0)
+	{
+		return false;
+	}
+
+	node.size = samples / TERRAIN_CHUNK_QUADS;
+	node.depth = 0;
+	while((TERRAIN_GRID >> node.depth) > node.size)
+	{
+		node.depth++;
+	}
+	node.x = sampleX / TERRAIN_CHUNK_QUADS;
+	node.y = sampleZ / TERRAIN_CHUNK_QUADS;
+
+	return (TERRAIN_GRID >> node.depth) == node.size && (node.x % node.size) == 0 && (node.y % node.size) == 0;
+}
+
+
+static void CheckVertices(TerrainClass& terrain, const NodeType& node, bool& valid)
+{
+	const VertexType* vertex;
+	float stride, length;
+	int i, j;
+
+
+	// The vertices lie on the heightmap samples of the node, every stride'th one, with unit normals pointing up.
+	stride = (float)node.size * TERRAIN_SPACING;
+	for(j=0; j<CHUNK_VERTICES; j++)
+	{
+		for(i=0; i<CHUNK_VERTICES; i++)
+		{
+			vertex = &node.vertices[j * CHUNK_VERTICES + i];
+			length = sqrtf(vertex->normal.x * vertex->normal.x + vertex->normal.y * vertex->normal.y + vertex->normal.z * vertex->normal.z);
+
+			valid = valid && (vertex->position.x == node.vertices[0].position.x + (float)i * stride);
+			valid = valid && (vertex->position.z == node.vertices[0].position.z + (float)j * stride);
+			valid = valid && (fabsf(vertex->position.y - terrain.GetHeight(vertex->position.x, vertex->position.z)) <= HEIGHT_TOLERANCE);
+			valid = valid && (fabsf(length - 1.0f) < 1e-4f) && (vertex->normal.y > 0.0f);
+		}
+	}
+
+	return;
+}
+
+
+static bool IsEdgeStitched(const NodeType& node, int edge)
+{
+	vector<bool> used;
+	unsigned int i;
+	int k, vertexX, vertexZ;
+
+
+	// An edge is stitched when none of its odd vertices is drawn, a plain edge draws all of them.
+	used.assign(CHUNK_VERTICES * CHUNK_VERTICES, false);
+	for(i=0; i<node.indices.size(); i++)
+	{
+		used[node.indices[i]] = true;
+	}
+
+	for(k=1; k<TERRAIN_CHUNK_QUADS; k+=2)
+	{
+		vertexX = (edge == 0) ? 0 : (edge == 1) ? TERRAIN_CHUNK_QUADS : k;
+		vertexZ = (edge == 2) ? 0 : (edge == 3) ? TERRAIN_CHUNK_QUADS : k;
+		if(used[vertexZ * CHUNK_VERTICES + vertexX])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+static void TestView(RecordingDeviceClass& device, TerrainClass& terrain, CameraClass& camera, const float* view, int screenHeight,
+					 int& maxNodeCount)
+{
+	const int offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+	vector<NodeType> nodes;
+	vector<int> cellNode;
+	XMMATRIX projectionMatrix;
+	int i, k, n, cellX, cellY, neighbourX, neighbourY, neighbour, triangleCount;
+	bool valid, overlapping, coarser, finer, unknown;
+
+
+	device.GetProjectionMatrix(projectionMatrix);
+	camera.SetPosition(view[0], view[1], view[2]);
+	camera.SetRotation(view[3], view[4], 0.0f);
+	camera.SetProjectionMatrix(projectionMatrix);
+	camera.Render();
+
+	CHECK(terrain.Update(&camera, projectionMatrix, screenHeight));
+
+	// The budget holds whatever the view.
+	CHECK(terrain.GetVisibleNodeCount() > 0);
+	CHECK(terrain.GetVisibleNodeCount() <= TERRAIN_MAX_NODES);
+	maxNodeCount = max(maxNodeCount, terrain.GetVisibleNodeCount());
+
+	// Read every visible node back and mark the cells of the finest level it covers, no two nodes may share a cell.
+	nodes.resize(terrain.GetVisibleNodeCount());
+	cellNode.assign(TERRAIN_GRID * TERRAIN_GRID, -1);
+	valid = true;
+	overlapping = false;
+	triangleCount = 0;
+	for(n=0; n<(int)nodes.size(); n++)
+	{
+		if(!ReadNode(device, terrain, n, nodes[n]))
+		{
+			valid = false;
+			continue;
+		}
+
+		triangleCount += (int)nodes[n].indices.size() / 3;
+		CheckVertices(terrain, nodes[n], valid);
+
+		for(cellY=nodes[n].y; cellY<nodes[n].y+nodes[n].size; cellY++)
+		{
+			for(cellX=nodes[n].x; cellX<nodes[n].x+nodes[n].size; cellX++)
+			{
+				overlapping = overlapping || (cellNode[cellY * TERRAIN_GRID + cellX] >= 0);
+				cellNode[cellY * TERRAIN_GRID + cellX] = n;
+			}
+		}
+	}
+
+	CHECK(valid);
+	CHECK(!overlapping);
+	CHECK(triangleCount == terrain.GetVisibleTriangleCount());
+
+	// Walk the cells along every edge of every node.  A visible neighbour is never more than one level away, and the
+	// edge is stitched exactly when the neighbour there is coarser.  A neighbour out of view is not known to the test.
+	for(n=0; n<(int)nodes.size() && valid; n++)
+	{
+		for(k=0; k<4; k++)
+		{
+			coarser = false;
+			finer = false;
+			unknown = false;
+			for(i=0; i<nodes[n].size; i++)
+			{
+				cellX = (k == 0) ? nodes[n].x : (k == 1) ? nodes[n].x + nodes[n].size - 1 : nodes[n].x + i;
+				cellY = (k == 2) ? nodes[n].y : (k == 3) ? nodes[n].y + nodes[n].size - 1 : nodes[n].y + i;
+				neighbourX = cellX + offsets[k][0];
+				neighbourY = cellY + offsets[k][1];
+				if(neighbourX < 0 || neighbourX >= TERRAIN_GRID || neighbourY < 0 || neighbourY >= TERRAIN_GRID)
+				{
+					continue;
+				}
+
+				neighbour = cellNode[neighbourY * TERRAIN_GRID + neighbourX];
+				if(neighbour < 0)
+				{
+					unknown = true;
+					continue;
+				}
+
+				CHECK(abs(nodes[neighbour].depth - nodes[n].depth) <= 1);
+				coarser = coarser || (nodes[neighbour].depth < nodes[n].depth);
+				finer = finer || (nodes[neighbour].depth > nodes[n].depth);
+			}
+
+			// An edge is either all coarser, all finer or all the same level after balancing.
+			CHECK(!(coarser && finer));
+
+			if(coarser)
+			{
+				CHECK(IsEdgeStitched(nodes[n], k));
+			}
+			else if(!unknown)
+			{
+				CHECK(!IsEdgeStitched(nodes[n], k));
+			}
+		}
+	}
+
+	return;
+}
+
+
+static void TestViews()
+{
+	RecordingDeviceClass device;
+	TerrainClass terrain;
+	CameraClass camera;
+	int i, maxNodeCount;
+
+
+	CHECK(device.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_DEPTH, SCREEN_NEAR, false));
+	CHECK(terrain.Initialize(&device, TERRAIN_SEED));
+
+	maxNodeCount = 0;
+	for(i=0; i<(int)(sizeof(VIEWS) / sizeof(VIEWS[0])); i++)
+	{
+		TestView(device, terrain, camera, VIEWS[i], SCREEN_HEIGHT, maxNodeCount);
+	}
+
+	// A screen this tall asks for far more detail than the budget allows, so the selection and the balancing have to
+	// be cut back to fit.
+	maxNodeCount = 0;
+	for(i=0; i<(int)(sizeof(VIEWS) / sizeof(VIEWS[0])); i++)
+	{
+		TestView(device, terrain, camera, VIEWS[i], SCREEN_HEIGHT * DETAIL_SCALE, maxNodeCount);
+	}
+
+	CHECK(maxNodeCount > TERRAIN_MAX_NODES * 3 / 4);
+
+	// The cached meshes and the shared index buffers are all released.
+	terrain.Shutdown();
+	CHECK(device.GetResourceCount() == 0);
+	device.Shutdown();
+
+	return;
+}
+
+
+int main()
+{
+	TestViews();
+
+	return TestResult("terraintest");
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: testcheck.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _TESTCHECK_H_
+#define _TESTCHECK_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <stdio.h>
+#include <math.h>
+
+
+/////////////
+// GLOBALS //
+/////////////
+static int g_checkCount = 0;
+static int g_failureCount = 0;
+
+
+////////////
+// MACROS //
+////////////
+// Each check prints the failing expression with its file and line and keeps going so one run reports every failure.
+#define CHECK(condition) \
+	do { g_checkCount++; if(!(condition)) { g_failureCount++; printf("%s(%d): CHECK failed: %s\n", __FILE__, __LINE__, #condition); } } while(0)
+
+#define CHECK_NEAR(value, expected, tolerance) \
+	do { g_checkCount++; double checkValue = (double)(value), checkExpected = (double)(expected); \
+	if(!(fabs(checkValue - checkExpected) <= (double)(tolerance))) { g_failureCount++; \
+	printf("%s(%d): CHECK_NEAR failed: %s = %g, expected %g\n", __FILE__, __LINE__, #value, checkValue, checkExpected); } } while(0)
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Function name: TestResult
+////////////////////////////////////////////////////////////////////////////////
+// Prints the summary line and returns the exit code for ctest.
+static inline int TestResult(const char* name)
+{
+	printf("%s: %d checks, %d failed\n", name, g_checkCount, g_failureCount);
+
+	return (g_failureCount == 0) ? 0 : 1;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: testscene.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _TESTSCENE_H_
+#define _TESTSCENE_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+using namespace std;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "graphicsclass.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+#ifndef TEST_OUTPUT_DIR
+#define TEST_OUTPUT_DIR "."
+#endif
+
+const char* const TEST_FALLBACK_MODEL = "../Engine/data/smallDrone.txt";
+const char* const TEST_FALLBACK_TEXTURE = "../Engine/data/tal512.dds";
+const wchar_t* const TEST_FALLBACK_SKY_TEXTURE = L"../Engine/data/lol.dds";
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Function name: GetOutputPath
+////////////////////////////////////////////////////////////////////////////////
+// Puts the files a test writes in the build directory instead of the source tree.
+static inline void GetOutputPath(const char* name, char* path, int size)
+{
+	snprintf(path, size, "%s/%s", TEST_OUTPUT_DIR, name);
+
+	return;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Function name: IsFile
+////////////////////////////////////////////////////////////////////////////////
+static inline bool IsFile(const char* filename)
+{
+	ifstream fin;
+
+
+	fin.open(filename, ios::binary);
+
+	return !fin.fail();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Function name: SetTestScene
+////////////////////////////////////////////////////////////////////////////////
+// Points the renderer at a copy of the game scene written to the build directory.  The copy is the same scene, only a
+// model or texture missing from the checkout is swapped for one that is there, as the null and software devices refuse
+// a missing file the same way the GPU does.  The sky texture is swapped the same way.
+static inline bool SetTestScene(GraphicsClass& graphics, const char* name)
+{
+	ifstream fin;
+	ofstream fout;
+	istringstream words;
+	string line, word;
+	char path[SCENE_MAX_PATH], filename[SCENE_MAX_PATH / 2];
+	bool first;
+
+
+	fin.open(SCENE_FILENAME);
+	if(fin.fail())
+	{
+		return false;
+	}
+
+	snprintf(filename, sizeof(filename), "%s.scene.txt", name);
+	GetOutputPath(filename, path, sizeof(path));
+	fout.open(path);
+	if(fout.fail())
+	{
+		return false;
+	}
+
+	// Copy the scene word by word, keeping the line breaks.  Every file the scene names is a path into the data folder.
+	while(getline(fin, line))
+	{
+		words.clear();
+		words.str(line);
+		first = true;
+		while(words >> word)
+		{
+			if((word.find('/') != string::npos) && !IsFile(word.c_str()))
+			{
+				word = ((word.size() > 4) && (word.compare(word.size() - 4, 4, ".dds") == 0)) ? TEST_FALLBACK_TEXTURE :
+					   TEST_FALLBACK_MODEL;
+			}
+
+			fout << (first ? "" : " ") << word;
+			first = false;
+		}
+		fout << "\n";
+	}
+
+	fout.close();
+	if(fout.fail())
+	{
+		return false;
+	}
+
+	// The sky texture goes through the wide file name the texture loader takes.
+	wcstombs(filename, SKY_TEXTURE_FILENAME, sizeof(filename) - 1);
+	filename[sizeof(filename) - 1] = 0;
+
+	graphics.SetSceneFiles(path, IsFile(filename) ? SKY_TEXTURE_FILENAME : TEST_FALLBACK_SKY_TEXTURE);
+
+	return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: transformbenchmark.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Times TransformClass::Update on a 100k node hierarchy with every node dirty, with one node in a hundred dirty (plus
+// the descendants that inherit the change) and with nothing dirty.
+//
+//   transformbenchmark [nodeCount] [iterations]
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "transformclass.h"
+#include "benchmarktimer.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int DEFAULT_NODE_COUNT = 100000;
+const int DEFAULT_ITERATIONS = 50;
+const int SPARSE_DIRTY_STRIDE = 100;
+const int TREE_BRANCHING = 4;
+
+
+static void BuildTree(TransformClass& transforms, int nodeCount)
+{
+	int i;
+
+
+	// A four way tree in heap order is already breadth first, node i hangs off node (i - 1) / 4.
+	for(i=0; i<nodeCount; i++)
+	{
+		transforms.AddNode((i == 0) ? -1 : (i - 1) / TREE_BRANCHING);
+		transforms.SetLocal(i, (float)(i % 7), (float)(i % 5), (float)(i % 3), 0.01f * (float)(i % 11), 0.02f * (float)(i % 13),
+							0.03f * (float)(i % 17), 1.0f);
+	}
+
+	transforms.Update();
+
+	return;
+}
+
+
+static double TimeUpdates(TransformClass& transforms, int nodeCount, int iterations, int stride, int& updatedCount)
+{
+	vector<double> samples;
+	double start;
+	int i, j, offset;
+
+
+	for(i=0; i<iterations; i++)
+	{
+		// Touch every stride'th node, starting at a different offset each time so the dirty set moves around the tree.
+		if(stride > 0)
+		{
+			offset = (i * 37) % stride;
+			for(j=offset; j<nodeCount; j+=stride)
+			{
+				transforms.SetLocalRotation(j, 0.001f * (float)i, 0.002f * (float)j, 0.0f);
+			}
+		}
+
+		start = GetMilliseconds();
+		updatedCount = transforms.Update();
+		samples.push_back(GetMilliseconds() - start);
+	}
+
+	return GetMedian(samples);
+}
+
+
+int main(int argc, char** argv)
+{
+	TransformClass transforms;
+	int nodeCount, iterations, updatedCount;
+	double time;
+
+
+	nodeCount = GetArgument(argc, argv, 1, DEFAULT_NODE_COUNT);
+	iterations = GetArgument(argc, argv, 2, DEFAULT_ITERATIONS);
+
+	if(!transforms.Initialize(nodeCount))
+	{
+		return 1;
+	}
+
+	BuildTree(transforms, nodeCount);
+
+	printf("transform update, %d nodes, median of %d\n", nodeCount, iterations);
+
+	time = TimeUpdates(transforms, nodeCount, iterations, 1, updatedCount);
+	printf("  all dirty     %8.3f ms  %7d nodes rebuilt\n", time, updatedCount);
+
+	time = TimeUpdates(transforms, nodeCount, iterations, SPARSE_DIRTY_STRIDE, updatedCount);
+	printf("  sparse dirty  %8.3f ms  %7d nodes rebuilt\n", time, updatedCount);
+
+	time = TimeUpdates(transforms, nodeCount, iterations, 0, updatedCount);
+	printf("  static        %8.3f ms  %7d nodes rebuilt\n", time, updatedCount);
+
+	transforms.Shutdown();
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: transformtest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Checks the batched local matrix build and the dirty propagation of TransformClass::Update against world matrices
+// composed node by node from the parent chain.
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "transformclass.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int NODE_COUNT = 341;
+const int TREE_BRANCHING = 4;
+
+
+static float Random(unsigned int& state)
+{
+	// Xorshift keeps the test deterministic on every platform.
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+
+	return (float)(state & 0xFFFF) / 65535.0f;
+}
+
+
+static XMMATRIX ReferenceWorld(int index, const float* values, const int* parents)
+{
+	const float* node;
+	XMMATRIX localMatrix;
+
+
+	// Scale, then roll, pitch and yaw, then translate, concatenated up the parent chain one node at a time.
+	node = &values[index * 7];
+	localMatrix = XMMatrixScaling(node[6], node[6], node[6]) * XMMatrixRotationRollPitchYaw(node[3], node[4], node[5]) *
+				  XMMatrixTranslation(node[0], node[1], node[2]);
+
+	if(parents[index] < 0)
+	{
+		return localMatrix;
+	}
+
+	return localMatrix * ReferenceWorld(parents[index], values, parents);
+}
+
+
+static float MaxError(TransformClass& transforms, const float* values, const int* parents)
+{
+	XMFLOAT4X4 expected;
+	const XMFLOAT4X4* world;
+	float error;
+	int i, row, column;
+
+
+	error = 0.0f;
+	for(i=0; i<transforms.GetNodeCount(); i++)
+	{
+		XMStoreFloat4x4(&expected, ReferenceWorld(i, values, parents));
+		world = transforms.GetWorldMatrix(i);
+		for(row=0; row<4; row++)
+		{
+			for(column=0; column<4; column++)
+			{
+				error = max(error, fabsf(world->m[row][column] - expected.m[row][column]));
+			}
+		}
+	}
+
+	return error;
+}
+
+
+static void SetRandom(TransformClass& transforms, float* values, int index, unsigned int& seed)
+{
+	float* node;
+	int i;
+
+
+	node = &values[index * 7];
+	for(i=0; i<3; i++)
+	{
+		node[i] = Random(seed) * 20.0f - 10.0f;
+		node[i + 3] = Random(seed) * 6.0f - 3.0f;
+	}
+	node[6] = 0.5f + Random(seed);
+
+	transforms.SetLocal(index, node[0], node[1], node[2], node[3], node[4], node[5], node[6]);
+
+	return;
+}
+
+
+static void TestHierarchy()
+{
+	TransformClass transforms;
+	float values[NODE_COUNT * 7];
+	int parents[NODE_COUNT];
+	unsigned int seed;
+	int i, updated;
+
+
+	CHECK(transforms.Initialize(NODE_COUNT));
+
+	// Build a four way tree in heap order with random local transforms.
+	seed = 12345;
+	for(i=0; i<NODE_COUNT; i++)
+	{
+		parents[i] = (i == 0) ? -1 : (i - 1) / TREE_BRANCHING;
+		CHECK(transforms.AddNode(parents[i]) == i);
+		SetRandom(transforms, values, i, seed);
+	}
+
+	// The first update builds every node, including the padded last group of the batch.
+	CHECK(transforms.Update() == NODE_COUNT);
+	CHECK(MaxError(transforms, values, parents) < 1e-3f);
+
+	// Nothing changed, so nothing is rebuilt.
+	CHECK(transforms.Update() == 0);
+
+	// Changing node 1 rebuilds its subtree, a quarter of every deeper level, and nothing else.
+	SetRandom(transforms, values, 1, seed);
+	updated = transforms.Update();
+	CHECK(updated == 1 + 4 + 16 + 64);
+	CHECK(MaxError(transforms, values, parents) < 1e-3f);
+
+	// Changing only leaves touches exactly those leaves, across several partial groups of four.
+	SetRandom(transforms, values, NODE_COUNT - 1, seed);
+	SetRandom(transforms, values, NODE_COUNT - 3, seed);
+	SetRandom(transforms, values, NODE_COUNT - 50, seed);
+	SetRandom(transforms, values, NODE_COUNT - 90, seed);
+	SetRandom(transforms, values, NODE_COUNT - 200, seed);
+	CHECK(transforms.Update() == 5);
+	CHECK(MaxError(transforms, values, parents) < 1e-3f);
+
+	// Position only and rotation only edits go through the same batch.
+	transforms.SetLocalPosition(0, 1.0f, 2.0f, 3.0f);
+	values[0] = 1.0f;
+	values[1] = 2.0f;
+	values[2] = 3.0f;
+	transforms.SetLocalRotation(5, 0.5f, -1.0f, 2.0f);
+	values[5 * 7 + 3] = 0.5f;
+	values[5 * 7 + 4] = -1.0f;
+	values[5 * 7 + 5] = 2.0f;
+	CHECK(transforms.Update() == NODE_COUNT);
+	CHECK(MaxError(transforms, values, parents) < 1e-3f);
+
+	transforms.Shutdown();
+
+	return;
+}
+
+
+static void TestInsertionOrder()
+{
+	TransformClass transforms;
+
+
+	CHECK(transforms.Initialize(4));
+
+	// Parents must exist and nodes must be added one level at a time.
+	CHECK(transforms.AddNode(0) == -1);
+	CHECK(transforms.AddNode(-1) == 0);
+	CHECK(transforms.AddNode(0) == 1);
+	CHECK(transforms.AddNode(-1) == -1);
+	CHECK(transforms.AddNode(1) == 2);
+	CHECK(transforms.AddNode(2) == 3);
+	CHECK(transforms.AddNode(2) == -1);
+	CHECK(transforms.GetParent(3) == 2);
+
+	transforms.Shutdown();
+
+	return;
+}
+
+
+int main()
+{
+	TestHierarchy();
+	TestInsertionOrder();
+
+	return TestResult("transformtest");
+}
\ No newline at end of file
@@ -0,0 +1,225 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: workerpooltest.cpp
+////////////////////////////////////////////////////////////////////////////////
+// Checks that WorkerPoolClass::Run hands every item of a job to exactly one block, in blocks of the given size, over
+// many jobs in a row on the same workers, and that the work really is spread across the threads of the pool.
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "workerpoolclass.h"
+#include "testcheck.h"
+
+
+/////////////
+// GLOBALS //
+/////////////
+const int MAX_ITEMS = 5000;
+const int REPEAT_COUNT = 200;
+const int SLOW_BLOCK_COUNT = 16;
+
+
+struct CountJobType
+{
+	atomic<int> hits[MAX_ITEMS];
+	atomic<int> badBlocks, blockCount;
+	int blockSize;
+};
+
+struct ThreadJobType
+{
+	thread::id ids[SLOW_BLOCK_COUNT];
+};
+
+
+static void CountItems(void* context, int start, int end)
+{
+	CountJobType* job;
+	int i;
+
+
+	job = (CountJobType*)context;
+
+	// Every block but the last is exactly one block size long and starts on a multiple of it.
+	if((start % job->blockSize != 0) || (end - start > job->blockSize) || (end <= start))
+	{
+		job->badBlocks++;
+	}
+	job->blockCount++;
+
+	for(i=start; i<end; i++)
+	{
+		job->hits[i]++;
+	}
+
+	return;
+}
+
+
+static void RecordThread(void* context, int start, int end)
+{
+	ThreadJobType* job;
+	int i;
+
+
+	job = (ThreadJobType*)context;
+
+	// Hold on to the block for a moment so the other threads get the chance to take the rest, and only then mark it.
+	for(i=start; i<end; i++)
+	{
+		this_thread::sleep_for(chrono::milliseconds(2));
+		job->ids[i] = this_thread::get_id();
+	}
+
+	return;
+}
+
+
+static bool RunAndCount(WorkerPoolClass& workerPool, CountJobType& job, int count, int blockSize)
+{
+	int i;
+	bool valid;
+
+
+	for(i=0; i<MAX_ITEMS; i++)
+	{
+		job.hits[i] = 0;
+	}
+	job.badBlocks = 0;
+	job.blockCount = 0;
+	job.blockSize = blockSize;
+
+	workerPool.Run(CountItems, &job, count, blockSize);
+
+	valid = (job.badBlocks == 0) && (job.blockCount == (count + blockSize - 1) / blockSize);
+	for(i=0; i<MAX_ITEMS; i++)
+	{
+		valid = valid && (job.hits[i] == ((i < count) ? 1 : 0));
+	}
+
+	return valid;
+}
+
+
+static void TestThreadCount()
+{
+	WorkerPoolClass workerPool;
+
+
+	// The calling thread counts as one of the threads and the count is clamped to the pool limit.
+	CHECK(workerPool.Initialize(0));
+	CHECK(workerPool.GetThreadCount() == 1);
+	workerPool.Shutdown();
+
+	CHECK(workerPool.Initialize(3));
+	CHECK(workerPool.GetThreadCount() == 3);
+	workerPool.Shutdown();
+
+	CHECK(workerPool.Initialize(WORKER_POOL_MAX_THREADS * 2));
+	CHECK(workerPool.GetThreadCount() == WORKER_POOL_MAX_THREADS);
+	workerPool.Shutdown();
+
+	return;
+}
+
+
+static void TestCoverage(int threadCount)
+{
+	const int counts[] = { 0, 1, 7, 64, 1000, MAX_ITEMS };
+	const int blockSizes[] = { 1, 3, 64, 250, MAX_ITEMS };
+	WorkerPoolClass workerPool;
+	CountJobType* job;
+	int c, b, i;
+	bool valid;
+
+
+	job = new CountJobType;
+	CHECK(workerPool.Initialize(threadCount));
+
+	valid = true;
+	for(c=0; c<(int)(sizeof(counts) / sizeof(counts[0])); c++)
+	{
+		for(b=0; b<(int)(sizeof(blockSizes) / sizeof(blockSizes[0])); b++)
+		{
+			valid = valid && RunAndCount(workerPool, *job, counts[c], blockSizes[b]);
+		}
+	}
+	CHECK(valid);
+
+	// Many short jobs back to back catch a worker that is still leaving one job when the next is handed out.
+	valid = true;
+	for(i=0; i<REPEAT_COUNT; i++)
+	{
+		valid = valid && RunAndCount(workerPool, *job, 100 + (i % 13), 1 + (i % 5));
+	}
+	CHECK(valid);
+
+	workerPool.Shutdown();
+	delete job;
+
+	return;
+}
+
+
+static void TestSpread()
+{
+	WorkerPoolClass workerPool;
+	ThreadJobType job;
+	int i;
+	bool calling, other, finished;
+
+
+	// A pool of one runs every block on the calling thread.
+	CHECK(workerPool.Initialize(1));
+	workerPool.Run(RecordThread, &job, SLOW_BLOCK_COUNT, 1);
+	calling = true;
+	for(i=0; i<SLOW_BLOCK_COUNT; i++)
+	{
+		calling = calling && (job.ids[i] == this_thread::get_id());
+	}
+	CHECK(calling);
+	workerPool.Shutdown();
+
+	// A larger pool has the workers take some of the blocks, and Run only returns once theirs are done as well.
+	for(i=0; i<SLOW_BLOCK_COUNT; i++)
+	{
+		job.ids[i] = thread::id();
+	}
+
+	CHECK(workerPool.Initialize(4));
+	workerPool.Run(RecordThread, &job, SLOW_BLOCK_COUNT, 1);
+	other = false;
+	finished = true;
+	for(i=0; i<SLOW_BLOCK_COUNT; i++)
+	{
+		other = other || (job.ids[i] != this_thread::get_id());
+		finished = finished && (job.ids[i] != thread::id());
+	}
+	CHECK(other);
+	CHECK(finished);
+	workerPool.Shutdown();
+
+	return;
+}
+
+
+int main()
+{
+	TestThreadCount();
+	TestCoverage(1);
+	TestCoverage(2);
+	TestCoverage(8);
+	TestSpread();
+
+	return TestResult("workerpooltest");
+}
\ No newline at end of file